@@ -36,6 +36,17 @@
 #include <stdlib.h>                         /* for standard library                    */
 #include <stdio.h>                          /* Standard I/O functions.                 */
 #include <string.h>                         /* for string library                      */
+#include <stddef.h>                         /* for offsetof                            */
+#if defined (PLATFORM_LINUX)
+#include <unistd.h>                         /* UNIX standard functions                 */
+#include <errno.h>                          /* for error numbers                       */
+#include <fcntl.h>                          /* for file control                        */
+#include <signal.h>                         /* for signal handling                     */
+#include <poll.h>                           /* for poll                                */
+#include <sys/socket.h>                     /* for sockets                             */
+#include <sys/un.h>                         /* for UNIX domain sockets                 */
+#include <sys/stat.h>                       /* for file status                         */
+#endif
 #include "openblt.h"                        /* OpenBLT host library.                   */
 
 
@@ -60,6 +71,48 @@
  *         progrma operation on the target.
  */
 #define RESULT_ERROR_MEMORY_PROGRAM         (4)
+/** \brief Program return code indicating that an error was detected during a memory
+ *         read operation on the target.
+ */
+#define RESULT_ERROR_MEMORY_READ            (5)
+/** \brief Program return code indicating that the firmware data on the target differs
+ *         from the one in the firmware file.
+ */
+#define RESULT_ERROR_VERIFY                 (6)
+
+/** \brief Number of bytes that are erased at a time, when updating multiple targets in
+ *         parallel. This prevents an erase timeout due to erasing too big of a memory
+ *         range.
+ */
+#define TARGET_ERASE_CHUNK_SIZE             (32768u)
+/** \brief Time in milliseconds between the connection attempts with a target, when
+ *         updating multiple targets in parallel.
+ */
+#define TARGET_CONNECT_RETRY_MS             (20u)
+/** \brief Maximum number of characters on a line of the batch manifest file. */
+#define MANIFEST_LINE_LEN_MAX               (1024u)
+/** \brief Maximum number of parameters of a job in batch mode. These are the command
+ *         line parameters together with the ones on the line of the job in the batch
+ *         manifest file.
+ */
+#define JOB_PARAMS_MAX                      (255u)
+/** \brief Maximum number of clients that can be connected to the daemon at the same
+ *         time.
+ */
+#define DAEMON_CLIENTS_MAX                  (16u)
+/** \brief Maximum number of bytes with answers that the daemon queues for a client.
+ *         A client that does not read its answers is disconnected once exceeded, such
+ *         that it cannot hold up the daemon or make it run out of memory.
+ */
+#define DAEMON_CLIENT_OUTPUT_MAX            (65536u)
+/** \brief Suffix that is appended to the name of the socket of the daemon, for the
+ *         directory of the firmware cache if none was specified with -fc=[directory].
+ */
+#define DAEMON_CACHE_SUFFIX                 ".cache"
+/** \brief Maximum total size in kilobytes of the files in the firmware cache directory.
+ *         Once exceeded, the least recently used ones are removed.
+ */
+#define FIRMWARE_CACHE_SIZE_MAX             (262144u)
 
 /* Macros for colored text on the output, if supported. */
 #if defined (PLATFORM_LINUX)
@@ -86,8 +139,245 @@ typedef struct t_program_settings
    *        information is shows.
    */
   bool silentMode;
+  /* \brief Comma separated list with the targets to update in parallel, as specified
+   *        with the -mt=[list] parameter. NULL to update a single target.
+   */
+  char const * targetList;
+  /* \brief True if a poor network should be emulated on top of the transport layer,
+   *        as specified with the -emu=[options] parameter.
+   */
+  bool emulate;
+  /* \brief Network emulation settings. The transport layer that it wraps is filled in
+   *        when a session is created.
+   */
+  tBltTransportSettingsXcpV10Emu emulation;
+  /* \brief Batch manifest file with the firmware update jobs, as specified with the
+   *        -bm=[file] parameter. NULL for a single firmware update.
+   */
+  char const * manifestFile;
+  /* \brief UNIX domain socket that the daemon listens on for jobs, as specified with
+   *        the -ds=[socket] parameter. NULL if not running as a daemon.
+   */
+  char const * daemonSocket;
+  /* \brief Directory of the firmware cache, as specified with the -fc=[directory]
+   *        parameter. NULL to always parse the firmware files.
+   */
+  char const * firmwareCache;
 } tProgramSettings;
 
+/** \brief Type for a memory segment of a firmware image. */
+typedef struct t_image_segment
+{
+  uint32_t base;                            /**< Base memory address of the segment.   */
+  uint32_t len;                             /**< Number of bytes in the segment.       */
+  uint8_t const * data;                     /**< Firmware data of the segment.         */
+} tImageSegment;
+
+/** \brief Type for the firmware data of a firmware file, as it is programmed on the
+ *         targets.
+ */
+typedef struct t_image
+{
+  /** \brief Name of the firmware file. NULL for an image of a daemon job. */
+  char const * file;
+  /** \brief Array with the memory segments. */
+  tImageSegment * segments;
+  /** \brief Number of memory segments. */
+  uint32_t segmentCount;
+  /** \brief Total number of firmware data bytes. */
+  uint32_t totalSize;
+  /** \brief Copy of the firmware data of all segments. NULL if the segments refer to the
+   *         firmware data in the firmware data module.
+   */
+  uint8_t * data;
+} tImage;
+
+/** \brief Steps of the operation on a target, when updating multiple targets in
+ *         parallel or when running jobs.
+ */
+typedef enum
+{
+  TARGET_STEP_CONNECT,                      /**< Connecting to the target bootloader.  */
+  TARGET_STEP_ERASE,                        /**< Erasing the memory segments.          */
+  TARGET_STEP_PROGRAM,                      /**< Programming the memory segments.      */
+  TARGET_STEP_VERIFY,                       /**< Verifying the memory segments.        */
+  TARGET_STEP_READ,                         /**< Reading a memory range.               */
+  TARGET_STEP_DISCONNECT,                   /**< Finishing the programming session.    */
+  TARGET_STEP_DONE                          /**< Operation finished or failed.         */
+} tTargetStep;
+
+/** \brief Operations on a target. */
+typedef enum
+{
+  TARGET_OP_FLASH,                          /**< Erase and program the firmware data.  */
+  TARGET_OP_VERIFY,                         /**< Compare the memory with the firmware. */
+  TARGET_OP_READ                            /**< Read a memory range.                  */
+} tTargetOperation;
+
+/** \brief Type for a target that is updated in parallel with other targets. */
+typedef struct t_target
+{
+  /** \brief Name of the target as specified in the target list. */
+  char * name;
+  /** \brief Transport layer settings of the target. */
+  void * transportSettings;
+  /** \brief Copy of the target name that the transport layer settings refer to. */
+  char * transportValue;
+  /** \brief Firmware update session of the target. */
+  tBltSessionHandle session;
+  /** \brief Operation on the target. */
+  tTargetOperation operation;
+  /** \brief Current step of the operation. */
+  tTargetStep step;
+  /** \brief Time in milliseconds when the current step was entered. */
+  uint32_t stepStart;
+  /** \brief Time in milliseconds spent in each step. */
+  uint32_t stepMs[TARGET_STEP_DONE];
+  /** \brief Firmware data to program on or to verify against the target. */
+  tImage const * image;
+  /** \brief Buffer for the data that is read from the target. */
+  uint8_t * readBuffer;
+  /** \brief Start address of the memory range to read. */
+  uint32_t readAddress;
+  /** \brief Number of bytes to read. */
+  uint32_t readLength;
+  /** \brief Number of bytes processed so far by the pending operation. */
+  uint32_t progress;
+  /** \brief Index of the memory segment that is currently erased or programmed. */
+  uint32_t segmentIdx;
+  /** \brief Offset into the memory segment that is currently erased. */
+  uint32_t segmentOffset;
+  /** \brief Program return code of the firmware update of the target. */
+  int result;
+  /** \brief True if the connection attempt failed and should be retried. */
+  bool connectRetry;
+  /** \brief Time in milliseconds of the last connection attempt. */
+  uint32_t connectTime;
+  /** \brief Time in milliseconds when the connection with the target was established. */
+  uint32_t startTime;
+  /** \brief Time in milliseconds when the firmware update of the target finished. */
+  uint32_t endTime;
+  /** \brief Number of bytes that were programmed, verified or read. */
+  uint32_t processedBytes;
+  /** \brief Controls what gets written to the standard output. */
+  bool silentMode;
+} tTarget;
+
+/** \brief Type for a client that is connected to the daemon. */
+typedef struct t_client
+{
+  /** \brief Socket of the connection. It is non-blocking. */
+  int socket;
+  /** \brief Stream for writing the responses. It writes to the output buffer in memory,
+   *         from which the responses are sent once the socket is ready for them.
+   */
+  FILE * stream;
+  /** \brief Output buffer of the stream. */
+  char * output;
+  /** \brief Number of bytes in the output buffer, as of the last flush of the stream. */
+  size_t outputLen;
+  /** \brief Number of bytes of the output buffer that were already sent. */
+  size_t outputSent;
+  /** \brief Set once the connection should be closed, after the output was sent. */
+  bool closing;
+  /** \brief Received characters of the line that is not yet complete. */
+  char line[MANIFEST_LINE_LEN_MAX + 2];
+  /** \brief Number of characters in the line. */
+  size_t lineLen;
+} tClient;
+
+/** \brief Type for a job of the batch manifest file or of a daemon client. */
+typedef struct t_job
+{
+  /** \brief Number of the job, starting at 1. */
+  uint32_t number;
+  /** \brief Line number of the job in the batch manifest file. */
+  uint32_t lineNumber;
+  /** \brief Operation of the job. */
+  tTargetOperation operation;
+  /** \brief Start address of the memory range of a read job. */
+  uint32_t readAddress;
+  /** \brief Number of bytes of a read job. */
+  uint32_t readLength;
+  /** \brief Copy of the line of the job, split up into its parameters. */
+  char * line;
+  /** \brief Number of parameters of the job. */
+  int argc;
+  /** \brief The command line parameters, followed by the parameters of the job. */
+  char const * * argv;
+  /** \brief Program settings of the job. */
+  tProgramSettings programSettings;
+  /** \brief Session type of the job. */
+  uint32_t sessionType;
+  /** \brief Session settings of the job. */
+  void * sessionSettings;
+  /** \brief Transport type of the job. */
+  uint32_t transportType;
+  /** \brief Transport settings of the job. */
+  void * transportSettings;
+  /** \brief Firmware file of the job. For a read job, this is the S-record file that
+   *         the data is written to.
+   */
+  char const * firmwareFile;
+  /** \brief Name of the interface, such as a serial port or a CAN device, that the
+   *         transport settings select.
+   */
+  char * interfaceName;
+  /** \brief Firmware data to program. In batch mode it is shared with the jobs for the
+   *         same file, in daemon mode the job owns it.
+   */
+  tImage * image;
+  /** \brief Daemon client that submitted the job. NULL for a job of the batch manifest
+   *         file or once the client disconnected.
+   */
+  tClient * client;
+  /** \brief Step of the last progress report to the client. */
+  tTargetStep reportedStep;
+  /** \brief Percentage of the last progress report to the client. */
+  uint32_t reportedPercent;
+  /** \brief Next job in the queue of the lane. */
+  struct t_job * next;
+} tJob;
+
+/** \brief Type for a lane that runs the jobs on one interface, such as a serial port or
+ *         a CAN device, one after the other. The lanes run in parallel.
+ */
+typedef struct t_lane
+{
+  /** \brief Name of the interface. */
+  char * interfaceName;
+  /** \brief Operation of the current job, with the session of the lane. */
+  tTarget target;
+  /** \brief The current job. NULL if the lane has no job to run. */
+  tJob * job;
+  /** \brief Queue with the jobs that still need to run, in order. */
+  tJob * queue;
+  /** \brief The job with the settings that the session was created with. */
+  tJob * sessionJob;
+} tLane;
+
+/** \brief Type for the state of the daemon. */
+typedef struct t_daemon
+{
+  /** \brief Program settings of the daemon. */
+  tProgramSettings const * programSettings;
+  /** \brief Number of program arguments, which are the defaults for the jobs. */
+  int argc;
+  /** \brief Array with program arguments. */
+  char const * const * argv;
+  /** \brief Array with the lanes, one for each interface that a job used so far. The
+   *         lanes are allocated separately, because their targets are the context of
+   *         the session callbacks.
+   */
+  tLane * * lanes;
+  /** \brief Number of lanes. */
+  uint32_t laneCount;
+  /** \brief The connected clients. NULL for a free entry. */
+  tClient * clients[DAEMON_CLIENTS_MAX];
+  /** \brief Number of jobs submitted so far, which numbers the jobs. */
+  uint32_t jobCount;
+} tDaemon;
+
 
 /****************************************************************************************
 * Function prototypes
@@ -96,9 +386,60 @@ static void DisplayProgramInfo(void);
 static void DisplayProgramUsage(void);
 static void DisplaySessionInfo(uint32_t sessionType, void const * sessionSettings);
 static void DisplayTransportInfo(uint32_t transportType, void const * transportSettings);
+static void DisplayEmulationInfo(tBltTransportSettingsXcpV10Emu const * emulation);
 static void DisplayFirmwareDataInfo(uint32_t segments, uint32_t base, uint32_t size);
+static void DisplayLatencyInfo(void);
+static void DisplayThroughputInfo(char const * name, uint32_t bytes, uint32_t timeMs);
+static int UpdateTargetsInParallel(tProgramSettings const * programSettings,
+                                   uint32_t sessionType, void const * sessionSettings,
+                                   uint32_t transportType,
+                                   void const * transportSettings);
+static tTarget * CreateTargets(char const * targetList, uint32_t transportType,
+                               void const * transportSettings, uint32_t * targetCount);
+static void DestroyTargets(tTarget * targets, uint32_t targetCount);
+static void SetTargetStep(tTarget * target, tTargetStep step);
+static void SubmitTargetOperation(tTarget * target);
+static void TargetSessionCallback(tBltSessionEvent const * event, void * context);
+static bool CreateImage(tImage * image, bool copy);
+static void DestroyImage(tImage * image);
+static int RunBatch(tProgramSettings const * programSettings, int argc,
+                    char const * const argv[]);
+static tJob * CreateJobs(char const * manifestFile, int argc, char const * const argv[],
+                         uint32_t * jobCount, uint32_t * errorLine);
+static int SplitManifestLine(char * line, char const * * params, int paramsMax);
+static void DestroyJobs(tJob * jobs, uint32_t jobCount);
+static char * CreateInterfaceName(uint32_t transportType,
+                                  void const * transportSettings);
+static bool JobSettingsEqual(tJob const * job1, tJob const * job2);
+static int InitJob(tJob * job, char const * text, int argc, char const * const argv[]);
+static void ReleaseJob(tJob * job);
+static bool InitLane(tLane * lane, char const * interfaceName, bool silentMode);
+static void ReleaseLane(tLane * lane);
+static void AddLaneJob(tLane * lane, tJob * job);
+static void StartLaneJob(tLane * lane);
+static int FinishLaneJob(tLane * lane, FILE * stream);
+static void PrintJsonString(FILE * stream, char const * str);
+#if defined (PLATFORM_LINUX)
+static int RunDaemon(tProgramSettings const * programSettings, int argc,
+                     char const * const argv[]);
+static void DaemonSignalHandler(int signum);
+static int DaemonProcessLanes(tDaemon * daemon);
+static void DaemonStartLaneJob(tLane * lane);
+static void DaemonFinishJob(tLane * lane);
+static void DaemonReleaseJob(tLane * lane, tJob * job);
+static void DaemonReportProgress(tLane * lane);
+static void DaemonAcceptClient(tDaemon * daemon, int listenSocket);
+static bool DaemonReadClient(tDaemon * daemon, tClient * client);
+static bool DaemonWriteClient(tClient * client);
+static void DaemonCloseClient(tDaemon * daemon, tClient * client);
+static void DaemonSubmitJob(tDaemon * daemon, tClient * client, char const * line);
+static tImage * DaemonLoadImage(char const * file);
+static void DaemonFreeImage(tImage * image);
+#endif
 static void ExtractProgramSettingsFromCommandLine(int argc, char const * const argv[],
                                                   tProgramSettings * programSettings);
+static void ExtractEmulationSettings(char const * options,
+                                     tBltTransportSettingsXcpV10Emu * emulation);
 static uint32_t ExtractSessionTypeFromCommandLine(int argc, char const * const argv[]);
 static void * ExtractSessionSettingsFromCommandLine(int argc, char const * const argv[],
                                                     uint32_t sessionType);
@@ -106,13 +447,40 @@ static uint32_t ExtractTransportTypeFromCommandLine(int argc, char const * const
 static void * ExtractTransportSettingsFromCommandLine(int argc, 
                                                       char const * const argv[],
                                                       uint32_t transportType);
-static char const * const ExtractFirmwareFileFromCommandLine(int argc, 
-                                                             char const * const argv[]);
+static char const * ExtractFirmwareFileFromCommandLine(int argc, 
+                                                       char const * const argv[]);
 static char const * GetLineTrailerByResult(bool errorDetected);
 static char const * GetLineTrailerByPercentage(uint8_t percentage);
 static void ErasePercentageTrailer(void);
 
 
+/****************************************************************************************
+* Local constant declarations
+****************************************************************************************/
+/** \brief Names of the operations on a target, as reported in the JSON output. */
+static char const * const targetOperationNames[] =
+{
+  "flash", "verify", "read"
+};
+
+/** \brief Names of the steps of the operation on a target, as reported in the JSON
+ *         output.
+ */
+static char const * const targetStepNames[] =
+{
+  "connect", "erase", "program", "verify", "read", "finish", "done"
+};
+
+
+#if defined (PLATFORM_LINUX)
+/****************************************************************************************
+* Local data declarations
+****************************************************************************************/
+/** \brief Set by the signal handler to request the daemon to stop. */
+static volatile sig_atomic_t daemonStopRequested;
+#endif
+
+
 /************************************************************************************//**
 ** \brief     This is the program entry point.
 ** \param     argc Number of program arguments.
@@ -167,9 +535,39 @@ int main(int argc, char const * const argv[])
      */
     bool appTransportSettingsOkay = (appTransportType == BLT_TRANSPORT_XCP_V10_USB) ?
       true : (appTransportSettings != NULL);
-    /* Check the settings that were detected so far. */
-    if ( (appSessionSettings == NULL) || (!appTransportSettingsOkay) ||
-        (appFirmwareFile == NULL) )
+    /* Check the settings that were detected so far. In batch mode, the transport
+     * settings and the firmware file can also be specified per job in the batch
+     * manifest file. They are checked when it is read. The same goes for the jobs that
+     * the daemon receives.
+     */
+    if (appProgramSettings.daemonSocket != NULL)
+    {
+#if defined (PLATFORM_LINUX)
+      /* The daemon runs the jobs of its clients, so it cannot be combined with batch
+       * mode or with updating multiple targets in parallel.
+       */
+      if ( (appProgramSettings.targetList != NULL) ||
+           (appProgramSettings.manifestFile != NULL) )
+      {
+        /* Set error code. */
+        result = RESULT_ERROR_COMMANDLINE;
+      }
+#else
+      /* The daemon is only supported on Linux. */
+      result = RESULT_ERROR_COMMANDLINE;
+#endif
+    }
+    else if (appProgramSettings.manifestFile != NULL)
+    {
+      /* Batch mode cannot be combined with updating multiple targets in parallel. */
+      if (appProgramSettings.targetList != NULL)
+      {
+        /* Set error code. */
+        result = RESULT_ERROR_COMMANDLINE;
+      }
+    }
+    else if ( (appSessionSettings == NULL) || (!appTransportSettingsOkay) ||
+              (appFirmwareFile == NULL) )
     {
       /* Set error code. */
       result = RESULT_ERROR_COMMANDLINE;
@@ -184,18 +582,59 @@ int main(int argc, char const * const argv[])
   }
   
   /* -------------------- Display detected parameters -------------------------------- */
-  if ( (result == RESULT_OK) && (!appProgramSettings.silentMode) )
+  if ( (result == RESULT_OK) && (!appProgramSettings.silentMode) &&
+       (appProgramSettings.daemonSocket != NULL) )
+  {
+    /* Display the socket of the daemon. The settings of the jobs are reported to the
+     * clients.
+     */
+    printf("Detected daemon socket: %s\n", appProgramSettings.daemonSocket);
+  }
+  else if ( (result == RESULT_OK) && (!appProgramSettings.silentMode) &&
+            (appProgramSettings.manifestFile != NULL) )
+  {
+    /* Display the batch manifest file. The settings of the jobs are displayed when it
+     * is read.
+     */
+    printf("Detected batch manifest file: %s\n", appProgramSettings.manifestFile);
+  }
+  else if ( (result == RESULT_OK) && (!appProgramSettings.silentMode) )
   {
     /* Display firmware file. */
     printf("Detected firmware file: %s\n", appFirmwareFile);
+    /* Display the targets to update in parallel. */
+    if (appProgramSettings.targetList != NULL)
+    {
+      printf("Detected targets: %s\n", appProgramSettings.targetList);
+    }
     /* Display session info. */
     DisplaySessionInfo(appSessionType, appSessionSettings);
     /* Display transport info. */
     DisplayTransportInfo(appTransportType, appTransportSettings);
+    /* Display network emulation info. */
+    if (appProgramSettings.emulate)
+    {
+      DisplayEmulationInfo(&appProgramSettings.emulation);
+    }
   }
   
+  /* -------------------- Firmware cache --------------------------------------------- */
+  if ( (result == RESULT_OK) && (appProgramSettings.firmwareCache != NULL) )
+  {
+    /* Display the directory of the firmware cache. */
+    if (!appProgramSettings.silentMode)
+    {
+      printf("Detected firmware cache: %s\n", appProgramSettings.firmwareCache);
+    }
+    /* Take the firmware data of files that were loaded before from the cache, instead
+     * of parsing them again. This applies to all modes.
+     */
+    BltFirmwareSetCache(appProgramSettings.firmwareCache, FIRMWARE_CACHE_SIZE_MAX);
+  }
+
   /* -------------------- Firmware loading ------------------------------------------- */
-  if (result == RESULT_OK)
+  if ( (result == RESULT_OK) && (appProgramSettings.manifestFile == NULL) &&
+       (appProgramSettings.daemonSocket == NULL) )
   {
     printf("Loading firmware data from file..."); (void)fflush(stdout); 
     /* Initialize the firmware data module using the S-record parser. */
@@ -259,12 +698,25 @@ int main(int argc, char const * const argv[])
   }
   
   /* -------------------- Session starting ------------------------------------------- */
-  if (result == RESULT_OK)
+  if ( (result == RESULT_OK) && (appProgramSettings.targetList == NULL) &&
+       (appProgramSettings.manifestFile == NULL) &&
+       (appProgramSettings.daemonSocket == NULL) )
   {
     /* Initialize the session. */
     printf("Connecting to target bootloader..."); (void)fflush(stdout);
-    BltSessionInit(appSessionType,appSessionSettings, 
-                  appTransportType, appTransportSettings);
+    /* Wrap the transport layer in the network emulation, if requested. */
+    if (appProgramSettings.emulate)
+    {
+      appProgramSettings.emulation.transportType = appTransportType;
+      appProgramSettings.emulation.transportSettings = appTransportSettings;
+      BltSessionInit(appSessionType, appSessionSettings, BLT_TRANSPORT_XCP_V10_EMU,
+                     &appProgramSettings.emulation);
+    }
+    else
+    {
+      BltSessionInit(appSessionType,appSessionSettings, 
+                    appTransportType, appTransportSettings);
+    }
     /* Start the session. */
     if (BltSessionStart() != BLT_RESULT_OK)
     {
@@ -283,7 +735,9 @@ int main(int argc, char const * const argv[])
   }
 
   /* -------------------- Erase operation -------------------------------------------- */
-  if (result == RESULT_OK)
+  if ( (result == RESULT_OK) && (appProgramSettings.targetList == NULL) &&
+       (appProgramSettings.manifestFile == NULL) &&
+       (appProgramSettings.daemonSocket == NULL) )
   {
     uint32_t segmentIdx;
     uint32_t segmentLen;
@@ -364,7 +818,9 @@ int main(int argc, char const * const argv[])
   }  
   
   /* -------------------- Program operation ------------------------------------------ */
-  if (result == RESULT_OK)
+  if ( (result == RESULT_OK) && (appProgramSettings.targetList == NULL) &&
+       (appProgramSettings.manifestFile == NULL) &&
+       (appProgramSettings.daemonSocket == NULL) )
   {
     uint32_t segmentIdx;
     uint32_t segmentLen;
@@ -446,19 +902,60 @@ int main(int argc, char const * const argv[])
   }
 
   /* -------------------- Session stopping ------------------------------------------- */
-  if (result == RESULT_OK)
+  if ( (result == RESULT_OK) && (appProgramSettings.targetList == NULL) &&
+       (appProgramSettings.manifestFile == NULL) &&
+       (appProgramSettings.daemonSocket == NULL) )
   {
-    /* Stop the session. */
+    /* Stop the session. This fails if the programming session could not be completed
+     * properly, in which case the bootloader does not start the user program.
+     */
     printf("Finishing programming session..."); (void)fflush(stdout);
-    BltSessionStop();
-    printf("%s\n", GetLineTrailerByResult((bool)false));
+    if (BltSessionStop() != BLT_RESULT_OK)
+    {
+      result = RESULT_ERROR_MEMORY_PROGRAM;
+    }
+    printf("%s\n", GetLineTrailerByResult((bool)(result != RESULT_OK)));
+    /* Output the command/response latency statistics. */
+    if (!appProgramSettings.silentMode)
+    {
+      DisplayLatencyInfo();
+    }
   }
 
+  /* -------------------- Parallel firmware update ----------------------------------- */
+  if ( (result == RESULT_OK) && (appProgramSettings.targetList != NULL) )
+  {
+    /* Update the firmware on all targets at the same time, with the firmware data that
+     * was loaded once.
+     */
+    result = UpdateTargetsInParallel(&appProgramSettings, appSessionType,
+                                     appSessionSettings, appTransportType,
+                                     appTransportSettings);
+  }
+
+  /* -------------------- Batch firmware update -------------------------------------- */
+  if ( (result == RESULT_OK) && (appProgramSettings.manifestFile != NULL) )
+  {
+    /* Run the jobs of the batch manifest file. */
+    result = RunBatch(&appProgramSettings, argc, argv);
+  }
+
+#if defined (PLATFORM_LINUX)
+  /* -------------------- Daemon ----------------------------------------------------- */
+  if ( (result == RESULT_OK) && (appProgramSettings.daemonSocket != NULL) )
+  {
+    /* Run the jobs of the clients until the daemon is stopped. */
+    result = RunDaemon(&appProgramSettings, argc, argv);
+  }
+#endif
+
   /* -------------------- Cleanup ---------------------------------------------------- */
   /* Terminate the session. */
   BltSessionTerminate();
   /* Terminate the firmware data module. */
   BltFirmwareTerminate();
+  /* Disable the firmware cache. */
+  BltFirmwareSetCache(NULL, 0);
   /* Free allocated memory */
   free(appTransportSettings);
   free(appSessionSettings);
@@ -500,6 +997,7 @@ static void DisplayProgramUsage(void)
   printf("                     xcp_can             -> XCP on CAN.\n");
   printf("                     xcp_usb             -> XCP on USB.\n");
   printf("                     xcp_net             -> XCP on TCP/IP.\n");
+  printf("                     xcp_udp             -> XCP on UDP/IP.\n");
   printf("\n");                   
   printf("XCP version 1.0 settings (xcp):\n");
   printf("  -t1=[timeout]    Command response timeout in milliseconds as a 16-bit\n");
@@ -523,7 +1021,8 @@ static void DisplayProgramUsage(void)
   printf("                   /dev/ttyUSB0 (Mandatory).\n");
   printf("  -b=[value]       The communication speed, a.k.a baudrate in bits per\n");
   printf("                   second, as a 32-bit value (Default = 57600).\n");
-  printf("                   Supported values: 9600, 19200, 38400, 57600, 115200.\n");
+  printf("                   Standard values range from 9600 to 4000000. Other\n");
+  printf("                   values work if the serial port driver supports them.\n");
   printf("\n");  
   printf("XCP on CAN settings (xcp_can):\n");
   printf("  -d=[name]        Name of the CAN device (Mandatory). On Linux this is\n");
@@ -551,6 +1050,9 @@ static void DisplayProgramUsage(void)
   printf("  -xid=[value]     Configures the 'tid' and 'rid' CAN identifier values\n");
   printf("                   as 29-bit CAN identifiers, if this 8-bit value is > 0\n");
   printf("                   (Default = 0).\n");
+  printf("  -fg=[value]      Minimum time between transmitted CAN frames in micro-\n");
+  printf("                   seconds, as a 32-bit value (Default = 0). Currently\n");
+  printf("                   only supported on Linux.\n");
   printf("\n");                   
   printf("XCP on USB settings (xcp_usb):\n");
   printf("  No additional settings needed.\n");
@@ -560,10 +1062,61 @@ static void DisplayProgramUsage(void)
   printf("                   For example 192.168.178.23 (Mandatory).\n");
   printf("  -p=[value]       The TCP port number to use, as a 16-bit value (Default\n");
   printf("                   = 1000).\n");
+  printf("  -w=[value]       Maximum number of program commands in flight, as a\n");
+  printf("                   32-bit value (Default = 1). Only use values larger\n");
+  printf("                   than 1 if the target buffers received commands.\n");
+  printf("\n");
+  printf("XCP on UDP/IP settings (xcp_udp):\n");
+  printf("  -a=[value]       The IP address or hostname of the target to connect to.\n");
+  printf("                   For example 192.168.178.23 (Mandatory).\n");
+  printf("  -p=[value]       The UDP port number to use, as a 16-bit value (Default\n");
+  printf("                   = 1000).\n");
+  printf("  -w=[value]       Maximum number of program commands in flight, as a\n");
+  printf("                   32-bit value (Default = 1). Only use values larger\n");
+  printf("                   than 1 if the target buffers received datagrams.\n");
   printf("\n");
   printf("Program settings:\n");
   printf("  -sm              Silent mode switch. When specified, only minimal\n");
   printf("                   information is written to the output (Optional).\n");
+  printf("  -mt=[list]       Comma separated list of targets to update in parallel,\n");
+  printf("                   with the firmware file that is loaded once (Optional).\n");
+  printf("                   The list holds the device names for xcp_rs232, the\n");
+  printf("                   'tid:rid' hexadecimal CAN identifier pairs for xcp_can\n");
+  printf("                   and the addresses with an optional ':port' for xcp_net\n");
+  printf("                   and xcp_udp. Other settings apply to all targets.\n");
+  printf("  -emu=[options]   Emulates a poor network on top of the transport layer,\n");
+  printf("                   for testing and benchmarking (Optional). Comma\n");
+  printf("                   separated list with the delay=[us] and jitter=[us] of\n");
+  printf("                   each command, the loss=[%%], dup=[%%] and reorder=[%%]\n");
+  printf("                   probabilities and the seed=[value] of the pseudo\n");
+  printf("                   random faults. For example:\n");
+  printf("                   -emu=delay=2000,jitter=500,loss=0.01,seed=7\n");
+  printf("  -bm=[file]       Batch manifest file with a firmware update job on each\n");
+  printf("                   line (Optional). A job is a firmware file, followed by\n");
+  printf("                   options that add to or override the ones on the\n");
+  printf("                   command line, such as the transport layer and target.\n");
+  printf("                   Each firmware file is loaded once. Jobs on the same\n");
+  printf("                   interface run one after the other, on a connection\n");
+  printf("                   that stays open for RS232 and CAN. Jobs on different\n");
+  printf("                   interfaces run in parallel. The result and the timing\n");
+  printf("                   of each job are written as a line in JSON format.\n");
+  printf("                   Only one CAN bus is supported, so all CAN jobs must\n");
+  printf("                   use the same device, channel and baudrate.\n");
+  printf("  -ds=[socket]     Runs as a daemon that accepts jobs on this UNIX domain\n");
+  printf("                   socket (Optional, Linux only). Each line that a client\n");
+  printf("                   sends is a flash, verify or read command, followed by\n");
+  printf("                   a job like in the batch manifest file. A read job\n");
+  printf("                   needs -ra=[hex address] and -rl=[length] and writes to\n");
+  printf("                   the S-record file of the job. Firmware files are kept\n");
+  printf("                   in the firmware cache, which is [socket].cache unless\n");
+  printf("                   -fc is specified, and connections stay open between\n");
+  printf("                   jobs. Answers, progress and results are written as\n");
+  printf("                   lines in JSON format.\n");
+  printf("  -fc=[directory]  Existing directory for a cache with the parsed data of\n");
+  printf("                   firmware files (Optional). A firmware file is looked\n");
+  printf("                   up by the SHA-256 hash of its contents, so it is only\n");
+  printf("                   parsed again after it changed. The least recently used\n");
+  printf("                   data is removed once the cache exceeds 256 MB.\n");
   printf("\n");
   printf("Note that it is not necessary to specify an option if its default value\n");
   printf("is already the desired value.\n");
@@ -660,6 +1213,9 @@ static void DisplayTransportInfo(uint32_t transportType, void const * transportS
     case BLT_TRANSPORT_XCP_V10_NET:
       printf("XCP on TCP/IP\n");
       break;
+    case BLT_TRANSPORT_XCP_V10_UDP:
+      printf("XCP on UDP/IP\n");
+      break;
     default:
       printf("Unknown\n");
       break;
@@ -734,6 +1290,7 @@ static void DisplayTransportInfo(uint32_t transportType, void const * transportS
         {
           printf("No\n");
         }
+        printf("  -> Minimum frame gap: %u us\n", xcpCanSettings->txFrameGap);
       }
       break;
     }
@@ -767,6 +1324,36 @@ static void DisplayTransportInfo(uint32_t transportType, void const * transportS
           printf("Unknown\n");
         }
         printf("  -> Port: %hu \n", xcpNetSettings->port);
+        printf("  -> Window: %u\n", xcpNetSettings->window);
+      }
+      break;
+    }
+    case BLT_TRANSPORT_XCP_V10_UDP:
+    {
+      /* Check settings pointer. */
+      assert(transportSettings);
+      if (transportSettings == NULL) /*lint !e774 */
+      {
+        /* No valid settings present. */
+        printf("  -> Invalid settings specified\n");
+      }
+      else
+      {
+        tBltTransportSettingsXcpV10Udp * xcpUdpSettings =
+          (tBltTransportSettingsXcpV10Udp *)transportSettings;
+
+        /* Output the settings to the user. */
+        printf("  -> Address: ");
+        if (xcpUdpSettings->address != NULL)
+        {
+          printf("%s\n", xcpUdpSettings->address);
+        }
+        else
+        {
+          printf("Unknown\n");
+        }
+        printf("  -> Port: %hu \n", xcpUdpSettings->port);
+        printf("  -> Window: %u\n", xcpUdpSettings->window);
       }
       break;
     }
@@ -777,6 +1364,23 @@ static void DisplayTransportInfo(uint32_t transportType, void const * transportS
 } /*** end of DisplayTransportInfo ***/
 
 
+/************************************************************************************//**
+** \brief     Displays the network emulation settings on the standard output.
+** \param     emulation The detected network emulation settings.
+**
+****************************************************************************************/
+static void DisplayEmulationInfo(tBltTransportSettingsXcpV10Emu const * emulation)
+{
+  printf("Detected network emulation:\n");
+  printf("  -> Delay: %u us\n", emulation->delay);
+  printf("  -> Jitter: %u us\n", emulation->jitter);
+  printf("  -> Loss: %.4f %%\n", emulation->loss / 10000.0);
+  printf("  -> Duplication: %.4f %%\n", emulation->duplicate / 10000.0);
+  printf("  -> Reordering: %.4f %%\n", emulation->reorder / 10000.0);
+  printf("  -> Seed: %u\n", emulation->seed);
+} /*** end of DisplayEmulationInfo ***/
+
+
 /************************************************************************************//**
 ** \brief     Displays firmware data information on the standard output.
 ** \param     segments Total number of firmware data segments
@@ -796,105 +1400,2887 @@ static void DisplayFirmwareDataInfo(uint32_t segments, uint32_t base, uint32_t s
 
 
 /************************************************************************************//**
-** \brief     Parses the command line to extract the program settings. 
-** \param     argc Number of program arguments.
-** \param     argv Array with program parameter strings.
-** \param     programSettings Pointer to the setting structure where the program settings
-**            should be written to.
+** \brief     Displays the command/response latency statistics of the session on the
+**            standard output. The host part is the time spent in this program, the
+**            library and the operating system. The wire part is the time spent on the
+**            communication medium and in the target.
 **
 ****************************************************************************************/
-static void ExtractProgramSettingsFromCommandLine(int argc, char const * const argv[],
-                                                  tProgramSettings * programSettings)
+static void DisplayLatencyInfo(void)
 {
-  uint8_t paramIdx;
-
-  /* Check parameters. */
-  assert(argv != NULL);
-  assert(programSettings != NULL);
+  tBltSessionLatency latency;
 
-  /* Only continue if parameters are valid. */
-  if ( (argv != NULL) && (programSettings != NULL) ) /*lint !e774 */
+  /* Only output the statistics if available. */
+  if ( (BltSessionGetLatency(&latency) == BLT_RESULT_OK) && (latency.count > 0) )
   {
-    /* Set default program settings. */
-    programSettings->silentMode = false;
-    /* Loop through all the command line parameters, just skip the 1st one because
-     * this  is the name of the program, which we are not interested in.
-     */
-    for (paramIdx = 1; paramIdx < argc; paramIdx++)
-    {
-      /* Is this the -sm parameter? */
-      if ( (strstr(argv[paramIdx], "-sm") != NULL) &&
-           (strlen(argv[paramIdx]) == 3) )
-      {
-        /* Activate silent mode. */
-        programSettings->silentMode = true;
-        /* Continue with next loop iteration. */
-        continue;
-      }
-    }
+    printf("Command/response latency:\n");
+    /* Output the number of measured exchanges. */
+    printf("  -> Number of exchanges: %u\n", latency.count);
+    /* Output the averages. */
+    printf("  -> Average total: %u us\n", latency.totalAvg);
+    printf("  -> Average host: %u us\n", latency.hostAvg);
+    printf("  -> Average wire/target: %u us\n", latency.wireAvg);
+    /* Output the worst case. */
+    printf("  -> Maximum total: %u us\n", latency.totalMax);
+    printf("  -> 99th percentile total: %u us\n", latency.totalP99);
   }
-} /*** end of ExtractProgramSettingsFromCommandLine ***/
+} /*** end of DisplayLatencyInfo ***/
 
 
 /************************************************************************************//**
-** \brief     Parses the command line to extract the session type. This is the one
-**            specified via the -s=[name] parameter.
-** \param     argc Number of program arguments.
-** \param     argv Array with program parameter strings.
-** \return    The session type value as used in LibOpenBLT.
+** \brief     Displays the throughput of a firmware update on the standard output.
+** \param     name Name of the target or NULL for the aggregate of all targets.
+** \param     bytes Number of firmware data bytes that were programmed.
+** \param     timeMs Time in milliseconds that the firmware update took.
 **
 ****************************************************************************************/
-static uint32_t ExtractSessionTypeFromCommandLine(int argc, char const * const argv[])
+static void DisplayThroughputInfo(char const * name, uint32_t bytes, uint32_t timeMs)
 {
-  uint32_t result;
-  uint8_t paramIdx;
-  uint8_t mapIdx; 
-  /* Mapping of the supported session types to the session type values. */
-  const struct
+  uint32_t bytesPerSec;
+
+  /* Prevent a division by zero for very fast updates. */
+  if (timeMs == 0)
   {
-    char * name;
-    uint32_t value;
-  } sessionMap[] =
+    timeMs = 1;
+  }
+  /* Determine the throughput. */
+  bytesPerSec = (uint32_t)(((uint64_t)bytes * 1000u) / timeMs);
+  /* Output the throughput. */
+  if (name != NULL)
   {
-    { .name = "xcp",  .value = BLT_SESSION_XCP_V10 }
-  };
-  
-  /* Set the default session in case nothing was specified on the command line. */
-  result = sessionMap[0].value;
+    printf("  -> Target %s: ", name);
+  }
+  else
+  {
+    printf("  -> All targets: ");
+  }
+  printf("%u bytes in %u.%03u s (%u.%u kB/s)\n", bytes, timeMs / 1000u, timeMs % 1000u,
+         bytesPerSec / 1024u, ((bytesPerSec % 1024u) * 10u) / 1024u);
+} /*** end of DisplayThroughputInfo ***/
+
+
+/************************************************************************************//**
+** \brief     Updates the firmware on multiple targets at the same time. Each target gets
+**            its own session, which erases and programs the firmware data that was
+**            loaded once. The sessions execute their operations in the background,
+**            while this function processes their events.
+** \param     programSettings The program settings with the list of targets.
+** \param     sessionType The session type for all targets.
+** \param     sessionSettings The session settings for all targets.
+** \param     transportType The transport type for all targets.
+** \param     transportSettings The transport settings that the settings of each target
+**            are based on.
+** \return    Program return code. RESULT_OK if all targets were updated, the error code
+**            of the first failed target otherwise.
+**
+****************************************************************************************/
+static int UpdateTargetsInParallel(tProgramSettings const * programSettings,
+                                   uint32_t sessionType, void const * sessionSettings,
+                                   uint32_t transportType,
+                                   void const * transportSettings)
+{
+  int result = RESULT_ERROR_COMMANDLINE;
+  tTarget * targets;
+  tTarget * target;
+  uint32_t targetCount = 0;
+  uint32_t targetIdx;
+  uint32_t doneCount;
+  uint32_t startTime;
+  uint32_t totalBytes = 0;
+  tBltTransportSettingsXcpV10Emu emulation;
+  tImage image = { 0 };
 
   /* Check parameters. */
-  assert(argv != NULL);
+  assert(programSettings != NULL);
+  assert(programSettings->targetList != NULL);
 
-  /* Only continue if parameters are valid. */
-  if (argv != NULL) /*lint !e774 */
+  /* Create the targets from the target list. They all program the firmware data of the
+   * firmware data module, so it does not need to be copied.
+   */
+  targets = CreateTargets(programSettings->targetList, transportType,
+                          transportSettings, &targetCount);
+  if ( (targets != NULL) && (!CreateImage(&image, false)) )
   {
-    /* Loop through all the command line parameters, just skip the 1st one because this
-     * is the name of the program, which we are not interested in.
-     */
-    for (paramIdx = 1; paramIdx < argc; paramIdx++)
+    DestroyTargets(targets, targetCount);
+    targets = NULL;
+  }
+  printf("Creating sessions for %u targets...", targetCount); (void)fflush(stdout);
+  /* Create a session for each target and start connecting to it. */
+  if (targets != NULL)
+  {
+    result = RESULT_OK;
+    for (targetIdx = 0; targetIdx < targetCount; targetIdx++)
     {
-      /* Check of the if -s is present in this argument. Note that the argument must have
-       * at least 4 characters to be a valid -s=[name] parameter.
-       */
-      if ( (strstr(argv[paramIdx], "-s=") != NULL) && (strlen(argv[paramIdx]) > 3) )
+      target = &targets[targetIdx];
+      target->silentMode = programSettings->silentMode;
+      target->image = &image;
+      /* Wrap the transport layer in the network emulation, if requested. */
+      if (programSettings->emulate)
       {
-        /* Loop through the map to find a matching session name. */
-        for (mapIdx = 0; mapIdx < sizeof(sessionMap)/sizeof(sessionMap[0]); mapIdx++)
-        {
-          /* Check for matching name. */
-          if (strcmp(sessionMap[mapIdx].name, &argv[paramIdx][3]) == 0)
-          {
-            /* Match found, now store the associated session type value. */
-            result = sessionMap[mapIdx].value;
-            /* No need to continue searching. */
-            break;
-          }
-        }
+        emulation = programSettings->emulation;
+        emulation.transportType = transportType;
+        emulation.transportSettings = target->transportSettings;
+        target->session = BltSessionCreate(sessionType, sessionSettings,
+                                           BLT_TRANSPORT_XCP_V10_EMU, &emulation);
+      }
+      else
+      {
+        target->session = BltSessionCreate(sessionType, sessionSettings, transportType,
+                                           target->transportSettings);
+      }
+      if (target->session == NULL)
+      {
+        /* Set error code. */
+        result = RESULT_ERROR_COMMANDLINE;
+        break;
       }
     }
   }
-  /* Give the result back to the caller. */
-  return result;
+  printf("%s\n", GetLineTrailerByResult((bool)(result != RESULT_OK)));
+
+  /* Only continue if all sessions were created. */
+  if (result == RESULT_OK)
+  {
+    printf("Updating targets in parallel...\n"); (void)fflush(stdout);
+    startTime = BltUtilTimeGetSystemTime();
+    /* Submit the first operation of each target. */
+    for (targetIdx = 0; targetIdx < targetCount; targetIdx++)
+    {
+      SubmitTargetOperation(&targets[targetIdx]);
+    }
+    /* Process the events of the sessions until all targets are done. The event callback
+     * submits the next operation of a target, once its previous operation completed.
+     */
+    do
+    {
+      (void)BltSessionProcessEvents(TARGET_CONNECT_RETRY_MS);
+      doneCount = 0;
+      for (targetIdx = 0; targetIdx < targetCount; targetIdx++)
+      {
+        /* Retry connecting to a target that did not yet respond. */
+        if ( (targets[targetIdx].connectRetry) &&
+             ((BltUtilTimeGetSystemTime() - targets[targetIdx].connectTime) >=
+              TARGET_CONNECT_RETRY_MS) )
+        {
+          targets[targetIdx].connectRetry = false;
+          SubmitTargetOperation(&targets[targetIdx]);
+        }
+        /* Count the targets that are done. */
+        if (targets[targetIdx].step == TARGET_STEP_DONE)
+        {
+          doneCount++;
+        }
+      }
+    }
+    while (doneCount < targetCount);
+
+    /* Determine the overall result and output the throughput of each target. */
+    printf("Firmware update throughput:\n");
+    for (targetIdx = 0; targetIdx < targetCount; targetIdx++)
+    {
+      if (targets[targetIdx].result == RESULT_OK)
+      {
+        totalBytes += targets[targetIdx].processedBytes;
+        DisplayThroughputInfo(targets[targetIdx].name,
+                              targets[targetIdx].processedBytes,
+                              targets[targetIdx].endTime - targets[targetIdx].startTime);
+      }
+      else if (result == RESULT_OK)
+      {
+        result = targets[targetIdx].result;
+      }
+    }
+    /* The aggregate throughput also covers the time it took to connect. */
+    DisplayThroughputInfo(NULL, totalBytes, BltUtilTimeGetSystemTime() - startTime);
+    printf("Updating targets in parallel...");
+    printf("%s\n", GetLineTrailerByResult((bool)(result != RESULT_OK)));
+  }
+
+  /* Release the sessions, the targets and the image. */
+  DestroyTargets(targets, targetCount);
+  DestroyImage(&image);
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UpdateTargetsInParallel ***/
+
+
+/************************************************************************************//**
+** \brief     Creates the targets from a comma separated target list. The transport
+**            settings of each target are a copy of the specified transport settings,
+**            with the value from the target list filled in. The targets should be
+**            released with DestroyTargets.
+** \param     targetList Comma separated list of targets.
+** \param     transportType The transport type of the targets.
+** \param     transportSettings The transport settings that the settings of each target
+**            are based on.
+** \param     targetCount Pointer where the number of targets is written to.
+** \return    Array with the targets or NULL if the list is invalid for the transport
+**            type or if out of memory.
+**
+****************************************************************************************/
+static tTarget * CreateTargets(char const * targetList, uint32_t transportType,
+                               void const * transportSettings, uint32_t * targetCount)
+{
+  tTarget * result = NULL;
+  size_t settingsSize = 0;
+  uint32_t count = 1;
+  uint32_t targetIdx;
+  char const * item;
+  char const * itemEnd;
+  size_t itemLen;
+  char * portSeparator;
+  bool okay = true;
+
+  /* Check parameters. */
+  assert(targetList != NULL);
+  assert(targetCount != NULL);
+
+  /* Determine the size of the transport settings. Only transport layers that select
+   * the target with a setting are supported.
+   */
+  switch (transportType)
+  {
+    case BLT_TRANSPORT_XCP_V10_RS232:
+      settingsSize = sizeof(tBltTransportSettingsXcpV10Rs232);
+      break;
+    case BLT_TRANSPORT_XCP_V10_CAN:
+      settingsSize = sizeof(tBltTransportSettingsXcpV10Can);
+      break;
+    case BLT_TRANSPORT_XCP_V10_NET:
+      settingsSize = sizeof(tBltTransportSettingsXcpV10Net);
+      break;
+    case BLT_TRANSPORT_XCP_V10_UDP:
+      settingsSize = sizeof(tBltTransportSettingsXcpV10Udp);
+      break;
+    default:
+      okay = false;
+      break;
+  }
+  /* Count the targets in the list. */
+  for (item = targetList; *item != '\0'; item++)
+  {
+    if (*item == ',')
+    {
+      count++;
+    }
+  }
+  /* Allocate the targets. */
+  if ( (okay) && (transportSettings != NULL) )
+  {
+    result = calloc(count, sizeof(tTarget));
+  }
+
+  /* Only continue if the allocation was successful. */
+  if (result != NULL)
+  {
+    item = targetList;
+    for (targetIdx = 0; targetIdx < count; targetIdx++)
+    {
+      /* Determine the length of this item. */
+      itemEnd = strchr(item, ',');
+      itemLen = (itemEnd != NULL) ? (size_t)(itemEnd - item) : strlen(item);
+      /* Store the name and the value that the transport settings refer to. */
+      result[targetIdx].step = TARGET_STEP_CONNECT;
+      result[targetIdx].result = RESULT_OK;
+      result[targetIdx].name = malloc(itemLen + 1);
+      result[targetIdx].transportValue = malloc(itemLen + 1);
+      result[targetIdx].transportSettings = malloc(settingsSize);
+      if ( (itemLen == 0) || (result[targetIdx].name == NULL) ||
+           (result[targetIdx].transportValue == NULL) ||
+           (result[targetIdx].transportSettings == NULL) )
+      {
+        okay = false;
+        break;
+      }
+      memcpy(result[targetIdx].name, item, itemLen);
+      result[targetIdx].name[itemLen] = '\0';
+      strcpy(result[targetIdx].transportValue, result[targetIdx].name);
+      memcpy(result[targetIdx].transportSettings, transportSettings, settingsSize);
+      /* Fill in the value from the target list. */
+      switch (transportType)
+      {
+        case BLT_TRANSPORT_XCP_V10_RS232:
+        {
+          tBltTransportSettingsXcpV10Rs232 * rs232Settings =
+            (tBltTransportSettingsXcpV10Rs232 *)result[targetIdx].transportSettings;
+          rs232Settings->portName = result[targetIdx].transportValue;
+          break;
+        }
+        case BLT_TRANSPORT_XCP_V10_CAN:
+        {
+          tBltTransportSettingsXcpV10Can * canSettings =
+            (tBltTransportSettingsXcpV10Can *)result[targetIdx].transportSettings;
+          /* The item holds the hexadecimal transmit and receive CAN identifiers. */
+          if (sscanf(result[targetIdx].transportValue, "%x:%x",
+                     &(canSettings->transmitId), &(canSettings->receiveId)) != 2)
+          {
+            okay = false;
+          }
+          break;
+        }
+        case BLT_TRANSPORT_XCP_V10_NET:
+        case BLT_TRANSPORT_XCP_V10_UDP:
+        {
+          /* The TCP/IP and UDP/IP settings share the same layout of the address and port
+           * fields. Check this to be sure.
+           */
+          tBltTransportSettingsXcpV10Net * netSettings =
+            (tBltTransportSettingsXcpV10Net *)result[targetIdx].transportSettings;
+          assert(offsetof(tBltTransportSettingsXcpV10Net, port) ==
+                 offsetof(tBltTransportSettingsXcpV10Udp, port));
+          /* The item holds the address with an optional port number. */
+          portSeparator = strrchr(result[targetIdx].transportValue, ':');
+          if (portSeparator != NULL)
+          {
+            *portSeparator = '\0';
+            if (sscanf(portSeparator + 1, "%hu", &(netSettings->port)) != 1)
+            {
+              okay = false;
+            }
+          }
+          netSettings->address = result[targetIdx].transportValue;
+          break;
+        }
+        default:
+          break;
+      }
+      /* Continue with the next item. */
+      item += itemLen + 1;
+    }
+    /* Release the targets again if the list was invalid. */
+    if (!okay)
+    {
+      DestroyTargets(result, count);
+      result = NULL;
+    }
+  }
+  /* Store the number of targets. */
+  *targetCount = (result != NULL) ? count : 0;
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of CreateTargets ***/
+
+
+/************************************************************************************//**
+** \brief     Destroys the targets and their sessions.
+** \param     targets Array with the targets. Can be NULL.
+** \param     targetCount Number of targets in the array.
+**
+****************************************************************************************/
+static void DestroyTargets(tTarget * targets, uint32_t targetCount)
+{
+  uint32_t targetIdx;
+
+  /* Only continue with a valid array. */
+  if (targets != NULL)
+  {
+    for (targetIdx = 0; targetIdx < targetCount; targetIdx++)
+    {
+      /* Destroy the session, which also cancels its pending operations. */
+      if (targets[targetIdx].session != NULL)
+      {
+        BltSessionDestroy(targets[targetIdx].session);
+      }
+      free(targets[targetIdx].transportSettings);
+      free(targets[targetIdx].transportValue);
+      free(targets[targetIdx].name);
+    }
+    free(targets);
+  }
+} /*** end of DestroyTargets ***/
+
+
+/************************************************************************************//**
+** \brief     Submits the next operation on a target, based on its current step. The
+**            segments are erased in chunks and programmed or verified one at a time.
+**            Once all segments of a step were processed, the target continues with the
+**            next step.
+** \param     target The target.
+**
+****************************************************************************************/
+static void SubmitTargetOperation(tTarget * target)
+{
+  uint32_t submitResult = BLT_RESULT_OK;
+  uint32_t segmentLen = 0;
+  uint32_t segmentBase = 0;
+  uint8_t const * segmentData = NULL;
+  uint32_t chunkLen;
+
+  /* Check parameters. */
+  assert(target != NULL);
+
+  /* Advance to the next step once all segments of the current step were processed. */
+  if ( ((target->step == TARGET_STEP_ERASE) || (target->step == TARGET_STEP_PROGRAM) ||
+        (target->step == TARGET_STEP_VERIFY)) &&
+       (target->segmentIdx >= target->image->segmentCount) )
+  {
+    SetTargetStep(target, (target->step == TARGET_STEP_ERASE) ? TARGET_STEP_PROGRAM :
+                                                                TARGET_STEP_DISCONNECT);
+    target->segmentIdx = 0;
+    target->segmentOffset = 0;
+    if ( (!target->silentMode) && (target->step == TARGET_STEP_PROGRAM) )
+    {
+      printf("  -> Target %s: erased\n", target->name); (void)fflush(stdout);
+    }
+  }
+  /* Extract the info of the current segment. */
+  if ( (target->step == TARGET_STEP_ERASE) || (target->step == TARGET_STEP_PROGRAM) ||
+       (target->step == TARGET_STEP_VERIFY) )
+  {
+    segmentData = target->image->segments[target->segmentIdx].data;
+    segmentBase = target->image->segments[target->segmentIdx].base;
+    segmentLen = target->image->segments[target->segmentIdx].len;
+    /* Sanity check. */
+    assert( (segmentData != NULL) && (segmentLen > 0) );
+  }
+  /* Submit the operation of the current step. */
+  target->progress = 0;
+  switch (target->step)
+  {
+    case TARGET_STEP_CONNECT:
+      target->connectTime = BltUtilTimeGetSystemTime();
+      submitResult = BltSessionHandleStartAsync(target->session, TargetSessionCallback,
+                                                target);
+      break;
+    case TARGET_STEP_ERASE:
+      /* Erase the next chunk of the segment. */
+      chunkLen = segmentLen - target->segmentOffset;
+      if (chunkLen > TARGET_ERASE_CHUNK_SIZE)
+      {
+        chunkLen = TARGET_ERASE_CHUNK_SIZE;
+      }
+      submitResult = BltSessionHandleClearMemoryAsync(
+        target->session, segmentBase + target->segmentOffset, chunkLen,
+        TargetSessionCallback, target);
+      break;
+    case TARGET_STEP_PROGRAM:
+      /* Program the entire segment. The library splits it up in chunks. Note that all
+       * targets program the same firmware data, which is not changed while the
+       * operations are pending.
+       */
+      submitResult = BltSessionHandleWriteDataAsync(target->session, segmentBase,
+                                                    segmentLen, segmentData,
+                                                    TargetSessionCallback, target);
+      break;
+    case TARGET_STEP_VERIFY:
+      /* Read back the entire segment, such that it can be compared once read. */
+      submitResult = BltSessionHandleReadDataAsync(target->session, segmentBase,
+                                                   segmentLen, target->readBuffer,
+                                                   TargetSessionCallback, target);
+      break;
+    case TARGET_STEP_READ:
+      submitResult = BltSessionHandleReadDataAsync(target->session, target->readAddress,
+                                                   target->readLength,
+                                                   target->readBuffer,
+                                                   TargetSessionCallback, target);
+      break;
+    case TARGET_STEP_DISCONNECT:
+      submitResult = BltSessionHandleStopAsync(target->session, TargetSessionCallback,
+                                               target);
+      break;
+    default:
+      break;
+  }
+  /* Abort the operation on the target if the operation could not be submitted. */
+  if (submitResult != BLT_RESULT_OK)
+  {
+    switch (target->step)
+    {
+      case TARGET_STEP_ERASE:
+        target->result = RESULT_ERROR_MEMORY_ERASE;
+        break;
+      case TARGET_STEP_VERIFY:
+      case TARGET_STEP_READ:
+        target->result = RESULT_ERROR_MEMORY_READ;
+        break;
+      default:
+        target->result = RESULT_ERROR_MEMORY_PROGRAM;
+        break;
+    }
+    SetTargetStep(target, TARGET_STEP_DONE);
+  }
+} /*** end of SubmitTargetOperation ***/
+
+
+/************************************************************************************//**
+** \brief     Callback function for the events of the asynchronous session operations of
+**            the targets. It keeps track of the progress and once an operation
+**            completed, it submits the next operation on the target.
+** \param     event The event.
+** \param     context The target.
+**
+****************************************************************************************/
+static void TargetSessionCallback(tBltSessionEvent const * event, void * context)
+{
+  tTarget * target = (tTarget *)context;
+  tImageSegment const * segment;
+
+  /* Check parameters. */
+  assert(event != NULL);
+  assert(target != NULL);
+
+  /* Keep track of the progress of the pending operation. */
+  if (event->event == BLT_SESSION_EVENT_PROGRESS)
+  {
+    target->progress = event->progress;
+  }
+  /* Otherwise continue with the next operation once this one completed. */
+  else if (event->event == BLT_SESSION_EVENT_COMPLETED)
+  {
+    switch (target->step)
+    {
+      case TARGET_STEP_CONNECT:
+        if (event->result == BLT_RESULT_OK)
+        {
+          /* Connected, so continue with the first step of the operation. */
+          if (!target->silentMode)
+          {
+            printf("  -> Target %s: connected\n", target->name); (void)fflush(stdout);
+          }
+          target->startTime = BltUtilTimeGetSystemTime();
+          switch (target->operation)
+          {
+            case TARGET_OP_VERIFY:
+              SetTargetStep(target, TARGET_STEP_VERIFY);
+              break;
+            case TARGET_OP_READ:
+              SetTargetStep(target, TARGET_STEP_READ);
+              break;
+            default:
+              SetTargetStep(target, TARGET_STEP_ERASE);
+              break;
+          }
+          SubmitTargetOperation(target);
+        }
+        else
+        {
+          /* No response. Keep trying until the target responds, for example when its
+           * system is reset, just like for a single target.
+           */
+          target->connectRetry = true;
+        }
+        break;
+      case TARGET_STEP_ERASE:
+        if (event->result == BLT_RESULT_OK)
+        {
+          /* Continue with the next chunk or the next segment. */
+          target->segmentOffset += TARGET_ERASE_CHUNK_SIZE;
+          if (target->segmentOffset >= target->image->segments[target->segmentIdx].len)
+          {
+            target->segmentIdx++;
+            target->segmentOffset = 0;
+          }
+          SubmitTargetOperation(target);
+        }
+        else
+        {
+          target->result = RESULT_ERROR_MEMORY_ERASE;
+          SetTargetStep(target, TARGET_STEP_DONE);
+        }
+        break;
+      case TARGET_STEP_PROGRAM:
+        if (event->result == BLT_RESULT_OK)
+        {
+          /* Continue with the next segment. */
+          target->processedBytes += event->total;
+          target->segmentIdx++;
+          SubmitTargetOperation(target);
+        }
+        else
+        {
+          target->result = RESULT_ERROR_MEMORY_PROGRAM;
+          SetTargetStep(target, TARGET_STEP_DONE);
+        }
+        break;
+      case TARGET_STEP_VERIFY:
+        segment = &target->image->segments[target->segmentIdx];
+        if (event->result != BLT_RESULT_OK)
+        {
+          target->result = RESULT_ERROR_MEMORY_READ;
+          SetTargetStep(target, TARGET_STEP_DONE);
+        }
+        else if (memcmp(target->readBuffer, segment->data, segment->len) != 0)
+        {
+          target->result = RESULT_ERROR_VERIFY;
+          SetTargetStep(target, TARGET_STEP_DONE);
+        }
+        else
+        {
+          /* Continue with the next segment. */
+          target->processedBytes += segment->len;
+          target->segmentIdx++;
+          SubmitTargetOperation(target);
+        }
+        break;
+      case TARGET_STEP_READ:
+        if (event->result == BLT_RESULT_OK)
+        {
+          /* Done reading, so finish the session. */
+          target->processedBytes = target->readLength;
+          SetTargetStep(target, TARGET_STEP_DISCONNECT);
+          SubmitTargetOperation(target);
+        }
+        else
+        {
+          target->result = RESULT_ERROR_MEMORY_READ;
+          SetTargetStep(target, TARGET_STEP_DONE);
+        }
+        break;
+      case TARGET_STEP_DISCONNECT:
+        /* The operation on the target is done. After programming, the session only
+         * stops successfully if it could be completed properly. For the other
+         * operations, the data was already obtained at this point.
+         */
+        if ( (event->result != BLT_RESULT_OK) && (target->operation == TARGET_OP_FLASH) )
+        {
+          target->result = RESULT_ERROR_MEMORY_PROGRAM;
+        }
+        target->endTime = BltUtilTimeGetSystemTime();
+        SetTargetStep(target, TARGET_STEP_DONE);
+        break;
+      default:
+        break;
+    }
+    /* Report a failed target right away. */
+    if ( (target->step == TARGET_STEP_DONE) && (target->result != RESULT_OK) )
+    {
+      printf("  -> Target %s: %s\n", target->name, GetLineTrailerByResult(true));
+      (void)fflush(stdout);
+    }
+    else if ( (target->step == TARGET_STEP_DONE) && (!target->silentMode) )
+    {
+      printf("  -> Target %s: %s\n", target->name, GetLineTrailerByResult(false));
+      (void)fflush(stdout);
+    }
+  }
+} /*** end of TargetSessionCallback ***/
+
+
+/************************************************************************************//**
+** \brief     Changes the step of the operation on a target. The time spent in the step
+**            that is left is added to the timing of the steps.
+** \param     target The target.
+** \param     step The new step.
+**
+****************************************************************************************/
+static void SetTargetStep(tTarget * target, tTargetStep step)
+{
+  uint32_t now = BltUtilTimeGetSystemTime();
+
+  /* Check parameters. */
+  assert(target != NULL);
+
+  /* Add the time spent in the step that is left. */
+  if (target->step < TARGET_STEP_DONE)
+  {
+    target->stepMs[target->step] += now - target->stepStart;
+  }
+  target->step = step;
+  target->stepStart = now;
+} /*** end of SetTargetStep ***/
+
+
+/************************************************************************************//**
+** \brief     Creates an image with the memory segments of the firmware data that is
+**            currently loaded in the firmware data module. The image should be released
+**            with DestroyImage.
+** \param     image Pointer to the image to create.
+** \param     copy True to copy the firmware data, such that the firmware data module can
+**            load another firmware file afterwards. False to refer to the firmware data
+**            in the firmware data module.
+** \return    True if successful, false if there is no firmware data or if out of memory.
+**
+****************************************************************************************/
+static bool CreateImage(tImage * image, bool copy)
+{
+  bool result = false;
+  uint32_t segmentIdx;
+  uint32_t offset = 0;
+  uint8_t * data;
+
+  /* Check parameters. */
+  assert(image != NULL);
+
+  /* Allocate the array with the memory segments. */
+  image->segmentCount = BltFirmwareGetSegmentCount();
+  image->totalSize = 0;
+  image->data = NULL;
+  image->segments = NULL;
+  if (image->segmentCount > 0)
+  {
+    image->segments = malloc(image->segmentCount * sizeof(tImageSegment));
+  }
+  /* Only continue if the allocation was successful. */
+  if (image->segments != NULL)
+  {
+    result = true;
+    for (segmentIdx = 0; segmentIdx < image->segmentCount; segmentIdx++)
+    {
+      image->segments[segmentIdx].data = BltFirmwareGetSegment(
+        segmentIdx, &image->segments[segmentIdx].base, &image->segments[segmentIdx].len);
+      image->totalSize += image->segments[segmentIdx].len;
+    }
+    /* Copy the firmware data of all segments into one buffer, if requested. */
+    if (copy)
+    {
+      image->data = malloc(image->totalSize);
+      if (image->data == NULL)
+      {
+        result = false;
+      }
+      else
+      {
+        for (segmentIdx = 0; segmentIdx < image->segmentCount; segmentIdx++)
+        {
+          data = &image->data[offset];
+          memcpy(data, image->segments[segmentIdx].data,
+                 image->segments[segmentIdx].len);
+          image->segments[segmentIdx].data = data;
+          offset += image->segments[segmentIdx].len;
+        }
+      }
+    }
+  }
+  /* Release the image again if something went wrong. */
+  if (!result)
+  {
+    DestroyImage(image);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of CreateImage ***/
+
+
+/************************************************************************************//**
+** \brief     Releases the memory segments and the firmware data of an image.
+** \param     image Pointer to the image.
+**
+****************************************************************************************/
+static void DestroyImage(tImage * image)
+{
+  /* Check parameters. */
+  assert(image != NULL);
+
+  free(image->segments);
+  free(image->data);
+  image->segments = NULL;
+  image->data = NULL;
+  image->segmentCount = 0;
+  image->totalSize = 0;
+} /*** end of DestroyImage ***/
+
+
+/************************************************************************************//**
+** \brief     Runs the firmware update jobs of the batch manifest file. Each firmware
+**            file is loaded only once, no matter how many jobs program it. The jobs on
+**            the same interface run one after the other in a lane, on a session that is
+**            reused as long as the settings of the jobs are the same. For RS232 and CAN
+**            the transport layer connection stays open in between the jobs. The lanes
+**            of the different interfaces run in parallel. The result and the timing of
+**            each job are written to the standard output as a line in the JSON format.
+** \param     programSettings The program settings with the batch manifest file.
+** \param     argc Number of program arguments.
+** \param     argv Array with program arguments. They are the defaults for the jobs.
+** \return    Program return code. RESULT_OK if all jobs were successful, the error code
+**            of the first failed job otherwise.
+**
+****************************************************************************************/
+static int RunBatch(tProgramSettings const * programSettings, int argc,
+                    char const * const argv[])
+{
+  int result = RESULT_OK;
+  int jobResult;
+  tJob * jobs;
+  uint32_t jobCount = 0;
+  uint32_t jobIdx;
+  uint32_t errorLine = 0;
+  tImage * images = NULL;
+  uint32_t imageCount = 0;
+  uint32_t imageIdx;
+  tLane * lanes = NULL;
+  uint32_t laneCount = 0;
+  uint32_t laneIdx;
+  tLane * lane;
+  uint32_t doneCount;
+  uint32_t startTime;
+  uint32_t totalBytes = 0;
+
+  /* Check parameters. */
+  assert(programSettings != NULL);
+  assert(programSettings->manifestFile != NULL);
+
+  /* Read the jobs from the batch manifest file. */
+  printf("Reading batch manifest file..."); (void)fflush(stdout);
+  jobs = CreateJobs(programSettings->manifestFile, argc, argv, &jobCount, &errorLine);
+  printf("%s\n", GetLineTrailerByResult((bool)(jobs == NULL)));
+  if (jobs == NULL)
+  {
+    if (errorLine > 0)
+    {
+      printf("  -> Invalid job on line %u\n", errorLine);
+    }
+    /* Set error code. */
+    result = RESULT_ERROR_COMMANDLINE;
+  }
+  else
+  {
+    images = calloc(jobCount, sizeof(tImage));
+    lanes = calloc(jobCount, sizeof(tLane));
+    if ( (images == NULL) || (lanes == NULL) )
+    {
+      /* Set error code. */
+      result = RESULT_ERROR_COMMANDLINE;
+    }
+  }
+
+  /* Load each firmware file once and keep a copy of its firmware data, such that the
+   * firmware data module can load the next one.
+   */
+  if (result == RESULT_OK)
+  {
+    BltFirmwareInit(BLT_FIRMWARE_PARSER_SRECORD);
+    for (jobIdx = 0; jobIdx < jobCount; jobIdx++)
+    {
+      /* Look for a job that already loaded the same firmware file. */
+      for (imageIdx = 0; imageIdx < imageCount; imageIdx++)
+      {
+        if (strcmp(images[imageIdx].file, jobs[jobIdx].firmwareFile) == 0)
+        {
+          break;
+        }
+      }
+      if (imageIdx == imageCount)
+      {
+        printf("Loading firmware data from file %s...", jobs[jobIdx].firmwareFile);
+        (void)fflush(stdout);
+        startTime = BltUtilTimeGetSystemTime();
+        images[imageIdx].file = jobs[jobIdx].firmwareFile;
+        if ( (BltFirmwareLoadFromFile(images[imageIdx].file, 0) != BLT_RESULT_OK) ||
+             (!CreateImage(&images[imageIdx], true)) )
+        {
+          /* Set error code. */
+          result = RESULT_ERROR_FIRMWARE_LOAD;
+        }
+        BltFirmwareClearData();
+        printf("%s\n", GetLineTrailerByResult((bool)(result != RESULT_OK)));
+        if (result != RESULT_OK)
+        {
+          break;
+        }
+        imageCount++;
+        printf("{\"type\":\"image\",\"file\":");
+        PrintJsonString(stdout, images[imageIdx].file);
+        printf(",\"segments\":%u,\"bytes\":%u,\"load_ms\":%u}\n",
+               images[imageIdx].segmentCount, images[imageIdx].totalSize,
+               BltUtilTimeGetSystemTime() - startTime);
+      }
+      jobs[jobIdx].image = &images[imageIdx];
+    }
+  }
+
+  /* Add the jobs to the queues of the lanes of their interfaces. */
+  if (result == RESULT_OK)
+  {
+    for (jobIdx = 0; jobIdx < jobCount; jobIdx++)
+    {
+      for (laneIdx = 0; laneIdx < laneCount; laneIdx++)
+      {
+        if (strcmp(lanes[laneIdx].interfaceName, jobs[jobIdx].interfaceName) == 0)
+        {
+          break;
+        }
+      }
+      if (laneIdx == laneCount)
+      {
+        if (!InitLane(&lanes[laneIdx], jobs[jobIdx].interfaceName,
+                      programSettings->silentMode))
+        {
+          /* Set error code. */
+          result = RESULT_ERROR_COMMANDLINE;
+          break;
+        }
+        laneCount++;
+      }
+      jobs[jobIdx].number = jobIdx + 1u;
+      AddLaneJob(&lanes[laneIdx], &jobs[jobIdx]);
+    }
+    if ( (result == RESULT_OK) && (!programSettings->silentMode) )
+    {
+      printf("Detected %u jobs with %u firmware files on %u interfaces\n", jobCount,
+             imageCount, laneCount);
+    }
+  }
+
+  /* Run the jobs. */
+  if (result == RESULT_OK)
+  {
+    printf("Running jobs...\n"); (void)fflush(stdout);
+    startTime = BltUtilTimeGetSystemTime();
+    /* Start the first job of each lane. */
+    for (laneIdx = 0; laneIdx < laneCount; laneIdx++)
+    {
+      StartLaneJob(&lanes[laneIdx]);
+    }
+    /* Process the events of the sessions until the jobs of all lanes are done. Once
+     * the job of a lane is done, the next job of the lane is started.
+     */
+    do
+    {
+      (void)BltSessionProcessEvents(TARGET_CONNECT_RETRY_MS);
+      doneCount = 0;
+      for (laneIdx = 0; laneIdx < laneCount; laneIdx++)
+      {
+        lane = &lanes[laneIdx];
+        if (lane->job != NULL)
+        {
+          /* Retry connecting to a target that did not yet respond. */
+          if ( (lane->target.connectRetry) &&
+               ((BltUtilTimeGetSystemTime() - lane->target.connectTime) >=
+                TARGET_CONNECT_RETRY_MS) )
+          {
+            lane->target.connectRetry = false;
+            SubmitTargetOperation(&lane->target);
+          }
+          /* Report the job that is done and continue with the next one. */
+          if (lane->target.step == TARGET_STEP_DONE)
+          {
+            jobResult = FinishLaneJob(lane, stdout);
+            if (jobResult == RESULT_OK)
+            {
+              totalBytes += lane->target.processedBytes;
+            }
+            else if (result == RESULT_OK)
+            {
+              result = jobResult;
+            }
+            StartLaneJob(lane);
+          }
+        }
+        /* Count the lanes that are done. */
+        if (lane->job == NULL)
+        {
+          doneCount++;
+        }
+      }
+    }
+    while (doneCount < laneCount);
+
+    /* The aggregate throughput also covers the time it took to connect. */
+    printf("Firmware update throughput:\n");
+    DisplayThroughputInfo(NULL, totalBytes, BltUtilTimeGetSystemTime() - startTime);
+    printf("Running jobs...");
+    printf("%s\n", GetLineTrailerByResult((bool)(result != RESULT_OK)));
+  }
+
+  /* Release the lanes with their sessions, the images and the jobs. */
+  if (lanes != NULL)
+  {
+    for (laneIdx = 0; laneIdx < laneCount; laneIdx++)
+    {
+      ReleaseLane(&lanes[laneIdx]);
+    }
+    free(lanes);
+  }
+  if (images != NULL)
+  {
+    for (imageIdx = 0; imageIdx < imageCount; imageIdx++)
+    {
+      DestroyImage(&images[imageIdx]);
+    }
+    free(images);
+  }
+  DestroyJobs(jobs, jobCount);
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of RunBatch ***/
+
+
+/************************************************************************************//**
+** \brief     Reads the jobs from the batch manifest file. Each line holds a job, as
+**            described at InitJob. Empty lines and lines that start with the '#'
+**            character are skipped. The jobs should be released with DestroyJobs.
+** \param     manifestFile Filename of the batch manifest file.
+** \param     argc Number of program arguments.
+** \param     argv Array with program arguments.
+** \param     jobCount Pointer where the number of jobs is written to.
+** \param     errorLine Pointer where the number of the line with an invalid job is
+**            written to. It is 0 if the file could not be read.
+** \return    Array with the jobs or NULL if the file could not be read, if it has no
+**            jobs, if a job is invalid or if out of memory.
+**
+****************************************************************************************/
+static tJob * CreateJobs(char const * manifestFile, int argc, char const * const argv[],
+                         uint32_t * jobCount, uint32_t * errorLine)
+{
+  tJob * result = NULL;
+  tJob * jobs;
+  FILE * file;
+  char lineBuffer[MANIFEST_LINE_LEN_MAX + 2];
+  uint32_t count = 0;
+  uint32_t lineNumber = 0;
+  size_t lineLen;
+  int initResult;
+  bool okay;
+
+  /* Check parameters. */
+  assert(manifestFile != NULL);
+  assert(argv != NULL);
+  assert(jobCount != NULL);
+  assert(errorLine != NULL);
+
+  *errorLine = 0;
+  file = fopen(manifestFile, "r");
+  okay = (file != NULL);
+  while ( (okay) && (fgets(lineBuffer, (int)sizeof(lineBuffer), file) != NULL) )
+  {
+    lineNumber++;
+    /* A line without a line ending is only allowed at the end of the file. */
+    lineLen = strlen(lineBuffer);
+    if ( (lineLen > MANIFEST_LINE_LEN_MAX) && (lineBuffer[lineLen - 1] != '\n') )
+    {
+      *errorLine = lineNumber;
+      okay = false;
+      break;
+    }
+    /* Make room for the job in the array. */
+    jobs = realloc(result, (count + 1) * sizeof(tJob));
+    if (jobs == NULL)
+    {
+      okay = false;
+      break;
+    }
+    result = jobs;
+    /* Add the job, unless the line has no parameters. */
+    initResult = InitJob(&result[count], lineBuffer, argc, argv);
+    if (initResult > 0)
+    {
+      result[count].lineNumber = lineNumber;
+      count++;
+    }
+    else
+    {
+      ReleaseJob(&result[count]);
+      if (initResult < 0)
+      {
+        *errorLine = lineNumber;
+        okay = false;
+      }
+    }
+  }
+  /* A manifest file without jobs is also invalid. */
+  if ( (okay) && ((ferror(file) != 0) || (count == 0)) )
+  {
+    okay = false;
+  }
+  if (file != NULL)
+  {
+    (void)fclose(file);
+  }
+  /* Release the jobs again if something went wrong. */
+  if (!okay)
+  {
+    DestroyJobs(result, count);
+    result = NULL;
+    count = 0;
+  }
+  /* Store the number of jobs. */
+  *jobCount = count;
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of CreateJobs ***/
+
+
+/************************************************************************************//**
+** \brief     Initializes a job from its parameters, which are just like the ones on the
+**            command line. They are appended to the command line parameters, so a job
+**            only needs to specify the firmware file and the parameters that differ,
+**            such as the device. A parameter with spaces can be enclosed in double
+**            quotes. The job is a firmware update. The job should be released with
+**            ReleaseJob, also if this function failed.
+** \param     job Pointer to the job to initialize.
+** \param     text The parameters of the job.
+** \param     argc Number of program arguments.
+** \param     argv Array with program arguments.
+** \return    1 if successful, 0 if there are no parameters or -1 if the parameters are
+**            invalid or if out of memory.
+**
+****************************************************************************************/
+static int InitJob(tJob * job, char const * text, int argc, char const * const argv[])
+{
+  int result = -1;
+  int paramCount;
+
+  /* Check parameters. */
+  assert(job != NULL);
+  assert(text != NULL);
+  assert(argv != NULL);
+
+  memset(job, 0, sizeof(tJob));
+  job->operation = TARGET_OP_FLASH;
+  job->line = malloc(strlen(text) + 1);
+  job->argv = malloc(JOB_PARAMS_MAX * sizeof(char const *));
+  /* Only continue if the allocations were successful. */
+  if ( (job->line != NULL) && (job->argv != NULL) && (argc <= (int)JOB_PARAMS_MAX) )
+  {
+    /* Split up the text into the parameters that follow the command line parameters. */
+    strcpy(job->line, text);
+    memcpy(job->argv, argv, (size_t)argc * sizeof(char const *));
+    paramCount = SplitManifestLine(job->line, &job->argv[argc],
+                                   (int)JOB_PARAMS_MAX - argc);
+    if (paramCount == 0)
+    {
+      result = 0;
+    }
+    else if (paramCount > 0)
+    {
+      job->argc = argc + paramCount;
+      /* Extract the settings of the job, just like the ones of the command line. */
+      ExtractProgramSettingsFromCommandLine(job->argc, job->argv, &job->programSettings);
+      job->sessionType = ExtractSessionTypeFromCommandLine(job->argc, job->argv);
+      job->sessionSettings = ExtractSessionSettingsFromCommandLine(job->argc, job->argv,
+                                                                   job->sessionType);
+      job->transportType = ExtractTransportTypeFromCommandLine(job->argc, job->argv);
+      job->transportSettings = ExtractTransportSettingsFromCommandLine(
+        job->argc, job->argv, job->transportType);
+      job->firmwareFile = ExtractFirmwareFileFromCommandLine(job->argc, job->argv);
+      job->interfaceName = CreateInterfaceName(job->transportType,
+                                               job->transportSettings);
+      /* Check the settings. Note that the transport settings are allowed to be NULL in
+       * case of BLT_TRANSPORT_XCP_V10_USB. A job cannot update multiple targets in
+       * parallel.
+       */
+      if ( (job->sessionSettings != NULL) && (job->firmwareFile != NULL) &&
+           (job->interfaceName != NULL) && (job->programSettings.targetList == NULL) )
+      {
+        result = 1;
+      }
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of InitJob ***/
+
+
+/************************************************************************************//**
+** \brief     Splits up a line of the batch manifest file into its parameters. The
+**            parameters are separated by white space. Double quotes group characters,
+**            including white space, into one parameter and are removed. The rest of
+**            the line is skipped at a parameter that starts with the '#' character.
+**            Note that the line is modified and that the parameters point into it.
+** \param     line The line.
+** \param     params Array where the pointers to the parameters are written to.
+** \param     paramsMax Maximum number of parameters that fit in the array.
+** \return    Number of parameters or -1 if the line has too many parameters or a
+**            double quote without its closing one.
+**
+****************************************************************************************/
+static int SplitManifestLine(char * line, char const * * params, int paramsMax)
+{
+  int result = 0;
+  char * src = line;
+  char * dst;
+  bool quoted;
+
+  /* Check parameters. */
+  assert(line != NULL);
+  assert(params != NULL);
+
+  while (result >= 0)
+  {
+    /* Skip the white space in front of the parameter. */
+    while ( (*src == ' ') || (*src == '\t') || (*src == '\r') || (*src == '\n') )
+    {
+      src++;
+    }
+    /* Done at the end of the line or at a comment. */
+    if ( (*src == '\0') || (*src == '#') )
+    {
+      break;
+    }
+    if (result >= paramsMax)
+    {
+      result = -1;
+      break;
+    }
+    /* Copy the characters of the parameter onto themselves, without the quotes. */
+    dst = src;
+    params[result] = dst;
+    result++;
+    quoted = false;
+    while ( (*src != '\0') && ((quoted) || ((*src != ' ') && (*src != '\t') &&
+                                            (*src != '\r') && (*src != '\n'))) )
+    {
+      if (*src == '"')
+      {
+        quoted = !quoted;
+      }
+      else
+      {
+        *dst = *src;
+        dst++;
+      }
+      src++;
+    }
+    if (*src != '\0')
+    {
+      src++;
+    }
+    *dst = '\0';
+    /* A parameter cannot end inside the quotes. */
+    if (quoted)
+    {
+      result = -1;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of SplitManifestLine ***/
+
+
+/************************************************************************************//**
+** \brief     Releases the jobs and their settings.
+** \param     jobs Array with the jobs. Can be NULL.
+** \param     jobCount Number of jobs in the array.
+**
+****************************************************************************************/
+static void DestroyJobs(tJob * jobs, uint32_t jobCount)
+{
+  uint32_t jobIdx;
+
+  /* Only continue with a valid array. */
+  if (jobs != NULL)
+  {
+    for (jobIdx = 0; jobIdx < jobCount; jobIdx++)
+    {
+      ReleaseJob(&jobs[jobIdx]);
+    }
+    free(jobs);
+  }
+} /*** end of DestroyJobs ***/
+
+
+/************************************************************************************//**
+** \brief     Releases the settings of a job.
+** \param     job The job.
+**
+****************************************************************************************/
+static void ReleaseJob(tJob * job)
+{
+  /* Check parameters. */
+  assert(job != NULL);
+
+  free(job->interfaceName);
+  free(job->transportSettings);
+  free(job->sessionSettings);
+  free(job->argv);
+  free(job->line);
+} /*** end of ReleaseJob ***/
+
+
+/************************************************************************************//**
+** \brief     Creates the name of the interface that the transport settings select, such
+**            as the serial port, the CAN device and channel or the network address and
+**            port. Jobs with the same interface name cannot run at the same time. The
+**            name should be released with free.
+** \param     transportType The transport type.
+** \param     transportSettings The transport settings. Can be NULL for USB.
+** \return    The interface name or NULL if the transport settings do not select an
+**            interface or if out of memory.
+**
+****************************************************************************************/
+static char * CreateInterfaceName(uint32_t transportType, void const * transportSettings)
+{
+  char * result = NULL;
+  char const * name = NULL;
+  uint32_t number = 0;
+
+  /* Determine the name and the number that is appended to it, if any. */
+  switch (transportType)
+  {
+    case BLT_TRANSPORT_XCP_V10_RS232:
+      if (transportSettings != NULL)
+      {
+        name = ((tBltTransportSettingsXcpV10Rs232 const *)transportSettings)->portName;
+      }
+      break;
+    case BLT_TRANSPORT_XCP_V10_CAN:
+      if (transportSettings != NULL)
+      {
+        tBltTransportSettingsXcpV10Can const * canSettings = transportSettings;
+        name = canSettings->deviceName;
+        number = canSettings->deviceChannel;
+      }
+      break;
+    case BLT_TRANSPORT_XCP_V10_NET:
+      if (transportSettings != NULL)
+      {
+        name = ((tBltTransportSettingsXcpV10Net const *)transportSettings)->address;
+        number = ((tBltTransportSettingsXcpV10Net const *)transportSettings)->port;
+      }
+      break;
+    case BLT_TRANSPORT_XCP_V10_UDP:
+      if (transportSettings != NULL)
+      {
+        name = ((tBltTransportSettingsXcpV10Udp const *)transportSettings)->address;
+        number = ((tBltTransportSettingsXcpV10Udp const *)transportSettings)->port;
+      }
+      break;
+    case BLT_TRANSPORT_XCP_V10_USB:
+      name = "usb";
+      break;
+    default:
+      break;
+  }
+  /* Build the interface name. The number fits in 10 digits and the separator. */
+  if (name != NULL)
+  {
+    result = malloc(strlen(name) + 12);
+    if (result != NULL)
+    {
+      if (number > 0)
+      {
+        sprintf(result, "%s:%u", name, number);
+      }
+      else
+      {
+        strcpy(result, name);
+      }
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of CreateInterfaceName ***/
+
+
+/************************************************************************************//**
+** \brief     Determines if two jobs have the same session, transport layer and network
+**            emulation settings, such that they can run on the same session.
+** \param     job1 The first job.
+** \param     job2 The second job.
+** \return    True if the settings are the same, false otherwise.
+**
+****************************************************************************************/
+static bool JobSettingsEqual(tJob const * job1, tJob const * job2)
+{
+  bool result;
+
+  /* Check parameters. */
+  assert(job1 != NULL);
+  assert(job2 != NULL);
+
+  /* Compare the types and the network emulation. */
+  result = (job1->sessionType == job2->sessionType) &&
+           (job1->transportType == job2->transportType) &&
+           (job1->programSettings.emulate == job2->programSettings.emulate);
+  if ( (result) && (job1->programSettings.emulate) )
+  {
+    tBltTransportSettingsXcpV10Emu const * emu1 = &job1->programSettings.emulation;
+    tBltTransportSettingsXcpV10Emu const * emu2 = &job2->programSettings.emulation;
+    result = (emu1->delay == emu2->delay) && (emu1->jitter == emu2->jitter) &&
+             (emu1->loss == emu2->loss) && (emu1->duplicate == emu2->duplicate) &&
+             (emu1->reorder == emu2->reorder) && (emu1->seed == emu2->seed);
+  }
+  /* Compare the session settings. */
+  if ( (result) && (job1->sessionType == BLT_SESSION_XCP_V10) )
+  {
+    tBltSessionSettingsXcpV10 const * xcp1 = job1->sessionSettings;
+    tBltSessionSettingsXcpV10 const * xcp2 = job2->sessionSettings;
+    result = (xcp1->timeoutT1 == xcp2->timeoutT1) &&
+             (xcp1->timeoutT3 == xcp2->timeoutT3) &&
+             (xcp1->timeoutT4 == xcp2->timeoutT4) &&
+             (xcp1->timeoutT5 == xcp2->timeoutT5) &&
+             (xcp1->timeoutT6 == xcp2->timeoutT6) &&
+             (xcp1->timeoutT7 == xcp2->timeoutT7) &&
+             (xcp1->connectMode == xcp2->connectMode) &&
+             (((xcp1->seedKeyFile == NULL) && (xcp2->seedKeyFile == NULL)) ||
+              ((xcp1->seedKeyFile != NULL) && (xcp2->seedKeyFile != NULL) &&
+               (strcmp(xcp1->seedKeyFile, xcp2->seedKeyFile) == 0)));
+  }
+  /* Compare the transport settings. The interface name covers the settings that
+   * select the interface.
+   */
+  if (result)
+  {
+    result = (strcmp(job1->interfaceName, job2->interfaceName) == 0);
+  }
+  if (result)
+  {
+    switch (job1->transportType)
+    {
+      case BLT_TRANSPORT_XCP_V10_RS232:
+      {
+        tBltTransportSettingsXcpV10Rs232 const * rs1 = job1->transportSettings;
+        tBltTransportSettingsXcpV10Rs232 const * rs2 = job2->transportSettings;
+        result = (rs1->baudrate == rs2->baudrate);
+        break;
+      }
+      case BLT_TRANSPORT_XCP_V10_CAN:
+      {
+        tBltTransportSettingsXcpV10Can const * can1 = job1->transportSettings;
+        tBltTransportSettingsXcpV10Can const * can2 = job2->transportSettings;
+        result = (can1->baudrate == can2->baudrate) &&
+                 (can1->transmitId == can2->transmitId) &&
+                 (can1->receiveId == can2->receiveId) &&
+                 (can1->useExtended == can2->useExtended) &&
+                 (can1->txFrameGap == can2->txFrameGap);
+        break;
+      }
+      case BLT_TRANSPORT_XCP_V10_NET:
+      {
+        tBltTransportSettingsXcpV10Net const * net1 = job1->transportSettings;
+        tBltTransportSettingsXcpV10Net const * net2 = job2->transportSettings;
+        result = (net1->window == net2->window);
+        break;
+      }
+      case BLT_TRANSPORT_XCP_V10_UDP:
+      {
+        tBltTransportSettingsXcpV10Udp const * udp1 = job1->transportSettings;
+        tBltTransportSettingsXcpV10Udp const * udp2 = job2->transportSettings;
+        result = (udp1->window == udp2->window);
+        break;
+      }
+      default:
+        break;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of JobSettingsEqual ***/
+
+
+/************************************************************************************//**
+** \brief     Initializes a lane for the jobs on an interface. The lane should be
+**            released with ReleaseLane, also if this function failed.
+** \param     lane Pointer to the lane to initialize.
+** \param     interfaceName Name of the interface.
+** \param     silentMode True to only output the most basic progress information.
+** \return    True if successful, false if out of memory.
+**
+****************************************************************************************/
+static bool InitLane(tLane * lane, char const * interfaceName, bool silentMode)
+{
+  /* Check parameters. */
+  assert(lane != NULL);
+  assert(interfaceName != NULL);
+
+  memset(lane, 0, sizeof(tLane));
+  lane->interfaceName = malloc(strlen(interfaceName) + 1);
+  if (lane->interfaceName != NULL)
+  {
+    strcpy(lane->interfaceName, interfaceName);
+  }
+  lane->target.name = lane->interfaceName;
+  lane->target.silentMode = silentMode;
+  lane->target.step = TARGET_STEP_DONE;
+  /* Give the result back to the caller. */
+  return (lane->interfaceName != NULL);
+} /*** end of InitLane ***/
+
+
+/************************************************************************************//**
+** \brief     Releases a lane and its session. The jobs of the lane are not released.
+** \param     lane The lane.
+**
+****************************************************************************************/
+static void ReleaseLane(tLane * lane)
+{
+  /* Check parameters. */
+  assert(lane != NULL);
+
+  /* Destroy the session, which also cancels its pending operations. */
+  if (lane->target.session != NULL)
+  {
+    BltSessionDestroy(lane->target.session);
+    lane->target.session = NULL;
+  }
+  free(lane->target.readBuffer);
+  free(lane->interfaceName);
+  lane->target.readBuffer = NULL;
+  lane->interfaceName = NULL;
+} /*** end of ReleaseLane ***/
+
+
+/************************************************************************************//**
+** \brief     Adds a job to the end of the queue of a lane.
+** \param     lane The lane.
+** \param     job The job.
+**
+****************************************************************************************/
+static void AddLaneJob(tLane * lane, tJob * job)
+{
+  tJob * * next;
+
+  /* Check parameters. */
+  assert(lane != NULL);
+  assert(job != NULL);
+
+  job->next = NULL;
+  for (next = &lane->queue; *next != NULL; next = &(*next)->next)
+  {
+    /* Nothing to do. Just find the end of the queue. */
+  }
+  *next = job;
+} /*** end of AddLaneJob ***/
+
+
+/************************************************************************************//**
+** \brief     Starts the next job in the queue of a lane. The session of the lane is
+**            reused if the job has the same settings as the job that the session was
+**            created for. Otherwise a new session is created. If the queue is empty,
+**            the job of the lane is set to NULL.
+** \param     lane The lane.
+**
+****************************************************************************************/
+static void StartLaneJob(tLane * lane)
+{
+  tTarget * target;
+  tJob * job;
+  tBltTransportSettingsXcpV10Emu emulation;
+  uint32_t bufferLen = 0;
+  uint32_t segmentIdx;
+
+  /* Check parameters. */
+  assert(lane != NULL);
+
+  /* Take the next job from the queue. */
+  job = lane->queue;
+  if (job != NULL)
+  {
+    lane->queue = job->next;
+    job->next = NULL;
+  }
+  lane->job = job;
+
+  /* Only continue if the lane has a job to run. */
+  if (job != NULL)
+  {
+    target = &lane->target;
+    /* Destroy the session if it cannot be reused for this job. */
+    if ( (target->session != NULL) && (!JobSettingsEqual(job, lane->sessionJob)) )
+    {
+      BltSessionDestroy(target->session);
+      target->session = NULL;
+    }
+    /* Create a new session if needed. */
+    if (target->session == NULL)
+    {
+      /* Wrap the transport layer in the network emulation, if requested. */
+      if (job->programSettings.emulate)
+      {
+        emulation = job->programSettings.emulation;
+        emulation.transportType = job->transportType;
+        emulation.transportSettings = job->transportSettings;
+        target->session = BltSessionCreate(job->sessionType, job->sessionSettings,
+                                           BLT_TRANSPORT_XCP_V10_EMU, &emulation);
+      }
+      else
+      {
+        target->session = BltSessionCreate(job->sessionType, job->sessionSettings,
+                                           job->transportType, job->transportSettings);
+      }
+      lane->sessionJob = (target->session != NULL) ? job : NULL;
+      /* Keep the connection of the transport layer open in between the jobs. This is
+       * only done for RS232 and CAN. A TCP/IP connection does not survive the reset
+       * of the target.
+       */
+      if ( (target->session != NULL) &&
+           ((job->transportType == BLT_TRANSPORT_XCP_V10_RS232) ||
+            (job->transportType == BLT_TRANSPORT_XCP_V10_CAN)) )
+      {
+        (void)BltSessionHandleKeepTransport(target->session, 1);
+      }
+    }
+    /* Allocate the buffer for the data that is read from the target. Verification
+     * reads one segment at a time.
+     */
+    if (job->operation == TARGET_OP_VERIFY)
+    {
+      for (segmentIdx = 0; segmentIdx < job->image->segmentCount; segmentIdx++)
+      {
+        if (job->image->segments[segmentIdx].len > bufferLen)
+        {
+          bufferLen = job->image->segments[segmentIdx].len;
+        }
+      }
+    }
+    else if (job->operation == TARGET_OP_READ)
+    {
+      bufferLen = job->readLength;
+    }
+    free(target->readBuffer);
+    target->readBuffer = (bufferLen > 0) ? malloc(bufferLen) : NULL;
+    /* Reset the operation on the target. */
+    target->operation = job->operation;
+    target->image = job->image;
+    target->readAddress = job->readAddress;
+    target->readLength = job->readLength;
+    target->segmentIdx = 0;
+    target->segmentOffset = 0;
+    target->result = RESULT_OK;
+    target->connectRetry = false;
+    target->startTime = 0;
+    target->endTime = 0;
+    target->processedBytes = 0;
+    target->progress = 0;
+    memset(target->stepMs, 0, sizeof(target->stepMs));
+    target->step = TARGET_STEP_CONNECT;
+    target->stepStart = BltUtilTimeGetSystemTime();
+    job->reportedStep = TARGET_STEP_DONE;
+    job->reportedPercent = 0;
+    /* Start connecting to the target. */
+    if ( (target->session != NULL) &&
+         ((bufferLen == 0) || (target->readBuffer != NULL)) )
+    {
+      SubmitTargetOperation(target);
+    }
+    else
+    {
+      target->result = RESULT_ERROR_COMMANDLINE;
+      SetTargetStep(target, TARGET_STEP_DONE);
+    }
+  }
+} /*** end of StartLaneJob ***/
+
+
+/************************************************************************************//**
+** \brief     Finishes the job of a lane, once it is done. The data of a read job is
+**            written to its S-record file. The result and the timing of the job are
+**            reported as a line in the JSON format. The duration of the connect step
+**            includes the time it took for the target to respond. The session of the
+**            lane is destroyed if the job failed, such that the next job starts with a
+**            new connection.
+** \param     lane The lane.
+** \param     stream Stream that the job is reported on. NULL to not report it.
+** \return    Program return code of the job.
+**
+****************************************************************************************/
+static int FinishLaneJob(tLane * lane, FILE * stream)
+{
+  tTarget * target;
+  tJob const * job;
+  uint32_t totalMs = 0;
+  uint32_t stepIdx;
+
+  /* Check parameters. */
+  assert(lane != NULL);
+  assert(lane->job != NULL);
+
+  target = &lane->target;
+  job = lane->job;
+  for (stepIdx = 0; stepIdx < (uint32_t)TARGET_STEP_DONE; stepIdx++)
+  {
+    totalMs += target->stepMs[stepIdx];
+  }
+  /* Store the data of a read job. */
+  if ( (target->result == RESULT_OK) && (target->operation == TARGET_OP_READ) )
+  {
+    BltFirmwareClearData();
+    if ( (BltFirmwareAddData(target->readAddress, target->readLength,
+                             target->readBuffer) != BLT_RESULT_OK) ||
+         (BltFirmwareSaveToFile(job->firmwareFile) != BLT_RESULT_OK) )
+    {
+      target->result = RESULT_ERROR_MEMORY_READ;
+    }
+    BltFirmwareClearData();
+  }
+  free(target->readBuffer);
+  target->readBuffer = NULL;
+  /* Output the job. */
+  if (stream != NULL)
+  {
+    fprintf(stream, "{\"type\":\"job\",\"job\":%u,", job->number);
+    if (job->lineNumber > 0)
+    {
+      fprintf(stream, "\"line\":%u,", job->lineNumber);
+    }
+    fprintf(stream, "\"operation\":\"%s\",\"file\":",
+            targetOperationNames[target->operation]);
+    PrintJsonString(stream, job->firmwareFile);
+    fprintf(stream, ",\"interface\":");
+    PrintJsonString(stream, lane->interfaceName);
+    fprintf(stream, ",\"result\":\"%s\",\"code\":%d,\"bytes\":%u,\"connect_ms\":%u,"
+            "\"erase_ms\":%u,\"program_ms\":%u,\"verify_ms\":%u,\"read_ms\":%u,"
+            "\"finish_ms\":%u,\"total_ms\":%u}\n",
+            (target->result == RESULT_OK) ? "ok" : "error", target->result,
+            target->processedBytes, target->stepMs[TARGET_STEP_CONNECT],
+            target->stepMs[TARGET_STEP_ERASE], target->stepMs[TARGET_STEP_PROGRAM],
+            target->stepMs[TARGET_STEP_VERIFY], target->stepMs[TARGET_STEP_READ],
+            target->stepMs[TARGET_STEP_DISCONNECT], totalMs);
+    (void)fflush(stream);
+  }
+  /* Start the next job with a new connection after a failure. */
+  if ( (target->result != RESULT_OK) && (target->session != NULL) )
+  {
+    BltSessionDestroy(target->session);
+    target->session = NULL;
+    lane->sessionJob = NULL;
+  }
+  /* Give the result back to the caller. */
+  return target->result;
+} /*** end of FinishLaneJob ***/
+
+
+/************************************************************************************//**
+** \brief     Writes a string to a stream as a JSON string, so enclosed in double quotes
+**            and with the special characters escaped.
+** \param     stream The stream.
+** \param     str The string.
+**
+****************************************************************************************/
+static void PrintJsonString(FILE * stream, char const * str)
+{
+  /* Check parameters. */
+  assert(stream != NULL);
+  assert(str != NULL);
+
+  (void)fputc('"', stream);
+  for (; *str != '\0'; str++)
+  {
+    if ( (*str == '"') || (*str == '\\') )
+    {
+      fprintf(stream, "\\%c", *str);
+    }
+    else if ((unsigned char)*str < 0x20u)
+    {
+      fprintf(stream, "\\u%04x", (unsigned int)(unsigned char)*str);
+    }
+    else
+    {
+      (void)fputc(*str, stream);
+    }
+  }
+  (void)fputc('"', stream);
+} /*** end of PrintJsonString ***/
+
+
+#if defined (PLATFORM_LINUX)
+/************************************************************************************//**
+** \brief     Runs as a daemon that accepts jobs from its clients on a UNIX domain
+**            socket. A client sends a job as a line with a command, followed by
+**            parameters just like the ones of a job in the batch manifest file:
+**              flash [firmware file] [options]
+**              verify [firmware file] [options]
+**              read [S-record file] -ra=[address] -rl=[length] [options]
+**            The daemon answers each job with an accepted or an error line. While the
+**            job runs, it reports its progress and once done its result and timing.
+**            All answers are lines in the JSON format. The jobs run in lanes, just like
+**            in batch mode, but the lanes and their sessions are kept, such that the
+**            transport layer of an interface stays connected for the next job. Parsed
+**            firmware files are kept in the firmware cache. Its directory is the one of
+**            the -fc=[directory] option or otherwise the name of the socket followed by
+**            DAEMON_CACHE_SUFFIX. The daemon stops with SIGINT or SIGTERM.
+** \param     programSettings The program settings with the socket.
+** \param     argc Number of program arguments.
+** \param     argv Array with program arguments. They are the defaults for the jobs.
+** \return    Program return code. RESULT_OK if the daemon started, an error code
+**            otherwise. The results of the jobs are reported to their clients.
+**
+****************************************************************************************/
+static int RunDaemon(tProgramSettings const * programSettings, int argc,
+                     char const * const argv[])
+{
+  int result = RESULT_OK;
+  tDaemon daemon;
+  struct sockaddr_un address;
+  struct stat socketStat;
+  struct pollfd pollFds[DAEMON_CLIENTS_MAX + 2u];
+  tClient * pollClients[DAEMON_CLIENTS_MAX + 2u];
+  nfds_t pollCount;
+  nfds_t pollIdx;
+  intptr_t eventHandle;
+  int listenSocket = -1;
+  int timeout;
+  uint32_t clientIdx;
+  uint32_t laneIdx;
+  char cacheDirectory[sizeof(address.sun_path) + sizeof(DAEMON_CACHE_SUFFIX)];
+
+  /* Check parameters. */
+  assert(programSettings != NULL);
+  assert(programSettings->daemonSocket != NULL);
+
+  memset(&daemon, 0, sizeof(daemon));
+  daemon.programSettings = programSettings;
+  daemon.argc = argc;
+  daemon.argv = argv;
+
+  /* Create the socket and listen on it. A socket that is left over from a previous run
+   * is removed, but nothing else.
+   */
+  printf("Starting daemon on socket %s...", programSettings->daemonSocket);
+  (void)fflush(stdout);
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (strlen(programSettings->daemonSocket) >= sizeof(address.sun_path))
+  {
+    /* Set error code. */
+    result = RESULT_ERROR_COMMANDLINE;
+  }
+  else
+  {
+    strcpy(address.sun_path, programSettings->daemonSocket);
+    if ( (stat(address.sun_path, &socketStat) == 0) && (S_ISSOCK(socketStat.st_mode)) )
+    {
+      (void)unlink(address.sun_path);
+    }
+    listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if ( (listenSocket < 0) ||
+         (bind(listenSocket, (struct sockaddr const *)&address, sizeof(address)) != 0) ||
+         (listen(listenSocket, (int)DAEMON_CLIENTS_MAX) != 0) )
+    {
+      /* Set error code. */
+      result = RESULT_ERROR_COMMANDLINE;
+    }
+  }
+  printf("%s\n", GetLineTrailerByResult((bool)(result != RESULT_OK)));
+  (void)fflush(stdout);
+
+  /* Only continue if the socket is ready. */
+  if (result == RESULT_OK)
+  {
+    /* Stop on SIGINT and SIGTERM. A client that disconnects while it is sent an answer
+     * should not stop the daemon.
+     */
+    daemonStopRequested = 0;
+    (void)signal(SIGINT, DaemonSignalHandler);
+    (void)signal(SIGTERM, DaemonSignalHandler);
+    (void)signal(SIGPIPE, SIG_IGN);
+    /* Keep the parsed firmware files in the firmware cache. The main function already
+     * configured it, if a directory was specified. Otherwise a directory next to the
+     * socket is used, which is kept for the next run of the daemon.
+     */
+    if (programSettings->firmwareCache == NULL)
+    {
+      strcpy(cacheDirectory, address.sun_path);
+      strcat(cacheDirectory, DAEMON_CACHE_SUFFIX);
+      if ( (mkdir(cacheDirectory, S_IRWXU) == 0) || (errno == EEXIST) )
+      {
+        BltFirmwareSetCache(cacheDirectory, FIRMWARE_CACHE_SIZE_MAX);
+      }
+    }
+    BltFirmwareInit(BLT_FIRMWARE_PARSER_SRECORD);
+    while (daemonStopRequested == 0)
+    {
+      /* Finish and start jobs and report their progress. This also determines how long
+       * to wait, which is forever unless a target did not yet respond.
+       */
+      timeout = DaemonProcessLanes(&daemon);
+      /* Wait for a new client, for data of a client or for events of the sessions. */
+      pollCount = 0;
+      pollFds[pollCount].fd = listenSocket;
+      pollFds[pollCount].events = POLLIN;
+      pollClients[pollCount] = NULL;
+      pollCount++;
+      eventHandle = BltSessionGetEventHandle();
+      if (eventHandle >= 0)
+      {
+        pollFds[pollCount].fd = (int)eventHandle;
+        pollFds[pollCount].events = POLLIN;
+        pollClients[pollCount] = NULL;
+        pollCount++;
+      }
+      for (clientIdx = 0; clientIdx < DAEMON_CLIENTS_MAX; clientIdx++)
+      {
+        /* Send the answers to the client, as far as its socket accepts them. Wait for
+         * the socket to accept more if not all of them were sent.
+         */
+        if ( (daemon.clients[clientIdx] != NULL) &&
+             (!DaemonWriteClient(daemon.clients[clientIdx])) )
+        {
+          DaemonCloseClient(&daemon, daemon.clients[clientIdx]);
+        }
+        if (daemon.clients[clientIdx] != NULL)
+        {
+          pollFds[pollCount].fd = daemon.clients[clientIdx]->socket;
+          pollFds[pollCount].events = daemon.clients[clientIdx]->closing ? 0 : POLLIN;
+          if (daemon.clients[clientIdx]->outputSent < daemon.clients[clientIdx]->outputLen)
+          {
+            pollFds[pollCount].events |= POLLOUT;
+          }
+          pollClients[pollCount] = daemon.clients[clientIdx];
+          pollCount++;
+        }
+      }
+      if (poll(pollFds, pollCount, timeout) < 0)
+      {
+        /* Interrupted, for example by a signal. */
+        continue;
+      }
+      /* Dispatch the events of the sessions. */
+      (void)BltSessionProcessEvents(0);
+      /* Accept a new client. */
+      if ((pollFds[0].revents & POLLIN) != 0)
+      {
+        DaemonAcceptClient(&daemon, listenSocket);
+      }
+      /* Read the jobs of the clients. Their answers are sent at the start of the next
+       * loop.
+       */
+      for (pollIdx = 0; pollIdx < pollCount; pollIdx++)
+      {
+        if ( (pollClients[pollIdx] != NULL) && (!pollClients[pollIdx]->closing) &&
+             ((pollFds[pollIdx].revents & (POLLIN | POLLHUP | POLLERR)) != 0) )
+        {
+          if (!DaemonReadClient(&daemon, pollClients[pollIdx]))
+          {
+            DaemonCloseClient(&daemon, pollClients[pollIdx]);
+          }
+        }
+      }
+    }
+    printf("Stopping daemon...");
+    /* Release the clients and the lanes with their jobs. */
+    for (clientIdx = 0; clientIdx < DAEMON_CLIENTS_MAX; clientIdx++)
+    {
+      if (daemon.clients[clientIdx] != NULL)
+      {
+        DaemonCloseClient(&daemon, daemon.clients[clientIdx]);
+      }
+    }
+    for (laneIdx = 0; laneIdx < daemon.laneCount; laneIdx++)
+    {
+      if (daemon.lanes[laneIdx]->job != NULL)
+      {
+        DaemonReleaseJob(daemon.lanes[laneIdx], daemon.lanes[laneIdx]->job);
+      }
+      if (daemon.lanes[laneIdx]->sessionJob != NULL)
+      {
+        DaemonReleaseJob(daemon.lanes[laneIdx], daemon.lanes[laneIdx]->sessionJob);
+      }
+      ReleaseLane(daemon.lanes[laneIdx]);
+      free(daemon.lanes[laneIdx]);
+    }
+    free(daemon.lanes);
+    (void)unlink(address.sun_path);
+    printf("%s\n", GetLineTrailerByResult((bool)false));
+  }
+  /* Close the socket. */
+  if (listenSocket >= 0)
+  {
+    (void)close(listenSocket);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of RunDaemon ***/
+
+
+/************************************************************************************//**
+** \brief     Signal handler that requests the daemon to stop.
+** \param     signum The signal.
+**
+****************************************************************************************/
+static void DaemonSignalHandler(int signum)
+{
+  (void)signum;
+  daemonStopRequested = 1;
+} /*** end of DaemonSignalHandler ***/
+
+
+/************************************************************************************//**
+** \brief     Finishes the jobs of the lanes that are done and starts their next ones.
+**            Also retries connecting to targets that did not yet respond and reports
+**            the progress of the jobs to their clients. A job that waits for its
+**            target to respond is cancelled once its client disconnected.
+** \param     daemon The daemon.
+** \return    Time in milliseconds that the daemon can wait for new events. -1 to wait
+**            without a timeout.
+**
+****************************************************************************************/
+static int DaemonProcessLanes(tDaemon * daemon)
+{
+  int result = -1;
+  uint32_t laneIdx;
+  tLane * lane;
+
+  /* Check parameters. */
+  assert(daemon != NULL);
+
+  for (laneIdx = 0; laneIdx < daemon->laneCount; laneIdx++)
+  {
+    lane = daemon->lanes[laneIdx];
+    /* Retry connecting to a target that did not yet respond, unless nobody waits for
+     * the result of the job anymore.
+     */
+    if ( (lane->job != NULL) && (lane->target.connectRetry) )
+    {
+      if (lane->job->client == NULL)
+      {
+        lane->target.connectRetry = false;
+        lane->target.result = RESULT_ERROR_COMMANDLINE;
+        SetTargetStep(&lane->target, TARGET_STEP_DONE);
+      }
+      else if ((BltUtilTimeGetSystemTime() - lane->target.connectTime) >=
+               TARGET_CONNECT_RETRY_MS)
+      {
+        lane->target.connectRetry = false;
+        SubmitTargetOperation(&lane->target);
+      }
+    }
+    /* Report the jobs that are done and continue with the next ones. A job can be done
+     * right away if its session could not be created.
+     */
+    while ( (lane->job != NULL) && (lane->target.step == TARGET_STEP_DONE) )
+    {
+      DaemonFinishJob(lane);
+      DaemonStartLaneJob(lane);
+    }
+    /* Report the progress of the current job. */
+    if (lane->job != NULL)
+    {
+      DaemonReportProgress(lane);
+      /* Wake up in time for the next connection attempt. */
+      if (lane->target.connectRetry)
+      {
+        result = (int)TARGET_CONNECT_RETRY_MS;
+      }
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of DaemonProcessLanes ***/
+
+
+/************************************************************************************//**
+** \brief     Starts the next job of a lane and releases the job that the session was
+**            created for, if the job got a new session.
+** \param     lane The lane.
+**
+****************************************************************************************/
+static void DaemonStartLaneJob(tLane * lane)
+{
+  tJob * previousSessionJob;
+
+  /* Check parameters. */
+  assert(lane != NULL);
+
+  previousSessionJob = lane->sessionJob;
+  StartLaneJob(lane);
+  if ( (previousSessionJob != NULL) && (previousSessionJob != lane->sessionJob) )
+  {
+    DaemonReleaseJob(lane, previousSessionJob);
+  }
+} /*** end of DaemonStartLaneJob ***/
+
+
+/************************************************************************************//**
+** \brief     Finishes the job of a lane, once it is done, and reports it to its client.
+**            The job is kept as long as the session of the lane was created for it.
+** \param     lane The lane.
+**
+****************************************************************************************/
+static void DaemonFinishJob(tLane * lane)
+{
+  tJob * job;
+  tJob * previousSessionJob;
+
+  /* Check parameters. */
+  assert(lane != NULL);
+  assert(lane->job != NULL);
+
+  job = lane->job;
+  previousSessionJob = lane->sessionJob;
+  (void)FinishLaneJob(lane, (job->client != NULL) ? job->client->stream : NULL);
+  job->client = NULL;
+  lane->job = NULL;
+  /* The session is destroyed after a failed job, so the job that it was created for
+   * is no longer needed.
+   */
+  if ( (previousSessionJob != NULL) && (previousSessionJob != lane->sessionJob) &&
+       (previousSessionJob != job) )
+  {
+    DaemonReleaseJob(lane, previousSessionJob);
+  }
+  if (job != lane->sessionJob)
+  {
+    DaemonReleaseJob(lane, job);
+  }
+} /*** end of DaemonFinishJob ***/
+
+
+/************************************************************************************//**
+** \brief     Releases a job of the daemon, together with its firmware data.
+** \param     lane The lane of the job.
+** \param     job The job.
+**
+****************************************************************************************/
+static void DaemonReleaseJob(tLane * lane, tJob * job)
+{
+  /* Check parameters. */
+  assert(lane != NULL);
+  assert(job != NULL);
+
+  if (lane->sessionJob == job)
+  {
+    lane->sessionJob = NULL;
+  }
+  if (lane->job == job)
+  {
+    lane->job = NULL;
+  }
+  DaemonFreeImage(job->image);
+  ReleaseJob(job);
+  free(job);
+} /*** end of DaemonReleaseJob ***/
+
+
+/************************************************************************************//**
+** \brief     Reports the progress of the job of a lane to its client, once the step or
+**            the percentage changed.
+** \param     lane The lane.
+**
+****************************************************************************************/
+static void DaemonReportProgress(tLane * lane)
+{
+  tJob * job;
+  tTarget const * target;
+  uint32_t done = 0;
+  uint32_t total = 0;
+  uint32_t percent = 0;
+  uint32_t segmentIdx;
+
+  /* Check parameters. */
+  assert(lane != NULL);
+  assert(lane->job != NULL);
+
+  job = lane->job;
+  target = &lane->target;
+  /* Determine the progress of the current step. */
+  switch (target->step)
+  {
+    case TARGET_STEP_ERASE:
+    case TARGET_STEP_PROGRAM:
+    case TARGET_STEP_VERIFY:
+      for (segmentIdx = 0; (segmentIdx < target->segmentIdx) &&
+                           (segmentIdx < target->image->segmentCount); segmentIdx++)
+      {
+        done += target->image->segments[segmentIdx].len;
+      }
+      done += (target->step == TARGET_STEP_ERASE) ? target->segmentOffset :
+                                                    target->progress;
+      total = target->image->totalSize;
+      break;
+    case TARGET_STEP_READ:
+      done = target->progress;
+      total = target->readLength;
+      break;
+    case TARGET_STEP_DISCONNECT:
+      done = 1u;
+      total = 1u;
+      break;
+    default:
+      break;
+  }
+  if (total > 0)
+  {
+    percent = (uint32_t)(((uint64_t)done * 100u) / total);
+    if (percent > 100u)
+    {
+      percent = 100u;
+    }
+  }
+  /* Report the progress if it changed. */
+  if ( (job->client != NULL) && (target->step != TARGET_STEP_DONE) &&
+       ((target->step != job->reportedStep) || (percent != job->reportedPercent)) )
+  {
+    fprintf(job->client->stream, "{\"type\":\"progress\",\"job\":%u,\"step\":\"%s\","
+            "\"percent\":%u}\n", job->number, targetStepNames[target->step], percent);
+    (void)fflush(job->client->stream);
+    job->reportedStep = target->step;
+    job->reportedPercent = percent;
+  }
+} /*** end of DaemonReportProgress ***/
+
+
+/************************************************************************************//**
+** \brief     Accepts the connection of a new client.
+** \param     daemon The daemon.
+** \param     listenSocket The socket that the daemon listens on.
+**
+****************************************************************************************/
+static void DaemonAcceptClient(tDaemon * daemon, int listenSocket)
+{
+  int clientSocket;
+  int flags;
+  uint32_t clientIdx;
+  tClient * client = NULL;
+
+  /* Check parameters. */
+  assert(daemon != NULL);
+
+  clientSocket = accept(listenSocket, NULL, NULL);
+  if (clientSocket >= 0)
+  {
+    /* Find a free place for the client. */
+    for (clientIdx = 0; clientIdx < DAEMON_CLIENTS_MAX; clientIdx++)
+    {
+      if (daemon->clients[clientIdx] == NULL)
+      {
+        client = calloc(1, sizeof(tClient));
+        break;
+      }
+    }
+    /* The socket is made non-blocking, such that a client that does not read its
+     * answers cannot block the daemon. The answers are written to a stream in memory
+     * and sent from there once the socket accepts them.
+     */
+    flags = fcntl(clientSocket, F_GETFL, 0);
+    if ( (client != NULL) && (flags >= 0) &&
+         (fcntl(clientSocket, F_SETFL, flags | O_NONBLOCK) == 0) )
+    {
+      client->socket = clientSocket;
+      client->stream = open_memstream(&client->output, &client->outputLen);
+    }
+    if ( (client != NULL) && (client->stream != NULL) )
+    {
+      daemon->clients[clientIdx] = client;
+    }
+    else
+    {
+      /* Refuse the client. */
+      (void)close(clientSocket);
+      free(client);
+    }
+  }
+} /*** end of DaemonAcceptClient ***/
+
+
+/************************************************************************************//**
+** \brief     Reads the data that a client sent and submits each complete line as a
+**            job.
+** \param     daemon The daemon.
+** \param     client The client.
+** \return    True if successful, false if the client disconnected.
+**
+****************************************************************************************/
+static bool DaemonReadClient(tDaemon * daemon, tClient * client)
+{
+  bool result = false;
+  ssize_t received;
+  char * lineEnd;
+  size_t consumed;
+
+  /* Check parameters. */
+  assert(daemon != NULL);
+  assert(client != NULL);
+
+  /* Append the received data to the line. */
+  received = recv(client->socket, &client->line[client->lineLen],
+                  sizeof(client->line) - 1u - client->lineLen, 0);
+  if (received > 0)
+  {
+    result = true;
+    client->lineLen += (size_t)received;
+    client->line[client->lineLen] = '\0';
+    /* Submit the complete lines. */
+    while ((lineEnd = memchr(client->line, '\n', client->lineLen)) != NULL)
+    {
+      *lineEnd = '\0';
+      DaemonSubmitJob(daemon, client, client->line);
+      consumed = (size_t)(lineEnd - client->line) + 1u;
+      client->lineLen -= consumed;
+      memmove(client->line, &client->line[consumed], client->lineLen + 1u);
+    }
+    /* The line is too long if it fills the buffer without a line ending. */
+    if (client->lineLen >= (sizeof(client->line) - 1u))
+    {
+      /* Close the connection once the error was sent. The rest of the data that the
+       * client already sent is discarded, because closing a socket with unread data
+       * resets the connection before the client could read the error.
+       */
+      fprintf(client->stream, "{\"type\":\"error\",\"message\":\"line too long\"}\n");
+      (void)fflush(client->stream);
+      while (recv(client->socket, client->line, sizeof(client->line), 0) > 0)
+      {
+        ;
+      }
+      client->lineLen = 0;
+      client->closing = true;
+    }
+  }
+  /* Nothing to read is no error for a non-blocking socket. */
+  else if ( (received < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK) ||
+                               (errno == EINTR)) )
+  {
+    result = true;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of DaemonReadClient ***/
+
+
+/************************************************************************************//**
+** \brief     Closes the connection of a client. Its jobs that did not yet start are
+**            removed. Its running job continues, but is no longer reported.
+** \param     daemon The daemon.
+** \param     client The client.
+**
+****************************************************************************************/
+static void DaemonCloseClient(tDaemon * daemon, tClient * client)
+{
+  uint32_t laneIdx;
+  uint32_t clientIdx;
+  tLane * lane;
+  tJob * * next;
+  tJob * job;
+
+  /* Check parameters. */
+  assert(daemon != NULL);
+  assert(client != NULL);
+
+  for (laneIdx = 0; laneIdx < daemon->laneCount; laneIdx++)
+  {
+    lane = daemon->lanes[laneIdx];
+    /* Remove the jobs of the client from the queue. */
+    next = &lane->queue;
+    while (*next != NULL)
+    {
+      job = *next;
+      if (job->client == client)
+      {
+        *next = job->next;
+        DaemonReleaseJob(lane, job);
+      }
+      else
+      {
+        next = &job->next;
+      }
+    }
+    if ( (lane->job != NULL) && (lane->job->client == client) )
+    {
+      lane->job->client = NULL;
+    }
+  }
+  /* Close the connection. */
+  for (clientIdx = 0; clientIdx < DAEMON_CLIENTS_MAX; clientIdx++)
+  {
+    if (daemon->clients[clientIdx] == client)
+    {
+      daemon->clients[clientIdx] = NULL;
+    }
+  }
+  (void)fclose(client->stream);
+  free(client->output);
+  (void)close(client->socket);
+  free(client);
+} /*** end of DaemonCloseClient ***/
+
+
+/************************************************************************************//**
+** \brief     Sends the answers in the output buffer of a client, as far as its socket
+**            accepts them without blocking. The output buffer is emptied once all of
+**            them were sent.
+** \param     client The client.
+** \return    True if successful, false if the connection should be closed. This is the
+**            case when sending failed, when the client did not read its answers for
+**            too long or when the connection was closing and all answers were sent.
+**
+****************************************************************************************/
+static bool DaemonWriteClient(tClient * client)
+{
+  bool result = true;
+  ssize_t sent;
+
+  /* Check parameters. */
+  assert(client != NULL);
+
+  /* Update the output buffer with what was written to the stream. */
+  (void)fflush(client->stream);
+  /* Disconnect a client that does not read its answers. */
+  if ((client->outputLen - client->outputSent) > DAEMON_CLIENT_OUTPUT_MAX)
+  {
+    result = false;
+  }
+  /* Send the answers that were not yet sent. */
+  else if (client->outputSent < client->outputLen)
+  {
+    sent = send(client->socket, &client->output[client->outputSent],
+                client->outputLen - client->outputSent, MSG_NOSIGNAL);
+    if (sent > 0)
+    {
+      client->outputSent += (size_t)sent;
+    }
+    else if ( (sent < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK) &&
+              (errno != EINTR) )
+    {
+      result = false;
+    }
+  }
+  /* Start writing at the beginning of the output buffer again, once it was sent. */
+  if ( (result) && (client->outputSent == client->outputLen) )
+  {
+    rewind(client->stream);
+    (void)fflush(client->stream);
+    client->outputSent = 0;
+    /* A closing connection can now be closed. */
+    if (client->closing)
+    {
+      result = false;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of DaemonWriteClient ***/
+
+
+/************************************************************************************//**
+** \brief     Submits a job that a client sent. The job is added to the queue of the
+**            lane of its interface. The client is answered with an accepted line or
+**            with an error line if the job is invalid.
+** \param     daemon The daemon.
+** \param     client The client.
+** \param     line The line with the command and the parameters of the job.
+**
+****************************************************************************************/
+static void DaemonSubmitJob(tDaemon * daemon, tClient * client, char const * line)
+{
+  char const * error = NULL;
+  char const * params;
+  size_t commandLen;
+  tTargetOperation operation = TARGET_OP_FLASH;
+  tJob * job = NULL;
+  tLane * lane = NULL;
+  tLane * * lanes;
+  uint32_t laneIdx;
+  int paramIdx;
+  uint32_t loadTime = 0;
+
+  /* Check parameters. */
+  assert(daemon != NULL);
+  assert(client != NULL);
+  assert(line != NULL);
+
+  /* Extract the command. An empty line is ignored. */
+  while ( (*line == ' ') || (*line == '\t') || (*line == '\r') )
+  {
+    line++;
+  }
+  for (commandLen = 0; (line[commandLen] != '\0') && (line[commandLen] != ' ') &&
+                       (line[commandLen] != '\t') && (line[commandLen] != '\r');
+       commandLen++)
+  {
+    /* Nothing to do. Just find the end of the command. */
+  }
+  params = &line[commandLen];
+  if (commandLen == 0)
+  {
+    return;
+  }
+  if ( (commandLen == 5) && (strncmp(line, "flash", 5) == 0) )
+  {
+    operation = TARGET_OP_FLASH;
+  }
+  else if ( (commandLen == 6) && (strncmp(line, "verify", 6) == 0) )
+  {
+    operation = TARGET_OP_VERIFY;
+  }
+  else if ( (commandLen == 4) && (strncmp(line, "read", 4) == 0) )
+  {
+    operation = TARGET_OP_READ;
+  }
+  else
+  {
+    error = "unknown command";
+  }
+
+  /* Create the job from the parameters. */
+  if (error == NULL)
+  {
+    job = malloc(sizeof(tJob));
+    if ( (job == NULL) || (InitJob(job, params, daemon->argc, daemon->argv) <= 0) )
+    {
+      error = "invalid parameters";
+    }
+  }
+  if (error == NULL)
+  {
+    job->operation = operation;
+    if (operation == TARGET_OP_READ)
+    {
+      /* Extract the memory range to read. */
+      for (paramIdx = 1; paramIdx < job->argc; paramIdx++)
+      {
+        if (strncmp(job->argv[paramIdx], "-ra=", 4) == 0)
+        {
+          (void)sscanf(&job->argv[paramIdx][4], "%x", &job->readAddress);
+        }
+        else if (strncmp(job->argv[paramIdx], "-rl=", 4) == 0)
+        {
+          (void)sscanf(&job->argv[paramIdx][4], "%u", &job->readLength);
+        }
+      }
+      if (job->readLength == 0)
+      {
+        error = "invalid memory range";
+      }
+    }
+    else
+    {
+      /* Load the firmware data, which is taken from the firmware cache if the file was
+       * loaded before.
+       */
+      loadTime = BltUtilTimeGetSystemTime();
+      job->image = DaemonLoadImage(job->firmwareFile);
+      loadTime = BltUtilTimeGetSystemTime() - loadTime;
+      if (job->image == NULL)
+      {
+        error = "could not load firmware file";
+      }
+    }
+  }
+
+  /* Find the lane of the interface or add a new one. */
+  if (error == NULL)
+  {
+    for (laneIdx = 0; laneIdx < daemon->laneCount; laneIdx++)
+    {
+      if (strcmp(daemon->lanes[laneIdx]->interfaceName, job->interfaceName) == 0)
+      {
+        lane = daemon->lanes[laneIdx];
+        break;
+      }
+    }
+    if (lane == NULL)
+    {
+      lanes = realloc(daemon->lanes, (daemon->laneCount + 1u) * sizeof(tLane *));
+      if (lanes != NULL)
+      {
+        daemon->lanes = lanes;
+        lane = malloc(sizeof(tLane));
+      }
+      if ( (lane != NULL) &&
+           (!InitLane(lane, job->interfaceName, daemon->programSettings->silentMode)) )
+      {
+        ReleaseLane(lane);
+        free(lane);
+        lane = NULL;
+      }
+      if (lane != NULL)
+      {
+        daemon->lanes[daemon->laneCount] = lane;
+        daemon->laneCount++;
+      }
+      else
+      {
+        error = "out of memory";
+      }
+    }
+  }
+
+  /* Queue the job and answer the client. */
+  if (error == NULL)
+  {
+    daemon->jobCount++;
+    job->number = daemon->jobCount;
+    job->client = client;
+    AddLaneJob(lane, job);
+    fprintf(client->stream, "{\"type\":\"accepted\",\"job\":%u,\"operation\":\"%s\","
+            "\"interface\":", job->number, targetOperationNames[operation]);
+    PrintJsonString(client->stream, lane->interfaceName);
+    if (job->image != NULL)
+    {
+      fprintf(client->stream, ",\"load_ms\":%u", loadTime);
+    }
+    fprintf(client->stream, "}\n");
+    (void)fflush(client->stream);
+    /* Start the job right away if the lane is idle. */
+    if (lane->job == NULL)
+    {
+      DaemonStartLaneJob(lane);
+    }
+  }
+  else
+  {
+    fprintf(client->stream, "{\"type\":\"error\",\"message\":\"%s\"}\n", error);
+    (void)fflush(client->stream);
+    if (job != NULL)
+    {
+      DaemonFreeImage(job->image);
+      ReleaseJob(job);
+      free(job);
+    }
+  }
+} /*** end of DaemonSubmitJob ***/
+
+
+/************************************************************************************//**
+** \brief     Loads the firmware data of a firmware file for a job of the daemon. The
+**            firmware data module takes it from the firmware cache if the same contents
+**            were loaded before, so a file is only parsed again after it was changed.
+**            The firmware data is copied, such that it stays valid while other files
+**            are loaded. It should be released with DaemonFreeImage.
+** \param     file The firmware file.
+** \return    The firmware data or NULL if the file could not be loaded.
+**
+****************************************************************************************/
+static tImage * DaemonLoadImage(char const * file)
+{
+  tImage * result;
+
+  /* Check parameters. */
+  assert(file != NULL);
+
+  result = calloc(1, sizeof(tImage));
+  if (result != NULL)
+  {
+    if ( (BltFirmwareLoadFromFile(file, 0) != BLT_RESULT_OK) ||
+         (!CreateImage(result, true)) )
+    {
+      free(result);
+      result = NULL;
+    }
+    BltFirmwareClearData();
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of DaemonLoadImage ***/
+
+
+/************************************************************************************//**
+** \brief     Releases the firmware data that was loaded with DaemonLoadImage.
+** \param     image The firmware data. Nothing happens if it is NULL.
+**
+****************************************************************************************/
+static void DaemonFreeImage(tImage * image)
+{
+  if (image != NULL)
+  {
+    DestroyImage(image);
+    free(image);
+  }
+} /*** end of DaemonFreeImage ***/
+#endif /* PLATFORM_LINUX */
+
+
+/************************************************************************************//**
+** \brief     Parses the command line to extract the program settings. 
+** \param     argc Number of program arguments.
+** \param     argv Array with program parameter strings.
+** \param     programSettings Pointer to the setting structure where the program settings
+**            should be written to.
+**
+****************************************************************************************/
+static void ExtractProgramSettingsFromCommandLine(int argc, char const * const argv[],
+                                                  tProgramSettings * programSettings)
+{
+  uint8_t paramIdx;
+
+  /* Check parameters. */
+  assert(argv != NULL);
+  assert(programSettings != NULL);
+
+  /* Only continue if parameters are valid. */
+  if ( (argv != NULL) && (programSettings != NULL) ) /*lint !e774 */
+  {
+    /* Set default program settings. */
+    programSettings->silentMode = false;
+    programSettings->targetList = NULL;
+    programSettings->emulate = false;
+    programSettings->manifestFile = NULL;
+    programSettings->daemonSocket = NULL;
+    programSettings->firmwareCache = NULL;
+    /* Loop through all the command line parameters, just skip the 1st one because
+     * this  is the name of the program, which we are not interested in.
+     */
+    for (paramIdx = 1; paramIdx < argc; paramIdx++)
+    {
+      /* Is this the -sm parameter? */
+      if ( (strstr(argv[paramIdx], "-sm") != NULL) &&
+           (strlen(argv[paramIdx]) == 3) )
+      {
+        /* Activate silent mode. */
+        programSettings->silentMode = true;
+        /* Continue with next loop iteration. */
+        continue;
+      }
+      /* Is this the -mt=[list] parameter? */
+      if ( (strstr(argv[paramIdx], "-mt=") != NULL) &&
+           (strlen(argv[paramIdx]) > 4) )
+      {
+        /* Store the pointer to the target list. */
+        programSettings->targetList = &argv[paramIdx][4];
+        /* Continue with next loop iteration. */
+        continue;
+      }
+      /* Is this the -bm=[file] parameter? */
+      if ( (strstr(argv[paramIdx], "-bm=") != NULL) &&
+           (strlen(argv[paramIdx]) > 4) )
+      {
+        /* Store the pointer to the batch manifest filename. */
+        programSettings->manifestFile = &argv[paramIdx][4];
+        /* Continue with next loop iteration. */
+        continue;
+      }
+      /* Is this the -ds=[socket] parameter? */
+      if ( (strstr(argv[paramIdx], "-ds=") != NULL) &&
+           (strlen(argv[paramIdx]) > 4) )
+      {
+        /* Store the pointer to the socket of the daemon. */
+        programSettings->daemonSocket = &argv[paramIdx][4];
+        /* Continue with next loop iteration. */
+        continue;
+      }
+      /* Is this the -fc=[directory] parameter? */
+      if ( (strstr(argv[paramIdx], "-fc=") != NULL) &&
+           (strlen(argv[paramIdx]) > 4) )
+      {
+        /* Store the pointer to the directory of the firmware cache. */
+        programSettings->firmwareCache = &argv[paramIdx][4];
+        /* Continue with next loop iteration. */
+        continue;
+      }
+      /* Is this the -emu=[options] parameter? */
+      if ( (strstr(argv[paramIdx], "-emu=") != NULL) &&
+           (strlen(argv[paramIdx]) > 5) )
+      {
+        /* Activate the network emulation with the specified options. */
+        programSettings->emulate = true;
+        ExtractEmulationSettings(&argv[paramIdx][5], &programSettings->emulation);
+        /* Continue with next loop iteration. */
+        continue;
+      }
+    }
+  }
+} /*** end of ExtractProgramSettingsFromCommandLine ***/
+
+
+/************************************************************************************//**
+** \brief     Extracts the network emulation settings from the options of the
+**            -emu=[options] parameter, such as "delay=2000,jitter=500,loss=0.01,seed=7".
+**            Probabilities are specified as a percentage. Unknown options are ignored
+**            and options that are not specified are 0.
+** \param     options The options of the parameter.
+** \param     emulation Pointer to the settings structure where the network emulation
+**            settings should be written to.
+**
+****************************************************************************************/
+static void ExtractEmulationSettings(char const * options,
+                                     tBltTransportSettingsXcpV10Emu * emulation)
+{
+  char const * option;
+  unsigned long value;
+  double percentage;
+  uint32_t * probability;
+
+  /* Check parameters. */
+  assert(options != NULL);
+  assert(emulation != NULL);
+
+  /* Only continue if parameters are valid. */
+  if ( (options != NULL) && (emulation != NULL) ) /*lint !e774 */
+  {
+    /* Set default network emulation settings. */
+    memset(emulation, 0, sizeof(tBltTransportSettingsXcpV10Emu));
+    /* Process the options one by one. */
+    option = options;
+    while (option != NULL)
+    {
+      probability = NULL;
+      if (sscanf(option, "delay=%lu", &value) == 1)
+      {
+        emulation->delay = (uint32_t)value;
+      }
+      else if (sscanf(option, "jitter=%lu", &value) == 1)
+      {
+        emulation->jitter = (uint32_t)value;
+      }
+      else if (sscanf(option, "seed=%lu", &value) == 1)
+      {
+        emulation->seed = (uint32_t)value;
+      }
+      else if (sscanf(option, "loss=%lf", &percentage) == 1)
+      {
+        probability = &emulation->loss;
+      }
+      else if (sscanf(option, "dup=%lf", &percentage) == 1)
+      {
+        probability = &emulation->duplicate;
+      }
+      else if (sscanf(option, "reorder=%lf", &percentage) == 1)
+      {
+        probability = &emulation->reorder;
+      }
+      /* Convert a percentage to parts per million. */
+      if (probability != NULL)
+      {
+        if (percentage < 0.0)
+        {
+          percentage = 0.0;
+        }
+        else if (percentage > 100.0)
+        {
+          percentage = 100.0;
+        }
+        *probability = (uint32_t)(percentage * 10000.0);
+      }
+      /* Move on to the next option, skipping the separator. */
+      option = strchr(option, ',');
+      if (option != NULL)
+      {
+        option++;
+      }
+    }
+  }
+} /*** end of ExtractEmulationSettings ***/
+
+
+/************************************************************************************//**
+** \brief     Parses the command line to extract the session type. This is the one
+**            specified via the -s=[name] parameter.
+** \param     argc Number of program arguments.
+** \param     argv Array with program parameter strings.
+** \return    The session type value as used in LibOpenBLT.
+**
+****************************************************************************************/
+static uint32_t ExtractSessionTypeFromCommandLine(int argc, char const * const argv[])
+{
+  uint32_t result;
+  uint8_t paramIdx;
+  uint8_t mapIdx; 
+  /* Mapping of the supported session types to the session type values. */
+  const struct
+  {
+    char * name;
+    uint32_t value;
+  } sessionMap[] =
+  {
+    { .name = "xcp",  .value = BLT_SESSION_XCP_V10 }
+  };
+  
+  /* Set the default session in case nothing was specified on the command line. */
+  result = sessionMap[0].value;
+
+  /* Check parameters. */
+  assert(argv != NULL);
+
+  /* Only continue if parameters are valid. */
+  if (argv != NULL) /*lint !e774 */
+  {
+    /* Loop through all the command line parameters, just skip the 1st one because this
+     * is the name of the program, which we are not interested in.
+     */
+    for (paramIdx = 1; paramIdx < argc; paramIdx++)
+    {
+      /* Check of the if -s is present in this argument. Note that the argument must have
+       * at least 4 characters to be a valid -s=[name] parameter.
+       */
+      if ( (strstr(argv[paramIdx], "-s=") != NULL) && (strlen(argv[paramIdx]) > 3) )
+      {
+        /* Loop through the map to find a matching session name. */
+        for (mapIdx = 0; mapIdx < sizeof(sessionMap)/sizeof(sessionMap[0]); mapIdx++)
+        {
+          /* Check for matching name. */
+          if (strcmp(sessionMap[mapIdx].name, &argv[paramIdx][3]) == 0)
+          {
+            /* Match found, now store the associated session type value. */
+            result = sessionMap[mapIdx].value;
+            /* No need to continue searching. */
+            break;
+          }
+        }
+      }
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
 } /*** end of ExtractSessionTypeFromCommandLine ***/
 
 
@@ -1066,7 +4452,8 @@ static uint32_t ExtractTransportTypeFromCommandLine(int argc, char const * const
     { .name = "xcp_rs232", .value = BLT_TRANSPORT_XCP_V10_RS232 },
     { .name = "xcp_can", .value = BLT_TRANSPORT_XCP_V10_CAN },
     { .name = "xcp_usb", .value = BLT_TRANSPORT_XCP_V10_USB },
-    { .name = "xcp_net", .value = BLT_TRANSPORT_XCP_V10_NET }
+    { .name = "xcp_net", .value = BLT_TRANSPORT_XCP_V10_NET },
+    { .name = "xcp_udp", .value = BLT_TRANSPORT_XCP_V10_UDP }
   };
   
   /* Set the default transport type in case nothing was specified on the command line. */
@@ -1187,6 +4574,7 @@ static void * ExtractTransportSettingsFromCommandLine(int argc,
          *   -tid=[value]   -> Transmit CAN identifier (32-bit hexadecimal).
          *   -rid=[value]   -> Receive CAN identifier (32-bit hexadecimal).
          *   -xid=[value]   -> Flag for configuring extended CAN identifiers (8-bit).
+         *   -fg=[value]    -> Minimum time between transmitted frames in us (32-bit).
          */
         /* Allocate memory for storing the settings and check the result. */
         result = malloc(sizeof(tBltTransportSettingsXcpV10Can));
@@ -1203,6 +4591,7 @@ static void * ExtractTransportSettingsFromCommandLine(int argc,
           canSettings->transmitId = 0x667;
           canSettings->receiveId = 0x7E1;
           canSettings->useExtended = false;
+          canSettings->txFrameGap = 0;
           /* Loop through all the command line parameters, just skip the 1st one because 
            * this  is the name of the program, which we are not interested in.
            */
@@ -1265,6 +4654,15 @@ static void * ExtractTransportSettingsFromCommandLine(int argc,
               /* Continue with next loop iteration. */
               continue;
             }
+            /* Is this the -fg=[value] parameter? */
+            if ( (strstr(argv[paramIdx], "-fg=") != NULL) && 
+                 (strlen(argv[paramIdx]) > 4) )
+            {
+              /* Extract the minimum frame gap value. */
+              sscanf(&argv[paramIdx][4], "%u", &(canSettings->txFrameGap));
+              /* Continue with next loop iteration. */
+              continue;
+            }
           }
         }
         break;
@@ -1279,6 +4677,7 @@ static void * ExtractTransportSettingsFromCommandLine(int argc,
           /* The following transport layer specific command line parameters are supported:
            *   -a=[value]     -> The IP address or hostname of the target to connect to.
            *   -p=[value]     -> The TCP port number to use.
+           *   -w=[value]     -> Maximum number of program commands in flight.
            */
           /* Allocate memory for storing the settings and check the result. */
           result = malloc(sizeof(tBltTransportSettingsXcpV10Net));
@@ -1291,6 +4690,7 @@ static void * ExtractTransportSettingsFromCommandLine(int argc,
             /* Set default values. */
             netSettings->address = NULL;
             netSettings->port = 1000;
+            netSettings->window = 1;
             /* Loop through all the command line parameters, just skip the 1st one because
              * this  is the name of the program, which we are not interested in.
              */
@@ -1314,6 +4714,69 @@ static void * ExtractTransportSettingsFromCommandLine(int argc,
                 /* Continue with next loop iteration. */
                 continue;
               }
+              /* Is this the -w=[value] parameter? */
+              if ( (strstr(argv[paramIdx], "-w=") != NULL) &&
+                   (strlen(argv[paramIdx]) > 3) )
+              {
+                /* Extract the window value. */
+                sscanf(&argv[paramIdx][3], "%u", &(netSettings->window));
+                /* Continue with next loop iteration. */
+                continue;
+              }
+            }
+          }
+          break;
+        /* -------------------------- XCP on UDP/IP ---------------------------------- */
+        case BLT_TRANSPORT_XCP_V10_UDP:
+          /* The following transport layer specific command line parameters are supported:
+           *   -a=[value]     -> The IP address or hostname of the target to connect to.
+           *   -p=[value]     -> The UDP port number to use.
+           *   -w=[value]     -> Maximum number of program commands in flight.
+           */
+          /* Allocate memory for storing the settings and check the result. */
+          result = malloc(sizeof(tBltTransportSettingsXcpV10Udp));
+          assert(result != NULL);
+          if (result != NULL) /*lint !e774 */
+          {
+            /* Create typed pointer for easy reading. */
+            tBltTransportSettingsXcpV10Udp * udpSettings =
+              (tBltTransportSettingsXcpV10Udp *)result;
+            /* Set default values. */
+            udpSettings->address = NULL;
+            udpSettings->port = 1000;
+            udpSettings->window = 1;
+            /* Loop through all the command line parameters, just skip the 1st one because
+             * this  is the name of the program, which we are not interested in.
+             */
+            for (paramIdx = 1; paramIdx < argc; paramIdx++)
+            {
+              /* Is this the -a=[name] parameter? */
+              if ( (strstr(argv[paramIdx], "-a=") != NULL) &&
+                   (strlen(argv[paramIdx]) > 3) )
+              {
+                /* Store the pointer to the network address. */
+                udpSettings->address = &argv[paramIdx][3];
+                /* Continue with next loop iteration. */
+                continue;
+              }
+              /* Is this the -p=[value] parameter? */
+              if ( (strstr(argv[paramIdx], "-p=") != NULL) &&
+                   (strlen(argv[paramIdx]) > 3) )
+              {
+                /* Extract the port value. */
+                sscanf(&argv[paramIdx][3], "%hu", &(udpSettings->port));
+                /* Continue with next loop iteration. */
+                continue;
+              }
+              /* Is this the -w=[value] parameter? */
+              if ( (strstr(argv[paramIdx], "-w=") != NULL) &&
+                   (strlen(argv[paramIdx]) > 3) )
+              {
+                /* Extract the window value. */
+                sscanf(&argv[paramIdx][3], "%u", &(udpSettings->window));
+                /* Continue with next loop iteration. */
+                continue;
+              }
             }
           }
           break;
@@ -1336,8 +4799,8 @@ static void * ExtractTransportSettingsFromCommandLine(int argc,
 ** \return    Pointer to the character array (string) with the firmware file.
 **
 ****************************************************************************************/
-static char const * const ExtractFirmwareFileFromCommandLine(int argc, 
-                                                             char const * const argv[])
+static char const * ExtractFirmwareFileFromCommandLine(int argc, 
+                                                       char const * const argv[])
 {
   char const * result = NULL;
   uint8_t paramIdx;
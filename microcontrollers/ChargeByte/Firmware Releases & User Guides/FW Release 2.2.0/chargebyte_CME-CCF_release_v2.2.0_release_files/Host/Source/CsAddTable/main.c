@@ -36,6 +36,12 @@
 #include <stdlib.h>                         /* for standard library                    */
 #include <stdio.h>                          /* Standard I/O functions.                 */
 #include <string.h>                         /* for string library                      */
+#if defined(PLATFORM_WINDOWS)
+#include <windows.h>                        /* for threads                             */
+#else
+#include <pthread.h>                        /* for threads                             */
+#include <unistd.h>                         /* for sysconf                             */
+#endif
 #include "openblt.h"                        /* OpenBLT host library.                   */
 
 
@@ -80,6 +86,37 @@
  */
 #define RESULT_ERROR_DATA_EXCLUSION         (7)
 
+/** \brief Maximum number of bytes that a worker thread checksums at a time. Larger
+ *         segments are split into chunks of this size, such that the worker threads
+ *         process them in parallel. The CRC values of the chunks are combined into the
+ *         CRC value of the segment afterwards.
+ */
+#define CHECKSUM_CHUNK_SIZE                 (262144u)
+
+/** \brief Maximum number of worker threads. */
+#define CHECKSUM_THREADS_MAX                (64u)
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Part of a firmware data segment over which a CRC value is calculated. */
+typedef struct
+{
+  uint8_t const * data;          /**< Pointer to the data of the chunk.                */
+  uint32_t len;                  /**< Number of bytes.                                 */
+  uint16_t crc;                  /**< CRC16 value, once calculated.                    */
+} tChecksumChunk;
+
+/** \brief Firmware data segment for which a row in the checksum info table is made. */
+typedef struct
+{
+  uint32_t address;              /**< Base address of the segment.                     */
+  uint32_t size;                 /**< Number of bytes.                                 */
+  uint8_t const * data;          /**< Pointer to the data of the segment.              */
+  uint32_t firstChunk;           /**< Index of the first chunk of the segment.         */
+} tChecksumSegment;
+
 
 /****************************************************************************************
 * Function prototypes
@@ -88,6 +125,16 @@ static void DisplayProgramInfo(void);
 static void DisplayProgramUsage(void);
 static bool ParseCommandLine(int argc, char const * const argv[]);
 static uint32_t GenerateChecksumInfoTable(uint8_t * const tableData);
+static void ProcessChecksumChunks(void);
+static void ChecksumWorker(void);
+#if defined(PLATFORM_WINDOWS)
+static DWORD WINAPI ChecksumThreadEntry(LPVOID param);
+#else
+static void * ChecksumThreadEntry(void * param);
+#endif
+static void ChecksumLock(void);
+static void ChecksumUnlock(void);
+static uint32_t GetProcessorCount(void);
 
 
 /****************************************************************************************
@@ -124,6 +171,25 @@ static char const * inputFileStr;
 /** \brief The filename of the output firmware file as specified on the command line. */
 static char const * outputFileStr;
 
+/** \brief Number of worker threads that calculate the checksums. */
+static uint32_t checksumThreadCount;
+
+/** \brief Array with the chunks of firmware data to checksum. */
+static tChecksumChunk * checksumChunks;
+
+/** \brief Number of chunks in the checksumChunks array. */
+static uint32_t checksumChunkCount;
+
+/** \brief Index of the next chunk that a worker thread takes from the array. */
+static uint32_t checksumChunkNext;
+
+/** \brief Lock for the chunk index, shared by the worker threads. */
+#if defined(PLATFORM_WINDOWS)
+static CRITICAL_SECTION checksumLock;
+#else
+static pthread_mutex_t checksumLock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
 
 /************************************************************************************//**
 ** \brief     This is the program entry point.
@@ -332,6 +398,9 @@ static void DisplayProgramUsage(void)
   printf("                    The first value is the start address and the second\n");
   printf("                    value is the end address. Specify both addresses as\n");
   printf("                    32-bit hexadecimal values e.g. -x08000000:08000FFF.\n");
+  printf("  -j[value]         Number of threads that calculate the checksums in\n");
+  printf("                    parallel, as a decimal value (Default=number of\n");
+  printf("                    processors).\n");
   printf("\n");
   printf("-------------------------------------------------------------------------\n");
 } /*** end of DisplayProgramUsage ***/
@@ -361,13 +430,14 @@ static bool ParseCommandLine(int argc, char const * const argv[])
   excludeRegionLen = 0;
   inputFileStr = NULL;
   outputFileStr = NULL;
+  checksumThreadCount = GetProcessorCount();
 
-  /* Only continue if parameters are valid. Note that 4 -5 command line parameters are
+  /* Only continue if parameters are valid. Note that 4 - 7 command line parameters are
    * expected. The first one if the name of this program's executable. After this the
    * address offset is expected, followed by the  input and output firmware files. The
-   * '-t' option for outputting only the checksum info table is optional
+   * '-t', '-x' and '-j' options are optional.
    */
-  if ( (argv != NULL) && ( (argc >= 4) && (argc <= 6) ) ) /*lint !e774 */
+  if ( (argv != NULL) && ( (argc >= 4) && (argc <= 7) ) ) /*lint !e774 */
   {
     /* Extract the input file. It is the second to last command line parameter. It should
      * not start with '-', as this is typically the start of a command line option.
@@ -431,6 +501,25 @@ static bool ParseCommandLine(int argc, char const * const argv[])
         /* Continue with next loop iteration. */
         continue;
       }
+      /* Is this the -j[value] parameter? */
+      if ( (strstr(argv[paramIdx], "-j") != NULL) &&
+           (strlen(argv[paramIdx]) > 2) )
+      {
+        /* Extract the number of worker threads and keep it within its limits. */
+        uint32_t threadCount = 0;
+        sscanf(&argv[paramIdx][2], "%u", &threadCount);
+        if (threadCount < 1u)
+        {
+          threadCount = 1u;
+        }
+        if (threadCount > CHECKSUM_THREADS_MAX)
+        {
+          threadCount = CHECKSUM_THREADS_MAX;
+        }
+        checksumThreadCount = threadCount;
+        /* Continue with next loop iteration. */
+        continue;
+      }
     }
     /* Validate the result. */
     if ( (tableBaseAddr != 0xffffffff) && (inputFileStr != NULL) &&
@@ -458,11 +547,15 @@ static uint32_t GenerateChecksumInfoTable(uint8_t * const tableData)
 {
   uint32_t result = 0;
   uint32_t segmentIdx;
+  uint32_t segmentCount;
+  uint32_t chunkIdx;
+  uint32_t chunkOffset;
   uint8_t * dataPtr;
   uint16_t crc16Value;
   uint32_t segmentAddress;
   uint32_t segmentSize;
   uint8_t const * segmentData;
+  tChecksumSegment * segments;
   /* Constant checksum table identifier. This value is stored in the first four bytes
    * of the checksum info table.
    */
@@ -474,17 +567,66 @@ static uint32_t GenerateChecksumInfoTable(uint8_t * const tableData)
   /* Only continue with valid parameters. */
   if (tableData != NULL) /*lint !e774 */
   {
+    /* Obtain information about all segments up front and determine how many chunks
+     * their firmware data is split into.
+     */
+    segmentCount = BltFirmwareGetSegmentCount();
+    segments = malloc((segmentCount + 1u) * sizeof(tChecksumSegment));
+    checksumChunkCount = 0;
+    checksumChunks = NULL;
+    if (segments != NULL)
+    {
+      for (segmentIdx = 0; segmentIdx < segmentCount; segmentIdx++)
+      {
+        segmentData = BltFirmwareGetSegment(segmentIdx, &segmentAddress, &segmentSize);
+        /* Validate the obtained segment information. This should not happen so flag it
+         * as an error.
+         */
+        if ( (segmentData == NULL) || (segmentSize == 0) )
+        {
+          break;
+        }
+        segments[segmentIdx].address = segmentAddress;
+        segments[segmentIdx].size = segmentSize;
+        segments[segmentIdx].data = segmentData;
+        segments[segmentIdx].firstChunk = checksumChunkCount;
+        checksumChunkCount += ((segmentSize - 1u) / CHECKSUM_CHUNK_SIZE) + 1u;
+      }
+      /* Only continue if all segments are valid. */
+      if (segmentIdx == segmentCount)
+      {
+        checksumChunks = malloc((checksumChunkCount + 1u) * sizeof(tChecksumChunk));
+      }
+    }
+    /* Split the segments into chunks and calculate their checksums in parallel. */
+    if (checksumChunks != NULL)
+    {
+      for (segmentIdx = 0; segmentIdx < segmentCount; segmentIdx++)
+      {
+        chunkIdx = segments[segmentIdx].firstChunk;
+        for (chunkOffset = 0; chunkOffset < segments[segmentIdx].size;
+             chunkOffset += CHECKSUM_CHUNK_SIZE)
+        {
+          checksumChunks[chunkIdx].data = &segments[segmentIdx].data[chunkOffset];
+          checksumChunks[chunkIdx].len = segments[segmentIdx].size - chunkOffset;
+          if (checksumChunks[chunkIdx].len > CHECKSUM_CHUNK_SIZE)
+          {
+            checksumChunks[chunkIdx].len = CHECKSUM_CHUNK_SIZE;
+          }
+          chunkIdx++;
+        }
+      }
+      ProcessChecksumChunks();
+    }
     /* Initialize the data pointer to right after the header row. This row will be added
      * after adding the rows for each segment of firmware data.
      */
     dataPtr = &tableData[0] + 10u;
     /* Loop over all segments with firmware data. */
-    for (segmentIdx = 0; segmentIdx < BltFirmwareGetSegmentCount(); segmentIdx++)
+    for (segmentIdx = 0; segmentIdx < segmentCount; segmentIdx++)
     {
-      /* Obtain information about the segment and access to its firmware data. */
-      segmentData = BltFirmwareGetSegment(segmentIdx, &segmentAddress, &segmentSize);
-      /* Validate the obtained segment information. */
-      if ( (segmentData == NULL) || (segmentSize == 0) )
+      /* Stop if the checksums could not be calculated. */
+      if (checksumChunks == NULL)
       {
         /* This should not happen so flag it as an error. */
         result = 0;
@@ -493,8 +635,20 @@ static uint32_t GenerateChecksumInfoTable(uint8_t * const tableData)
       /* Segment information is assumed valid. */
       else
       {
-        /* Calculate the checksum over the segment's firmware data. */
-        crc16Value = BltUtilCrc16Calculate(segmentData, segmentSize);
+        segmentAddress = segments[segmentIdx].address;
+        segmentSize = segments[segmentIdx].size;
+        /* Combine the checksums of the segment's chunks into the checksum over the
+         * segment's firmware data.
+         */
+        chunkIdx = segments[segmentIdx].firstChunk;
+        crc16Value = checksumChunks[chunkIdx].crc;
+        for (chunkOffset = checksumChunks[chunkIdx].len; chunkOffset < segmentSize;
+             chunkOffset += checksumChunks[chunkIdx].len)
+        {
+          chunkIdx++;
+          crc16Value = BltUtilCrc16Combine(crc16Value, checksumChunks[chunkIdx].crc,
+                                           checksumChunks[chunkIdx].len);
+        }
         /* Add the segment's base address (LSB first). */
         *dataPtr = (uint8_t)segmentAddress;
         dataPtr++;
@@ -570,12 +724,195 @@ static uint32_t GenerateChecksumInfoTable(uint8_t * const tableData)
       /* Update the result value, which holds the number of bytes that were added. */
       result += 10;
     }
+    /* Release the allocated memory. */
+    free(checksumChunks);
+    checksumChunks = NULL;
+    free(segments);
   }
   /* Give the result back to the caller. */
   return result;
 } /*** end of GenerateChecksumInfoTable ***/
 
 
+/************************************************************************************//**
+** \brief     Calculates the checksums of all chunks with a pool of worker threads. Each
+**            worker thread takes the next chunk, until all chunks are processed. The
+**            program's main thread is one of the worker threads. No more threads are
+**            started than there are chunks, so small firmware files are processed
+**            without starting any additional threads.
+**
+****************************************************************************************/
+static void ProcessChecksumChunks(void)
+{
+  uint32_t threadCount = checksumThreadCount;
+  uint32_t threadsStarted = 0;
+#if defined(PLATFORM_WINDOWS)
+  HANDLE threads[CHECKSUM_THREADS_MAX];
+#else
+  pthread_t threads[CHECKSUM_THREADS_MAX];
+#endif
+
+  /* Initialize the shared state of the worker threads. */
+  checksumChunkNext = 0;
+#if defined(PLATFORM_WINDOWS)
+  InitializeCriticalSection(&checksumLock);
+#endif
+  if (threadCount > checksumChunkCount)
+  {
+    threadCount = checksumChunkCount;
+  }
+  /* Start the additional worker threads. If a thread cannot be started, the ones that
+   * did start simply take more chunks.
+   */
+  for (uint32_t idx = 1; idx < threadCount; idx++)
+  {
+#if defined(PLATFORM_WINDOWS)
+    threads[threadsStarted] = CreateThread(NULL, 0, ChecksumThreadEntry, NULL, 0, NULL);
+    if (threads[threadsStarted] == NULL)
+    {
+      break;
+    }
+#else
+    if (pthread_create(&threads[threadsStarted], NULL, ChecksumThreadEntry, NULL) != 0)
+    {
+      break;
+    }
+#endif
+    threadsStarted++;
+  }
+  /* The main thread works along and then waits for the other threads to finish. */
+  ChecksumWorker();
+  for (uint32_t idx = 0; idx < threadsStarted; idx++)
+  {
+#if defined(PLATFORM_WINDOWS)
+    (void)WaitForSingleObject(threads[idx], INFINITE);
+    (void)CloseHandle(threads[idx]);
+#else
+    (void)pthread_join(threads[idx], NULL);
+#endif
+  }
+#if defined(PLATFORM_WINDOWS)
+  DeleteCriticalSection(&checksumLock);
+#endif
+} /*** end of ProcessChecksumChunks ***/
+
+
+/************************************************************************************//**
+** \brief     Takes chunks and calculates their checksums, until no chunks are left.
+**
+****************************************************************************************/
+static void ChecksumWorker(void)
+{
+  uint32_t chunkIdx;
+
+  for (;;)
+  {
+    /* Take the next chunk. */
+    ChecksumLock();
+    chunkIdx = checksumChunkNext;
+    if (chunkIdx < checksumChunkCount)
+    {
+      checksumChunkNext++;
+    }
+    ChecksumUnlock();
+    /* Stop when there are no more chunks to process. */
+    if (chunkIdx >= checksumChunkCount)
+    {
+      break;
+    }
+    /* Calculate the checksum over the chunk. Each worker thread only writes to the
+     * chunks that it took.
+     */
+    checksumChunks[chunkIdx].crc = BltUtilCrc16Calculate(checksumChunks[chunkIdx].data,
+                                                         checksumChunks[chunkIdx].len);
+  }
+} /*** end of ChecksumWorker ***/
+
+
+/************************************************************************************//**
+** \brief     Entry point of an additional worker thread.
+** \param     param Not used.
+** \return    Always zero.
+**
+****************************************************************************************/
+#if defined(PLATFORM_WINDOWS)
+static DWORD WINAPI ChecksumThreadEntry(LPVOID param)
+{
+  (void)param;
+  ChecksumWorker();
+  return 0;
+} /*** end of ChecksumThreadEntry ***/
+#else
+static void * ChecksumThreadEntry(void * param)
+{
+  (void)param;
+  ChecksumWorker();
+  return NULL;
+} /*** end of ChecksumThreadEntry ***/
+#endif
+
+
+/************************************************************************************//**
+** \brief     Obtains the lock that the worker threads share.
+**
+****************************************************************************************/
+static void ChecksumLock(void)
+{
+#if defined(PLATFORM_WINDOWS)
+  EnterCriticalSection(&checksumLock);
+#else
+  (void)pthread_mutex_lock(&checksumLock);
+#endif
+} /*** end of ChecksumLock ***/
+
+
+/************************************************************************************//**
+** \brief     Releases the lock that the worker threads share.
+**
+****************************************************************************************/
+static void ChecksumUnlock(void)
+{
+#if defined(PLATFORM_WINDOWS)
+  LeaveCriticalSection(&checksumLock);
+#else
+  (void)pthread_mutex_unlock(&checksumLock);
+#endif
+} /*** end of ChecksumUnlock ***/
+
+
+/************************************************************************************//**
+** \brief     Determines the number of processors, which is the default number of worker
+**            threads.
+** \return    Number of processors, at least 1 and at most CHECKSUM_THREADS_MAX.
+**
+****************************************************************************************/
+static uint32_t GetProcessorCount(void)
+{
+  uint32_t result;
+#if defined(PLATFORM_WINDOWS)
+  SYSTEM_INFO systemInfo;
+
+  GetSystemInfo(&systemInfo);
+  result = systemInfo.dwNumberOfProcessors;
+#else
+  long processors = sysconf(_SC_NPROCESSORS_ONLN);
+
+  result = (processors > 0) ? (uint32_t)processors : 1u;
+#endif
+  /* Keep the value within its limits. */
+  if (result < 1u)
+  {
+    result = 1u;
+  }
+  if (result > CHECKSUM_THREADS_MAX)
+  {
+    result = CHECKSUM_THREADS_MAX;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of GetProcessorCount ***/
+
+
 /*********************************** end of main.c *************************************/
 
 
@@ -60,6 +60,48 @@
  */
 #define RESULT_ERROR_FIRMWARE_SAVE          (3)
 
+/** \brief Maximum number of characters on an S-record line. The bytes count entry is
+ *         max 255 bytes, which results in 510 characters. Another 4 characters are
+ *         needed for the bytes count and line type and another two for possible line
+ *         termination.
+ */
+#define SREC_LINE_LEN_MAX                   (516u)
+
+/** \brief Maximum number of data bytes on an S-record line. */
+#define SREC_DATA_LEN_MAX                   (252u)
+
+/** \brief Number of data bytes on the S-record lines of the output file. It is the
+ *         same as when LibOpenBLT saves a firmware file.
+ */
+#define SREC_OUTPUT_DATA_LEN                (32u)
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Range of memory addresses with firmware data. */
+typedef struct
+{
+  uint64_t start;                /**< First address of the range.                      */
+  uint64_t end;                  /**< Address right after the range.                   */
+} tAddressRange;
+
+/** \brief Firmware file as specified on the command line. */
+typedef struct
+{
+  char const * fileStr;          /**< The filename of the firmware file.               */
+  FILE * fp;                     /**< File pointer, while the file is open.            */
+  bool sorted;                   /**< True if the data records have ascending and not  */
+                                 /**< overlapping addresses.                           */
+  tAddressRange * ranges;        /**< Sorted ranges with firmware data in the file.    */
+  uint32_t rangeCount;           /**< Number of entries in the ranges array.           */
+  uint32_t rangeCapacity;        /**< Number of entries the ranges array can hold.     */
+  bool recordValid;              /**< True if the current data record is valid.        */
+  uint32_t recordAddress;        /**< Base address of the current data record.         */
+  uint64_t recordEnd;            /**< Address right after the current data record.     */
+  uint8_t recordData[SREC_DATA_LEN_MAX]; /**< Data of the current data record.         */
+} tInputFile;
+
 
 /****************************************************************************************
 * Function prototypes
@@ -67,20 +109,49 @@
 static void DisplayProgramInfo(void);
 static void DisplayProgramUsage(void);
 static bool ParseCommandLine(int argc, char const * const argv[]);
+static bool ScanInputFile(tInputFile * input);
+static void ReportOverlaps(void);
+static bool MergeInputFiles(void);
+static bool ReadDataRecord(tInputFile * input, bool * checksumError);
+static bool AddAddressRange(tInputFile * input, uint64_t start, uint64_t end);
+static int CompareAddressRanges(void const * first, void const * second);
+static bool WriteOutputData(uint64_t address, uint8_t const * data, uint32_t len);
+static bool WriteRecord(char type, uint32_t address, uint8_t const * data, uint32_t len);
+static uint8_t HexStringToByte(char const * hexstring);
 
 
 /****************************************************************************************
 * Local data declarations
 ****************************************************************************************/
-/** \brief The filename of the first firmware file as specified on the command line. */
-static char const * input1FileStr;
+/** \brief The firmware files as specified on the command line, in the order in which
+ *         they are combined.
+ */
+static tInputFile * inputFiles;
 
-/** \brief The filename of the second firmware file as specified on the command line. */
-static char const * input2FileStr;
+/** \brief Number of entries in the inputFiles array. */
+static uint32_t inputFileCount;
 
 /** \brief The filename of the output firmware file as specified on the command line. */
 static char const * outputFileStr;
 
+/** \brief File pointer of the output file, while it is written. */
+static FILE * outputFp;
+
+/** \brief S-record type character of the data records in the output file. */
+static char outputDataType;
+
+/** \brief Data of the output record that is currently being assembled. */
+static uint8_t outputLineData[SREC_OUTPUT_DATA_LEN];
+
+/** \brief Base address of the output record that is currently being assembled. */
+static uint32_t outputLineAddress;
+
+/** \brief Number of bytes in the output record that is currently being assembled. */
+static uint32_t outputLineLen;
+
+/** \brief Address right after the last byte written to the output file. */
+static uint64_t outputNextAddress;
+
 
 /************************************************************************************//**
 ** \brief     This is the program entry point.
@@ -92,6 +163,7 @@ static char const * outputFileStr;
 int main(int argc, char const * const argv[])
 {
   int result = RESULT_OK;
+  bool inputsSorted = true;
 
   /* -------------------- Initialization --------------------------------------------- */
   /* Initialize the firmware data module using the S-record parser. */
@@ -99,8 +171,8 @@ int main(int argc, char const * const argv[])
 
   /* -------------------- Display info ----------------------------------------------- */
   /* Check that at least enough command line arguments were specified. The first one is
-   * always the name of the executable. Additionally, two firmware file must be 
-   * specified, followed by the output file.
+   * always the name of the executable. Additionally, at least two firmware files must
+   * be specified, followed by the output file.
    */
   if (!ParseCommandLine(argc, argv))
   {
@@ -114,37 +186,41 @@ int main(int argc, char const * const argv[])
     result = RESULT_ERROR_COMMANDLINE;
   }
 
-  /* -------------------- Firmware loading ------------------------------------------- */
-  /* Load the first input file. */
+  /* -------------------- Firmware scanning ------------------------------------------ */
+  /* Verify the input files and determine which address ranges they contain. */
   if (result == RESULT_OK)
   {
-    if (BltFirmwareLoadFromFile(input1FileStr, 0) != BLT_RESULT_OK)
+    for (uint32_t inputIdx = 0; inputIdx < inputFileCount; inputIdx++)
     {
-      /* Display error. */
-      printf("[ERROR] Could not load the first input file.\n");
-      /* Set error code. */
-      result = RESULT_ERROR_FIRMWARE_LOAD;
+      if (!ScanInputFile(&inputFiles[inputIdx]))
+      {
+        /* Display error. */
+        printf("[ERROR] Could not load the input file %s.\n",
+               inputFiles[inputIdx].fileStr);
+        /* Set error code. */
+        result = RESULT_ERROR_FIRMWARE_LOAD;
+        break;
+      }
+      if (!inputFiles[inputIdx].sorted)
+      {
+        inputsSorted = false;
+      }
     }
   }
-  /* Load the second input file. */
+  /* Report data that a later input file overwrites. */
   if (result == RESULT_OK)
   {
-    if (BltFirmwareLoadFromFile(input2FileStr, 0) != BLT_RESULT_OK)
-    {
-      /* Display error. */
-      printf("[ERROR] Could not load the second input file.\n");
-      /* Set error code. */
-      result = RESULT_ERROR_FIRMWARE_LOAD;
-    }
+    ReportOverlaps();
   }
 
-  /* -------------------- Firmware saving -------------------------------------------- */
-  /* Save the currently loaded firmware data of both input files into a new output
-   * file.
+  /* -------------------- Firmware combining ----------------------------------------- */
+  /* If the data records of all input files are sorted by address, the input files are
+   * merged while reading them, one data record of each file at a time. This way only a
+   * data record per input file and one output record are kept in memory.
    */
-  if (result == RESULT_OK)
+  if ( (result == RESULT_OK) && (inputsSorted) )
   {
-    if (BltFirmwareSaveToFile(outputFileStr) != BLT_RESULT_OK)
+    if (!MergeInputFiles())
     {
       /* Display error. */
       printf("[ERROR] Could not save output file.\n");
@@ -152,7 +228,50 @@ int main(int argc, char const * const argv[])
       result = RESULT_ERROR_FIRMWARE_SAVE;
     }
   }
+  /* Otherwise load the firmware data of all input files with the firmware data module
+   * and save the combined firmware data into a new output file.
+   */
+  else if (result == RESULT_OK)
+  {
+    for (uint32_t inputIdx = 0; inputIdx < inputFileCount; inputIdx++)
+    {
+      if (BltFirmwareLoadFromFile(inputFiles[inputIdx].fileStr, 0) != BLT_RESULT_OK)
+      {
+        /* Display error. */
+        printf("[ERROR] Could not load the input file %s.\n",
+               inputFiles[inputIdx].fileStr);
+        /* Set error code. */
+        result = RESULT_ERROR_FIRMWARE_LOAD;
+        break;
+      }
+    }
+    if (result == RESULT_OK)
+    {
+      if (BltFirmwareSaveToFile(outputFileStr) != BLT_RESULT_OK)
+      {
+        /* Display error. */
+        printf("[ERROR] Could not save output file.\n");
+        /* Set error code. */
+        result = RESULT_ERROR_FIRMWARE_SAVE;
+      }
+    }
+  }
+
   /* -------------------- Clean-up --------------------------------------------------- */
+  /* Close the input files and release the memory of the input file information. */
+  if (inputFiles != NULL)
+  {
+    for (uint32_t inputIdx = 0; inputIdx < inputFileCount; inputIdx++)
+    {
+      if (inputFiles[inputIdx].fp != NULL)
+      {
+        fclose(inputFiles[inputIdx].fp);
+      }
+      free(inputFiles[inputIdx].ranges);
+    }
+    free(inputFiles);
+    inputFiles = NULL;
+  }
   /* Terminate the firmware data module. */
   BltFirmwareTerminate();
   
@@ -168,7 +287,7 @@ int main(int argc, char const * const argv[])
 static void DisplayProgramInfo(void)
 {
   printf("--------------------------------------------------------------------------\n");
-  printf("FwCombine version 1.4.2 Combines two S-record files into one.\n");
+  printf("FwCombine version 1.5.0 Combines S-record files into one.\n");
   printf("Copyright (c) 2017 by Feaser  http://www.feaser.com\n");
   printf("-------------------------------------------------------------------------\n");
 } /*** end of DisplayProgramInfo ***/
@@ -180,10 +299,13 @@ static void DisplayProgramInfo(void)
 ****************************************************************************************/
 static void DisplayProgramUsage(void)
 {
-  printf("Usage:    FwCombine [input file 1] [input file 2] [output file]\n");
+  printf("Usage:    FwCombine [input file 1] [input file 2] ... [output file]\n");
   printf("\n");
   printf("Example:  FwCombine bootloader.srec userprog.srec combined.srec\n");
   printf("\n");
+  printf("Where input files overlap, the data of the later input file is used. The\n");
+  printf("overlapping address ranges are reported.\n");
+  printf("\n");
   printf("-------------------------------------------------------------------------\n");
 } /*** end of DisplayProgramUsage ***/
 
@@ -204,52 +326,661 @@ static bool ParseCommandLine(int argc, char const * const argv[])
   assert(argv != NULL);
 
   /* Reset the command line parameter storage variables. */
-  input1FileStr = NULL;
-  input2FileStr = NULL;
+  inputFiles = NULL;
+  inputFileCount = 0;
   outputFileStr = NULL;
 
-  /* Only continue if parameters are valid. Note that 4 command line parameters are
-   * expected. The first one if the name of this program's executable. After this the
-   * two input files are specified, followed by the output filename.
+  /* Only continue if parameters are valid. Note that at least 4 command line parameters
+   * are expected. The first one if the name of this program's executable. After this at
+   * least two input files are specified, followed by the output filename.
    */
-  if ( (argv != NULL) && (argc == 4) ) /*lint !e774 */
+  if ( (argv != NULL) && (argc >= 4) ) /*lint !e774 */
   {
-    /* Extract the first input file. It should not start with '-', as this is typically
-     * the start of a command line option. Additionally it must have a plausible
-     * length.
+    inputFiles = calloc((size_t)argc - 2u, sizeof(tInputFile));
+    if (inputFiles != NULL)
+    {
+      result = true;
+      /* Extract the input files and the output file. They should not start with '-',
+       * as this is typically the start of a command line option. Additionally they
+       * must have a plausible length.
+       */
+      for (int paramIdx = 1; paramIdx < argc; paramIdx++)
+      {
+        if ( (argv[paramIdx][0] == '-') || (strlen(argv[paramIdx]) <= 2) )
+        {
+          result = false;
+        }
+      }
+      if (result)
+      {
+        /* Store the pointers to the filenames. */
+        inputFileCount = (uint32_t)argc - 2u;
+        for (uint32_t inputIdx = 0; inputIdx < inputFileCount; inputIdx++)
+        {
+          inputFiles[inputIdx].fileStr = argv[inputIdx + 1u];
+        }
+        outputFileStr = argv[argc - 1];
+      }
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of ParseCommandLine ***/
+
+
+/************************************************************************************//**
+** \brief     Verifies that the input file is a valid S-record file with program data and
+**            determines the address ranges with firmware data in the file. It also
+**            determines if the data records are sorted by address. The file stays open,
+**            such that it can be merged afterwards.
+** \param     input The input file.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+static bool ScanInputFile(tInputFile * input)
+{
+  bool result = false;
+  bool checksumError = false;
+  uint64_t previousEnd = 0;
+  uint32_t rangeIdx;
+
+  /* Check parameters. */
+  assert(input != NULL);
+
+  /* Only continue if the parameters are valid. */
+  if (input != NULL) /*lint !e774 */
+  {
+    input->sorted = true;
+    input->rangeCount = 0;
+    /* Open the file for reading. */
+    input->fp = fopen(input->fileStr, "r");
+    /* Only continue if the filepointer is valid. */
+    if (input->fp != NULL)
+    {
+      result = true;
+      /* Read all data records. */
+      while (ReadDataRecord(input, &checksumError))
+      {
+        /* A data record below the end of the previous one means that the file is not
+         * sorted by address.
+         */
+        if (input->recordAddress < previousEnd)
+        {
+          input->sorted = false;
+        }
+        previousEnd = input->recordEnd;
+        if (!AddAddressRange(input, input->recordAddress, input->recordEnd))
+        {
+          result = false;
+          break;
+        }
+      }
+      /* The file must have valid checksums and contain program data. */
+      if ( (checksumError) || (input->rangeCount == 0) )
+      {
+        result = false;
+      }
+    }
+    /* The address ranges of an unsorted file are sorted afterwards. Ranges that overlap
+     * or that are adjacent are merged.
      */
-    if ( (argv[1][0] != '-') && (strlen(argv[1]) > 2) )
+    if ( (result) && (!input->sorted) )
+    {
+      qsort(input->ranges, input->rangeCount, sizeof(tAddressRange),
+            CompareAddressRanges);
+      rangeIdx = 0;
+      for (uint32_t idx = 1; idx < input->rangeCount; idx++)
+      {
+        if (input->ranges[idx].start <= input->ranges[rangeIdx].end)
+        {
+          if (input->ranges[idx].end > input->ranges[rangeIdx].end)
+          {
+            input->ranges[rangeIdx].end = input->ranges[idx].end;
+          }
+        }
+        else
+        {
+          rangeIdx++;
+          input->ranges[rangeIdx] = input->ranges[idx];
+        }
+      }
+      input->rangeCount = rangeIdx + 1u;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of ScanInputFile ***/
+
+
+/************************************************************************************//**
+** \brief     Reports the address ranges where the firmware data of two input files
+**            overlaps. In these ranges, the data of the later input file is used.
+**
+****************************************************************************************/
+static void ReportOverlaps(void)
+{
+  tInputFile const * first;
+  tInputFile const * second;
+  uint32_t firstIdx;
+  uint32_t secondIdx;
+  uint64_t start;
+  uint64_t end;
+
+  /* Compare each pair of input files. */
+  for (uint32_t idx1 = 0; idx1 < inputFileCount; idx1++)
+  {
+    for (uint32_t idx2 = idx1 + 1u; idx2 < inputFileCount; idx2++)
+    {
+      first = &inputFiles[idx1];
+      second = &inputFiles[idx2];
+      firstIdx = 0;
+      secondIdx = 0;
+      /* Walk through the sorted address ranges of both files at the same time. */
+      while ( (firstIdx < first->rangeCount) && (secondIdx < second->rangeCount) )
+      {
+        start = first->ranges[firstIdx].start;
+        if (second->ranges[secondIdx].start > start)
+        {
+          start = second->ranges[secondIdx].start;
+        }
+        end = first->ranges[firstIdx].end;
+        if (second->ranges[secondIdx].end < end)
+        {
+          end = second->ranges[secondIdx].end;
+        }
+        if (start < end)
+        {
+          printf("[WARNING] Data of %s and %s overlaps at %08X-%08X.\n",
+                 first->fileStr, second->fileStr, (uint32_t)start, (uint32_t)(end - 1u));
+        }
+        /* Continue with the range that ends first. */
+        if (first->ranges[firstIdx].end < second->ranges[secondIdx].end)
+        {
+          firstIdx++;
+        }
+        else
+        {
+          secondIdx++;
+        }
+      }
+    }
+  }
+} /*** end of ReportOverlaps ***/
+
+
+/************************************************************************************//**
+** \brief     Merges the input files into the output file in one pass. Each input file
+**            must be sorted by address. The merge repeatedly takes the lowest address
+**            that one of the current data records of the input files holds. The data
+**            from there is taken from the last input file that has data at that
+**            address, up to where its data record ends or where a later input file
+**            takes over. The output file is the same as when the input files would be
+**            loaded and saved with the firmware data module.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+static bool MergeInputFiles(void)
+{
+  bool result = false;
+  bool checksumError = false;
+  uint64_t lowestAddress = UINT64_MAX;
+  uint64_t highestAddress = 0;
+  uint64_t address = 0;
+  uint64_t mergeAddress;
+  uint64_t mergeEnd;
+  tInputFile * winner;
+  char terminationType = '9';
+  char const * filenamePtr;
+  uint32_t filenameLen;
+
+  /* Determine the lowest and the highest memory address of the program data. The
+   * lowest address is specified in the termination record. The highest address
+   * determines the number of bits needed for the address in the data records (16, 24
+   * or 32), which determines the type of the data records and the termination record.
+   */
+  for (uint32_t inputIdx = 0; inputIdx < inputFileCount; inputIdx++)
+  {
+    tInputFile const * input = &inputFiles[inputIdx];
+    if (input->ranges[0].start < lowestAddress)
+    {
+      lowestAddress = input->ranges[0].start;
+    }
+    if ((input->ranges[input->rangeCount - 1u].end - 1u) > highestAddress)
+    {
+      highestAddress = input->ranges[input->rangeCount - 1u].end - 1u;
+    }
+  }
+  outputDataType = '1';
+  if (highestAddress > 0xffffff)
+  {
+    outputDataType = '3';
+    terminationType = '7';
+  }
+  else if (highestAddress > 0xffff)
+  {
+    outputDataType = '2';
+    terminationType = '8';
+  }
+  outputLineLen = 0;
+  outputNextAddress = 0;
+
+  /* Open the output file for writing. */
+  outputFp = fopen(outputFileStr, "w");
+  if (outputFp != NULL)
+  {
+    /* Add the S0-record with just the filename, so without its path. */
+    filenamePtr = strrchr(outputFileStr, '/');
+    if (filenamePtr == NULL)
+    {
+      filenamePtr = strrchr(outputFileStr, '\\');
+    }
+    filenamePtr = (filenamePtr != NULL) ? (filenamePtr + 1) : outputFileStr;
+    filenameLen = (uint32_t)strlen(filenamePtr);
+    if (filenameLen > SREC_DATA_LEN_MAX)
+    {
+      filenameLen = SREC_DATA_LEN_MAX;
+    }
+    result = WriteRecord('0', 0, (uint8_t const *)filenamePtr, filenameLen);
+    /* Read the first data record of each input file. */
+    for (uint32_t inputIdx = 0; inputIdx < inputFileCount; inputIdx++)
+    {
+      rewind(inputFiles[inputIdx].fp);
+      (void)ReadDataRecord(&inputFiles[inputIdx], &checksumError);
+    }
+    while (result)
+    {
+      /* Skip the data records that were already written. Note that a data record can
+       * also be partially written.
+       */
+      mergeAddress = UINT64_MAX;
+      for (uint32_t inputIdx = 0; inputIdx < inputFileCount; inputIdx++)
+      {
+        tInputFile * input = &inputFiles[inputIdx];
+        while ( (input->recordValid) && (input->recordEnd <= address) )
+        {
+          (void)ReadDataRecord(input, &checksumError);
+        }
+        /* Determine the lowest address with data that was not yet written. */
+        if (input->recordValid)
+        {
+          uint64_t recordAddress = input->recordAddress;
+          if (recordAddress < address)
+          {
+            recordAddress = address;
+          }
+          if (recordAddress < mergeAddress)
+          {
+            mergeAddress = recordAddress;
+          }
+        }
+      }
+      /* Done when all input files are read. */
+      if (mergeAddress == UINT64_MAX)
+      {
+        break;
+      }
+      /* Find the last input file with data at this address. The data is taken from
+       * it, until its data record ends or a later input file has data.
+       */
+      winner = NULL;
+      mergeEnd = UINT64_MAX;
+      for (uint32_t inputIdx = inputFileCount; inputIdx > 0; inputIdx--)
+      {
+        tInputFile * input = &inputFiles[inputIdx - 1u];
+        if (input->recordValid)
+        {
+          if (input->recordAddress <= mergeAddress)
+          {
+            winner = input;
+            break;
+          }
+          if (input->recordAddress < mergeEnd)
+          {
+            mergeEnd = input->recordAddress;
+          }
+        }
+      }
+      assert(winner != NULL);
+      if (winner->recordEnd < mergeEnd)
+      {
+        mergeEnd = winner->recordEnd;
+      }
+      result = WriteOutputData(mergeAddress,
+                               &winner->recordData[mergeAddress - winner->recordAddress],
+                               (uint32_t)(mergeEnd - mergeAddress));
+      address = mergeEnd;
+    }
+    /* Write the last data record and the termination record. */
+    if ( (result) && (outputLineLen > 0) )
+    {
+      result = WriteRecord(outputDataType, outputLineAddress, outputLineData,
+                           outputLineLen);
+    }
+    if (result)
     {
-      /* Store the pointer to the filename. */
-      input1FileStr = argv[1];
+      result = WriteRecord(terminationType, (uint32_t)lowestAddress, NULL, 0);
     }
-    /* Extract the second input file. It should not start with '-', as this is typically
-     * the start of a command line option. Additionally it must have a plausible
-     * length.
+    /* Close the file now that we are done with it. */
+    if (fclose(outputFp) != 0)
+    {
+      result = false;
+    }
+    outputFp = NULL;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of MergeInputFiles ***/
+
+
+/************************************************************************************//**
+** \brief     Reads the next data record with program data from the input file. Lines
+**            that do not contain program data are skipped.
+** \param     input The input file.
+** \param     checksumError Set to true if a data record with an invalid checksum was
+**            found. Reading stops at that record.
+** \return    True if a data record was read, false at the end of the file or in case of
+**            an error.
+**
+****************************************************************************************/
+static bool ReadDataRecord(tInputFile * input, bool * checksumError)
+{
+  /* Note that this array was made static to lower the stack load. */
+  static char line[SREC_LINE_LEN_MAX];
+  uint32_t addressBytes;
+  uint32_t byteCount;
+  uint8_t checksum;
+
+  /* Check parameters. */
+  assert(input != NULL);
+  assert(checksumError != NULL);
+
+  input->recordValid = false;
+  while ( (!input->recordValid) &&
+          (fgets(line, sizeof(line)/sizeof(line[0]), input->fp) != NULL) )
+  {
+    /* Replace the line termination with a string termination. */
+    line[strcspn(line, "\n\r")] = '\0';
+    /* We are only interested in S1, S2 and S3 lines that contain program data. */
+    if ( ((line[0] != 'S') && (line[0] != 's')) || (line[1] < '1') || (line[1] > '3') )
+    {
+      continue;
+    }
+    /* The S1, S2 and S3 lines have a 16, 24 and 32-bit address respectively. The line
+     * must hold the number of bytes that the byte count specifies, which includes the
+     * address and the checksum.
      */
-    if ( (argv[2][0] != '-') && (strlen(argv[2]) > 2) )
+    addressBytes = (uint32_t)(line[1] - '0') + 1u;
+    byteCount = HexStringToByte(&line[2]);
+    if ( (byteCount < (addressBytes + 1u)) || (strlen(line) < (4u + (byteCount * 2u))) )
     {
-      /* Store the pointer to the filename. */
-      input2FileStr = argv[2];
+      *checksumError = true;
+      break;
     }
-    /* Extract the output file. It should not start with '-', as this is typically
-     * the start of a command line option. Additionally it must have a plausible
-     * length.
+    /* Verify the checksum, which is the 1-complement of the sum of the byte count, the
+     * address and the data bytes.
      */
-    if ( (argv[3][0] != '-') && (strlen(argv[3]) > 2) )
+    checksum = (uint8_t)byteCount;
+    input->recordAddress = 0;
+    for (uint32_t idx = 0; idx < (byteCount - 1u); idx++)
     {
-      /* Store the pointer to the filename. */
-      outputFileStr = argv[3];
+      uint8_t byteValue = HexStringToByte(&line[4u + (idx * 2u)]);
+      checksum += byteValue;
+      if (idx < addressBytes)
+      {
+        input->recordAddress = (input->recordAddress << 8) | byteValue;
+      }
+      else
+      {
+        input->recordData[idx - addressBytes] = byteValue;
+      }
     }
-    /* Validate the result. */
-    if ( (input1FileStr != NULL) && (input2FileStr != NULL) && (outputFileStr != NULL) )
+    checksum = (uint8_t)~checksum;
+    if (checksum != HexStringToByte(&line[4u + ((byteCount - 1u) * 2u)]))
     {
-      result = true;
+      *checksumError = true;
+      break;
+    }
+    /* Only lines that actually hold data bytes count as a data record. */
+    input->recordEnd = (uint64_t)input->recordAddress + (byteCount - addressBytes - 1u);
+    input->recordValid = (input->recordEnd > input->recordAddress);
+  }
+  /* Give the result back to the caller. */
+  return input->recordValid;
+} /*** end of ReadDataRecord ***/
+
+
+/************************************************************************************//**
+** \brief     Adds an address range to the address ranges of the input file. It is
+**            merged with the last range if it directly follows it.
+** \param     input The input file.
+** \param     start First address of the range.
+** \param     end Address right after the range.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+static bool AddAddressRange(tInputFile * input, uint64_t start, uint64_t end)
+{
+  bool result = true;
+
+  /* Check parameters. */
+  assert(input != NULL);
+
+  /* Extend the last range if the new range directly follows it. */
+  if ( (input->rangeCount > 0) && (input->ranges[input->rangeCount - 1u].end == start) )
+  {
+    input->ranges[input->rangeCount - 1u].end = end;
+  }
+  else
+  {
+    /* Grow the array if it is full. */
+    if (input->rangeCount == input->rangeCapacity)
+    {
+      uint32_t newCapacity = (input->rangeCapacity == 0) ? 16u :
+                             (input->rangeCapacity * 2u);
+      tAddressRange * newRanges;
+      newRanges = realloc(input->ranges, newCapacity * sizeof(tAddressRange));
+      if (newRanges == NULL)
+      {
+        result = false;
+      }
+      else
+      {
+        input->ranges = newRanges;
+        input->rangeCapacity = newCapacity;
+      }
+    }
+    /* Add the new range. */
+    if (result)
+    {
+      input->ranges[input->rangeCount].start = start;
+      input->ranges[input->rangeCount].end = end;
+      input->rangeCount++;
     }
   }
   /* Give the result back to the caller. */
   return result;
-} /*** end of ParseCommandLine ***/
+} /*** end of AddAddressRange ***/
+
+
+/************************************************************************************//**
+** \brief     Compares two address ranges by their first address, for qsort.
+** \param     first Pointer to the first address range.
+** \param     second Pointer to the second address range.
+** \return    Negative, zero or positive if the first range starts before, at or after
+**            the second range.
+**
+****************************************************************************************/
+static int CompareAddressRanges(void const * first, void const * second)
+{
+  uint64_t firstStart = ((tAddressRange const *)first)->start;
+  uint64_t secondStart = ((tAddressRange const *)second)->start;
+
+  return (firstStart > secondStart) - (firstStart < secondStart);
+} /*** end of CompareAddressRanges ***/
+
+
+/************************************************************************************//**
+** \brief     Writes firmware data to the output file. The data records are assembled
+**            such that each contiguous run of firmware data is split into records of
+**            SREC_OUTPUT_DATA_LEN bytes, starting at the beginning of the run.
+** \param     address Base address of the firmware data.
+** \param     data Pointer to the firmware data.
+** \param     len Number of bytes.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+static bool WriteOutputData(uint64_t address, uint8_t const * data, uint32_t len)
+{
+  bool result = true;
+  uint32_t copyLen;
+
+  /* Check parameters. */
+  assert(data != NULL);
+
+  /* A gap in the firmware data ends the record that is being assembled. */
+  if ( (outputLineLen > 0) && (address != outputNextAddress) )
+  {
+    result = WriteRecord(outputDataType, outputLineAddress, outputLineData,
+                         outputLineLen);
+    outputLineLen = 0;
+  }
+  while ( (result) && (len > 0) )
+  {
+    /* Start a new record if needed. */
+    if (outputLineLen == 0)
+    {
+      outputLineAddress = (uint32_t)address;
+    }
+    /* Copy as many bytes as fit in the record. */
+    copyLen = SREC_OUTPUT_DATA_LEN - outputLineLen;
+    if (len < copyLen)
+    {
+      copyLen = len;
+    }
+    memcpy(&outputLineData[outputLineLen], data, copyLen);
+    outputLineLen += copyLen;
+    address += copyLen;
+    data += copyLen;
+    len -= copyLen;
+    /* Write the record once it is full. */
+    if (outputLineLen == SREC_OUTPUT_DATA_LEN)
+    {
+      result = WriteRecord(outputDataType, outputLineAddress, outputLineData,
+                           outputLineLen);
+      outputLineLen = 0;
+    }
+  }
+  outputNextAddress = address;
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of WriteOutputData ***/
+
+
+/************************************************************************************//**
+** \brief     Writes an S-record line to the output file. The checksum at the end of the
+**            line is calculated and added.
+** \param     type The S-record type character, '0' up to '9'.
+** \param     address The address to embed into the line after the byte count.
+** \param     data Point to byte array with data bytes to add to the line.
+** \param     len The number of data bytes present in the data-array.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+static bool WriteRecord(char type, uint32_t address, uint8_t const * data, uint32_t len)
+{
+  /* Note that this array was made static to lower the stack load. */
+  static char line[SREC_LINE_LEN_MAX];
+  static char const hexDigits[] = "0123456789ABCDEF";
+  uint8_t bytes[SREC_DATA_LEN_MAX + 6u];
+  uint32_t addressBytes = 2u;
+  uint32_t byteCount;
+  uint8_t checksum = 0;
+  uint32_t pos = 0;
+
+  /* Check parameters. */
+  assert(len <= SREC_DATA_LEN_MAX);
+  assert((len == 0) || (data != NULL));
+
+  /* Determine the size of the address. */
+  if ( (type == '2') || (type == '8') )
+  {
+    addressBytes = 3u;
+  }
+  else if ( (type == '3') || (type == '7') )
+  {
+    addressBytes = 4u;
+  }
+  /* Collect the byte count, the address and the data bytes. */
+  byteCount = addressBytes + len + 1u;
+  bytes[pos++] = (uint8_t)byteCount;
+  for (uint32_t cnt = addressBytes; cnt > 0; cnt--)
+  {
+    bytes[pos++] = (uint8_t)(address >> ((cnt - 1u) * 8u));
+  }
+  if (len > 0)
+  {
+    memcpy(&bytes[pos], data, len);
+    pos += len;
+  }
+  /* Add the checksum, which is the 1-complement of the sum of the other bytes. */
+  for (uint32_t idx = 0; idx < pos; idx++)
+  {
+    checksum += bytes[idx];
+  }
+  bytes[pos++] = (uint8_t)~checksum;
+  /* Construct the line. */
+  line[0] = 'S';
+  line[1] = type;
+  for (uint32_t idx = 0; idx < pos; idx++)
+  {
+    line[2u + (idx * 2u)] = hexDigits[bytes[idx] >> 4];
+    line[3u + (idx * 2u)] = hexDigits[bytes[idx] & 0x0f];
+  }
+  line[2u + (pos * 2u)] = '\n';
+  line[3u + (pos * 2u)] = '\0';
+  /* Give the result back to the caller. */
+  return (fputs(line, outputFp) >= 0);
+} /*** end of WriteRecord ***/
+
+
+/************************************************************************************//**
+** \brief     Helper function to convert a sequence of 2 characters that represent
+**            a hexadecimal value to the actual byte value.
+**              Example: HexStringToByte("2f")  --> returns 47.
+** \param     hexstring String beginning with 2 characters that represent a hexa-
+**            decimal value.
+** \return    The resulting byte value.
+**
+****************************************************************************************/
+static uint8_t HexStringToByte(char const * hexstring)
+{
+  uint8_t result = 0;
+  char c;
+
+  /* Check parameters. */
+  assert(hexstring != NULL);
+
+  /* A hexadecimal character is 2 characters long (i.e 0x4F minus the 0x part). */
+  for (uint8_t counter = 0; counter < 2u; counter++)
+  {
+    c = hexstring[counter];
+    /* Convert the character to its 4-bit value. Other characters count as zero. */
+    if ( (c >= '0') && (c <= '9') )
+    {
+      result = (uint8_t)((result << 4u) + (uint8_t)(c - '0'));
+    }
+    else if ( (c >= 'A') && (c <= 'F') )
+    {
+      result = (uint8_t)((result << 4u) + (uint8_t)(c - 'A' + 10));
+    }
+    else if ( (c >= 'a') && (c <= 'f') )
+    {
+      result = (uint8_t)((result << 4u) + (uint8_t)(c - 'a' + 10));
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of HexStringToByte ***/
 
 
 /*********************************** end of main.c *************************************/
@@ -36,6 +36,12 @@
 #include <stdlib.h>                         /* for standard library                    */
 #include <stdio.h>                          /* Standard I/O functions.                 */
 #include <string.h>                         /* for string library                      */
+#if defined(PLATFORM_WINDOWS)
+#include <windows.h>                        /* for threads                             */
+#else
+#include <pthread.h>                        /* for threads                             */
+#include <unistd.h>                         /* for sysconf                             */
+#endif
 #include "openblt.h"                        /* OpenBLT host library.                   */
 
 
@@ -75,6 +81,26 @@
  */
 #define RESULT_ERROR_FIRMWARE_SAVE          (6)
 
+/** \brief Maximum number of bytes that a worker thread en/decrypts at a time. Larger
+ *         parts of a segment are split into slices of this size, such that the worker
+ *         threads process them in parallel. It is a multiple of the AES block size.
+ */
+#define CRYPTO_SLICE_SIZE                   (65536u)
+
+/** \brief Maximum number of worker threads. */
+#define CRYPTO_THREADS_MAX                  (64u)
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Part of a firmware data segment that is en/decrypted as a whole. */
+typedef struct
+{
+  uint8_t * data;                /**< Pointer to the data of the slice.                */
+  uint32_t len;                  /**< Number of bytes, a multiple of 16.               */
+} tCryptoSlice;
+
 
 /****************************************************************************************
 * Function prototypes
@@ -83,6 +109,17 @@ static void DisplayProgramInfo(void);
 static void DisplayProgramUsage(void);
 static bool ParseCommandLine(int argc, char const * const argv[]);
 static bool ExtractCryptoKeyFromFile(char const * cryptoKeyFile, uint8_t * cryptoKey);
+static bool AddCryptoSlices(uint8_t * data, uint32_t len);
+static bool ProcessCryptoSlices(tBltAes256Handle crypto);
+static void CryptoWorker(void);
+#if defined(PLATFORM_WINDOWS)
+static DWORD WINAPI CryptoThreadEntry(LPVOID param);
+#else
+static void * CryptoThreadEntry(void * param);
+#endif
+static void CryptoLock(void);
+static void CryptoUnlock(void);
+static uint32_t GetProcessorCount(void);
 
 
 /****************************************************************************************
@@ -115,6 +152,34 @@ static char const * inputFileStr;
 /** \brief The filename of the output firmware file as specified on the command line. */
 static char const * outputFileStr;
 
+/** \brief Number of worker threads that en/decrypt the firmware data. */
+static uint32_t cryptoThreadCount;
+
+/** \brief Array with the slices of firmware data to en/decrypt. */
+static tCryptoSlice * cryptoSlices;
+
+/** \brief Number of slices in the cryptoSlices array. */
+static uint32_t cryptoSliceCount;
+
+/** \brief Number of slices that the cryptoSlices array can hold. */
+static uint32_t cryptoSliceCapacity;
+
+/** \brief Index of the next slice that a worker thread takes from the array. */
+static uint32_t cryptoSliceNext;
+
+/** \brief Flag that a worker thread sets when it could not process a slice. */
+static bool cryptoFailed;
+
+/** \brief The cryptography context that the worker threads share. */
+static tBltAes256Handle cryptoContext;
+
+/** \brief Lock for the slice index and the error flag, shared by the worker threads. */
+#if defined(PLATFORM_WINDOWS)
+static CRITICAL_SECTION cryptoLock;
+#else
+static pthread_mutex_t cryptoLock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
 
 /************************************************************************************//**
 ** \brief     This is the program entry point.
@@ -355,10 +420,26 @@ int main(int argc, char const * const argv[])
   }
 
   /* -------------------- Perform cryptography --------------------------------------- */
+  /* The key is expanded only once, in a cryptography context that all worker threads
+   * share. The segments are split into slices that leave out the region to exclude.
+   * Large slices are split further, such that the worker threads en/decrypt them in
+   * parallel.
+   */
   if (result == RESULT_OK)
   {
+    tBltAes256Handle crypto = BltUtilCryptoAes256Create(cryptoKey);
+    if (crypto == NULL)
+    {
+      /* Set error code. */
+      result = RESULT_ERROR_CRYPTO_OPERATION;
+    }
     for (uint32_t segmentIdx = 0; segmentIdx < BltFirmwareGetSegmentCount(); segmentIdx++)
     {
+      /* Stop looping if an error was detected. */
+      if (result != RESULT_OK)
+      {
+        break;
+      }
       /* Obtain segment info. */
       uint32_t segmentAddress;
       uint32_t segmentLen;
@@ -371,62 +452,63 @@ int main(int argc, char const * const argv[])
         /* Stop looping because an error was detected. */
         break;
       }
-      /* Only continue if is no error was detected. */
-      if (result == RESULT_OK)
+      /* Determine the range of blocks that lie entirely within the region to exclude.
+       * By default the range is empty.
+       */
+      uint32_t blockCount = segmentLen / 16u;
+      uint32_t excludeFirst = blockCount;
+      uint32_t excludeEnd = blockCount;
+      if (excludeRegion)
       {
-        /* Perform cryptography operation in blocks of 16 bytes. Not really needed from
-         * a LibOpenBLT API perspective, but this makes it easier to exclude a region.
-         */
-        uint32_t blockBaseAddress = segmentAddress;
-        for (uint32_t i = 0; i < (segmentLen / 16u); i++)
+        uint64_t regionStart = excludeRegionBaseAddr;
+        uint64_t regionEnd = regionStart + excludeRegionLen;
+        uint64_t first = 0;
+        uint64_t end = 0;
+        if (regionStart > segmentAddress)
         {
-          bool blockExcluded = false;
-          /* Was an exclusion region specified? */
-          if (excludeRegion)
-          {
-            /* Is this block excluded? */
-            if ( (blockBaseAddress >= excludeRegionBaseAddr) &&
-                 ((blockBaseAddress + 16u) <= (excludeRegionBaseAddr + excludeRegionLen)) )
-            {
-              /* This block should be excluded. */
-              blockExcluded = true;
-            }
-          }
-          /* Only perform the cryptography operation if the block is not part of the
-           * region that was requested to be excluded.
-           */
-          if (!blockExcluded)
-          {
-            /* Should the firmware data be encrypted? */
-            if (encryptOperation)
-            {
-              if (BltUtilCryptoAes256Encrypt(&segmentData[i * 16u], 16, cryptoKey) !=
-                    BLT_RESULT_OK)
-              {
-                /* Set error code. */
-                result = RESULT_ERROR_CRYPTO_OPERATION;
-                /* Stop looping because an error was detected. */
-                break;
-              }
-            }
-            /* Firmware data should be decrypted. */
-            else
-            {
-              if (BltUtilCryptoAes256Decrypt(&segmentData[i * 16u], 16, cryptoKey) !=
-                    BLT_RESULT_OK)
-              {
-                /* Set error code. */
-                result = RESULT_ERROR_CRYPTO_OPERATION;
-                /* Stop looping because an error was detected. */
-                break;
-              }
-            }
-          }
-          /* Update the block base address for the next iteration. */
-          blockBaseAddress += 16u;
+          first = ((regionStart - segmentAddress) + 15u) / 16u;
+        }
+        if (regionEnd > segmentAddress)
+        {
+          end = (regionEnd - segmentAddress) / 16u;
+        }
+        if (end > blockCount)
+        {
+          end = blockCount;
+        }
+        if (first < end)
+        {
+          excludeFirst = (uint32_t)first;
+          excludeEnd = (uint32_t)end;
         }
       }
+      /* Add the blocks before and after the excluded range. */
+      if ( (!AddCryptoSlices(segmentData, excludeFirst * 16u)) ||
+           (!AddCryptoSlices(&segmentData[excludeEnd * 16u],
+                             (blockCount - excludeEnd) * 16u)) )
+      {
+        /* Set error code. */
+        result = RESULT_ERROR_CRYPTO_OPERATION;
+      }
     }
+    /* En/decrypt all slices. */
+    if (result == RESULT_OK)
+    {
+      if (!ProcessCryptoSlices(crypto))
+      {
+        /* Set error code. */
+        result = RESULT_ERROR_CRYPTO_OPERATION;
+      }
+    }
+    /* Release the cryptography context and the slices. */
+    if (crypto != NULL)
+    {
+      BltUtilCryptoAes256Destroy(crypto);
+    }
+    free(cryptoSlices);
+    cryptoSlices = NULL;
+    cryptoSliceCount = 0;
+    cryptoSliceCapacity = 0;
   }
 
   /* -------------------- Firmware saving -------------------------------------------- */
@@ -492,6 +574,9 @@ static void DisplayProgramUsage(void)
   printf("                     32-bit hexadecimal values e.g. -x=08000000:08000FFF.\n");
   printf("                     Note that both the address and total size of the\n");
   printf("                     range must be 16-byte aligned.\n");
+  printf("  -j=[value]         Number of threads that en/decrypt the program data in\n");
+  printf("                     parallel, as a decimal value (Default=number of\n");
+  printf("                     processors).\n");
   printf("\n");
   printf("Note that it is not necessary to specify an option if its default value\n");
   printf("is already the desired value.\n");
@@ -523,6 +608,7 @@ static bool ParseCommandLine(int argc, char const * const argv[])
   excludeRegionLen = 0;
   inputFileStr = NULL;
   outputFileStr = NULL;
+  cryptoThreadCount = GetProcessorCount();
 
   /* Only continue with valid parameters. Note that at least 4 command line arguments
    * are specified. The first one is always the name of the executable. Additionally,
@@ -580,6 +666,25 @@ static bool ParseCommandLine(int argc, char const * const argv[])
         /* Continue with next loop iteration. */
         continue;
       }
+      /* Is this the -j=[value] parameter? */
+      if ( (strstr(argv[paramIdx], "-j=") != NULL) &&
+           (strlen(argv[paramIdx]) > 3) )
+      {
+        /* Extract the number of worker threads and keep it within its limits. */
+        uint32_t threadCount = 0;
+        sscanf(&argv[paramIdx][3], "%u", &threadCount);
+        if (threadCount < 1u)
+        {
+          threadCount = 1u;
+        }
+        if (threadCount > CRYPTO_THREADS_MAX)
+        {
+          threadCount = CRYPTO_THREADS_MAX;
+        }
+        cryptoThreadCount = threadCount;
+        /* Continue with next loop iteration. */
+        continue;
+      }
     }
     /* Store the pointer to the filename of the s-record input file. */
     inputFileStr = &argv[argc - 2][0];
@@ -679,6 +784,261 @@ static bool ExtractCryptoKeyFromFile(char const * cryptoKeyFile, uint8_t * crypt
 } /*** end of ExtractCryptoKeyFromFile ***/
 
 
+/************************************************************************************//**
+** \brief     Adds the specified firmware data to the slices that are to be en/decrypted.
+**            The data is split into slices of at most CRYPTO_SLICE_SIZE bytes.
+** \param     data Pointer to the firmware data.
+** \param     len The number of bytes. It must be a multiple of 16. Nothing is added if
+**            it is zero.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+static bool AddCryptoSlices(uint8_t * data, uint32_t len)
+{
+  bool result = true;
+
+  /* Check parameters. */
+  assert(data != NULL);
+  assert((len % 16u) == 0);
+
+  while (len > 0)
+  {
+    /* Grow the array if it is full. */
+    if (cryptoSliceCount == cryptoSliceCapacity)
+    {
+      uint32_t newCapacity = (cryptoSliceCapacity == 0) ? 16u :
+                             (cryptoSliceCapacity * 2u);
+      tCryptoSlice * newSlices;
+      newSlices = realloc(cryptoSlices, newCapacity * sizeof(tCryptoSlice));
+      if (newSlices == NULL)
+      {
+        result = false;
+        break;
+      }
+      cryptoSlices = newSlices;
+      cryptoSliceCapacity = newCapacity;
+    }
+    /* Add the next slice. */
+    uint32_t sliceLen = (len > CRYPTO_SLICE_SIZE) ? CRYPTO_SLICE_SIZE : len;
+    cryptoSlices[cryptoSliceCount].data = data;
+    cryptoSlices[cryptoSliceCount].len = sliceLen;
+    data += sliceLen;
+    len -= sliceLen;
+    cryptoSliceCount++;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of AddCryptoSlices ***/
+
+
+/************************************************************************************//**
+** \brief     En/decrypts all slices with a pool of worker threads. Each worker thread
+**            takes the next slice, until all slices are processed. The program's main
+**            thread is one of the worker threads. No more threads are started than
+**            there are slices, so small firmware files are processed without starting
+**            any additional threads.
+** \param     crypto Handle of the cryptography context.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+static bool ProcessCryptoSlices(tBltAes256Handle crypto)
+{
+  uint32_t threadCount = cryptoThreadCount;
+  uint32_t threadsStarted = 0;
+#if defined(PLATFORM_WINDOWS)
+  HANDLE threads[CRYPTO_THREADS_MAX];
+#else
+  pthread_t threads[CRYPTO_THREADS_MAX];
+#endif
+
+  /* Check parameters. */
+  assert(crypto != NULL);
+
+  /* Initialize the shared state of the worker threads. */
+  cryptoContext = crypto;
+  cryptoSliceNext = 0;
+  cryptoFailed = false;
+#if defined(PLATFORM_WINDOWS)
+  InitializeCriticalSection(&cryptoLock);
+#endif
+  if (threadCount > cryptoSliceCount)
+  {
+    threadCount = cryptoSliceCount;
+  }
+  /* Start the additional worker threads. If a thread cannot be started, the ones that
+   * did start simply take more slices.
+   */
+  for (uint32_t idx = 1; idx < threadCount; idx++)
+  {
+#if defined(PLATFORM_WINDOWS)
+    threads[threadsStarted] = CreateThread(NULL, 0, CryptoThreadEntry, NULL, 0, NULL);
+    if (threads[threadsStarted] == NULL)
+    {
+      break;
+    }
+#else
+    if (pthread_create(&threads[threadsStarted], NULL, CryptoThreadEntry, NULL) != 0)
+    {
+      break;
+    }
+#endif
+    threadsStarted++;
+  }
+  /* The main thread works along and then waits for the other threads to finish. */
+  CryptoWorker();
+  for (uint32_t idx = 0; idx < threadsStarted; idx++)
+  {
+#if defined(PLATFORM_WINDOWS)
+    (void)WaitForSingleObject(threads[idx], INFINITE);
+    (void)CloseHandle(threads[idx]);
+#else
+    (void)pthread_join(threads[idx], NULL);
+#endif
+  }
+#if defined(PLATFORM_WINDOWS)
+  DeleteCriticalSection(&cryptoLock);
+#endif
+  /* Give the result back to the caller. */
+  return !cryptoFailed;
+} /*** end of ProcessCryptoSlices ***/
+
+
+/************************************************************************************//**
+** \brief     Takes slices and en/decrypts them, until no slices are left or a slice
+**            could not be processed.
+**
+****************************************************************************************/
+static void CryptoWorker(void)
+{
+  uint32_t sliceIdx;
+  uint32_t sliceResult;
+
+  for (;;)
+  {
+    /* Take the next slice. */
+    CryptoLock();
+    sliceIdx = cryptoSliceNext;
+    if ( (sliceIdx < cryptoSliceCount) && (!cryptoFailed) )
+    {
+      cryptoSliceNext++;
+    }
+    else
+    {
+      sliceIdx = cryptoSliceCount;
+    }
+    CryptoUnlock();
+    /* Stop when there are no more slices to process. */
+    if (sliceIdx >= cryptoSliceCount)
+    {
+      break;
+    }
+    /* En/decrypt the slice as a whole. */
+    if (encryptOperation)
+    {
+      sliceResult = BltUtilCryptoAes256HandleEncrypt(cryptoContext,
+                                                     cryptoSlices[sliceIdx].data,
+                                                     cryptoSlices[sliceIdx].len);
+    }
+    else
+    {
+      sliceResult = BltUtilCryptoAes256HandleDecrypt(cryptoContext,
+                                                     cryptoSlices[sliceIdx].data,
+                                                     cryptoSlices[sliceIdx].len);
+    }
+    if (sliceResult != BLT_RESULT_OK)
+    {
+      CryptoLock();
+      cryptoFailed = true;
+      CryptoUnlock();
+    }
+  }
+} /*** end of CryptoWorker ***/
+
+
+/************************************************************************************//**
+** \brief     Entry point of an additional worker thread.
+** \param     param Not used.
+** \return    Always zero.
+**
+****************************************************************************************/
+#if defined(PLATFORM_WINDOWS)
+static DWORD WINAPI CryptoThreadEntry(LPVOID param)
+{
+  (void)param;
+  CryptoWorker();
+  return 0;
+} /*** end of CryptoThreadEntry ***/
+#else
+static void * CryptoThreadEntry(void * param)
+{
+  (void)param;
+  CryptoWorker();
+  return NULL;
+} /*** end of CryptoThreadEntry ***/
+#endif
+
+
+/************************************************************************************//**
+** \brief     Obtains the lock that the worker threads share.
+**
+****************************************************************************************/
+static void CryptoLock(void)
+{
+#if defined(PLATFORM_WINDOWS)
+  EnterCriticalSection(&cryptoLock);
+#else
+  (void)pthread_mutex_lock(&cryptoLock);
+#endif
+} /*** end of CryptoLock ***/
+
+
+/************************************************************************************//**
+** \brief     Releases the lock that the worker threads share.
+**
+****************************************************************************************/
+static void CryptoUnlock(void)
+{
+#if defined(PLATFORM_WINDOWS)
+  LeaveCriticalSection(&cryptoLock);
+#else
+  (void)pthread_mutex_unlock(&cryptoLock);
+#endif
+} /*** end of CryptoUnlock ***/
+
+
+/************************************************************************************//**
+** \brief     Determines the number of processors, which is the default number of worker
+**            threads.
+** \return    Number of processors, at least 1 and at most CRYPTO_THREADS_MAX.
+**
+****************************************************************************************/
+static uint32_t GetProcessorCount(void)
+{
+  uint32_t result;
+#if defined(PLATFORM_WINDOWS)
+  SYSTEM_INFO systemInfo;
+
+  GetSystemInfo(&systemInfo);
+  result = systemInfo.dwNumberOfProcessors;
+#else
+  long processors = sysconf(_SC_NPROCESSORS_ONLN);
+
+  result = (processors > 0) ? (uint32_t)processors : 1u;
+#endif
+  /* Keep the value within its limits. */
+  if (result < 1u)
+  {
+    result = 1u;
+  }
+  if (result > CRYPTO_THREADS_MAX)
+  {
+    result = CRYPTO_THREADS_MAX;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of GetProcessorCount ***/
+
+
 /*********************************** end of main.c *************************************/
 
 
@@ -0,0 +1,1330 @@
+/************************************************************************************//**
+* \file         main.c
+* \brief        FwPipeline program source file.
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+*
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+*
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+*
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include <assert.h>                         /* for assertions                          */
+#include <stdint.h>                         /* for standard integer types              */
+#include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
+#include <stdio.h>                          /* Standard I/O functions.                 */
+#include <string.h>                         /* for string library                      */
+#if defined(PLATFORM_WINDOWS)
+#include <windows.h>                        /* for threads                             */
+#else
+#include <pthread.h>                        /* for threads                             */
+#include <unistd.h>                         /* for sysconf                             */
+#endif
+#include "openblt.h"                        /* OpenBLT host library.                   */
+
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Program return code indicating that the program executed successfully. */
+#define RESULT_OK                           (0)
+
+/** \brief Program return code indicating that an error was detected when processing the
+ *         command line parameters.
+ */
+#define RESULT_ERROR_COMMANDLINE            (1)
+
+/** \brief Program return code indicating that an error was detected while loading
+ *         firmware data from a firmware file.
+ */
+#define RESULT_ERROR_FIRMWARE_LOAD          (2)
+
+/** \brief Program return code indicating that an error was detected while saving
+ *         firmware data to a firmware file.
+ */
+#define RESULT_ERROR_FIRMWARE_SAVE          (3)
+
+/** \brief Program return code indicating that an error was detected during the creation
+ *         of the checksum info table.
+ */
+#define RESULT_ERROR_CHECKSUM_TABLE         (4)
+
+/** \brief Program return code indicating that an error was detected while aligning the
+ *         firmware data.
+ */
+#define RESULT_ERROR_DATA_ALIGNMENT         (5)
+
+/** \brief Program return code indicating that an error was detected while extracting the
+ *         cryptography key from the key file.
+ */
+#define RESULT_ERROR_INVALID_KEY            (6)
+
+/** \brief Program return code indicating that an error was detected while performing
+ *         a cryptographic operation on the firmware data.
+ */
+#define RESULT_ERROR_CRYPTO_OPERATION       (7)
+
+/** \brief Stage that loads a firmware file and combines it with the firmware data that
+ *         is already loaded.
+ */
+#define STAGE_COMBINE                       (0u)
+
+/** \brief Stage that sets the address range to exclude in the stages that follow. */
+#define STAGE_EXCLUDE                       (1u)
+
+/** \brief Stage that adds a checksum info table to the firmware data. */
+#define STAGE_CHECKSUM                      (2u)
+
+/** \brief Stage that aligns the base address and the size of the segments. */
+#define STAGE_ALIGN                         (3u)
+
+/** \brief Stage that encrypts the firmware data. */
+#define STAGE_ENCRYPT                       (4u)
+
+/** \brief Stage that decrypts the firmware data. */
+#define STAGE_DECRYPT                       (5u)
+
+/** \brief Maximum number of stages on the command line. */
+#define PIPELINE_STAGES_MAX                 (32u)
+
+/** \brief Largest alignment that the align stage accepts. */
+#define PIPELINE_ALIGN_MAX                  (65536u)
+
+/** \brief Maximum number of bytes that a worker thread processes at a time. Larger
+ *         parts of a segment are split into jobs of this size, such that the worker
+ *         threads process them in parallel. It is a multiple of the AES block size.
+ */
+#define PIPELINE_JOB_SIZE                   (65536u)
+
+/** \brief Maximum number of worker threads. */
+#define PIPELINE_THREADS_MAX                (64u)
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Stage of the pipeline, as specified on the command line. */
+typedef struct
+{
+  uint8_t type;                  /**< Type of the stage (STAGE_xxx).                   */
+  char const * file;             /**< Firmware or key file, if the stage uses one.     */
+  uint32_t value;                /**< Table address, alignment or region start.        */
+  uint32_t len;                  /**< Size in bytes of the region to exclude.          */
+} tPipelineStage;
+
+/** \brief Part of a firmware data segment that a worker thread processes as a whole. */
+typedef struct
+{
+  uint8_t * data;                /**< Pointer to the data of the job.                  */
+  uint32_t len;                  /**< Number of bytes.                                 */
+  uint16_t crc;                  /**< CRC16 value, once calculated.                    */
+} tPipelineJob;
+
+/** \brief Row of the checksum info table. */
+typedef struct
+{
+  uint32_t address;              /**< Base address of the checksummed data.            */
+  uint32_t size;                 /**< Number of bytes.                                 */
+  uint32_t firstJob;             /**< Index of the first job of the row.               */
+} tChecksumRow;
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+static void DisplayProgramInfo(void);
+static void DisplayProgramUsage(void);
+static bool ParseCommandLine(int argc, char const * const argv[]);
+static int RunStage(tPipelineStage const * stage);
+static bool AddChecksumTable(uint32_t tableAddress);
+static bool AlignSegments(uint32_t alignment);
+static bool CryptSegments(uint8_t const * cryptoKey, bool encrypt);
+static bool ExtractCryptoKeyFromFile(char const * cryptoKeyFile, uint8_t * cryptoKey);
+static bool AddJobs(uint8_t * data, uint32_t len);
+static bool ProcessJobs(void);
+static void JobWorker(void);
+#if defined(PLATFORM_WINDOWS)
+static DWORD WINAPI JobThreadEntry(LPVOID param);
+#else
+static void * JobThreadEntry(void * param);
+#endif
+static void JobLock(void);
+static void JobUnlock(void);
+static uint32_t GetProcessorCount(void);
+
+
+/****************************************************************************************
+* Local constant declarations
+****************************************************************************************/
+/** \brief Names of the stages in the timing report, indexed by the STAGE_xxx type. */
+static char const * const stageNames[] =
+{
+  "combine", "exclude", "checksum", "align", "encrypt", "decrypt"
+};
+
+
+/****************************************************************************************
+* Local data declarations
+****************************************************************************************/
+/** \brief The stages of the pipeline in the order of execution. */
+static tPipelineStage stages[PIPELINE_STAGES_MAX];
+
+/** \brief Number of stages in the stages array. */
+static uint32_t stageCount;
+
+/** \brief The filename of the output firmware file as specified on the command line. */
+static char const * outputFileStr;
+
+/** \brief Flag to indicate if a specific region is excluded from the checksum info table
+ *         and from the crypto operation. It is set by the exclude stage.
+ */
+static bool excludeRegion;
+
+/** \brief The start address of the region to exclude. */
+static uint32_t excludeRegionBaseAddr;
+
+/** \brief The size in bytes of the region to exclude. */
+static uint32_t excludeRegionLen;
+
+/** \brief Number of worker threads that process the jobs. */
+static uint32_t jobThreadCount;
+
+/** \brief Array with the jobs that the worker threads process. */
+static tPipelineJob * jobs;
+
+/** \brief Number of jobs in the jobs array. */
+static uint32_t jobCount;
+
+/** \brief Number of jobs that the jobs array can hold. */
+static uint32_t jobCapacity;
+
+/** \brief Index of the next job that a worker thread takes from the array. */
+static uint32_t jobNext;
+
+/** \brief Flag that a worker thread sets when it could not process a job. */
+static bool jobFailed;
+
+/** \brief Type of the stage that the worker threads process the jobs for. */
+static uint8_t jobStageType;
+
+/** \brief The cryptography context that the worker threads share. */
+static tBltAes256Handle jobCrypto;
+
+/** \brief Lock for the job index and the error flag, shared by the worker threads. */
+#if defined(PLATFORM_WINDOWS)
+static CRITICAL_SECTION jobLock;
+#else
+static pthread_mutex_t jobLock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+
+/************************************************************************************//**
+** \brief     This is the program entry point.
+** \param     argc Number of program arguments.
+** \param     argv Array with program arguments.
+** \return    Program return code. 0 for success, error code otherwise.
+**
+****************************************************************************************/
+int main(int argc, char const * const argv[])
+{
+  int result = RESULT_OK;
+  uint64_t pipelineStart;
+  uint64_t stageStart;
+
+  /* -------------------- Initialization --------------------------------------------- */
+  /* Initialize the firmware data module using the S-record parser. */
+  BltFirmwareInit(BLT_FIRMWARE_PARSER_SRECORD);
+
+  /* -------------------- Display info ----------------------------------------------- */
+  /* Check that the stages and the output file were properly specified on the command
+   * line.
+   */
+  if (!ParseCommandLine(argc, argv))
+  {
+    /* Display program info */
+    DisplayProgramInfo();
+    /* Display program usage. */
+    DisplayProgramUsage();
+    /* Display error. */
+    printf("[ERROR] Incorrect command line parameters specified.\n");
+    /* Set error code. */
+    result = RESULT_ERROR_COMMANDLINE;
+  }
+
+  /* -------------------- Run stages ------------------------------------------------- */
+  /* Run the stages one after the other on the firmware data that is loaded in the
+   * firmware module. The firmware data is only parsed when a firmware file is combined
+   * and is only written once, at the end. The time of each stage is reported.
+   */
+  pipelineStart = BltUtilTimeGetMonotonicUs();
+  for (uint32_t stageIdx = 0; stageIdx < stageCount; stageIdx++)
+  {
+    /* Stop looping if an error was detected. */
+    if (result != RESULT_OK)
+    {
+      break;
+    }
+    stageStart = BltUtilTimeGetMonotonicUs();
+    result = RunStage(&stages[stageIdx]);
+    if (result == RESULT_OK)
+    {
+      printf("%-9s %10.3f ms  ", stageNames[stages[stageIdx].type],
+             (double)(BltUtilTimeGetMonotonicUs() - stageStart) / 1000.0);
+      if (stages[stageIdx].file != NULL)
+      {
+        printf("%s\n", stages[stageIdx].file);
+      }
+      else if (stages[stageIdx].type == STAGE_EXCLUDE)
+      {
+        printf("%08X:%08X\n", stages[stageIdx].value,
+               (stages[stageIdx].value + stages[stageIdx].len) - 1u);
+      }
+      else if (stages[stageIdx].type == STAGE_CHECKSUM)
+      {
+        printf("%08X\n", stages[stageIdx].value);
+      }
+      else
+      {
+        printf("%u\n", stages[stageIdx].value);
+      }
+    }
+  }
+
+  /* -------------------- Firmware saving -------------------------------------------- */
+  /* Save the firmware data that all stages processed into the output file. */
+  if (result == RESULT_OK)
+  {
+    stageStart = BltUtilTimeGetMonotonicUs();
+    if (BltFirmwareSaveToFile(outputFileStr) != BLT_RESULT_OK)
+    {
+      /* Display error. */
+      printf("[ERROR] Could not save output file.\n");
+      /* Set error code. */
+      result = RESULT_ERROR_FIRMWARE_SAVE;
+    }
+    else
+    {
+      printf("%-9s %10.3f ms  %s\n", "save",
+             (double)(BltUtilTimeGetMonotonicUs() - stageStart) / 1000.0,
+             outputFileStr);
+      printf("%-9s %10.3f ms\n", "total",
+             (double)(BltUtilTimeGetMonotonicUs() - pipelineStart) / 1000.0);
+    }
+  }
+
+  /* -------------------- Clean-up --------------------------------------------------- */
+  /* Terminate the firmware data module. */
+  BltFirmwareTerminate();
+
+  /* Give result back. */
+  return result;
+} /*** end of main ***/
+
+
+/************************************************************************************//**
+** \brief     Outputs information to the user about this program.
+**
+****************************************************************************************/
+static void DisplayProgramInfo(void)
+{
+  printf("--------------------------------------------------------------------------\n");
+  printf("FwPipeline version 1.0.0. Combines, checksums, aligns and encrypts\n");
+  printf("S-record files in one pass.\n");
+  printf("Copyright (c) 2017 by Feaser  http://www.feaser.com\n");
+  printf("-------------------------------------------------------------------------\n");
+} /*** end of DisplayProgramInfo ***/
+
+
+/************************************************************************************//**
+** \brief     Outputs information to the user about how to use this program.
+**
+****************************************************************************************/
+static void DisplayProgramUsage(void)
+{
+  printf("Usage:    FwPipeline [stages] [output file]\n");
+  printf("\n");
+  printf("Example:  FwPipeline -c=bootloader.srec -c=userprog.srec\n");
+  printf("                     -x=08000000:08007FFF -cs=0800C000 -en=cryptokey.txt\n");
+  printf("                     release.srec\n");
+  printf("\n");
+  printf("Available stages, which run in the specified order:\n");
+  printf("  -c=[file]          Loads an S-record file and combines it with the\n");
+  printf("                     firmware data of the stages before it. At least one\n");
+  printf("                     file must be specified.\n");
+  printf("  -x=[value]:[value] Specifies an address range that the checksum and\n");
+  printf("                     crypto stages after it exclude. The first value is\n");
+  printf("                     the start address and the second value is the end\n");
+  printf("                     address. Specify both addresses as 32-bit hexadecimal\n");
+  printf("                     values e.g. -x=08000000:08000FFF. Note that both the\n");
+  printf("                     address and total size of the range must be 16-byte\n");
+  printf("                     aligned for the crypto stages.\n");
+  printf("  -cs=[value]        Adds a checksum info table at the specified address,\n");
+  printf("                     as a 32-bit hexadecimal value, like CsAddTable.\n");
+  printf("  -al=[value]        Aligns the base address and the size of the segments\n");
+  printf("                     to a multiple of the specified number of bytes, as a\n");
+  printf("                     decimal power of two. Filler bytes are 0xFF.\n");
+  printf("  -en=[file]         Encrypts the firmware data, like FwCrypto, with the\n");
+  printf("                     256-bit AES key in the specified text file. The\n");
+  printf("                     segments are aligned to 16 bytes first.\n");
+  printf("  -de=[file]         Decrypts the firmware data, like FwCrypto, with the\n");
+  printf("                     256-bit AES key in the specified text file.\n");
+  printf("\n");
+  printf("Available options:\n");
+  printf("  -j=[value]         Number of threads that checksum and en/decrypt the\n");
+  printf("                     firmware data in parallel, as a decimal value\n");
+  printf("                     (Default=number of processors).\n");
+  printf("\n");
+  printf("The time of each stage is reported after it ran.\n");
+  printf("-------------------------------------------------------------------------\n");
+} /*** end of DisplayProgramUsage ***/
+
+
+/************************************************************************************//**
+** \brief     Parses the command line to validate and extract the command line
+**            parameters.
+** \param     argc Number of program arguments.
+** \param     argv Array with program parameter strings.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+static bool ParseCommandLine(int argc, char const * const argv[])
+{
+  bool result = false;
+  bool combined = false;
+  bool aligned16 = true;
+  tPipelineStage * stage;
+
+  /* Check parameters. */
+  assert(argv != NULL);
+
+  /* Reset the command line parameter storage variables. */
+  stageCount = 0;
+  outputFileStr = NULL;
+  jobThreadCount = GetProcessorCount();
+
+  /* Only continue with valid parameters. Note that at least 3 command line arguments
+   * are specified. The first one is always the name of the executable. Additionally,
+   * at least one stage and the s-record output file are expected.
+   */
+  if ( (argv != NULL) && (argc >= 3) ) /*lint !e774 */
+  {
+    result = true;
+    /* Loop through all the command line parameters, just skip the 1st one because this
+     * is the name of the program, which we are not interested in. There is also no need
+     * to iterate over the last parameter, because this is always the s-record output
+     * file.
+     */
+    for (int paramIdx = 1; paramIdx < (argc - 1); paramIdx++)
+    {
+      /* Is this the -j=[value] parameter? */
+      if ( (strstr(argv[paramIdx], "-j=") == argv[paramIdx]) &&
+           (strlen(argv[paramIdx]) > 3) )
+      {
+        /* Extract the number of worker threads and keep it within its limits. */
+        uint32_t threadCount = 0;
+        sscanf(&argv[paramIdx][3], "%u", &threadCount);
+        if (threadCount < 1u)
+        {
+          threadCount = 1u;
+        }
+        if (threadCount > PIPELINE_THREADS_MAX)
+        {
+          threadCount = PIPELINE_THREADS_MAX;
+        }
+        jobThreadCount = threadCount;
+        /* Continue with next loop iteration. */
+        continue;
+      }
+      /* All other parameters are stages. */
+      if (stageCount >= PIPELINE_STAGES_MAX)
+      {
+        result = false;
+        break;
+      }
+      stage = &stages[stageCount];
+      stage->file = NULL;
+      stage->value = 0;
+      stage->len = 0;
+      /* Is this the -c=[file] stage? */
+      if ( (strstr(argv[paramIdx], "-c=") == argv[paramIdx]) &&
+           (strlen(argv[paramIdx]) > 3) )
+      {
+        stage->type = STAGE_COMBINE;
+        stage->file = &argv[paramIdx][3];
+        combined = true;
+      }
+      /* Is this the -x=[value]:[value] stage? */
+      else if ( (strstr(argv[paramIdx], "-x=") == argv[paramIdx]) &&
+                (strlen(argv[paramIdx]) >= 6) )
+      {
+        uint32_t startAddr = 0;
+        uint32_t endAddr = 0;
+        /* Extract the hexadecimal start and end addresses for the region to exclude. */
+        if ( (sscanf(&argv[paramIdx][3], "%x:%x", &startAddr, &endAddr) != 2) ||
+             (startAddr >= endAddr) )
+        {
+          result = false;
+          break;
+        }
+        stage->type = STAGE_EXCLUDE;
+        stage->value = startAddr;
+        stage->len = (endAddr - startAddr) + 1u;
+        aligned16 = ((stage->value % 16u) == 0) && ((stage->len % 16u) == 0);
+      }
+      /* Is this the -cs=[value] stage? */
+      else if ( (strstr(argv[paramIdx], "-cs=") == argv[paramIdx]) &&
+                (strlen(argv[paramIdx]) > 4) )
+      {
+        stage->type = STAGE_CHECKSUM;
+        if (sscanf(&argv[paramIdx][4], "%x", &stage->value) != 1)
+        {
+          result = false;
+          break;
+        }
+      }
+      /* Is this the -al=[value] stage? */
+      else if ( (strstr(argv[paramIdx], "-al=") == argv[paramIdx]) &&
+                (strlen(argv[paramIdx]) > 4) )
+      {
+        stage->type = STAGE_ALIGN;
+        /* The alignment must be a power of two within the supported range. */
+        if ( (sscanf(&argv[paramIdx][4], "%u", &stage->value) != 1) ||
+             (stage->value == 0) || (stage->value > PIPELINE_ALIGN_MAX) ||
+             ((stage->value & (stage->value - 1u)) != 0) )
+        {
+          result = false;
+          break;
+        }
+      }
+      /* Is this the -en=[file] or the -de=[file] stage? */
+      else if ( ( (strstr(argv[paramIdx], "-en=") == argv[paramIdx]) ||
+                  (strstr(argv[paramIdx], "-de=") == argv[paramIdx]) ) &&
+                (strlen(argv[paramIdx]) > 4) )
+      {
+        stage->type = (argv[paramIdx][1] == 'e') ? STAGE_ENCRYPT : STAGE_DECRYPT;
+        stage->file = &argv[paramIdx][4];
+        /* The crypto operation works on blocks of 16 bytes, so a region to exclude must
+         * be 16-byte aligned.
+         */
+        if (!aligned16)
+        {
+          result = false;
+          break;
+        }
+      }
+      /* Unknown parameter. */
+      else
+      {
+        result = false;
+        break;
+      }
+      stageCount++;
+    }
+    /* Store the pointer to the filename of the s-record output file. */
+    outputFileStr = &argv[argc - 1][0];
+    /* The output file should not start with '-', as this is typically the start of a
+     * command line option. At least one firmware file must be combined.
+     */
+    if ( (outputFileStr[0] == '-') || (!combined) )
+    {
+      result = false;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of ParseCommandLine ***/
+
+
+/************************************************************************************//**
+** \brief     Runs one stage of the pipeline on the firmware data that is loaded in the
+**            firmware module.
+** \param     stage The stage to run.
+** \return    Program return code. RESULT_OK for success, error code otherwise.
+**
+****************************************************************************************/
+static int RunStage(tPipelineStage const * stage)
+{
+  int result = RESULT_OK;
+  static uint8_t cryptoKey[32] = { 0 };
+
+  /* Check parameters. */
+  assert(stage != NULL);
+
+  switch (stage->type)
+  {
+    case STAGE_COMBINE:
+      if (BltFirmwareLoadFromFile(stage->file, 0) != BLT_RESULT_OK)
+      {
+        /* Display error. */
+        printf("[ERROR] Could not load the input file %s.\n", stage->file);
+        /* Set error code. */
+        result = RESULT_ERROR_FIRMWARE_LOAD;
+      }
+      break;
+
+    case STAGE_EXCLUDE:
+      /* Store the information about the region to exclude. */
+      excludeRegion = true;
+      excludeRegionBaseAddr = stage->value;
+      excludeRegionLen = stage->len;
+      break;
+
+    case STAGE_CHECKSUM:
+      if (!AddChecksumTable(stage->value))
+      {
+        /* Display error. */
+        printf("[ERROR] Could not add the checksum info table.\n");
+        /* Set error code. */
+        result = RESULT_ERROR_CHECKSUM_TABLE;
+      }
+      break;
+
+    case STAGE_ALIGN:
+      if (!AlignSegments(stage->value))
+      {
+        /* Display error. */
+        printf("[ERROR] Could not align the firmware data.\n");
+        /* Set error code. */
+        result = RESULT_ERROR_DATA_ALIGNMENT;
+      }
+      break;
+
+    default:
+      /* Attempt to extract the key from the file. */
+      if (!ExtractCryptoKeyFromFile(stage->file, cryptoKey))
+      {
+        /* Display error. */
+        printf("[ERROR] Could not read the key from %s.\n", stage->file);
+        /* Set error code. */
+        result = RESULT_ERROR_INVALID_KEY;
+      }
+      /* Decryption is performed in the OpenBLT bootloader's flash driver. AES ECB
+       * cryptography works on blocks of 16 bytes, so the segments are aligned to 16
+       * bytes first.
+       */
+      else if (!AlignSegments(16u))
+      {
+        /* Display error. */
+        printf("[ERROR] Could not align the firmware data.\n");
+        /* Set error code. */
+        result = RESULT_ERROR_DATA_ALIGNMENT;
+      }
+      else if (!CryptSegments(cryptoKey, (stage->type == STAGE_ENCRYPT)))
+      {
+        /* Display error. */
+        printf("[ERROR] Could not perform the cryptography operation.\n");
+        /* Set error code. */
+        result = RESULT_ERROR_CRYPTO_OPERATION;
+      }
+      break;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of RunStage ***/
+
+
+/************************************************************************************//**
+** \brief     Generates a checksum info table over the firmware data that is loaded in
+**            the firmware module and adds it to the firmware data. The table has the
+**            same format as the one that CsAddTable generates. The region to exclude is
+**            left out of the table, without removing it from the firmware data, such
+**            that the firmware data does not have to be restored afterwards.
+** \param     tableAddress Base address of where the table is added.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+static bool AddChecksumTable(uint32_t tableAddress)
+{
+  bool result = false;
+  uint32_t segmentCount;
+  uint32_t rowCount = 0;
+  uint32_t tableSize;
+  uint32_t jobIdx;
+  uint32_t offset;
+  uint16_t crc16Value;
+  tChecksumRow * rows;
+  uint8_t * tableData = NULL;
+  uint8_t * dataPtr;
+  /* Constant checksum table identifier. This value is stored in the first four bytes
+   * of the checksum info table.
+   */
+  uint32_t const checksumTableId = 0x23AA5537ul;
+
+  /* Each segment results in at most two rows, one before and one after the region to
+   * exclude.
+   */
+  segmentCount = BltFirmwareGetSegmentCount();
+  rows = malloc(((segmentCount * 2u) + 1u) * sizeof(tChecksumRow));
+  if (rows != NULL)
+  {
+    result = true;
+    jobCount = 0;
+    for (uint32_t segmentIdx = 0; segmentIdx < segmentCount; segmentIdx++)
+    {
+      uint32_t segmentAddress;
+      uint32_t segmentSize;
+      uint8_t * segmentData;
+      uint64_t partStart[2];
+      uint64_t partEnd[2];
+
+      segmentData = BltFirmwareGetSegment(segmentIdx, &segmentAddress, &segmentSize);
+      if ( (segmentData == NULL) || (segmentSize == 0) )
+      {
+        result = false;
+        break;
+      }
+      /* Determine the parts of the segment that lie before and after the region to
+       * exclude. Without a region to exclude, the first part is the entire segment.
+       */
+      partStart[0] = segmentAddress;
+      partEnd[0] = (uint64_t)segmentAddress + segmentSize;
+      partStart[1] = partEnd[0];
+      partEnd[1] = partEnd[0];
+      if (excludeRegion)
+      {
+        uint64_t regionStart = excludeRegionBaseAddr;
+        uint64_t regionEnd = regionStart + excludeRegionLen;
+
+        if (regionStart < partEnd[0])
+        {
+          partEnd[0] = (regionStart > partStart[0]) ? regionStart : partStart[0];
+        }
+        if (regionEnd < partEnd[1])
+        {
+          partStart[1] = (regionEnd > partStart[0]) ? regionEnd : partStart[0];
+        }
+      }
+      /* Add a row and the jobs for each part that holds data. */
+      for (uint32_t partIdx = 0; partIdx < 2u; partIdx++)
+      {
+        if (partEnd[partIdx] > partStart[partIdx])
+        {
+          rows[rowCount].address = (uint32_t)partStart[partIdx];
+          rows[rowCount].size = (uint32_t)(partEnd[partIdx] - partStart[partIdx]);
+          rows[rowCount].firstJob = jobCount;
+          if (!AddJobs(&segmentData[partStart[partIdx] - segmentAddress],
+                       rows[rowCount].size))
+          {
+            result = false;
+          }
+          rowCount++;
+        }
+      }
+    }
+  }
+  /* The number of rows is stored as a byte in the table header. */
+  if (rowCount > 255u)
+  {
+    result = false;
+  }
+  /* Allocate memory for the table. It has a 10 byte header and 10 bytes per row. */
+  tableSize = 10u + (rowCount * 10u);
+  if (result)
+  {
+    tableData = malloc(tableSize);
+    if (tableData == NULL)
+    {
+      result = false;
+    }
+  }
+  /* Calculate the checksums of the jobs in parallel. */
+  if (result)
+  {
+    jobStageType = STAGE_CHECKSUM;
+    result = ProcessJobs();
+  }
+  if (result)
+  {
+    /* Add the rows after the header row. */
+    dataPtr = &tableData[10];
+    for (uint32_t rowIdx = 0; rowIdx < rowCount; rowIdx++)
+    {
+      /* Combine the checksums of the row's jobs into the checksum over the row's
+       * firmware data.
+       */
+      jobIdx = rows[rowIdx].firstJob;
+      crc16Value = jobs[jobIdx].crc;
+      for (offset = jobs[jobIdx].len; offset < rows[rowIdx].size;
+           offset += jobs[jobIdx].len)
+      {
+        jobIdx++;
+        crc16Value = BltUtilCrc16Combine(crc16Value, jobs[jobIdx].crc, jobs[jobIdx].len);
+      }
+      /* Add the base address, the length and the checksum value (LSB first). */
+      for (uint32_t idx = 0; idx < 4u; idx++)
+      {
+        dataPtr[idx] = (uint8_t)(rows[rowIdx].address >> (idx * 8u));
+        dataPtr[idx + 4u] = (uint8_t)(rows[rowIdx].size >> (idx * 8u));
+      }
+      dataPtr[8] = (uint8_t)crc16Value;
+      dataPtr[9] = (uint8_t)(crc16Value >> 8);
+      dataPtr += 10u;
+    }
+    /* Add the header row: the constant table identifier, the number of rows, three
+     * reserved bytes and the checksum over the rows (LSB first).
+     */
+    crc16Value = BltUtilCrc16Calculate(&tableData[10], rowCount * 10u);
+    for (uint32_t idx = 0; idx < 4u; idx++)
+    {
+      tableData[idx] = (uint8_t)(checksumTableId >> (idx * 8u));
+    }
+    tableData[4] = (uint8_t)rowCount;
+    tableData[5] = 0u;
+    tableData[6] = 0u;
+    tableData[7] = 0u;
+    tableData[8] = (uint8_t)crc16Value;
+    tableData[9] = (uint8_t)(crc16Value >> 8);
+    /* Add the checksum info table to the firmware data. */
+    if (BltFirmwareAddData(tableAddress, tableSize, tableData) != BLT_RESULT_OK)
+    {
+      result = false;
+    }
+  }
+  /* Release the allocated memory. */
+  free(tableData);
+  free(rows);
+  jobCount = 0;
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of AddChecksumTable ***/
+
+
+/************************************************************************************//**
+** \brief     Aligns the base address and the size of all segments to a multiple of the
+**            specified alignment, by adding 0xFF filler bytes. Filler bytes at the start
+**            of a segment never overwrite data of the previous segment. If the filler
+**            bytes close the gap to the previous segment, both segments are merged.
+** \param     alignment The alignment in bytes. It must be a power of two.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+static bool AlignSegments(uint32_t alignment)
+{
+  bool result = true;
+  uint8_t * fillerData;
+  uint32_t segmentCount;
+  uint32_t segmentIdx;
+  uint32_t segmentAddress;
+  uint32_t segmentLen;
+  uint32_t numFillerBytes;
+
+  /* Check parameters. */
+  assert((alignment > 0) && ((alignment & (alignment - 1u)) == 0));
+
+  fillerData = malloc(alignment);
+  if (fillerData == NULL)
+  {
+    result = false;
+  }
+  else
+  {
+    memset(fillerData, 0xff, alignment);
+  }
+  /* Align the base addresses. A segment is only moved on to when its base address is
+   * aligned. Filler bytes that close the gap to the previous segment merge the segment
+   * into the previous one, in which case the next segment moves up to the same index.
+   */
+  segmentCount = BltFirmwareGetSegmentCount();
+  segmentIdx = 0;
+  while ( (result) && (segmentIdx < segmentCount) )
+  {
+    if (BltFirmwareGetSegment(segmentIdx, &segmentAddress, &segmentLen) == NULL)
+    {
+      result = false;
+      break;
+    }
+    numFillerBytes = segmentAddress & (alignment - 1u);
+    /* Make sure that the filler bytes do not overwrite data in the previous segment. */
+    if ( (numFillerBytes > 0) && (segmentIdx >= 1u) )
+    {
+      uint32_t prevSegmentAddress;
+      uint32_t prevSegmentLen;
+      if (BltFirmwareGetSegment(segmentIdx - 1u, &prevSegmentAddress,
+                                &prevSegmentLen) == NULL)
+      {
+        result = false;
+        break;
+      }
+      if (numFillerBytes > (segmentAddress - (prevSegmentAddress + prevSegmentLen)))
+      {
+        numFillerBytes = segmentAddress - (prevSegmentAddress + prevSegmentLen);
+      }
+    }
+    if (numFillerBytes == 0)
+    {
+      segmentIdx++;
+    }
+    else
+    {
+      if (BltFirmwareAddData(segmentAddress - numFillerBytes, numFillerBytes,
+                             fillerData) != BLT_RESULT_OK)
+      {
+        result = false;
+      }
+      segmentCount = BltFirmwareGetSegmentCount();
+    }
+  }
+  /* Align the sizes. The base address of the next segment is already aligned, so the
+   * filler bytes cannot overwrite its data. They merge both segments at the most, in
+   * which case the merged segment is checked again.
+   */
+  segmentIdx = 0;
+  while ( (result) && (segmentIdx < segmentCount) )
+  {
+    if (BltFirmwareGetSegment(segmentIdx, &segmentAddress, &segmentLen) == NULL)
+    {
+      result = false;
+      break;
+    }
+    numFillerBytes = (alignment - ((segmentAddress + segmentLen) & (alignment - 1u))) &
+                     (alignment - 1u);
+    if (numFillerBytes == 0)
+    {
+      segmentIdx++;
+    }
+    else
+    {
+      if (BltFirmwareAddData(segmentAddress + segmentLen, numFillerBytes,
+                             fillerData) != BLT_RESULT_OK)
+      {
+        result = false;
+      }
+      segmentCount = BltFirmwareGetSegmentCount();
+    }
+  }
+  /* Release the allocated memory. */
+  free(fillerData);
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of AlignSegments ***/
+
+
+/************************************************************************************//**
+** \brief     En/decrypts the firmware data that is loaded in the firmware module, like
+**            FwCrypto does. The blocks that lie entirely within the region to exclude
+**            are left as is. The segments must already be aligned to 16 bytes.
+** \param     cryptoKey Pointer to the 32 byte cryptography key.
+** \param     encrypt True for encryption, false for decryption.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+static bool CryptSegments(uint8_t const * cryptoKey, bool encrypt)
+{
+  bool result = true;
+
+  /* Check parameters. */
+  assert(cryptoKey != NULL);
+
+  /* The key is expanded only once, in a cryptography context that all worker threads
+   * share.
+   */
+  jobCrypto = BltUtilCryptoAes256Create(cryptoKey);
+  if (jobCrypto == NULL)
+  {
+    result = false;
+  }
+  jobCount = 0;
+  for (uint32_t segmentIdx = 0; segmentIdx < BltFirmwareGetSegmentCount(); segmentIdx++)
+  {
+    /* Stop looping if an error was detected. */
+    if (!result)
+    {
+      break;
+    }
+    /* Obtain segment info. */
+    uint32_t segmentAddress;
+    uint32_t segmentLen;
+    uint8_t * segmentData;
+    segmentData = BltFirmwareGetSegment(segmentIdx, &segmentAddress, &segmentLen);
+    if (segmentData == NULL)
+    {
+      result = false;
+      break;
+    }
+    /* Determine the range of blocks that lie entirely within the region to exclude.
+     * By default the range is empty.
+     */
+    uint32_t blockCount = segmentLen / 16u;
+    uint32_t excludeFirst = blockCount;
+    uint32_t excludeEnd = blockCount;
+    if (excludeRegion)
+    {
+      uint64_t regionStart = excludeRegionBaseAddr;
+      uint64_t regionEnd = regionStart + excludeRegionLen;
+      uint64_t first = 0;
+      uint64_t end = 0;
+      if (regionStart > segmentAddress)
+      {
+        first = ((regionStart - segmentAddress) + 15u) / 16u;
+      }
+      if (regionEnd > segmentAddress)
+      {
+        end = (regionEnd - segmentAddress) / 16u;
+      }
+      if (end > blockCount)
+      {
+        end = blockCount;
+      }
+      if (first < end)
+      {
+        excludeFirst = (uint32_t)first;
+        excludeEnd = (uint32_t)end;
+      }
+    }
+    /* Add the blocks before and after the excluded range. */
+    if ( (!AddJobs(segmentData, excludeFirst * 16u)) ||
+         (!AddJobs(&segmentData[excludeEnd * 16u], (blockCount - excludeEnd) * 16u)) )
+    {
+      result = false;
+    }
+  }
+  /* En/decrypt all jobs. */
+  if (result)
+  {
+    jobStageType = encrypt ? STAGE_ENCRYPT : STAGE_DECRYPT;
+    result = ProcessJobs();
+  }
+  /* Release the cryptography context. */
+  if (jobCrypto != NULL)
+  {
+    BltUtilCryptoAes256Destroy(jobCrypto);
+    jobCrypto = NULL;
+  }
+  jobCount = 0;
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of CryptSegments ***/
+
+
+/************************************************************************************//**
+** \brief     Extract the 256-bit AES-ECB cryptography key from the file contents, in
+**            the same format as FwCrypto:
+**              key=0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF
+** \param     cryptoKeyFile The filename of the text-file that holds the key.
+** \param     cryptoKey Pointer to byte array with at least 32 elements where the
+**            extracted cryptography key will be written to.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+static bool ExtractCryptoKeyFromFile(char const * cryptoKeyFile, uint8_t * cryptoKey)
+{
+  bool result = false;
+  FILE *fp;
+  /* The line is only expected to have "key=" + 64 characters + CR + LF = 70 characters.
+   * just make the line buffer a bit bigger in case the file contains other lines. Note
+   * that this array was made static to lower the stack load.
+   */
+  static char line[256];
+
+  /* Check parameters. */
+  assert(cryptoKeyFile != NULL);
+  assert(cryptoKey != NULL);
+
+  /* Only continue with valid parameters. */
+  if ( (cryptoKeyFile != NULL) && (cryptoKey != NULL) ) /*lint !e774 */
+  {
+    /* Open the file for reading. */
+    fp = fopen(cryptoKeyFile, "r");
+    /* Only continue if the filepointer is valid. */
+    if (fp != NULL)
+    {
+      /* Read the file one line at a time, until the key is found. */
+      while ( (!result) && (fgets(line, sizeof(line)/sizeof(line[0]), fp) != NULL) )
+      {
+        /* Does this line start with "key=" and is it followed by at least 64
+         * hexadecimal characters?
+         */
+        if ( (strstr(line, "key=") == &line[0]) && (strlen(&line[4]) >= 64) )
+        {
+          /* Read out the 32 bytes of the cryptography key one-by-one. */
+          for (uint8_t idx = 0; idx < 32; idx++)
+          {
+            sscanf(&line[4 + (idx * 2)], "%2hhx", &cryptoKey[idx]);
+          }
+          /* All key characters read. Update the result value. */
+          result = true;
+        }
+      }
+      /* Close the file now that we are done with it. */
+      fclose(fp);
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of ExtractCryptoKeyFromFile ***/
+
+
+/************************************************************************************//**
+** \brief     Adds the specified firmware data to the jobs that the worker threads
+**            process. The data is split into jobs of at most PIPELINE_JOB_SIZE bytes.
+** \param     data Pointer to the firmware data.
+** \param     len The number of bytes. Nothing is added if it is zero.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+static bool AddJobs(uint8_t * data, uint32_t len)
+{
+  bool result = true;
+
+  /* Check parameters. */
+  assert(data != NULL);
+
+  while (len > 0)
+  {
+    /* Grow the array if it is full. */
+    if (jobCount == jobCapacity)
+    {
+      uint32_t newCapacity = (jobCapacity == 0) ? 16u : (jobCapacity * 2u);
+      tPipelineJob * newJobs;
+      newJobs = realloc(jobs, newCapacity * sizeof(tPipelineJob));
+      if (newJobs == NULL)
+      {
+        result = false;
+        break;
+      }
+      jobs = newJobs;
+      jobCapacity = newCapacity;
+    }
+    /* Add the next job. */
+    uint32_t jobLen = (len > PIPELINE_JOB_SIZE) ? PIPELINE_JOB_SIZE : len;
+    jobs[jobCount].data = data;
+    jobs[jobCount].len = jobLen;
+    jobs[jobCount].crc = 0;
+    data += jobLen;
+    len -= jobLen;
+    jobCount++;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of AddJobs ***/
+
+
+/************************************************************************************//**
+** \brief     Processes all jobs with a pool of worker threads. Each worker thread takes
+**            the next job, until all jobs are processed. The program's main thread is
+**            one of the worker threads. No more threads are started than there are
+**            jobs, so small firmware files are processed without starting any
+**            additional threads.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+static bool ProcessJobs(void)
+{
+  uint32_t threadCount = jobThreadCount;
+  uint32_t threadsStarted = 0;
+#if defined(PLATFORM_WINDOWS)
+  HANDLE threads[PIPELINE_THREADS_MAX];
+#else
+  pthread_t threads[PIPELINE_THREADS_MAX];
+#endif
+
+  /* Initialize the shared state of the worker threads. */
+  jobNext = 0;
+  jobFailed = false;
+#if defined(PLATFORM_WINDOWS)
+  InitializeCriticalSection(&jobLock);
+#endif
+  if (threadCount > jobCount)
+  {
+    threadCount = jobCount;
+  }
+  /* Start the additional worker threads. If a thread cannot be started, the ones that
+   * did start simply take more jobs.
+   */
+  for (uint32_t idx = 1; idx < threadCount; idx++)
+  {
+#if defined(PLATFORM_WINDOWS)
+    threads[threadsStarted] = CreateThread(NULL, 0, JobThreadEntry, NULL, 0, NULL);
+    if (threads[threadsStarted] == NULL)
+    {
+      break;
+    }
+#else
+    if (pthread_create(&threads[threadsStarted], NULL, JobThreadEntry, NULL) != 0)
+    {
+      break;
+    }
+#endif
+    threadsStarted++;
+  }
+  /* The main thread works along and then waits for the other threads to finish. */
+  JobWorker();
+  for (uint32_t idx = 0; idx < threadsStarted; idx++)
+  {
+#if defined(PLATFORM_WINDOWS)
+    (void)WaitForSingleObject(threads[idx], INFINITE);
+    (void)CloseHandle(threads[idx]);
+#else
+    (void)pthread_join(threads[idx], NULL);
+#endif
+  }
+#if defined(PLATFORM_WINDOWS)
+  DeleteCriticalSection(&jobLock);
+#endif
+  /* Give the result back to the caller. */
+  return !jobFailed;
+} /*** end of ProcessJobs ***/
+
+
+/************************************************************************************//**
+** \brief     Takes jobs and processes them for the current stage, until no jobs are
+**            left or a job could not be processed.
+**
+****************************************************************************************/
+static void JobWorker(void)
+{
+  uint32_t jobIdx;
+  uint32_t jobResult;
+
+  for (;;)
+  {
+    /* Take the next job. */
+    JobLock();
+    jobIdx = jobNext;
+    if ( (jobIdx < jobCount) && (!jobFailed) )
+    {
+      jobNext++;
+    }
+    else
+    {
+      jobIdx = jobCount;
+    }
+    JobUnlock();
+    /* Stop when there are no more jobs to process. */
+    if (jobIdx >= jobCount)
+    {
+      break;
+    }
+    /* Process the job. Each worker thread only writes to the jobs that it took. */
+    jobResult = BLT_RESULT_OK;
+    if (jobStageType == STAGE_CHECKSUM)
+    {
+      jobs[jobIdx].crc = BltUtilCrc16Calculate(jobs[jobIdx].data, jobs[jobIdx].len);
+    }
+    else if (jobStageType == STAGE_ENCRYPT)
+    {
+      jobResult = BltUtilCryptoAes256HandleEncrypt(jobCrypto, jobs[jobIdx].data,
+                                                   jobs[jobIdx].len);
+    }
+    else
+    {
+      jobResult = BltUtilCryptoAes256HandleDecrypt(jobCrypto, jobs[jobIdx].data,
+                                                   jobs[jobIdx].len);
+    }
+    if (jobResult != BLT_RESULT_OK)
+    {
+      JobLock();
+      jobFailed = true;
+      JobUnlock();
+    }
+  }
+} /*** end of JobWorker ***/
+
+
+/************************************************************************************//**
+** \brief     Entry point of an additional worker thread.
+** \param     param Not used.
+** \return    Always zero.
+**
+****************************************************************************************/
+#if defined(PLATFORM_WINDOWS)
+static DWORD WINAPI JobThreadEntry(LPVOID param)
+{
+  (void)param;
+  JobWorker();
+  return 0;
+} /*** end of JobThreadEntry ***/
+#else
+static void * JobThreadEntry(void * param)
+{
+  (void)param;
+  JobWorker();
+  return NULL;
+} /*** end of JobThreadEntry ***/
+#endif
+
+
+/************************************************************************************//**
+** \brief     Obtains the lock that the worker threads share.
+**
+****************************************************************************************/
+static void JobLock(void)
+{
+#if defined(PLATFORM_WINDOWS)
+  EnterCriticalSection(&jobLock);
+#else
+  (void)pthread_mutex_lock(&jobLock);
+#endif
+} /*** end of JobLock ***/
+
+
+/************************************************************************************//**
+** \brief     Releases the lock that the worker threads share.
+**
+****************************************************************************************/
+static void JobUnlock(void)
+{
+#if defined(PLATFORM_WINDOWS)
+  LeaveCriticalSection(&jobLock);
+#else
+  (void)pthread_mutex_unlock(&jobLock);
+#endif
+} /*** end of JobUnlock ***/
+
+
+/************************************************************************************//**
+** \brief     Determines the number of processors, which is the default number of worker
+**            threads.
+** \return    Number of processors, at least 1 and at most PIPELINE_THREADS_MAX.
+**
+****************************************************************************************/
+static uint32_t GetProcessorCount(void)
+{
+  uint32_t result;
+#if defined(PLATFORM_WINDOWS)
+  SYSTEM_INFO systemInfo;
+
+  GetSystemInfo(&systemInfo);
+  result = systemInfo.dwNumberOfProcessors;
+#else
+  long processors = sysconf(_SC_NPROCESSORS_ONLN);
+
+  result = (processors > 0) ? (uint32_t)processors : 1u;
+#endif
+  /* Keep the value within its limits. */
+  if (result < 1u)
+  {
+    result = 1u;
+  }
+  if (result > PIPELINE_THREADS_MAX)
+  {
+    result = PIPELINE_THREADS_MAX;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of GetProcessorCount ***/
+
+
+/*********************************** end of main.c *************************************/
@@ -1,6 +1,7 @@
 /*  
 *   Byte-oriented AES-256 implementation.
 *   All lookup tables replaced with 'on the fly' calculations. 
+*   Key schedule context with T-table and AES-NI block processing.
 *
 *   Copyright (c) 2007-2009 Ilya O. Levin, http://www.literatecode.com
 *   Other contributors: Hal Finney
@@ -34,6 +35,39 @@ extern "C" {
     void aes256_encrypt_ecb(aes256_context *, uint8_t * /* plaintext */);
     void aes256_decrypt_ecb(aes256_context *, uint8_t * /* cipertext */);
 
+    /* Block cipher implementations that the key schedule context can use. */
+    typedef enum {
+        AES256_BACKEND_AUTO = 0,  /* fastest one that the CPU supports */
+        AES256_BACKEND_BYTE,      /* byte-oriented, round keys on the fly */
+        AES256_BACKEND_TTABLE,    /* portable 32-bit T-tables */
+        AES256_BACKEND_AESNI      /* x86 AES-NI instructions */
+    } aes256_backend;
+
+    /* Context with the expanded encryption and decryption key schedules. The key
+     * is expanded once in aes256_ks_init(), after which any number of blocks can be
+     * processed per call. The T-table backend uses the round keys as big-endian
+     * words, the AES-NI backend as bytes. The byte-oriented backend only uses the
+     * original context.
+     */
+    typedef struct {
+        union {
+            uint32_t w[60];
+            uint8_t b[240];
+        } enckey, deckey;
+        aes256_context ctx;
+        aes256_backend backend;
+    } aes256_ks_context;
+
+    int aes256_backend_supported(aes256_backend);
+    aes256_backend aes256_backend_select(void);
+    const char *aes256_backend_name(aes256_backend);
+    int aes256_ks_init(aes256_ks_context *, uint8_t const * /* key */, aes256_backend);
+    void aes256_ks_done(aes256_ks_context *);
+    void aes256_ks_encrypt_ecb(aes256_ks_context *, uint8_t * /* plaintext */,
+                               uint32_t /* blocks */);
+    void aes256_ks_decrypt_ecb(aes256_ks_context *, uint8_t * /* ciphertext */,
+                               uint32_t /* blocks */);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,262 @@
+/************************************************************************************//**
+* \file         aesbench.c
+* \brief        AES256 benchmark program source file.
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+*
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+*
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+*
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include <stdint.h>                         /* for standard integer types              */
+#include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
+#include <stdio.h>                          /* Standard I/O functions.                 */
+#include <string.h>                         /* for string library                      */
+#include <time.h>                           /* for clock                               */
+#include "aes256.h"                         /* for AES256 cryptography.                */
+
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Program return code indicating that all backends passed. */
+#define RESULT_OK                           (0)
+/** \brief Program return code indicating that a backend produced wrong results. */
+#define RESULT_ERROR_MISMATCH               (1)
+/** \brief Program return code indicating that memory could not be allocated. */
+#define RESULT_ERROR_MEMORY                 (2)
+
+/** \brief Number of 16 byte blocks in the benchmark buffer (1 MiB). */
+#define BENCH_BLOCKS                        (65536u)
+/** \brief Minimum processor time in seconds that each measurement runs. */
+#define BENCH_MIN_SECONDS                   (0.5)
+/** \brief Number of blocks in the cross-check buffer. It is deliberately not a multiple
+ *         of eight, so that the remainder handling of the parallel backends is checked
+ *         as well.
+ */
+#define CHECK_BLOCKS                        (1029u)
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+static bool CheckBackend(aes256_backend backend, uint8_t const * reference,
+                         uint8_t const * plain);
+static double MeasureBackend(aes256_backend backend, uint8_t * buffer, bool encrypt);
+
+
+/****************************************************************************************
+* Local constant declarations
+****************************************************************************************/
+/** \brief Key of the AES-256 example vector in appendix C.3 of FIPS-197. */
+static const uint8_t fipsKey[32] =
+{
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d,
+  0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b,
+  0x1c, 0x1d, 0x1e, 0x1f
+};
+
+/** \brief Plaintext of the AES-256 example vector in appendix C.3 of FIPS-197. */
+static const uint8_t fipsPlain[16] =
+{
+  0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd,
+  0xee, 0xff
+};
+
+/** \brief Ciphertext of the AES-256 example vector in appendix C.3 of FIPS-197. */
+static const uint8_t fipsCipher[16] =
+{
+  0x8e, 0xa2, 0xb7, 0xca, 0x51, 0x67, 0x45, 0xbf, 0xea, 0xfc, 0x49, 0x90, 0x4b, 0x49,
+  0x60, 0x89
+};
+
+
+/************************************************************************************//**
+** \brief     This is the program entry point. It checks each AES256 backend that the
+**            CPU supports against the FIPS-197 example vector and against the byte-
+**            oriented backend. Afterwards it reports the encryption and decryption
+**            throughput of each backend.
+** \param     argc Number of program arguments.
+** \param     argv Array with program arguments.
+** \return    Program return code.
+**
+****************************************************************************************/
+int main(int argc, char const * const argv[])
+{
+  int result = RESULT_OK;
+  uint8_t * buffer;
+  uint8_t * plain;
+  uint8_t * reference;
+  aes256_ks_context ctx;
+  aes256_backend backend;
+
+  /* The program has no parameters. */
+  (void)argc;
+  (void)argv;
+
+  buffer = malloc(BENCH_BLOCKS * 16u);
+  plain = malloc(CHECK_BLOCKS * 16u);
+  reference = malloc(CHECK_BLOCKS * 16u);
+  if ( (buffer == NULL) || (plain == NULL) || (reference == NULL) )
+  {
+    printf("[ERROR] Could not allocate memory.\n");
+    result = RESULT_ERROR_MEMORY;
+  }
+  else
+  {
+    /* Prepare pseudo random test data and encrypt it with the byte-oriented backend,
+     * which is the original implementation, as a reference.
+     */
+    srand(1);
+    for (uint32_t i = 0; i < (CHECK_BLOCKS * 16u); i++)
+    {
+      plain[i] = (uint8_t)rand();
+    }
+    memcpy(reference, plain, CHECK_BLOCKS * 16u);
+    (void)aes256_ks_init(&ctx, fipsKey, AES256_BACKEND_BYTE);
+    aes256_ks_encrypt_ecb(&ctx, reference, CHECK_BLOCKS);
+    aes256_ks_done(&ctx);
+    memset(buffer, 0x5a, BENCH_BLOCKS * 16u);
+
+    printf("Automatically selected backend: %s\n",
+           aes256_backend_name(aes256_backend_select()));
+    printf("%-8s %-6s %12s %12s\n", "Backend", "Check", "Enc[MB/s]", "Dec[MB/s]");
+    for (backend = AES256_BACKEND_BYTE; backend <= AES256_BACKEND_AESNI; backend++)
+    {
+      if (!aes256_backend_supported(backend))
+      {
+        printf("%-8s %-6s %12s %12s\n", aes256_backend_name(backend), "N/A", "-", "-");
+        continue;
+      }
+      if (!CheckBackend(backend, reference, plain))
+      {
+        printf("%-8s %-6s %12s %12s\n", aes256_backend_name(backend), "FAIL", "-", "-");
+        result = RESULT_ERROR_MISMATCH;
+        continue;
+      }
+      printf("%-8s %-6s %12.1f %12.1f\n", aes256_backend_name(backend), "OK",
+             MeasureBackend(backend, buffer, true),
+             MeasureBackend(backend, buffer, false));
+    }
+  }
+  free(buffer);
+  free(plain);
+  free(reference);
+  return result;
+} /*** end of main ***/
+
+
+/************************************************************************************//**
+** \brief     Checks that a backend encrypts and decrypts the FIPS-197 example vector
+**            correctly and that it encrypts the test data exactly like the byte-
+**            oriented backend.
+** \param     backend The backend to check.
+** \param     reference The test data encrypted by the byte-oriented backend.
+** \param     plain The test data.
+** \return    True if the backend produced the correct results, false otherwise.
+**
+****************************************************************************************/
+static bool CheckBackend(aes256_backend backend, uint8_t const * reference,
+                         uint8_t const * plain)
+{
+  bool result = false;
+  aes256_ks_context ctx;
+  uint8_t block[16];
+  uint8_t * data;
+
+  data = malloc(CHECK_BLOCKS * 16u);
+  if ( (data != NULL) && (aes256_ks_init(&ctx, fipsKey, backend) != 0) )
+  {
+    result = true;
+    /* Check the example vector. */
+    memcpy(block, fipsPlain, sizeof(block));
+    aes256_ks_encrypt_ecb(&ctx, block, 1u);
+    if (memcmp(block, fipsCipher, sizeof(block)) != 0)
+    {
+      result = false;
+    }
+    aes256_ks_decrypt_ecb(&ctx, block, 1u);
+    if (memcmp(block, fipsPlain, sizeof(block)) != 0)
+    {
+      result = false;
+    }
+    /* Check the test data, with all blocks processed in one call. */
+    memcpy(data, plain, CHECK_BLOCKS * 16u);
+    aes256_ks_encrypt_ecb(&ctx, data, CHECK_BLOCKS);
+    if (memcmp(data, reference, CHECK_BLOCKS * 16u) != 0)
+    {
+      result = false;
+    }
+    aes256_ks_decrypt_ecb(&ctx, data, CHECK_BLOCKS);
+    if (memcmp(data, plain, CHECK_BLOCKS * 16u) != 0)
+    {
+      result = false;
+    }
+    aes256_ks_done(&ctx);
+  }
+  free(data);
+  return result;
+} /*** end of CheckBackend ***/
+
+
+/************************************************************************************//**
+** \brief     Measures the throughput of a backend. The buffer is processed repeatedly,
+**            until the minimum measurement time elapsed.
+** \param     backend The backend to measure.
+** \param     buffer Buffer with BENCH_BLOCKS blocks to process.
+** \param     encrypt True to measure encryption, false to measure decryption.
+** \return    Throughput in megabytes (10^6 bytes) per second.
+**
+****************************************************************************************/
+static double MeasureBackend(aes256_backend backend, uint8_t * buffer, bool encrypt)
+{
+  aes256_ks_context ctx;
+  uint32_t rounds = 0;
+  clock_t start;
+  double seconds;
+
+  (void)aes256_ks_init(&ctx, fipsKey, backend);
+  start = clock();
+  do
+  {
+    if (encrypt)
+    {
+      aes256_ks_encrypt_ecb(&ctx, buffer, BENCH_BLOCKS);
+    }
+    else
+    {
+      aes256_ks_decrypt_ecb(&ctx, buffer, BENCH_BLOCKS);
+    }
+    rounds++;
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+  }
+  while (seconds < BENCH_MIN_SECONDS);
+  aes256_ks_done(&ctx);
+  return ((double)rounds * BENCH_BLOCKS * 16u) / (seconds * 1000000.0);
+} /*** end of MeasureBackend ***/
+
+
+/*********************************** end of aesbench.c *********************************/
@@ -0,0 +1,389 @@
+/************************************************************************************//**
+* \file         cancontention.c
+* \brief        CAN session contention benchmark program source file.
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+*
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+*
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+*
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include <stdint.h>                         /* for standard integer types              */
+#include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
+#include <stdio.h>                          /* Standard I/O functions.                 */
+#include <string.h>                         /* for string library                      */
+#include "util.h"                           /* Utility module                          */
+#include "candriver.h"                      /* Generic CAN driver module               */
+#include "session.h"                        /* Communication session module            */
+#include "xcploader.h"                      /* XCP loader module                       */
+#include "xcptpcan.h"                       /* XCP CAN transport layer                 */
+#include "xcpsim.h"                         /* XCP target simulation                   */
+#include "simtarget.h"                      /* Simulated targets on the loopback bus   */
+
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Program return code indicating that all sessions succeeded. */
+#define RESULT_OK                           (0)
+/** \brief Program return code indicating that a session failed or that the programmed
+ *         data did not match.
+ */
+#define RESULT_ERROR_SESSION                (1)
+/** \brief Program return code indicating that the benchmark could not be set up. */
+#define RESULT_ERROR_SETUP                  (2)
+
+/** \brief Default CAN baudrate in bits/sec. */
+#define BENCH_BAUDRATE_DEFAULT              (500000u)
+/** \brief Maximum number of concurrent sessions. */
+#define BENCH_SESSIONS_MAX                  (8u)
+/** \brief Number of bytes that each session programs. */
+#define BENCH_DATA_SIZE                     (8192u)
+/** \brief Start address of the flash memory of the simulated targets. */
+#define BENCH_FLASH_ADDRESS                 (0x00010000u)
+/** \brief Sector size of the flash memory of the simulated targets. */
+#define BENCH_FLASH_SECTOR_SIZE             (1024u)
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief State of one programming session of the benchmark. */
+typedef struct t_bench_session
+{
+  tXcpTpCanSettings tpSettings;    /**< CAN transport layer settings.                  */
+  tXcpLoaderSettings settings;     /**< XCP loader settings.                           */
+  tSessionHandle handle;           /**< Handle of the session.                         */
+  uint8_t const * data;            /**< Data that the session programs.                */
+  uint64_t time;                   /**< Duration of the programming in microseconds.   */
+  bool ok;                         /**< True if all session steps succeeded.           */
+} tBenchSession;
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+static bool RunBench(char const * device, uint32_t baudrate, uint32_t count,
+                     uint8_t const * data);
+static void RunSession(void * arg);
+
+
+/****************************************************************************************
+* Local constant declarations
+****************************************************************************************/
+/** \brief Number of concurrent sessions for which the benchmark runs. */
+static const uint32_t benchSessionCounts[] =
+{
+  1u, 2u, 4u, BENCH_SESSIONS_MAX
+};
+
+/** \brief Flash memory layout of each simulated target. */
+static const tXcpSimRegion benchFlashRegion =
+{
+  BENCH_FLASH_ADDRESS, BENCH_FLASH_SECTOR_SIZE, BENCH_DATA_SIZE / BENCH_FLASH_SECTOR_SIZE
+};
+
+
+/** \brief Devices for which the benchmark runs, if no device is specified. Without
+ *         bitrate emulation the sessions only compete for the locks of the host side CAN
+ *         stack. With bitrate emulation they compete for the bus time like on a real CAN
+ *         bus, which hides the host side overhead.
+ */
+static char const * const benchDevicesDefault[] =
+{
+  "loopback:bitrate=0", "loopback"
+};
+
+
+/****************************************************************************************
+* Local data declarations
+****************************************************************************************/
+/** \brief The programming sessions. */
+static tBenchSession benchSessions[BENCH_SESSIONS_MAX];
+
+
+/************************************************************************************//**
+** \brief     This is the program entry point. It programs simulated targets on the
+**            in-process loopback CAN bus, with an increasing number of sessions that
+**            run concurrently, each in its own thread. For each number of sessions it
+**            reports the aggregate and per-session throughput and the command/response
+**            latency. The programmed data is checked in the flash memory of each
+**            simulated target. Without a device argument, the benchmark runs once
+**            without and once with bitrate emulation on the loopback CAN bus.
+** \param     argc Number of program arguments.
+** \param     argv Array with program arguments. The optional first argument is the
+**            device name, such as "loopback:bitrate=0" or "loopback:latency=200". The
+**            optional second argument is the baudrate in bits/sec.
+** \return    Program return code.
+**
+****************************************************************************************/
+int main(int argc, char const * const argv[])
+{
+  int result = RESULT_OK;
+  char const * const * devices = benchDevicesDefault;
+  uint32_t deviceCount = sizeof(benchDevicesDefault) / sizeof(benchDevicesDefault[0]);
+  uint32_t baudrate = BENCH_BAUDRATE_DEFAULT;
+  uint8_t * data;
+  uint32_t devIdx;
+  uint32_t idx;
+
+  /* Process the optional program arguments. */
+  if (argc > 1)
+  {
+    devices = &argv[1];
+    deviceCount = 1;
+  }
+  if (argc > 2)
+  {
+    baudrate = (uint32_t)strtoul(argv[2], NULL, 10);
+  }
+
+  data = malloc(BENCH_SESSIONS_MAX * BENCH_DATA_SIZE);
+  if (data == NULL)
+  {
+    printf("[ERROR] Could not allocate memory.\n");
+    result = RESULT_ERROR_SETUP;
+  }
+  else
+  {
+    /* Prepare pseudo random test data, different for each session. */
+    srand(1);
+    for (idx = 0; idx < (BENCH_SESSIONS_MAX * BENCH_DATA_SIZE); idx++)
+    {
+      data[idx] = (uint8_t)rand();
+    }
+    for (devIdx = 0; devIdx < deviceCount; devIdx++)
+    {
+      if (devIdx > 0)
+      {
+        printf("\n");
+      }
+      printf("Device %s, %u bit/sec, %u bytes per session\n", devices[devIdx],
+             (unsigned int)baudrate, (unsigned int)BENCH_DATA_SIZE);
+      printf("%-8s %-6s %10s %12s %10s %10s %10s\n", "Sessions", "Result",
+             "Time [ms]", "Total [kB/s]", "Per [kB/s]", "Avg [us]", "Max [us]");
+      for (idx = 0; idx < (sizeof(benchSessionCounts) / sizeof(benchSessionCounts[0]));
+           idx++)
+      {
+        if (!RunBench(devices[devIdx], baudrate, benchSessionCounts[idx], data))
+        {
+          result = RESULT_ERROR_SESSION;
+        }
+        (void)fflush(stdout);
+      }
+    }
+  }
+  free(data);
+  return result;
+} /*** end of main ***/
+
+
+/************************************************************************************//**
+** \brief     Runs the benchmark for a number of concurrent sessions and reports the
+**            results as one line of the table.
+** \param     device CAN device name.
+** \param     baudrate CAN baudrate in bits/sec.
+** \param     count Number of concurrent sessions.
+** \param     data Test data. Session n programs BENCH_DATA_SIZE bytes at offset
+**            n * BENCH_DATA_SIZE.
+** \return    True if all sessions succeeded and programmed the correct data, false
+**            otherwise.
+**
+****************************************************************************************/
+static bool RunBench(char const * device, uint32_t baudrate, uint32_t count,
+                     uint8_t const * data)
+{
+  bool result = true;
+  tXcpSimSettings simSettings;
+  tUtilThread threads[BENCH_SESSIONS_MAX];
+  tSessionLatency latency;
+  tSessionLatency sessionLatency;
+  uint8_t check[BENCH_DATA_SIZE];
+  uint64_t startTime;
+  uint64_t wallTime;
+  uint64_t sessionTime = 0;
+  uint32_t idx;
+  uint32_t bucket;
+
+  /* Configure the simulated targets without flash timing, so that only the
+   * communication is measured.
+   */
+  memset(&simSettings, 0, sizeof(simSettings));
+  simSettings.regions = &benchFlashRegion;
+  simSettings.regionCount = 1;
+  simSettings.maxCto = CAN_MSG_MAX_LEN;
+  simSettings.maxDto = CAN_MSG_MAX_LEN;
+  simSettings.faultSeed = 1;
+
+  /* Initialize the sessions. The first one creates the virtual CAN bus. */
+  for (idx = 0; idx < count; idx++)
+  {
+    memset(&benchSessions[idx], 0, sizeof(benchSessions[idx]));
+    benchSessions[idx].tpSettings.device = device;
+    benchSessions[idx].tpSettings.baudrate = baudrate;
+    benchSessions[idx].tpSettings.transmitId = SIM_TARGET_COMMAND_ID + idx;
+    benchSessions[idx].tpSettings.receiveId = SIM_TARGET_RESPONSE_ID + idx;
+    benchSessions[idx].settings.timeoutT1 = 1000;
+    benchSessions[idx].settings.timeoutT3 = 2000;
+    benchSessions[idx].settings.timeoutT4 = 10000;
+    benchSessions[idx].settings.timeoutT5 = 1000;
+    benchSessions[idx].settings.timeoutT6 = 50;
+    benchSessions[idx].settings.timeoutT7 = 2000;
+    benchSessions[idx].settings.transport = XcpTpCanGetTransport();
+    benchSessions[idx].settings.transportSettings = &benchSessions[idx].tpSettings;
+    benchSessions[idx].data = &data[idx * BENCH_DATA_SIZE];
+    benchSessions[idx].handle = SessionInit(XcpLoaderGetProtocol(),
+                                            &benchSessions[idx].settings);
+    if (benchSessions[idx].handle == NULL)
+    {
+      result = false;
+    }
+  }
+  /* Attach the simulated targets to the virtual CAN bus. */
+  if ( (result) && (!SimTargetInit(count, &simSettings)) )
+  {
+    result = false;
+  }
+
+  /* Run the sessions concurrently. */
+  if (result)
+  {
+    startTime = UtilTimeGetMonotonicUs();
+    for (idx = 0; idx < count; idx++)
+    {
+      threads[idx] = UtilThreadCreate(RunSession, &benchSessions[idx]);
+      if (threads[idx] == NULL)
+      {
+        /* Run the session from this thread instead. */
+        RunSession(&benchSessions[idx]);
+      }
+    }
+    for (idx = 0; idx < count; idx++)
+    {
+      if (threads[idx] != NULL)
+      {
+        UtilThreadJoin(threads[idx]);
+      }
+    }
+    wallTime = UtilTimeGetMonotonicUs() - startTime;
+
+    /* Collect the results and check the flash memory of the simulated targets. */
+    memset(&latency, 0, sizeof(latency));
+    for (idx = 0; idx < count; idx++)
+    {
+      if ( (!benchSessions[idx].ok) ||
+           (!XcpSimReadMemory(SimTargetGetSim(idx), BENCH_FLASH_ADDRESS,
+                              BENCH_DATA_SIZE, check)) ||
+           (memcmp(check, benchSessions[idx].data, BENCH_DATA_SIZE) != 0) )
+      {
+        result = false;
+      }
+      sessionTime += benchSessions[idx].time;
+      if (SessionGetLatency(benchSessions[idx].handle, &sessionLatency))
+      {
+        latency.count += sessionLatency.count;
+        latency.totalTime += sessionLatency.totalTime;
+        latency.wireTime += sessionLatency.wireTime;
+        if (sessionLatency.totalMax > latency.totalMax)
+        {
+          latency.totalMax = sessionLatency.totalMax;
+        }
+        for (bucket = 0; bucket < SESSION_LATENCY_BUCKETS; bucket++)
+        {
+          latency.histogram[bucket] += sessionLatency.histogram[bucket];
+        }
+      }
+    }
+    if (wallTime == 0)
+    {
+      wallTime = 1;
+    }
+    if (sessionTime == 0)
+    {
+      sessionTime = 1;
+    }
+    /* 1 byte per microsecond is 1000 kB/s. The per-session throughput is based on
+     * the average duration of the sessions.
+     */
+    printf("%-8u %-6s %10.1f %12.1f %10.1f %10u %10u\n", (unsigned int)count,
+           result ? "OK" : "FAIL", (double)wallTime / 1000.0,
+           ((double)count * BENCH_DATA_SIZE * 1000.0) / (double)wallTime,
+           ((double)count * BENCH_DATA_SIZE * 1000.0) / (double)sessionTime,
+           (latency.count > 0) ? (unsigned int)(latency.totalTime / latency.count) : 0u,
+           (unsigned int)latency.totalMax);
+  }
+  else
+  {
+    printf("%-8u %-6s\n", (unsigned int)count, "SETUP");
+  }
+
+  /* Detach the simulated targets before the last session removes the virtual CAN bus.
+   * This is also fine if they were not attached.
+   */
+  SimTargetTerminate();
+  for (idx = 0; idx < count; idx++)
+  {
+    if (benchSessions[idx].handle != NULL)
+    {
+      SessionTerminate(benchSessions[idx].handle);
+      benchSessions[idx].handle = NULL;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of RunBench ***/
+
+
+/************************************************************************************//**
+** \brief     Thread function that runs one programming session: connect, erase,
+**            program and disconnect.
+** \param     arg Pointer to the tBenchSession of the session.
+**
+****************************************************************************************/
+static void RunSession(void * arg)
+{
+  tBenchSession * session = arg;
+  uint64_t startTime;
+
+  startTime = UtilTimeGetMonotonicUs();
+  session->ok = SessionStart(session->handle);
+  if (session->ok)
+  {
+    session->ok = (SessionClearMemory(session->handle, BENCH_FLASH_ADDRESS,
+                                      BENCH_DATA_SIZE)) &&
+                  (SessionWriteData(session->handle, BENCH_FLASH_ADDRESS,
+                                    BENCH_DATA_SIZE, session->data));
+    /* Always end the session that was started. */
+    if (!SessionStop(session->handle))
+    {
+      session->ok = false;
+    }
+  }
+  session->time = UtilTimeGetMonotonicUs() - startTime;
+} /*** end of RunSession ***/
+
+
+/******************************* end of cancontention.c ********************************/
@@ -0,0 +1,421 @@
+/************************************************************************************//**
+* \file         canframecheck.c
+* \brief        Concurrent CAN transmission check program source file.
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+*
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+*
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+*
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include <stdint.h>                         /* for standard integer types              */
+#include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
+#include <stdio.h>                          /* Standard I/O functions.                 */
+#include <string.h>                         /* for string library                      */
+#include "util.h"                           /* Utility module                          */
+#include "candriver.h"                      /* Generic CAN driver module               */
+#include "canloopback.h"                    /* Loopback CAN interface                  */
+
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Program return code indicating that all frames were received correctly. */
+#define RESULT_OK                           (0)
+/** \brief Program return code indicating that a frame was lost, corrupted or received
+ *         out of order.
+ */
+#define RESULT_ERROR_FRAME                  (1)
+/** \brief Program return code indicating that the check could not be set up. */
+#define RESULT_ERROR_SETUP                  (2)
+
+/** \brief Number of concurrent sessions, that each transmit from their own thread. */
+#define CHECK_SESSIONS_MAX                  (8u)
+/** \brief Default number of CAN frames that each session transmits. */
+#define CHECK_FRAMES_DEFAULT                (1000u)
+/** \brief CAN identifier of the frames of the first session. Session n uses this
+ *         identifier plus n.
+ */
+#define CHECK_BASE_ID                       (0x100u)
+/** \brief Maximum time in milliseconds to wait for frames that are still on their way,
+ *         once all sessions are done. This is only needed with bus latency.
+ */
+#define CHECK_DRAIN_TIMEOUT_MS              (1000u)
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief State of one session of the check. */
+typedef struct t_check_session
+{
+  uint32_t index;                  /**< Zero based index of the session.               */
+  uint32_t frameCount;             /**< Number of frames to transmit.                  */
+  uint32_t txCount;                /**< Number of frames that were transmitted.        */
+  uint32_t rxCount;                /**< Number of frames that were received correctly. */
+  bool initialized;                /**< True if the session uses the CAN driver.       */
+} tCheckSession;
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+static bool RunCheck(char const * device, uint32_t frameCount);
+static void RunSession(void * arg);
+static void BuildFrame(uint32_t index, uint32_t seqNr, tCanMsg * msg);
+static void CheckMessageReceived(tCanMsg const * msg);
+static bool CheckAllReceived(void);
+
+
+/****************************************************************************************
+* Local constant declarations
+****************************************************************************************/
+/** \brief Devices for which the check runs, if no device is specified. Without bitrate
+ *         emulation the frames of the sessions are delivered in the context of the
+ *         transmitting threads, so they race with each other. With bitrate emulation
+ *         they are also interleaved on the bus.
+ */
+static char const * const checkDevicesDefault[] =
+{
+  "loopback:bitrate=0", "loopback"
+};
+
+/** \brief Event functions of the endpoint that checks the frames on the bus. */
+static const tCanEvents checkEvents =
+{
+  NULL,
+  CheckMessageReceived
+};
+
+
+/****************************************************************************************
+* Local data declarations
+****************************************************************************************/
+/** \brief The sessions. */
+static tCheckSession checkSessions[CHECK_SESSIONS_MAX];
+
+/** \brief Number of frames that were received with an unknown identifier, a wrong
+ *         length or wrong data, or out of order.
+ */
+static uint32_t checkErrorCount;
+
+/** \brief Critical section object that protects the reception counters, because the
+ *         frames are received in the context of different threads.
+ */
+static tUtilCriticalSection checkCritSect;
+
+
+/************************************************************************************//**
+** \brief     This is the program entry point. It runs multiple sessions that share the
+**            CAN interface of the CAN driver and transmit CAN frames at the same time,
+**            each from its own thread. Another endpoint on the in-process loopback CAN
+**            bus receives the frames and checks the identifier, length, data and order
+**            of every one of them. Without a device argument, the check runs once
+**            without and once with bitrate emulation on the loopback CAN bus.
+** \param     argc Number of program arguments.
+** \param     argv Array with program arguments. The optional first argument is the
+**            device name, such as "loopback:bitrate=0". The optional second argument
+**            is the number of frames that each session transmits.
+** \return    Program return code.
+**
+****************************************************************************************/
+int main(int argc, char const * const argv[])
+{
+  int result = RESULT_OK;
+  char const * const * devices = checkDevicesDefault;
+  uint32_t deviceCount = sizeof(checkDevicesDefault) / sizeof(checkDevicesDefault[0]);
+  uint32_t frameCount = CHECK_FRAMES_DEFAULT;
+  uint32_t devIdx;
+
+  /* Process the optional program arguments. */
+  if (argc > 1)
+  {
+    devices = &argv[1];
+    deviceCount = 1;
+  }
+  if (argc > 2)
+  {
+    frameCount = (uint32_t)strtoul(argv[2], NULL, 10);
+  }
+
+  checkCritSect = UtilCriticalSectionCreate();
+  if (checkCritSect == NULL)
+  {
+    printf("[ERROR] Could not create critical section.\n");
+    result = RESULT_ERROR_SETUP;
+  }
+  else
+  {
+    printf("%-24s %-6s %8s %10s %10s %8s\n", "Device", "Result", "Sessions", "Sent",
+           "Received", "Errors");
+    for (devIdx = 0; devIdx < deviceCount; devIdx++)
+    {
+      if (!RunCheck(devices[devIdx], frameCount))
+      {
+        result = RESULT_ERROR_FRAME;
+      }
+      (void)fflush(stdout);
+    }
+    UtilCriticalSectionDestroy(checkCritSect);
+  }
+  return result;
+} /*** end of main ***/
+
+
+/************************************************************************************//**
+** \brief     Runs the check on a device and reports the results as one line of the
+**            table.
+** \param     device CAN device name.
+** \param     frameCount Number of frames that each session transmits.
+** \return    True if all frames were transmitted and received correctly, false
+**            otherwise.
+**
+****************************************************************************************/
+static bool RunCheck(char const * device, uint32_t frameCount)
+{
+  bool result = true;
+  tCanSettings settings;
+  tCanLoopbackEndpoint endpoint = NULL;
+  tUtilThread threads[CHECK_SESSIONS_MAX];
+  uint32_t txTotal = 0;
+  uint32_t rxTotal = 0;
+  uint64_t deadline;
+  uint32_t idx;
+
+  /* All sessions share the CAN interface, so they use the same settings. */
+  memset(&settings, 0, sizeof(settings));
+  settings.devicename = device;
+  settings.baudrate = CAN_BR500K;
+  checkErrorCount = 0;
+
+  /* Initialize the sessions. The first one creates the virtual CAN bus. */
+  for (idx = 0; idx < CHECK_SESSIONS_MAX; idx++)
+  {
+    memset(&checkSessions[idx], 0, sizeof(checkSessions[idx]));
+    checkSessions[idx].index = idx;
+    checkSessions[idx].frameCount = frameCount;
+    if ( (result) && (CanInit(&settings)) )
+    {
+      checkSessions[idx].initialized = true;
+      result = CanConnect();
+    }
+    else
+    {
+      result = false;
+    }
+  }
+  /* Attach the endpoint that checks the frames to the virtual CAN bus. */
+  if (result)
+  {
+    endpoint = CanLoopbackEndpointAttach(&checkEvents);
+    result = (endpoint != NULL);
+  }
+
+  /* Run the sessions concurrently. */
+  if (result)
+  {
+    for (idx = 0; idx < CHECK_SESSIONS_MAX; idx++)
+    {
+      threads[idx] = UtilThreadCreate(RunSession, &checkSessions[idx]);
+      if (threads[idx] == NULL)
+      {
+        /* Run the session from this thread instead. */
+        RunSession(&checkSessions[idx]);
+      }
+    }
+    for (idx = 0; idx < CHECK_SESSIONS_MAX; idx++)
+    {
+      if (threads[idx] != NULL)
+      {
+        UtilThreadJoin(threads[idx]);
+      }
+    }
+    /* With bus latency, the last frames can still be on their way. */
+    deadline = UtilTimeDeadlineUs((uint64_t)CHECK_DRAIN_TIMEOUT_MS * 1000u);
+    while ( (!CheckAllReceived()) && (!UtilTimeDeadlineExpired(deadline)) )
+    {
+      UtilTimeDelayMs(1);
+    }
+    /* Collect the results. */
+    UtilCriticalSectionLock(checkCritSect);
+    for (idx = 0; idx < CHECK_SESSIONS_MAX; idx++)
+    {
+      txTotal += checkSessions[idx].txCount;
+      rxTotal += checkSessions[idx].rxCount;
+      if ( (checkSessions[idx].txCount != frameCount) ||
+           (checkSessions[idx].rxCount != frameCount) )
+      {
+        result = false;
+      }
+    }
+    if (checkErrorCount > 0)
+    {
+      result = false;
+    }
+    printf("%-24s %-6s %8u %10u %10u %8u\n", device, result ? "OK" : "FAIL",
+           (unsigned int)CHECK_SESSIONS_MAX, (unsigned int)txTotal,
+           (unsigned int)rxTotal, (unsigned int)checkErrorCount);
+    UtilCriticalSectionUnlock(checkCritSect);
+  }
+  else
+  {
+    printf("%-24s %-6s\n", device, "SETUP");
+  }
+
+  /* Detach the endpoint before the last session removes the virtual CAN bus. */
+  if (endpoint != NULL)
+  {
+    CanLoopbackEndpointDetach(endpoint);
+  }
+  for (idx = 0; idx < CHECK_SESSIONS_MAX; idx++)
+  {
+    if (checkSessions[idx].initialized)
+    {
+      CanDisconnect();
+      CanTerminate();
+      checkSessions[idx].initialized = false;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of RunCheck ***/
+
+
+/************************************************************************************//**
+** \brief     Thread function that runs one session. It transmits its frames one after
+**            the other, as fast as the CAN driver accepts them.
+** \param     arg Pointer to the tCheckSession of the session.
+**
+****************************************************************************************/
+static void RunSession(void * arg)
+{
+  tCheckSession * session = arg;
+  tCanMsg msg;
+  uint32_t seqNr;
+
+  for (seqNr = 0; seqNr < session->frameCount; seqNr++)
+  {
+    BuildFrame(session->index, seqNr, &msg);
+    if (!CanTransmit(&msg))
+    {
+      break;
+    }
+    UtilCriticalSectionLock(checkCritSect);
+    session->txCount++;
+    UtilCriticalSectionUnlock(checkCritSect);
+  }
+} /*** end of RunSession ***/
+
+
+/************************************************************************************//**
+** \brief     Builds a frame of a session. The length and the data of the frame depend on
+**            the session and on the sequence number of the frame, so that a receiver can
+**            verify both.
+** \param     index Zero based index of the session.
+** \param     seqNr Zero based sequence number of the frame within the session.
+** \param     msg Pointer to the CAN message to build.
+**
+****************************************************************************************/
+static void BuildFrame(uint32_t index, uint32_t seqNr, tCanMsg * msg)
+{
+  uint8_t idx;
+
+  memset(msg, 0, sizeof(*msg));
+  msg->id = CHECK_BASE_ID + index;
+  msg->dlc = (uint8_t)(seqNr % (CAN_MSG_MAX_LEN + 1u));
+  for (idx = 0; idx < msg->dlc; idx++)
+  {
+    msg->data[idx] = (uint8_t)((seqNr * 31u) + (index * 7u) + idx + (seqNr >> 8));
+  }
+} /*** end of BuildFrame ***/
+
+
+/************************************************************************************//**
+** \brief     Event function of the endpoint that checks the frames on the bus. A frame
+**            must be the next one of its session, with exactly the length and data that
+**            the session transmitted.
+** \param     msg Pointer to the received CAN message.
+**
+****************************************************************************************/
+static void CheckMessageReceived(tCanMsg const * msg)
+{
+  tCanMsg expected;
+  uint32_t index;
+
+  UtilCriticalSectionLock(checkCritSect);
+  index = msg->id - CHECK_BASE_ID;
+  if ( (msg->id < CHECK_BASE_ID) || (index >= CHECK_SESSIONS_MAX) )
+  {
+    checkErrorCount++;
+  }
+  else
+  {
+    BuildFrame(index, checkSessions[index].rxCount, &expected);
+    if ( (msg->dlc != expected.dlc) ||
+         (memcmp(msg->data, expected.data, expected.dlc) != 0) )
+    {
+      checkErrorCount++;
+    }
+    else
+    {
+      checkSessions[index].rxCount++;
+    }
+  }
+  UtilCriticalSectionUnlock(checkCritSect);
+} /*** end of CheckMessageReceived ***/
+
+
+/************************************************************************************//**
+** \brief     Determines if the checking endpoint received all frames that the sessions
+**            transmitted, or if a frame was wrong, such that no more are expected.
+** \return    True if no more frames are expected, false otherwise.
+**
+****************************************************************************************/
+static bool CheckAllReceived(void)
+{
+  bool result;
+  uint32_t idx;
+
+  UtilCriticalSectionLock(checkCritSect);
+  result = (checkErrorCount > 0);
+  for (idx = 0; (!result) && (idx < CHECK_SESSIONS_MAX); idx++)
+  {
+    if (checkSessions[idx].rxCount < checkSessions[idx].txCount)
+    {
+      break;
+    }
+  }
+  if (idx == CHECK_SESSIONS_MAX)
+  {
+    result = true;
+  }
+  UtilCriticalSectionUnlock(checkCritSect);
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of CheckAllReceived ***/
+
+
+/******************************* end of canframecheck.c ********************************/
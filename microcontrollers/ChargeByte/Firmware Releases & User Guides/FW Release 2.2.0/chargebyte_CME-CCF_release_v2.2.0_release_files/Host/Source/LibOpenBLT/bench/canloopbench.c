@@ -0,0 +1,289 @@
+/************************************************************************************//**
+* \file         canloopbench.c
+* \brief        Loopback CAN bus benchmark program source file.
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+*
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+*
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+*
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include <stdint.h>                         /* for standard integer types              */
+#include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
+#include <stdio.h>                          /* Standard I/O functions.                 */
+#include <string.h>                         /* for string library                      */
+#include "util.h"                           /* Utility module                          */
+#include "candriver.h"                      /* Generic CAN driver module               */
+#include "session.h"                        /* Communication session module            */
+#include "xcploader.h"                      /* XCP loader module                       */
+#include "xcptpcan.h"                       /* XCP CAN transport layer                 */
+#include "xcpsim.h"                         /* XCP target simulation                   */
+#include "simtarget.h"                      /* Simulated targets on the loopback bus   */
+
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Program return code indicating that all profiles passed. */
+#define RESULT_OK                           (0)
+/** \brief Program return code indicating that a session failed or that the programmed
+ *         data did not match.
+ */
+#define RESULT_ERROR_SESSION                (1)
+/** \brief Program return code indicating that memory could not be allocated. */
+#define RESULT_ERROR_MEMORY                 (2)
+
+/** \brief Default number of bytes that are programmed for each profile. */
+#define BENCH_DATA_SIZE_DEFAULT             (8192u)
+/** \brief Default CAN baudrate in bits/sec, if a device is specified. */
+#define BENCH_BAUDRATE_DEFAULT              (500000u)
+/** \brief Start address of the flash memory of the simulated target. */
+#define BENCH_FLASH_ADDRESS                 (0x00010000u)
+/** \brief Sector size of the flash memory of the simulated target. */
+#define BENCH_FLASH_SECTOR_SIZE             (1024u)
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Profile of the virtual CAN bus. */
+typedef struct t_bench_profile
+{
+  char const * name;               /**< Name of the profile in the table.              */
+  char const * device;             /**< Device name with the options of the bus.       */
+  uint32_t baudrate;               /**< CAN baudrate in bits/sec.                      */
+} tBenchProfile;
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+static bool RunProfile(tBenchProfile const * profile, uint8_t const * data,
+                       uint32_t size);
+
+
+/****************************************************************************************
+* Local constant declarations
+****************************************************************************************/
+/** \brief Profiles of the virtual CAN bus for which the benchmark runs. */
+static const tBenchProfile benchProfiles[] =
+{
+  { "host",       "loopback:bitrate=0",              1000000u },
+  { "1M",         "loopback",                        1000000u },
+  { "500k",       "loopback",                         500000u },
+  { "250k",       "loopback",                         250000u },
+  { "500k+200us", "loopback:latency=200",             500000u },
+  { "500k+1ms",   "loopback:latency=1000",            500000u }
+};
+
+
+
+/************************************************************************************//**
+** \brief     This is the program entry point. It programs a simulated target on the
+**            in-process loopback CAN bus, once for each profile of the bus, through the
+**            complete CAN stack of LibOpenBLT. For each profile it reports the
+**            throughput and the command/response latency. No CAN hardware or kernel
+**            configuration is needed and the bus timing is emulated, so the program
+**            can run as part of a CI pipeline. It fails if a session fails or if the
+**            flash memory of the simulated target does not hold the programmed data.
+** \param     argc Number of program arguments.
+** \param     argv Array with program arguments. The optional first argument is the
+**            device name, such as "loopback:latency=200", to run only that profile.
+**            The optional second argument is the baudrate in bits/sec for that
+**            profile. The optional third argument is the number of bytes to program.
+** \return    Program return code.
+**
+****************************************************************************************/
+int main(int argc, char const * const argv[])
+{
+  int result = RESULT_OK;
+  tBenchProfile const * profiles = benchProfiles;
+  uint32_t profileCount = sizeof(benchProfiles) / sizeof(benchProfiles[0]);
+  tBenchProfile customProfile;
+  uint32_t size = BENCH_DATA_SIZE_DEFAULT;
+  uint8_t * data;
+  uint32_t idx;
+
+  /* Process the optional program arguments. */
+  if (argc > 1)
+  {
+    customProfile.name = "custom";
+    customProfile.device = argv[1];
+    customProfile.baudrate = BENCH_BAUDRATE_DEFAULT;
+    if (argc > 2)
+    {
+      customProfile.baudrate = (uint32_t)strtoul(argv[2], NULL, 10);
+    }
+    profiles = &customProfile;
+    profileCount = 1;
+  }
+  if (argc > 3)
+  {
+    size = (uint32_t)strtoul(argv[3], NULL, 10);
+    if (size == 0)
+    {
+      size = BENCH_DATA_SIZE_DEFAULT;
+    }
+  }
+
+  data = malloc(size);
+  if (data == NULL)
+  {
+    printf("[ERROR] Could not allocate memory.\n");
+    result = RESULT_ERROR_MEMORY;
+  }
+  else
+  {
+    /* Prepare pseudo random test data. */
+    srand(1);
+    for (idx = 0; idx < size; idx++)
+    {
+      data[idx] = (uint8_t)rand();
+    }
+    printf("%u bytes per profile\n", (unsigned int)size);
+    printf("%-11s %-6s %10s %9s %9s %9s %9s %9s\n", "Profile", "Result", "Time [ms]",
+           "[kB/s]", "Avg [us]", "P99 [us]", "Max [us]", "Commands");
+    for (idx = 0; idx < profileCount; idx++)
+    {
+      if (!RunProfile(&profiles[idx], data, size))
+      {
+        result = RESULT_ERROR_SESSION;
+      }
+      (void)fflush(stdout);
+    }
+  }
+  free(data);
+  return result;
+} /*** end of main ***/
+
+
+/************************************************************************************//**
+** \brief     Programs the simulated target on a virtual CAN bus with the specified
+**            profile and reports the results as one line of the table.
+** \param     profile The profile of the virtual CAN bus.
+** \param     data Test data.
+** \param     size Number of bytes of test data.
+** \return    True if the session succeeded and programmed the correct data, false
+**            otherwise.
+**
+****************************************************************************************/
+static bool RunProfile(tBenchProfile const * profile, uint8_t const * data,
+                       uint32_t size)
+{
+  bool result = false;
+  tXcpSimRegion flashRegion;
+  tXcpSimSettings simSettings;
+  tXcpTpCanSettings tpSettings;
+  tXcpLoaderSettings settings;
+  tSessionHandle session;
+  tSessionLatency latency;
+  tXcpSimStats stats;
+  uint8_t * check;
+  uint64_t startTime;
+  uint64_t time = 1;
+
+  /* Configure the simulated target without flash timing, so that only the
+   * communication is measured.
+   */
+  flashRegion.address = BENCH_FLASH_ADDRESS;
+  flashRegion.sectorSize = BENCH_FLASH_SECTOR_SIZE;
+  flashRegion.sectorCount = (size + BENCH_FLASH_SECTOR_SIZE - 1u) /
+                            BENCH_FLASH_SECTOR_SIZE;
+  memset(&simSettings, 0, sizeof(simSettings));
+  simSettings.regions = &flashRegion;
+  simSettings.regionCount = 1;
+  simSettings.maxCto = CAN_MSG_MAX_LEN;
+  simSettings.maxDto = CAN_MSG_MAX_LEN;
+  simSettings.faultSeed = 1;
+  /* Configure the session. */
+  memset(&tpSettings, 0, sizeof(tpSettings));
+  tpSettings.device = profile->device;
+  tpSettings.baudrate = profile->baudrate;
+  tpSettings.transmitId = SIM_TARGET_COMMAND_ID;
+  tpSettings.receiveId = SIM_TARGET_RESPONSE_ID;
+  memset(&settings, 0, sizeof(settings));
+  settings.timeoutT1 = 1000;
+  settings.timeoutT3 = 2000;
+  settings.timeoutT4 = 10000;
+  settings.timeoutT5 = 1000;
+  settings.timeoutT6 = 50;
+  settings.timeoutT7 = 2000;
+  settings.transport = XcpTpCanGetTransport();
+  settings.transportSettings = &tpSettings;
+  memset(&latency, 0, sizeof(latency));
+  memset(&stats, 0, sizeof(stats));
+
+  /* Initialize the session, which creates the virtual CAN bus, and attach the
+   * simulated target to it.
+   */
+  check = malloc(size);
+  session = (check != NULL) ? SessionInit(XcpLoaderGetProtocol(), &settings) : NULL;
+  if (session != NULL)
+  {
+    if (SimTargetInit(1, &simSettings))
+    {
+      /* Program the simulated target. */
+      startTime = UtilTimeGetMonotonicUs();
+      if (SessionStart(session))
+      {
+        result = (SessionClearMemory(session, BENCH_FLASH_ADDRESS, size)) &&
+                 (SessionWriteData(session, BENCH_FLASH_ADDRESS, size, data));
+        /* Always end the session that was started. */
+        if (!SessionStop(session))
+        {
+          result = false;
+        }
+      }
+      time += UtilTimeGetMonotonicUs() - startTime;
+      /* Check the flash memory of the simulated target. */
+      if ( (result) &&
+           ( (!XcpSimReadMemory(SimTargetGetSim(0), BENCH_FLASH_ADDRESS, size, check)) ||
+             (memcmp(check, data, size) != 0) ) )
+      {
+        result = false;
+      }
+      XcpSimGetStats(SimTargetGetSim(0), &stats);
+      (void)SessionGetLatency(session, &latency);
+      /* Detach the simulated target before the session removes the virtual CAN bus. */
+      SimTargetTerminate();
+    }
+    SessionTerminate(session);
+  }
+  free(check);
+
+  /* 1 byte per microsecond is 1000 kB/s. */
+  printf("%-11s %-6s %10.1f %9.1f %9u %9u %9u %9u\n", profile->name,
+         result ? "OK" : "FAIL", (double)time / 1000.0,
+         ((double)size * 1000.0) / (double)time,
+         (latency.count > 0) ? (unsigned int)(latency.totalTime / latency.count) : 0u,
+         (unsigned int)SessionLatencyGetPercentile(&latency, 99),
+         (unsigned int)latency.totalMax, (unsigned int)stats.commands);
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of RunProfile ***/
+
+
+/******************************** end of canloopbench.c ********************************/
@@ -0,0 +1,277 @@
+/************************************************************************************//**
+* \file         crcbench.c
+* \brief        CRC checksum benchmark program source file.
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+*
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+*
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+*
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include <stdint.h>                         /* for standard integer types              */
+#include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
+#include <stdio.h>                          /* Standard I/O functions.                 */
+#include <string.h>                         /* for string library                      */
+#include <time.h>                           /* for clock                               */
+#include "util.h"                           /* Utility module                          */
+
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Program return code indicating that all kernels passed. */
+#define RESULT_OK                           (0)
+/** \brief Program return code indicating that a kernel produced wrong results. */
+#define RESULT_ERROR_MISMATCH               (1)
+/** \brief Program return code indicating that memory could not be allocated. */
+#define RESULT_ERROR_MEMORY                 (2)
+
+/** \brief Size of the benchmark buffer in bytes. It is the largest measured size. */
+#define BENCH_SIZE_MAX                      (1048576u)
+/** \brief Minimum processor time in seconds that each measurement runs. */
+#define BENCH_MIN_SECONDS                   (0.2)
+/** \brief Size of the cross-check buffer in bytes. */
+#define CHECK_SIZE                          (4096u)
+/** \brief Number of different start offsets in the cross-check buffer. This checks that
+ *         the kernels do not depend on the alignment of the data.
+ */
+#define CHECK_OFFSETS                       (16u)
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+static bool CheckKernel(uint8_t kernel, uint8_t const * data);
+static double MeasureKernel(uint8_t kernel, uint8_t const * data, uint32_t len,
+                            bool crc32);
+
+
+/****************************************************************************************
+* Local constant declarations
+****************************************************************************************/
+/** \brief Names of the checksum kernels, indexed by UTIL_CHECKSUM_KERNEL_xxx. */
+static const char * const kernelNames[] =
+{
+  "auto", "byte", "slice8", "clmul"
+};
+
+/** \brief Buffer sizes in bytes for which the throughput is measured. */
+static const uint32_t benchSizes[] =
+{
+  16u, 64u, 256u, 1024u, 4096u, 65536u, BENCH_SIZE_MAX
+};
+
+/** \brief The 9 ASCII digits "123456789", which are the input of the standard check
+ *         value of a CRC algorithm.
+ */
+static const uint8_t checkInput[9] =
+{
+  '1', '2', '3', '4', '5', '6', '7', '8', '9'
+};
+
+
+/************************************************************************************//**
+** \brief     This is the program entry point. It checks each checksum kernel that the
+**            CPU supports against the byte-oriented kernel, for all lengths and
+**            alignments of the cross-check buffer. Afterwards it reports the CRC16 and
+**            CRC32 throughput of each kernel for a range of buffer sizes.
+** \param     argc Number of program arguments.
+** \param     argv Array with program arguments.
+** \return    Program return code.
+**
+****************************************************************************************/
+int main(int argc, char const * const argv[])
+{
+  int result = RESULT_OK;
+  uint8_t * buffer;
+  uint8_t kernel;
+  uint32_t sizeIdx;
+  bool supported[UTIL_CHECKSUM_KERNEL_CLMUL + 1u];
+
+  /* The program has no parameters. */
+  (void)argc;
+  (void)argv;
+
+  buffer = malloc(BENCH_SIZE_MAX);
+  if (buffer == NULL)
+  {
+    printf("[ERROR] Could not allocate memory.\n");
+    result = RESULT_ERROR_MEMORY;
+  }
+  else
+  {
+    /* Prepare pseudo random test data. */
+    srand(1);
+    for (uint32_t i = 0; i < BENCH_SIZE_MAX; i++)
+    {
+      buffer[i] = (uint8_t)rand();
+    }
+    /* Report the standard check values, calculated with the byte-oriented kernel,
+     * which is the original implementation.
+     */
+    printf("Check values: CRC16 0x%04X, CRC32 0x%08X\n",
+           UtilChecksumCrc16CalculateKernel(checkInput, sizeof(checkInput),
+                                            UTIL_CHECKSUM_KERNEL_BYTE),
+           UtilChecksumCrc32CalculateKernel(checkInput, sizeof(checkInput),
+                                            UTIL_CHECKSUM_KERNEL_BYTE));
+    printf("%-8s %-6s\n", "Kernel", "Check");
+    for (kernel = UTIL_CHECKSUM_KERNEL_BYTE; kernel <= UTIL_CHECKSUM_KERNEL_CLMUL;
+         kernel++)
+    {
+      supported[kernel] = UtilChecksumKernelSupported(kernel);
+      if (!supported[kernel])
+      {
+        printf("%-8s %-6s\n", kernelNames[kernel], "N/A");
+      }
+      else if (!CheckKernel(kernel, buffer))
+      {
+        printf("%-8s %-6s\n", kernelNames[kernel], "FAIL");
+        supported[kernel] = false;
+        result = RESULT_ERROR_MISMATCH;
+      }
+      else
+      {
+        printf("%-8s %-6s\n", kernelNames[kernel], "OK");
+      }
+    }
+    /* Report the throughput of each kernel that passed, per buffer size. */
+    printf("\n%-8s %-8s", "CRC", "Size");
+    for (kernel = UTIL_CHECKSUM_KERNEL_BYTE; kernel <= UTIL_CHECKSUM_KERNEL_CLMUL;
+         kernel++)
+    {
+      printf(" %9s", kernelNames[kernel]);
+    }
+    printf("   [MB/s]\n");
+    for (uint32_t crcIdx = 0; crcIdx < 2u; crcIdx++)
+    {
+      for (sizeIdx = 0; sizeIdx < (sizeof(benchSizes) / sizeof(benchSizes[0]));
+           sizeIdx++)
+      {
+        printf("%-8s %-8u", (crcIdx == 0) ? "CRC16" : "CRC32",
+               (unsigned int)benchSizes[sizeIdx]);
+        for (kernel = UTIL_CHECKSUM_KERNEL_BYTE; kernel <= UTIL_CHECKSUM_KERNEL_CLMUL;
+             kernel++)
+        {
+          if (!supported[kernel])
+          {
+            printf(" %9s", "-");
+          }
+          else
+          {
+            printf(" %9.1f", MeasureKernel(kernel, buffer, benchSizes[sizeIdx],
+                                           crcIdx != 0));
+          }
+          (void)fflush(stdout);
+        }
+        printf("\n");
+      }
+    }
+  }
+  free(buffer);
+  return result;
+} /*** end of main ***/
+
+
+/************************************************************************************//**
+** \brief     Checks that a kernel calculates the same CRC16 and CRC32 values as the
+**            byte-oriented kernel, for each length of the cross-check buffer and for a
+**            number of different start offsets.
+** \param     kernel The kernel to check.
+** \param     data The test data. It holds at least CHECK_SIZE + CHECK_OFFSETS bytes.
+** \return    True if the kernel produced the correct results, false otherwise.
+**
+****************************************************************************************/
+static bool CheckKernel(uint8_t kernel, uint8_t const * data)
+{
+  bool result = true;
+  uint32_t offset;
+  uint32_t len;
+
+  for (offset = 0; offset < CHECK_OFFSETS; offset++)
+  {
+    for (len = 1; len <= CHECK_SIZE; len++)
+    {
+      if ( (UtilChecksumCrc16CalculateKernel(&data[offset], len, kernel) !=
+            UtilChecksumCrc16CalculateKernel(&data[offset], len,
+                                             UTIL_CHECKSUM_KERNEL_BYTE)) ||
+           (UtilChecksumCrc32CalculateKernel(&data[offset], len, kernel) !=
+            UtilChecksumCrc32CalculateKernel(&data[offset], len,
+                                             UTIL_CHECKSUM_KERNEL_BYTE)) )
+      {
+        result = false;
+      }
+    }
+  }
+  return result;
+} /*** end of CheckKernel ***/
+
+
+/************************************************************************************//**
+** \brief     Measures the throughput of a kernel. The CRC is calculated over the first
+**            len bytes of the buffer repeatedly, until the minimum measurement time
+**            elapsed.
+** \param     kernel The kernel to measure.
+** \param     data Buffer with the data.
+** \param     len Number of bytes to calculate the CRC over.
+** \param     crc32 True to measure the CRC32 calculation, false for CRC16.
+** \return    Throughput in megabytes (10^6 bytes) per second.
+**
+****************************************************************************************/
+static double MeasureKernel(uint8_t kernel, uint8_t const * data, uint32_t len,
+                            bool crc32)
+{
+  uint32_t rounds = 0;
+  uint32_t idx;
+  /* Accumulate the results, so that the compiler cannot leave out the calculations. */
+  volatile uint32_t sink = 0;
+  clock_t start;
+  double seconds;
+
+  start = clock();
+  do
+  {
+    /* Check the time only once per megabyte, because clock() itself is not free. */
+    for (idx = 0; idx < (BENCH_SIZE_MAX / len); idx++)
+    {
+      if (crc32)
+      {
+        sink ^= UtilChecksumCrc32CalculateKernel(data, len, kernel);
+      }
+      else
+      {
+        sink ^= UtilChecksumCrc16CalculateKernel(data, len, kernel);
+      }
+    }
+    rounds += idx;
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+  }
+  while (seconds < BENCH_MIN_SECONDS);
+  (void)sink;
+  return ((double)rounds * len) / (seconds * 1000000.0);
+} /*** end of MeasureKernel ***/
+
+
+/*********************************** end of crcbench.c *********************************/
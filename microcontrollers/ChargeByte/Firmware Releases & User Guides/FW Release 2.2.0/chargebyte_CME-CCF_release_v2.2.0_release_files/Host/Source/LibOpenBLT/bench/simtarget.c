@@ -0,0 +1,197 @@
+/************************************************************************************//**
+* \file         simtarget.c
+* \brief        Simulated targets on the loopback CAN bus source file.
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+*
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+*
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+*
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include <assert.h>                         /* for assertions                          */
+#include <stdint.h>                         /* for standard integer types              */
+#include <stddef.h>                         /* for NULL declaration                    */
+#include <stdbool.h>                        /* for boolean type                        */
+#include <string.h>                         /* for string library                      */
+#include "candriver.h"                      /* Generic CAN driver module               */
+#include "canloopback.h"                    /* Loopback CAN interface                  */
+#include "xcpsim.h"                         /* XCP target simulation                   */
+#include "simtarget.h"                      /* Simulated targets on the loopback bus   */
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+static void SimTargetMessageReceived(tCanMsg const * msg);
+
+
+/****************************************************************************************
+* Local constant declarations
+****************************************************************************************/
+/** \brief Event functions of the endpoint of the simulated targets. */
+static const tCanEvents simTargetEvents =
+{
+  NULL,
+  SimTargetMessageReceived
+};
+
+
+/****************************************************************************************
+* Local data declarations
+****************************************************************************************/
+/** \brief Endpoint on the loopback CAN bus that all simulated targets share. */
+static tCanLoopbackEndpoint simTargetEndpoint;
+
+/** \brief The simulated targets. */
+static tXcpSimHandle simTargets[SIM_TARGET_COUNT_MAX];
+
+/** \brief Number of simulated targets. */
+static uint32_t simTargetCount;
+
+
+/************************************************************************************//**
+** \brief     Creates the simulated targets and attaches them to the loopback CAN bus.
+**            The loopback CAN bus only exists while the CAN driver is initialized, so
+**            at least one session on it must already be initialized. Target n receives
+**            XCP commands on CAN identifier SIM_TARGET_COMMAND_ID + n and responds on
+**            SIM_TARGET_RESPONSE_ID + n. The targets respond from the context of the
+**            thread that sent the command, so they need no thread of their own.
+** \param     count Number of simulated targets.
+** \param     settings Settings of each target simulation.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+bool SimTargetInit(uint32_t count, tXcpSimSettings const * settings)
+{
+  bool result = true;
+  uint32_t idx;
+
+  /* Check parameters. */
+  assert(count <= SIM_TARGET_COUNT_MAX);
+  assert(settings != NULL);
+
+  /* Create the target simulations. */
+  simTargetCount = 0;
+  for (idx = 0; (result) && (idx < count); idx++)
+  {
+    simTargets[idx] = XcpSimInit(settings);
+    if (simTargets[idx] == NULL)
+    {
+      result = false;
+    }
+    else
+    {
+      simTargetCount++;
+    }
+  }
+  /* Attach them to the loopback CAN bus. */
+  if (result)
+  {
+    simTargetEndpoint = CanLoopbackEndpointAttach(&simTargetEvents);
+    result = (simTargetEndpoint != NULL);
+  }
+  /* Clean up in case of an error. */
+  if (!result)
+  {
+    SimTargetTerminate();
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of SimTargetInit ***/
+
+
+/************************************************************************************//**
+** \brief     Detaches the simulated targets from the loopback CAN bus and releases
+**            them. Call this before the last session on the loopback CAN bus is
+**            terminated.
+**
+****************************************************************************************/
+void SimTargetTerminate(void)
+{
+  uint32_t idx;
+
+  if (simTargetEndpoint != NULL)
+  {
+    CanLoopbackEndpointDetach(simTargetEndpoint);
+    simTargetEndpoint = NULL;
+  }
+  for (idx = 0; idx < simTargetCount; idx++)
+  {
+    XcpSimTerminate(simTargets[idx]);
+    simTargets[idx] = NULL;
+  }
+  simTargetCount = 0;
+} /*** end of SimTargetTerminate ***/
+
+
+/************************************************************************************//**
+** \brief     Obtains the target simulation of a simulated target, for example to check
+**            its flash memory or to obtain its statistics.
+** \param     idx Zero based index of the simulated target.
+** \return    Handle of the target simulation. NULL if the target does not exist.
+**
+****************************************************************************************/
+tXcpSimHandle SimTargetGetSim(uint32_t idx)
+{
+  return (idx < simTargetCount) ? simTargets[idx] : NULL;
+} /*** end of SimTargetGetSim ***/
+
+
+/************************************************************************************//**
+** \brief     Event function that gets called for each CAN message on the loopback CAN
+**            bus. A command for one of the simulated targets is processed right away
+**            and its response is transmitted.
+** \param     msg Pointer to the received CAN message.
+**
+****************************************************************************************/
+static void SimTargetMessageReceived(tCanMsg const * msg)
+{
+  uint32_t idx;
+  uint8_t res[XCPSIM_PACKET_SIZE_MAX];
+  uint8_t resLen = 0;
+  tCanMsg resMsg;
+
+  /* Check parameters. */
+  assert(msg != NULL);
+
+  /* Determine the target that the command is meant for. */
+  idx = (msg->id & ~CAN_MSG_EXT_ID_MASK) - SIM_TARGET_COMMAND_ID;
+  if ( ((msg->id & CAN_MSG_EXT_ID_MASK) == 0) && (idx < simTargetCount) )
+  {
+    /* Process the command and transmit the response, if there is one. */
+    if ( (XcpSimProcessCommand(simTargets[idx], msg->data, msg->dlc, res, &resLen)) &&
+         (resLen > 0) && (resLen <= CAN_MSG_MAX_LEN) )
+    {
+      memset(&resMsg, 0, sizeof(resMsg));
+      resMsg.id = SIM_TARGET_RESPONSE_ID + idx;
+      resMsg.dlc = resLen;
+      memcpy(resMsg.data, res, resLen);
+      (void)CanLoopbackEndpointTransmit(simTargetEndpoint, &resMsg);
+    }
+  }
+} /*** end of SimTargetMessageReceived ***/
+
+
+/********************************** end of simtarget.c *********************************/
@@ -0,0 +1,62 @@
+/************************************************************************************//**
+* \file         simtarget.h
+* \brief        Simulated targets on the loopback CAN bus header file.
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+*
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+*
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+*
+* \endinternal
+****************************************************************************************/
+
+#ifndef SIMTARGET_H
+#define SIMTARGET_H
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include "xcpsim.h"                         /* XCP target simulation                   */
+
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Maximum number of simulated targets on the loopback CAN bus. */
+#define SIM_TARGET_COUNT_MAX           (16u)
+/** \brief CAN identifier on which the first simulated target receives XCP commands.
+ *         The next targets use the identifiers that follow.
+ */
+#define SIM_TARGET_COMMAND_ID          (0x600u)
+/** \brief CAN identifier on which the first simulated target transmits XCP responses.
+ *         The next targets use the identifiers that follow.
+ */
+#define SIM_TARGET_RESPONSE_ID         (0x700u)
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+bool SimTargetInit(uint32_t count, tXcpSimSettings const * settings);
+void SimTargetTerminate(void);
+tXcpSimHandle SimTargetGetSim(uint32_t idx);
+
+#endif /* SIMTARGET_H */
+/********************************** end of simtarget.h *********************************/
@@ -31,6 +31,7 @@
 //
 //***************************************************************************************
 using System;
+using System.Collections.Generic;
 using System.Runtime.InteropServices;
 using System.Diagnostics;
 
@@ -162,6 +163,48 @@ namespace OpenBLT
             /// </summary>
             private const UInt32 TRANSPORT_XCP_V10_NET = 3;
 
+            /// <summary>
+            /// Transport layer for the XCP v1.0 protocol that uses UDP/IP for data
+            /// exchange.
+            /// </summary>
+            private const UInt32 TRANSPORT_XCP_V10_UDP = 4;
+
+            /// <summary>
+            /// Operation type of StartAsync.
+            /// </summary>
+            public const UInt32 OP_START = 0;
+
+            /// <summary>
+            /// Operation type of StopAsync.
+            /// </summary>
+            public const UInt32 OP_STOP = 1;
+
+            /// <summary>
+            /// Operation type of ClearMemoryAsync.
+            /// </summary>
+            public const UInt32 OP_CLEAR_MEMORY = 2;
+
+            /// <summary>
+            /// Operation type of WriteDataAsync.
+            /// </summary>
+            public const UInt32 OP_WRITE_DATA = 3;
+
+            /// <summary>
+            /// Operation type of ReadDataAsync.
+            /// </summary>
+            public const UInt32 OP_READ_DATA = 4;
+
+            /// <summary>
+            /// Event type of an asynchronous session operation that made progress.
+            /// </summary>
+            public const UInt32 EVENT_PROGRESS = 0;
+
+            /// <summary>
+            /// Event type of an asynchronous session operation that completed. This is
+            /// always the last event of an operation.
+            /// </summary>
+            public const UInt32 EVENT_COMPLETED = 1;
+
             /// <summary>
             /// Structure layout of the XCP version 1.0 session settings.
             /// </summary>
@@ -310,6 +353,11 @@ namespace OpenBLT
                 /// Boolean to configure 29-bit CAN identifiers.
                 /// </summary>
                 public Boolean useExtended;
+
+                /// <summary>
+                /// Minimum time between transmitted CAN frames in microseconds.
+                /// </summary>
+                public UInt32 txFrameGap;
             }
 
             /// <summary>
@@ -327,6 +375,7 @@ namespace OpenBLT
                 public UInt32 transmitId;
                 public UInt32 receiveId;
                 public UInt32 useExtended;
+                public UInt32 txFrameGap;
             }
 
             /// <summary>
@@ -335,7 +384,9 @@ namespace OpenBLT
             /// <remarks>
             /// The address field can be set to either the IP address or the hostname, such
             /// as "192.168.178.23" or "mymicro.mydomain.com". The port should be set to the
-            /// TCP port number that the bootloader target listens on.
+            /// TCP port number that the bootloader target listens on. The window sets the
+            /// maximum number of program commands in flight. Only set it larger than 1 for a
+            /// target that buffers received commands.
             /// </remarks>
             public struct TransportSettingsXcpV10Net
             {
@@ -348,6 +399,11 @@ namespace OpenBLT
                 /// TCP port to use.
                 /// </summary>
                 public UInt16 port;
+
+                /// <summary>
+                /// Maximum number of commands in flight.
+                /// </summary>
+                public UInt32 window;
             }
 
             /// <summary>
@@ -361,11 +417,207 @@ namespace OpenBLT
             {
                 public IntPtr address;
                 public UInt16 port;
+                public UInt32 window;
+            }
+
+            /// <summary>
+            /// Structure layout of the XCP version 1.0 UDP transport layer settings.
+            /// </summary>
+            /// <remarks>
+            /// The address field can be set to either the IP address or the hostname, such
+            /// as "192.168.178.23" or "mymicro.mydomain.com". The port should be set to the
+            /// UDP port number that the bootloader target listens on. The window sets the
+            /// maximum number of program commands in flight. Only set it larger than 1 for a
+            /// target that buffers received datagrams.
+            /// </remarks>
+            public struct TransportSettingsXcpV10Udp
+            {
+                /// <summary>
+                /// Target IP-address or hostname on the network.
+                /// </summary>
+                public String address;
+
+                /// <summary>
+                /// UDP port to use.
+                /// </summary>
+                public UInt16 port;
+
+                /// <summary>
+                /// Maximum number of commands in flight.
+                /// </summary>
+                public UInt32 window;
+            }
+
+            /// <summary>
+            /// Unmanaged structure layout of the XCP version 1.0 UDP/IP transport layer settings.
+            /// </summary>
+            /// <remarks>
+            /// Only used internally when calling the API function inside the DLL.
+            /// </remarks>
+            [StructLayout(LayoutKind.Sequential)]
+            private struct TransportSettingsXcpV10UdpUnmanaged
+            {
+                public IntPtr address;
+                public UInt16 port;
+                public UInt32 window;
+            }
+
+            /// <summary>
+            /// Structure layout of the command/response latency statistics of a session.
+            /// </summary>
+            /// <remarks>
+            /// The command/response time of each exchange with the target is split into the
+            /// time spent on the host and the time spent on the communication medium and in
+            /// the target (wire time). The split relies on time stamps from the transport
+            /// layer. It is currently only supported by the CAN transport layer. For other
+            /// transport layers the entire command/response time counts as wire time. All
+            /// times are in microseconds.
+            /// </remarks>
+            [StructLayout(LayoutKind.Sequential)]
+            public struct SessionLatency
+            {
+                /// <summary>
+                /// Number of measured command/response exchanges.
+                /// </summary>
+                public UInt32 count;
+
+                /// <summary>
+                /// Average command/response time.
+                /// </summary>
+                public UInt32 totalAvg;
+
+                /// <summary>
+                /// Average time spent on the host.
+                /// </summary>
+                public UInt32 hostAvg;
+
+                /// <summary>
+                /// Average time spent on the communication medium and in the target.
+                /// </summary>
+                public UInt32 wireAvg;
+
+                /// <summary>
+                /// Longest command/response time.
+                /// </summary>
+                public UInt32 totalMax;
+
+                /// <summary>
+                /// 99th percentile of the command/response time.
+                /// </summary>
+                public UInt32 totalP99;
+            }
+
+            /// <summary>
+            /// Structure layout of an event of an asynchronous session operation.
+            /// </summary>
+            /// <remarks>
+            /// The progress is the number of bytes that were processed so far, out of the
+            /// total. For start and stop operations, both are 0. The result is only valid
+            /// for a completion event.
+            /// </remarks>
+            [StructLayout(LayoutKind.Sequential)]
+            public struct SessionEvent
+            {
+                /// <summary>
+                /// Operation type (OP_xxx).
+                /// </summary>
+                public UInt32 operation;
+
+                /// <summary>
+                /// Event type (EVENT_xxx).
+                /// </summary>
+                public UInt32 eventType;
+
+                /// <summary>
+                /// Result of a completed operation.
+                /// </summary>
+                public UInt32 result;
+
+                /// <summary>
+                /// Number of bytes processed so far.
+                /// </summary>
+                public UInt32 progress;
+
+                /// <summary>
+                /// Total number of bytes to process.
+                /// </summary>
+                public UInt32 total;
+            }
+
+            /// <summary>
+            /// Callback for the events of an asynchronous session operation. It is only
+            /// called from within ProcessEvents, so in the thread of the application.
+            /// </summary>
+            /// <param name="sessionEvent">The event.</param>
+            public delegate void SessionCallback(SessionEvent sessionEvent);
+
+            /// <summary>
+            /// Callback function as it is called by the library.
+            /// </summary>
+            [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+            private delegate void NativeSessionCallback(ref SessionEvent sessionEvent, IntPtr context);
+
+            /// <summary>
+            /// Request of an asynchronous session operation that did not yet complete.
+            /// </summary>
+            private class AsyncRequest
+            {
+                /// <summary>
+                /// Callback of the application. Can be null.
+                /// </summary>
+                public SessionCallback callback;
+
+                /// <summary>
+                /// Unmanaged memory with the data of a write or read operation.
+                /// </summary>
+                public IntPtr dataPtr;
+
+                /// <summary>
+                /// Array to store the uploaded data in, for a read operation.
+                /// </summary>
+                public byte[] readData;
             }
 
+            /// <summary>
+            /// Requests of the asynchronous session operations that did not yet complete,
+            /// indexed by their identifier.
+            /// </summary>
+            private static Dictionary<Int64, AsyncRequest> asyncRequests = new Dictionary<Int64, AsyncRequest>();
+
+            /// <summary>
+            /// Identifier of the next request.
+            /// </summary>
+            private static Int64 asyncNextId = 1;
+
+            /// <summary>
+            /// Callback function for the events of all asynchronous session operations. It
+            /// is kept referenced here, so that it is not garbage collected while the
+            /// library can still call it.
+            /// </summary>
+            private static NativeSessionCallback asyncDispatcher = AsyncDispatch;
+
+            /// <summary>
+            /// Function of the library that opens a session with the specified settings.
+            /// </summary>
+            private delegate IntPtr SessionOpener(UInt32 sessionType, IntPtr sessionSettings, UInt32 transportType, IntPtr transportSettings);
+
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern IntPtr BltSessionCreate(UInt32 sessionType, IntPtr sessionSettings, UInt32 transportType, IntPtr transportSettings);
+
             [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
             private static extern void BltSessionInit(UInt32 sessionType, IntPtr sessionSettings, UInt32 transportType, IntPtr transportSettings);
 
+            /// <summary>
+            /// Initializes the session of the library, which is used by the functions
+            /// without a session parameter.
+            /// </summary>
+            /// <returns>Always IntPtr.Zero.</returns>
+            private static IntPtr InitDefault(UInt32 sessionType, IntPtr sessionSettings, UInt32 transportType, IntPtr transportSettings)
+            {
+                BltSessionInit(sessionType, sessionSettings, transportType, transportSettings);
+                return IntPtr.Zero;
+            }
+
             /// <summary>
             /// Initializes the firmware update session for the XCP v1.0 communication
             /// protocol and RS232 as the transport layer. This function is typically
@@ -394,6 +646,36 @@ namespace OpenBLT
             /// </example>
             public static void Init(SessionSettingsXcpV10 sessionSettings, TransportSettingsXcpV10Rs232 transportSettings)
             {
+                // Initialize the session of the library.
+                Open(sessionSettings, transportSettings, InitDefault);
+            }
+
+            /// <summary>
+            /// Creates a firmware update session for the XCP v1.0 communication protocol
+            /// and RS232 as the transport layer. Unlike Init, it can be called multiple
+            /// times to update the firmware on several targets at the same time.
+            /// </summary>
+            /// <param name="sessionSettings">XCP V1.0 protocol settings</param>
+            /// <param name="transportSettings">RS232 transport layer settings</param>
+            /// <returns>The session if successful, IntPtr.Zero otherwise. Pass it to the
+            /// other session functions and release it with Destroy.</returns>
+            public static IntPtr Create(SessionSettingsXcpV10 sessionSettings, TransportSettingsXcpV10Rs232 transportSettings)
+            {
+                // Create the session in the library.
+                return Open(sessionSettings, transportSettings, BltSessionCreate);
+            }
+
+            /// <summary>
+            /// Copies the settings to unmanaged memory and opens the session with them.
+            /// </summary>
+            /// <param name="sessionSettings">XCP V1.0 protocol settings</param>
+            /// <param name="transportSettings">RS232 transport layer settings</param>
+            /// <param name="open">Function of the library that opens the session.</param>
+            /// <returns>The result of the open function.</returns>
+            private static IntPtr Open(SessionSettingsXcpV10 sessionSettings, TransportSettingsXcpV10Rs232 transportSettings, SessionOpener open)
+            {
+                IntPtr result = IntPtr.Zero;
+
                 // Copy the managed session settings to an unmanaged structure.
                 SessionSettingsXcpV10Unmanaged sessionSettingsUnmanaged;
                 sessionSettingsUnmanaged.timeoutT1 = sessionSettings.timeoutT1;
@@ -434,7 +716,7 @@ namespace OpenBLT
                     Marshal.StructureToPtr(transportSettingsUnmanaged, transportSettingsUnmanagedPtr, false);
 
                     // Call the API function inside the DLL.
-                    BltSessionInit(SESSION_XCP_V10, sessionSettingsUnmanagedPtr, TRANSPORT_XCP_V10_RS232, transportSettingsUnmanagedPtr);
+                    result = open(SESSION_XCP_V10, sessionSettingsUnmanagedPtr, TRANSPORT_XCP_V10_RS232, transportSettingsUnmanagedPtr);
 
                     // Free memory allocated on the heap.
                     Marshal.FreeHGlobal(transportSettingsUnmanagedPtr);
@@ -442,6 +724,9 @@ namespace OpenBLT
                     Marshal.FreeHGlobal(transportSettingsUnmanaged.portName);
                     Marshal.FreeHGlobal(sessionSettingsUnmanaged.seedKeyFile);
                 }
+
+                // Give the result back to the caller.
+                return result;
             }
 
             /// <summary>
@@ -470,12 +755,43 @@ namespace OpenBLT
             ///  transportSettings.transmitId = 0x667;
             ///  transportSettings.receiveId = 0x7E1;
             ///  transportSettings.useExtended = false;
+            ///  transportSettings.txFrameGap = 0;
             ///  
             ///  OpenBLT.Lib.Session.Init(sessionSettings, transportSettings);
             /// </code>
             /// </example>
             public static void Init(SessionSettingsXcpV10 sessionSettings, TransportSettingsXcpV10Can transportSettings)
             {
+                // Initialize the session of the library.
+                Open(sessionSettings, transportSettings, InitDefault);
+            }
+
+            /// <summary>
+            /// Creates a firmware update session for the XCP v1.0 communication protocol
+            /// and CAN as the transport layer. Unlike Init, it can be called multiple
+            /// times to update the firmware on several targets at the same time.
+            /// </summary>
+            /// <param name="sessionSettings">XCP V1.0 protocol settings</param>
+            /// <param name="transportSettings">CAN transport layer settings</param>
+            /// <returns>The session if successful, IntPtr.Zero otherwise. Pass it to the
+            /// other session functions and release it with Destroy.</returns>
+            public static IntPtr Create(SessionSettingsXcpV10 sessionSettings, TransportSettingsXcpV10Can transportSettings)
+            {
+                // Create the session in the library.
+                return Open(sessionSettings, transportSettings, BltSessionCreate);
+            }
+
+            /// <summary>
+            /// Copies the settings to unmanaged memory and opens the session with them.
+            /// </summary>
+            /// <param name="sessionSettings">XCP V1.0 protocol settings</param>
+            /// <param name="transportSettings">CAN transport layer settings</param>
+            /// <param name="open">Function of the library that opens the session.</param>
+            /// <returns>The result of the open function.</returns>
+            private static IntPtr Open(SessionSettingsXcpV10 sessionSettings, TransportSettingsXcpV10Can transportSettings, SessionOpener open)
+            {
+                IntPtr result = IntPtr.Zero;
+
                 // Copy the managed session settings to an unmanaged structure.
                 SessionSettingsXcpV10Unmanaged sessionSettingsUnmanaged;
                 sessionSettingsUnmanaged.timeoutT1 = sessionSettings.timeoutT1;
@@ -501,6 +817,7 @@ namespace OpenBLT
                 {
                     transportSettingsUnmanaged.useExtended = 1;
                 }
+                transportSettingsUnmanaged.txFrameGap = transportSettings.txFrameGap;
 
                 // The structures are now formatted to be converted to unmanaged memory. Start by allocating
                 // memory on the heap for this.
@@ -524,7 +841,7 @@ namespace OpenBLT
                     Marshal.StructureToPtr(transportSettingsUnmanaged, transportSettingsUnmanagedPtr, false);
 
                     // Call the API function inside the DLL.
-                    BltSessionInit(SESSION_XCP_V10, sessionSettingsUnmanagedPtr, TRANSPORT_XCP_V10_CAN, transportSettingsUnmanagedPtr);
+                    result = open(SESSION_XCP_V10, sessionSettingsUnmanagedPtr, TRANSPORT_XCP_V10_CAN, transportSettingsUnmanagedPtr);
 
                     // Free memory allocated on the heap.
                     Marshal.FreeHGlobal(transportSettingsUnmanagedPtr);
@@ -532,6 +849,9 @@ namespace OpenBLT
                     Marshal.FreeHGlobal(transportSettingsUnmanaged.deviceName);
                     Marshal.FreeHGlobal(sessionSettingsUnmanaged.seedKeyFile);
                 }
+
+                // Give the result back to the caller.
+                return result;
             }
 
             /// <summary>
@@ -562,6 +882,34 @@ namespace OpenBLT
             /// </example>
             public static void Init(SessionSettingsXcpV10 sessionSettings)
             {
+                // Initialize the session of the library.
+                Open(sessionSettings, InitDefault);
+            }
+
+            /// <summary>
+            /// Creates a firmware update session for the XCP v1.0 communication protocol
+            /// and USB as the transport layer. Unlike Init, it can be called multiple
+            /// times to update the firmware on several targets at the same time.
+            /// </summary>
+            /// <param name="sessionSettings">XCP V1.0 protocol settings</param>
+            /// <returns>The session if successful, IntPtr.Zero otherwise. Pass it to the
+            /// other session functions and release it with Destroy.</returns>
+            public static IntPtr Create(SessionSettingsXcpV10 sessionSettings)
+            {
+                // Create the session in the library.
+                return Open(sessionSettings, BltSessionCreate);
+            }
+
+            /// <summary>
+            /// Copies the settings to unmanaged memory and opens the session with them.
+            /// </summary>
+            /// <param name="sessionSettings">XCP V1.0 protocol settings</param>
+            /// <param name="open">Function of the library that opens the session.</param>
+            /// <returns>The result of the open function.</returns>
+            private static IntPtr Open(SessionSettingsXcpV10 sessionSettings, SessionOpener open)
+            {
+                IntPtr result = IntPtr.Zero;
+
                 // Copy the managed session settings to an unmanaged structure.
                 SessionSettingsXcpV10Unmanaged sessionSettingsUnmanaged;
                 sessionSettingsUnmanaged.timeoutT1 = sessionSettings.timeoutT1;
@@ -590,12 +938,15 @@ namespace OpenBLT
                     Marshal.StructureToPtr(sessionSettingsUnmanaged, sessionSettingsUnmanagedPtr, false);
 
                     // Call the API function inside the DLL.
-                    BltSessionInit(SESSION_XCP_V10, sessionSettingsUnmanagedPtr, TRANSPORT_XCP_V10_USB, IntPtr.Zero);
+                    result = open(SESSION_XCP_V10, sessionSettingsUnmanagedPtr, TRANSPORT_XCP_V10_USB, IntPtr.Zero);
 
                     // Free memory allocated on the heap.
                     Marshal.FreeHGlobal(sessionSettingsUnmanagedPtr);
                     Marshal.FreeHGlobal(sessionSettingsUnmanaged.seedKeyFile);
                 }
+
+                // Give the result back to the caller.
+                return result;
             }
 
             /// <summary>
@@ -620,12 +971,43 @@ namespace OpenBLT
             ///  OpenBLT.Lib.Session.TransportSettingsXcpV10Net transportSettings;
             ///  transportSettings.address = "192.168.178.30";
             ///  transportSettings.port = 1000;
+            ///  transportSettings.window = 1;
             ///  
             ///  OpenBLT.Lib.Session.Init(sessionSettings, transportSettings);
             /// </code>
             /// </example>
             public static void Init(SessionSettingsXcpV10 sessionSettings, TransportSettingsXcpV10Net transportSettings)
             {
+                // Initialize the session of the library.
+                Open(sessionSettings, transportSettings, InitDefault);
+            }
+
+            /// <summary>
+            /// Creates a firmware update session for the XCP v1.0 communication protocol
+            /// and TCP/IP as the transport layer. Unlike Init, it can be called multiple
+            /// times to update the firmware on several targets at the same time.
+            /// </summary>
+            /// <param name="sessionSettings">XCP V1.0 protocol settings</param>
+            /// <param name="transportSettings">TCP/IP transport layer settings</param>
+            /// <returns>The session if successful, IntPtr.Zero otherwise. Pass it to the
+            /// other session functions and release it with Destroy.</returns>
+            public static IntPtr Create(SessionSettingsXcpV10 sessionSettings, TransportSettingsXcpV10Net transportSettings)
+            {
+                // Create the session in the library.
+                return Open(sessionSettings, transportSettings, BltSessionCreate);
+            }
+
+            /// <summary>
+            /// Copies the settings to unmanaged memory and opens the session with them.
+            /// </summary>
+            /// <param name="sessionSettings">XCP V1.0 protocol settings</param>
+            /// <param name="transportSettings">TCP/IP transport layer settings</param>
+            /// <param name="open">Function of the library that opens the session.</param>
+            /// <returns>The result of the open function.</returns>
+            private static IntPtr Open(SessionSettingsXcpV10 sessionSettings, TransportSettingsXcpV10Net transportSettings, SessionOpener open)
+            {
+                IntPtr result = IntPtr.Zero;
+
                 // Copy the managed session settings to an unmanaged structure.
                 SessionSettingsXcpV10Unmanaged sessionSettingsUnmanaged;
                 sessionSettingsUnmanaged.timeoutT1 = sessionSettings.timeoutT1;
@@ -643,6 +1025,7 @@ namespace OpenBLT
                 // Convert string to unmanaged string.
                 transportSettingsUnmanaged.address = (IntPtr)Marshal.StringToHGlobalAnsi(transportSettings.address);
                 transportSettingsUnmanaged.port = transportSettings.port;
+                transportSettingsUnmanaged.window = transportSettings.window;
 
                 // The structures are now formatted to be converted to unmanaged memory. Start by allocating
                 // memory on the heap for this.
@@ -666,7 +1049,7 @@ namespace OpenBLT
                     Marshal.StructureToPtr(transportSettingsUnmanaged, transportSettingsUnmanagedPtr, false);
 
                     // Call the API function inside the DLL.
-                    BltSessionInit(SESSION_XCP_V10, sessionSettingsUnmanagedPtr, TRANSPORT_XCP_V10_NET, transportSettingsUnmanagedPtr);
+                    result = open(SESSION_XCP_V10, sessionSettingsUnmanagedPtr, TRANSPORT_XCP_V10_NET, transportSettingsUnmanagedPtr);
 
                     // Free memory allocated on the heap.
                     Marshal.FreeHGlobal(transportSettingsUnmanagedPtr);
@@ -674,66 +1057,244 @@ namespace OpenBLT
                     Marshal.FreeHGlobal(transportSettingsUnmanaged.address);
                     Marshal.FreeHGlobal(sessionSettingsUnmanaged.seedKeyFile);
                 }
-            }
 
-            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
-            private static extern void BltSessionTerminate();
+                // Give the result back to the caller.
+                return result;
+            }
 
             /// <summary>
-            /// Terminates the firmware update session. This function is typically called
-            /// once at the end of the firmware update.
+            /// Initializes the firmware update session for the XCP v1.0 communication
+            /// protocol and UDP/IP as the transport layer. This function is typically
+            /// called once at the start of the firmware update.
             /// </summary>
+            /// <param name="sessionSettings">XCP V1.0 protocol settings</param>
+            /// <param name="transportSettings">UDP/IP transport layer settings</param>
             /// <example>
             /// <code>
-            /// OpenBLT.Lib.Session.Terminate();
+            ///  OpenBLT.Lib.Session.SessionSettingsXcpV10 sessionSettings;
+            ///  sessionSettings.timeoutT1 = 1000;
+            ///  sessionSettings.timeoutT3 = 2000;
+            ///  sessionSettings.timeoutT4 = 10000;
+            ///  sessionSettings.timeoutT5 = 1000;
+            ///  sessionSettings.timeoutT6 = 50;
+            ///  sessionSettings.timeoutT7 = 2000;
+            ///  sessionSettings.seedKeyFile = "";
+            ///  sessionSettings.connectMode = 0;
+            ///  
+            ///  OpenBLT.Lib.Session.TransportSettingsXcpV10Udp transportSettings;
+            ///  transportSettings.address = "192.168.178.30";
+            ///  transportSettings.port = 1000;
+            ///  transportSettings.window = 1;
+            ///  
+            ///  OpenBLT.Lib.Session.Init(sessionSettings, transportSettings);
             /// </code>
             /// </example>
-            public static void Terminate()
+            public static void Init(SessionSettingsXcpV10 sessionSettings, TransportSettingsXcpV10Udp transportSettings)
             {
-                BltSessionTerminate();
+                // Initialize the session of the library.
+                Open(sessionSettings, transportSettings, InitDefault);
             }
 
-            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
-            private static extern UInt32 BltSessionStart();
+            /// <summary>
+            /// Creates a firmware update session for the XCP v1.0 communication protocol
+            /// and UDP/IP as the transport layer. Unlike Init, it can be called multiple
+            /// times to update the firmware on several targets at the same time.
+            /// </summary>
+            /// <param name="sessionSettings">XCP V1.0 protocol settings</param>
+            /// <param name="transportSettings">UDP/IP transport layer settings</param>
+            /// <returns>The session if successful, IntPtr.Zero otherwise. Pass it to the
+            /// other session functions and release it with Destroy.</returns>
+            public static IntPtr Create(SessionSettingsXcpV10 sessionSettings, TransportSettingsXcpV10Udp transportSettings)
+            {
+                // Create the session in the library.
+                return Open(sessionSettings, transportSettings, BltSessionCreate);
+            }
 
             /// <summary>
-            /// Terminates the firmware update session. This function is typically called
-            /// once at the end of the firmware update.
+            /// Copies the settings to unmanaged memory and opens the session with them.
             /// </summary>
-            /// <returns>RESULT_OK if successful, RESULT_ERROR_xxx otherwise.</returns>
-            /// <example>
-            /// <code>
-            /// if (OpenBLT.Lib.Session.Start() != OpenBLT.Lib.RESULT_OK)
-            /// {
+            /// <param name="sessionSettings">XCP V1.0 protocol settings</param>
+            /// <param name="transportSettings">UDP/IP transport layer settings</param>
+            /// <param name="open">Function of the library that opens the session.</param>
+            /// <returns>The result of the open function.</returns>
+            private static IntPtr Open(SessionSettingsXcpV10 sessionSettings, TransportSettingsXcpV10Udp transportSettings, SessionOpener open)
+            {
+                IntPtr result = IntPtr.Zero;
+
+                // Copy the managed session settings to an unmanaged structure.
+                SessionSettingsXcpV10Unmanaged sessionSettingsUnmanaged;
+                sessionSettingsUnmanaged.timeoutT1 = sessionSettings.timeoutT1;
+                sessionSettingsUnmanaged.timeoutT3 = sessionSettings.timeoutT3;
+                sessionSettingsUnmanaged.timeoutT4 = sessionSettings.timeoutT4;
+                sessionSettingsUnmanaged.timeoutT5 = sessionSettings.timeoutT5;
+                sessionSettingsUnmanaged.timeoutT6 = sessionSettings.timeoutT6;
+                sessionSettingsUnmanaged.timeoutT7 = sessionSettings.timeoutT7;
+                // Convert string to unmanged string.
+                sessionSettingsUnmanaged.seedKeyFile = (IntPtr)Marshal.StringToHGlobalAnsi(sessionSettings.seedKeyFile);
+                sessionSettingsUnmanaged.connectMode = sessionSettings.connectMode;
+
+                // Copy the managed transport settings to an unmanaged structure.
+                TransportSettingsXcpV10UdpUnmanaged transportSettingsUnmanaged;
+                // Convert string to unmanaged string.
+                transportSettingsUnmanaged.address = (IntPtr)Marshal.StringToHGlobalAnsi(transportSettings.address);
+                transportSettingsUnmanaged.port = transportSettings.port;
+                transportSettingsUnmanaged.window = transportSettings.window;
+
+                // The structures are now formatted to be converted to unmanaged memory. Start by allocating
+                // memory on the heap for this.
+                IntPtr sessionSettingsUnmanagedPtr = Marshal.AllocHGlobal(Marshal.SizeOf(sessionSettingsUnmanaged));
+                IntPtr transportSettingsUnmanagedPtr = Marshal.AllocHGlobal(Marshal.SizeOf(transportSettingsUnmanaged));
+
+                // Assert the heap allocations.
+                Debug.Assert(sessionSettingsUnmanaged.seedKeyFile != IntPtr.Zero);
+                Debug.Assert(transportSettingsUnmanaged.address != IntPtr.Zero);
+                Debug.Assert(sessionSettingsUnmanagedPtr != IntPtr.Zero);
+                Debug.Assert(transportSettingsUnmanagedPtr != IntPtr.Zero);
+
+                // Only continue if all the heap allocations were successful.
+                if ((sessionSettingsUnmanaged.seedKeyFile != IntPtr.Zero) &&
+                     (transportSettingsUnmanaged.address != IntPtr.Zero) &&
+                     (sessionSettingsUnmanagedPtr != IntPtr.Zero) &&
+                     (transportSettingsUnmanagedPtr != IntPtr.Zero))
+                {
+                    // Copy the structures to unmanaged memory.
+                    Marshal.StructureToPtr(sessionSettingsUnmanaged, sessionSettingsUnmanagedPtr, false);
+                    Marshal.StructureToPtr(transportSettingsUnmanaged, transportSettingsUnmanagedPtr, false);
+
+                    // Call the API function inside the DLL.
+                    result = open(SESSION_XCP_V10, sessionSettingsUnmanagedPtr, TRANSPORT_XCP_V10_UDP, transportSettingsUnmanagedPtr);
+
+                    // Free memory allocated on the heap.
+                    Marshal.FreeHGlobal(transportSettingsUnmanagedPtr);
+                    Marshal.FreeHGlobal(sessionSettingsUnmanagedPtr);
+                    Marshal.FreeHGlobal(transportSettingsUnmanaged.address);
+                    Marshal.FreeHGlobal(sessionSettingsUnmanaged.seedKeyFile);
+                }
+
+                // Give the result back to the caller.
+                return result;
+            }
+
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern void BltSessionTerminate();
+
+            /// <summary>
+            /// Terminates the firmware update session. This function is typically called
+            /// once at the end of the firmware update.
+            /// </summary>
+            /// <example>
+            /// <code>
+            /// OpenBLT.Lib.Session.Terminate();
+            /// </code>
+            /// </example>
+            public static void Terminate()
+            {
+                BltSessionTerminate();
+            }
+
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern void BltSessionDestroy(IntPtr session);
+
+            /// <summary>
+            /// Destroys a firmware update session that was created with Create. Its
+            /// pending asynchronous operations are cancelled and their events are passed
+            /// on to their callbacks, before the session is released.
+            /// </summary>
+            /// <param name="session">The session to destroy.</param>
+            public static void Destroy(IntPtr session)
+            {
+                // Only destroy a valid session.
+                if (session != IntPtr.Zero)
+                {
+                    BltSessionDestroy(session);
+                }
+            }
+
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern UInt32 BltSessionStart();
+
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern UInt32 BltSessionHandleStart(IntPtr session);
+
+            /// <summary>
+            /// Terminates the firmware update session. This function is typically called
+            /// once at the end of the firmware update.
+            /// </summary>
+            /// <returns>RESULT_OK if successful, RESULT_ERROR_xxx otherwise.</returns>
+            /// <example>
+            /// <code>
+            /// if (OpenBLT.Lib.Session.Start() != OpenBLT.Lib.RESULT_OK)
+            /// {
             ///     Console.WriteLine("Could not connect to the target.");
             /// }
             /// </code>
             /// </example>
             public static UInt32 Start()
             {
-                return BltSessionStart();
+                // Forward to the session of the library.
+                return Start(IntPtr.Zero);
+            }
+
+            /// <summary>
+            /// Starts the firmware update session. This is were the library attempts to
+            /// activate and connect with the bootloader running on the target, through the
+            /// transport layer that was specified when the session was created.
+            /// </summary>
+            /// <param name="session">Session created with Create. IntPtr.Zero for the session
+            /// of Init.</param>
+            /// <returns>RESULT_OK if successful, RESULT_ERROR_xxx otherwise.</returns>
+            public static UInt32 Start(IntPtr session)
+            {
+                // Start the session in the library.
+                return (session == IntPtr.Zero) ? BltSessionStart() : BltSessionHandleStart(session);
             }
 
             [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
-            private static extern void BltSessionStop();
+            private static extern UInt32 BltSessionStop();
+
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern UInt32 BltSessionHandleStop(IntPtr session);
 
             /// <summary>
             /// Terminates the firmware update session. This function is typically called
             /// once at the end of the firmware update.
             /// </summary>
+            /// <returns>RESULT_OK if successful, RESULT_ERROR_xxx otherwise.</returns>
             /// <example>
             /// <code>
-            /// OpenBLT.Lib.Session.Stop();
+            /// if (OpenBLT.Lib.Session.Stop() != OpenBLT.Lib.RESULT_OK)
+            /// {
+            ///     Console.WriteLine("Could not complete the firmware update.");
+            /// }
             /// </code>
             /// </example>
-            public static void Stop()
+            public static UInt32 Stop()
+            {
+                // Forward to the session of the library.
+                return Stop(IntPtr.Zero);
+            }
+
+            /// <summary>
+            /// Stops the firmware update session. This is there the library disconnects the
+            /// transport layer as well. An error is reported if the firmware update could
+            /// not be completed properly. The bootloader then does not start the user
+            /// program.
+            /// </summary>
+            /// <param name="session">Session created with Create. IntPtr.Zero for the session
+            /// of Init.</param>
+            /// <returns>RESULT_OK if successful, RESULT_ERROR_xxx otherwise.</returns>
+            public static UInt32 Stop(IntPtr session)
             {
-                BltSessionStop();
+                // Stop the session in the library.
+                return (session == IntPtr.Zero) ? BltSessionStop() : BltSessionHandleStop(session);
             }
 
             [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
             private static extern UInt32 BltSessionClearMemory(UInt32 address, UInt32 len);
 
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern UInt32 BltSessionHandleClearMemory(IntPtr session, UInt32 address, UInt32 len);
+
             /// <summary>
             /// Requests the target to erase the specified range of memory on the target.
             /// </summary>
@@ -755,17 +1316,42 @@ namespace OpenBLT
             /// </code>
             /// </example>
             public static UInt32 ClearMemory(UInt32 address, Int32 len)
+            {
+                // Forward to the session of the library.
+                return ClearMemory(IntPtr.Zero, address, len);
+            }
+
+            /// <summary>
+            /// Requests the target to erase the specified range of memory on the target.
+            /// </summary>
+            /// <remarks>
+            /// Note that the target automatically aligns this to the erasable memory
+            /// block sizes. This typically results in more memory being erased than the
+            /// range that was specified here. Refer to the target implementation for
+            /// details.
+            /// </remarks>
+            /// <param name="session">Session created with Create. IntPtr.Zero for the session
+            /// of Init.</param>
+            /// <param name="address">The starting memory address for the erase operation.</param>
+            /// <param name="len">The total number of bytes to erase from memory.</param>
+            /// <returns>RESULT_OK if successful, RESULT_ERROR_xxx otherwise.</returns>
+            public static UInt32 ClearMemory(IntPtr session, UInt32 address, Int32 len)
             {
                 // Note that parameter length was made 32-bit signed, because you typically erase the
                 // length of a segment. When obtaining the segment info with GetSegment(), you would
                 // then pass the length of the segment's data-array into this function, which is 32-bit
                 // signed.
-                return BltSessionClearMemory(address, (UInt32)len);
+                return (session == IntPtr.Zero)
+                    ? BltSessionClearMemory(address, (UInt32)len)
+                    : BltSessionHandleClearMemory(session, address, (UInt32)len);
             }
 
             [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
             private static extern UInt32 BltSessionWriteData(UInt32 address, UInt32 len, IntPtr data);
 
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern UInt32 BltSessionHandleWriteData(IntPtr session, UInt32 address, UInt32 len, IntPtr data);
+
             /// <summary>
             /// Requests the target to program the specified data to memory.
             /// </summary>
@@ -797,6 +1383,25 @@ namespace OpenBLT
             /// </code>
             /// </example>
             public static UInt32 WriteData(UInt32 address, byte[] data)
+            {
+                // Forward to the session of the library.
+                return WriteData(IntPtr.Zero, address, data);
+            }
+
+            /// <summary>
+            /// Requests the target to program the specified data to memory.
+            /// </summary>
+            /// <remarks>
+            /// Note that it is the responsibility of the application to make sure the
+            /// memory range was erased beforehand. The length of the data array
+            /// determines how many bytes are programmed.
+            /// </remarks>
+            /// <param name="session">Session created with Create. IntPtr.Zero for the session
+            /// of Init.</param>
+            /// <param name="address">The starting memory address for the write operation.</param>
+            /// <param name="data">Byte array with data to write.</param>
+            /// <returns>RESULT_OK if successful, RESULT_ERROR_xxx otherwise.</returns>
+            public static UInt32 WriteData(IntPtr session, UInt32 address, byte[] data)
             {
                 UInt32 result = RESULT_ERROR_GENERIC;
 
@@ -812,7 +1417,9 @@ namespace OpenBLT
                     // Copy the data to unmanaged memory.
                     Marshal.Copy(data, 0, dataPtr, data.Length);
                     // Write the data to memory on the target.
-                    result = BltSessionWriteData(address, (UInt32)data.Length, dataPtr);
+                    result = (session == IntPtr.Zero)
+                        ? BltSessionWriteData(address, (UInt32)data.Length, dataPtr)
+                        : BltSessionHandleWriteData(session, address, (UInt32)data.Length, dataPtr);
                     // Free the unmanaged memory.
                     Marshal.FreeHGlobal(dataPtr);
                 }
@@ -824,6 +1431,9 @@ namespace OpenBLT
             [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
             private static extern UInt32 BltSessionReadData(UInt32 address, UInt32 len, IntPtr data);
 
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern UInt32 BltSessionHandleReadData(IntPtr session, UInt32 address, UInt32 len, IntPtr data);
+
             /// <summary>
             /// Requests the target to upload the specified range from memory and store its
             /// contents in the specified data buffer.
@@ -840,6 +1450,24 @@ namespace OpenBLT
             /// </code>
             /// </example>
             public static UInt32 ReadData(UInt32 address, byte[] data)
+            {
+                // Forward to the session of the library.
+                return ReadData(IntPtr.Zero, address, data);
+            }
+
+            /// <summary>
+            /// Requests the target to upload the specified range from memory and store its
+            /// contents in the specified data buffer.
+            /// </summary>
+            /// <remarks>
+            /// Note that the length of the data array determines how many bytes are read.
+            /// </remarks>
+            /// <param name="session">Session created with Create. IntPtr.Zero for the session
+            /// of Init.</param>
+            /// <param name="address">The starting memory address for the read operation.</param>
+            /// <param name="data">Byte array where the uploaded data should be stored.</param>
+            /// <returns>RESULT_OK if successful, RESULT_ERROR_xxx otherwise.</returns>
+            public static UInt32 ReadData(IntPtr session, UInt32 address, byte[] data)
             {
                 UInt32 result = RESULT_ERROR_GENERIC;
 
@@ -853,7 +1481,9 @@ namespace OpenBLT
                 if (dataPtr != IntPtr.Zero)
                 {
                     // Read the data to memory on the target.
-                    result = BltSessionReadData(address, (UInt32)data.Length, dataPtr);
+                    result = (session == IntPtr.Zero)
+                        ? BltSessionReadData(address, (UInt32)data.Length, dataPtr)
+                        : BltSessionHandleReadData(session, address, (UInt32)data.Length, dataPtr);
 
                     // Copy read data in unmanaged memory back to the data array.
                     Marshal.Copy(dataPtr, data, 0, dataSize);
@@ -865,6 +1495,474 @@ namespace OpenBLT
                 // Give the result back to the caller.
                 return result;
             }
+
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern UInt32 BltSessionGetLatency(out SessionLatency latency);
+
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern UInt32 BltSessionHandleGetLatency(IntPtr session, out SessionLatency latency);
+
+            /// <summary>
+            /// Obtains the command/response latency statistics of the firmware update
+            /// session. They cover all successful exchanges with the target since the
+            /// session was started and remain available after the session was stopped.
+            /// </summary>
+            /// <param name="latency">Structure where the statistics are stored.</param>
+            /// <returns>RESULT_OK if successful, RESULT_ERROR_xxx otherwise.</returns>
+            /// <example>
+            /// <code>
+            /// OpenBLT.Lib.Session.SessionLatency latency;
+            ///
+            /// if (OpenBLT.Lib.Session.GetLatency(out latency) == OpenBLT.Lib.RESULT_OK)
+            /// {
+            ///    Console.WriteLine("Average host time: {0} us", latency.hostAvg);
+            ///    Console.WriteLine("Average wire time: {0} us", latency.wireAvg);
+            /// }
+            /// </code>
+            /// </example>
+            public static UInt32 GetLatency(out SessionLatency latency)
+            {
+                // Forward to the session of the library.
+                return GetLatency(IntPtr.Zero, out latency);
+            }
+
+            /// <summary>
+            /// Obtains the command/response latency statistics of the firmware update
+            /// session. They cover all successful exchanges with the target since the
+            /// session was started and remain available after the session was stopped.
+            /// </summary>
+            /// <param name="session">Session created with Create. IntPtr.Zero for the session
+            /// of Init.</param>
+            /// <param name="latency">Structure where the statistics are stored.</param>
+            /// <returns>RESULT_OK if successful, RESULT_ERROR_xxx otherwise.</returns>
+            public static UInt32 GetLatency(IntPtr session, out SessionLatency latency)
+            {
+                // Obtain the statistics from the library.
+                return (session == IntPtr.Zero)
+                    ? BltSessionGetLatency(out latency)
+                    : BltSessionHandleGetLatency(session, out latency);
+            }
+
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern UInt32 BltSessionKeepTransport(UInt32 keep);
+
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern UInt32 BltSessionHandleKeepTransport(IntPtr session, UInt32 keep);
+
+            /// <summary>
+            /// Configures if the transport layer stays connected when the firmware update
+            /// session is stopped, such that the next start of the session skips
+            /// connecting it. Only use it for transport layers whose connection does not
+            /// end when the target resets, such as RS232 and CAN.
+            /// </summary>
+            /// <param name="keep">True to keep the transport layer connected.</param>
+            /// <returns>RESULT_OK if successful, RESULT_ERROR_xxx otherwise.</returns>
+            public static UInt32 KeepTransport(bool keep)
+            {
+                // Forward to the session of the library.
+                return KeepTransport(IntPtr.Zero, keep);
+            }
+
+            /// <summary>
+            /// Configures if the transport layer stays connected when the firmware update
+            /// session is stopped, such that the next start of the session skips
+            /// connecting it. Only use it for transport layers whose connection does not
+            /// end when the target resets, such as RS232 and CAN.
+            /// </summary>
+            /// <param name="session">Session created with Create. IntPtr.Zero for the session
+            /// of Init.</param>
+            /// <param name="keep">True to keep the transport layer connected.</param>
+            /// <returns>RESULT_OK if successful, RESULT_ERROR_xxx otherwise.</returns>
+            public static UInt32 KeepTransport(IntPtr session, bool keep)
+            {
+                // Configure the session in the library.
+                UInt32 keepValue = keep ? 1u : 0u;
+                return (session == IntPtr.Zero)
+                    ? BltSessionKeepTransport(keepValue)
+                    : BltSessionHandleKeepTransport(session, keepValue);
+            }
+
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern UInt32 BltSessionStartAsync(NativeSessionCallback callback, IntPtr context);
+
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern UInt32 BltSessionHandleStartAsync(IntPtr session, NativeSessionCallback callback, IntPtr context);
+
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern UInt32 BltSessionStopAsync(NativeSessionCallback callback, IntPtr context);
+
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern UInt32 BltSessionHandleStopAsync(IntPtr session, NativeSessionCallback callback, IntPtr context);
+
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern UInt32 BltSessionClearMemoryAsync(UInt32 address, UInt32 len, NativeSessionCallback callback, IntPtr context);
+
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern UInt32 BltSessionHandleClearMemoryAsync(IntPtr session, UInt32 address, UInt32 len, NativeSessionCallback callback, IntPtr context);
+
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern UInt32 BltSessionWriteDataAsync(UInt32 address, UInt32 len, IntPtr data, NativeSessionCallback callback, IntPtr context);
+
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern UInt32 BltSessionHandleWriteDataAsync(IntPtr session, UInt32 address, UInt32 len, IntPtr data, NativeSessionCallback callback, IntPtr context);
+
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern UInt32 BltSessionReadDataAsync(UInt32 address, UInt32 len, IntPtr data, NativeSessionCallback callback, IntPtr context);
+
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern UInt32 BltSessionHandleReadDataAsync(IntPtr session, UInt32 address, UInt32 len, IntPtr data, NativeSessionCallback callback, IntPtr context);
+
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern UInt32 BltSessionProcessEvents(UInt32 timeout);
+
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern void BltSessionCancelAsync();
+
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern void BltSessionHandleCancelAsync(IntPtr session);
+
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern IntPtr BltSessionGetEventHandle();
+
+            /// <summary>
+            /// Submits an operation to start the firmware update session, without waiting
+            /// for it to complete. The operation is executed in the background. Its events
+            /// are passed on to the callback from within ProcessEvents.
+            /// </summary>
+            /// <param name="callback">Callback for the events of the operation. Can be null.</param>
+            /// <returns>RESULT_OK if the operation was submitted, RESULT_ERROR_xxx otherwise.</returns>
+            /// <example>
+            /// <code>
+            /// OpenBLT.Lib.Session.StartAsync(evt =>
+            /// {
+            ///    if (evt.result != OpenBLT.Lib.RESULT_OK)
+            ///    {
+            ///       Console.WriteLine("Could not connect to the target.");
+            ///    }
+            /// });
+            /// while (OpenBLT.Lib.Session.ProcessEvents(100) > 0) { }
+            /// </code>
+            /// </example>
+            public static UInt32 StartAsync(SessionCallback callback)
+            {
+                // Forward to the session of the library.
+                return StartAsync(IntPtr.Zero, callback);
+            }
+
+            /// <summary>
+            /// Submits an operation to start the firmware update session, without waiting
+            /// for it to complete. The operation is executed in the background. Its events
+            /// are passed on to the callback from within ProcessEvents.
+            /// </summary>
+            /// <param name="session">Session created with Create. IntPtr.Zero for the session
+            /// of Init.</param>
+            /// <param name="callback">Callback for the events of the operation. Can be null.</param>
+            /// <returns>RESULT_OK if the operation was submitted, RESULT_ERROR_xxx otherwise.</returns>
+            public static UInt32 StartAsync(IntPtr session, SessionCallback callback)
+            {
+                // Submit the operation.
+                return SubmitAsync(new AsyncRequest { callback = callback },
+                                   context => (session == IntPtr.Zero)
+                                       ? BltSessionStartAsync(asyncDispatcher, context)
+                                       : BltSessionHandleStartAsync(session, asyncDispatcher, context));
+            }
+
+            /// <summary>
+            /// Submits an operation to stop the firmware update session, without waiting
+            /// for it to complete.
+            /// </summary>
+            /// <param name="callback">Callback for the events of the operation. Can be null.</param>
+            /// <returns>RESULT_OK if the operation was submitted, RESULT_ERROR_xxx otherwise.</returns>
+            public static UInt32 StopAsync(SessionCallback callback)
+            {
+                // Forward to the session of the library.
+                return StopAsync(IntPtr.Zero, callback);
+            }
+
+            /// <summary>
+            /// Submits an operation to stop the firmware update session, without waiting
+            /// for it to complete.
+            /// </summary>
+            /// <param name="session">Session created with Create. IntPtr.Zero for the session
+            /// of Init.</param>
+            /// <param name="callback">Callback for the events of the operation. Can be null.</param>
+            /// <returns>RESULT_OK if the operation was submitted, RESULT_ERROR_xxx otherwise.</returns>
+            public static UInt32 StopAsync(IntPtr session, SessionCallback callback)
+            {
+                // Submit the operation.
+                return SubmitAsync(new AsyncRequest { callback = callback },
+                                   context => (session == IntPtr.Zero)
+                                       ? BltSessionStopAsync(asyncDispatcher, context)
+                                       : BltSessionHandleStopAsync(session, asyncDispatcher, context));
+            }
+
+            /// <summary>
+            /// Submits an operation to erase the specified range of memory on the target,
+            /// without waiting for it to complete.
+            /// </summary>
+            /// <param name="address">The starting memory address for the erase operation.</param>
+            /// <param name="len">The total number of bytes to erase from memory.</param>
+            /// <param name="callback">Callback for the events of the operation. Can be null.</param>
+            /// <returns>RESULT_OK if the operation was submitted, RESULT_ERROR_xxx otherwise.</returns>
+            public static UInt32 ClearMemoryAsync(UInt32 address, UInt32 len, SessionCallback callback)
+            {
+                // Forward to the session of the library.
+                return ClearMemoryAsync(IntPtr.Zero, address, len, callback);
+            }
+
+            /// <summary>
+            /// Submits an operation to erase the specified range of memory on the target,
+            /// without waiting for it to complete.
+            /// </summary>
+            /// <param name="session">Session created with Create. IntPtr.Zero for the session
+            /// of Init.</param>
+            /// <param name="address">The starting memory address for the erase operation.</param>
+            /// <param name="len">The total number of bytes to erase from memory.</param>
+            /// <param name="callback">Callback for the events of the operation. Can be null.</param>
+            /// <returns>RESULT_OK if the operation was submitted, RESULT_ERROR_xxx otherwise.</returns>
+            public static UInt32 ClearMemoryAsync(IntPtr session, UInt32 address, UInt32 len, SessionCallback callback)
+            {
+                // Submit the operation.
+                return SubmitAsync(new AsyncRequest { callback = callback },
+                                   context => (session == IntPtr.Zero)
+                                       ? BltSessionClearMemoryAsync(address, len, asyncDispatcher, context)
+                                       : BltSessionHandleClearMemoryAsync(session, address, len, asyncDispatcher, context));
+            }
+
+            /// <summary>
+            /// Submits an operation to program the specified data to memory, without
+            /// waiting for it to complete. Progress events are passed on to the callback
+            /// while the data is programmed.
+            /// </summary>
+            /// <param name="address">The starting memory address for the write operation.</param>
+            /// <param name="data">Byte array with data to write.</param>
+            /// <param name="callback">Callback for the events of the operation. Can be null.</param>
+            /// <returns>RESULT_OK if the operation was submitted, RESULT_ERROR_xxx otherwise.</returns>
+            /// <example>
+            /// <code>
+            /// OpenBLT.Lib.Session.WriteDataAsync(0x08006000, flashData, evt =>
+            /// {
+            ///    Console.WriteLine("Programmed {0} of {1} bytes", evt.progress, evt.total);
+            /// });
+            /// </code>
+            /// </example>
+            public static UInt32 WriteDataAsync(UInt32 address, byte[] data, SessionCallback callback)
+            {
+                // Forward to the session of the library.
+                return WriteDataAsync(IntPtr.Zero, address, data, callback);
+            }
+
+            /// <summary>
+            /// Submits an operation to program the specified data to memory, without
+            /// waiting for it to complete. Progress events are passed on to the callback
+            /// while the data is programmed.
+            /// </summary>
+            /// <param name="session">Session created with Create. IntPtr.Zero for the session
+            /// of Init.</param>
+            /// <param name="address">The starting memory address for the write operation.</param>
+            /// <param name="data">Byte array with data to write.</param>
+            /// <param name="callback">Callback for the events of the operation. Can be null.</param>
+            /// <returns>RESULT_OK if the operation was submitted, RESULT_ERROR_xxx otherwise.</returns>
+            public static UInt32 WriteDataAsync(IntPtr session, UInt32 address, byte[] data, SessionCallback callback)
+            {
+                UInt32 result = RESULT_ERROR_GENERIC;
+
+                // Allocate memory on the heap for storing the data in unmanaged memory. It
+                // is released once the operation completed.
+                IntPtr dataPtr = Marshal.AllocHGlobal(data.Length);
+
+                // Only continue if the allocation was successful.
+                if (dataPtr != IntPtr.Zero)
+                {
+                    // Copy the data to unmanaged memory.
+                    Marshal.Copy(data, 0, dataPtr, data.Length);
+                    // Submit the operation.
+                    result = SubmitAsync(new AsyncRequest { callback = callback, dataPtr = dataPtr },
+                                         context => (session == IntPtr.Zero)
+                                             ? BltSessionWriteDataAsync(address, (UInt32)data.Length, dataPtr, asyncDispatcher, context)
+                                             : BltSessionHandleWriteDataAsync(session, address, (UInt32)data.Length, dataPtr, asyncDispatcher, context));
+                }
+
+                // Give the result back to the caller.
+                return result;
+            }
+
+            /// <summary>
+            /// Submits an operation to upload the specified range from memory, without
+            /// waiting for it to complete. Progress events are passed on to the callback
+            /// while the data is uploaded. Once the operation completed successfully, the
+            /// uploaded data is stored in the data array.
+            /// </summary>
+            /// <param name="address">The starting memory address for the read operation.</param>
+            /// <param name="data">Byte array where the uploaded data should be stored. Its
+            /// length determines the number of bytes to upload.</param>
+            /// <param name="callback">Callback for the events of the operation. Can be null.</param>
+            /// <returns>RESULT_OK if the operation was submitted, RESULT_ERROR_xxx otherwise.</returns>
+            public static UInt32 ReadDataAsync(UInt32 address, byte[] data, SessionCallback callback)
+            {
+                // Forward to the session of the library.
+                return ReadDataAsync(IntPtr.Zero, address, data, callback);
+            }
+
+            /// <summary>
+            /// Submits an operation to upload the specified range from memory, without
+            /// waiting for it to complete. Progress events are passed on to the callback
+            /// while the data is uploaded. Once the operation completed successfully, the
+            /// uploaded data is stored in the data array.
+            /// </summary>
+            /// <param name="session">Session created with Create. IntPtr.Zero for the session
+            /// of Init.</param>
+            /// <param name="address">The starting memory address for the read operation.</param>
+            /// <param name="data">Byte array where the uploaded data should be stored. Its
+            /// length determines the number of bytes to upload.</param>
+            /// <param name="callback">Callback for the events of the operation. Can be null.</param>
+            /// <returns>RESULT_OK if the operation was submitted, RESULT_ERROR_xxx otherwise.</returns>
+            public static UInt32 ReadDataAsync(IntPtr session, UInt32 address, byte[] data, SessionCallback callback)
+            {
+                UInt32 result = RESULT_ERROR_GENERIC;
+
+                // Allocate memory on the heap for storing the data in unmanaged memory. It
+                // is released once the operation completed.
+                IntPtr dataPtr = Marshal.AllocHGlobal(data.Length);
+
+                // Only continue if the allocation was successful.
+                if (dataPtr != IntPtr.Zero)
+                {
+                    // Submit the operation.
+                    result = SubmitAsync(new AsyncRequest { callback = callback, dataPtr = dataPtr, readData = data },
+                                         context => (session == IntPtr.Zero)
+                                             ? BltSessionReadDataAsync(address, (UInt32)data.Length, dataPtr, asyncDispatcher, context)
+                                             : BltSessionHandleReadDataAsync(session, address, (UInt32)data.Length, dataPtr, asyncDispatcher, context));
+                }
+
+                // Give the result back to the caller.
+                return result;
+            }
+
+            /// <summary>
+            /// Passes the pending events of asynchronous session operations on to their
+            /// callbacks. If no events are pending yet, it first waits for them, up to the
+            /// specified timeout.
+            /// </summary>
+            /// <param name="timeout">Maximum time in milliseconds to wait for events. 0 to
+            /// only process the events that are already pending.</param>
+            /// <returns>Number of asynchronous operations that did not yet complete.</returns>
+            public static UInt32 ProcessEvents(UInt32 timeout)
+            {
+                // Process the events in the library.
+                return BltSessionProcessEvents(timeout);
+            }
+
+            /// <summary>
+            /// Cancels all pending asynchronous session operations. Cancelled operations
+            /// complete with an error, which is passed on to their callbacks with the next
+            /// call of ProcessEvents.
+            /// </summary>
+            public static void CancelAsync()
+            {
+                // Forward to the session of the library.
+                CancelAsync(IntPtr.Zero);
+            }
+
+            /// <summary>
+            /// Cancels all pending asynchronous session operations. Cancelled operations
+            /// complete with an error, which is passed on to their callbacks with the next
+            /// call of ProcessEvents.
+            /// </summary>
+            /// <param name="session">Session created with Create. IntPtr.Zero for the session
+            /// of Init.</param>
+            public static void CancelAsync(IntPtr session)
+            {
+                // Cancel the operations in the library.
+                if (session == IntPtr.Zero)
+                {
+                    BltSessionCancelAsync();
+                }
+                else
+                {
+                    BltSessionHandleCancelAsync(session);
+                }
+            }
+
+            /// <summary>
+            /// Obtains the operating system handle that is signaled while events of
+            /// asynchronous session operations are pending. On Windows this is an event
+            /// object handle, which can for example be wrapped in a WaitHandle. On Linux
+            /// this is a file descriptor that becomes readable.
+            /// </summary>
+            /// <returns>The operating system handle. -1 if the session is not initialized.</returns>
+            public static IntPtr GetEventHandle()
+            {
+                // Obtain the handle from the library.
+                return BltSessionGetEventHandle();
+            }
+
+            /// <summary>
+            /// Stores the request of an asynchronous session operation and submits the
+            /// operation.
+            /// </summary>
+            /// <param name="request">The request.</param>
+            /// <param name="submit">Function that submits the operation to the library,
+            /// with the specified context.</param>
+            /// <returns>RESULT_OK if the operation was submitted, RESULT_ERROR_xxx otherwise.</returns>
+            private static UInt32 SubmitAsync(AsyncRequest request, Func<IntPtr, UInt32> submit)
+            {
+                // Store the request.
+                Int64 id = asyncNextId++;
+                asyncRequests[id] = request;
+
+                // Submit the operation.
+                UInt32 result = submit(new IntPtr(id));
+
+                // Release the request again, if the operation was not submitted.
+                if (result != RESULT_OK)
+                {
+                    asyncRequests.Remove(id);
+                    if (request.dataPtr != IntPtr.Zero)
+                    {
+                        Marshal.FreeHGlobal(request.dataPtr);
+                    }
+                }
+
+                // Give the result back to the caller.
+                return result;
+            }
+
+            /// <summary>
+            /// Callback function for the events of all asynchronous session operations. It
+            /// is called by the library from within BltSessionProcessEvents and passes the
+            /// event on to the callback of the application.
+            /// </summary>
+            /// <param name="sessionEvent">The event.</param>
+            /// <param name="context">Identifier of the request.</param>
+            private static void AsyncDispatch(ref SessionEvent sessionEvent, IntPtr context)
+            {
+                AsyncRequest request;
+
+                // Look up the request.
+                if (asyncRequests.TryGetValue(context.ToInt64(), out request))
+                {
+                    // Release the request once the operation completed. For a read operation,
+                    // the uploaded data is copied to the array of the application first.
+                    if (sessionEvent.eventType == EVENT_COMPLETED)
+                    {
+                        asyncRequests.Remove(context.ToInt64());
+                        if (request.dataPtr != IntPtr.Zero)
+                        {
+                            if ((request.readData != null) && (sessionEvent.result == RESULT_OK))
+                            {
+                                Marshal.Copy(request.dataPtr, request.readData, 0, request.readData.Length);
+                            }
+                            Marshal.FreeHGlobal(request.dataPtr);
+                        }
+                    }
+                    // Pass the event on to the callback of the application.
+                    if (request.callback != null)
+                    {
+                        request.callback(sessionEvent);
+                    }
+                }
+            }
         }
 
         /// <summary>
@@ -1115,6 +2213,32 @@ namespace OpenBLT
             {
                 BltFirmwareClearData();
             }
+
+            [DllImport(LIBNAME, CharSet = CharSet.Ansi, CallingConvention = CallingConvention.Cdecl)]
+            private static extern void BltFirmwareSetCache(String directory, UInt32 maxSize);
+
+            /// <summary>
+            /// Enables or disables the firmware cache. With the cache enabled, LoadFromFile
+            /// stores the parsed firmware data in a cache file, named after the checksum of
+            /// the contents of the firmware file, and loads it from there the next time
+            /// that the same contents are loaded. The least recently used cache files are
+            /// removed once the cache files take more space than allowed.
+            /// </summary>
+            /// <param name="directory">
+            /// Existing directory for the cache files. Null to disable the cache.
+            /// </param>
+            /// <param name="maxSize">
+            /// Maximum total size of the cache files in kilobytes. 0 for no limit.
+            /// </param>
+            /// <example>
+            /// <code>
+            /// OpenBLT.Lib.Firmware.SetCache("fwcache", 262144);
+            /// </code>
+            /// </example>
+            public static void SetCache(String directory, UInt32 maxSize)
+            {
+                BltFirmwareSetCache(directory, maxSize);
+            }
         }
 
         /// <summary>
@@ -79,6 +79,18 @@ const
   BLT_TRANSPORT_XCP_V10_USB: LongWord = 2;
   // Transport layer for the XCP v1.0 protocol that uses TCP/IP for data exchange.
   BLT_TRANSPORT_XCP_V10_NET: LongWord = 3;
+  // Transport layer for the XCP v1.0 protocol that uses UDP/IP for data exchange.
+  BLT_TRANSPORT_XCP_V10_UDP: LongWord = 4;
+  // Operation types of the asynchronous session functions.
+  BLT_SESSION_OP_START: LongWord = 0;
+  BLT_SESSION_OP_STOP: LongWord = 1;
+  BLT_SESSION_OP_CLEAR_MEMORY: LongWord = 2;
+  BLT_SESSION_OP_WRITE_DATA: LongWord = 3;
+  BLT_SESSION_OP_READ_DATA: LongWord = 4;
+  // Event type of an asynchronous session operation that made progress.
+  BLT_SESSION_EVENT_PROGRESS: LongWord = 0;
+  // Event type of an asynchronous session operation that completed.
+  BLT_SESSION_EVENT_COMPLETED: LongWord = 1;
 
 
 type
@@ -108,14 +120,52 @@ type
     transmitId: LongWord;         // Transmit CAN identifier.
     receiveId: LongWord;          // Receive CAN identifier.
     useExtended: LongWord;        // Boolean to configure 29-bit CAN identifiers.
+    txFrameGap: LongWord;         // Minimum time between tx frames in microseconds.
   end;
 
   // Structure layout of the XCP version 1.0 NET transport layer settings.
   tBltTransportSettingsXcpV10Net = record
     address: PAnsiChar;           // Target IP-address or hostname on the network.
     port: Word;                   // TCP port to use.
+    window: LongWord;             // Maximum number of commands in flight.
   end;
 
+  // Structure layout of the XCP version 1.0 UDP transport layer settings.
+  tBltTransportSettingsXcpV10Udp = record
+    address: PAnsiChar;           // Target IP-address or hostname on the network.
+    port: Word;                   // UDP port to use.
+    window: LongWord;             // Maximum number of commands in flight.
+  end;
+
+  // Structure layout of the command/response latency statistics of a session. All
+  // times are in microseconds.
+  tBltSessionLatency = record
+    count: LongWord;              // Number of measured command/response exchanges.
+    totalAvg: LongWord;           // Average command/response time.
+    hostAvg: LongWord;            // Average time spent on the host.
+    wireAvg: LongWord;            // Average time spent on the medium and in target.
+    totalMax: LongWord;           // Longest command/response time.
+    totalP99: LongWord;           // 99th percentile of the command/response time.
+  end;
+
+  // Structure layout of an event of an asynchronous session operation. The progress is
+  // the number of bytes that were processed so far, out of the total.
+  tBltSessionEvent = record
+    operation: LongWord;          // Operation type (BLT_SESSION_OP_xxx).
+    event: LongWord;              // Event type (BLT_SESSION_EVENT_xxx).
+    result: LongWord;             // Result of a completed operation.
+    progress: LongWord;           // Number of bytes processed so far.
+    total: LongWord;              // Total number of bytes to process.
+  end;
+  PBltSessionEvent = ^tBltSessionEvent;
+
+  // Callback function for the events of an asynchronous session operation. It is only
+  // called from within BltSessionProcessEvents.
+  tBltSessionCallback = procedure(event: PBltSessionEvent; context: Pointer); cdecl;
+
+  // Handle of a firmware update session that was created with BltSessionCreate.
+  tBltSessionHandle = Pointer;
+
 
 procedure BltSessionInit(sessionType: LongWord;
                          sessionSettings: Pointer;
@@ -124,7 +174,7 @@ procedure BltSessionInit(sessionType: LongWord;
                          cdecl; external LIBOPENBLT_LIBNAME;
 procedure BltSessionTerminate; cdecl; external LIBOPENBLT_LIBNAME;
 function  BltSessionStart: LongWord; cdecl; external LIBOPENBLT_LIBNAME;
-procedure BltSessionStop; cdecl; external LIBOPENBLT_LIBNAME;
+function  BltSessionStop: LongWord; cdecl; external LIBOPENBLT_LIBNAME;
 function  BltSessionClearMemory(address: LongWord;
                                 len: LongWord): LongWord;
                                 cdecl; external LIBOPENBLT_LIBNAME;
@@ -136,6 +186,98 @@ function  BltSessionReadData(address: LongWord;
                              len: LongWord;
                              data: PByte): LongWord;
                              cdecl; external LIBOPENBLT_LIBNAME;
+function  BltSessionGetLatency(var latency: tBltSessionLatency): LongWord;
+                               cdecl; external LIBOPENBLT_LIBNAME;
+function  BltSessionKeepTransport(keep: LongWord): LongWord;
+                                  cdecl; external LIBOPENBLT_LIBNAME;
+function  BltSessionStartAsync(callback: tBltSessionCallback;
+                               context: Pointer): LongWord;
+                               cdecl; external LIBOPENBLT_LIBNAME;
+function  BltSessionStopAsync(callback: tBltSessionCallback;
+                              context: Pointer): LongWord;
+                              cdecl; external LIBOPENBLT_LIBNAME;
+function  BltSessionClearMemoryAsync(address: LongWord;
+                                     len: LongWord;
+                                     callback: tBltSessionCallback;
+                                     context: Pointer): LongWord;
+                                     cdecl; external LIBOPENBLT_LIBNAME;
+function  BltSessionWriteDataAsync(address: LongWord;
+                                   len: LongWord;
+                                   data: PByte;
+                                   callback: tBltSessionCallback;
+                                   context: Pointer): LongWord;
+                                   cdecl; external LIBOPENBLT_LIBNAME;
+function  BltSessionReadDataAsync(address: LongWord;
+                                  len: LongWord;
+                                  data: PByte;
+                                  callback: tBltSessionCallback;
+                                  context: Pointer): LongWord;
+                                  cdecl; external LIBOPENBLT_LIBNAME;
+function  BltSessionProcessEvents(timeout: LongWord): LongWord;
+                                  cdecl; external LIBOPENBLT_LIBNAME;
+procedure BltSessionCancelAsync; cdecl; external LIBOPENBLT_LIBNAME;
+function  BltSessionGetEventHandle: PtrInt; cdecl; external LIBOPENBLT_LIBNAME;
+function  BltSessionCreate(sessionType: LongWord;
+                           sessionSettings: Pointer;
+                           transportType: LongWord;
+                           transportSettings: Pointer): tBltSessionHandle;
+                           cdecl; external LIBOPENBLT_LIBNAME;
+procedure BltSessionDestroy(session: tBltSessionHandle);
+                            cdecl; external LIBOPENBLT_LIBNAME;
+function  BltSessionHandleStart(session: tBltSessionHandle): LongWord;
+                                cdecl; external LIBOPENBLT_LIBNAME;
+function  BltSessionHandleStop(session: tBltSessionHandle): LongWord;
+                               cdecl; external LIBOPENBLT_LIBNAME;
+function  BltSessionHandleClearMemory(session: tBltSessionHandle;
+                                      address: LongWord;
+                                      len: LongWord): LongWord;
+                                      cdecl; external LIBOPENBLT_LIBNAME;
+function  BltSessionHandleWriteData(session: tBltSessionHandle;
+                                    address: LongWord;
+                                    len: LongWord;
+                                    data: PByte): LongWord;
+                                    cdecl; external LIBOPENBLT_LIBNAME;
+function  BltSessionHandleReadData(session: tBltSessionHandle;
+                                   address: LongWord;
+                                   len: LongWord;
+                                   data: PByte): LongWord;
+                                   cdecl; external LIBOPENBLT_LIBNAME;
+function  BltSessionHandleGetLatency(session: tBltSessionHandle;
+                                     var latency: tBltSessionLatency): LongWord;
+                                     cdecl; external LIBOPENBLT_LIBNAME;
+function  BltSessionHandleKeepTransport(session: tBltSessionHandle;
+                                        keep: LongWord): LongWord;
+                                        cdecl; external LIBOPENBLT_LIBNAME;
+function  BltSessionHandleStartAsync(session: tBltSessionHandle;
+                                     callback: tBltSessionCallback;
+                                     context: Pointer): LongWord;
+                                     cdecl; external LIBOPENBLT_LIBNAME;
+function  BltSessionHandleStopAsync(session: tBltSessionHandle;
+                                    callback: tBltSessionCallback;
+                                    context: Pointer): LongWord;
+                                    cdecl; external LIBOPENBLT_LIBNAME;
+function  BltSessionHandleClearMemoryAsync(session: tBltSessionHandle;
+                                           address: LongWord;
+                                           len: LongWord;
+                                           callback: tBltSessionCallback;
+                                           context: Pointer): LongWord;
+                                           cdecl; external LIBOPENBLT_LIBNAME;
+function  BltSessionHandleWriteDataAsync(session: tBltSessionHandle;
+                                         address: LongWord;
+                                         len: LongWord;
+                                         data: PByte;
+                                         callback: tBltSessionCallback;
+                                         context: Pointer): LongWord;
+                                         cdecl; external LIBOPENBLT_LIBNAME;
+function  BltSessionHandleReadDataAsync(session: tBltSessionHandle;
+                                        address: LongWord;
+                                        len: LongWord;
+                                        data: PByte;
+                                        callback: tBltSessionCallback;
+                                        context: Pointer): LongWord;
+                                        cdecl; external LIBOPENBLT_LIBNAME;
+procedure BltSessionHandleCancelAsync(session: tBltSessionHandle);
+                                      cdecl; external LIBOPENBLT_LIBNAME;
 
 
 //***************************************************************************************
@@ -167,21 +309,52 @@ function  BltFirmwareRemoveData(address: LongWord;
                                len: LongWord): LongWord;
                                cdecl; external LIBOPENBLT_LIBNAME;
 procedure BltFirmwareClearData; cdecl; external LIBOPENBLT_LIBNAME;
+procedure BltFirmwareSetCache(directory: PAnsiChar;
+                              maxSize: LongWord);
+                              cdecl; external LIBOPENBLT_LIBNAME;
 
 
 //***************************************************************************************
 //             G E N E R I C   U T I L I T I E S
 //***************************************************************************************
+type
+  // Handle of an AES256 cryptography context that was created with
+  // BltUtilCryptoAes256Create.
+  tBltAes256Handle = Pointer;
+
 function BltUtilCrc16Calculate(data: PByte; len: LongWord): Word; 
                                cdecl; external LIBOPENBLT_LIBNAME;
 function BltUtilCrc32Calculate(data: PByte; len: LongWord): LongWord; 
                                cdecl; external LIBOPENBLT_LIBNAME;
+function BltUtilCrc16Init: Word; cdecl; external LIBOPENBLT_LIBNAME;
+function BltUtilCrc16Update(crc: Word; data: PByte; len: LongWord): Word;
+                            cdecl; external LIBOPENBLT_LIBNAME;
+function BltUtilCrc16Final(crc: Word): Word; cdecl; external LIBOPENBLT_LIBNAME;
+function BltUtilCrc16Combine(crc1: Word; crc2: Word; len2: LongWord): Word;
+                             cdecl; external LIBOPENBLT_LIBNAME;
+function BltUtilCrc32Init: LongWord; cdecl; external LIBOPENBLT_LIBNAME;
+function BltUtilCrc32Update(crc: LongWord; data: PByte; len: LongWord): LongWord;
+                            cdecl; external LIBOPENBLT_LIBNAME;
+function BltUtilCrc32Final(crc: LongWord): LongWord; cdecl; external LIBOPENBLT_LIBNAME;
+function BltUtilCrc32Combine(crc1: LongWord; crc2: LongWord; len2: LongWord): LongWord;
+                             cdecl; external LIBOPENBLT_LIBNAME;
 function BltUtilTimeGetSystemTime: LongWord; cdecl; external LIBOPENBLT_LIBNAME;
+function BltUtilTimeGetMonotonicUs: QWord; cdecl; external LIBOPENBLT_LIBNAME;
 procedure BltUtilTimeDelayMs(delay: Word); cdecl; external LIBOPENBLT_LIBNAME;
 function BltUtilCryptoAes256Encrypt(data: PByte; len: LongWord; key: PByte): LongWord;
                                     cdecl; external LIBOPENBLT_LIBNAME;
 function BltUtilCryptoAes256Decrypt(data: PByte; len: LongWord; key: PByte): LongWord;
                                     cdecl; external LIBOPENBLT_LIBNAME;
+function BltUtilCryptoAes256Create(key: PByte): tBltAes256Handle;
+                                   cdecl; external LIBOPENBLT_LIBNAME;
+procedure BltUtilCryptoAes256Destroy(crypto: tBltAes256Handle);
+                                     cdecl; external LIBOPENBLT_LIBNAME;
+function BltUtilCryptoAes256HandleEncrypt(crypto: tBltAes256Handle; data: PByte;
+                                          len: LongWord): LongWord;
+                                          cdecl; external LIBOPENBLT_LIBNAME;
+function BltUtilCryptoAes256HandleDecrypt(crypto: tBltAes256Handle; data: PByte;
+                                          len: LongWord): LongWord;
+                                          cdecl; external LIBOPENBLT_LIBNAME;
 
 
 implementation
@@ -54,17 +54,39 @@ from openblt.lib import BLT_TRANSPORT_XCP_V10_RS232
 from openblt.lib import BLT_TRANSPORT_XCP_V10_CAN
 from openblt.lib import BLT_TRANSPORT_XCP_V10_USB
 from openblt.lib import BLT_TRANSPORT_XCP_V10_NET
+from openblt.lib import BLT_TRANSPORT_XCP_V10_UDP
 from openblt.lib import BltSessionSettingsXcpV10
 from openblt.lib import BltTransportSettingsXcpV10Rs232
 from openblt.lib import BltTransportSettingsXcpV10Can
 from openblt.lib import BltTransportSettingsXcpV10Net
+from openblt.lib import BltTransportSettingsXcpV10Udp
+from openblt.lib import BLT_SESSION_OP_START
+from openblt.lib import BLT_SESSION_OP_STOP
+from openblt.lib import BLT_SESSION_OP_CLEAR_MEMORY
+from openblt.lib import BLT_SESSION_OP_WRITE_DATA
+from openblt.lib import BLT_SESSION_OP_READ_DATA
+from openblt.lib import BLT_SESSION_EVENT_PROGRESS
+from openblt.lib import BLT_SESSION_EVENT_COMPLETED
+from openblt.lib import BltSessionLatency
+from openblt.lib import BltSessionEvent
 from openblt.lib import session_init
 from openblt.lib import session_terminate
+from openblt.lib import session_create
+from openblt.lib import session_destroy
 from openblt.lib import session_start
 from openblt.lib import session_stop
 from openblt.lib import session_clear_memory
 from openblt.lib import session_write_data
 from openblt.lib import session_read_data
+from openblt.lib import session_get_latency
+from openblt.lib import session_start_async
+from openblt.lib import session_stop_async
+from openblt.lib import session_clear_memory_async
+from openblt.lib import session_write_data_async
+from openblt.lib import session_read_data_async
+from openblt.lib import session_process_events
+from openblt.lib import session_cancel_async
+from openblt.lib import session_get_event_handle
 
 
 # ***************************************************************************************
@@ -80,6 +102,7 @@ from openblt.lib import firmware_get_segment
 from openblt.lib import firmware_add_data
 from openblt.lib import firmware_remove_data
 from openblt.lib import firmware_clear_data
+from openblt.lib import firmware_set_cache
 
 
 # ***************************************************************************************
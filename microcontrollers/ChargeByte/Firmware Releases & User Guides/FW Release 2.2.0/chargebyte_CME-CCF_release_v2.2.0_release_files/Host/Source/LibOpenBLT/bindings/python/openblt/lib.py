@@ -35,6 +35,7 @@ __docformat__ = 'reStructuredText'
 #  Imports
 # ***************************************************************************************
 import ctypes
+import functools
 import sys
 import os
 
@@ -149,6 +150,13 @@ if hasattr(sharedLibraryHandle, 'BltFirmwareClearData'):
     BltFirmwareClearData.restype = None
 
 
+BltFirmwareSetCache = None
+if hasattr(sharedLibraryHandle, 'BltFirmwareSetCache'):
+    BltFirmwareSetCache = sharedLibraryHandle.BltFirmwareSetCache
+    BltFirmwareSetCache.argtypes = [ctypes.c_char_p, ctypes.c_uint32]
+    BltFirmwareSetCache.restype = None
+
+
 BltUtilCrc16Calculate = None
 if hasattr(sharedLibraryHandle, 'BltUtilCrc16Calculate'):
     BltUtilCrc16Calculate = sharedLibraryHandle.BltUtilCrc16Calculate
@@ -221,7 +229,7 @@ BltSessionStop = None
 if hasattr(sharedLibraryHandle, 'BltSessionStop'):
     BltSessionStop = sharedLibraryHandle.BltSessionStop
     BltSessionStop.argtypes = []
-    BltSessionStop.restype = None
+    BltSessionStop.restype = ctypes.c_uint32
 
 
 BltSessionClearMemory = None
@@ -246,6 +254,192 @@ if hasattr(sharedLibraryHandle, 'BltSessionReadData'):
                                    ctypes.POINTER(ctypes.c_uint8)]
 
 
+BltSessionGetLatency = None
+if hasattr(sharedLibraryHandle, 'BltSessionGetLatency'):
+    BltSessionGetLatency = sharedLibraryHandle.BltSessionGetLatency
+    BltSessionGetLatency.argtypes = [ctypes.c_void_p]
+    BltSessionGetLatency.restype = ctypes.c_uint32
+
+
+# C-types prototype of the callback function for asynchronous session operations.
+BltSessionCallback = ctypes.CFUNCTYPE(None, ctypes.c_void_p, ctypes.c_void_p)
+
+
+BltSessionStartAsync = None
+if hasattr(sharedLibraryHandle, 'BltSessionStartAsync'):
+    BltSessionStartAsync = sharedLibraryHandle.BltSessionStartAsync
+    BltSessionStartAsync.argtypes = [BltSessionCallback, ctypes.c_void_p]
+    BltSessionStartAsync.restype = ctypes.c_uint32
+
+
+BltSessionStopAsync = None
+if hasattr(sharedLibraryHandle, 'BltSessionStopAsync'):
+    BltSessionStopAsync = sharedLibraryHandle.BltSessionStopAsync
+    BltSessionStopAsync.argtypes = [BltSessionCallback, ctypes.c_void_p]
+    BltSessionStopAsync.restype = ctypes.c_uint32
+
+
+BltSessionClearMemoryAsync = None
+if hasattr(sharedLibraryHandle, 'BltSessionClearMemoryAsync'):
+    BltSessionClearMemoryAsync = sharedLibraryHandle.BltSessionClearMemoryAsync
+    BltSessionClearMemoryAsync.argtypes = [ctypes.c_uint32, ctypes.c_uint32,
+                                           BltSessionCallback, ctypes.c_void_p]
+    BltSessionClearMemoryAsync.restype = ctypes.c_uint32
+
+
+BltSessionWriteDataAsync = None
+if hasattr(sharedLibraryHandle, 'BltSessionWriteDataAsync'):
+    BltSessionWriteDataAsync = sharedLibraryHandle.BltSessionWriteDataAsync
+    BltSessionWriteDataAsync.argtypes = [ctypes.c_uint32, ctypes.c_uint32,
+                                         ctypes.POINTER(ctypes.c_uint8),
+                                         BltSessionCallback, ctypes.c_void_p]
+    BltSessionWriteDataAsync.restype = ctypes.c_uint32
+
+
+BltSessionReadDataAsync = None
+if hasattr(sharedLibraryHandle, 'BltSessionReadDataAsync'):
+    BltSessionReadDataAsync = sharedLibraryHandle.BltSessionReadDataAsync
+    BltSessionReadDataAsync.argtypes = [ctypes.c_uint32, ctypes.c_uint32,
+                                        ctypes.POINTER(ctypes.c_uint8),
+                                        BltSessionCallback, ctypes.c_void_p]
+    BltSessionReadDataAsync.restype = ctypes.c_uint32
+
+
+BltSessionProcessEvents = None
+if hasattr(sharedLibraryHandle, 'BltSessionProcessEvents'):
+    BltSessionProcessEvents = sharedLibraryHandle.BltSessionProcessEvents
+    BltSessionProcessEvents.argtypes = [ctypes.c_uint32]
+    BltSessionProcessEvents.restype = ctypes.c_uint32
+
+
+BltSessionCancelAsync = None
+if hasattr(sharedLibraryHandle, 'BltSessionCancelAsync'):
+    BltSessionCancelAsync = sharedLibraryHandle.BltSessionCancelAsync
+    BltSessionCancelAsync.argtypes = []
+    BltSessionCancelAsync.restype = None
+
+
+BltSessionGetEventHandle = None
+if hasattr(sharedLibraryHandle, 'BltSessionGetEventHandle'):
+    BltSessionGetEventHandle = sharedLibraryHandle.BltSessionGetEventHandle
+    BltSessionGetEventHandle.argtypes = []
+    BltSessionGetEventHandle.restype = ctypes.c_ssize_t
+
+
+BltSessionCreate = None
+if hasattr(sharedLibraryHandle, 'BltSessionCreate'):
+    BltSessionCreate = sharedLibraryHandle.BltSessionCreate
+    BltSessionCreate.argtypes = [ctypes.c_uint32, ctypes.c_void_p, ctypes.c_uint32,
+                                 ctypes.c_void_p]
+    BltSessionCreate.restype = ctypes.c_void_p
+
+
+BltSessionDestroy = None
+if hasattr(sharedLibraryHandle, 'BltSessionDestroy'):
+    BltSessionDestroy = sharedLibraryHandle.BltSessionDestroy
+    BltSessionDestroy.argtypes = [ctypes.c_void_p]
+    BltSessionDestroy.restype = None
+
+
+BltSessionHandleStart = None
+if hasattr(sharedLibraryHandle, 'BltSessionHandleStart'):
+    BltSessionHandleStart = sharedLibraryHandle.BltSessionHandleStart
+    BltSessionHandleStart.argtypes = [ctypes.c_void_p]
+    BltSessionHandleStart.restype = ctypes.c_uint32
+
+
+BltSessionHandleStop = None
+if hasattr(sharedLibraryHandle, 'BltSessionHandleStop'):
+    BltSessionHandleStop = sharedLibraryHandle.BltSessionHandleStop
+    BltSessionHandleStop.argtypes = [ctypes.c_void_p]
+    BltSessionHandleStop.restype = ctypes.c_uint32
+
+
+BltSessionHandleClearMemory = None
+if hasattr(sharedLibraryHandle, 'BltSessionHandleClearMemory'):
+    BltSessionHandleClearMemory = sharedLibraryHandle.BltSessionHandleClearMemory
+    BltSessionHandleClearMemory.argtypes = [ctypes.c_void_p, ctypes.c_uint32,
+                                            ctypes.c_uint32]
+    BltSessionHandleClearMemory.restype = ctypes.c_uint32
+
+
+BltSessionHandleWriteData = None
+if hasattr(sharedLibraryHandle, 'BltSessionHandleWriteData'):
+    BltSessionHandleWriteData = sharedLibraryHandle.BltSessionHandleWriteData
+    BltSessionHandleWriteData.argtypes = [ctypes.c_void_p, ctypes.c_uint32,
+                                          ctypes.c_uint32,
+                                          ctypes.POINTER(ctypes.c_uint8)]
+    BltSessionHandleWriteData.restype = ctypes.c_uint32
+
+
+BltSessionHandleReadData = None
+if hasattr(sharedLibraryHandle, 'BltSessionHandleReadData'):
+    BltSessionHandleReadData = sharedLibraryHandle.BltSessionHandleReadData
+    BltSessionHandleReadData.argtypes = [ctypes.c_void_p, ctypes.c_uint32,
+                                         ctypes.c_uint32, ctypes.POINTER(ctypes.c_uint8)]
+    BltSessionHandleReadData.restype = ctypes.c_uint32
+
+
+BltSessionHandleGetLatency = None
+if hasattr(sharedLibraryHandle, 'BltSessionHandleGetLatency'):
+    BltSessionHandleGetLatency = sharedLibraryHandle.BltSessionHandleGetLatency
+    BltSessionHandleGetLatency.argtypes = [ctypes.c_void_p, ctypes.c_void_p]
+    BltSessionHandleGetLatency.restype = ctypes.c_uint32
+
+
+BltSessionHandleStartAsync = None
+if hasattr(sharedLibraryHandle, 'BltSessionHandleStartAsync'):
+    BltSessionHandleStartAsync = sharedLibraryHandle.BltSessionHandleStartAsync
+    BltSessionHandleStartAsync.argtypes = [ctypes.c_void_p, BltSessionCallback,
+                                           ctypes.c_void_p]
+    BltSessionHandleStartAsync.restype = ctypes.c_uint32
+
+
+BltSessionHandleStopAsync = None
+if hasattr(sharedLibraryHandle, 'BltSessionHandleStopAsync'):
+    BltSessionHandleStopAsync = sharedLibraryHandle.BltSessionHandleStopAsync
+    BltSessionHandleStopAsync.argtypes = [ctypes.c_void_p, BltSessionCallback,
+                                          ctypes.c_void_p]
+    BltSessionHandleStopAsync.restype = ctypes.c_uint32
+
+
+BltSessionHandleClearMemoryAsync = None
+if hasattr(sharedLibraryHandle, 'BltSessionHandleClearMemoryAsync'):
+    BltSessionHandleClearMemoryAsync = \
+        sharedLibraryHandle.BltSessionHandleClearMemoryAsync
+    BltSessionHandleClearMemoryAsync.argtypes = [ctypes.c_void_p, ctypes.c_uint32,
+                                                 ctypes.c_uint32, BltSessionCallback,
+                                                 ctypes.c_void_p]
+    BltSessionHandleClearMemoryAsync.restype = ctypes.c_uint32
+
+
+BltSessionHandleWriteDataAsync = None
+if hasattr(sharedLibraryHandle, 'BltSessionHandleWriteDataAsync'):
+    BltSessionHandleWriteDataAsync = sharedLibraryHandle.BltSessionHandleWriteDataAsync
+    BltSessionHandleWriteDataAsync.argtypes = [ctypes.c_void_p, ctypes.c_uint32,
+                                               ctypes.c_uint32,
+                                               ctypes.POINTER(ctypes.c_uint8),
+                                               BltSessionCallback, ctypes.c_void_p]
+    BltSessionHandleWriteDataAsync.restype = ctypes.c_uint32
+
+
+BltSessionHandleReadDataAsync = None
+if hasattr(sharedLibraryHandle, 'BltSessionHandleReadDataAsync'):
+    BltSessionHandleReadDataAsync = sharedLibraryHandle.BltSessionHandleReadDataAsync
+    BltSessionHandleReadDataAsync.argtypes = [ctypes.c_void_p, ctypes.c_uint32,
+                                              ctypes.c_uint32,
+                                              ctypes.POINTER(ctypes.c_uint8),
+                                              BltSessionCallback, ctypes.c_void_p]
+    BltSessionHandleReadDataAsync.restype = ctypes.c_uint32
+
+
+BltSessionHandleCancelAsync = None
+if hasattr(sharedLibraryHandle, 'BltSessionHandleCancelAsync'):
+    BltSessionHandleCancelAsync = sharedLibraryHandle.BltSessionHandleCancelAsync
+    BltSessionHandleCancelAsync.argtypes = [ctypes.c_void_p]
+    BltSessionHandleCancelAsync.restype = None
+
+
 # ***************************************************************************************
 #  Constant declarations
 # ***************************************************************************************
@@ -577,6 +771,34 @@ def firmware_clear_data():
         BltFirmwareClearData()
 
 
+def firmware_set_cache(directory, max_size):
+    """
+    Enables or disables the firmware cache. With the cache enabled, firmware_load_from_file
+    stores the parsed firmware data in a cache file, named after the checksum of the
+    contents of the firmware file, and loads it from there the next time that the same
+    contents are loaded. The least recently used cache files are removed once the cache
+    files take more space than allowed.
+
+    :param directory: Existing directory for the cache files. None to disable the cache.
+    :param max_size: Maximum total size of the cache files in kilobytes. 0 for no limit.
+
+    :Example:
+    ::
+
+        import openblt
+
+        openblt.firmware_set_cache('fwcache', 262144)
+    """
+    # Check if the shared library function could be imported.
+    if BltFirmwareSetCache is not None:
+        # Call the function in the shared library
+        if directory is None:
+            BltFirmwareSetCache(None, ctypes.c_uint32(max_size))
+        else:
+            BltFirmwareSetCache(ctypes.c_char_p(directory.encode('utf-8')),
+                                ctypes.c_uint32(max_size))
+
+
 # ***************************************************************************************
 #              G E N E R I C   U T I L I T I E S
 # ***************************************************************************************
@@ -818,6 +1040,14 @@ BLT_TRANSPORT_XCP_V10_RS232 = 0
 BLT_TRANSPORT_XCP_V10_CAN = 1
 BLT_TRANSPORT_XCP_V10_USB = 2
 BLT_TRANSPORT_XCP_V10_NET = 3
+BLT_TRANSPORT_XCP_V10_UDP = 4
+BLT_SESSION_OP_START = 0
+BLT_SESSION_OP_STOP = 1
+BLT_SESSION_OP_CLEAR_MEMORY = 2
+BLT_SESSION_OP_WRITE_DATA = 3
+BLT_SESSION_OP_READ_DATA = 4
+BLT_SESSION_EVENT_PROGRESS = 0
+BLT_SESSION_EVENT_COMPLETED = 1
 
 
 # ***************************************************************************************
@@ -872,7 +1102,9 @@ class BltTransportSettingsXcpV10Can:
     following: "peak_pcanusb", "kvaser_leaflight", or "lawicel_canusb". Field use 
     extended is a boolean field. When set to 0, the specified transmitId and receiveId 
     are assumed to be 11-bit standard CAN identifier. It the field is 1, these 
-    identifiers are assumed to be 29-bit extended CAN identifiers.
+    identifiers are assumed to be 29-bit extended CAN identifiers. Field txFrameGap
+    configures the minimum time in microseconds between two transmitted CAN frames. A
+    value of 0 disables the pacing.
     """
     def __init__(self):
         """
@@ -885,6 +1117,7 @@ class BltTransportSettingsXcpV10Can:
         self.transmitId = 0x667       # Transmit CAN identifier.
         self.receiveId = 0x7E1        # Receive CAN identifier.
         self.useExtended = 0          # Boolean to configure 29-bit CAN identifiers.
+        self.txFrameGap = 0           # Minimum time between tx frames in microseconds.
 
 
 class BltTransportSettingsXcpV10Net:
@@ -892,7 +1125,9 @@ class BltTransportSettingsXcpV10Net:
     Class with the layout of the XCP version 1.0 NET transport layer settings. The
     address field can be set to either the IP address or the hostname, such as
     "192.168.178.23" or "mymicro.mydomain.com". The port should be set to the TCP port 
-    number that the bootloader target listens on.
+    number that the bootloader target listens on. The window sets the maximum number
+    of program commands in flight. Only set it larger than 1 for a target that buffers
+    received commands.
     """
     def __init__(self):
         """
@@ -901,47 +1136,107 @@ class BltTransportSettingsXcpV10Net:
         # Set default values for instance variables.
         self.address = ''             # Target IP-address or hostname on the network.
         self.port = 1000              # TCP port to use.
+        self.window = 1               # Maximum number of commands in flight.
 
 
-# ***************************************************************************************
-#  Functions
-# ***************************************************************************************
-def session_init(session_type, session_settings, transport_type, transport_settings):
+class BltTransportSettingsXcpV10Udp:
     """
-    Initializes the firmware update session for a specific communication protocol and 
-    transport layer. This function is typically called once at the start of the firmware
-    update.
+    Class with the layout of the XCP version 1.0 UDP transport layer settings. The
+    address field can be set to either the IP address or the hostname, such as
+    "192.168.178.23" or "mymicro.mydomain.com". The port should be set to the UDP port
+    number that the bootloader target listens on. The window sets the maximum number
+    of program commands in flight. Only set it larger than 1 for a target that buffers
+    received datagrams.
+    """
+    def __init__(self):
+        """
+        Class constructor.
+        """
+        # Set default values for instance variables.
+        self.address = ''             # Target IP-address or hostname on the network.
+        self.port = 1000              # UDP port to use.
+        self.window = 1               # Maximum number of commands in flight.
 
-    :param session_type: The communication protocol to use for this session. It should
-           be a BLT_SESSION_xxx value.
-    :param session_settings: Instance of class BltSessionSettingsXxx with communication 
-           protocol specific settings.
-    :param transport_type: The transport layer to use for the specified communication
-           protocol. It should be a BLT_TRANSPORT_xxx value.           
-    :param transport_settings: Instance of class BltTransportSettingsXxx with transport 
-           layer specific settings.
 
-    :Example:
-    ::
+class BltSessionLatency:
+    """
+    Class with the layout of the command/response latency statistics of a session. The
+    command/response time of each exchange with the target is split into the time spent
+    on the host and the time spent on the communication medium and in the target (wire
+    time). The split relies on time stamps from the transport layer. It is currently
+    only supported by the CAN transport layer. For other transport layers the entire
+    command/response time counts as wire time. All times are in microseconds.
+    """
+    def __init__(self):
+        """
+        Class constructor.
+        """
+        # Set default values for instance variables.
+        self.count = 0                # Number of measured command/response exchanges.
+        self.totalAvg = 0             # Average command/response time.
+        self.hostAvg = 0              # Average time spent on the host.
+        self.wireAvg = 0              # Average time spent on the medium and in target.
+        self.totalMax = 0             # Longest command/response time.
+        self.totalP99 = 0             # 99th percentile of the command/response time.
 
-        import openblt
 
-        session_type = openblt.BLT_SESSION_XCP_V10
-        session_settings = openblt.BltSessionSettingsXcpV10()
-        session_settings.timeoutT1 = 1000
-        session_settings.timeoutT3 = 2000
-        session_settings.timeoutT4 = 10000
-        session_settings.timeoutT5 = 1000
-        session_settings.timeoutT6 = 50
-        session_settings.timeoutT7 = 2000
-        session_settings.seedKeyFile = ''
-        session_settings.connectMode = 0
-        transport_type = openblt.BLT_TRANSPORT_XCP_V10_RS232
-        transport_settings = openblt.BltTransportSettingsXcpV10Rs232()
-        transport_settings.portName = '/dev/ttyACM0'
-        transport_settings.baudrate = 57600
-        openblt.session_init(session_type, session_settings,
-                             transport_type, transport_settings)
+class BltSessionEvent:
+    """
+    Class with the layout of an event of an asynchronous session operation. The progress
+    is the number of bytes that were processed so far, out of the total. For start and
+    stop operations, both are 0. The result is only valid for a completion event.
+    """
+    def __init__(self):
+        """
+        Class constructor.
+        """
+        # Set default values for instance variables.
+        self.operation = 0            # Operation type (BLT_SESSION_OP_xxx).
+        self.event = 0                # Event type (BLT_SESSION_EVENT_xxx).
+        self.result = 0               # Result of a completed operation.
+        self.progress = 0             # Number of bytes processed so far.
+        self.total = 0                # Total number of bytes to process.
+
+
+class _struct_t_blt_session_event(ctypes.Structure):
+    """
+    C-types structure for mapping to BltSessionEvent
+    """
+    _fields_ = [('operation', ctypes.c_uint32),
+                ('event',     ctypes.c_uint32),
+                ('result',    ctypes.c_uint32),
+                ('progress',  ctypes.c_uint32),
+                ('total',     ctypes.c_uint32)]
+
+
+# ***************************************************************************************
+#  Local data declarations
+# ***************************************************************************************
+# Requests of the asynchronous session operations that did not yet complete, indexed by
+# their identifier. Each request holds the callback of the caller, the c-byte array with
+# the data and, for a read operation, the list to store the uploaded data in. They must
+# stay referenced until the operation completed.
+_session_async_requests = {}
+_session_async_next_id = 1
+
+
+# ***************************************************************************************
+#  Functions
+# ***************************************************************************************
+def _session_convert_settings(session_type, session_settings, transport_type,
+                              transport_settings):
+    """
+    Converts the communication protocol and transport layer settings to the c-types
+    structures that the shared library expects.
+
+    :param session_type: The communication protocol. It should be a BLT_SESSION_xxx
+           value.
+    :param session_settings: Instance of class BltSessionSettingsXxx.
+    :param transport_type: The transport layer. It should be a BLT_TRANSPORT_xxx value.
+    :param transport_settings: Instance of class BltTransportSettingsXxx.
+    :returns: Tuple with the pointers to the session and transport settings structures.
+              A pointer is None if the type has no settings.
+    :rtype: tuple
     """
     class struct_t_blt_session_settings_xcp_v10(ctypes.Structure):
         """
@@ -972,14 +1267,24 @@ def session_init(session_type, session_settings, transport_type, transport_setti
                     ('baudrate',      ctypes.c_uint32),
                     ('transmitId',    ctypes.c_uint32),
                     ('receiveId',     ctypes.c_uint32),
-                    ('useExtended',   ctypes.c_uint32)]
+                    ('useExtended',   ctypes.c_uint32),
+                    ('txFrameGap',    ctypes.c_uint32)]
 
     class struct_t_blt_transport_settings_xcp_v10_net(ctypes.Structure):
         """
         C-types structure for mapping to BltTransportSettingsXcpV10Net
         """
         _fields_ = [('address', ctypes.c_char_p),
-                    ('port',    ctypes.c_uint16)]
+                    ('port',    ctypes.c_uint16),
+                    ('window',  ctypes.c_uint32)]
+
+    class struct_t_blt_transport_settings_xcp_v10_udp(ctypes.Structure):
+        """
+        C-types structure for mapping to BltTransportSettingsXcpV10Udp
+        """
+        _fields_ = [('address', ctypes.c_char_p),
+                    ('port',    ctypes.c_uint16),
+                    ('window',  ctypes.c_uint32)]
 
     # Convert session settings to the correct c-types structure.
     session_settings_struct = None
@@ -1017,24 +1322,81 @@ def session_init(session_type, session_settings, transport_type, transport_setti
             ctypes.c_uint32(transport_settings.receiveId)
         transport_settings_struct.useExtended = \
             ctypes.c_uint32(transport_settings.useExtended)
+        transport_settings_struct.txFrameGap = \
+            ctypes.c_uint32(transport_settings.txFrameGap)
     elif transport_type == BLT_TRANSPORT_XCP_V10_NET:
         transport_settings_struct = struct_t_blt_transport_settings_xcp_v10_net()
         transport_settings_struct.address = \
             ctypes.c_char_p(transport_settings.address.encode('utf-8'))
         transport_settings_struct.port = \
             ctypes.c_uint16(transport_settings.port)
+        transport_settings_struct.window = \
+            ctypes.c_uint32(transport_settings.window)
+    elif transport_type == BLT_TRANSPORT_XCP_V10_UDP:
+        transport_settings_struct = struct_t_blt_transport_settings_xcp_v10_udp()
+        transport_settings_struct.address = \
+            ctypes.c_char_p(transport_settings.address.encode('utf-8'))
+        transport_settings_struct.port = \
+            ctypes.c_uint16(transport_settings.port)
+        transport_settings_struct.window = \
+            ctypes.c_uint32(transport_settings.window)
+
+    # Prepare pointer parameters.
+    if session_settings_struct == None:
+        session_settings_struct_ptr = None
+    else:
+        session_settings_struct_ptr = ctypes.pointer(session_settings_struct)
+    if transport_settings_struct == None:
+        transport_settings_struct_ptr = None
+    else:
+        transport_settings_struct_ptr = ctypes.pointer(transport_settings_struct)
+    # Give the pointers back to the caller.
+    return session_settings_struct_ptr, transport_settings_struct_ptr
+
+
+def session_init(session_type, session_settings, transport_type, transport_settings):
+    """
+    Initializes the firmware update session for a specific communication protocol and 
+    transport layer. This function is typically called once at the start of the firmware
+    update.
+
+    :param session_type: The communication protocol to use for this session. It should
+           be a BLT_SESSION_xxx value.
+    :param session_settings: Instance of class BltSessionSettingsXxx with communication 
+           protocol specific settings.
+    :param transport_type: The transport layer to use for the specified communication
+           protocol. It should be a BLT_TRANSPORT_xxx value.           
+    :param transport_settings: Instance of class BltTransportSettingsXxx with transport 
+           layer specific settings.
 
+    :Example:
+    ::
+
+        import openblt
+
+        session_type = openblt.BLT_SESSION_XCP_V10
+        session_settings = openblt.BltSessionSettingsXcpV10()
+        session_settings.timeoutT1 = 1000
+        session_settings.timeoutT3 = 2000
+        session_settings.timeoutT4 = 10000
+        session_settings.timeoutT5 = 1000
+        session_settings.timeoutT6 = 50
+        session_settings.timeoutT7 = 2000
+        session_settings.seedKeyFile = ''
+        session_settings.connectMode = 0
+        transport_type = openblt.BLT_TRANSPORT_XCP_V10_RS232
+        transport_settings = openblt.BltTransportSettingsXcpV10Rs232()
+        transport_settings.portName = '/dev/ttyACM0'
+        transport_settings.baudrate = 57600
+        openblt.session_init(session_type, session_settings,
+                             transport_type, transport_settings)
+    """
     # Check if the shared library function could be imported.
     if BltSessionInit is not None:
-        # Prepare pointer parameters
-        if session_settings_struct == None:
-            session_settings_struct_ptr = None
-        else:
-            session_settings_struct_ptr = ctypes.byref(session_settings_struct)
-        if transport_settings_struct == None:
-            transport_settings_struct_ptr = None
-        else:
-            transport_settings_struct_ptr = ctypes.byref(transport_settings_struct)
+        # Convert the settings to c-types structures.
+        session_settings_struct_ptr, transport_settings_struct_ptr = \
+            _session_convert_settings(session_type, session_settings,
+                                      transport_type, transport_settings)
         # Call the function in the shared library
         BltSessionInit(ctypes.c_uint32(session_type),
                        session_settings_struct_ptr,
@@ -1060,12 +1422,112 @@ def session_terminate():
         BltSessionTerminate()
 
 
-def session_start():
+def session_create(session_type, session_settings, transport_type, transport_settings):
+    """
+    Creates a firmware update session for a specific communication protocol and transport
+    layer. Unlike session_init(), it can be called multiple times to update the firmware
+    on several targets at the same time. The returned session is passed as the session
+    parameter to the other session functions. Each session runs its asynchronous
+    operations on its own worker thread, while session_process_events() passes the
+    events of all sessions on to their callbacks.
+
+    :param session_type: The communication protocol to use for this session. It should
+           be a BLT_SESSION_xxx value.
+    :param session_settings: Instance of class BltSessionSettingsXxx with communication
+           protocol specific settings.
+    :param transport_type: The transport layer to use for the specified communication
+           protocol. It should be a BLT_TRANSPORT_xxx value.
+    :param transport_settings: Instance of class BltTransportSettingsXxx with transport
+           layer specific settings.
+    :returns: The session if successful, None otherwise.
+
+    :Example:
+    ::
+
+        import openblt
+
+        sessions = []
+        for address in [ '192.168.178.23', '192.168.178.24' ]:
+            transport_settings = openblt.BltTransportSettingsXcpV10Net()
+            transport_settings.address = address
+            transport_settings.port = 1000
+            sessions.append(openblt.session_create(openblt.BLT_SESSION_XCP_V10,
+                                                   openblt.BltSessionSettingsXcpV10(),
+                                                   openblt.BLT_TRANSPORT_XCP_V10_NET,
+                                                   transport_settings))
+        for session in sessions:
+            openblt.session_start_async(session=session)
+        while openblt.session_process_events(100) > 0:
+            pass
+    """
+    # Initialize the result.
+    result = None
+    # Check if the shared library function could be imported.
+    if BltSessionCreate is not None:
+        # Convert the settings to c-types structures.
+        session_settings_struct_ptr, transport_settings_struct_ptr = \
+            _session_convert_settings(session_type, session_settings,
+                                      transport_type, transport_settings)
+        # Call the function in the shared library
+        result = BltSessionCreate(ctypes.c_uint32(session_type),
+                                  session_settings_struct_ptr,
+                                  ctypes.c_uint32(transport_type),
+                                  transport_settings_struct_ptr)
+    # Give the result back to the caller.
+    return result
+
+
+def session_destroy(session):
+    """
+    Destroys a firmware update session that was created with session_create(). Its
+    pending asynchronous operations are cancelled and their events are passed on to
+    their callbacks, before the session is released.
+
+    :param session: The session to destroy.
+
+    :Example:
+    ::
+
+        import openblt
+
+        openblt.session_destroy(session)
+    """
+    # Check if the shared library function could be imported.
+    if BltSessionDestroy is not None and session is not None:
+        # Call the function in the shared library
+        BltSessionDestroy(session)
+
+
+def _session_function(func, handle_func, session):
+    """
+    Selects the function in the shared library that operates on the specified session.
+
+    :param func: Function in the shared library for the session of session_init().
+    :param handle_func: Function in the shared library that takes a session created
+           with session_create() as its first parameter.
+    :param session: Session created with session_create(). None for the session of
+           session_init().
+    :returns: The function to call or None if it could not be imported.
+    """
+    # Initialize the result.
+    result = func
+    # Bind the session to the function that operates on a specific session.
+    if session is not None:
+        result = None
+        if handle_func is not None:
+            result = functools.partial(handle_func, session)
+    # Give the result back to the caller.
+    return result
+
+
+def session_start(session=None):
     """
     Starts the firmware update session. This is were the library attempts to activate and
     connect with the bootloader running on the target, through the transport layer that 
     was specified during the session's initialization.
 
+    :param session: Session created with session_create(). None for the session of
+           session_init().
     :returns: BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
     :rtype: int
 
@@ -1079,33 +1541,48 @@ def session_start():
     """
     # Initialize the result.
     result = BLT_RESULT_ERROR_GENERIC
+    # Select the function in the shared library for the session.
+    lib_func = _session_function(BltSessionStart, BltSessionHandleStart, session)
     # Check if the shared library function could be imported.
-    if BltSessionStart is not None:
+    if lib_func is not None:
         # Call the function in the shared library
-        result = BltSessionStart()
+        result = lib_func()
     # Give the result back to the caller.
     return result
 
 
-def session_stop():
+def session_stop(session=None):
     """
     Stops the firmware update session. This is there the library disconnects the 
-    transport layer as well.
+    transport layer as well. An error is reported if the firmware update could not be
+    completed properly. The bootloader then does not start the user program.
+
+    :param session: Session created with session_create(). None for the session of
+           session_init().
+    :returns: BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
+    :rtype: int
 
     :Example:
     ::
 
         import openblt
 
-        openblt.session_stop()
+        if openblt.session_stop() != openblt.BLT_RESULT_OK:
+            print('[ERROR] Could not complete the firmware update.')
     """
+    # Initialize the result.
+    result = BLT_RESULT_ERROR_GENERIC
+    # Select the function in the shared library for the session.
+    lib_func = _session_function(BltSessionStop, BltSessionHandleStop, session)
     # Check if the shared library function could be imported.
-    if BltSessionStop is not None:
+    if lib_func is not None:
         # Call the function in the shared library
-        BltSessionStop()
+        result = lib_func()
+    # Give the result back to the caller.
+    return result
 
 
-def session_clear_memory(address, len):
+def session_clear_memory(address, len, session=None):
     """
     Requests the target to erase the specified range of memory on the target. Note that 
     the target automatically aligns this to the erasable memory block sizes. This 
@@ -1114,6 +1591,8 @@ def session_clear_memory(address, len):
 
     :param address: The starting memory address for the erase operation.
     :param len: The total number of bytes to erase from memory.
+    :param session: Session created with session_create(). None for the session of
+           session_init().
     :returns: BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
     :rtype: int
 
@@ -1127,15 +1606,18 @@ def session_clear_memory(address, len):
     """
     # Initialize the result.
     result = BLT_RESULT_ERROR_GENERIC
+    # Select the function in the shared library for the session.
+    lib_func = _session_function(BltSessionClearMemory,
+                                 BltSessionHandleClearMemory, session)
     # Check if the shared library function could be imported.
-    if BltSessionClearMemory is not None:
+    if lib_func is not None:
         # Call the function in the shared library
-        result = BltSessionClearMemory(ctypes.c_uint32(address), ctypes.c_uint32(len))
+        result = lib_func(ctypes.c_uint32(address), ctypes.c_uint32(len))
     # Give the result back to the caller.
     return result
 
 
-def session_write_data(address, len, data):
+def session_write_data(address, len, data, session=None):
     """
     Requests the target to program the specified data to memory. Note that it is the 
     responsibility of the application to make sure the memory range was erased 
@@ -1144,6 +1626,8 @@ def session_write_data(address, len, data):
     :param address: The starting memory address for the write operation.
     :param len: The number of bytes in the data buffer that should be written.
     :param data: List with data bytes that should be written.
+    :param session: Session created with session_create(). None for the session of
+           session_init().
     :returns: BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
     :rtype: int
 
@@ -1158,21 +1642,22 @@ def session_write_data(address, len, data):
     """
     # Initialize the result.
     result = BLT_RESULT_ERROR_GENERIC
+    # Select the function in the shared library for the session.
+    lib_func = _session_function(BltSessionWriteData, BltSessionHandleWriteData, session)
     # Check if the shared library function could be imported.
-    if BltSessionWriteData is not None:
+    if lib_func is not None:
         # Convert the list to a c-byte array
         new_data_type = ctypes.c_uint8 * len
         new_data = new_data_type()
         for i in range(0, len):
             new_data[i] = ctypes.c_uint8(data[i])
         # Call the function in the shared library
-        result = BltSessionWriteData(ctypes.c_uint32(address), ctypes.c_uint32(len),
-                                     new_data)
+        result = lib_func(ctypes.c_uint32(address), ctypes.c_uint32(len), new_data)
     # Give the result back to the caller.
     return result
 
 
-def session_read_data(address, len, data):
+def session_read_data(address, len, data, session=None):
     """
     Requests the target to upload the specified range from memory and store its contents 
     in the specified data buffer.
@@ -1181,6 +1666,8 @@ def session_read_data(address, len, data):
     :param len: The number of bytes to upload from the target and store in the data 
            buffer.
     :param data: List where the uploaded data bytes should be stored.
+    :param session: Session created with session_create(). None for the session of
+           session_init().
     :returns: BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
     :rtype: int
 
@@ -1199,14 +1686,15 @@ def session_read_data(address, len, data):
     """
     # Initialize the result.
     result = BLT_RESULT_ERROR_GENERIC
+    # Select the function in the shared library for the session.
+    lib_func = _session_function(BltSessionReadData, BltSessionHandleReadData, session)
     # Check if the shared library function could be imported.
-    if BltSessionReadData is not None:
+    if lib_func is not None:
         # Create c-byte array for storing the uploaded byte values.
         upload_data_type = ctypes.c_uint8 * len
         upload_data = upload_data_type()
         # Call the function in the shared library.
-        result = BltSessionReadData(ctypes.c_uint32(address), ctypes.c_uint32(len),
-                                     upload_data)
+        result = lib_func(ctypes.c_uint32(address), ctypes.c_uint32(len), upload_data)
         # Copy the uploaded data byte values to the data list provided by the caller.
         for i in range(len):
             data.append(upload_data[i])
@@ -1214,4 +1702,416 @@ def session_read_data(address, len, data):
     return result
 
 
+def _session_async_dispatch(event_ptr, context):
+    """
+    Callback function for the events of all asynchronous session operations. It is called
+    by the shared library from within BltSessionProcessEvents. It converts the event and
+    passes it on to the callback of the caller.
+
+    :param event_ptr: Pointer to the tBltSessionEvent structure.
+    :param context: Identifier of the request.
+    """
+    event_struct = ctypes.cast(event_ptr, ctypes.POINTER(_struct_t_blt_session_event))
+    event = BltSessionEvent()
+    event.operation = event_struct.contents.operation
+    event.event = event_struct.contents.event
+    event.result = event_struct.contents.result
+    event.progress = event_struct.contents.progress
+    event.total = event_struct.contents.total
+    request = _session_async_requests.get(context)
+    if request is not None:
+        callback, c_data, data = request
+        # Release the request once the operation completed. For a read operation, the
+        # uploaded data is copied to the list of the caller.
+        if event.event == BLT_SESSION_EVENT_COMPLETED:
+            del _session_async_requests[context]
+            if data is not None and event.result == BLT_RESULT_OK:
+                data.extend(c_data)
+        # Pass the event on to the callback of the caller.
+        if callback is not None:
+            callback(event)
+
+
+# C-types function object of the callback function. It must stay referenced for as long
+# as the shared library can call it.
+_session_async_dispatch_func = BltSessionCallback(_session_async_dispatch)
+
+
+def _session_submit_async(submit, callback, c_data, data):
+    """
+    Stores the request of an asynchronous session operation and submits the operation.
+
+    :param submit: Function that submits the operation to the shared library. It is
+           called with the callback function and the context.
+    :param callback: Callback function of the caller.
+    :param c_data: C-byte array with the data of the operation or None.
+    :param data: List to store the uploaded data in or None.
+    :returns: BLT_RESULT_OK if the operation was submitted, BLT_RESULT_ERROR_xxx
+              otherwise.
+    :rtype: int
+    """
+    global _session_async_next_id
+    # Store the request.
+    request_id = _session_async_next_id
+    _session_async_next_id += 1
+    _session_async_requests[request_id] = (callback, c_data, data)
+    # Submit the operation.
+    result = submit(_session_async_dispatch_func, ctypes.c_void_p(request_id))
+    if result != BLT_RESULT_OK:
+        del _session_async_requests[request_id]
+    # Give the result back to the caller.
+    return result
+
+
+def session_start_async(callback=None, session=None):
+    """
+    Submits an operation to start the firmware update session, without waiting for it
+    to complete. The operation is executed in the background. Its events are passed on
+    to the callback function from within session_process_events().
+
+    :param callback: Function that is called with an instance of class BltSessionEvent
+           for each event of the operation. Can be None.
+    :param session: Session created with session_create(). None for the session of
+           session_init().
+    :returns: BLT_RESULT_OK if the operation was submitted, BLT_RESULT_ERROR_xxx
+              otherwise.
+    :rtype: int
+
+    :Example:
+    ::
+
+        import openblt
+
+        def on_started(event):
+            if event.result != openblt.BLT_RESULT_OK:
+                print('[ERROR] Could not connect to the target.')
+
+        openblt.session_start_async(on_started)
+        while openblt.session_process_events(100) > 0:
+            pass
+    """
+    # Initialize the result.
+    result = BLT_RESULT_ERROR_GENERIC
+    # Select the function in the shared library for the session.
+    lib_func = _session_function(BltSessionStartAsync,
+                                 BltSessionHandleStartAsync, session)
+    # Check if the shared library function could be imported.
+    if lib_func is not None:
+        # Submit the operation.
+        result = _session_submit_async(lib_func, callback, None, None)
+    # Give the result back to the caller.
+    return result
+
+
+def session_stop_async(callback=None, session=None):
+    """
+    Submits an operation to stop the firmware update session, without waiting for it to
+    complete.
+
+    :param callback: Function that is called with an instance of class BltSessionEvent
+           for each event of the operation. Can be None.
+    :param session: Session created with session_create(). None for the session of
+           session_init().
+    :returns: BLT_RESULT_OK if the operation was submitted, BLT_RESULT_ERROR_xxx
+              otherwise.
+    :rtype: int
+
+    :Example:
+    ::
+
+        import openblt
+
+        openblt.session_stop_async()
+    """
+    # Initialize the result.
+    result = BLT_RESULT_ERROR_GENERIC
+    # Select the function in the shared library for the session.
+    lib_func = _session_function(BltSessionStopAsync, BltSessionHandleStopAsync, session)
+    # Check if the shared library function could be imported.
+    if lib_func is not None:
+        # Submit the operation.
+        result = _session_submit_async(lib_func, callback, None, None)
+    # Give the result back to the caller.
+    return result
+
+
+def session_clear_memory_async(address, len, callback=None, session=None):
+    """
+    Submits an operation to erase the specified range of memory on the target, without
+    waiting for it to complete.
+
+    :param address: The starting memory address for the erase operation.
+    :param len: The total number of bytes to erase from memory.
+    :param callback: Function that is called with an instance of class BltSessionEvent
+           for each event of the operation. Can be None.
+    :param session: Session created with session_create(). None for the session of
+           session_init().
+    :returns: BLT_RESULT_OK if the operation was submitted, BLT_RESULT_ERROR_xxx
+              otherwise.
+    :rtype: int
+
+    :Example:
+    ::
+
+        import openblt
+
+        openblt.session_clear_memory_async(0x8002000, 1024)
+    """
+    # Initialize the result.
+    result = BLT_RESULT_ERROR_GENERIC
+    # Select the function in the shared library for the session.
+    lib_func = _session_function(BltSessionClearMemoryAsync,
+                                 BltSessionHandleClearMemoryAsync, session)
+    # Check if the shared library function could be imported.
+    if lib_func is not None:
+        # Submit the operation.
+        result = _session_submit_async(
+            lambda func, context: lib_func(ctypes.c_uint32(address),
+                                           ctypes.c_uint32(len),
+                                           func, context),
+            callback, None, None)
+    # Give the result back to the caller.
+    return result
+
+
+def session_write_data_async(address, len, data, callback=None, session=None):
+    """
+    Submits an operation to program the specified data to memory, without waiting for
+    it to complete. Progress events are passed on to the callback while the data is
+    programmed.
+
+    :param address: The starting memory address for the write operation.
+    :param len: The number of bytes in the data buffer that should be written.
+    :param data: List with data bytes to write.
+    :param callback: Function that is called with an instance of class BltSessionEvent
+           for each event of the operation. Can be None.
+    :param session: Session created with session_create(). None for the session of
+           session_init().
+    :returns: BLT_RESULT_OK if the operation was submitted, BLT_RESULT_ERROR_xxx
+              otherwise.
+    :rtype: int
+
+    :Example:
+    ::
+
+        import openblt
+
+        def on_write(event):
+            if event.event == openblt.BLT_SESSION_EVENT_PROGRESS:
+                print('Programmed', event.progress, 'of', event.total, 'bytes')
+
+        prog_data = [ 0x55, 0xAA ] * 2048
+        openblt.session_write_data_async(0x08002000, len(prog_data), prog_data, on_write)
+    """
+    # Initialize the result.
+    result = BLT_RESULT_ERROR_GENERIC
+    # Select the function in the shared library for the session.
+    lib_func = _session_function(BltSessionWriteDataAsync,
+                                 BltSessionHandleWriteDataAsync, session)
+    # Check if the shared library function could be imported.
+    if lib_func is not None:
+        # Convert the list with data to a c-byte array. It stays referenced by the
+        # request until the operation completed.
+        new_data_type = ctypes.c_uint8 * len
+        new_data = new_data_type(*data[:len])
+        # Submit the operation.
+        result = _session_submit_async(
+            lambda func, context: lib_func(ctypes.c_uint32(address),
+                                           ctypes.c_uint32(len),
+                                           new_data, func, context),
+            callback, new_data, None)
+    # Give the result back to the caller.
+    return result
+
+
+def session_read_data_async(address, len, data, callback=None, session=None):
+    """
+    Submits an operation to upload the specified range from memory, without waiting for
+    it to complete. Progress events are passed on to the callback while the data is
+    uploaded. Once the operation completed successfully, the uploaded data bytes are
+    appended to the data list.
+
+    :param address: The starting memory address for the read operation.
+    :param len: The number of bytes to upload from the target.
+    :param data: List where the uploaded data bytes should be stored.
+    :param callback: Function that is called with an instance of class BltSessionEvent
+           for each event of the operation. Can be None.
+    :param session: Session created with session_create(). None for the session of
+           session_init().
+    :returns: BLT_RESULT_OK if the operation was submitted, BLT_RESULT_ERROR_xxx
+              otherwise.
+    :rtype: int
+
+    :Example:
+    ::
+
+        import openblt
+
+        read_data = []
+        openblt.session_read_data_async(0x08002800, 16, read_data)
+        while openblt.session_process_events(100) > 0:
+            pass
+        print('Read', len(read_data), 'bytes')
+    """
+    # Initialize the result.
+    result = BLT_RESULT_ERROR_GENERIC
+    # Select the function in the shared library for the session.
+    lib_func = _session_function(BltSessionReadDataAsync,
+                                 BltSessionHandleReadDataAsync, session)
+    # Check if the shared library function could be imported.
+    if lib_func is not None:
+        # Create c-byte array for storing the uploaded byte values. It stays referenced
+        # by the request until the operation completed.
+        upload_data_type = ctypes.c_uint8 * len
+        upload_data = upload_data_type()
+        # Submit the operation.
+        result = _session_submit_async(
+            lambda func, context: lib_func(ctypes.c_uint32(address),
+                                           ctypes.c_uint32(len),
+                                           upload_data, func, context),
+            callback, upload_data, data)
+    # Give the result back to the caller.
+    return result
+
+
+def session_process_events(timeout=0):
+    """
+    Passes the pending events of asynchronous session operations on to their callbacks.
+    If no events are pending yet, it first waits for them, up to the specified timeout.
+
+    :param timeout: Maximum time in milliseconds to wait for events. 0 to only process
+           the events that are already pending.
+    :returns: Number of asynchronous operations that did not yet complete.
+    :rtype: int
+
+    :Example:
+    ::
+
+        import openblt
+
+        while openblt.session_process_events(100) > 0:
+            pass
+    """
+    # Initialize the result.
+    result = 0
+    # Check if the shared library function could be imported.
+    if BltSessionProcessEvents is not None:
+        # Call the function in the shared library.
+        result = BltSessionProcessEvents(ctypes.c_uint32(timeout))
+    # Give the result back to the caller.
+    return result
+
+
+def session_cancel_async(session=None):
+    """
+    Cancels all pending asynchronous session operations. Cancelled operations complete
+    with an error, which is passed on to their callbacks with the next call of
+    session_process_events().
+
+
+    :param session: Session created with session_create(). None for the session of
+           session_init().
+
+    :Example:
+    ::
+
+        import openblt
+
+        openblt.session_cancel_async()
+    """
+    # Select the function in the shared library for the session.
+    lib_func = _session_function(BltSessionCancelAsync,
+                                 BltSessionHandleCancelAsync, session)
+    # Check if the shared library function could be imported.
+    if lib_func is not None:
+        # Call the function in the shared library.
+        lib_func()
+
+
+def session_get_event_handle():
+    """
+    Obtains the operating system handle that is signaled while events of asynchronous
+    session operations are pending. On Linux this is a file descriptor that becomes
+    readable, which can be used with the select module. On Windows this is an event
+    object handle.
+
+    :returns: The operating system handle. -1 if the session is not initialized.
+    :rtype: int
+
+    :Example:
+    ::
+
+        import select
+        import openblt
+
+        fd = openblt.session_get_event_handle()
+        select.select([fd], [], [], 1.0)
+        openblt.session_process_events()
+    """
+    # Initialize the result.
+    result = -1
+    # Check if the shared library function could be imported.
+    if BltSessionGetEventHandle is not None:
+        # Call the function in the shared library.
+        result = BltSessionGetEventHandle()
+    # Give the result back to the caller.
+    return result
+
+
+def session_get_latency(latency, session=None):
+    """
+    Obtains the command/response latency statistics of the firmware update session. They
+    cover all successful exchanges with the target since the session was started and
+    remain available after the session was stopped.
+
+    :param latency: Instance of class BltSessionLatency where the statistics should be
+           stored.
+    :param session: Session created with session_create(). None for the session of
+           session_init().
+    :returns: BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
+    :rtype: int
+
+    :Example:
+    ::
+
+        import openblt
+
+        latency = openblt.BltSessionLatency()
+        if openblt.session_get_latency(latency) == openblt.BLT_RESULT_OK:
+            print('Average host time =', latency.hostAvg, 'us')
+            print('Average wire time =', latency.wireAvg, 'us')
+    """
+    class struct_t_blt_session_latency(ctypes.Structure):
+        """
+        C-types structure for mapping to BltSessionLatency
+        """
+        _fields_ = [('count',    ctypes.c_uint32),
+                    ('totalAvg', ctypes.c_uint32),
+                    ('hostAvg',  ctypes.c_uint32),
+                    ('wireAvg',  ctypes.c_uint32),
+                    ('totalMax', ctypes.c_uint32),
+                    ('totalP99', ctypes.c_uint32)]
+
+    # Initialize the result.
+    result = BLT_RESULT_ERROR_GENERIC
+    # Select the function in the shared library for the session.
+    lib_func = _session_function(BltSessionGetLatency,
+                                 BltSessionHandleGetLatency, session)
+    # Check if the shared library function could be imported.
+    if lib_func is not None:
+        latency_struct = struct_t_blt_session_latency()
+        # Call the function in the shared library.
+        result = lib_func(ctypes.byref(latency_struct))
+        # Copy the statistics to the object provided by the caller.
+        if result == BLT_RESULT_OK:
+            latency.count = latency_struct.count
+            latency.totalAvg = latency_struct.totalAvg
+            latency.hostAvg = latency_struct.hostAvg
+            latency.wireAvg = latency_struct.wireAvg
+            latency.totalMax = latency_struct.totalMax
+            latency.totalP99 = latency_struct.totalP99
+    # Give the result back to the caller.
+    return result
+
+
 # ********************************* end of lib.py ***************************************
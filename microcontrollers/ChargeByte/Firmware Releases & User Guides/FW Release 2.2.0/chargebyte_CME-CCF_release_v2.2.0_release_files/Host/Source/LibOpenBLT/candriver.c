@@ -35,8 +35,11 @@
 #include <stdint.h>                         /* for standard integer types              */
 #include <stddef.h>                         /* for NULL declaration                    */
 #include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
 #include <string.h>                         /* for string library                      */
 #include "candriver.h"                      /* Generic CAN driver module               */
+#include "util.h"                           /* Utility module                          */
+#include "canloopback.h"                    /* In-process loopback CAN interface       */
 #if defined(PLATFORM_LINUX)
 #include "socketcan.h"                      /* SocketCAN interface                     */
 #else
@@ -48,6 +51,51 @@
 #endif
 
 
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Number of buckets in the hash table for dispatching received CAN messages to
+ *         their subscribers. Must be a power of 2.
+ */
+#define CAN_RX_HASH_BUCKETS            (32u)
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Entry in the hash table with subscribers for received CAN messages. */
+typedef struct t_can_rx_subscriber
+{
+  uint32_t id;                                   /**< Subscribed CAN identifier.       */
+  tCanRxEvents events;                           /**< Event callback functions.        */
+  void * context;                                /**< Context of the subscriber.       */
+  struct t_can_rx_subscriber * next;             /**< Next entry in the same bucket.   */
+} tCanRxSubscriber;
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+static void CanEventMessageTransmitted(tCanMsg const * msg);
+static void CanEventMessageReceived(tCanMsg const * msg);
+static uint32_t CanRxHash(uint32_t id);
+static void CanUpdateRxFilters(void);
+static bool CanSettingsMatch(tCanSettings const * settings);
+
+
+/****************************************************************************************
+* Local constant declarations
+****************************************************************************************/
+/** \brief CAN interface event functions for dispatching transmitted and received
+ *         messages.
+ */
+static const tCanEvents canDispatchEvents =
+{
+  CanEventMessageTransmitted,
+  CanEventMessageReceived
+};
+
+
 /****************************************************************************************
 * Local data declarations
 ****************************************************************************************/
@@ -57,98 +105,267 @@ static tCanInterface const * canIfPtr;
 /** \brief Flag to store the connection status. */
 static bool canConnected;
 
+/** \brief Number of users that initialized the CAN module and did not yet terminate
+ *         it. The CAN interface is only initialized for the first one and terminated
+ *         for the last one. Users can live in different threads, so it is only accessed
+ *         while holding the process wide critical section.
+ */
+static uint32_t canInitCount = 0;
+
+/** \brief Number of users that connected the CAN module and did not yet disconnect
+ *         it. The CAN interface stays connected for as long as there are users.
+ */
+static uint32_t canConnectCount;
+
+/** \brief Copy of the settings that the CAN interface was initialized with. Later users
+ *         can only share the CAN interface if they specify the same settings.
+ */
+static tCanSettings canSettings;
+
+/** \brief Critical section object that protects the connection state. */
+static tUtilCriticalSection canConnectCritSect;
+
+/** \brief Hash table with the subscribers for received CAN messages, indexed by the
+ *         hash of their CAN identifier.
+ */
+static tCanRxSubscriber * canRxSubscribers[CAN_RX_HASH_BUCKETS];
+
+/** \brief Total number of entries in the \ref canRxSubscribers hash table. */
+static uint32_t canRxSubscriberCount;
+
+/** \brief Critical section object that protects the subscribers hash table, which is
+ *         shared with the CAN interface's reception thread.
+ */
+static tUtilCriticalSection canRxCritSect;
+
+/** \brief Critical section object that serializes the transmissions of the users that
+ *         share the CAN interface. Not all CAN interfaces support concurrent calls of
+ *         their transmit function.
+ */
+static tUtilCriticalSection canTxCritSect;
+
 
 /************************************************************************************//**
-** \brief     Initializes the CAN module. Typically called once at program startup.
+** \brief     Initializes the CAN module. The CAN module can be initialized by multiple
+**            users, which then share the same CAN interface. The CAN interface is only
+**            initialized for the first user. Later users must specify the same
+**            settings. Note that there is only one CAN interface per process. While it
+**            is in use, initializing the CAN module for a different device, channel or
+**            baudrate fails. For example, can0 and can1 cannot be used at the same
+**            time.
 ** \param     settings Pointer to the CAN module settings.
+** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-void CanInit(tCanSettings const * settings)
+bool CanInit(tCanSettings const * settings)
 {
-  /* Initialize locals. */
-  canIfPtr = NULL;
-  canConnected = false;
-  
+  bool result = false;
+  char * deviceName;
+
   /* Check parameters. */
   assert(settings != NULL);
-  
-  /* Only continue with valid parameters. */
-  if (settings != NULL)  /*lint !e774 */
+
+  /* Multiple users can initialize and terminate the CAN module from different threads.
+   * The module's own critical sections are only created for the first user, so the
+   * process wide critical section protects the user count.
+   */
+  UtilCriticalSectionLock(UtilCriticalSectionGetGlobal());
+  /* Just add a user to the CAN interface, if it is already initialized. */
+  if (canInitCount > 0)
+  {
+    if (CanSettingsMatch(settings))
+    {
+      canInitCount++;
+      result = true;
+    }
+  }
+  /* Otherwise initialize the CAN interface for its first user. */
+  else
   {
-    /* Check device name. */
-    assert(settings->devicename != NULL);
+    /* Initialize locals. */
+    canIfPtr = NULL;
+    canConnected = false;
+    canConnectCount = 0;
+    canRxSubscriberCount = 0;
+    for (uint32_t idx = 0; idx < CAN_RX_HASH_BUCKETS; idx++)
+    {
+      canRxSubscribers[idx] = NULL;
+    }
+    /* Create the critical section object for protecting the subscribers hash table. */
+    canRxCritSect = UtilCriticalSectionCreate();
+    assert(canRxCritSect != NULL);
+    /* Create the critical section object for protecting the connection state. */
+    canConnectCritSect = UtilCriticalSectionCreate();
+    assert(canConnectCritSect != NULL);
+    /* Create the critical section object for serializing the transmissions. */
+    canTxCritSect = UtilCriticalSectionCreate();
+    assert(canTxCritSect != NULL);
 
-    /* Only continue with a valid device name. */
-    if (settings->devicename != NULL) /*lint !e774 */
+    /* Only continue with valid parameters. */
+    if (settings != NULL)  /*lint !e774 */
     {
-      /* Determine the pointer to the correct CAN interface, based on the specified
-       * device name.
-       */
+      /* Check device name. */
+      assert(settings->devicename != NULL);
+
+      /* Only continue with a valid device name. */
+      if (settings->devicename != NULL) /*lint !e774 */
+      {
+        /* Determine the pointer to the correct CAN interface, based on the specified
+         * device name. The loopback CAN interface is available on all platforms.
+         */
+        if (strncmp(settings->devicename, "loopback", 8) == 0)
+        {
+          canIfPtr = CanLoopbackGetInterface();
+        }
+        else
+        {
 #if defined(PLATFORM_LINUX)
-      /* On Linux, the device name is the name of the SocketCAN link, so always link
-       * the SocketCAN interface to the CAN driver.
-       */
-      canIfPtr = SocketCanGetInterface();
+          /* On Linux, the device name is the name of the SocketCAN link, so always link
+           * the SocketCAN interface to the CAN driver.
+           */
+          canIfPtr = SocketCanGetInterface();
 #else
-      if (strcmp(settings->devicename, "peak_pcanusb") == 0)
-      {
-        canIfPtr = PCanUsbGetInterface();
-      }
-      else if (strcmp(settings->devicename, "kvaser_leaflight") == 0)
-      {
-        canIfPtr = LeafLightGetInterface();
-      }
-      else if (strcmp(settings->devicename, "lawicel_canusb") == 0)
-      {
-        canIfPtr = CanUsbGetInterface();
-      }
-      else if (strcmp(settings->devicename, "vector_xldriver") == 0)
-      {
-        canIfPtr = VectorXlGetInterface();
-      }
-      else if (strcmp(settings->devicename, "ixxat_vcidriver") == 0)
-      {
-        canIfPtr = IxxatVciGetInterface();
-      }
+          if (strcmp(settings->devicename, "peak_pcanusb") == 0)
+          {
+            canIfPtr = PCanUsbGetInterface();
+          }
+          else if (strcmp(settings->devicename, "kvaser_leaflight") == 0)
+          {
+            canIfPtr = LeafLightGetInterface();
+          }
+          else if (strcmp(settings->devicename, "lawicel_canusb") == 0)
+          {
+            canIfPtr = CanUsbGetInterface();
+          }
+          else if (strcmp(settings->devicename, "vector_xldriver") == 0)
+          {
+            canIfPtr = VectorXlGetInterface();
+          }
+          else if (strcmp(settings->devicename, "ixxat_vcidriver") == 0)
+          {
+            canIfPtr = IxxatVciGetInterface();
+          }
 #endif
-      /* Check validity of the interface. */
-      assert(canIfPtr != NULL);
+        }
+        /* Check validity of the interface. */
+        assert(canIfPtr != NULL);
 
-      /* Only continue with a valid interface. */
-      if (canIfPtr != NULL) /*lint !e774 */
-      {
-        /* Initialize the CAN interface. */
-        canIfPtr->Init(settings);
+        /* Only continue with a valid interface. */
+        if (canIfPtr != NULL) /*lint !e774 */
+        {
+          /* Initialize the CAN interface. */
+          canIfPtr->Init(settings);
+          /* Register the events for dispatching received messages to subscribers. */
+          canIfPtr->RegisterEvents(&canDispatchEvents);
+          /* Store the settings, such that later users can be checked against them. The
+           * device name is deep copied, because it is not guaranteed to stay valid.
+           */
+          canSettings = *settings;
+          deviceName = malloc(strlen(settings->devicename) + 1);
+          assert(deviceName != NULL);
+          if (deviceName != NULL) /*lint !e774 */
+          {
+            strcpy(deviceName, settings->devicename);
+          }
+          canSettings.devicename = deviceName;
+          /* The CAN interface now has its first user. */
+          canInitCount = 1;
+          result = true;
+        }
       }
     }
+    /* Clean up if the CAN interface could not be initialized. */
+    if (!result)
+    {
+      UtilCriticalSectionDestroy(canRxCritSect);
+      canRxCritSect = NULL;
+      UtilCriticalSectionDestroy(canConnectCritSect);
+      canConnectCritSect = NULL;
+      UtilCriticalSectionDestroy(canTxCritSect);
+      canTxCritSect = NULL;
+    }
   }
+  UtilCriticalSectionUnlock(UtilCriticalSectionGetGlobal());
+  /* Give the result back to the caller. */
+  return result;
 } /*** end of CanInit ***/
 
 
 /************************************************************************************//**
-** \brief     Terminates the CAN module. Typically called once at program cleanup.
+** \brief     Terminates the CAN module for one of its users. The CAN interface is only
+**            terminated for the last user.
 **
 ****************************************************************************************/
 void CanTerminate(void)
 {
-  /* Make sure a valid CAN interface is linked. */
-  assert(canIfPtr != NULL);
-  
-  /* Only continue with a valid CAN interface. */
-  if (canIfPtr != NULL) /*lint !e774 */
+  tCanRxSubscriber * entry;
+  tCanRxSubscriber * nextEntry;
+
+  /* Protect the user count against users in other threads. */
+  UtilCriticalSectionLock(UtilCriticalSectionGetGlobal());
+  /* Make sure the CAN module was initialized. */
+  assert(canInitCount > 0);
+
+  /* Only terminate the CAN interface for the last user. */
+  if (canInitCount > 1)
   {
-    /* Make sure to disconnect first. */
-    CanDisconnect();
-    /* Terminate the CAN interface. */
-    canIfPtr->Terminate();
-    /* Unlink the CAN interface. */
-    canIfPtr = NULL;
+    canInitCount--;
   }
+  else
+  {
+    canInitCount = 0;
+    /* Make sure a valid CAN interface is linked. */
+    assert(canIfPtr != NULL);
+
+    /* Only continue with a valid CAN interface. */
+    if (canIfPtr != NULL) /*lint !e774 */
+    {
+      /* Make sure to disconnect first, also for users that are still connected. */
+      if (canConnectCount > 0)
+      {
+        canConnectCount = 1;
+        CanDisconnect();
+      }
+      /* Terminate the CAN interface. */
+      canIfPtr->Terminate();
+      /* Unlink the CAN interface. */
+      canIfPtr = NULL;
+    }
+    /* Release the memory of all subscribers that are still registered. */
+    for (uint32_t idx = 0; idx < CAN_RX_HASH_BUCKETS; idx++)
+    {
+      entry = canRxSubscribers[idx];
+      while (entry != NULL)
+      {
+        nextEntry = entry->next;
+        free(entry);
+        entry = nextEntry;
+      }
+      canRxSubscribers[idx] = NULL;
+    }
+    canRxSubscriberCount = 0;
+    /* Release the memory of the stored device name. */
+    if (canSettings.devicename != NULL)
+    {
+      free((char *)canSettings.devicename);
+      canSettings.devicename = NULL;
+    }
+    /* Destroy the critical section objects. */
+    UtilCriticalSectionDestroy(canRxCritSect);
+    canRxCritSect = NULL;
+    UtilCriticalSectionDestroy(canConnectCritSect);
+    canConnectCritSect = NULL;
+    UtilCriticalSectionDestroy(canTxCritSect);
+    canTxCritSect = NULL;
+  }
+  UtilCriticalSectionUnlock(UtilCriticalSectionGetGlobal());
 } /*** end of CanTerminate ***/
 
 
 /************************************************************************************//**
-** \brief     Connects the CAN module.
+** \brief     Connects the CAN module for one of its users. The CAN interface is only
+**            connected for the first user. Each successful call should be followed up
+**            by a call to CanDisconnect.
 ** \return    True if connected, false otherwise.
 **
 ****************************************************************************************/
@@ -162,12 +379,19 @@ bool CanConnect(void)
   /* Only continue with a valid CAN interface. */
   if (canIfPtr != NULL) /*lint !e774 */
   {
-    /* Make sure that the CAN module is in the disconnected state. */
-    CanDisconnect();
-    /* Connect the CAN interface. */
-    result = canIfPtr->Connect();
-    /* Update the connection state. */
-    canConnected = result;
+    UtilCriticalSectionLock(canConnectCritSect);
+    /* Connect the CAN interface, if this is its first user. */
+    if (canConnectCount == 0)
+    {
+      canConnected = canIfPtr->Connect();
+    }
+    /* Add the user, if connected. */
+    if (canConnected)
+    {
+      canConnectCount++;
+      result = true;
+    }
+    UtilCriticalSectionUnlock(canConnectCritSect);
   }
   /* Give the result back to the caller. */
   return result;
@@ -175,7 +399,8 @@ bool CanConnect(void)
 
 
 /************************************************************************************//**
-** \brief     Disconnects the CAN module.
+** \brief     Disconnects the CAN module for one of its users. The CAN interface is only
+**            disconnected for the last user.
 **
 ****************************************************************************************/
 void CanDisconnect(void)
@@ -186,14 +411,20 @@ void CanDisconnect(void)
   /* Only continue with a valid CAN interface. */
   if (canIfPtr != NULL) /*lint !e774 */
   {
+    UtilCriticalSectionLock(canConnectCritSect);
     /* Only disconnect if actually connected. */
-    if (canConnected)
+    if (canConnectCount > 0)
     {
-      /* Disconnect CAN interface. */
-      canIfPtr->Disconnect();
-      /* Update the connection state. */
-      canConnected = false;
+      canConnectCount--;
+      /* Disconnect the CAN interface, if this was its last user. */
+      if (canConnectCount == 0)
+      {
+        canIfPtr->Disconnect();
+        /* Update the connection state. */
+        canConnected = false;
+      }
     }
+    UtilCriticalSectionUnlock(canConnectCritSect);
   }
 } /*** end of CanDisconnect ***/
 
@@ -211,7 +442,8 @@ bool CanIsConnected(void)
 
 
 /************************************************************************************//**
-** \brief     Submits a message for transmission on the CAN bus.
+** \brief     Submits a message for transmission on the CAN bus. Transmissions of
+**            the users that share the CAN interface are serialized.
 ** \param     msg Pointer to CAN message structure.
 ** \return    True if successful, false otherwise.
 **
@@ -229,7 +461,9 @@ bool CanTransmit(tCanMsg const * msg)
     /* Only transmit the message if connected. */
     if (canConnected)
     {
+      UtilCriticalSectionLock(canTxCritSect);
       result = canIfPtr->Transmit(msg);
+      UtilCriticalSectionUnlock(canTxCritSect);
     }
   }
   /* Give the result back to the caller. */
@@ -283,4 +517,296 @@ void CanRegisterEvents(tCanEvents const * events)
 } /*** end of CanRegisterEvents ***/
 
 
+/************************************************************************************//**
+** \brief     Subscribes to the reception of CAN messages with a specific identifier.
+**            Received messages are dispatched by means of a hash table lookup, so only
+**            the subscribers of the message's identifier get their MsgRxed event
+**            function called. All subscribed identifiers together form the reception
+**            acceptance filter list, for CAN interfaces that support such a list. This
+**            way multiple users can share one connection to the CAN bus, without each
+**            of them having to filter all the received messages themselves.
+** \param     id CAN identifier to subscribe to. Note that \ref CAN_MSG_EXT_ID_MASK
+**            should be set for 29-bit CAN identifiers.
+** \param     events Pointer to structure with event callback function pointers.
+** \param     context Pointer that is passed on to the event callback functions.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+bool CanRegisterRxId(uint32_t id, tCanRxEvents const * events, void * context)
+{
+  bool result = false;
+  tCanRxSubscriber * entry;
+  uint32_t bucketIdx;
+
+  /* Check parameters. */
+  assert(events != NULL);
+
+  /* Only continue with valid parameters. */
+  if (events != NULL) /*lint !e774 */
+  {
+    /* Allocate memory for the new subscriber. */
+    entry = malloc(sizeof(tCanRxSubscriber));
+    assert(entry != NULL);
+    /* Only continue if the allocation was successful. */
+    if (entry != NULL) /*lint !e774 */
+    {
+      /* Initialize the new subscriber. */
+      entry->id = id;
+      entry->events = *events;
+      entry->context = context;
+      /* Add it to the front of its bucket in the hash table. */
+      bucketIdx = CanRxHash(id);
+      UtilCriticalSectionLock(canRxCritSect);
+      entry->next = canRxSubscribers[bucketIdx];
+      canRxSubscribers[bucketIdx] = entry;
+      canRxSubscriberCount++;
+      UtilCriticalSectionUnlock(canRxCritSect);
+      /* Update the reception acceptance filter list of the CAN interface. */
+      CanUpdateRxFilters();
+      /* Update the result. */
+      result = true;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of CanRegisterRxId ***/
+
+
+/************************************************************************************//**
+** \brief     Removes a subscription that was previously registered with
+**            CanRegisterRxId.
+** \param     id Subscribed CAN identifier.
+** \param     events Pointer to structure with event callback function pointers that
+**            was used during the registration.
+** \param     context Pointer that was used during the registration.
+**
+****************************************************************************************/
+void CanUnregisterRxId(uint32_t id, tCanRxEvents const * events, void * context)
+{
+  tCanRxSubscriber * entry;
+  tCanRxSubscriber * prevEntry = NULL;
+  uint32_t bucketIdx;
+  bool removed = false;
+
+  /* Check parameters. */
+  assert(events != NULL);
+
+  /* Only continue with valid parameters. */
+  if (events != NULL) /*lint !e774 */
+  {
+    /* Search the subscriber in its bucket and unlink it. */
+    bucketIdx = CanRxHash(id);
+    UtilCriticalSectionLock(canRxCritSect);
+    entry = canRxSubscribers[bucketIdx];
+    while (entry != NULL)
+    {
+      if ( (entry->id == id) && (entry->context == context) &&
+           (entry->events.MsgRxed == events->MsgRxed) &&
+           (entry->events.MsgTxed == events->MsgTxed) )
+      {
+        if (prevEntry == NULL)
+        {
+          canRxSubscribers[bucketIdx] = entry->next;
+        }
+        else
+        {
+          prevEntry->next = entry->next;
+        }
+        canRxSubscriberCount--;
+        free(entry);
+        removed = true;
+        break;
+      }
+      prevEntry = entry;
+      entry = entry->next;
+    }
+    UtilCriticalSectionUnlock(canRxCritSect);
+    /* Update the reception acceptance filter list of the CAN interface. */
+    if (removed)
+    {
+      CanUpdateRxFilters();
+    }
+  }
+} /*** end of CanUnregisterRxId ***/
+
+
+/************************************************************************************//**
+** \brief     CAN interface event callback function that gets called each time a CAN
+**            message was transmitted. Subscriptions are only made for received CAN
+**            identifiers, so the message is dispatched to all subscribers. This
+**            enables them to correlate the transmission time of a request with the
+**            reception time of its response.
+** \param     msg Pointer to the transmitted CAN message.
+**
+****************************************************************************************/
+static void CanEventMessageTransmitted(tCanMsg const * msg)
+{
+  tCanRxSubscriber const * entry;
+
+  /* Check parameters. */
+  assert(msg != NULL);
+
+  /* Only continue with valid parameters. */
+  if (msg != NULL) /*lint !e774 */
+  {
+    UtilCriticalSectionLock(canRxCritSect);
+    /* Call the event function of all subscribers. */
+    for (uint32_t idx = 0; idx < CAN_RX_HASH_BUCKETS; idx++)
+    {
+      for (entry = canRxSubscribers[idx]; entry != NULL; entry = entry->next)
+      {
+        if (entry->events.MsgTxed != NULL)
+        {
+          entry->events.MsgTxed(entry->context, msg);
+        }
+      }
+    }
+    UtilCriticalSectionUnlock(canRxCritSect);
+  }
+} /*** end of CanEventMessageTransmitted ***/
+
+
+/************************************************************************************//**
+** \brief     CAN interface event callback function that gets called each time a CAN
+**            message was received. It dispatches the message to the subscribers of its
+**            CAN identifier.
+** \param     msg Pointer to the received CAN message.
+**
+****************************************************************************************/
+static void CanEventMessageReceived(tCanMsg const * msg)
+{
+  tCanRxSubscriber const * entry;
+
+  /* Check parameters. */
+  assert(msg != NULL);
+
+  /* Only continue with valid parameters. */
+  if (msg != NULL) /*lint !e774 */
+  {
+    UtilCriticalSectionLock(canRxCritSect);
+    /* Call the event function of all subscribers with a matching CAN identifier. */
+    entry = canRxSubscribers[CanRxHash(msg->id)];
+    while (entry != NULL)
+    {
+      if ( (entry->id == msg->id) && (entry->events.MsgRxed != NULL) )
+      {
+        entry->events.MsgRxed(entry->context, msg);
+      }
+      entry = entry->next;
+    }
+    UtilCriticalSectionUnlock(canRxCritSect);
+  }
+} /*** end of CanEventMessageReceived ***/
+
+
+/************************************************************************************//**
+** \brief     Calculates the index of the bucket in the subscribers hash table for a CAN
+**            identifier.
+** \param     id CAN identifier.
+** \return    Bucket index.
+**
+****************************************************************************************/
+static uint32_t CanRxHash(uint32_t id)
+{
+  /* Fold the bits of both 11-bit and 29-bit identifiers into the bucket index. */
+  return (id ^ (id >> 5) ^ (id >> 11) ^ (id >> 22)) & (CAN_RX_HASH_BUCKETS - 1u);
+} /*** end of CanRxHash ***/
+
+
+/************************************************************************************//**
+** \brief     Passes the list of all subscribed CAN identifiers on to the CAN interface,
+**            such that it can configure its reception acceptance filter with it.
+**
+****************************************************************************************/
+static void CanUpdateRxFilters(void)
+{
+  uint32_t * ids;
+  uint32_t count = 0;
+  tCanRxSubscriber const * entry;
+
+  /* Only continue if the linked CAN interface supports a filter list. */
+  if ( (canIfPtr != NULL) && (canIfPtr->SetRxFilters != NULL) )
+  {
+    UtilCriticalSectionLock(canRxCritSect);
+    /* Allocate memory for the list. Note that one extra entry is allocated to make sure
+     * malloc doesn't get called with zero.
+     */
+    ids = malloc(sizeof(uint32_t) * (canRxSubscriberCount + 1u));
+    assert(ids != NULL);
+    if (ids != NULL) /*lint !e774 */
+    {
+      /* Collect the CAN identifiers from the hash table. Each identifier should only
+       * be listed once, because SocketCAN for example delivers a message once for each
+       * filter that matches.
+       */
+      for (uint32_t idx = 0; idx < CAN_RX_HASH_BUCKETS; idx++)
+      {
+        for (entry = canRxSubscribers[idx]; entry != NULL; entry = entry->next)
+        {
+          bool listed = false;
+          for (uint32_t listIdx = 0; listIdx < count; listIdx++)
+          {
+            if (ids[listIdx] == entry->id)
+            {
+              listed = true;
+              break;
+            }
+          }
+          if (!listed)
+          {
+            ids[count] = entry->id;
+            count++;
+          }
+        }
+      }
+    }
+    UtilCriticalSectionUnlock(canRxCritSect);
+    /* Configure the list with the CAN interface. */
+    if (ids != NULL) /*lint !e774 */
+    {
+      canIfPtr->SetRxFilters(ids, count);
+      free(ids);
+    }
+  }
+} /*** end of CanUpdateRxFilters ***/
+
+
+/************************************************************************************//**
+** \brief     Checks if the settings of a new user of the CAN module match the ones that
+**            the CAN interface was initialized with. The reception acceptance filter
+**            does not have to match, if the CAN interface supports a filter list,
+**            because the list is then built from the subscriptions of all users.
+** \param     settings Pointer to the CAN module settings of the new user.
+** \return    True if the settings match, false otherwise.
+**
+****************************************************************************************/
+static bool CanSettingsMatch(tCanSettings const * settings)
+{
+  bool result = false;
+
+  /* Check the settings that determine the connection to the CAN bus. */
+  if ( (settings != NULL) && (settings->devicename != NULL) &&
+       (canSettings.devicename != NULL) )
+  {
+    if ( (strcmp(settings->devicename, canSettings.devicename) == 0) &&
+         (settings->channel == canSettings.channel) &&
+         (settings->baudrate == canSettings.baudrate) &&
+         (settings->txFrameGap == canSettings.txFrameGap) )
+    {
+      result = true;
+    }
+  }
+  /* Check the reception acceptance filter, if the CAN interface uses it. */
+  if ( (result) && (canIfPtr != NULL) && (canIfPtr->SetRxFilters == NULL) )
+  {
+    if ( (settings->code != canSettings.code) || (settings->mask != canSettings.mask) )
+    {
+      result = false;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of CanSettingsMatch ***/
+
+
 /*********************************** end of candriver.c ********************************/
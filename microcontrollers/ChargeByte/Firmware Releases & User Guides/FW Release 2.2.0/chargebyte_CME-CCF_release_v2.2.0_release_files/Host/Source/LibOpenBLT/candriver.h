@@ -31,6 +31,16 @@
 * \defgroup   CanDriver CAN driver
 * \brief      This module implements a generic CAN driver.
 * \ingroup    Session
+* \details
+* The CAN driver manages one connection to a CAN bus, which can be shared by multiple
+* users, for example multiple XCP transport layer objects that communicate with
+* different targets on the same CAN bus. The CAN driver keeps track of the number of
+* users that initialized and connected it. Each user subscribes to the CAN identifiers
+* that it wants to receive.
+* Note that the CAN driver has only one CAN interface per process. All its users must
+* therefore be on the same CAN bus and specify the same device, channel and baudrate.
+* Using different CAN buses at the same time, for example can0 and can1, is not
+* supported. Initializing the CAN driver for a second CAN bus fails.
 ****************************************************************************************/
 #ifndef CANDRIVER_H
 #define CANDRIVER_H
@@ -71,12 +81,17 @@ typedef enum
 
 /** \brief Layout of a CAN message. Note that \ref CAN_MSG_EXT_ID_MASK can be used to
  *         configure the CAN message identifier as 29-bit extended.         
+ *         The timestamp holds the time in microseconds since the epoch, at which the
+ *         message was received or transmitted, as reported by the CAN interface. This is
+ *         ideally a hardware time stamp of the CAN controller. A value of 0 means that
+ *         the CAN interface does not support time stamps.
  */
 typedef struct t_can_msg
 {
   uint32_t id;                         /**< CAN message identifier.                    */
   uint8_t dlc;                         /**< CAN message data length code.              */
   uint8_t data[CAN_MSG_MAX_LEN];       /**< Array with CAN message data.               */
+  uint64_t timestamp;                  /**< Reception/transmission time in us.         */
 } tCanMsg;
 
 /** \brief Type to group of CAN interface related settings. The device name specifies
@@ -99,6 +114,8 @@ typedef struct t_can_msg
  *           Example 4: Receive only CAN identifier 0x124 (29-bit)
  *                      .code = 0x80000124
  *                      .mask = 0x9fffffff
+ *         The txFrameGap value configures the minimum time in microseconds between the
+ *         start of two transmitted CAN messages. A value of 0 disables the pacing.
  */
 typedef struct t_can_settings
 {
@@ -107,6 +124,7 @@ typedef struct t_can_settings
   tCanBaudrate baudrate;               /**< Communication speed.                       */
   uint32_t code;                       /**< Code of the reception acceptance filter.   */
   uint32_t mask;                       /**< Mask of the reception acceptance filter.   */
+  uint32_t txFrameGap;                 /**< Minimum time between tx frames in us.      */
 } tCanSettings;
 
 /** \brief Structure with CAN event callback functions. */
@@ -118,6 +136,19 @@ typedef struct t_can_events
   void (*MsgRxed) (tCanMsg const * msg);
 } tCanEvents;
 
+/** \brief Structure with event callback functions for a subscriber of received CAN
+ *         messages. The context is the pointer that the subscriber specified when it
+ *         subscribed, which makes it possible to have multiple subscribers that share
+ *         the same event functions.
+ */
+typedef struct t_can_rx_events
+{
+  /** \brief Event function that should be called when a message was transmitted. */
+  void (*MsgTxed) (void * context, tCanMsg const * msg);
+  /** \brief Event function that should be called when a message was received. */
+  void (*MsgRxed) (void * context, tCanMsg const * msg);
+} tCanRxEvents;
+
 /** \brief CAN interface type. */
 typedef struct t_can_interface
 {
@@ -135,13 +166,18 @@ typedef struct t_can_interface
   bool (*IsBusError) (void);
   /** \brief Registers the event callback functions. */
   void (*RegisterEvents) (tCanEvents const * events);
+  /** \brief Configures the list of CAN identifiers to receive. This one is optional
+   *         and can be left NULL, in which case the reception acceptance filter from
+   *         the settings is used.
+   */
+  void (*SetRxFilters) (uint32_t const * ids, uint32_t count);
 } tCanInterface;
 
 
 /***************************************************************************************
 * Function prototypes
 ****************************************************************************************/
-void CanInit(tCanSettings const * settings);
+bool CanInit(tCanSettings const * settings);
 void CanTerminate(void);
 bool CanConnect(void);
 void CanDisconnect(void);
@@ -149,6 +185,8 @@ bool CanIsConnected(void);
 bool CanTransmit(tCanMsg const * msg);
 bool CanIsBusError(void);
 void CanRegisterEvents(tCanEvents const * events);
+bool CanRegisterRxId(uint32_t id, tCanRxEvents const * events, void * context);
+void CanUnregisterRxId(uint32_t id, tCanRxEvents const * events, void * context);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,910 @@
+/************************************************************************************//**
+* \file         canloopback.c
+* \brief        In-process loopback CAN interface source file.
+* \ingroup      CanLoopback
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+* 
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+* 
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+*
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include <assert.h>                         /* for assertions                          */
+#include <stdint.h>                         /* for standard integer types              */
+#include <stddef.h>                         /* for NULL declaration                    */
+#include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
+#include <string.h>                         /* for string library                      */
+#include <stdio.h>                          /* for standard input/output               */
+#include "util.h"                           /* Utility module                          */
+#include "candriver.h"                      /* Generic CAN driver module               */
+#include "canloopback.h"                    /* In-process loopback CAN interface       */
+
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Maximum number of endpoints that can be attached to the virtual CAN bus. */
+#define CAN_LOOPBACK_ENDPOINTS_MAX     (8u)
+
+/** \brief Prefix of the device name that selects the loopback CAN interface. */
+#define CAN_LOOPBACK_DEVICE_PREFIX     "loopback"
+
+/** \brief Number of bits of a CAN frame with 11-bit identifier and no data, including
+ *         the interframe space. Bit stuffing is not taken into account.
+ */
+#define CAN_LOOPBACK_FRAME_BITS_STD    (47u)
+
+/** \brief Number of bits of a CAN frame with 29-bit identifier and no data, including
+ *         the interframe space. Bit stuffing is not taken into account.
+ */
+#define CAN_LOOPBACK_FRAME_BITS_EXT    (67u)
+
+/** \brief Maximum number of CAN frames that can wait for their delivery after the
+ *         latency. When full, a frame is delivered in the context of the transmitting
+ *         endpoint instead.
+ */
+#define CAN_LOOPBACK_DELIVERY_MAX      (64u)
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Endpoint on the virtual CAN bus. */
+typedef struct t_can_loopback_endpoint_entry
+{
+  bool attached;                                 /**< Entry is in use.                 */
+  tCanEvents events;                             /**< Event callback functions.        */
+} tCanLoopbackEndpointEntry;
+
+/** \brief CAN frame that waits for its delivery after the latency. */
+typedef struct t_can_loopback_delivery
+{
+  tCanMsg msg;                                   /**< Message with delivery time.      */
+  tCanEvents receivers[CAN_LOOPBACK_ENDPOINTS_MAX]; /**< Events of the receivers.      */
+  uint32_t receiverCount;                        /**< Number of receivers.             */
+} tCanLoopbackDelivery;
+
+
+/***************************************************************************************
+* Function prototypes
+****************************************************************************************/
+/* CAN interface functions. */
+static void CanLoopbackInit(tCanSettings const * settings);
+static void CanLoopbackTerminate(void);
+static bool CanLoopbackConnect(void);
+static void CanLoopbackDisconnect(void);
+static bool CanLoopbackTransmit(tCanMsg const * msg);
+static bool CanLoopbackIsBusError(void);
+static void CanLoopbackRegisterEvents(tCanEvents const * events);
+static void CanLoopbackSetRxFilters(uint32_t const * ids, uint32_t count);
+/* Event functions of the CAN interface's own endpoint. */
+static void CanLoopbackEventMessageTransmitted(tCanMsg const * msg);
+static void CanLoopbackEventMessageReceived(tCanMsg const * msg);
+/* Virtual CAN bus functions. */
+static void CanLoopbackParseOptions(char const * devicename);
+static uint32_t CanLoopbackFrameTime(tCanMsg const * msg);
+static bool CanLoopbackFrameLost(void);
+static void CanLoopbackWaitUntil(uint64_t time);
+static void CanLoopbackDeliver(tCanLoopbackDelivery const * delivery);
+/* Delivery thread functions. */
+static void CanLoopbackDeliveryThread(void * arg);
+static void CanLoopbackStopDeliveryThread(void);
+
+
+/****************************************************************************************
+* Local constant declarations
+****************************************************************************************/
+/** \brief CAN interface structure filled with loopback specifics. */
+static const tCanInterface canLoopbackInterface =
+{
+  CanLoopbackInit,
+  CanLoopbackTerminate,
+  CanLoopbackConnect,
+  CanLoopbackDisconnect,
+  CanLoopbackTransmit,
+  CanLoopbackIsBusError,
+  CanLoopbackRegisterEvents,
+  CanLoopbackSetRxFilters
+};
+
+/** \brief Event functions of the CAN interface's own endpoint on the virtual CAN bus. */
+static const tCanEvents canLoopbackIfEvents =
+{
+  CanLoopbackEventMessageTransmitted,
+  CanLoopbackEventMessageReceived
+};
+
+
+/****************************************************************************************
+* Local data declarations
+****************************************************************************************/
+/** \brief List with callback functions that this driver should use. */
+static tCanEvents * canLoopbackEventsList;
+
+/** \brief Total number of event entries into the \ref canLoopbackEventsList list. */
+static uint32_t canLoopbackEventsEntries;
+
+/** \brief The CAN interface's own endpoint on the virtual CAN bus. NULL when not
+ *         connected.
+ */
+static tCanLoopbackEndpoint canLoopbackIfEndpoint;
+
+/** \brief Endpoints on the virtual CAN bus. */
+static tCanLoopbackEndpointEntry canLoopbackEndpoints[CAN_LOOPBACK_ENDPOINTS_MAX];
+
+/** \brief Critical section object that protects the state of the virtual CAN bus, which
+ *         is shared by all endpoints.
+ */
+static tUtilCriticalSection canLoopbackBusCritSect;
+
+/** \brief Time in microseconds at which the virtual CAN bus becomes idle. */
+static uint64_t canLoopbackBusFreeTime;
+
+/** \brief Emulated bitrate of the virtual CAN bus in bits/sec. 0 if disabled. */
+static uint32_t canLoopbackBitrate;
+
+/** \brief Extra delay in microseconds before a CAN frame is received. */
+static uint32_t canLoopbackLatency;
+
+/** \brief Frame loss probability in parts per million. */
+static uint32_t canLoopbackLossPpm;
+
+/** \brief State of the pseudo random generator for the frame loss. */
+static uint32_t canLoopbackRandomState;
+
+/** \brief Ring buffer with the CAN frames that wait for their delivery after the
+ *         latency, ordered by delivery time. It is protected by
+ *         \ref canLoopbackBusCritSect.
+ */
+static tCanLoopbackDelivery canLoopbackDeliveries[CAN_LOOPBACK_DELIVERY_MAX];
+
+/** \brief Index of the oldest entry in the \ref canLoopbackDeliveries ring buffer. */
+static uint32_t canLoopbackDeliveryHead;
+
+/** \brief Total number of entries in the \ref canLoopbackDeliveries ring buffer. */
+static uint32_t canLoopbackDeliveryCount;
+
+/** \brief Thread that delivers the CAN frames after the latency. It is started when the
+ *         first frame needs it. NULL when not running.
+ */
+static tUtilThread canLoopbackDeliveryThread;
+
+/** \brief Event to wake up the delivery thread. */
+static tUtilEvent canLoopbackDeliveryEvent;
+
+/** \brief Flag to request the delivery thread to stop. */
+static bool canLoopbackDeliveryStop;
+
+
+/***********************************************************************************//**
+** \brief     Obtains a pointer to the CAN interface structure, so that it can be linked
+**            to the generic CAN driver module.
+** \return    Pointer to CAN interface structure.
+**
+****************************************************************************************/
+tCanInterface const * CanLoopbackGetInterface(void)
+{
+  return &canLoopbackInterface;
+} /*** end of CanLoopbackGetInterface ***/
+
+
+/************************************************************************************//**
+** \brief     Initializes the CAN interface. This also creates the virtual CAN bus, so
+**            other endpoints can only be attached after this.
+** \param     settings Pointer to the CAN interface settings.
+**
+****************************************************************************************/
+static void CanLoopbackInit(tCanSettings const * settings)
+{
+  /* Initialize locals. */
+  canLoopbackEventsList = NULL;
+  canLoopbackEventsEntries = 0;
+  canLoopbackIfEndpoint = NULL;
+  for (uint32_t idx = 0; idx < CAN_LOOPBACK_ENDPOINTS_MAX; idx++)
+  {
+    canLoopbackEndpoints[idx].attached = false;
+  }
+  canLoopbackBusFreeTime = 0;
+  canLoopbackBitrate = 500000;
+  canLoopbackLatency = 0;
+  canLoopbackLossPpm = 0;
+  canLoopbackRandomState = 1;
+  canLoopbackDeliveryHead = 0;
+  canLoopbackDeliveryCount = 0;
+  canLoopbackDeliveryThread = NULL;
+  canLoopbackDeliveryStop = false;
+  /* Create the critical section object for protecting the virtual CAN bus and the
+   * event for waking up the delivery thread.
+   */
+  canLoopbackBusCritSect = UtilCriticalSectionCreate();
+  assert(canLoopbackBusCritSect != NULL);
+  canLoopbackDeliveryEvent = UtilEventCreate();
+  assert(canLoopbackDeliveryEvent != NULL);
+
+  /* Check parameters. */
+  assert(settings != NULL);
+
+  /* Only continue with valid parameters. */
+  if (settings != NULL) /*lint !e774 */
+  {
+    /* Emulate the configured baudrate by default. */
+    switch (settings->baudrate)
+    {
+      case CAN_BR10K:
+        canLoopbackBitrate = 10000;
+        break;
+      case CAN_BR20K:
+        canLoopbackBitrate = 20000;
+        break;
+      case CAN_BR50K:
+        canLoopbackBitrate = 50000;
+        break;
+      case CAN_BR100K:
+        canLoopbackBitrate = 100000;
+        break;
+      case CAN_BR125K:
+        canLoopbackBitrate = 125000;
+        break;
+      case CAN_BR250K:
+        canLoopbackBitrate = 250000;
+        break;
+      case CAN_BR800K:
+        canLoopbackBitrate = 800000;
+        break;
+      case CAN_BR1M:
+        canLoopbackBitrate = 1000000;
+        break;
+      case CAN_BR500K:
+      default:
+        canLoopbackBitrate = 500000;
+        break;
+    }
+    /* Process the options that were appended to the device name. */
+    if (settings->devicename != NULL)
+    {
+      CanLoopbackParseOptions(settings->devicename);
+    }
+  }
+} /*** end of CanLoopbackInit ***/
+
+
+/************************************************************************************//**
+** \brief     Terminates the CAN interface. This also detaches all endpoints from the
+**            virtual CAN bus.
+**
+****************************************************************************************/
+static void CanLoopbackTerminate(void)
+{
+  /* Stop the delivery thread. Frames that still wait for their delivery are dropped. */
+  CanLoopbackStopDeliveryThread();
+  /* Detach all endpoints. */
+  for (uint32_t idx = 0; idx < CAN_LOOPBACK_ENDPOINTS_MAX; idx++)
+  {
+    canLoopbackEndpoints[idx].attached = false;
+  }
+  canLoopbackIfEndpoint = NULL;
+  /* Release memory that was allocated for CAN events and reset the entry count. */
+  if ( (canLoopbackEventsList != NULL) && (canLoopbackEventsEntries != 0) )
+  {
+    free(canLoopbackEventsList);
+    canLoopbackEventsList = NULL;
+    canLoopbackEventsEntries = 0;
+  }
+  /* Destroy the critical section and event objects. */
+  UtilEventDestroy(canLoopbackDeliveryEvent);
+  canLoopbackDeliveryEvent = NULL;
+  UtilCriticalSectionDestroy(canLoopbackBusCritSect);
+  canLoopbackBusCritSect = NULL;
+} /*** end of CanLoopbackTerminate ***/
+
+
+/************************************************************************************//**
+** \brief     Connects the CAN interface, by attaching its own endpoint to the virtual
+**            CAN bus.
+** \return    True if connected, false otherwise.
+**
+****************************************************************************************/
+static bool CanLoopbackConnect(void)
+{
+  bool result = false;
+
+  /* Attach the endpoint, if not already done. */
+  if (canLoopbackIfEndpoint == NULL)
+  {
+    canLoopbackIfEndpoint = CanLoopbackEndpointAttach(&canLoopbackIfEvents);
+  }
+  /* Update the result. */
+  if (canLoopbackIfEndpoint != NULL)
+  {
+    result = true;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of CanLoopbackConnect ***/
+
+
+/************************************************************************************//**
+** \brief     Disconnects the CAN interface, by detaching its own endpoint from the
+**            virtual CAN bus.
+**
+****************************************************************************************/
+static void CanLoopbackDisconnect(void)
+{
+  /* Detach the endpoint, if attached. */
+  if (canLoopbackIfEndpoint != NULL)
+  {
+    CanLoopbackEndpointDetach(canLoopbackIfEndpoint);
+    canLoopbackIfEndpoint = NULL;
+  }
+} /*** end of CanLoopbackDisconnect ***/
+
+
+/************************************************************************************//**
+** \brief     Submits a message for transmission on the CAN bus.
+** \param     msg Pointer to CAN message structure.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+static bool CanLoopbackTransmit(tCanMsg const * msg)
+{
+  bool result = false;
+
+  /* Only continue if connected. */
+  if (canLoopbackIfEndpoint != NULL)
+  {
+    result = CanLoopbackEndpointTransmit(canLoopbackIfEndpoint, msg);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of CanLoopbackTransmit ***/
+
+
+/************************************************************************************//**
+** \brief     Checks if a bus off or bus heavy situation occurred. The virtual CAN bus
+**            never has bus errors.
+** \return    True if a bus error situation was detected, false otherwise.
+**
+****************************************************************************************/
+static bool CanLoopbackIsBusError(void)
+{
+  return false;
+} /*** end of CanLoopbackIsBusError ***/
+
+
+/************************************************************************************//**
+** \brief     Registers the event callback functions that should be called by the CAN
+**            interface.
+** \param     events Pointer to structure with event callback function pointers.
+**
+****************************************************************************************/
+static void CanLoopbackRegisterEvents(tCanEvents const * events)
+{
+  /* Check parameters. */
+  assert(events != NULL);
+
+  /* Only continue with valid parameters. */
+  if (events != NULL) /*lint !e774 */
+  {
+    /* Increase length of the list to make space for one more event entry. Note that
+     * it is okay to call realloc with a NULL pointer. In this case it simply behaves
+     * as malloc.
+     */
+    canLoopbackEventsList = realloc(canLoopbackEventsList,
+                                    (sizeof(tCanEvents) * (canLoopbackEventsEntries + 1)));
+    /* Assert reallocation. */
+    assert(canLoopbackEventsList != NULL);
+    /* Only continue if reallocation was successful. */
+    if (canLoopbackEventsList != NULL)
+    {
+      /* Increment events entry count. */
+      canLoopbackEventsEntries++;
+      /* Store the events in the new entry. */
+      canLoopbackEventsList[canLoopbackEventsEntries - 1] = *events;
+    }
+    /* Reallocation failed. */
+    else
+    {
+      /* Reset events entry count. */
+      canLoopbackEventsEntries = 0;
+    }
+  }
+} /*** end of CanLoopbackRegisterEvents ***/
+
+
+/************************************************************************************//**
+** \brief     Configures the list of CAN identifiers to receive. The virtual CAN bus
+**            delivers all CAN messages and the CAN driver dispatches them to the
+**            subscribers of their identifier, so there is nothing to configure. Having
+**            this function does allow multiple users with different reception
+**            identifiers to share the virtual CAN bus, such as concurrent sessions that
+**            each program another simulated target.
+** \param     ids Array with the CAN identifiers to receive.
+** \param     count Number of entries in the array.
+**
+****************************************************************************************/
+static void CanLoopbackSetRxFilters(uint32_t const * ids, uint32_t count)
+{
+  /* Nothing to configure. */
+  (void)ids;
+  (void)count;
+} /*** end of CanLoopbackSetRxFilters ***/
+
+
+/************************************************************************************//**
+** \brief     Event function of the CAN interface's own endpoint that gets called each
+**            time it transmitted a CAN message. It triggers the transmit complete
+**            event(s).
+** \param     msg Pointer to the transmitted CAN message.
+**
+****************************************************************************************/
+static void CanLoopbackEventMessageTransmitted(tCanMsg const * msg)
+{
+  for (uint32_t idx = 0; idx < canLoopbackEventsEntries; idx++)
+  {
+    if (canLoopbackEventsList[idx].MsgTxed != NULL)
+    {
+      canLoopbackEventsList[idx].MsgTxed(msg);
+    }
+  }
+} /*** end of CanLoopbackEventMessageTransmitted ***/
+
+
+/************************************************************************************//**
+** \brief     Event function of the CAN interface's own endpoint that gets called each
+**            time it received a CAN message. It triggers the message reception event(s).
+** \param     msg Pointer to the received CAN message.
+**
+****************************************************************************************/
+static void CanLoopbackEventMessageReceived(tCanMsg const * msg)
+{
+  for (uint32_t idx = 0; idx < canLoopbackEventsEntries; idx++)
+  {
+    if (canLoopbackEventsList[idx].MsgRxed != NULL)
+    {
+      canLoopbackEventsList[idx].MsgRxed(msg);
+    }
+  }
+} /*** end of CanLoopbackEventMessageReceived ***/
+
+
+/************************************************************************************//**
+** \brief     Attaches an endpoint to the virtual CAN bus. Its MsgRxed event function is
+**            called for each CAN message that another endpoint transmits. Its MsgTxed
+**            event function is called for each CAN message that it transmitted itself.
+**            Note that the event functions are called from the context of the
+**            transmitting endpoint or, when a latency is configured, from the context of
+**            the delivery thread. It is okay to transmit a response from within the
+**            MsgRxed event function.
+** \param     events Pointer to structure with event callback function pointers.
+** \return    Handle of the endpoint if successful, NULL otherwise.
+**
+****************************************************************************************/
+tCanLoopbackEndpoint CanLoopbackEndpointAttach(tCanEvents const * events)
+{
+  tCanLoopbackEndpoint result = NULL;
+
+  /* Check parameters. */
+  assert(events != NULL);
+
+  /* Only continue with valid parameters and if the virtual CAN bus exists. */
+  if ( (events != NULL) && (canLoopbackBusCritSect != NULL) ) /*lint !e774 */
+  {
+    UtilCriticalSectionLock(canLoopbackBusCritSect);
+    /* Find a free entry for the endpoint. */
+    for (uint32_t idx = 0; idx < CAN_LOOPBACK_ENDPOINTS_MAX; idx++)
+    {
+      if (!canLoopbackEndpoints[idx].attached)
+      {
+        canLoopbackEndpoints[idx].events = *events;
+        canLoopbackEndpoints[idx].attached = true;
+        result = &canLoopbackEndpoints[idx];
+        break;
+      }
+    }
+    UtilCriticalSectionUnlock(canLoopbackBusCritSect);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of CanLoopbackEndpointAttach ***/
+
+
+/************************************************************************************//**
+** \brief     Detaches an endpoint from the virtual CAN bus.
+** \param     endpoint Handle of the endpoint.
+**
+****************************************************************************************/
+void CanLoopbackEndpointDetach(tCanLoopbackEndpoint endpoint)
+{
+  tCanLoopbackEndpointEntry * entry = endpoint;
+
+  /* Check parameters. */
+  assert(endpoint != NULL);
+
+  /* Only continue with valid parameters and if the virtual CAN bus exists. */
+  if ( (endpoint != NULL) && (canLoopbackBusCritSect != NULL) ) /*lint !e774 */
+  {
+    UtilCriticalSectionLock(canLoopbackBusCritSect);
+    entry->attached = false;
+    UtilCriticalSectionUnlock(canLoopbackBusCritSect);
+  }
+} /*** end of CanLoopbackEndpointDetach ***/
+
+
+/************************************************************************************//**
+** \brief     Transmits a CAN message on the virtual CAN bus. The message starts as soon
+**            as the bus is idle and occupies it for the duration of the frame at the
+**            emulated bitrate. This function returns once the frame completed on the
+**            bus. Without latency, the message is delivered to all other endpoints
+**            before that. With latency, the delivery thread delivers it once the latency
+**            passed, so this function does not wait for it. If the message got lost,
+**            only the transmitting endpoint gets notified.
+** \param     endpoint Handle of the transmitting endpoint.
+** \param     msg Pointer to CAN message structure.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+bool CanLoopbackEndpointTransmit(tCanLoopbackEndpoint endpoint, tCanMsg const * msg)
+{
+  bool result = false;
+  tCanLoopbackEndpointEntry * sender = endpoint;
+  tCanEvents senderEvents = { NULL, NULL };
+  tCanLoopbackDelivery delivery;
+  tCanLoopbackDelivery * queued;
+  uint64_t startTime = 0;
+  uint64_t endTime = 0;
+  bool lost = false;
+  bool deliverNow = false;
+  tCanMsg busMsg;
+
+  /* Check parameters. */
+  assert(endpoint != NULL);
+  assert(msg != NULL);
+
+  /* Only continue with valid parameters and if the virtual CAN bus exists. */
+  if ( (endpoint != NULL) && (msg != NULL) && (msg->dlc <= CAN_MSG_MAX_LEN) &&
+       (canLoopbackBusCritSect != NULL) ) /*lint !e774 */
+  {
+    UtilCriticalSectionLock(canLoopbackBusCritSect);
+    /* Only an attached endpoint can transmit. */
+    if (sender->attached)
+    {
+      /* Occupy the bus for the duration of the frame, once it is idle. */
+      startTime = UtilTimeGetSystemTimeUs();
+      if (startTime < canLoopbackBusFreeTime)
+      {
+        startTime = canLoopbackBusFreeTime;
+      }
+      endTime = startTime + CanLoopbackFrameTime(msg);
+      canLoopbackBusFreeTime = endTime;
+      lost = CanLoopbackFrameLost();
+      /* Copy the event functions, because they are called outside of the critical
+       * section. This allows the endpoints to transmit from their event functions.
+       */
+      senderEvents = sender->events;
+      delivery.msg = *msg;
+      delivery.msg.timestamp = endTime + canLoopbackLatency;
+      delivery.receiverCount = 0;
+      for (uint32_t idx = 0; idx < CAN_LOOPBACK_ENDPOINTS_MAX; idx++)
+      {
+        if ( (canLoopbackEndpoints[idx].attached) && (&canLoopbackEndpoints[idx] != sender) )
+        {
+          delivery.receivers[delivery.receiverCount] = canLoopbackEndpoints[idx].events;
+          delivery.receiverCount++;
+        }
+      }
+      /* With latency, hand the frame over to the delivery thread, if there is space.
+       * Frames are added in the order in which they occupy the bus, so the ring buffer
+       * is ordered by delivery time.
+       */
+      if ( (!lost) && (delivery.receiverCount > 0) )
+      {
+        deliverNow = true;
+        if (canLoopbackLatency > 0)
+        {
+          if (canLoopbackDeliveryThread == NULL)
+          {
+            canLoopbackDeliveryStop = false;
+            canLoopbackDeliveryThread = UtilThreadCreate(CanLoopbackDeliveryThread,
+                                                         NULL);
+          }
+          if ( (canLoopbackDeliveryThread != NULL) &&
+               (canLoopbackDeliveryCount < CAN_LOOPBACK_DELIVERY_MAX) )
+          {
+            queued = &canLoopbackDeliveries[(canLoopbackDeliveryHead +
+                                             canLoopbackDeliveryCount) %
+                                            CAN_LOOPBACK_DELIVERY_MAX];
+            *queued = delivery;
+            canLoopbackDeliveryCount++;
+            UtilEventSet(canLoopbackDeliveryEvent);
+            deliverNow = false;
+          }
+        }
+      }
+      result = true;
+    }
+    UtilCriticalSectionUnlock(canLoopbackBusCritSect);
+
+    /* Only continue if the message is on the bus. */
+    if (result)
+    {
+      /* Notify the sender once the frame completed on the bus. */
+      CanLoopbackWaitUntil(endTime);
+      busMsg = *msg;
+      busMsg.timestamp = startTime;
+      if (senderEvents.MsgTxed != NULL)
+      {
+        senderEvents.MsgTxed(&busMsg);
+      }
+      /* Deliver the frame to the other endpoints, unless the delivery thread does it. */
+      if (deliverNow)
+      {
+        CanLoopbackWaitUntil(delivery.msg.timestamp);
+        CanLoopbackDeliver(&delivery);
+      }
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of CanLoopbackEndpointTransmit ***/
+
+
+/************************************************************************************//**
+** \brief     Processes the options that were appended to the device name, such as
+**            "loopback:latency=200,bitrate=1000000,loss=0.5,seed=7". Unknown options
+**            are ignored.
+** \param     devicename The device name.
+**
+****************************************************************************************/
+static void CanLoopbackParseOptions(char const * devicename)
+{
+  char const * option;
+  unsigned long value;
+  double percentage;
+
+  /* Check parameters. */
+  assert(devicename != NULL);
+
+  /* Only continue with valid parameters. */
+  if (devicename != NULL) /*lint !e774 */
+  {
+    /* The options start after the colon. */
+    option = strchr(devicename, ':');
+    while (option != NULL)
+    {
+      /* Skip the separator. */
+      option++;
+      /* Process the option. */
+      if (sscanf(option, "latency=%lu", &value) == 1)
+      {
+        canLoopbackLatency = (uint32_t)value;
+      }
+      else if (sscanf(option, "bitrate=%lu", &value) == 1)
+      {
+        canLoopbackBitrate = (uint32_t)value;
+      }
+      else if (sscanf(option, "seed=%lu", &value) == 1)
+      {
+        /* Note that the pseudo random generator cannot have an all zero state. */
+        canLoopbackRandomState = (value != 0) ? (uint32_t)value : 1u;
+      }
+      else if (sscanf(option, "loss=%lf", &percentage) == 1)
+      {
+        if (percentage < 0.0)
+        {
+          percentage = 0.0;
+        }
+        else if (percentage > 100.0)
+        {
+          percentage = 100.0;
+        }
+        canLoopbackLossPpm = (uint32_t)(percentage * 10000.0);
+      }
+      /* Move on to the next option. */
+      option = strchr(option, ',');
+    }
+  }
+} /*** end of CanLoopbackParseOptions ***/
+
+
+/************************************************************************************//**
+** \brief     Calculates how long a CAN message occupies the virtual CAN bus at the
+**            emulated bitrate.
+** \param     msg Pointer to CAN message structure.
+** \return    Frame time in microseconds.
+**
+****************************************************************************************/
+static uint32_t CanLoopbackFrameTime(tCanMsg const * msg)
+{
+  uint32_t result = 0;
+  uint32_t bits;
+
+  /* Only calculate the frame time, if the bitrate emulation is enabled. */
+  if (canLoopbackBitrate > 0)
+  {
+    /* Determine the number of bits in the frame. */
+    bits = ((msg->id & CAN_MSG_EXT_ID_MASK) != 0) ? CAN_LOOPBACK_FRAME_BITS_EXT :
+                                                     CAN_LOOPBACK_FRAME_BITS_STD;
+    bits += 8u * msg->dlc;
+    /* Convert to microseconds and round up. */
+    result = (uint32_t)((((uint64_t)bits * 1000000u) + canLoopbackBitrate - 1u) /
+                        canLoopbackBitrate);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of CanLoopbackFrameTime ***/
+
+
+/************************************************************************************//**
+** \brief     Determines if the next CAN message gets lost on the virtual CAN bus. A
+**            xorshift pseudo random generator is used, such that a specific seed always
+**            results in the same frames getting lost.
+** \return    True if the CAN message gets lost, false otherwise.
+**
+****************************************************************************************/
+static bool CanLoopbackFrameLost(void)
+{
+  bool result = false;
+
+  /* Only run the pseudo random generator, if frame loss is enabled. */
+  if (canLoopbackLossPpm > 0)
+  {
+    canLoopbackRandomState ^= canLoopbackRandomState << 13;
+    canLoopbackRandomState ^= canLoopbackRandomState >> 17;
+    canLoopbackRandomState ^= canLoopbackRandomState << 5;
+    result = ((canLoopbackRandomState % 1000000u) < canLoopbackLossPpm);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of CanLoopbackFrameLost ***/
+
+
+/************************************************************************************//**
+** \brief     Waits until the specified time. The bulk of the time is slept and the last
+**            part is spent polling, because a sleep is not accurate enough for emulating
+**            the timing of a CAN bus.
+** \param     time Time in microseconds to wait for.
+**
+****************************************************************************************/
+static void CanLoopbackWaitUntil(uint64_t time)
+{
+  uint64_t now;
+
+  now = UtilTimeGetSystemTimeUs();
+  while (now < time)
+  {
+    /* Sleep if more than two milliseconds remain. */
+    if ((time - now) > 2000u)
+    {
+      UtilTimeDelayMs((uint16_t)(((time - now) / 1000u) - 1u));
+    }
+    now = UtilTimeGetSystemTimeUs();
+  }
+} /*** end of CanLoopbackWaitUntil ***/
+
+
+/************************************************************************************//**
+** \brief     Delivers a CAN frame to the receiving endpoints.
+** \param     delivery Pointer to the CAN frame with the events of its receivers.
+**
+****************************************************************************************/
+static void CanLoopbackDeliver(tCanLoopbackDelivery const * delivery)
+{
+  for (uint32_t idx = 0; idx < delivery->receiverCount; idx++)
+  {
+    if (delivery->receivers[idx].MsgRxed != NULL)
+    {
+      delivery->receivers[idx].MsgRxed(&delivery->msg);
+    }
+  }
+} /*** end of CanLoopbackDeliver ***/
+
+
+/************************************************************************************//**
+** \brief     Delivery thread. It waits until the delivery time of the oldest CAN frame
+**            in the \ref canLoopbackDeliveries ring buffer and then delivers it to the
+**            receiving endpoints.
+** \param     arg Not used.
+**
+****************************************************************************************/
+static void CanLoopbackDeliveryThread(void * arg)
+{
+  bool stop = false;
+  bool pending;
+  uint64_t deliveryTime = 0;
+  tCanLoopbackDelivery delivery;
+
+  (void)arg;
+
+  while (!stop)
+  {
+    /* Reset the wake up event before checking the ring buffer, so a frame that is added
+     * after the check is not missed.
+     */
+    UtilEventReset(canLoopbackDeliveryEvent);
+    UtilCriticalSectionLock(canLoopbackBusCritSect);
+    stop = canLoopbackDeliveryStop;
+    pending = (canLoopbackDeliveryCount > 0);
+    if (pending)
+    {
+      deliveryTime = canLoopbackDeliveries[canLoopbackDeliveryHead].msg.timestamp;
+    }
+    UtilCriticalSectionUnlock(canLoopbackBusCritSect);
+    if (stop)
+    {
+      break;
+    }
+    if (pending)
+    {
+      /* Only this thread removes entries, so the oldest one is still the same after
+       * waiting for its delivery time.
+       */
+      CanLoopbackWaitUntil(deliveryTime);
+      UtilCriticalSectionLock(canLoopbackBusCritSect);
+      delivery = canLoopbackDeliveries[canLoopbackDeliveryHead];
+      canLoopbackDeliveryHead = (canLoopbackDeliveryHead + 1u) %
+                                CAN_LOOPBACK_DELIVERY_MAX;
+      canLoopbackDeliveryCount--;
+      UtilCriticalSectionUnlock(canLoopbackBusCritSect);
+      CanLoopbackDeliver(&delivery);
+    }
+    else
+    {
+      (void)UtilEventWait(canLoopbackDeliveryEvent, UTIL_EVENT_WAIT_INFINITE);
+    }
+  }
+} /*** end of CanLoopbackDeliveryThread ***/
+
+
+/************************************************************************************//**
+** \brief     Stops the delivery thread, if it is running. CAN frames that still wait
+**            for their delivery are dropped.
+**
+****************************************************************************************/
+static void CanLoopbackStopDeliveryThread(void)
+{
+  tUtilThread thread;
+
+  if (canLoopbackBusCritSect != NULL)
+  {
+    UtilCriticalSectionLock(canLoopbackBusCritSect);
+    thread = canLoopbackDeliveryThread;
+    canLoopbackDeliveryStop = true;
+    UtilCriticalSectionUnlock(canLoopbackBusCritSect);
+    if (thread != NULL)
+    {
+      UtilEventSet(canLoopbackDeliveryEvent);
+      UtilThreadJoin(thread);
+    }
+    UtilCriticalSectionLock(canLoopbackBusCritSect);
+    canLoopbackDeliveryThread = NULL;
+    canLoopbackDeliveryHead = 0;
+    canLoopbackDeliveryCount = 0;
+    UtilCriticalSectionUnlock(canLoopbackBusCritSect);
+  }
+} /*** end of CanLoopbackStopDeliveryThread ***/
+
+
+/********************************* end of canloopback.c ********************************/
@@ -0,0 +1,80 @@
+/************************************************************************************//**
+* \file         canloopback.h
+* \brief        In-process loopback CAN interface header file.
+* \ingroup      CanLoopback
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+* 
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+* 
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+*
+* \endinternal
+****************************************************************************************/
+/************************************************************************************//**
+* \defgroup   CanLoopback In-process loopback CAN interface
+* \brief      This module implements a CAN interface that connects in-process endpoints
+*             through a virtual CAN bus.
+* \ingroup    CanDriver
+* \details
+* The loopback CAN interface does not need any CAN hardware or kernel configuration. It
+* is selected with a device name that starts with "loopback". Options for the virtual
+* CAN bus can be appended after a colon, separated by commas:
+*   - latency=<us>   Extra delay in microseconds between the end of a CAN frame on the
+*                    bus and its reception by the other endpoints. Default 0.
+*   - bitrate=<bps>  Emulated bitrate of the bus. Defaults to the configured baudrate.
+*                    A value of 0 disables the bitrate emulation.
+*   - loss=<pct>     Percentage of CAN frames that get lost on the bus. Default 0.
+*   - seed=<value>   Seed of the pseudo random generator for the frame loss. Default 1.
+* Example: "loopback:latency=200,loss=0.5".
+* The CAN interface itself is one endpoint on the virtual CAN bus. Other in-process
+* code, such as a simulated target, attaches as an additional endpoint. The transmitting
+* endpoint waits until its CAN frame completed on the emulated bus. Without latency, the
+* frame is then delivered in the context of the transmitting endpoint. With latency, a
+* delivery thread delivers it once the latency passed, so that the next frame can
+* already be transmitted in the meantime, like on a real CAN bus.
+****************************************************************************************/
+#ifndef CANLOOPBACK_H
+#define CANLOOPBACK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Handle of an endpoint on the virtual CAN bus. */
+typedef void * tCanLoopbackEndpoint;
+
+
+/***************************************************************************************
+* Function prototypes
+****************************************************************************************/
+tCanInterface const * CanLoopbackGetInterface(void);
+tCanLoopbackEndpoint CanLoopbackEndpointAttach(tCanEvents const * events);
+void CanLoopbackEndpointDetach(tCanLoopbackEndpoint endpoint);
+bool CanLoopbackEndpointTransmit(tCanLoopbackEndpoint endpoint, tCanMsg const * msg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CANLOOPBACK_H */
+/********************************* end of canloopback.h ********************************/
@@ -0,0 +1,669 @@
+/************************************************************************************//**
+* \file         firmwarecache.c
+* \brief        Firmware cache module source file.
+* \ingroup      Firmware
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+* 
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+* 
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+*
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include <assert.h>                         /* for assertions                          */
+#include <stdint.h>                         /* for standard integer types              */
+#include <stddef.h>                         /* for NULL declaration                    */
+#include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
+#include <stdio.h>                          /* for standard I/O library                */
+#include <string.h>                         /* for string library                      */
+#include "util.h"                           /* Utility module                          */
+#include "firmware.h"                       /* Firmware data module                    */
+#include "firmwarecache.h"                  /* Firmware cache module                   */
+
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Identifies a cache file. It reads as "BFWC" on a little endian system, so a
+ *         cache file of a system with a different byte order is not recognized.
+ */
+#define FIRMWARE_CACHE_MAGIC           (0x43574642u)
+/** \brief Version of the layout of the cache file. Increment it when the layout
+ *         changes, such that existing cache files are no longer used.
+ */
+#define FIRMWARE_CACHE_VERSION         (2u)
+/** \brief Extension of a cache file. */
+#define FIRMWARE_CACHE_EXTENSION       ".fwc"
+/** \brief Extension of a cache file that is still being written. */
+#define FIRMWARE_CACHE_TMP_EXTENSION   ".tmp"
+/** \brief Maximum number of characters of the name of a cache file, without the
+ *         directory.
+ */
+#define FIRMWARE_CACHE_NAME_LEN_MAX    (64u)
+/** \brief Number of bytes of the firmware file that are read at a time, to calculate
+ *         the hash of its contents.
+ */
+#define FIRMWARE_CACHE_CHUNK_SIZE      (65536u)
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Key of a cache file. The firmware data only depends on the contents of the
+ *         firmware file, the parser and the address offset, not on the name or the time
+ *         stamp of the file. The contents are identified by their SHA-256 hash, because
+ *         two different files with the same 32-bit CRC and size are too easily made. A
+ *         changed file therefore never matches a stale cache file.
+ */
+typedef struct t_firmware_cache_key
+{
+  /** \brief SHA-256 hash of the contents of the firmware file. */
+  uint8_t hash[UTIL_CHECKSUM_SHA256_LEN];
+  /** \brief Number of bytes in the firmware file. */
+  uint32_t size;
+  /** \brief Firmware file parser that loads the firmware file. */
+  uint32_t parserId;
+  /** \brief Memory address offset that is added when loading the firmware file. */
+  uint32_t addressOffset;
+} tFirmwareCacheKey;
+
+/** \brief Header at the start of a cache file. It is followed by the table with the
+ *         segments and then by the data of all segments, one after the other. All
+ *         values are 32-bit and in the byte order of the system, so the cache file can
+ *         be mapped into memory and used as is. The header is 64 bytes, which keeps the
+ *         segment table aligned to 8 bytes. It holds the entire key, so a cache file is
+ *         only used if the full hash matches, not just the part in its name.
+ */
+typedef struct t_firmware_cache_header
+{
+  /** \brief FIRMWARE_CACHE_MAGIC. */
+  uint32_t magic;
+  /** \brief FIRMWARE_CACHE_VERSION. */
+  uint32_t version;
+  /** \brief Key of the firmware file that the cache file belongs to. */
+  tFirmwareCacheKey key;
+  /** \brief Number of segments. */
+  uint32_t segmentCount;
+  /** \brief Total number of data bytes of all segments. */
+  uint32_t dataSize;
+  /** \brief 32-bit CRC of the segment table and the data, which detects a damaged
+   *         cache file.
+   */
+  uint32_t checksum;
+} tFirmwareCacheHeader;
+
+/** \brief Entry of the segment table of a cache file. */
+typedef struct t_firmware_cache_segment
+{
+  /** \brief Start memory address of the segment. */
+  uint32_t base;
+  /** \brief Number of data bytes in the segment. */
+  uint32_t length;
+} tFirmwareCacheSegment;
+
+/** \brief File in the cache directory, as found when scanning it for eviction. */
+typedef struct t_firmware_cache_file
+{
+  /** \brief Name of the file, without the directory. */
+  char name[FIRMWARE_CACHE_NAME_LEN_MAX];
+  /** \brief Number of bytes in the file. */
+  uint64_t size;
+  /** \brief Time of the last modification, or of the last use, in microseconds. */
+  uint64_t modified;
+} tFirmwareCacheFile;
+
+/** \brief Result of scanning the cache directory. */
+typedef struct t_firmware_cache_scan
+{
+  /** \brief Array with the files of the cache. */
+  tFirmwareCacheFile * files;
+  /** \brief Number of files in the array. */
+  uint32_t count;
+  /** \brief Number of files that the array can hold. */
+  uint32_t capacity;
+  /** \brief Total number of bytes of all files. */
+  uint64_t totalSize;
+  /** \brief True if the array could not be enlarged. */
+  bool incomplete;
+} tFirmwareCacheScan;
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+static bool FirmwareCacheGetKey(char const * firmwareFile, uint32_t parserId,
+                                uint32_t addressOffset, tFirmwareCacheKey * key);
+static char * FirmwareCacheGetFilename(tFirmwareCacheKey const * key,
+                                       char const * suffix);
+static bool FirmwareCacheRead(tFirmwareCacheKey const * key);
+static void FirmwareCacheWrite(tFirmwareCacheKey const * key);
+static void FirmwareCacheEvict(void);
+static void FirmwareCacheScanFile(char const * name, uint64_t size, uint64_t modified,
+                                  void * arg);
+static int FirmwareCacheCompareFiles(void const * file1, void const * file2);
+
+
+/****************************************************************************************
+* Local data declarations
+****************************************************************************************/
+/** \brief Directory with the cache files. NULL if the cache is disabled. */
+static char * cacheDirectory;
+
+/** \brief Maximum total size of the cache files in kilobytes. 0 for no limit. */
+static uint32_t cacheMaxSize;
+
+
+/************************************************************************************//**
+** \brief     Configures the cache with the firmware data of firmware files. Parsing a
+**            large firmware file takes a while. The cache stores the firmware data of
+**            each firmware file that is loaded, in a binary file that is named after
+**            the SHA-256 hash of the contents of the firmware file. Loading the same
+**            contents again, from any file and by any process, then only takes reading
+**            the firmware file to calculate its hash and mapping the cache file
+**            into memory. Once the cache files take more space than allowed, the ones
+**            that were used least recently are removed.
+** \param     directory Existing directory for the cache files. NULL or an empty string
+**            to disable the cache, which is the default.
+** \param     maxSize Maximum total size of the cache files in kilobytes. 0 for no
+**            limit.
+**
+****************************************************************************************/
+void FirmwareCacheConfigure(char const * directory, uint32_t maxSize)
+{
+  /* Release the previous configuration. */
+  free(cacheDirectory);
+  cacheDirectory = NULL;
+  cacheMaxSize = maxSize;
+  /* Store a copy of the directory. */
+  if ( (directory != NULL) && (directory[0] != '\0') )
+  {
+    cacheDirectory = malloc(strlen(directory) + 1u);
+    assert(cacheDirectory != NULL);
+    if (cacheDirectory != NULL) /*lint !e774 */
+    {
+      strcpy(cacheDirectory, directory);
+    }
+  }
+} /*** end of FirmwareCacheConfigure ***/
+
+
+/************************************************************************************//**
+** \brief     Loads the firmware data of a firmware file from the cache, or with the
+**            linked parser if it is not yet in the cache. The cache is only used if the
+**            firmware data module did not yet hold any firmware data. Otherwise the
+**            firmware data of the file cannot be told apart from the firmware data that
+**            was already there, neither for adding it to the cache, nor for removing it
+**            again when the cache file turns out to be unusable.
+** \param     firmwareFile Filename of the firmware file to load.
+** \param     parserId Identifies the linked parser.
+** \param     addressOffset Optional memory address offset to add when loading the
+**            firmware data from the file.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+bool FirmwareCacheLoadFromFile(char const * firmwareFile, uint32_t parserId,
+                               uint32_t addressOffset)
+{
+  bool result = false;
+  bool cacheable = false;
+  tFirmwareCacheKey key;
+
+  /* Verify parameters. */
+  assert(firmwareFile != NULL);
+
+  /* Only continue if parameters are valid. */
+  if (firmwareFile != NULL) /*lint !e774 */
+  {
+    /* Look up the firmware file in the cache, if enabled. */
+    if ( (cacheDirectory != NULL) && (FirmwareGetSegmentCount() == 0) )
+    {
+      if (FirmwareCacheGetKey(firmwareFile, parserId, addressOffset, &key))
+      {
+        cacheable = true;
+        result = FirmwareCacheRead(&key);
+        /* Remove the firmware data that was already added from a cache file that
+         * turned out to be unusable, such that the parser starts from scratch.
+         */
+        if (!result)
+        {
+          FirmwareClearData();
+        }
+      }
+    }
+    /* Parse the firmware file if it is not in the cache. */
+    if (!result)
+    {
+      result = FirmwareLoadFromFile(firmwareFile, addressOffset);
+      /* Add the firmware data to the cache. */
+      if ( (result) && (cacheable) )
+      {
+        FirmwareCacheWrite(&key);
+      }
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of FirmwareCacheLoadFromFile ***/
+
+
+/************************************************************************************//**
+** \brief     Determines the key of a firmware file, by reading the firmware file and
+**            calculating the hash of its contents.
+** \param     firmwareFile Filename of the firmware file.
+** \param     parserId Identifies the linked parser.
+** \param     addressOffset Memory address offset to add when loading the firmware file.
+** \param     key Pointer to the key where the result is written to.
+** \return    True if successful, false if the firmware file could not be read.
+**
+****************************************************************************************/
+static bool FirmwareCacheGetKey(char const * firmwareFile, uint32_t parserId,
+                                uint32_t addressOffset, tFirmwareCacheKey * key)
+{
+  bool result = false;
+  FILE * fp;
+  uint8_t * buffer;
+  size_t bytesRead;
+  uint64_t size = 0;
+  tUtilChecksumSha256 hashContext;
+
+  /* Check parameters. */
+  assert(firmwareFile != NULL);
+  assert(key != NULL);
+
+  memset(key, 0, sizeof(tFirmwareCacheKey));
+  key->parserId = parserId;
+  key->addressOffset = addressOffset;
+  buffer = malloc(FIRMWARE_CACHE_CHUNK_SIZE);
+  fp = fopen(firmwareFile, "rb");
+  if ( (buffer != NULL) && (fp != NULL) )
+  {
+    /* Calculate the hash over the contents, one chunk at a time. */
+    UtilChecksumSha256Init(&hashContext);
+    do
+    {
+      bytesRead = fread(buffer, 1, FIRMWARE_CACHE_CHUNK_SIZE, fp);
+      UtilChecksumSha256Update(&hashContext, buffer, (uint32_t)bytesRead);
+      size += bytesRead;
+    }
+    while (bytesRead == FIRMWARE_CACHE_CHUNK_SIZE);
+    UtilChecksumSha256Final(&hashContext, key->hash);
+    /* Only use the key if the entire file was read. */
+    if ( (ferror(fp) == 0) && (size > 0) && (size <= UINT32_MAX) )
+    {
+      key->size = (uint32_t)size;
+      result = true;
+    }
+  }
+  if (fp != NULL)
+  {
+    (void)fclose(fp);
+  }
+  free(buffer);
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of FirmwareCacheGetKey ***/
+
+
+/************************************************************************************//**
+** \brief     Builds the filename of the cache file of a key, including the directory.
+**            The name holds the first 64 bits of the hash, which is plenty to tell the
+**            cache files apart. The full hash is checked with the one in the header.
+** \param     key The key.
+** \param     suffix Text to append to the filename, such as the extension.
+** \return    The filename if successful, NULL otherwise. Release it with free().
+**
+****************************************************************************************/
+static char * FirmwareCacheGetFilename(tFirmwareCacheKey const * key,
+                                       char const * suffix)
+{
+  char * result;
+  size_t len;
+
+  /* Check parameters. */
+  assert(key != NULL);
+  assert(suffix != NULL);
+  assert(cacheDirectory != NULL);
+
+  len = strlen(cacheDirectory) + FIRMWARE_CACHE_NAME_LEN_MAX + strlen(suffix);
+  result = malloc(len);
+  if (result != NULL)
+  {
+    (void)snprintf(result, len, "%s/%02x%02x%02x%02x%02x%02x%02x%02x%08lx-%08lx-%lu%s",
+                   cacheDirectory, key->hash[0], key->hash[1], key->hash[2],
+                   key->hash[3], key->hash[4], key->hash[5], key->hash[6], key->hash[7],
+                   (unsigned long)key->size, (unsigned long)key->addressOffset,
+                   (unsigned long)key->parserId, suffix);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of FirmwareCacheGetFilename ***/
+
+
+/************************************************************************************//**
+** \brief     Adds the firmware data of the cache file of a key to the firmware data
+**            module. The cache file is only used if it is complete and undamaged.
+**            Afterwards the cache file is marked as recently used.
+** \param     key The key.
+** \return    True if successful, false if the cache file does not exist or cannot be
+**            used. Note that in the latter case, part of its firmware data could
+**            already be added.
+**
+****************************************************************************************/
+static bool FirmwareCacheRead(tFirmwareCacheKey const * key)
+{
+  bool result = false;
+  char * filename;
+  uint8_t const * contents = NULL;
+  uint32_t contentsLen = 0;
+  tFirmwareCacheHeader header;
+  tFirmwareCacheSegment segment;
+  uint32_t tableLen;
+  uint32_t dataLen;
+  uint32_t segmentIdx;
+  uint32_t offset;
+
+  /* Check parameters. */
+  assert(key != NULL);
+
+  filename = FirmwareCacheGetFilename(key, FIRMWARE_CACHE_EXTENSION);
+  if (filename != NULL)
+  {
+    contents = UtilFileMap(filename, &contentsLen);
+  }
+  if ( (contents != NULL) && (contentsLen > sizeof(tFirmwareCacheHeader)) )
+  {
+    /* Check the header. */
+    memcpy(&header, contents, sizeof(tFirmwareCacheHeader));
+    tableLen = contentsLen - (uint32_t)sizeof(tFirmwareCacheHeader);
+    if ( (header.magic == FIRMWARE_CACHE_MAGIC) &&
+         (header.version == FIRMWARE_CACHE_VERSION) &&
+         (memcmp(&header.key, key, sizeof(tFirmwareCacheKey)) == 0) &&
+         (header.segmentCount > 0) &&
+         (header.segmentCount <= (tableLen / sizeof(tFirmwareCacheSegment))) &&
+         (header.dataSize == (tableLen - (header.segmentCount *
+                                          (uint32_t)sizeof(tFirmwareCacheSegment)))) &&
+         (header.checksum == UtilChecksumCrc32Calculate(
+                               &contents[sizeof(tFirmwareCacheHeader)], tableLen)) )
+    {
+      /* Check that the segments add up to the data. */
+      dataLen = 0;
+      result = true;
+      for (segmentIdx = 0; segmentIdx < header.segmentCount; segmentIdx++)
+      {
+        memcpy(&segment, &contents[sizeof(tFirmwareCacheHeader) +
+                                   (segmentIdx * sizeof(tFirmwareCacheSegment))],
+               sizeof(tFirmwareCacheSegment));
+        if ( (segment.length == 0) || (segment.length > (header.dataSize - dataLen)) )
+        {
+          result = false;
+          break;
+        }
+        dataLen += segment.length;
+      }
+      if (dataLen != header.dataSize)
+      {
+        result = false;
+      }
+      /* Add the firmware data directly from the mapped cache file. */
+      offset = (uint32_t)sizeof(tFirmwareCacheHeader) +
+               (header.segmentCount * (uint32_t)sizeof(tFirmwareCacheSegment));
+      for (segmentIdx = 0; (result) && (segmentIdx < header.segmentCount); segmentIdx++)
+      {
+        memcpy(&segment, &contents[sizeof(tFirmwareCacheHeader) +
+                                   (segmentIdx * sizeof(tFirmwareCacheSegment))],
+               sizeof(tFirmwareCacheSegment));
+        result = FirmwareAddData(segment.base, segment.length, &contents[offset]);
+        offset += segment.length;
+      }
+    }
+  }
+  if (contents != NULL)
+  {
+    UtilFileUnmap(contents, contentsLen);
+  }
+  /* Mark the cache file as recently used, such that it is removed last. */
+  if (result)
+  {
+    (void)UtilFileTouch(filename);
+  }
+  free(filename);
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of FirmwareCacheRead ***/
+
+
+/************************************************************************************//**
+** \brief     Writes the firmware data of the firmware data module to the cache file of
+**            a key. The cache file is first written under a temporary name and then
+**            renamed. This way other processes never see an incomplete cache file.
+**            Afterwards the least recently used cache files are removed, if the cache
+**            became too large.
+** \param     key The key.
+**
+****************************************************************************************/
+static void FirmwareCacheWrite(tFirmwareCacheKey const * key)
+{
+  bool written = false;
+  char * filename;
+  char * tmpFilename;
+  char tmpSuffix[32];
+  FILE * fp = NULL;
+  tFirmwareCacheHeader header;
+  tFirmwareCacheSegment segment;
+  tFirmwareSegment const * firmwareSegment;
+  uint64_t dataSize = 0;
+
+  /* Check parameters. */
+  assert(key != NULL);
+
+  /* Prepare the header. */
+  memset(&header, 0, sizeof(tFirmwareCacheHeader));
+  header.magic = FIRMWARE_CACHE_MAGIC;
+  header.version = FIRMWARE_CACHE_VERSION;
+  header.key = *key;
+  header.segmentCount = FirmwareGetSegmentCount();
+  firmwareSegment = (header.segmentCount > 0) ? FirmwareGetSegment(0) : NULL;
+  for (; firmwareSegment != NULL; firmwareSegment = firmwareSegment->next)
+  {
+    segment.base = firmwareSegment->base;
+    segment.length = firmwareSegment->length;
+    header.checksum = UtilChecksumCrc32Update(header.checksum, (uint8_t *)&segment,
+                                              sizeof(tFirmwareCacheSegment));
+    dataSize += firmwareSegment->length;
+  }
+  for (firmwareSegment = (header.segmentCount > 0) ? FirmwareGetSegment(0) : NULL;
+       firmwareSegment != NULL; firmwareSegment = firmwareSegment->next)
+  {
+    header.checksum = UtilChecksumCrc32Update(header.checksum, firmwareSegment->data,
+                                              firmwareSegment->length);
+  }
+  header.dataSize = (uint32_t)dataSize;
+
+  /* Write the cache file under a temporary name, which is unique for this process. */
+  (void)snprintf(tmpSuffix, sizeof(tmpSuffix), FIRMWARE_CACHE_EXTENSION ".%llx"
+                 FIRMWARE_CACHE_TMP_EXTENSION,
+                 (unsigned long long)UtilTimeGetMonotonicNs());
+  filename = FirmwareCacheGetFilename(key, FIRMWARE_CACHE_EXTENSION);
+  tmpFilename = FirmwareCacheGetFilename(key, tmpSuffix);
+  /* Skip firmware data that does not fit in the cache at all. */
+  if ( (filename != NULL) && (tmpFilename != NULL) && (header.segmentCount > 0) &&
+       (dataSize <= UINT32_MAX) &&
+       ((cacheMaxSize == 0) || ((dataSize / 1024u) < cacheMaxSize)) )
+  {
+    fp = fopen(tmpFilename, "wb");
+  }
+  if (fp != NULL)
+  {
+    written = (fwrite(&header, sizeof(tFirmwareCacheHeader), 1, fp) == 1);
+    for (firmwareSegment = FirmwareGetSegment(0);
+         (written) && (firmwareSegment != NULL); firmwareSegment = firmwareSegment->next)
+    {
+      segment.base = firmwareSegment->base;
+      segment.length = firmwareSegment->length;
+      written = (fwrite(&segment, sizeof(tFirmwareCacheSegment), 1, fp) == 1);
+    }
+    for (firmwareSegment = FirmwareGetSegment(0);
+         (written) && (firmwareSegment != NULL); firmwareSegment = firmwareSegment->next)
+    {
+      written = (fwrite(firmwareSegment->data, 1, firmwareSegment->length, fp) ==
+                 firmwareSegment->length);
+    }
+    if (fclose(fp) != 0)
+    {
+      written = false;
+    }
+    /* Give the cache file its final name. If another process just did the same, its
+     * cache file is equally good, so a failure is not a problem.
+     */
+    if ( (!written) || (rename(tmpFilename, filename) != 0) )
+    {
+      (void)remove(tmpFilename);
+    }
+    /* Make room for the new cache file. */
+    FirmwareCacheEvict();
+  }
+  free(tmpFilename);
+  free(filename);
+} /*** end of FirmwareCacheWrite ***/
+
+
+/************************************************************************************//**
+** \brief     Removes the least recently used cache files, until the cache files no
+**            longer take more space than allowed. Temporary files count as well, so
+**            ones that a crashed process left behind are eventually removed.
+**
+****************************************************************************************/
+static void FirmwareCacheEvict(void)
+{
+  tFirmwareCacheScan scan;
+  uint32_t fileIdx;
+  char * filename;
+  size_t len;
+
+  /* Only continue if the size of the cache is limited. */
+  if ( (cacheDirectory != NULL) && (cacheMaxSize > 0) )
+  {
+    memset(&scan, 0, sizeof(tFirmwareCacheScan));
+    if ( (UtilFileScanDirectory(cacheDirectory, FirmwareCacheScanFile, &scan)) &&
+         (!scan.incomplete) && (scan.totalSize > ((uint64_t)cacheMaxSize * 1024u)) )
+    {
+      /* Remove the files, oldest first. */
+      qsort(scan.files, scan.count, sizeof(tFirmwareCacheFile),
+            FirmwareCacheCompareFiles);
+      len = strlen(cacheDirectory) + FIRMWARE_CACHE_NAME_LEN_MAX + 2u;
+      filename = malloc(len);
+      for (fileIdx = 0; (filename != NULL) && (fileIdx < scan.count) &&
+                        (scan.totalSize > ((uint64_t)cacheMaxSize * 1024u)); fileIdx++)
+      {
+        (void)snprintf(filename, len, "%s/%s", cacheDirectory, scan.files[fileIdx].name);
+        if (remove(filename) == 0)
+        {
+          scan.totalSize -= scan.files[fileIdx].size;
+        }
+      }
+      free(filename);
+    }
+    free(scan.files);
+  }
+} /*** end of FirmwareCacheEvict ***/
+
+
+/************************************************************************************//**
+** \brief     Adds a file of the cache directory to the result of the scan, if it is a
+**            cache file or a temporary cache file.
+** \param     name Name of the file, without the directory.
+** \param     size Number of bytes in the file.
+** \param     modified Time of the last modification in microseconds.
+** \param     arg The result of the scan.
+**
+****************************************************************************************/
+static void FirmwareCacheScanFile(char const * name, uint64_t size, uint64_t modified,
+                                  void * arg)
+{
+  tFirmwareCacheScan * scan = arg;
+  tFirmwareCacheFile * files;
+  size_t nameLen;
+  size_t extLen = strlen(FIRMWARE_CACHE_EXTENSION);
+  size_t tmpExtLen = strlen(FIRMWARE_CACHE_TMP_EXTENSION);
+
+  /* Check parameters. */
+  assert(name != NULL);
+  assert(scan != NULL);
+
+  /* Only consider the files of the cache. */
+  nameLen = strlen(name);
+  if ( (nameLen < FIRMWARE_CACHE_NAME_LEN_MAX) &&
+       (((nameLen > extLen) &&
+         (strcmp(&name[nameLen - extLen], FIRMWARE_CACHE_EXTENSION) == 0)) ||
+        ((nameLen > tmpExtLen) &&
+         (strcmp(&name[nameLen - tmpExtLen], FIRMWARE_CACHE_TMP_EXTENSION) == 0))) )
+  {
+    /* Enlarge the array if needed. */
+    if (scan->count == scan->capacity)
+    {
+      files = realloc(scan->files, ((size_t)scan->capacity + 64u) *
+                                   sizeof(tFirmwareCacheFile));
+      if (files != NULL)
+      {
+        scan->files = files;
+        scan->capacity += 64u;
+      }
+      else
+      {
+        scan->incomplete = true;
+      }
+    }
+    /* Add the file. */
+    if (scan->count < scan->capacity)
+    {
+      strcpy(scan->files[scan->count].name, name);
+      scan->files[scan->count].size = size;
+      scan->files[scan->count].modified = modified;
+      scan->count++;
+      scan->totalSize += size;
+    }
+  }
+} /*** end of FirmwareCacheScanFile ***/
+
+
+/************************************************************************************//**
+** \brief     Compares two files of the cache directory by the time of their last
+**            modification, for sorting them with qsort.
+** \param     file1 The first file.
+** \param     file2 The second file.
+** \return    Negative if the first file is older, positive if it is newer and zero if
+**            both have the same age.
+**
+****************************************************************************************/
+static int FirmwareCacheCompareFiles(void const * file1, void const * file2)
+{
+  uint64_t modified1 = ((tFirmwareCacheFile const *)file1)->modified;
+  uint64_t modified2 = ((tFirmwareCacheFile const *)file2)->modified;
+
+  return (modified1 < modified2) ? -1 : ((modified1 > modified2) ? 1 : 0);
+} /*** end of FirmwareCacheCompareFiles ***/
+
+
+/******************************** end of firmwarecache.c *******************************/
@@ -39,15 +39,41 @@
 extern "C" {
 #endif
 
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Maximum number of buffers that can be sent with one call. */
+#define NETACCESS_BUFFERS_MAX          (4u)
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Layout of a buffer with a part of the data to send. */
+typedef struct t_net_access_buffer
+{
+  uint8_t const * data;          /**< Pointer to the data.                             */
+  uint32_t length;               /**< Number of bytes in the data.                     */
+} tNetAccessBuffer;
+
+/** \brief Handle of a network access object. Each object manages its own connection,
+ *         so multiple connections can be used at the same time.
+ */
+typedef void * tNetAccessHandle;
+
+
 /****************************************************************************************
 * Function prototypes
 ****************************************************************************************/
-void NetAccessInit(void);
-void NetAccessTerminate(void);
-bool NetAccessConnect(char const * address, uint16_t port);
-void NetAccessDisconnect(void);
-bool NetAccessSend(uint8_t const * data, uint32_t length);
-bool NetAccessReceive(uint8_t * data, uint32_t * length, uint32_t timeout);
+tNetAccessHandle NetAccessInit(void);
+void NetAccessTerminate(tNetAccessHandle handle);
+bool NetAccessConnect(tNetAccessHandle handle, char const * address, uint16_t port);
+void NetAccessDisconnect(tNetAccessHandle handle);
+bool NetAccessSend(tNetAccessHandle handle, uint8_t const * data, uint32_t length);
+bool NetAccessSendVector(tNetAccessHandle handle, tNetAccessBuffer const * buffers,
+                         uint32_t count);
+bool NetAccessReceive(tNetAccessHandle handle, uint8_t * data, uint32_t * length,
+                      uint32_t timeout);
 
 #ifdef __cplusplus
 }
@@ -34,16 +34,21 @@
 #include <assert.h>                         /* for assertions                          */
 #include <stddef.h>                         /* for NULL declaration                    */
 #include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
 #include "openblt.h"                        /* OpenBLT host library                    */
 #include "util.h"                           /* Utility module                          */
 #include "firmware.h"                       /* Firmware data module                    */
+#include "firmwarecache.h"                  /* Firmware cache module                   */
 #include "srecparser.h"                     /* S-record parser                         */
 #include "session.h"                        /* Communication session module            */
+#include "sessionasync.h"                   /* Asynchronous session operations module  */
 #include "xcploader.h"                      /* XCP loader module                       */
 #include "xcptpuart.h"                      /* XCP UART transport layer                */
 #include "xcptpcan.h"                       /* XCP CAN transport layer                 */
 #include "xcptpusb.h"                       /* XCP USB transport layer                 */
 #include "xcptpnet.h"                       /* XCP TCP/IP transport layer              */
+#include "xcptpudp.h"                       /* XCP UDP/IP transport layer              */
+#include "xcptpemu.h"                       /* XCP network emulation transport layer   */
 
 
 /****************************************************************************************
@@ -59,6 +64,37 @@
 #define BLT_VERSION_STRING   "1.03.08"
 
 
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Layout of the request that is linked to an asynchronous session operation.
+ *         It holds the callback of the application, for dispatching the events.
+ */
+typedef struct t_blt_session_async_request
+{
+  tBltSessionCallback callback;  /**< Callback function of the application.            */
+  void * context;                /**< Context of the application for the callback.     */
+} tBltSessionAsyncRequest;
+
+/** \brief Layout of a firmware update session object. */
+typedef struct t_blt_session_obj
+{
+  tSessionHandle session;        /**< Handle of the communication session.             */
+  tSessionAsyncHandle async;     /**< Handle of the asynchronous session operations.   */
+  struct t_blt_session_obj * next; /**< Next session in the list of sessions.          */
+} tBltSessionObj;
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+static uint32_t BltSessionSubmitAsync(tBltSessionHandle session,
+                                      tSessionAsyncOperation * operation,
+                                      tBltSessionCallback callback, void * context);
+static void BltSessionDispatchEvents(tBltSessionObj * bltSession);
+static uint32_t BltSessionGetPendingCount(void);
+
+
 /****************************************************************************************
 * Local constant declarations
 ****************************************************************************************/
@@ -66,6 +102,32 @@
 char const bltVersionString[] = BLT_VERSION_STRING;
 
 
+/****************************************************************************************
+* Local data declarations
+****************************************************************************************/
+/** \brief Session that BltSessionInit created. The session functions without a session
+ *         handle parameter operate on it.
+ */
+static tBltSessionHandle bltDefaultSession;
+
+/** \brief List with all sessions that exist. Sessions are created, destroyed and have
+ *         their events processed from the thread of the application, so the list does
+ *         not need to be protected.
+ */
+static tBltSessionObj * bltSessionList;
+
+/** \brief Event that is set while events of asynchronous session operations are
+ *         pending. It is shared by all sessions and only exists while sessions exist.
+ */
+static tUtilEvent bltSessionNotifyEvent;
+
+/** \brief Firmware file parser that BltFirmwareInit linked. It is part of the key of the
+ *         firmware cache, because another parser makes other firmware data out of the
+ *         same file.
+ */
+static uint32_t bltFirmwareParserType;
+
+
 /****************************************************************************************
 *             V E R S I O N   I N F O R M A T I O N
 ****************************************************************************************/
@@ -98,9 +160,9 @@ LIBOPENBLT_EXPORT char const * BltVersionGetString(void)
 *             S E S S I O N   /   T R A N S P O R T   L A Y E R S
 ****************************************************************************************/
 /************************************************************************************//**
-** \brief     Initializes the firmware update session for a specific communication
-**            protocol and transport layer. This function is typically called once at
-**            the start of the firmware update.
+** \brief     Creates a firmware update session for a specific communication protocol
+**            and transport layer. Each session has its own connection with a target,
+**            so that multiple targets can be updated at the same time.
 ** \param     sessionType The communication protocol to use for this session. It should
 **            be a BLT_SESSION_xxx value.
 ** \param     sessionSettings Pointer to a structure with communication protocol specific
@@ -109,13 +171,18 @@ LIBOPENBLT_EXPORT char const * BltVersionGetString(void)
 **            protocol. It should be a BLT_TRANSPORT_xxx value.
 ** \param     transportSettings Pointer to a structure with transport layer specific
 **            settings.
+** \return    Handle of the session object if successful, NULL otherwise.
 **
 ****************************************************************************************/
-LIBOPENBLT_EXPORT void BltSessionInit(uint32_t sessionType, 
-                                      void const * sessionSettings,
-                                      uint32_t transportType, 
-                                      void const * transportSettings)
+LIBOPENBLT_EXPORT tBltSessionHandle BltSessionCreate(uint32_t sessionType,
+                                                     void const * sessionSettings,
+                                                     uint32_t transportType,
+                                                     void const * transportSettings)
 {
+  tBltSessionObj * bltSession = NULL;
+  tSessionHandle session = NULL;
+  tBltTransportSettingsXcpV10Emu const * bltTransportSettingsXcpV10EmuPtr = NULL;
+
   /* Check parameters. Note that the settings-pointers are allowed to be NULL in case
    * no additional settings are needed for the specified session or transport type.
    */
@@ -123,7 +190,30 @@ LIBOPENBLT_EXPORT void BltSessionInit(uint32_t sessionType,
   assert( (transportType == BLT_TRANSPORT_XCP_V10_RS232) || \
           (transportType == BLT_TRANSPORT_XCP_V10_CAN) || \
           (transportType == BLT_TRANSPORT_XCP_V10_USB) || \
-          (transportType == BLT_TRANSPORT_XCP_V10_NET) );
+          (transportType == BLT_TRANSPORT_XCP_V10_NET) || \
+          (transportType == BLT_TRANSPORT_XCP_V10_UDP) || \
+          (transportType == BLT_TRANSPORT_XCP_V10_EMU) );
+
+  /* The network emulation wraps another transport layer. Continue with the settings
+   * of the wrapped one and link the network emulation on top of it afterwards.
+   */
+  if (transportType == BLT_TRANSPORT_XCP_V10_EMU)
+  {
+    /* Verify transportSettings parameters because the XCP network emulation transport
+     * layer requires them.
+     */
+    assert(transportSettings != NULL);
+    /* Only continue if the transportSettings parameter is valid. */
+    if (transportSettings != NULL) /*lint !e774 */
+    {
+      bltTransportSettingsXcpV10EmuPtr =
+        (tBltTransportSettingsXcpV10Emu const *)transportSettings;
+      transportType = bltTransportSettingsXcpV10EmuPtr->transportType;
+      transportSettings = bltTransportSettingsXcpV10EmuPtr->transportSettings;
+      /* It cannot wrap itself. */
+      assert(transportType != BLT_TRANSPORT_XCP_V10_EMU);
+    }
+  }
 
   /* Initialize the correct session. */
   if (sessionType == BLT_SESSION_XCP_V10) /*lint !e774 */
@@ -199,6 +289,7 @@ LIBOPENBLT_EXPORT void BltSessionInit(uint32_t sessionType,
           xcpTpCanSettings.transmitId = bltTransportSettingsXcpV10CanPtr->transmitId;
           xcpTpCanSettings.receiveId = bltTransportSettingsXcpV10CanPtr->receiveId;
           xcpTpCanSettings.useExtended = (bltTransportSettingsXcpV10CanPtr->useExtended != 0);
+          xcpTpCanSettings.txFrameGap = bltTransportSettingsXcpV10CanPtr->txFrameGap;
           /* Store transport layer settings in the XCP loader settings. */
           xcpLoaderSettings.transportSettings = &xcpTpCanSettings;
           /* Link the transport layer to the XCP loader settings. */
@@ -232,160 +323,1066 @@ LIBOPENBLT_EXPORT void BltSessionInit(uint32_t sessionType,
           static tXcpTpNetSettings xcpTpNetSettings;
           xcpTpNetSettings.address = bltTransportSettingsXcpV10NetPtr->address;
           xcpTpNetSettings.port = bltTransportSettingsXcpV10NetPtr->port;
+          xcpTpNetSettings.window = bltTransportSettingsXcpV10NetPtr->window;
           /* Store transport layer settings in the XCP loader settings. */
           xcpLoaderSettings.transportSettings = &xcpTpNetSettings;
           /* Link the transport layer to the XCP loader settings. */
           xcpLoaderSettings.transport = XcpTpNetGetTransport();
         }
       }
+      else if (transportType == BLT_TRANSPORT_XCP_V10_UDP)
+      {
+        /* Verify transportSettings parameters because the XCP UDP transport layer
+         * requires them.
+         */
+        assert(transportSettings != NULL);
+        /* Only continue if the transportSettings parameter is valid. */
+        if (transportSettings != NULL) /*lint !e774 */
+        {
+          /* Cast transport settings to the correct type. */
+          tBltTransportSettingsXcpV10Udp * bltTransportSettingsXcpV10UdpPtr;
+          bltTransportSettingsXcpV10UdpPtr =
+            (tBltTransportSettingsXcpV10Udp * )transportSettings;
+          /* Convert transport settings to the format supported by the XCP UDP transport
+           * layer. It was made static to make sure it doesn't get out of scope when
+           * used in xcpLoaderSettings.
+           */
+          static tXcpTpUdpSettings xcpTpUdpSettings;
+          xcpTpUdpSettings.address = bltTransportSettingsXcpV10UdpPtr->address;
+          xcpTpUdpSettings.port = bltTransportSettingsXcpV10UdpPtr->port;
+          xcpTpUdpSettings.window = bltTransportSettingsXcpV10UdpPtr->window;
+          /* Store transport layer settings in the XCP loader settings. */
+          xcpLoaderSettings.transportSettings = &xcpTpUdpSettings;
+          /* Link the transport layer to the XCP loader settings. */
+          xcpLoaderSettings.transport = XcpTpUdpGetTransport();
+        }
+      }
+      /* Link the network emulation on top of the transport layer, if requested. */
+      if ( (bltTransportSettingsXcpV10EmuPtr != NULL) &&
+           (xcpLoaderSettings.transport != NULL) )
+      {
+        /* Convert transport settings to the format supported by the XCP network
+         * emulation transport layer. It was made static to make sure it doesn't get out
+         * of scope when used in xcpLoaderSettings.
+         */
+        static tXcpTpEmuSettings xcpTpEmuSettings;
+        xcpTpEmuSettings.transport = xcpLoaderSettings.transport;
+        xcpTpEmuSettings.transportSettings = xcpLoaderSettings.transportSettings;
+        xcpTpEmuSettings.delay = bltTransportSettingsXcpV10EmuPtr->delay;
+        xcpTpEmuSettings.jitter = bltTransportSettingsXcpV10EmuPtr->jitter;
+        xcpTpEmuSettings.lossPpm = bltTransportSettingsXcpV10EmuPtr->loss;
+        xcpTpEmuSettings.duplicatePpm = bltTransportSettingsXcpV10EmuPtr->duplicate;
+        xcpTpEmuSettings.reorderPpm = bltTransportSettingsXcpV10EmuPtr->reorder;
+        xcpTpEmuSettings.seed = bltTransportSettingsXcpV10EmuPtr->seed;
+        /* Store transport layer settings in the XCP loader settings. */
+        xcpLoaderSettings.transportSettings = &xcpTpEmuSettings;
+        /* Link the transport layer to the XCP loader settings. */
+        xcpLoaderSettings.transport = XcpTpEmuGetTransport();
+      }
       /* Perform actual session initialization. */
-      SessionInit(XcpLoaderGetProtocol(), &xcpLoaderSettings);
+      session = SessionInit(XcpLoaderGetProtocol(), &xcpLoaderSettings);
+    }
+  }
+  /* Only continue if the session was initialized. */
+  if (session != NULL)
+  {
+    /* Create the notify event of the asynchronous session operations. It is shared by
+     * all sessions.
+     */
+    if (bltSessionNotifyEvent == NULL)
+    {
+      bltSessionNotifyEvent = UtilEventCreate();
+    }
+    /* Create the session object. */
+    bltSession = calloc(1, sizeof(tBltSessionObj));
+    assert(bltSession != NULL);
+    if ( (bltSession != NULL) && (bltSessionNotifyEvent != NULL) ) /*lint !e774 */
+    {
+      bltSession->session = session;
+      /* Prepare for asynchronous session operations. */
+      bltSession->async = SessionAsyncInit(session, bltSessionNotifyEvent);
+    }
+    /* Add the session to the list of sessions, if everything was created. */
+    if ( (bltSession != NULL) && (bltSession->async != NULL) ) /*lint !e774 */
+    {
+      bltSession->next = bltSessionList;
+      bltSessionList = bltSession;
+    }
+    /* Otherwise clean up. */
+    else
+    {
+      free(bltSession);
+      bltSession = NULL;
+      SessionTerminate(session);
+      if ( (bltSessionList == NULL) && (bltSessionNotifyEvent != NULL) )
+      {
+        UtilEventDestroy(bltSessionNotifyEvent);
+        bltSessionNotifyEvent = NULL;
+      }
+    }
+  }
+  /* Give the result back to the caller. */
+  return bltSession;
+} /*** end of BltSessionCreate ***/
+
+
+/************************************************************************************//**
+** \brief     Terminates the firmware update session object and releases it.
+**            Asynchronous operations of the session that are still pending are
+**            cancelled. Their callbacks are called from within this function. Do not
+**            call this function from within a callback.
+** \param     session Handle of the session object.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT void BltSessionDestroy(tBltSessionHandle session)
+{
+  tBltSessionObj * bltSession = (tBltSessionObj *)session;
+  tBltSessionObj * * link;
+
+  /* Check parameters. */
+  assert(bltSession != NULL);
+
+  /* Only continue with valid parameters. */
+  if (bltSession != NULL) /*lint !e774 */
+  {
+    /* Cancel pending asynchronous operations and report their completion. */
+    SessionAsyncCancel(bltSession->async);
+    BltSessionDispatchEvents(bltSession);
+    SessionAsyncTerminate(bltSession->async);
+    /* Terminate the session. */
+    SessionTerminate(bltSession->session);
+    /* Unlink it from the list of sessions. */
+    link = &bltSessionList;
+    while ( (*link != NULL) && (*link != bltSession) )
+    {
+      link = &(*link)->next;
+    }
+    if (*link != NULL)
+    {
+      *link = bltSession->next;
+    }
+    free(bltSession);
+    /* Release the notify event once the last session is gone. */
+    if ( (bltSessionList == NULL) && (bltSessionNotifyEvent != NULL) )
+    {
+      UtilEventDestroy(bltSessionNotifyEvent);
+      bltSessionNotifyEvent = NULL;
+    }
+  }
+} /*** end of BltSessionDestroy ***/
+
+
+/************************************************************************************//**
+** \brief     Starts the firmware update session. This is were the library attempts to
+**            activate and connect with the bootloader running on the target, through
+**            the transport layer that was specified during the session's creation.
+** \param     session Handle of the session object.
+** \return    BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltSessionHandleStart(tBltSessionHandle session)
+{
+  uint32_t result = BLT_RESULT_ERROR_GENERIC;
+  tBltSessionObj * bltSession = (tBltSessionObj *)session;
+
+  /* Check parameters. */
+  assert(bltSession != NULL);
+
+  /* Only continue with valid parameters. */
+  if (bltSession != NULL) /*lint !e774 */
+  {
+    /* Start the session. */
+    if (SessionStart(bltSession->session))
+    {
+      result = BLT_RESULT_OK;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of BltSessionHandleStart ***/
+
+
+/************************************************************************************//**
+** \brief     Stops the firmware update session. This is there the library disconnects
+**            the transport layer as well. Refer to BltSessionStop for details.
+** \param     session Handle of the session object.
+** \return    BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltSessionHandleStop(tBltSessionHandle session)
+{
+  uint32_t result = BLT_RESULT_ERROR_GENERIC;
+  tBltSessionObj * bltSession = (tBltSessionObj *)session;
+
+  /* Check parameters. */
+  assert(bltSession != NULL);
+
+  /* Only continue with valid parameters. */
+  if (bltSession != NULL) /*lint !e774 */
+  {
+    /* Stop the session. */
+    if (SessionStop(bltSession->session))
+    {
+      result = BLT_RESULT_OK;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of BltSessionHandleStop ***/
+
+
+/************************************************************************************//**
+** \brief     Requests the target to erase the specified range of memory on the target.
+**            Refer to BltSessionClearMemory for details.
+** \param     session Handle of the session object.
+** \param     address The starting memory address for the erase operation.
+** \param     len The total number of bytes to erase from memory.
+** \return    BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltSessionHandleClearMemory(tBltSessionHandle session,
+                                                       uint32_t address, uint32_t len)
+{
+  uint32_t result = BLT_RESULT_ERROR_GENERIC;
+  tBltSessionObj * bltSession = (tBltSessionObj *)session;
+
+  /* Check parameters. */
+  assert(bltSession != NULL);
+  assert(len > 0);
+
+  /* Only continue if the parameters are valid. */
+  if ( (bltSession != NULL) && (len > 0) ) /*lint !e774 */
+  {
+    /* Pass the request on to the session module. */
+    if (SessionClearMemory(bltSession->session, address, len))
+    {
+      result = BLT_RESULT_OK;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of BltSessionHandleClearMemory ***/
+
+
+/************************************************************************************//**
+** \brief     Requests the target to program the specified data to memory. Note that it
+**            is the responsibility of the application to make sure the memory range was
+**            erased beforehand.
+** \param     session Handle of the session object.
+** \param     address The starting memory address for the write operation.
+** \param     len The number of bytes in the data buffer that should be written.
+** \param     data Pointer to the byte array with data to write.
+** \return    BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltSessionHandleWriteData(tBltSessionHandle session,
+                                                     uint32_t address, uint32_t len,
+                                                     uint8_t const * data)
+{
+  uint32_t result = BLT_RESULT_ERROR_GENERIC;
+  tBltSessionObj * bltSession = (tBltSessionObj *)session;
+
+  /* Check parameters. */
+  assert(bltSession != NULL);
+  assert(data != NULL);
+  assert(len > 0);
+
+  /* Only continue if the parameters are valid. */
+  if ( (bltSession != NULL) && (data != NULL) && (len > 0) ) /*lint !e774 */
+  {
+    /* Pass the request on to the session module. */
+    if (SessionWriteData(bltSession->session, address, len, data))
+    {
+      result = BLT_RESULT_OK;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of BltSessionHandleWriteData ***/
+
+
+/************************************************************************************//**
+** \brief     Requests the target to upload the specified range from memory and store its
+**            contents in the specified data buffer.
+** \param     session Handle of the session object.
+** \param     address The starting memory address for the read operation.
+** \param     len The number of bytes to upload from the target and store in the data
+**            buffer.
+** \param     data Pointer to the byte array where the uploaded data should be stored.
+** \return    BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltSessionHandleReadData(tBltSessionHandle session,
+                                                    uint32_t address, uint32_t len,
+                                                    uint8_t * data)
+{
+  uint32_t result = BLT_RESULT_ERROR_GENERIC;
+  tBltSessionObj * bltSession = (tBltSessionObj *)session;
+
+  /* Check parameters. */
+  assert(bltSession != NULL);
+  assert(data != NULL);
+  assert(len > 0);
+
+  /* Only continue if the parameters are valid. */
+  if ( (bltSession != NULL) && (data != NULL) && (len > 0) ) /*lint !e774 */
+  {
+    /* Pass the request on to the session module. */
+    if (SessionReadData(bltSession->session, address, len, data))
+    {
+      result = BLT_RESULT_OK;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of BltSessionHandleReadData ***/
+
+
+/************************************************************************************//**
+** \brief     Obtains the command/response latency statistics of the firmware update
+**            session. They cover all successful exchanges with the target since the
+**            session was started and remain available after the session was stopped.
+** \param     session Handle of the session object.
+** \param     latency Pointer to the structure where the statistics are stored.
+** \return    BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltSessionHandleGetLatency(tBltSessionHandle session,
+                                                      tBltSessionLatency * latency)
+{
+  uint32_t result = BLT_RESULT_ERROR_GENERIC;
+  tBltSessionObj * bltSession = (tBltSessionObj *)session;
+  tSessionLatency sessionLatency;
+
+  /* Check parameters. */
+  assert(bltSession != NULL);
+  assert(latency != NULL);
+
+  /* Only continue if the parameters are valid. */
+  if ( (bltSession != NULL) && (latency != NULL) ) /*lint !e774 */
+  {
+    /* Obtain the statistics from the session module. */
+    if (SessionGetLatency(bltSession->session, &sessionLatency))
+    {
+      /* Convert them to averages. */
+      latency->count = sessionLatency.count;
+      latency->totalAvg = 0;
+      latency->wireAvg = 0;
+      if (sessionLatency.count > 0)
+      {
+        latency->totalAvg = (uint32_t)(sessionLatency.totalTime / sessionLatency.count);
+        latency->wireAvg = (uint32_t)(sessionLatency.wireTime / sessionLatency.count);
+      }
+      latency->hostAvg = latency->totalAvg - latency->wireAvg;
+      latency->totalMax = sessionLatency.totalMax;
+      latency->totalP99 = SessionLatencyGetPercentile(&sessionLatency, 99);
+      result = BLT_RESULT_OK;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of BltSessionHandleGetLatency ***/
+
+
+/************************************************************************************//**
+** \brief     Configures if the transport layer stays connected when the firmware update
+**            session is stopped. The next start of the session then skips connecting
+**            the transport layer, for example opening the serial port or the CAN
+**            device. This speeds up updating multiple targets one after the other,
+**            which are reached through the same transport layer settings. Only use it
+**            for transport layers whose connection does not end when the target
+**            resets, such as RS232 and CAN. By default the transport layer is
+**            disconnected.
+** \param     session Handle of the session object.
+** \param     keep 1 to keep the transport layer connected, 0 to disconnect it when
+**            the session is stopped.
+** \return    BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltSessionHandleKeepTransport(tBltSessionHandle session,
+                                                         uint32_t keep)
+{
+  uint32_t result = BLT_RESULT_ERROR_GENERIC;
+  tBltSessionObj * bltSession = (tBltSessionObj *)session;
+
+  /* Check parameters. */
+  assert(bltSession != NULL);
+
+  /* Only continue if the parameters are valid. */
+  if (bltSession != NULL) /*lint !e774 */
+  {
+    /* Pass the request on to the session module. */
+    if (SessionKeepTransport(bltSession->session, (bool)(keep != 0)))
+    {
+      result = BLT_RESULT_OK;
     }
   }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of BltSessionHandleKeepTransport ***/
+
+
+/************************************************************************************//**
+** \brief     Submits an operation to start the firmware update session, without
+**            waiting for it to complete. Refer to BltSessionHandleStart for details.
+** \param     session Handle of the session object.
+** \param     callback Function that is called for the events of the operation. Can be
+**            NULL.
+** \param     context Context of the application. It is passed on to the callback.
+** \return    BLT_RESULT_OK if the operation was submitted, BLT_RESULT_ERROR_xxx
+**            otherwise.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltSessionHandleStartAsync(tBltSessionHandle session,
+                                                      tBltSessionCallback callback,
+                                                      void * context)
+{
+  tSessionAsyncOperation operation = { 0 };
+
+  /* Submit the operation. */
+  operation.type = SESSION_ASYNC_OP_START;
+  return BltSessionSubmitAsync(session, &operation, callback, context);
+} /*** end of BltSessionHandleStartAsync ***/
+
+
+/************************************************************************************//**
+** \brief     Submits an operation to stop the firmware update session, without waiting
+**            for it to complete. Refer to BltSessionHandleStop for details.
+** \param     session Handle of the session object.
+** \param     callback Function that is called for the events of the operation. Can be
+**            NULL.
+** \param     context Context of the application. It is passed on to the callback.
+** \return    BLT_RESULT_OK if the operation was submitted, BLT_RESULT_ERROR_xxx
+**            otherwise.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltSessionHandleStopAsync(tBltSessionHandle session,
+                                                     tBltSessionCallback callback,
+                                                     void * context)
+{
+  tSessionAsyncOperation operation = { 0 };
+
+  /* Submit the operation. */
+  operation.type = SESSION_ASYNC_OP_STOP;
+  return BltSessionSubmitAsync(session, &operation, callback, context);
+} /*** end of BltSessionHandleStopAsync ***/
+
+
+/************************************************************************************//**
+** \brief     Submits an operation to erase the specified range of memory on the target,
+**            without waiting for it to complete. Refer to BltSessionClearMemory for
+**            details.
+** \param     session Handle of the session object.
+** \param     address The starting memory address for the erase operation.
+** \param     len The total number of bytes to erase from memory.
+** \param     callback Function that is called for the events of the operation. Can be
+**            NULL.
+** \param     context Context of the application. It is passed on to the callback.
+** \return    BLT_RESULT_OK if the operation was submitted, BLT_RESULT_ERROR_xxx
+**            otherwise.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltSessionHandleClearMemoryAsync(tBltSessionHandle session,
+                                                            uint32_t address,
+                                                            uint32_t len,
+                                                            tBltSessionCallback callback,
+                                                            void * context)
+{
+  uint32_t result = BLT_RESULT_ERROR_GENERIC;
+  tSessionAsyncOperation operation = { 0 };
+
+  /* Check parameters. */
+  assert(len > 0);
+
+  /* Only continue if the parameters are valid. */
+  if (len > 0)
+  {
+    /* Submit the operation. */
+    operation.type = SESSION_ASYNC_OP_CLEAR_MEMORY;
+    operation.address = address;
+    operation.len = len;
+    result = BltSessionSubmitAsync(session, &operation, callback, context);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of BltSessionHandleClearMemoryAsync ***/
+
+
+/************************************************************************************//**
+** \brief     Submits an operation to program the specified data to memory, without
+**            waiting for it to complete. Progress events are reported while the data
+**            is programmed. Refer to BltSessionHandleWriteData for details.
+** \param     session Handle of the session object.
+** \param     address The starting memory address for the write operation.
+** \param     len The number of bytes in the data buffer that should be written.
+** \param     data Pointer to the byte array with data to write. It must stay valid until
+**            the operation completed.
+** \param     callback Function that is called for the events of the operation. Can be
+**            NULL.
+** \param     context Context of the application. It is passed on to the callback.
+** \return    BLT_RESULT_OK if the operation was submitted, BLT_RESULT_ERROR_xxx
+**            otherwise.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltSessionHandleWriteDataAsync(tBltSessionHandle session,
+                                                          uint32_t address, uint32_t len,
+                                                          uint8_t const * data,
+                                                          tBltSessionCallback callback,
+                                                          void * context)
+{
+  uint32_t result = BLT_RESULT_ERROR_GENERIC;
+  tSessionAsyncOperation operation = { 0 };
+
+  /* Check parameters. */
+  assert(data != NULL);
+  assert(len > 0);
+
+  /* Only continue if the parameters are valid. */
+  if ( (data != NULL) && (len > 0) ) /*lint !e774 */
+  {
+    /* Submit the operation. */
+    operation.type = SESSION_ASYNC_OP_WRITE_DATA;
+    operation.address = address;
+    operation.len = len;
+    operation.writeData = data;
+    result = BltSessionSubmitAsync(session, &operation, callback, context);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of BltSessionHandleWriteDataAsync ***/
+
+
+/************************************************************************************//**
+** \brief     Submits an operation to upload the specified range from memory and store
+**            its contents in the specified data buffer, without waiting for it to
+**            complete. Progress events are reported while the data is uploaded. Refer
+**            to BltSessionHandleReadData for details.
+** \param     session Handle of the session object.
+** \param     address The starting memory address for the read operation.
+** \param     len The number of bytes to upload from the target and store in the data
+**            buffer.
+** \param     data Pointer to the byte array where the uploaded data should be stored.
+**            It must stay valid until the operation completed.
+** \param     callback Function that is called for the events of the operation. Can be
+**            NULL.
+** \param     context Context of the application. It is passed on to the callback.
+** \return    BLT_RESULT_OK if the operation was submitted, BLT_RESULT_ERROR_xxx
+**            otherwise.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltSessionHandleReadDataAsync(tBltSessionHandle session,
+                                                         uint32_t address, uint32_t len,
+                                                         uint8_t * data,
+                                                         tBltSessionCallback callback,
+                                                         void * context)
+{
+  uint32_t result = BLT_RESULT_ERROR_GENERIC;
+  tSessionAsyncOperation operation = { 0 };
+
+  /* Check parameters. */
+  assert(data != NULL);
+  assert(len > 0);
+
+  /* Only continue if the parameters are valid. */
+  if ( (data != NULL) && (len > 0) ) /*lint !e774 */
+  {
+    /* Submit the operation. */
+    operation.type = SESSION_ASYNC_OP_READ_DATA;
+    operation.address = address;
+    operation.len = len;
+    operation.readData = data;
+    result = BltSessionSubmitAsync(session, &operation, callback, context);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of BltSessionHandleReadDataAsync ***/
+
+
+/************************************************************************************//**
+** \brief     Cancels all pending asynchronous operations of the session. A running
+**            write or read operation is aborted in between two chunks of data.
+**            Cancelled operations complete with an error, which is reported to their
+**            callbacks with the next call of BltSessionProcessEvents.
+** \param     session Handle of the session object.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT void BltSessionHandleCancelAsync(tBltSessionHandle session)
+{
+  tBltSessionObj * bltSession = (tBltSessionObj *)session;
+
+  /* Check parameters. */
+  assert(bltSession != NULL);
+
+  /* Only continue with valid parameters. */
+  if (bltSession != NULL) /*lint !e774 */
+  {
+    /* Pass the request on to the asynchronous session operations module. */
+    SessionAsyncCancel(bltSession->async);
+  }
+} /*** end of BltSessionHandleCancelAsync ***/
+
+
+/************************************************************************************//**
+** \brief     Dispatches the pending events of asynchronous session operations to their
+**            callbacks. This covers the operations of all sessions. If no events are
+**            pending yet, it first waits for them, up to the specified timeout. An
+**            application typically calls this function after the event handle of
+**            BltSessionGetEventHandle got signaled, or periodically with a timeout.
+** \param     timeout Maximum time in milliseconds to wait for events. 0 to only
+**            dispatch the events that are already pending.
+** \return    Number of asynchronous operations that did not yet complete. 0 once all
+**            submitted operations completed.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltSessionProcessEvents(uint32_t timeout)
+{
+  uint32_t result = 0;
+  tBltSessionObj * bltSession;
+
+  /* Only continue if a session exists. */
+  if (bltSessionNotifyEvent != NULL)
+  {
+    /* Wait for events, but only if there are operations that can still produce
+     * them.
+     */
+    if ( (timeout > 0) && (BltSessionGetPendingCount() > 0) )
+    {
+      (void)UtilEventWait(bltSessionNotifyEvent, timeout);
+    }
+    /* Reset the notification before retrieving the events. An event that gets added
+     * in the meantime sets it again, so it is never missed.
+     */
+    UtilEventReset(bltSessionNotifyEvent);
+    /* Dispatch the pending events of all sessions. */
+    for (bltSession = bltSessionList; bltSession != NULL; bltSession = bltSession->next)
+    {
+      BltSessionDispatchEvents(bltSession);
+    }
+    result = BltSessionGetPendingCount();
+  }
+  /* Give the number of operations that did not yet complete back to the caller. */
+  return result;
+} /*** end of BltSessionProcessEvents ***/
+
+
+/************************************************************************************//**
+** \brief     Obtains the operating system handle that is signaled while events of
+**            asynchronous session operations are pending. It is shared by all sessions.
+**            On Linux this is a file descriptor that becomes readable, which can be used
+**            with poll() or select(). On Windows this is an event object handle, which
+**            can be used with WaitForMultipleObjects(). Do not read from or reset the
+**            handle. This is done by BltSessionProcessEvents. The handle stays the same
+**            as long as at least one session exists.
+** \return    The operating system handle. -1 if no session exists.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT intptr_t BltSessionGetEventHandle(void)
+{
+  intptr_t result = -1;
+
+  /* Only continue if a session exists. */
+  if (bltSessionNotifyEvent != NULL)
+  {
+    result = UtilEventGetHandle(bltSessionNotifyEvent);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of BltSessionGetEventHandle ***/
+
+
+/************************************************************************************//**
+** \brief     Initializes the firmware update session for a specific communication
+**            protocol and transport layer. This function is typically called once at
+**            the start of the firmware update. It creates the session that the
+**            functions without a session handle parameter operate on. Refer to
+**            BltSessionCreate for details.
+** \param     sessionType The communication protocol to use for this session. It should
+**            be a BLT_SESSION_xxx value.
+** \param     sessionSettings Pointer to a structure with communication protocol specific
+**            settings.
+** \param     transportType The transport layer to use for the specified communication
+**            protocol. It should be a BLT_TRANSPORT_xxx value.
+** \param     transportSettings Pointer to a structure with transport layer specific
+**            settings.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT void BltSessionInit(uint32_t sessionType, 
+                                      void const * sessionSettings,
+                                      uint32_t transportType, 
+                                      void const * transportSettings)
+{
+  /* Make sure a previously initialized session is terminated. */
+  BltSessionTerminate();
+  /* Create the session. */
+  bltDefaultSession = BltSessionCreate(sessionType, sessionSettings, transportType,
+                                       transportSettings);
 } /*** end of BltSessionInit ***/
 
 
 /************************************************************************************//**
-** \brief     Terminates the firmware update session. This function is typically called
-**            once at the end of the firmware update.
+** \brief     Terminates the firmware update session. This function is typically called
+**            once at the end of the firmware update. Asynchronous operations that are
+**            still pending are cancelled. Their callbacks are called from within this
+**            function.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT void BltSessionTerminate(void)
+{
+  /* Only continue if the session was initialized. */
+  if (bltDefaultSession != NULL)
+  {
+    BltSessionDestroy(bltDefaultSession);
+    bltDefaultSession = NULL;
+  }
+} /*** end of BltSessionTerminate ***/
+
+
+/************************************************************************************//**
+** \brief     Starts the firmware update session. This is were the library attempts to
+**            activate and connect with the bootloader running on the target, through
+**            the transport layer that was specified during the session's initialization.
+** \return    BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltSessionStart(void)
+{
+  /* Pass the request on to the initialized session. */
+  return BltSessionHandleStart(bltDefaultSession);
+} /*** end of BltSessionStart ***/
+
+
+/************************************************************************************//**
+** \brief     Stops the firmware update session. This is there the library disconnects
+**            the transport layer as well. An error is reported if the firmware update
+**            could not be completed properly. For example when the programmed data did
+**            not match, after it was transferred over a transport layer that can lose,
+**            duplicate or reorder packets. In this case the bootloader does not start
+**            the user program.
+** \return    BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltSessionStop(void)
+{
+  /* Pass the request on to the initialized session. */
+  return BltSessionHandleStop(bltDefaultSession);
+} /*** end of BltSessionStop ***/
+
+
+/************************************************************************************//**
+** \brief     Requests the target to erase the specified range of memory on the target.
+**            Note that the target automatically aligns this to the erasable memory
+**            block sizes. This typically results in more memory being erased than the
+**            range that was specified here. Refer to the target implementation for
+**            details.
+** \param     address The starting memory address for the erase operation.
+** \param     len The total number of bytes to erase from memory.
+** \return    BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltSessionClearMemory(uint32_t address, uint32_t len)
+{
+  /* Pass the request on to the initialized session. */
+  return BltSessionHandleClearMemory(bltDefaultSession, address, len);
+} /*** end of BltSessionClearMemory ***/
+
+
+/************************************************************************************//**
+** \brief     Requests the target to program the specified data to memory. Note that it
+**            is the responsibility of the application to make sure the memory range was
+**            erased beforehand.
+** \param     address The starting memory address for the write operation.
+** \param     len The number of bytes in the data buffer that should be written.
+** \param     data Pointer to the byte array with data to write.
+** \return    BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltSessionWriteData(uint32_t address, uint32_t len, 
+                                               uint8_t const * data)
+{
+  /* Pass the request on to the initialized session. */
+  return BltSessionHandleWriteData(bltDefaultSession, address, len, data);
+} /*** end of BltSessionWriteData ***/
+
+
+/************************************************************************************//**
+** \brief     Requests the target to upload the specified range from memory and store its
+**            contents in the specified data buffer.
+** \param     address The starting memory address for the read operation.
+** \param     len The number of bytes to upload from the target and store in the data 
+**            buffer.
+** \param     data Pointer to the byte array where the uploaded data should be stored.
+** \return    BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltSessionReadData(uint32_t address, uint32_t len, 
+                                              uint8_t * data)
+{
+  /* Pass the request on to the initialized session. */
+  return BltSessionHandleReadData(bltDefaultSession, address, len, data);
+} /*** end of BltSessionReadData ***/
+
+
+/************************************************************************************//**
+** \brief     Obtains the command/response latency statistics of the firmware update
+**            session. They cover all successful exchanges with the target since the
+**            session was started and remain available after the session was stopped.
+** \param     latency Pointer to the structure where the statistics are stored.
+** \return    BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltSessionGetLatency(tBltSessionLatency * latency)
+{
+  /* Pass the request on to the initialized session. */
+  return BltSessionHandleGetLatency(bltDefaultSession, latency);
+} /*** end of BltSessionGetLatency ***/
+
+
+/************************************************************************************//**
+** \brief     Configures if the transport layer stays connected when the firmware update
+**            session is stopped. Refer to BltSessionHandleKeepTransport for details.
+** \param     keep 1 to keep the transport layer connected, 0 to disconnect it when
+**            the session is stopped.
+** \return    BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltSessionKeepTransport(uint32_t keep)
+{
+  /* Pass the request on to the initialized session. */
+  return BltSessionHandleKeepTransport(bltDefaultSession, keep);
+} /*** end of BltSessionKeepTransport ***/
+
+
+/************************************************************************************//**
+** \brief     Submits an operation to start the firmware update session, without
+**            waiting for it to complete. Refer to BltSessionStart for details.
+** \param     callback Function that is called for the events of the operation. Can be
+**            NULL.
+** \param     context Context of the application. It is passed on to the callback.
+** \return    BLT_RESULT_OK if the operation was submitted, BLT_RESULT_ERROR_xxx
+**            otherwise.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltSessionStartAsync(tBltSessionCallback callback,
+                                                void * context)
+{
+  /* Pass the request on to the initialized session. */
+  return BltSessionHandleStartAsync(bltDefaultSession, callback, context);
+} /*** end of BltSessionStartAsync ***/
+
+
+/************************************************************************************//**
+** \brief     Submits an operation to stop the firmware update session, without waiting
+**            for it to complete. Refer to BltSessionStop for details.
+** \param     callback Function that is called for the events of the operation. Can be
+**            NULL.
+** \param     context Context of the application. It is passed on to the callback.
+** \return    BLT_RESULT_OK if the operation was submitted, BLT_RESULT_ERROR_xxx
+**            otherwise.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltSessionStopAsync(tBltSessionCallback callback,
+                                               void * context)
+{
+  /* Pass the request on to the initialized session. */
+  return BltSessionHandleStopAsync(bltDefaultSession, callback, context);
+} /*** end of BltSessionStopAsync ***/
+
+
+/************************************************************************************//**
+** \brief     Submits an operation to erase the specified range of memory on the target,
+**            without waiting for it to complete. Refer to BltSessionClearMemory for
+**            details.
+** \param     address The starting memory address for the erase operation.
+** \param     len The total number of bytes to erase from memory.
+** \param     callback Function that is called for the events of the operation. Can be
+**            NULL.
+** \param     context Context of the application. It is passed on to the callback.
+** \return    BLT_RESULT_OK if the operation was submitted, BLT_RESULT_ERROR_xxx
+**            otherwise.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltSessionClearMemoryAsync(uint32_t address, uint32_t len,
+                                                      tBltSessionCallback callback,
+                                                      void * context)
+{
+  /* Pass the request on to the initialized session. */
+  return BltSessionHandleClearMemoryAsync(bltDefaultSession, address, len, callback,
+                                          context);
+} /*** end of BltSessionClearMemoryAsync ***/
+
+
+/************************************************************************************//**
+** \brief     Submits an operation to program the specified data to memory, without
+**            waiting for it to complete. Progress events are reported while the data
+**            is programmed. Refer to BltSessionWriteData for details.
+** \param     address The starting memory address for the write operation.
+** \param     len The number of bytes in the data buffer that should be written.
+** \param     data Pointer to the byte array with data to write. It must stay valid until
+**            the operation completed.
+** \param     callback Function that is called for the events of the operation. Can be
+**            NULL.
+** \param     context Context of the application. It is passed on to the callback.
+** \return    BLT_RESULT_OK if the operation was submitted, BLT_RESULT_ERROR_xxx
+**            otherwise.
 **
 ****************************************************************************************/
-LIBOPENBLT_EXPORT void BltSessionTerminate(void)
+LIBOPENBLT_EXPORT uint32_t BltSessionWriteDataAsync(uint32_t address, uint32_t len,
+                                                    uint8_t const * data,
+                                                    tBltSessionCallback callback,
+                                                    void * context)
 {
-  /* Terminate the session. */
-  SessionTerminate();
-} /*** end of BltSessionTerminate ***/
+  /* Pass the request on to the initialized session. */
+  return BltSessionHandleWriteDataAsync(bltDefaultSession, address, len, data,
+                                        callback, context);
+} /*** end of BltSessionWriteDataAsync ***/
 
 
 /************************************************************************************//**
-** \brief     Starts the firmware update session. This is were the library attempts to
-**            activate and connect with the bootloader running on the target, through
-**            the transport layer that was specified during the session's initialization.
-** \return    BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
+** \brief     Submits an operation to upload the specified range from memory and store
+**            its contents in the specified data buffer, without waiting for it to
+**            complete. Progress events are reported while the data is uploaded. Refer
+**            to BltSessionReadData for details.
+** \param     address The starting memory address for the read operation.
+** \param     len The number of bytes to upload from the target and store in the data
+**            buffer.
+** \param     data Pointer to the byte array where the uploaded data should be stored.
+**            It must stay valid until the operation completed.
+** \param     callback Function that is called for the events of the operation. Can be
+**            NULL.
+** \param     context Context of the application. It is passed on to the callback.
+** \return    BLT_RESULT_OK if the operation was submitted, BLT_RESULT_ERROR_xxx
+**            otherwise.
 **
 ****************************************************************************************/
-LIBOPENBLT_EXPORT uint32_t BltSessionStart(void)
+LIBOPENBLT_EXPORT uint32_t BltSessionReadDataAsync(uint32_t address, uint32_t len,
+                                                   uint8_t * data,
+                                                   tBltSessionCallback callback,
+                                                   void * context)
 {
-  uint32_t result = BLT_RESULT_ERROR_GENERIC;
-
-  /* Start the session. */
-  if (SessionStart())
-  {
-    result = BLT_RESULT_OK;
-  }
-  /* Give the result back to the caller. */
-  return result;
-} /*** end of BltSessionStart ***/
+  /* Pass the request on to the initialized session. */
+  return BltSessionHandleReadDataAsync(bltDefaultSession, address, len, data,
+                                       callback, context);
+} /*** end of BltSessionReadDataAsync ***/
 
 
 /************************************************************************************//**
-** \brief     Stops the firmware update session. This is there the library disconnects
-**            the transport layer as well.
+** \brief     Cancels all pending asynchronous session operations. A running write or
+**            read operation is aborted in between two chunks of data. Cancelled
+**            operations complete with an error, which is reported to their callbacks
+**            with the next call of BltSessionProcessEvents.
 **
 ****************************************************************************************/
-LIBOPENBLT_EXPORT void BltSessionStop(void)
+LIBOPENBLT_EXPORT void BltSessionCancelAsync(void)
 {
-  /* Stop the session. */
-  SessionStop();
-} /*** end of BltSessionStop ***/
+  /* Pass the request on to the initialized session. */
+  BltSessionHandleCancelAsync(bltDefaultSession);
+} /*** end of BltSessionCancelAsync ***/
 
 
 /************************************************************************************//**
-** \brief     Requests the target to erase the specified range of memory on the target.
-**            Note that the target automatically aligns this to the erasable memory
-**            block sizes. This typically results in more memory being erased than the
-**            range that was specified here. Refer to the target implementation for
-**            details.
-** \param     address The starting memory address for the erase operation.
-** \param     len The total number of bytes to erase from memory.
-** \return    BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
+** \brief     Links the callback of the application to an asynchronous session
+**            operation and submits it.
+** \param     session Handle of the session object.
+** \param     operation Pointer to the operation. Its context is set by this function.
+** \param     callback Function that is called for the events of the operation. Can be
+**            NULL.
+** \param     context Context of the application. It is passed on to the callback.
+** \return    BLT_RESULT_OK if the operation was submitted, BLT_RESULT_ERROR_xxx
+**            otherwise.
 **
 ****************************************************************************************/
-LIBOPENBLT_EXPORT uint32_t BltSessionClearMemory(uint32_t address, uint32_t len)
+static uint32_t BltSessionSubmitAsync(tBltSessionHandle session,
+                                      tSessionAsyncOperation * operation,
+                                      tBltSessionCallback callback, void * context)
 {
   uint32_t result = BLT_RESULT_ERROR_GENERIC;
-  
+  tBltSessionObj * bltSession = (tBltSessionObj *)session;
+  tBltSessionAsyncRequest * request;
+
   /* Check parameters. */
-  assert(len > 0);
-  
-  /* Only continue if the parameters are valid. */
-  if (len > 0) 
+  assert(bltSession != NULL);
+
+  /* Only continue with valid parameters. */
+  if (bltSession != NULL) /*lint !e774 */
   {
-    /* Pass the request on to the session module. */
-    if (SessionClearMemory(address, len))
+    /* Allocate the request that links the callback to the operation. */
+    request = malloc(sizeof(tBltSessionAsyncRequest));
+    assert(request != NULL);
+    /* Only continue if the allocation was successful. */
+    if (request != NULL) /*lint !e774 */
     {
-      result = BLT_RESULT_OK;
+      request->callback = callback;
+      request->context = context;
+      operation->context = request;
+      /* Submit the operation. */
+      if (SessionAsyncSubmit(bltSession->async, operation))
+      {
+        result = BLT_RESULT_OK;
+      }
+      else
+      {
+        free(request);
+      }
     }
   }
   /* Give the result back to the caller. */
   return result;
-} /*** end of BltSessionClearMemory ***/
+} /*** end of BltSessionSubmitAsync ***/
 
 
 /************************************************************************************//**
-** \brief     Requests the target to program the specified data to memory. Note that it
-**            is the responsibility of the application to make sure the memory range was
-**            erased beforehand.
-** \param     address The starting memory address for the write operation.
-** \param     len The number of bytes in the data buffer that should be written.
-** \param     data Pointer to the byte array with data to write.
-** \return    BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
+** \brief     Dispatches the pending events of the asynchronous operations of a session
+**            to their callbacks.
+** \param     bltSession Pointer to the session object.
 **
 ****************************************************************************************/
-LIBOPENBLT_EXPORT uint32_t BltSessionWriteData(uint32_t address, uint32_t len, 
-                                               uint8_t const * data)
+static void BltSessionDispatchEvents(tBltSessionObj * bltSession)
 {
-  uint32_t result = BLT_RESULT_ERROR_GENERIC;
+  tSessionAsyncEvent asyncEvent;
+  tBltSessionEvent event;
+  tBltSessionAsyncRequest * request;
 
-  /* Check parameters. */
-  assert(data != NULL);
-  assert(len > 0);
-  
-  /* Only continue if the parameters are valid. */ 
-  if ( (data != NULL) && (len > 0) ) /*lint !e774 */
+  while (SessionAsyncGetEvent(bltSession->async, &asyncEvent))
   {
-    /* Pass the request on to the session module. */
-    if (SessionWriteData(address, len, data))
+    request = (tBltSessionAsyncRequest *)asyncEvent.context;
+    /* Convert the event. */
+    event.operation = asyncEvent.operation;
+    event.event = (asyncEvent.type == SESSION_ASYNC_EVENT_COMPLETED) ?
+                  BLT_SESSION_EVENT_COMPLETED : BLT_SESSION_EVENT_PROGRESS;
+    event.result = (asyncEvent.result) ? BLT_RESULT_OK : BLT_RESULT_ERROR_GENERIC;
+    event.progress = asyncEvent.progress;
+    event.total = asyncEvent.total;
+    /* Pass it on to the callback of the application. */
+    if ( (request != NULL) && (request->callback != NULL) )
     {
-      result = BLT_RESULT_OK;
+      request->callback(&event, request->context);
+    }
+    /* The request is no longer needed once the operation completed. */
+    if (event.event == BLT_SESSION_EVENT_COMPLETED)
+    {
+      free(request);
     }
   }
-  /* Give the result back to the caller. */
-  return result;
-} /*** end of BltSessionWriteData ***/
+} /*** end of BltSessionDispatchEvents ***/
 
 
 /************************************************************************************//**
-** \brief     Requests the target to upload the specified range from memory and store its
-**            contents in the specified data buffer.
-** \param     address The starting memory address for the read operation.
-** \param     len The number of bytes to upload from the target and store in the data 
-**            buffer.
-** \param     data Pointer to the byte array where the uploaded data should be stored.
-** \return    BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
+** \brief     Obtains the number of pending asynchronous operations of all sessions.
+** \return    Number of asynchronous operations that did not yet complete.
 **
 ****************************************************************************************/
-LIBOPENBLT_EXPORT uint32_t BltSessionReadData(uint32_t address, uint32_t len, 
-                                              uint8_t * data)
+static uint32_t BltSessionGetPendingCount(void)
 {
-  uint32_t result = BLT_RESULT_ERROR_GENERIC;
-
-  /* Check parameters. */
-  assert(data != NULL);
-  assert(len > 0);
+  uint32_t result = 0;
+  tBltSessionObj * bltSession;
 
-  /* Only continue if the parameters are valid. */
-  if ( (data != NULL) && (len > 0) ) /*lint !e774 */
+  for (bltSession = bltSessionList; bltSession != NULL; bltSession = bltSession->next)
   {
-    /* Pass the request on to the session module. */
-    if (SessionReadData(address, len, data))
-    {
-      result = BLT_RESULT_OK;
-    }
+    result += SessionAsyncGetPendingCount(bltSession->async);
   }
   /* Give the result back to the caller. */
   return result;
-} /*** end of BltSessionReadData ***/
+} /*** end of BltSessionGetPendingCount ***/
 
 
 /****************************************************************************************
@@ -411,6 +1408,7 @@ LIBOPENBLT_EXPORT void BltFirmwareInit(uint32_t parserType)
   }
   /* Initialize the firmware data module by linking the firmware file parser. */
   FirmwareInit(firmwareParser);
+  bltFirmwareParserType = parserType;
 } /*** end of BltFirmwareInit ***/
 
 
@@ -428,7 +1426,9 @@ LIBOPENBLT_EXPORT void BltFirmwareTerminate(void)
 
 /************************************************************************************//**
 ** \brief     Loads firmware data from the specified file using the firmware file parser
-**            that was specified during the initialization of this module.
+**            that was specified during the initialization of this module. If the
+**            firmware cache is enabled with BltFirmwareSetCache, the firmware data is
+**            taken from the cache when the contents of the file were loaded before.
 ** \param     firmwareFile Filename of the firmware file to load.
 ** \param     addressOffset Optional memory address offset to add when loading the 
 **            firmware data from the file. This is typically only useful when loading
@@ -447,8 +1447,10 @@ LIBOPENBLT_EXPORT uint32_t BltFirmwareLoadFromFile(char const * firmwareFile,
   /* Only continue if parameters are valid. */
   if (firmwareFile != NULL) /*lint !e774 */
   {
-    /* Pass the request on to the firmware data module. */
-    if (FirmwareLoadFromFile(firmwareFile, addressOffset))
+    /* Pass the request on to the firmware cache module, which passes it on to the
+     * firmware data module if the file is not yet in the cache.
+     */
+    if (FirmwareCacheLoadFromFile(firmwareFile, bltFirmwareParserType, addressOffset))
     {
       result = BLT_RESULT_OK;
     }
@@ -615,6 +1617,29 @@ LIBOPENBLT_EXPORT void BltFirmwareClearData(void)
 } /*** end of BltFirmwareClearData ***/
 
 
+/************************************************************************************//**
+** \brief     Enables or disables the firmware cache. Parsing a large firmware file takes
+**            a while. With the cache enabled, BltFirmwareLoadFromFile stores the
+**            firmware data of each firmware file that it parsed in a binary cache file,
+**            named after the SHA-256 hash of the contents of the firmware file. The next
+**            time that the same contents are loaded, by any process that uses the same
+**            directory, the firmware data is mapped from the cache file instead. A
+**            changed firmware file has another hash, so it is never loaded from a
+**            stale cache file. Once the cache files take more space than allowed, the
+**            least recently used ones are removed.
+** \param     directory Existing directory for the cache files. NULL or an empty string
+**            to disable the cache, which is the default.
+** \param     maxSize Maximum total size of the cache files in kilobytes. 0 for no
+**            limit.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT void BltFirmwareSetCache(char const * directory, uint32_t maxSize)
+{
+  /* Pass the request on to the firmware cache module. */
+  FirmwareCacheConfigure(directory, maxSize);
+} /*** end of BltFirmwareSetCache ***/
+
+
 /****************************************************************************************
 *             G E N E R I C   U T I L I T I E S
 ****************************************************************************************/
@@ -671,7 +1696,158 @@ LIBOPENBLT_EXPORT uint32_t BltUtilCrc32Calculate(uint8_t const * data, uint32_t
 
 
 /************************************************************************************//**
-** \brief     Get the system time in milliseconds.
+** \brief     Starts a 16-bit CRC calculation over data that is not available all at
+**            once. The parts of the data are added with BltUtilCrc16Update and
+**            BltUtilCrc16Final gives the CRC value of all data. The result is the same
+**            as that of BltUtilCrc16Calculate over all data.
+** \return    The initial CRC value.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint16_t BltUtilCrc16Init(void)
+{
+  /* The CRC calculation starts with zero. */
+  return 0;
+} /*** end of BltUtilCrc16Init ***/
+
+
+/************************************************************************************//**
+** \brief     Continues a 16-bit CRC calculation with the next part of the data.
+** \param     crc The CRC value from BltUtilCrc16Init or from the previous call of this
+**            function.
+** \param     data Array with bytes over which the CRC16 should be calculated.
+** \param     len Number of bytes in the data array. Can be zero.
+** \return    The updated CRC value.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint16_t BltUtilCrc16Update(uint16_t crc, uint8_t const * data,
+                                           uint32_t len)
+{
+  uint16_t result = crc;
+
+  /* Check parameters. */
+  assert( (data != NULL) || (len == 0) );
+
+  /* Only continue if parameters are valid. */
+  if ( (data != NULL) && (len > 0) ) /*lint !e774 */
+  {
+    /* Perform checksum calculation. */
+    result = UtilChecksumCrc16Update(crc, data, len);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of BltUtilCrc16Update ***/
+
+
+/************************************************************************************//**
+** \brief     Completes a 16-bit CRC calculation.
+** \param     crc The CRC value from the last call of BltUtilCrc16Update.
+** \return    The 16-bit CRC value of all data.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint16_t BltUtilCrc16Final(uint16_t crc)
+{
+  /* No final XOR value is applied, so the CRC value is already complete. */
+  return crc;
+} /*** end of BltUtilCrc16Final ***/
+
+
+/************************************************************************************//**
+** \brief     Combines the 16-bit CRC values of two consecutive blocks of data into the
+**            CRC value of both blocks together. This makes it possible to calculate the
+**            CRC values of parts of the data independently, for example in parallel, and
+**            to merge them afterwards.
+** \param     crc1 CRC value of the first block.
+** \param     crc2 CRC value of the second block.
+** \param     len2 Number of bytes in the second block.
+** \return    The 16-bit CRC value of the first block followed by the second block.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint16_t BltUtilCrc16Combine(uint16_t crc1, uint16_t crc2,
+                                               uint32_t len2)
+{
+  /* Perform the combination. */
+  return UtilChecksumCrc16Combine(crc1, crc2, len2);
+} /*** end of BltUtilCrc16Combine ***/
+
+
+/************************************************************************************//**
+** \brief     Starts a 32-bit CRC calculation over data that is not available all at
+**            once. The parts of the data are added with BltUtilCrc32Update and
+**            BltUtilCrc32Final gives the CRC value of all data. The result is the same
+**            as that of BltUtilCrc32Calculate over all data.
+** \return    The initial CRC value.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltUtilCrc32Init(void)
+{
+  /* The CRC calculation starts with zero. */
+  return 0;
+} /*** end of BltUtilCrc32Init ***/
+
+
+/************************************************************************************//**
+** \brief     Continues a 32-bit CRC calculation with the next part of the data.
+** \param     crc The CRC value from BltUtilCrc32Init or from the previous call of this
+**            function.
+** \param     data Array with bytes over which the CRC32 should be calculated.
+** \param     len Number of bytes in the data array. Can be zero.
+** \return    The updated CRC value.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltUtilCrc32Update(uint32_t crc, uint8_t const * data,
+                                           uint32_t len)
+{
+  uint32_t result = crc;
+
+  /* Check parameters. */
+  assert( (data != NULL) || (len == 0) );
+
+  /* Only continue if parameters are valid. */
+  if ( (data != NULL) && (len > 0) ) /*lint !e774 */
+  {
+    /* Perform checksum calculation. */
+    result = UtilChecksumCrc32Update(crc, data, len);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of BltUtilCrc32Update ***/
+
+
+/************************************************************************************//**
+** \brief     Completes a 32-bit CRC calculation.
+** \param     crc The CRC value from the last call of BltUtilCrc32Update.
+** \return    The 32-bit CRC value of all data.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltUtilCrc32Final(uint32_t crc)
+{
+  /* No final XOR value is applied, so the CRC value is already complete. */
+  return crc;
+} /*** end of BltUtilCrc32Final ***/
+
+
+/************************************************************************************//**
+** \brief     Combines the 32-bit CRC values of two consecutive blocks of data into the
+**            CRC value of both blocks together. This makes it possible to calculate the
+**            CRC values of parts of the data independently, for example in parallel, and
+**            to merge them afterwards.
+** \param     crc1 CRC value of the first block.
+** \param     crc2 CRC value of the second block.
+** \param     len2 Number of bytes in the second block.
+** \return    The 32-bit CRC value of the first block followed by the second block.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltUtilCrc32Combine(uint32_t crc1, uint32_t crc2,
+                                               uint32_t len2)
+{
+  /* Perform the combination. */
+  return UtilChecksumCrc32Combine(crc1, crc2, len2);
+} /*** end of BltUtilCrc32Combine ***/
+
+
+/************************************************************************************//**
+** \brief     Get the system time in milliseconds. It does not jump when the wall-clock
+**            time is adjusted, so it can be used for measuring time intervals.
 ** \return    Time in milliseconds.
 **
 ****************************************************************************************/
@@ -685,6 +1861,22 @@ LIBOPENBLT_EXPORT uint32_t BltUtilTimeGetSystemTime(void)
   return result;
 } /*** end of BltUtilTimeGetSystemTime ***/
 
+
+/************************************************************************************//**
+** \brief     Get the time of the monotonic clock in microseconds. It does not jump when
+**            the wall-clock time is adjusted. The time at which it started is
+**            unspecified, so it is only useful for measuring time intervals, such as
+**            latencies below a millisecond.
+** \return    Time in microseconds.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint64_t BltUtilTimeGetMonotonicUs(void)
+{
+  /* Pass the request on to the utility module. */
+  return UtilTimeGetMonotonicUs();
+} /*** end of BltUtilTimeGetMonotonicUs ***/
+
+
 /************************************************************************************//**
 ** \brief     Performs a delay of the specified amount of milliseconds.
 ** \param     delay Delay time in milliseconds.
@@ -765,6 +1957,121 @@ LIBOPENBLT_EXPORT uint32_t BltUtilCryptoAes256Decrypt(uint8_t * data, uint32_t l
 } /*** end of BltUtilCryptoAes256Decrypt ***/
 
 
+/************************************************************************************//**
+** \brief     Creates an AES256 cryptography context for the specified 256-bit (32 bytes)
+**            key. The key is expanded only once, so the context en/decrypts many
+**            buffers faster than BltUtilCryptoAes256Encrypt/Decrypt. Release the
+**            context with BltUtilCryptoAes256Destroy when it is no longer needed.
+** \param     key The 256-bit cryptography key as a array of 32 bytes.
+** \return    Handle of the context if successful, NULL otherwise.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT tBltAes256Handle BltUtilCryptoAes256Create(uint8_t const * key)
+{
+  tBltAes256Handle result = NULL;
+
+  /* Check parameters */
+  assert(key != NULL);
+
+  /* Only continue with valid parameters. */
+  if (key != NULL) /*lint !e774 */
+  {
+    /* Pass the request on to the utility module. */
+    result = UtilCryptoAes256Create(key);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of BltUtilCryptoAes256Create ***/
+
+
+/************************************************************************************//**
+** \brief     Releases an AES256 cryptography context, that was created with
+**            BltUtilCryptoAes256Create.
+** \param     crypto Handle of the context.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT void BltUtilCryptoAes256Destroy(tBltAes256Handle crypto)
+{
+  /* Check parameters */
+  assert(crypto != NULL);
+
+  /* Only continue with valid parameters. */
+  if (crypto != NULL) /*lint !e774 */
+  {
+    /* Pass the request on to the utility module. */
+    UtilCryptoAes256Destroy(crypto);
+  }
+} /*** end of BltUtilCryptoAes256Destroy ***/
+
+
+/************************************************************************************//**
+** \brief     Encrypts the len-bytes in the specified data-array, using the key of the
+**            cryptography context. The results are written back into the same array.
+** \param     crypto Handle of the context.
+** \param     data Pointer to the byte array with data to encrypt. The encrypted bytes
+**            are stored in the same array.
+** \param     len The number of bytes in the data-array to encrypt. It must be a multiple
+**            of 16, as this is the AES256 minimal block size.
+** \return    BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltUtilCryptoAes256HandleEncrypt(tBltAes256Handle crypto,
+                                                            uint8_t * data, uint32_t len)
+{
+  uint32_t result = BLT_RESULT_ERROR_GENERIC;
+
+  /* Check parameters */
+  assert(crypto != NULL);
+  assert(data != NULL);
+
+  /* Only continue with valid parameters. Also add a block size check for 'len'. */
+  if ( (crypto != NULL) && (data != NULL) && ((len % 16u) == 0) ) /*lint !e774 */
+  {
+    /* Pass the request on to the utility module. */
+    if (UtilCryptoAes256EncryptData(crypto, data, len))
+    {
+      result = BLT_RESULT_OK;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of BltUtilCryptoAes256HandleEncrypt ***/
+
+
+/************************************************************************************//**
+** \brief     Decrypts the len-bytes in the specified data-array, using the key of the
+**            cryptography context. The results are written back into the same array.
+** \param     crypto Handle of the context.
+** \param     data Pointer to the byte array with data to decrypt. The decrypted bytes
+**            are stored in the same array.
+** \param     len The number of bytes in the data-array to decrypt. It must be a multiple
+**            of 16, as this is the AES256 minimal block size.
+** \return    BLT_RESULT_OK if successful, BLT_RESULT_ERROR_xxx otherwise.
+**
+****************************************************************************************/
+LIBOPENBLT_EXPORT uint32_t BltUtilCryptoAes256HandleDecrypt(tBltAes256Handle crypto,
+                                                            uint8_t * data, uint32_t len)
+{
+  uint32_t result = BLT_RESULT_ERROR_GENERIC;
+
+  /* Check parameters */
+  assert(crypto != NULL);
+  assert(data != NULL);
+
+  /* Only continue with valid parameters. Also add a block size check for 'len'. */
+  if ( (crypto != NULL) && (data != NULL) && ((len % 16u) == 0) ) /*lint !e774 */
+  {
+    /* Pass the request on to the utility module. */
+    if (UtilCryptoAes256DecryptData(crypto, data, len))
+    {
+      result = BLT_RESULT_OK;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of BltUtilCryptoAes256HandleDecrypt ***/
+
+
 /*********************************** end of openblt.c **********************************/
 
  
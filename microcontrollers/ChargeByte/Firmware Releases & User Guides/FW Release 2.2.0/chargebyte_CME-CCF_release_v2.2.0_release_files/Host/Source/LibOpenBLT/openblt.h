@@ -115,6 +115,32 @@ LIBOPENBLT_EXPORT char const * BltVersionGetString(void);
  */
 #define BLT_TRANSPORT_XCP_V10_NET      ((uint32_t)3u)
 
+/** \brief Transport layer for the XCP v1.0 protocol that uses UDP/IP for data
+ *         exchange.
+ */
+#define BLT_TRANSPORT_XCP_V10_UDP      ((uint32_t)4u)
+
+/** \brief Transport layer for the XCP v1.0 protocol that wraps one of the other
+ *         transport layers and emulates the delay, jitter, loss, duplication and
+ *         reordering of a poor network. Meant for testing and benchmarking.
+ */
+#define BLT_TRANSPORT_XCP_V10_EMU      ((uint32_t)5u)
+
+/* Operation types of the asynchronous session functions. */
+#define BLT_SESSION_OP_START           ((uint32_t)0u) /**< BltSessionStartAsync.       */
+#define BLT_SESSION_OP_STOP            ((uint32_t)1u) /**< BltSessionStopAsync.        */
+#define BLT_SESSION_OP_CLEAR_MEMORY    ((uint32_t)2u) /**< BltSessionClearMemoryAsync. */
+#define BLT_SESSION_OP_WRITE_DATA      ((uint32_t)3u) /**< BltSessionWriteDataAsync.   */
+#define BLT_SESSION_OP_READ_DATA       ((uint32_t)4u) /**< BltSessionReadDataAsync.    */
+
+/** \brief Event type of an asynchronous session operation that made progress. */
+#define BLT_SESSION_EVENT_PROGRESS     ((uint32_t)0u)
+
+/** \brief Event type of an asynchronous session operation that completed. This is
+ *         always the last event of an operation.
+ */
+#define BLT_SESSION_EVENT_COMPLETED    ((uint32_t)1u)
+
 
 /****************************************************************************************
 * Type definitions
@@ -136,6 +162,10 @@ typedef struct t_blt_session_settings_xcp_v10
  *         portName field is platform dependent. On Linux based systems this should be
  *         the filename of the tty-device, such as "/dev/tty0". On Windows based systems
  *         it should be the name of the COM-port, such as "COM1".
+ *         The baudrate field is not limited to the standard baudrates up to 115200.
+ *         Higher standard baudrates, such as 921600 or 4000000, and arbitrary ones are
+ *         supported as well, provided that the serial port's driver and hardware
+ *         support them.
  */
 typedef struct t_blt_transport_settings_xcp_v10_rs232
 {
@@ -154,9 +184,20 @@ typedef struct t_blt_transport_settings_xcp_v10_rs232
  *         On Windows based systems, the device name is a name that is pre-defined by
  *         this library for the supported CAN adapters. The device name should be one of
  *         the following: "peak_pcanusb", "kvaser_leaflight", or "lawicel_canusb".
+ *         On all systems, a device name that starts with "loopback" selects an
+ *         in-process virtual CAN bus without hardware, which emulates the bus timing.
+ *         Options can be appended, for example "loopback:latency=200,loss=0.5".
  *         Field use extended is a boolean field. When set to 0, the specified transmitId
  *         and receiveId are assumed to be 11-bit standard CAN identifier. It the field
  *         is 1, these identifiers are assumed to be 29-bit extended CAN identifiers.
+ *         Field txFrameGap configures the minimum time in microseconds between the
+ *         start of two transmitted CAN frames, for targets that cannot keep up with
+ *         back-to-back frames. A value of 0 disables the pacing. This field is
+ *         currently only supported by the SocketCAN interface on Linux.
+ *         The library supports one CAN bus per process. Sessions that exist at the same
+ *         time must all use the same deviceName, deviceChannel and baudrate. Creating a
+ *         session for a different CAN bus, for example can1 while can0 is in use,
+ *         fails.
  */
 typedef struct t_blt_transport_settings_xcp_v10_can
 {
@@ -166,19 +207,129 @@ typedef struct t_blt_transport_settings_xcp_v10_can
   uint32_t transmitId;           /**< Transmit CAN identifier.                         */
   uint32_t receiveId;            /**< Receive CAN identifier.                          */
   uint32_t useExtended;          /**< Boolean to configure 29-bit CAN identifiers.     */
+  uint32_t txFrameGap;           /**< Minimum time between tx frames in microseconds.  */
 } tBltTransportSettingsXcpV10Can;
 
 /** \brief Structure layout of the XCP version 1.0 NET transport layer settings. The
  *         address field can be set to either the IP address or the hostname, such as
  *         "192.168.178.23" or "mymicro.mydomain.com". The port should be set to the 
  *         TCP port number that the bootloader target listens on.
+ *         Field window configures the maximum number of program commands that are
+ *         sent to the target, before waiting for the oldest response. A value of 0 or
+ *         1 disables the pipelining. Only enable it for a target that buffers received
+ *         commands and processes them in order, because the TCP stream does not keep
+ *         packet boundaries.
  */
 typedef struct t_blt_transport_settings_xcp_v10_net
 {
   char const * address;          /**< Target IP-address or hostname on the network.    */
   uint16_t port;                 /**< TCP port to use.                                 */
+  uint32_t window;               /**< Maximum number of commands in flight.            */
 } tBltTransportSettingsXcpV10Net;
 
+/** \brief Structure layout of the XCP version 1.0 UDP transport layer settings. The
+ *         address field can be set to either the IP address or the hostname, such as
+ *         "192.168.178.23" or "mymicro.mydomain.com". The port should be set to the
+ *         UDP port number that the bootloader target listens on.
+ *         Field window configures the maximum number of program commands that are
+ *         sent to the target, before waiting for the oldest response. A value of 0 or
+ *         1 disables the pipelining. The datagrams of the commands in flight are sent
+ *         in batches. Only enable it for a target that buffers received datagrams.
+ */
+typedef struct t_blt_transport_settings_xcp_v10_udp
+{
+  char const * address;          /**< Target IP-address or hostname on the network.    */
+  uint16_t port;                 /**< UDP port to use.                                 */
+  uint32_t window;               /**< Maximum number of commands in flight.            */
+} tBltTransportSettingsXcpV10Udp;
+
+/** \brief Structure layout of the XCP version 1.0 network emulation transport layer
+ *         settings. It wraps the transport layer of the transportType field, which is
+ *         configured with the settings that transportSettings points to. Another
+ *         network emulation transport layer cannot be wrapped.
+ *         Each command is held back for the delay plus a random part of the jitter,
+ *         before it is passed on to the wrapped transport layer. This adds to the
+ *         round trip time, but commands keep their order. The loss, duplicate and
+ *         reorder fields are probabilities in parts per million. A lost command or
+ *         response makes the exchange time out. A duplicated command is executed
+ *         twice by the target and the second response is discarded. Reordering swaps
+ *         a command with the next one. This needs a delay and a transport layer window
+ *         with multiple program commands in flight. A retransmission of the wrapped
+ *         transport layer, such as the one of XCP on UDP/IP, is not triggered by
+ *         emulated loss, because it happens below this layer. The pseudo random
+ *         generator starts from the seed, so the same seed gives the same faults.
+ */
+typedef struct t_blt_transport_settings_xcp_v10_emu
+{
+  uint32_t transportType;        /**< Wrapped transport layer (BLT_TRANSPORT_xxx).     */
+  void const * transportSettings;/**< Settings of the wrapped transport layer.         */
+  uint32_t delay;                /**< Delay of each command in microseconds.           */
+  uint32_t jitter;               /**< Maximum random extra delay in microseconds.      */
+  uint32_t loss;                 /**< Probability of losing a packet in ppm.           */
+  uint32_t duplicate;            /**< Probability of duplicating a command in ppm.     */
+  uint32_t reorder;              /**< Probability of reordering a command in ppm.      */
+  uint32_t seed;                 /**< Seed of the pseudo random generator.             */
+} tBltTransportSettingsXcpV10Emu;
+
+/** \brief Structure layout of the command/response latency statistics of a session.
+ *         The command/response time of each exchange with the target is split into the
+ *         time spent on the host and the time spent on the communication medium and in
+ *         the target (wire time). The split relies on time stamps from the transport
+ *         layer. It is currently only supported by the CAN transport layer, where the
+ *         SocketCAN interface on Linux uses the time stamps of the kernel or, if
+ *         synchronized with the system time, those of the CAN controller. For other
+ *         transport layers the entire command/response time counts as wire time. All
+ *         times are in microseconds.
+ */
+typedef struct t_blt_session_latency
+{
+  uint32_t count;                /**< Number of measured command/response exchanges.   */
+  uint32_t totalAvg;             /**< Average command/response time.                   */
+  uint32_t hostAvg;              /**< Average time spent on the host.                  */
+  uint32_t wireAvg;              /**< Average time spent on the medium and in target.  */
+  uint32_t totalMax;             /**< Longest command/response time.                   */
+  uint32_t totalP99;             /**< 99th percentile of the command/response time.    */
+} tBltSessionLatency;
+
+/** \brief Structure layout of an event of an asynchronous session operation. The
+ *         progress is the number of bytes that were processed so far, out of the total.
+ *         For start and stop operations, both are 0. The result is only valid for a
+ *         completion event and holds BLT_RESULT_OK if the operation was successful.
+ */
+typedef struct t_blt_session_event
+{
+  uint32_t operation;            /**< Operation type (BLT_SESSION_OP_xxx).             */
+  uint32_t event;                /**< Event type (BLT_SESSION_EVENT_xxx).              */
+  uint32_t result;               /**< Result of a completed operation.                 */
+  uint32_t progress;             /**< Number of bytes processed so far.                */
+  uint32_t total;                /**< Total number of bytes to process.                */
+} tBltSessionEvent;
+
+/** \brief Callback function for the events of an asynchronous session operation. The
+ *         asynchronous session functions submit an operation, which is executed in the
+ *         background by a worker thread of the library. The operations of a session are
+ *         executed one after the other, in the order in which they were submitted. Each
+ *         session has its own worker thread, so the operations of different sessions
+ *         run at the same time. The callback is only called from within
+ *         BltSessionProcessEvents, so in the thread of the application. It is allowed
+ *         to submit new operations from the callback. The event handle of
+ *         BltSessionGetEventHandle is signaled while events of any session are
+ *         pending. On Linux it is a file descriptor that becomes readable and on
+ *         Windows it is an event object handle. This makes it possible to wait for it
+ *         together with other handles of the application. The synchronous session
+ *         functions can still be used while asynchronous operations are pending.
+ */
+typedef void (* tBltSessionCallback)(tBltSessionEvent const * event, void * context);
+
+/** \brief Handle of a firmware update session object. Multiple sessions can exist at
+ *         the same time, each with its own connection to a target. This makes it
+ *         possible to update the firmware of multiple targets in parallel. Sessions are
+ *         created, destroyed and have their events processed from the same thread of
+ *         the application. The session functions without a session handle parameter
+ *         operate on the session of BltSessionInit.
+ */
+typedef void * tBltSessionHandle;
+
 
 /****************************************************************************************
 * Function prototypes
@@ -189,12 +340,73 @@ LIBOPENBLT_EXPORT void BltSessionInit(uint32_t sessionType,
                                       void const * transportSettings);
 LIBOPENBLT_EXPORT void BltSessionTerminate(void);
 LIBOPENBLT_EXPORT uint32_t BltSessionStart(void);
-LIBOPENBLT_EXPORT void BltSessionStop(void);
+LIBOPENBLT_EXPORT uint32_t BltSessionStop(void);
 LIBOPENBLT_EXPORT uint32_t BltSessionClearMemory(uint32_t address, uint32_t len);
 LIBOPENBLT_EXPORT uint32_t BltSessionWriteData(uint32_t address, uint32_t len, 
                                                uint8_t const * data);
 LIBOPENBLT_EXPORT uint32_t BltSessionReadData(uint32_t address, uint32_t len, 
                                               uint8_t * data);
+LIBOPENBLT_EXPORT uint32_t BltSessionGetLatency(tBltSessionLatency * latency);
+LIBOPENBLT_EXPORT uint32_t BltSessionKeepTransport(uint32_t keep);
+LIBOPENBLT_EXPORT uint32_t BltSessionStartAsync(tBltSessionCallback callback,
+                                                void * context);
+LIBOPENBLT_EXPORT uint32_t BltSessionStopAsync(tBltSessionCallback callback,
+                                               void * context);
+LIBOPENBLT_EXPORT uint32_t BltSessionClearMemoryAsync(uint32_t address, uint32_t len,
+                                                      tBltSessionCallback callback,
+                                                      void * context);
+LIBOPENBLT_EXPORT uint32_t BltSessionWriteDataAsync(uint32_t address, uint32_t len,
+                                                    uint8_t const * data,
+                                                    tBltSessionCallback callback,
+                                                    void * context);
+LIBOPENBLT_EXPORT uint32_t BltSessionReadDataAsync(uint32_t address, uint32_t len,
+                                                   uint8_t * data,
+                                                   tBltSessionCallback callback,
+                                                   void * context);
+LIBOPENBLT_EXPORT uint32_t BltSessionProcessEvents(uint32_t timeout);
+LIBOPENBLT_EXPORT void BltSessionCancelAsync(void);
+LIBOPENBLT_EXPORT intptr_t BltSessionGetEventHandle(void);
+LIBOPENBLT_EXPORT tBltSessionHandle BltSessionCreate(uint32_t sessionType,
+                                                     void const * sessionSettings,
+                                                     uint32_t transportType,
+                                                     void const * transportSettings);
+LIBOPENBLT_EXPORT void BltSessionDestroy(tBltSessionHandle session);
+LIBOPENBLT_EXPORT uint32_t BltSessionHandleStart(tBltSessionHandle session);
+LIBOPENBLT_EXPORT uint32_t BltSessionHandleStop(tBltSessionHandle session);
+LIBOPENBLT_EXPORT uint32_t BltSessionHandleClearMemory(tBltSessionHandle session,
+                                                       uint32_t address, uint32_t len);
+LIBOPENBLT_EXPORT uint32_t BltSessionHandleWriteData(tBltSessionHandle session,
+                                                     uint32_t address, uint32_t len,
+                                                     uint8_t const * data);
+LIBOPENBLT_EXPORT uint32_t BltSessionHandleReadData(tBltSessionHandle session,
+                                                    uint32_t address, uint32_t len,
+                                                    uint8_t * data);
+LIBOPENBLT_EXPORT uint32_t BltSessionHandleGetLatency(tBltSessionHandle session,
+                                                      tBltSessionLatency * latency);
+LIBOPENBLT_EXPORT uint32_t BltSessionHandleKeepTransport(tBltSessionHandle session,
+                                                         uint32_t keep);
+LIBOPENBLT_EXPORT uint32_t BltSessionHandleStartAsync(tBltSessionHandle session,
+                                                      tBltSessionCallback callback,
+                                                      void * context);
+LIBOPENBLT_EXPORT uint32_t BltSessionHandleStopAsync(tBltSessionHandle session,
+                                                     tBltSessionCallback callback,
+                                                     void * context);
+LIBOPENBLT_EXPORT uint32_t BltSessionHandleClearMemoryAsync(tBltSessionHandle session,
+                                                            uint32_t address,
+                                                            uint32_t len,
+                                                            tBltSessionCallback callback,
+                                                            void * context);
+LIBOPENBLT_EXPORT uint32_t BltSessionHandleWriteDataAsync(tBltSessionHandle session,
+                                                          uint32_t address, uint32_t len,
+                                                          uint8_t const * data,
+                                                          tBltSessionCallback callback,
+                                                          void * context);
+LIBOPENBLT_EXPORT uint32_t BltSessionHandleReadDataAsync(tBltSessionHandle session,
+                                                         uint32_t address, uint32_t len,
+                                                         uint8_t * data,
+                                                         tBltSessionCallback callback,
+                                                         void * context);
+LIBOPENBLT_EXPORT void BltSessionHandleCancelAsync(tBltSessionHandle session);
 
 
 /****************************************************************************************
@@ -226,22 +438,57 @@ LIBOPENBLT_EXPORT uint32_t BltFirmwareAddData(uint32_t address, uint32_t len,
                                               uint8_t const * data);
 LIBOPENBLT_EXPORT uint32_t BltFirmwareRemoveData(uint32_t address, uint32_t len);
 LIBOPENBLT_EXPORT void BltFirmwareClearData(void);
+LIBOPENBLT_EXPORT void BltFirmwareSetCache(char const * directory, uint32_t maxSize);
 
 
 /****************************************************************************************
 *             G E N E R I C   U T I L I T I E S
 ****************************************************************************************/
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Handle of an AES256 cryptography context. The key is expanded once, when the
+ *         context is created with BltUtilCryptoAes256Create. Afterwards the context
+ *         en/decrypts any number of buffers, which is a lot faster than calling
+ *         BltUtilCryptoAes256Encrypt/Decrypt for each one of them. The context is not
+ *         changed while data is processed, so multiple threads can use the same context
+ *         at the same time, for example each on their own part of a buffer.
+ */
+typedef void * tBltAes256Handle;
+
+
 /****************************************************************************************
 * Function prototypes
 ****************************************************************************************/
 LIBOPENBLT_EXPORT uint16_t BltUtilCrc16Calculate(uint8_t const * data, uint32_t len);
 LIBOPENBLT_EXPORT uint32_t BltUtilCrc32Calculate(uint8_t const * data, uint32_t len);
+LIBOPENBLT_EXPORT uint16_t BltUtilCrc16Init(void);
+LIBOPENBLT_EXPORT uint16_t BltUtilCrc16Update(uint16_t crc, uint8_t const * data,
+                                              uint32_t len);
+LIBOPENBLT_EXPORT uint16_t BltUtilCrc16Final(uint16_t crc);
+LIBOPENBLT_EXPORT uint16_t BltUtilCrc16Combine(uint16_t crc1, uint16_t crc2,
+                                               uint32_t len2);
+LIBOPENBLT_EXPORT uint32_t BltUtilCrc32Init(void);
+LIBOPENBLT_EXPORT uint32_t BltUtilCrc32Update(uint32_t crc, uint8_t const * data,
+                                              uint32_t len);
+LIBOPENBLT_EXPORT uint32_t BltUtilCrc32Final(uint32_t crc);
+LIBOPENBLT_EXPORT uint32_t BltUtilCrc32Combine(uint32_t crc1, uint32_t crc2,
+                                               uint32_t len2);
 LIBOPENBLT_EXPORT uint32_t BltUtilTimeGetSystemTime(void);
+LIBOPENBLT_EXPORT uint64_t BltUtilTimeGetMonotonicUs(void);
 LIBOPENBLT_EXPORT void BltUtilTimeDelayMs(uint16_t delay);
 LIBOPENBLT_EXPORT uint32_t BltUtilCryptoAes256Encrypt(uint8_t * data, uint32_t len,
                                                       uint8_t const * key);
 LIBOPENBLT_EXPORT uint32_t BltUtilCryptoAes256Decrypt(uint8_t * data, uint32_t len,
                                                       uint8_t const * key);
+LIBOPENBLT_EXPORT tBltAes256Handle BltUtilCryptoAes256Create(uint8_t const * key);
+LIBOPENBLT_EXPORT void BltUtilCryptoAes256Destroy(tBltAes256Handle crypto);
+LIBOPENBLT_EXPORT uint32_t BltUtilCryptoAes256HandleEncrypt(tBltAes256Handle crypto,
+                                                            uint8_t * data,
+                                                            uint32_t len);
+LIBOPENBLT_EXPORT uint32_t BltUtilCryptoAes256HandleDecrypt(tBltAes256Handle crypto,
+                                                            uint8_t * data,
+                                                            uint32_t len);
 
 
 #ifdef __cplusplus
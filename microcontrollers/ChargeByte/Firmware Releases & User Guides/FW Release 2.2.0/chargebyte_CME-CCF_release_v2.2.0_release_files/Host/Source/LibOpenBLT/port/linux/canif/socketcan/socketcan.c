@@ -37,20 +37,61 @@
 #include <stdbool.h>                        /* for boolean type                        */
 #include <stdlib.h>                         /* for standard library                    */
 #include <string.h>                         /* for string library                      */
+#include <errno.h>                          /* for error numbers                       */
+#include <time.h>                           /* for clock functions                     */
 #include <pthread.h>                        /* for posix threads                       */
 #include <unistd.h>                         /* UNIX standard functions                 */
 #include <fcntl.h>                          /* file control operations                 */
+#include <poll.h>                           /* for polling file descriptors            */
 #include <sys/time.h>                       /* time definitions                        */
+#include <sys/socket.h>                     /* for sockets                             */
 #include <sys/ioctl.h>                      /* I/O control operations                  */
 #include <net/if.h>                         /* network interfaces                      */
 #include <linux/can.h>                      /* CAN kernel definitions                  */
 #include <linux/can/raw.h>                  /* CAN raw sockets                         */
 #include <linux/can/error.h>                /* CAN errors                              */
+#include <linux/net_tstamp.h>               /* for time stamping flags                 */
+#include <linux/errqueue.h>                 /* for time stamping control messages      */
 #include "util.h"                           /* Utility module                          */
 #include "candriver.h"                      /* Generic CAN driver module               */
 #include "socketcan.h"                      /* SocketCAN interface                     */
 
 
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Maximum time in milliseconds to wait for space in the transmit queue of the
+ *         CAN network interface, before giving up on transmitting a frame.
+ */
+#define SOCKETCAN_TX_TIMEOUT_MS        (100u)
+
+/** \brief Maximum number of transmitted CAN frames that can wait for their transmission
+ *         time stamp from the kernel.
+ */
+#define SOCKETCAN_TX_PENDING_MAX       (64u)
+
+/** \brief Maximum time in microseconds to wait for the transmission time stamp of a CAN
+ *         frame. When it did not arrive in time, the frame is completed with the time at
+ *         which it was handed over to the kernel.
+ */
+#define SOCKETCAN_TX_TSTAMP_TIMEOUT_US (10000u)
+
+/** \brief Number of consecutive CAN frames whose transmission time stamp did not arrive
+ *         in time, after which the CAN network interface is assumed to not support
+ *         transmission time stamps. Waiting for them is resumed as soon as one arrives.
+ */
+#define SOCKETCAN_TX_TSTAMP_MISSES_MAX (8u)
+
+/** \brief Maximum difference in microseconds between a hardware and a software time
+ *         stamp, for the hardware time stamp to be considered synchronized with the
+ *         system time.
+ */
+#define SOCKETCAN_HW_TSTAMP_MAX_DEV_US (1000000u)
+
+/** \brief Size of the buffer for receiving control messages, such as time stamps. */
+#define SOCKETCAN_CTRL_BUF_SIZE        (256u)
+
+
 /****************************************************************************************
 * Type definitions
 ****************************************************************************************/
@@ -61,6 +102,14 @@ typedef struct t_socket_can_thread_ctrl
   bool terminated;                          /**< handshake flag.                       */
 } tSocketCanThreadCtrl;
 
+/** \brief Transmitted CAN message that waits for its transmission time stamp. */
+typedef struct t_socket_can_tx_pending
+{
+  tCanMsg msg;                              /**< transmitted CAN message.              */
+  uint32_t seqNr;                           /**< sequence number of the transmission.  */
+  bool submitted;                           /**< handed over to the kernel.            */
+} tSocketCanTxPending;
+
 
 /***************************************************************************************
 * Function prototypes
@@ -73,6 +122,25 @@ static void SocketCanDisconnect(void);
 static bool SocketCanTransmit(tCanMsg const * msg);
 static bool SocketCanIsBusError(void);
 static void SocketCanRegisterEvents(tCanEvents const * events);
+static void SocketCanSetRxFilters(uint32_t const * ids, uint32_t count);
+/* Transmit functions. */
+static bool SocketCanTxSendFrame(struct can_frame const * frame);
+static void SocketCanTxWaitFrameGap(void);
+static uint32_t SocketCanTxPendingAdd(tCanMsg const * msg);
+static void SocketCanTxPendingSubmitted(uint32_t seqNr, bool submitted,
+                                        uint64_t submitTime);
+static bool SocketCanTxPendingTake(tCanMsg const * txedMsg, tCanMsg * msg);
+static bool SocketCanTxPendingTakeExpired(uint64_t submitTimeMax, tCanMsg * msg);
+static void SocketCanTxPendingRemove(uint32_t idx);
+static void SocketCanTxPendingFlush(void);
+/* Time stamping functions. */
+static ssize_t SocketCanReceive(struct can_frame * frame, int flags, uint64_t * timestamp);
+static uint64_t SocketCanGetTimestamp(struct msghdr * msgHdr);
+static void SocketCanProcessTxTimestamps(void);
+/* Event functions. */
+static void SocketCanTriggerMsgTxed(tCanMsg const * msg);
+/* Reception acceptance filter functions. */
+static bool SocketCanApplyRxFilters(void);
 /* Event thread functions. */
 static bool  SocketCanStartEventThread(void);
 static void  SocketCanStopEventThread(void);
@@ -91,7 +159,8 @@ static const tCanInterface socketCanInterface =
   SocketCanDisconnect,
   SocketCanTransmit,
   SocketCanIsBusError,
-  SocketCanRegisterEvents
+  SocketCanRegisterEvents,
+  SocketCanSetRxFilters
 };
 
 
@@ -108,11 +177,12 @@ static volatile tCanEvents * socketCanEventsList;
 static volatile uint32_t socketCanEventsEntries;
 
 /** \brief Flag to set in the event thread when either a bus off or bus heavy situation
- *
+ *         is detected. It is shared with the event thread, but only ever accessed with
+ *         atomic operations, so no critical section is needed to protect it.
  */
 static volatile bool socketCanErrorDetected;
 
-/** \brief Event thread control. */
+/** \brief Event thread control. Its flags are only accessed with atomic operations. */
 static volatile tSocketCanThreadCtrl eventThreadCtrl;
 
 /** \brief The ID of the event thread. */
@@ -121,6 +191,59 @@ static pthread_t eventThreadId;
 /** \brief CAN raw socket. */
 static volatile int32_t canSocket;
 
+/** \brief Flag to keep track of the socket being connected. */
+static bool socketCanConnected;
+
+/** \brief List with reception acceptance filters, one for each CAN identifier that
+ *         should be received. All users of the CAN interface share the same socket, so
+ *         this list contains the CAN identifiers of all of them.
+ */
+static struct can_filter * socketCanRxFilters;
+
+/** \brief Total number of entries in the \ref socketCanRxFilters list. */
+static uint32_t socketCanRxFilterCount;
+
+/** \brief Time at which the last CAN frame was handed over to the kernel. Needed for
+ *         pacing the frames, when a minimum gap between frames is configured. It is
+ *         protected by \ref socketCanTxCritSect.
+ */
+static struct timespec socketCanLastTxTime;
+
+/** \brief Flag to keep track of the kernel delivering transmission time stamps. It is
+ *         shared with the event thread, but only ever accessed with atomic operations.
+ */
+static volatile bool socketCanTxTimestamping;
+
+/** \brief Number of consecutive CAN frames whose transmission time stamp did not
+ *         arrive in time. Only accessed by the event thread, apart from the reset when
+ *         connecting.
+ */
+static uint32_t socketCanTxTstampMisses;
+
+/** \brief List with the transmitted CAN messages that wait for their transmission time
+ *         stamp, ordered from oldest to newest. Until it arrives, the timestamp field
+ *         holds the time at which the message was handed over to the kernel.
+ */
+static tSocketCanTxPending socketCanTxPending[SOCKETCAN_TX_PENDING_MAX];
+
+/** \brief Total number of entries in the \ref socketCanTxPending list. */
+static uint32_t socketCanTxPendingCount;
+
+/** \brief Sequence number for the next entry in the \ref socketCanTxPending list. */
+static uint32_t socketCanTxPendingSeqNr;
+
+/** \brief Critical section object that protects the \ref socketCanTxPending list, which
+ *         is shared with the event thread.
+ */
+static tUtilCriticalSection socketCanTxPendingCritSect;
+
+/** \brief Critical section object that serializes the transmit path. Multiple sessions
+ *         can transmit on the CAN interface at the same time. It is held while pacing
+ *         and handing over a frame to the kernel, so that the frame gap applies to all
+ *         frames and the pending transmissions are queued in the order of transmission.
+ */
+static tUtilCriticalSection socketCanTxCritSect;
+
 
 /***********************************************************************************//**
 ** \brief     Obtains a pointer to the CAN interface structure, so that it can be linked
@@ -149,15 +272,29 @@ static void SocketCanInit(tCanSettings const * settings)
   socketCanEventsList = NULL;
   socketCanEventsEntries = 0;
   socketCanErrorDetected = false;
+  socketCanConnected = false;
+  socketCanRxFilters = NULL;
+  socketCanRxFilterCount = 0;
   /* Reset CAN interface settings. */
   socketCanSettings.devicename = "";
   socketCanSettings.channel = 0;
   socketCanSettings.baudrate = CAN_BR500K;
   socketCanSettings.code = 0x00000000u;
   socketCanSettings.mask = 0x00000000u;
-
-  /* Initialize the critical section module. */
-  UtilCriticalSectionInit();
+  socketCanSettings.txFrameGap = 0;
+  socketCanLastTxTime.tv_sec = 0;
+  socketCanLastTxTime.tv_nsec = 0;
+  socketCanTxTimestamping = false;
+  socketCanTxTstampMisses = 0;
+  socketCanTxPendingCount = 0;
+  socketCanTxPendingSeqNr = 0;
+  /* Create the critical section objects for the transmit path and for protecting the
+   * pending transmissions.
+   */
+  socketCanTxCritSect = UtilCriticalSectionCreate();
+  assert(socketCanTxCritSect != NULL);
+  socketCanTxPendingCritSect = UtilCriticalSectionCreate();
+  assert(socketCanTxPendingCritSect != NULL);
 
   /* Check parameters. */
   assert(settings != NULL);
@@ -202,14 +339,25 @@ static void SocketCanTerminate(void)
   socketCanSettings.baudrate = CAN_BR500K;
   socketCanSettings.code = 0x00000000u;
   socketCanSettings.mask = 0x00000000u;
+  socketCanSettings.txFrameGap = 0;
   /* Release memory that was allocated for CAN events and reset the entry count. */
   if ( (socketCanEventsList != NULL) && (socketCanEventsEntries != 0) )
   {
     free((void *)socketCanEventsList);
     socketCanEventsEntries = 0;
   }
-  /* Terminate the critical section module. */
-  UtilCriticalSectionTerminate();
+  /* Release memory that was allocated for the reception acceptance filter list. */
+  if (socketCanRxFilters != NULL)
+  {
+    free(socketCanRxFilters);
+    socketCanRxFilters = NULL;
+  }
+  socketCanRxFilterCount = 0;
+  /* Destroy the critical section objects. */
+  UtilCriticalSectionDestroy(socketCanTxPendingCritSect);
+  socketCanTxPendingCritSect = NULL;
+  UtilCriticalSectionDestroy(socketCanTxCritSect);
+  socketCanTxCritSect = NULL;
 } /*** end of SocketCanTerminate ***/
 
 
@@ -226,11 +374,11 @@ static bool SocketCanConnect(void)
   struct sockaddr_can addr;
   struct ifreq ifr;
   int32_t flags;
-  struct can_filter rxFilter;
   can_err_mask_t errMask;
+  int tsFlags;
 
   /* Reset the error flag. */
-  socketCanErrorDetected = false;
+  __atomic_store_n(&socketCanErrorDetected, false, __ATOMIC_RELEASE);
 
   /* Check settings. */
   assert(socketCanSettings.devicename != NULL);
@@ -290,27 +438,10 @@ static bool SocketCanConnect(void)
       }
     }
 
-    /* Configure reception acceptance filter, if it is not supposed to be fully open. */
-    if ( (result) && (socketCanSettings.mask != 0x00000000u) )
+    /* Configure the reception acceptance filter. */
+    if (result)
     {
-      /* Configure reception acceptance filter. The CAN_MSG_EXT_ID_MASK-bit from
-       * the CAN driver is currently the same as the CAN_EFF_FLAG-bit from SocketCAN.
-       * However, we don't know if this gets changed in the future in SocketCAN so
-       * process this bit manually.
-       */
-      rxFilter.can_id = socketCanSettings.code;
-      if ((rxFilter.can_id & CAN_MSG_EXT_ID_MASK) != 0)
-      {
-        rxFilter.can_id &= ~CAN_MSG_EXT_ID_MASK;
-        rxFilter.can_id |= CAN_EFF_FLAG;
-      }
-      rxFilter.can_mask = socketCanSettings.mask;
-      if ((rxFilter.can_mask & CAN_MSG_EXT_ID_MASK) != 0)
-      {
-        rxFilter.can_mask &= ~CAN_MSG_EXT_ID_MASK;
-        rxFilter.can_mask |= CAN_EFF_FLAG;
-      }
-      if (setsockopt(canSocket, SOL_CAN_RAW, CAN_RAW_FILTER, &rxFilter, sizeof(rxFilter)) != 0)
+      if (!SocketCanApplyRxFilters())
       {
         close(canSocket);
         result = false;
@@ -328,6 +459,28 @@ static bool SocketCanConnect(void)
       }
     }
 
+    /* Configure time stamping of received and transmitted CAN frames by the kernel and,
+     * if supported, by the CAN controller. Not all CAN network interfaces support this,
+     * so it is not treated as an error, if it cannot be enabled. The transmission time
+     * stamps come with a copy of the transmitted frame, which is needed to find the
+     * pending transmission that they belong to.
+     */
+    if (result)
+    {
+      socketCanTxTstampMisses = 0;
+      tsFlags = (SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_TX_SOFTWARE |
+                 SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_TX_HARDWARE |
+                 SOF_TIMESTAMPING_SOFTWARE | SOF_TIMESTAMPING_RAW_HARDWARE);
+      if (setsockopt(canSocket, SOL_SOCKET, SO_TIMESTAMPING, &tsFlags, sizeof(tsFlags)) == 0)
+      {
+        __atomic_store_n(&socketCanTxTimestamping, true, __ATOMIC_RELEASE);
+      }
+      else
+      {
+        __atomic_store_n(&socketCanTxTimestamping, false, __ATOMIC_RELEASE);
+      }
+    }
+
     if (result)
     {
       /* Start the event thread. */
@@ -337,6 +490,9 @@ static bool SocketCanConnect(void)
         result = false;
       }
     }
+
+    /* Update the connection state. */
+    socketCanConnected = result;
   }
   /* Give the result back to the caller. */
   return result;
@@ -353,6 +509,9 @@ static void SocketCanDisconnect(void)
   SocketCanStopEventThread();
   /* Close the socket. */
   close(canSocket);
+  socketCanConnected = false;
+  /* Complete the transmissions that still wait for their time stamp. */
+  SocketCanTxPendingFlush();
   /* Reset the error flag. */
   socketCanErrorDetected = false;
 } /*** end of SocketCanDisconnect ***/
@@ -368,7 +527,9 @@ static bool SocketCanTransmit(tCanMsg const * msg)
 {
   bool result = false;
   struct can_frame canTxFrame;
-  tCanEvents volatile const * pEvents;
+  tCanMsg txMsg;
+  bool txPending;
+  uint32_t seqNr = 0;
 
   /* Check parameters. */
   assert(msg != NULL);
@@ -377,6 +538,7 @@ static bool SocketCanTransmit(tCanMsg const * msg)
   if (msg != NULL) /*lint !e774 */
   {
     /* Construct the message frame. */
+    memset(&canTxFrame, 0, sizeof(canTxFrame));
     canTxFrame.can_id = msg->id;
     if ((msg->id & CAN_MSG_EXT_ID_MASK) != 0)
     {
@@ -389,30 +551,331 @@ static bool SocketCanTransmit(tCanMsg const * msg)
       canTxFrame.data[idx] = msg->data[idx];
     }
 
+    UtilCriticalSectionLock(socketCanTxCritSect);
+    /* If the kernel delivers transmission time stamps, the transmit complete event is
+     * postponed until the event thread received it. The message is added to the pending
+     * transmissions before the frame is handed over to the kernel, because its time
+     * stamp can arrive before the system call returns.
+     */
+    txMsg = *msg;
+    txMsg.timestamp = UtilTimeGetSystemTimeUs();
+    txPending = __atomic_load_n(&socketCanTxTimestamping, __ATOMIC_ACQUIRE);
+    if (txPending)
+    {
+      seqNr = SocketCanTxPendingAdd(&txMsg);
+    }
     /* Submit the frame for transmission. */
-    if (write(canSocket, &canTxFrame,  sizeof(struct can_frame)) == (ssize_t)sizeof(struct can_frame))
+    result = SocketCanTxSendFrame(&canTxFrame);
+    /* Time stamp the message with the submission time, in case its transmission time
+     * stamp does not arrive. Remove it again from the pending transmissions if it could
+     * not be submitted.
+     */
+    txMsg.timestamp = UtilTimeGetSystemTimeUs();
+    if (txPending)
     {
-      /* Update result value to success. */
-      result = true;
-      /* Trigger transmit complete event(s). */
-      pEvents = socketCanEventsList;
-      for (uint32_t idx = 0; idx < socketCanEventsEntries; idx++)
+      SocketCanTxPendingSubmitted(seqNr, result, txMsg.timestamp);
+    }
+    UtilCriticalSectionUnlock(socketCanTxCritSect);
+    /* Trigger the transmit complete event outside of the critical section. */
+    if ( (result) && (!txPending) )
+    {
+      SocketCanTriggerMsgTxed(&txMsg);
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of SocketCanTransmit ***/
+
+
+/************************************************************************************//**
+** \brief     Hands a frame over to the kernel, after waiting for the configured minimum
+**            gap between frames. When the transmit queue of the CAN network interface
+**            is full, the kernel reports ENOBUFS or EAGAIN. This is not treated as an
+**            error. Instead this function backs off and retries, until the frame was
+**            accepted or until SOCKETCAN_TX_TIMEOUT_MS passed. The caller should hold
+**            \ref socketCanTxCritSect.
+** \param     frame Pointer to the CAN frame to submit.
+** \return    True if the frame was submitted, false otherwise.
+**
+****************************************************************************************/
+static bool SocketCanTxSendFrame(struct can_frame const * frame)
+{
+  bool result = false;
+  bool done = false;
+  ssize_t sendResult;
+  uint32_t waitTime = 0;
+  struct pollfd pollDesc;
+
+  /* Check parameters. */
+  assert(frame != NULL);
+
+  /* Only continue with valid parameters. */
+  if (frame != NULL) /*lint !e774 */
+  {
+    /* When pacing is configured, wait until the frame can be transmitted. */
+    if (socketCanSettings.txFrameGap > 0)
+    {
+      SocketCanTxWaitFrameGap();
+    }
+    /* Keep going until the frame is sent or an error occurred. */
+    while (!done)
+    {
+      sendResult = send(canSocket, frame, sizeof(struct can_frame), 0);
+      if (sendResult == (ssize_t)sizeof(struct can_frame))
       {
-        if (pEvents != NULL)
-        {
-          if (pEvents->MsgTxed != NULL)
-          {
-            pEvents->MsgTxed(msg);
-          }
-          /* Move on to the next entry in the list. */
-          pEvents++;
-        }
+        (void)clock_gettime(CLOCK_MONOTONIC, &socketCanLastTxTime);
+        result = true;
+        done = true;
+      }
+      /* Is the transmit queue of the CAN network interface full? */
+      else if ( (sendResult < 0) &&
+                ( (errno == ENOBUFS) || (errno == EAGAIN) || (errno == EWOULDBLOCK) ||
+                  (errno == EINTR) ) && (waitTime < SOCKETCAN_TX_TIMEOUT_MS) )
+      {
+        /* Wait for the socket to become writable again. Note that the kernel does not
+         * signal this when the network interface's queue is full (ENOBUFS), so the
+         * timeout doubles as a back off time in that case.
+         */
+        pollDesc.fd = canSocket;
+        pollDesc.events = POLLOUT;
+        pollDesc.revents = 0;
+        (void)poll(&pollDesc, 1, 1);
+        waitTime++;
+      }
+      /* Any other error is fatal, just like running out of time. */
+      else
+      {
+        done = true;
       }
     }
   }
   /* Give the result back to the caller. */
   return result;
-} /*** end of SocketCanTransmit ***/
+} /*** end of SocketCanTxSendFrame ***/
+
+
+/************************************************************************************//**
+** \brief     Waits until the configured minimum gap between transmitted frames passed
+**            since the last frame was handed over to the kernel.
+**
+****************************************************************************************/
+static void SocketCanTxWaitFrameGap(void)
+{
+  struct timespec nextTxTime;
+
+  /* Calculate the earliest time that the next frame can be transmitted. */
+  nextTxTime.tv_sec = socketCanLastTxTime.tv_sec +
+                      (time_t)(socketCanSettings.txFrameGap / 1000000u);
+  nextTxTime.tv_nsec = socketCanLastTxTime.tv_nsec +
+                       (long)((socketCanSettings.txFrameGap % 1000000u) * 1000u);
+  if (nextTxTime.tv_nsec >= 1000000000L)
+  {
+    nextTxTime.tv_sec++;
+    nextTxTime.tv_nsec -= 1000000000L;
+  }
+  /* Sleep until that time. Note that this returns right away if the time already
+   * passed.
+   */
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &nextTxTime, NULL) == EINTR)
+  {
+    /* Interrupted by a signal, so just continue sleeping. */
+  }
+} /*** end of SocketCanTxWaitFrameGap ***/
+
+
+/************************************************************************************//**
+** \brief     Adds a message to the list with messages that wait for their transmission
+**            time stamp. If the list is full, the oldest message is completed right away
+**            without time stamp from the kernel.
+** \param     msg Pointer to the CAN message that is about to be handed over to the
+**            kernel.
+** \return    Sequence number of the entry, for \ref SocketCanTxPendingSubmitted.
+**
+****************************************************************************************/
+static uint32_t SocketCanTxPendingAdd(tCanMsg const * msg)
+{
+  uint32_t result = 0;
+  tCanMsg oldestMsg;
+  bool overflow = false;
+
+  /* Check parameters. */
+  assert(msg != NULL);
+
+  /* Only continue with valid parameters. */
+  if (msg != NULL) /*lint !e774 */
+  {
+    UtilCriticalSectionLock(socketCanTxPendingCritSect);
+    /* Make room by removing the oldest entry, if the list is full. */
+    if (socketCanTxPendingCount == SOCKETCAN_TX_PENDING_MAX)
+    {
+      oldestMsg = socketCanTxPending[0].msg;
+      SocketCanTxPendingRemove(0);
+      overflow = true;
+    }
+    /* Store the message at the end of the list. */
+    result = socketCanTxPendingSeqNr++;
+    socketCanTxPending[socketCanTxPendingCount].msg = *msg;
+    socketCanTxPending[socketCanTxPendingCount].seqNr = result;
+    socketCanTxPending[socketCanTxPendingCount].submitted = false;
+    socketCanTxPendingCount++;
+    UtilCriticalSectionUnlock(socketCanTxPendingCritSect);
+    /* Complete the removed entry outside of the critical section. */
+    if (overflow)
+    {
+      SocketCanTriggerMsgTxed(&oldestMsg);
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of SocketCanTxPendingAdd ***/
+
+
+/************************************************************************************//**
+** \brief     Updates a message in the list with messages that wait for their
+**            transmission time stamp, after trying to hand it over to the kernel. Note
+**            that the entry is no longer there if its time stamp already arrived.
+** \param     seqNr Sequence number of the entry.
+** \param     submitted True if the message was handed over to the kernel. False if
+**            that failed, in which case the entry is removed.
+** \param     submitTime Time in microseconds at which the message was handed over to the
+**            kernel.
+**
+****************************************************************************************/
+static void SocketCanTxPendingSubmitted(uint32_t seqNr, bool submitted,
+                                        uint64_t submitTime)
+{
+  UtilCriticalSectionLock(socketCanTxPendingCritSect);
+  /* Search from the end, because it is most likely the newest entry. */
+  for (uint32_t idx = socketCanTxPendingCount; idx > 0; idx--)
+  {
+    if (socketCanTxPending[idx - 1u].seqNr == seqNr)
+    {
+      if (submitted)
+      {
+        socketCanTxPending[idx - 1u].msg.timestamp = submitTime;
+        socketCanTxPending[idx - 1u].submitted = true;
+      }
+      else
+      {
+        SocketCanTxPendingRemove(idx - 1u);
+      }
+      break;
+    }
+  }
+  UtilCriticalSectionUnlock(socketCanTxPendingCritSect);
+} /*** end of SocketCanTxPendingSubmitted ***/
+
+
+/************************************************************************************//**
+** \brief     Takes the message that a transmission time stamp belongs to from the list
+**            with messages that wait for their transmission time stamp. This is the
+**            oldest message with the same identifier and data as the transmitted frame
+**            that the kernel returned together with the time stamp.
+** \param     txedMsg Pointer to the transmitted frame from the kernel, converted to a
+**            CAN message. Use NULL to take the oldest message.
+** \param     msg Pointer where the message is stored.
+** \return    True if a message was taken, false otherwise.
+**
+****************************************************************************************/
+static bool SocketCanTxPendingTake(tCanMsg const * txedMsg, tCanMsg * msg)
+{
+  bool result = false;
+  tCanMsg const * pendingMsg;
+
+  /* Check parameters. */
+  assert(msg != NULL);
+
+  /* Only continue with valid parameters. */
+  if (msg != NULL) /*lint !e774 */
+  {
+    UtilCriticalSectionLock(socketCanTxPendingCritSect);
+    for (uint32_t idx = 0; idx < socketCanTxPendingCount; idx++)
+    {
+      pendingMsg = &socketCanTxPending[idx].msg;
+      if ( (txedMsg == NULL) ||
+           ( (pendingMsg->id == txedMsg->id) && (pendingMsg->dlc == txedMsg->dlc) &&
+             (memcmp(pendingMsg->data, txedMsg->data, txedMsg->dlc) == 0) ) )
+      {
+        *msg = *pendingMsg;
+        SocketCanTxPendingRemove(idx);
+        result = true;
+        break;
+      }
+    }
+    UtilCriticalSectionUnlock(socketCanTxPendingCritSect);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of SocketCanTxPendingTake ***/
+
+
+/************************************************************************************//**
+** \brief     Takes the oldest message from the list with messages that wait for their
+**            transmission time stamp, if it waited too long.
+** \param     submitTimeMax Only take the message if it was handed over to the kernel at
+**            or before this time in microseconds.
+** \param     msg Pointer where the message is stored.
+** \return    True if a message was taken, false otherwise.
+**
+****************************************************************************************/
+static bool SocketCanTxPendingTakeExpired(uint64_t submitTimeMax, tCanMsg * msg)
+{
+  bool result = false;
+
+  /* Check parameters. */
+  assert(msg != NULL);
+
+  /* Only continue with valid parameters. */
+  if (msg != NULL) /*lint !e774 */
+  {
+    UtilCriticalSectionLock(socketCanTxPendingCritSect);
+    /* A message that is still being handed over to the kernel did not expire yet. */
+    if ( (socketCanTxPendingCount > 0) && (socketCanTxPending[0].submitted) &&
+         (socketCanTxPending[0].msg.timestamp <= submitTimeMax) )
+    {
+      *msg = socketCanTxPending[0].msg;
+      SocketCanTxPendingRemove(0);
+      result = true;
+    }
+    UtilCriticalSectionUnlock(socketCanTxPendingCritSect);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of SocketCanTxPendingTakeExpired ***/
+
+
+/************************************************************************************//**
+** \brief     Removes an entry from the list with messages that wait for their
+**            transmission time stamp. The caller should hold
+**            \ref socketCanTxPendingCritSect.
+** \param     idx Index of the entry in the list.
+**
+****************************************************************************************/
+static void SocketCanTxPendingRemove(uint32_t idx)
+{
+  if (idx < socketCanTxPendingCount)
+  {
+    socketCanTxPendingCount--;
+    memmove(&socketCanTxPending[idx], &socketCanTxPending[idx + 1u],
+            (socketCanTxPendingCount - idx) * sizeof(socketCanTxPending[0]));
+  }
+} /*** end of SocketCanTxPendingRemove ***/
+
+
+/************************************************************************************//**
+** \brief     Completes all messages that still wait for their transmission time stamp,
+**            using the time at which they were handed over to the kernel.
+**
+****************************************************************************************/
+static void SocketCanTxPendingFlush(void)
+{
+  tCanMsg txMsg;
+
+  while (SocketCanTxPendingTake(NULL, &txMsg))
+  {
+    SocketCanTriggerMsgTxed(&txMsg);
+  }
+} /*** end of SocketCanTxPendingFlush ***/
 
 
 /************************************************************************************//**
@@ -424,16 +887,12 @@ static bool SocketCanIsBusError(void)
 {
   bool result= false;
 
-  /* Read flag to detect bus off or bus heavy. */
-  UtilCriticalSectionEnter();
-  if (socketCanErrorDetected)
+  /* Read and reset the flag to detect bus off or bus heavy in one atomic operation. */
+  if (__atomic_exchange_n(&socketCanErrorDetected, false, __ATOMIC_ACQ_REL))
   {
     /* Update result. */
     result = true;
-    /* Reset the error flag. */
-    socketCanErrorDetected = false;
   }
-  UtilCriticalSectionExit();
 
   /* Give the result back to the caller. */
   return result;
@@ -480,6 +939,311 @@ static void SocketCanRegisterEvents(tCanEvents const * events)
 } /*** end of SocketCanRegisterEvents ***/
 
 
+/************************************************************************************//**
+** \brief     Configures the list of CAN identifiers that should be received. It
+**            replaces the reception acceptance filter from the settings with one exact
+**            match filter for each CAN identifier. The kernel then already drops all
+**            other CAN messages, before they ever reach the socket's receive buffer.
+** \param     ids Array with CAN identifiers. Note that \ref CAN_MSG_EXT_ID_MASK is set
+**            for 29-bit CAN identifiers.
+** \param     count Number of entries in the array.
+**
+****************************************************************************************/
+static void SocketCanSetRxFilters(uint32_t const * ids, uint32_t count)
+{
+  struct can_filter * newFilters = NULL;
+
+  /* Check parameters. */
+  assert( (ids != NULL) || (count == 0) );
+
+  /* Only continue with valid parameters. */
+  if ( (ids != NULL) || (count == 0) ) /*lint !e774 */
+  {
+    /* Allocate memory for the new filter list. */
+    if (count > 0)
+    {
+      newFilters = malloc(sizeof(struct can_filter) * count);
+      assert(newFilters != NULL);
+    }
+    /* Only continue if the allocation was successful. */
+    if ( (newFilters != NULL) || (count == 0) )
+    {
+      /* Convert the CAN identifiers to exact match filters. The CAN_MSG_EXT_ID_MASK-bit
+       * from the CAN driver is processed manually, same as with the filter from the
+       * settings.
+       */
+      for (uint32_t idx = 0; idx < count; idx++)
+      {
+        if ((ids[idx] & CAN_MSG_EXT_ID_MASK) != 0)
+        {
+          newFilters[idx].can_id = (ids[idx] & CAN_EFF_MASK) | CAN_EFF_FLAG;
+          newFilters[idx].can_mask = CAN_EFF_MASK | CAN_EFF_FLAG | CAN_RTR_FLAG;
+        }
+        else
+        {
+          newFilters[idx].can_id = ids[idx] & CAN_SFF_MASK;
+          newFilters[idx].can_mask = CAN_SFF_MASK | CAN_EFF_FLAG | CAN_RTR_FLAG;
+        }
+      }
+      /* Replace the old filter list. */
+      if (socketCanRxFilters != NULL)
+      {
+        free(socketCanRxFilters);
+      }
+      socketCanRxFilters = newFilters;
+      socketCanRxFilterCount = count;
+      /* Apply the new filter list right away, if the socket is already connected. */
+      if (socketCanConnected)
+      {
+        (void)SocketCanApplyRxFilters();
+      }
+    }
+  }
+} /*** end of SocketCanSetRxFilters ***/
+
+
+/************************************************************************************//**
+** \brief     Configures the reception acceptance filter on the socket. This is the
+**            filter list, if one was set. Otherwise it is the filter from the settings.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+static bool SocketCanApplyRxFilters(void)
+{
+  bool result = false;
+  struct can_filter rxFilter;
+
+  /* Configure all filters from the list with one system call, if one was set. */
+  if (socketCanRxFilterCount > 0)
+  {
+    if (setsockopt(canSocket, SOL_CAN_RAW, CAN_RAW_FILTER, socketCanRxFilters,
+                   (socklen_t)(sizeof(struct can_filter) * socketCanRxFilterCount)) == 0)
+    {
+      result = true;
+    }
+  }
+  /* Otherwise configure the reception acceptance filter from the settings. Note that a
+   * mask of all zeroes results in a fully open filter.
+   */
+  else
+  {
+    /* Configure reception acceptance filter. The CAN_MSG_EXT_ID_MASK-bit from
+     * the CAN driver is currently the same as the CAN_EFF_FLAG-bit from SocketCAN.
+     * However, we don't know if this gets changed in the future in SocketCAN so
+     * process this bit manually.
+     */
+    rxFilter.can_id = socketCanSettings.code;
+    if ((rxFilter.can_id & CAN_MSG_EXT_ID_MASK) != 0)
+    {
+      rxFilter.can_id &= ~CAN_MSG_EXT_ID_MASK;
+      rxFilter.can_id |= CAN_EFF_FLAG;
+    }
+    rxFilter.can_mask = socketCanSettings.mask;
+    if ((rxFilter.can_mask & CAN_MSG_EXT_ID_MASK) != 0)
+    {
+      rxFilter.can_mask &= ~CAN_MSG_EXT_ID_MASK;
+      rxFilter.can_mask |= CAN_EFF_FLAG;
+    }
+    if (setsockopt(canSocket, SOL_CAN_RAW, CAN_RAW_FILTER, &rxFilter, sizeof(rxFilter)) == 0)
+    {
+      result = true;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of SocketCanApplyRxFilters ***/
+
+
+/************************************************************************************//**
+** \brief     Reads a CAN frame from the socket, together with its time stamp.
+** \param     frame Pointer where the CAN frame is stored.
+** \param     flags Flags for recvmsg. Use MSG_ERRQUEUE to read transmission time stamps
+**            from the socket's error queue.
+** \param     timestamp Pointer where the time stamp in microseconds is stored. It is set
+**            to 0 if no time stamp is available.
+** \return    Number of bytes read, or -1 if nothing was read.
+**
+****************************************************************************************/
+static ssize_t SocketCanReceive(struct can_frame * frame, int flags, uint64_t * timestamp)
+{
+  ssize_t result = -1;
+  struct iovec ioVec;
+  struct msghdr msgHdr;
+  union
+  {
+    struct cmsghdr align;
+    uint8_t data[SOCKETCAN_CTRL_BUF_SIZE];
+  } ctrlBuf;
+
+  /* Check parameters. */
+  assert(frame != NULL);
+  assert(timestamp != NULL);
+
+  /* Only continue with valid parameters. */
+  if ( (frame != NULL) && (timestamp != NULL) ) /*lint !e774 */
+  {
+    /* Prepare the message header. */
+    ioVec.iov_base = frame;
+    ioVec.iov_len = sizeof(struct can_frame);
+    memset(&msgHdr, 0, sizeof(msgHdr));
+    msgHdr.msg_iov = &ioVec;
+    msgHdr.msg_iovlen = 1;
+    msgHdr.msg_control = ctrlBuf.data;
+    msgHdr.msg_controllen = sizeof(ctrlBuf.data);
+    /* Read the frame and extract its time stamp from the control messages. */
+    result = recvmsg(canSocket, &msgHdr, flags | MSG_DONTWAIT);
+    *timestamp = (result >= 0) ? SocketCanGetTimestamp(&msgHdr) : 0;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of SocketCanReceive ***/
+
+
+/************************************************************************************//**
+** \brief     Extracts the time stamp from the control messages of a received message.
+**            The hardware time stamp of the CAN controller is preferred. It is however
+**            only used if the controller's clock is synchronized with the system time,
+**            because it is compared with time stamps taken by the host. Otherwise the
+**            software time stamp of the kernel is used.
+** \param     msgHdr Pointer to the message header of the received message.
+** \return    Time stamp in microseconds since the epoch or 0 if not available.
+**
+****************************************************************************************/
+static uint64_t SocketCanGetTimestamp(struct msghdr * msgHdr)
+{
+  uint64_t result = 0;
+  struct cmsghdr * cmsg;
+  struct scm_timestamping timestamps;
+  uint64_t swTime;
+  uint64_t hwTime;
+
+  /* Check parameters. */
+  assert(msgHdr != NULL);
+
+  /* Only continue with valid parameters. */
+  if (msgHdr != NULL) /*lint !e774 */
+  {
+    for (cmsg = CMSG_FIRSTHDR(msgHdr); cmsg != NULL; cmsg = CMSG_NXTHDR(msgHdr, cmsg))
+    {
+      if ( (cmsg->cmsg_level == SOL_SOCKET) && (cmsg->cmsg_type == SCM_TIMESTAMPING) )
+      {
+        /* Copy the time stamps, because the control message data is not aligned. */
+        memcpy(&timestamps, CMSG_DATA(cmsg), sizeof(timestamps));
+        swTime = ((uint64_t)timestamps.ts[0].tv_sec * 1000000ull) +
+                 ((uint64_t)timestamps.ts[0].tv_nsec / 1000ull);
+        hwTime = ((uint64_t)timestamps.ts[2].tv_sec * 1000000ull) +
+                 ((uint64_t)timestamps.ts[2].tv_nsec / 1000ull);
+        result = swTime;
+        /* Only use the hardware time stamp if it is close to the software time stamp. */
+        if ( (hwTime != 0) && (swTime != 0) &&
+             (((hwTime > swTime) ? (hwTime - swTime) : (swTime - hwTime)) <
+              SOCKETCAN_HW_TSTAMP_MAX_DEV_US) )
+        {
+          result = hwTime;
+        }
+      }
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of SocketCanGetTimestamp ***/
+
+
+/************************************************************************************//**
+** \brief     Processes the transmission time stamps in the socket's error queue. The
+**            kernel returns each time stamp together with a copy of the transmitted
+**            frame, which completes the oldest pending message with the same identifier
+**            and data. Messages that waited too long are completed with the time at
+**            which they were handed over to the kernel. If this happens for several
+**            messages in a row, the CAN network interface apparently does not support
+**            transmission time stamps, so no longer wait for them, until one arrives.
+**
+****************************************************************************************/
+static void SocketCanProcessTxTimestamps(void)
+{
+  struct can_frame canErrFrame;
+  ssize_t frameLen;
+  uint64_t timestamp;
+  tCanMsg txedMsg;
+  tCanMsg txMsg;
+  uint64_t now;
+
+  /* Match the time stamps from the error queue with the pending transmissions. */
+  while ((frameLen = SocketCanReceive(&canErrFrame, MSG_ERRQUEUE, &timestamp)) >= 0)
+  {
+    if (timestamp != 0)
+    {
+      /* The CAN network interface delivers transmission time stamps. */
+      socketCanTxTstampMisses = 0;
+      __atomic_store_n(&socketCanTxTimestamping, true, __ATOMIC_RELEASE);
+    }
+    /* Convert the transmitted frame, if the kernel returned it. Otherwise just take
+     * the oldest pending message.
+     */
+    if (frameLen == (ssize_t)sizeof(struct can_frame))
+    {
+      txedMsg.id = canErrFrame.can_id & ~(CAN_RTR_FLAG | CAN_ERR_FLAG);
+      if ((txedMsg.id & CAN_EFF_FLAG) != 0)
+      {
+        txedMsg.id &= ~CAN_EFF_FLAG;
+        txedMsg.id |= CAN_MSG_EXT_ID_MASK;
+      }
+      txedMsg.dlc = ((canErrFrame.can_dlc <= CAN_MSG_MAX_LEN) ? canErrFrame.can_dlc :
+                     CAN_MSG_MAX_LEN);
+      memcpy(txedMsg.data, canErrFrame.data, txedMsg.dlc);
+    }
+    if (SocketCanTxPendingTake((frameLen == (ssize_t)sizeof(struct can_frame)) ?
+                               &txedMsg : NULL, &txMsg))
+    {
+      if (timestamp != 0)
+      {
+        txMsg.timestamp = timestamp;
+      }
+      SocketCanTriggerMsgTxed(&txMsg);
+    }
+  }
+  /* Complete the pending transmissions that waited too long for their time stamp. */
+  now = UtilTimeGetSystemTimeUs();
+  if (now > SOCKETCAN_TX_TSTAMP_TIMEOUT_US)
+  {
+    while (SocketCanTxPendingTakeExpired(now - SOCKETCAN_TX_TSTAMP_TIMEOUT_US, &txMsg))
+    {
+      socketCanTxTstampMisses++;
+      if (socketCanTxTstampMisses >= SOCKETCAN_TX_TSTAMP_MISSES_MAX)
+      {
+        __atomic_store_n(&socketCanTxTimestamping, false, __ATOMIC_RELEASE);
+      }
+      SocketCanTriggerMsgTxed(&txMsg);
+    }
+  }
+} /*** end of SocketCanProcessTxTimestamps ***/
+
+
+/************************************************************************************//**
+** \brief     Triggers the transmit complete event(s) for a message.
+** \param     msg Pointer to the transmitted CAN message.
+**
+****************************************************************************************/
+static void SocketCanTriggerMsgTxed(tCanMsg const * msg)
+{
+  tCanEvents volatile const * pEvents;
+
+  pEvents = socketCanEventsList;
+  for (uint32_t idx = 0; idx < socketCanEventsEntries; idx++)
+  {
+    if (pEvents != NULL)
+    {
+      if (pEvents->MsgTxed != NULL)
+      {
+        pEvents->MsgTxed(msg);
+      }
+      /* Move on to the next entry in the list. */
+      pEvents++;
+    }
+  }
+} /*** end of SocketCanTriggerMsgTxed ***/
+
+
 /************************************************************************************//**
 ** \brief     Starts the event thread.
 ** \return    True if the thread was successfully started, false otherwise.
@@ -490,10 +1254,8 @@ static bool SocketCanStartEventThread(void)
   bool result = false;
 
   /* Prepare thread parameters. */
-  UtilCriticalSectionEnter();
-  eventThreadCtrl.terminate = false;
-  eventThreadCtrl.terminated = false;
-  UtilCriticalSectionExit();
+  __atomic_store_n(&eventThreadCtrl.terminate, false, __ATOMIC_RELEASE);
+  __atomic_store_n(&eventThreadCtrl.terminated, false, __ATOMIC_RELEASE);
   /* Create and start the event thread */
   if (pthread_create(&eventThreadId, NULL, &SocketCanEventThread, NULL) == 0) /*lint !e546 */
   {
@@ -515,15 +1277,11 @@ static void SocketCanStopEventThread(void)
   bool terminatedCpy = false;
 
   /* Set the terminate request. */
-  UtilCriticalSectionEnter();
-  eventThreadCtrl.terminate = true;
-  UtilCriticalSectionExit();
+  __atomic_store_n(&eventThreadCtrl.terminate, true, __ATOMIC_RELEASE);
   /* Wait for thread to terminate. */
   while (!terminatedCpy)
   {
-    UtilCriticalSectionEnter();
-    terminatedCpy = eventThreadCtrl.terminated;
-    UtilCriticalSectionExit();
+    terminatedCpy = __atomic_load_n(&eventThreadCtrl.terminated, __ATOMIC_ACQUIRE);
     /* Wait a little without starving the CPU. */
     UtilTimeDelayMs(10);
   }
@@ -541,6 +1299,7 @@ static void *SocketCanEventThread(void *param)
 {
   bool terminateRequest = false;
   struct can_frame canRxFrame;
+  uint64_t rxTimestamp;
   tCanMsg rxMsg;
   tCanEvents volatile const * pEvents;
 
@@ -551,12 +1310,15 @@ static void *SocketCanEventThread(void *param)
   while (!terminateRequest)
   {
     /* Update termination request. */
-    UtilCriticalSectionEnter();
-    terminateRequest = eventThreadCtrl.terminate;
-    UtilCriticalSectionExit();
+    terminateRequest = __atomic_load_n(&eventThreadCtrl.terminate, __ATOMIC_ACQUIRE);
+
+    /* Process transmission time stamps first. This way the transmit complete event of
+     * a request is triggered before the receive event of its response.
+     */
+    SocketCanProcessTxTimestamps();
 
     /* Check if CAN frames were received. */
-    while (read(canSocket, &canRxFrame, sizeof(struct can_frame)) == (ssize_t)sizeof(struct can_frame))
+    while (SocketCanReceive(&canRxFrame, 0, &rxTimestamp) == (ssize_t)sizeof(struct can_frame))
     {
       /* Ignore remote frames */
       if (canRxFrame.can_id & CAN_RTR_FLAG)
@@ -570,9 +1332,7 @@ static void *SocketCanEventThread(void *param)
         if ((canRxFrame.can_id & CAN_ERR_BUSOFF) != 0)
         {
           /* Set the error flag. */
-          UtilCriticalSectionEnter();
-          socketCanErrorDetected = true;
-          UtilCriticalSectionExit();
+          __atomic_store_n(&socketCanErrorDetected, true, __ATOMIC_RELEASE);
         }
         /* Was it a CAN controller event? */
         else if ((canRxFrame.can_id & CAN_ERR_CRTL) != 0)
@@ -581,9 +1341,7 @@ static void *SocketCanEventThread(void *param)
           if ((canRxFrame.data[1] & (CAN_ERR_CRTL_RX_PASSIVE | CAN_ERR_CRTL_TX_PASSIVE)) != 0)
           {
             /* Set the error flag. */
-            UtilCriticalSectionEnter();
-            socketCanErrorDetected = true;
-            UtilCriticalSectionExit();
+            __atomic_store_n(&socketCanErrorDetected, true, __ATOMIC_RELEASE);
           }
         }
       }
@@ -602,6 +1360,7 @@ static void *SocketCanEventThread(void *param)
         {
           rxMsg.data[idx] = canRxFrame.data[idx];
         }
+        rxMsg.timestamp = rxTimestamp;
 
         /* Trigger message reception event(s). */
         pEvents = socketCanEventsList;
@@ -626,9 +1385,7 @@ static void *SocketCanEventThread(void *param)
   }
 
   /* handshake */
-  UtilCriticalSectionEnter();
-  eventThreadCtrl.terminated = true;
-  UtilCriticalSectionExit();
+  __atomic_store_n(&eventThreadCtrl.terminated, true, __ATOMIC_RELEASE);
 
   /* exit the thread */
   return NULL;
@@ -33,7 +33,9 @@
 ****************************************************************************************/
 #include <assert.h>                         /* for assertions                          */
 #include <stdint.h>                         /* for standard integer types              */
+#include <stddef.h>                         /* for NULL declaration                    */
 #include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
 #include <pthread.h>                        /* for posix threads                       */
 #include "util.h"                           /* Utility module                          */
 
@@ -41,88 +43,120 @@
 /****************************************************************************************
 * Local data declarations
 ****************************************************************************************/
-/** \brief Flag to determine if the critical section object was already initialized. */
-static volatile bool criticalSectionInitialized = false;
-
-/** \brief Critical section object. */
-static volatile pthread_mutex_t mtxCritSect;
+/** \brief Process wide critical section object. It is statically initialized, so it
+ *         can already be locked before any module created its own critical sections.
+ */
+static pthread_mutex_t utilCriticalSectionGlobal = PTHREAD_MUTEX_INITIALIZER;
 
 
 /************************************************************************************//**
-** \brief     Initializes the critical section module. Should be called before the
-**            Enter/Exit functions are used. It is okay to call this initialization
-**            multiple times from different modules.
+** \brief     Creates a new critical section object. Each module that needs to protect
+**            its own shared data should create its own critical section object. This
+**            way unrelated modules never have to wait on each other.
+** \return    Handle to the newly created critical section object if successful, NULL
+**            otherwise.
 **
 ****************************************************************************************/
-void UtilCriticalSectionInit(void)
+tUtilCriticalSection UtilCriticalSectionCreate(void)
 {
-  /* Only initialize if not yet done so previously. */
-  if (!criticalSectionInitialized)
+  tUtilCriticalSection result = NULL;
+  pthread_mutex_t * critSectObj;
+
+  /* Allocate memory for the critical section object. */
+  critSectObj = malloc(sizeof(pthread_mutex_t));
+  assert(critSectObj != NULL);
+  /* Only continue if the allocation was successful. */
+  if (critSectObj != NULL) /*lint !e774 */
   {
-    /* Initialize the critical section object. */
-    (void)pthread_mutex_init((pthread_mutex_t *)&mtxCritSect, NULL);
-    /* Set initialized flag. */
-    criticalSectionInitialized = true;
+    /* Initialize the mutex and only hand it out if this was successful. */
+    if (pthread_mutex_init(critSectObj, NULL) == 0)
+    {
+      result = critSectObj;
+    }
+    else
+    {
+      free(critSectObj);
+    }
   }
-} /*** end of UtilCriticalSectionInit ***/
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilCriticalSectionCreate ***/
 
 
 /************************************************************************************//**
-** \brief     Terminates the critical section module. Should be called once critical
-**            sections are no longer needed. Typically called from another module's
-**            termination function that also initialized it. It is okay to call this 
-**            termination multiple times from different modules.
+** \brief     Destroys a critical section object that was previously created with
+**            UtilCriticalSectionCreate. The critical section should not be locked
+**            when calling this function.
+** \param     critSect Handle to the critical section object.
 **
 ****************************************************************************************/
-void UtilCriticalSectionTerminate(void)
+void UtilCriticalSectionDestroy(tUtilCriticalSection critSect)
 {
-  /* Only terminate if it was initialized. */
-  if (criticalSectionInitialized)
+  /* Only continue with a valid handle. Note that a NULL handle is allowed, in which
+   * case there is nothing to destroy.
+   */
+  if (critSect != NULL)
   {
-    /* Reset the initialized flag. */
-    criticalSectionInitialized = false;
-    /* Delete the critical section object. */
-    (void)pthread_mutex_destroy((pthread_mutex_t *)&mtxCritSect);
+    /* Delete the critical section object and release its memory. */
+    (void)pthread_mutex_destroy((pthread_mutex_t *)critSect);
+    free(critSect);
   }
-} /*** end of UtilCriticalSectionTerminate ***/
+} /*** end of UtilCriticalSectionDestroy ***/
 
 
+/************************************************************************************//**
+** \brief     Obtains the process wide critical section object. Unlike the ones created
+**            with UtilCriticalSectionCreate, it exists from the start and is never
+**            destroyed. It is meant for protecting the initialization and termination
+**            of modules that are shared by multiple users, because these cannot use a
+**            critical section object that they create themselves during their
+**            initialization. It should only be locked for short periods of time.
+** \return    Handle to the process wide critical section object.
+**
+****************************************************************************************/
+tUtilCriticalSection UtilCriticalSectionGetGlobal(void)
+{
+  /* Give the result back to the caller. */
+  return &utilCriticalSectionGlobal;
+} /*** end of UtilCriticalSectionGetGlobal ***/
+
 
 /************************************************************************************//**
-** \brief     Enters a critical section. The functions UtilCriticalSectionEnter and 
-**            UtilCriticalSectionExit should always be used in a pair.
+** \brief     Locks a critical section object. The functions UtilCriticalSectionLock and
+**            UtilCriticalSectionUnlock should always be used in a pair.
+** \param     critSect Handle to the critical section object.
 **
 ****************************************************************************************/
-void UtilCriticalSectionEnter(void)
+void UtilCriticalSectionLock(tUtilCriticalSection critSect)
 {
-  /* Check initialization. */
-  assert(criticalSectionInitialized);
+  /* Check parameters. */
+  assert(critSect != NULL);
 
-  /* Only continue if actually initialized. */
-  if (criticalSectionInitialized)
+  /* Only continue with a valid handle. */
+  if (critSect != NULL) /*lint !e774 */
   {
-    (void)pthread_mutex_lock((pthread_mutex_t *)&mtxCritSect);
+    (void)pthread_mutex_lock((pthread_mutex_t *)critSect);
   }
-} /*** end of UtilCriticalSectionEnter ***/ /*lint !e456 !e454 */
+} /*** end of UtilCriticalSectionLock ***/ /*lint !e456 !e454 */
 
 
 /************************************************************************************//**
-** \brief     Leaves a critical section. The functions UtilCriticalSectionEnter and 
-**            UtilCriticalSectionExit should always be used in a pair.
+** \brief     Unlocks a critical section object. The functions UtilCriticalSectionLock
+**            and UtilCriticalSectionUnlock should always be used in a pair.
+** \param     critSect Handle to the critical section object.
 **
 ****************************************************************************************/
-void UtilCriticalSectionExit(void)
+void UtilCriticalSectionUnlock(tUtilCriticalSection critSect)
 {
-  /* Check initialization. */
-  assert(criticalSectionInitialized);
+  /* Check parameters. */
+  assert(critSect != NULL);
 
-  /* Only continue if actually initialized. */
-  if (criticalSectionInitialized)
+  /* Only continue with a valid handle. */
+  if (critSect != NULL) /*lint !e774 */
   {
-    (void)pthread_mutex_unlock((pthread_mutex_t *)&mtxCritSect); /*lint !e455 */
+    (void)pthread_mutex_unlock((pthread_mutex_t *)critSect); /*lint !e455 */
   }
-} /*** end of UtilCriticalSectionExit ***/
+} /*** end of UtilCriticalSectionUnlock ***/
 
 
 /*********************************** end of critutil.c *********************************/
-
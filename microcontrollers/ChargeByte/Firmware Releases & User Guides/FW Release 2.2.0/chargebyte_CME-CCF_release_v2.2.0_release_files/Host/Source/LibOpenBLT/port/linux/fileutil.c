@@ -0,0 +1,187 @@
+/************************************************************************************//**
+* \file         port/linux/fileutil.c
+* \brief        File utility source file.
+* \ingroup      Utility
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+* 
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+* 
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+* 
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include <assert.h>                         /* for assertions                          */
+#include <stdint.h>                         /* for standard integer types              */
+#include <stddef.h>                         /* for NULL declaration                    */
+#include <stdbool.h>                        /* for boolean type                        */
+#include <unistd.h>                         /* UNIX standard functions                 */
+#include <fcntl.h>                          /* for file control                        */
+#include <dirent.h>                         /* for directory access                    */
+#include <sys/mman.h>                       /* for memory mapped files                 */
+#include <sys/stat.h>                       /* for file status                         */
+#include "util.h"                           /* Utility module                          */
+
+
+/************************************************************************************//**
+** \brief     Maps the contents of a file into memory for reading. The pages are only
+**            read from the file once they are accessed, so this is faster than reading
+**            the entire file, if it is already in the page cache of the operating
+**            system.
+** \param     filename Name of the file.
+** \param     len Pointer where the number of bytes in the file is written to.
+** \return    Pointer to the contents of the file if successful, NULL otherwise. An
+**            empty file cannot be mapped. Release it with UtilFileUnmap.
+**
+****************************************************************************************/
+uint8_t const * UtilFileMap(char const * filename, uint32_t * len)
+{
+  uint8_t const * result = NULL;
+  int fd;
+  struct stat fileStat;
+  void * mapping;
+
+  /* Check parameters. */
+  assert(filename != NULL);
+  assert(len != NULL);
+
+  /* Only continue if parameters are valid. */
+  if ( (filename != NULL) && (len != NULL) ) /*lint !e774 */
+  {
+    fd = open(filename, O_RDONLY);
+    if (fd >= 0)
+    {
+      if ( (fstat(fd, &fileStat) == 0) && (S_ISREG(fileStat.st_mode)) &&
+           (fileStat.st_size > 0) && ((uint64_t)fileStat.st_size <= UINT32_MAX) )
+      {
+        mapping = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED)
+        {
+          *len = (uint32_t)fileStat.st_size;
+          result = mapping;
+        }
+      }
+      /* The mapping stays valid after closing the file. */
+      (void)close(fd);
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilFileMap ***/
+
+
+/************************************************************************************//**
+** \brief     Releases the contents of a file that was mapped into memory.
+** \param     data Pointer to the contents of the file, as returned by UtilFileMap.
+** \param     len Number of bytes in the file.
+**
+****************************************************************************************/
+void UtilFileUnmap(uint8_t const * data, uint32_t len)
+{
+  /* Check parameters. */
+  assert(data != NULL);
+
+  /* Only continue if parameters are valid. */
+  if (data != NULL) /*lint !e774 */
+  {
+    (void)munmap((void *)data, len);
+  }
+} /*** end of UtilFileUnmap ***/
+
+
+/************************************************************************************//**
+** \brief     Sets the time of the last modification of a file to the current time.
+** \param     filename Name of the file.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+bool UtilFileTouch(char const * filename)
+{
+  bool result = false;
+
+  /* Check parameters. */
+  assert(filename != NULL);
+
+  /* Only continue if parameters are valid. */
+  if (filename != NULL) /*lint !e774 */
+  {
+    if (utimensat(AT_FDCWD, filename, NULL, 0) == 0)
+    {
+      result = true;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilFileTouch ***/
+
+
+/************************************************************************************//**
+** \brief     Calls a function for each regular file in a directory.
+** \param     directory Name of the directory.
+** \param     func Function to call with the name of the file, without the directory,
+**            its size in bytes and the time of its last modification in microseconds
+**            since the epoch.
+** \param     arg Argument to pass on to the function.
+** \return    True if successful, false if the directory could not be opened.
+**
+****************************************************************************************/
+bool UtilFileScanDirectory(char const * directory, tUtilFileScanFunc func, void * arg)
+{
+  bool result = false;
+  DIR * dir;
+  struct dirent * entry;
+  struct stat fileStat;
+
+  /* Check parameters. */
+  assert(directory != NULL);
+  assert(func != NULL);
+
+  /* Only continue if parameters are valid. */
+  if ( (directory != NULL) && (func != NULL) ) /*lint !e774 */
+  {
+    dir = opendir(directory);
+    if (dir != NULL)
+    {
+      result = true;
+      while ((entry = readdir(dir)) != NULL)
+      {
+        /* Only report regular files. A file that was removed in the meantime is
+         * skipped.
+         */
+        if ( (fstatat(dirfd(dir), entry->d_name, &fileStat, AT_SYMLINK_NOFOLLOW) == 0) &&
+             (S_ISREG(fileStat.st_mode)) )
+        {
+          func(entry->d_name, (uint64_t)fileStat.st_size,
+               ((uint64_t)fileStat.st_mtim.tv_sec * 1000000u) +
+               ((uint64_t)fileStat.st_mtim.tv_nsec / 1000u), arg);
+        }
+      }
+      (void)closedir(dir);
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilFileScanDirectory ***/
+
+
+/*********************************** end of fileutil.c *********************************/
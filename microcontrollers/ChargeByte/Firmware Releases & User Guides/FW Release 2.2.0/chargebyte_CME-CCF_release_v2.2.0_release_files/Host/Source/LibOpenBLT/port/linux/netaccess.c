@@ -31,15 +31,24 @@
 /****************************************************************************************
 * Include files
 ****************************************************************************************/
+#define _GNU_SOURCE                         /* for ppoll                               */
 #include <assert.h>                         /* for assertions                          */
 #include <stdint.h>                         /* for standard integer types              */
 #include <stddef.h>                         /* for NULL declaration                    */
 #include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
 #include <string.h>                         /* for string utilities                    */
 #include <unistd.h>                         /* for close                               */
+#include <errno.h>                          /* for error numbers                       */
+#include <poll.h>                           /* for polling file descriptors            */
+#include <time.h>                           /* for time structures                     */
 #include <sys/socket.h>                     /* for socket                              */
+#include <sys/uio.h>                        /* for scatter/gather I/O vectors          */
+#include <netinet/in.h>                     /* for IP protocol definitions             */
+#include <netinet/tcp.h>                    /* for TCP socket options                  */
 #include <arpa/inet.h>                      /* for inet_addr                           */
 #include <netdb.h>                          /* for hostent                             */
+#include "util.h"                           /* Utility module                          */
 #include "netaccess.h"                      /* TCP/IP network access module            */
 
 
@@ -51,46 +60,76 @@
 
 
 /****************************************************************************************
-* Local data declarations
+* Type definitions
 ****************************************************************************************/
-/** \brief The socket that is used as an endpoint for the TCP/IP network
- * communication.
- */
-static int netAccessSocket;
+/** \brief Network access object. A network access handle points to one of these. */
+typedef struct t_net_access_obj
+{
+  /** \brief The socket that is used as an endpoint for the TCP/IP network
+   *         communication.
+   */
+  int sock;
+} tNetAccessObj;
 
 
 /************************************************************************************//**
-** \brief     Initializes the network access module.
+** \brief     Initializes a network access object.
+** \return    Handle of the network access object or NULL in case of an error.
 **
 ****************************************************************************************/
-void NetAccessInit(void)
+tNetAccessHandle NetAccessInit(void)
 {
-  /* Invalidate the socket. */
-  netAccessSocket = NETACCESS_INVALID_SOCKET;
+  tNetAccessObj * netAccess;
+
+  /* Allocate memory for the network access object. */
+  netAccess = malloc(sizeof(tNetAccessObj));
+  assert(netAccess != NULL);
+  /* Only continue if the allocation was successful. */
+  if (netAccess != NULL) /*lint !e774 */
+  {
+    /* Invalidate the socket. */
+    netAccess->sock = NETACCESS_INVALID_SOCKET;
+  }
+  /* Give the handle back to the caller. */
+  return netAccess;
 } /*** end of NetAccessInit ***/
 
 
 /************************************************************************************//**
-** \brief     Terminates the network access module.
+** \brief     Terminates a network access object and releases its memory.
+** \param     handle Handle of the network access object.
 **
 ****************************************************************************************/
-void NetAccessTerminate(void)
+void NetAccessTerminate(tNetAccessHandle handle)
 {
-  /* Make sure to disconnect form the server. */
-  NetAccessDisconnect();
+  tNetAccessObj * netAccess = (tNetAccessObj *)handle;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only continue with valid parameters. */
+  if (netAccess != NULL) /*lint !e774 */
+  {
+    /* Make sure to disconnect form the server. */
+    NetAccessDisconnect(handle);
+    /* Release the memory of the object. */
+    free(netAccess);
+  }
 } /*** end of NetAccessTerminate ***/
 
 
 /************************************************************************************//**
 ** \brief     Connects to the TCP/IP server at the specified address and the given port.
+** \param     handle Handle of the network access object.
 ** \param     address The address of the server. This can be a hostname (such as
 **            mydomain.com) or an IP address (such as 127.0.0.1).
 ** \param     port The port number on the server to connect to.
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-bool NetAccessConnect(char const * address, uint16_t port)
+bool NetAccessConnect(tNetAccessHandle handle, char const * address, uint16_t port)
 {
+  tNetAccessObj * netAccess = (tNetAccessObj *)handle;
   bool result = false;
   struct addrinfo hints = { 0 };
   struct addrinfo * serverinfo = NULL;
@@ -100,15 +139,15 @@ bool NetAccessConnect(char const * address, uint16_t port)
   bool serverIPv6found = false;
   
   /* Check parameters. */
+  assert(handle != NULL);
   assert(address != NULL);
   assert(port > 0);
 
-  /* Start by invalidating the socket. */
-  netAccessSocket = NETACCESS_INVALID_SOCKET;
-
   /* Only continue with valid parameters. */
-  if ( (address != NULL) && (port > 0) ) /*lint !e774 */
+  if ( (netAccess != NULL) && (address != NULL) && (port > 0) ) /*lint !e774 */
   {
+    /* Start by invalidating the socket. */
+    netAccess->sock = NETACCESS_INVALID_SOCKET;
     /* Set result to true and only reset it to false upon detection of a problem. */
     result = true;
 
@@ -187,17 +226,17 @@ bool NetAccessConnect(char const * address, uint16_t port)
       /* Create the socket based on the family type. */
       if (serverIPv4found)
       {
-        netAccessSocket = socket(serverIPv4.sin_family, (int)SOCK_STREAM, IPPROTO_TCP);
+        netAccess->sock = socket(serverIPv4.sin_family, (int)SOCK_STREAM, IPPROTO_TCP);
       }
       else
       {
-        netAccessSocket = socket(serverIPv6.sin6_family, (int)SOCK_STREAM, IPPROTO_TCP);
+        netAccess->sock = socket(serverIPv6.sin6_family, (int)SOCK_STREAM, IPPROTO_TCP);
       }
       /* Check the socket. */
-      if (netAccessSocket < 0)
+      if (netAccess->sock < 0)
       {
         /* Could not create the socket. */
-        netAccessSocket = NETACCESS_INVALID_SOCKET;
+        netAccess->sock = NETACCESS_INVALID_SOCKET;
         result = false;
       }
     }
@@ -215,14 +254,25 @@ bool NetAccessConnect(char const * address, uint16_t port)
         server_address = (struct sockaddr *)&serverIPv6; /*lint !e740 */
       }
       /* Attempt to connect. */
-      if (connect(netAccessSocket, server_address, sizeof(struct sockaddr)) < 0)
+      if (connect(netAccess->sock, server_address, sizeof(struct sockaddr)) < 0)
       {
         /* Could not connect. Close the socket and negate result value. */
-        close(netAccessSocket);
-        netAccessSocket = NETACCESS_INVALID_SOCKET;
+        close(netAccess->sock);
+        netAccess->sock = NETACCESS_INVALID_SOCKET;
         result = false;
       }
     }
+    /* Disable Nagle's algorithm. XCP is a request/response protocol with small
+     * packets, so a command should go out right away instead of waiting for more data
+     * or for the acknowledgement of the previous segment. Note that this is an
+     * optimization, so failing to configure it is not an error.
+     */
+    if (result)
+    {
+      int noDelay = 1;
+      (void)setsockopt(netAccess->sock, IPPROTO_TCP, TCP_NODELAY, &noDelay,
+                       sizeof(noDelay));
+    }
   }
   /* Give the result back to the caller. */
   return result;
@@ -231,45 +281,66 @@ bool NetAccessConnect(char const * address, uint16_t port)
 
 /************************************************************************************//**
 ** \brief     Disconnects from the TCP/IP server.
+** \param     handle Handle of the network access object.
 **
 ****************************************************************************************/
-void NetAccessDisconnect(void)
+void NetAccessDisconnect(tNetAccessHandle handle)
 {
+  tNetAccessObj * netAccess = (tNetAccessObj *)handle;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
   /* Close the socket if it is open. */
-  if (netAccessSocket >= 0)
+  if ( (netAccess != NULL) && (netAccess->sock >= 0) ) /*lint !e774 */
   {
-    close(netAccessSocket);
-    netAccessSocket = NETACCESS_INVALID_SOCKET;
+    close(netAccess->sock);
+    netAccess->sock = NETACCESS_INVALID_SOCKET;
   }
 } /*** end of NetAccessDisconnect ***/
 
 
 /************************************************************************************//**
 ** \brief     Sends data to the TCP/IP server.
+** \param     handle Handle of the network access object.
 ** \param     data Pointer to byte array with data to send.
 ** \param     length Number of bytes to send.
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-bool NetAccessSend(uint8_t const * data, uint32_t length)
+bool NetAccessSend(tNetAccessHandle handle, uint8_t const * data, uint32_t length)
 {
+  tNetAccessObj * netAccess = (tNetAccessObj *)handle;
   bool result = false;
+  uint32_t sentLen = 0;
+  ssize_t sendResult;
 
   /* Check parameters. */
+  assert(handle != NULL);
   assert(data != NULL);
   assert(length > 0);
 
   /* Only continue with valid parameters. */
-  if ( (data != NULL) && (length > 0) ) /*lint !e774 */
+  if ( (netAccess != NULL) && (data != NULL) && (length > 0) ) /*lint !e774 */
   {
     /* Only continue with a valid socket. */
-    if (netAccessSocket >= 0)
+    if (netAccess->sock >= 0)
     {
-      /* Attempt to send the data. */
-      if (send(netAccessSocket, data, length, 0) >= 0)
+      /* Attempt to send the data. A stream socket can accept less data than requested,
+       * so keep sending until all data is accepted.
+       */
+      result = true;
+      while ( (result) && (sentLen < length) )
       {
-        /* Successfully send the data. */
-        result = true;
+        sendResult = send(netAccess->sock, &data[sentLen], length - sentLen, 0);
+        if (sendResult >= 0)
+        {
+          sentLen += (uint32_t)sendResult;
+        }
+        else if (errno != EINTR)
+        {
+          result = false;
+        }
       }
     }
   }
@@ -278,8 +349,93 @@ bool NetAccessSend(uint8_t const * data, uint32_t length)
 } /*** end of NetAccessSend ***/
 
 
+/************************************************************************************//**
+** \brief     Sends data, that is spread over multiple buffers, to the TCP/IP server. The
+**            buffers are gathered by the kernel, so they do not need to be copied into
+**            one buffer first.
+** \param     handle Handle of the network access object.
+** \param     buffers Pointer to the array with buffers to send.
+** \param     count Number of buffers in the array.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+bool NetAccessSendVector(tNetAccessHandle handle, tNetAccessBuffer const * buffers,
+                         uint32_t count)
+{
+  tNetAccessObj * netAccess = (tNetAccessObj *)handle;
+  bool result = false;
+  struct iovec iovecs[NETACCESS_BUFFERS_MAX];
+  struct msghdr msg = { 0 };
+  uint32_t iovecCount = 0;
+  uint32_t idx;
+  ssize_t sendResult;
+  size_t sentLen;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+  assert(buffers != NULL);
+  assert(count > 0);
+  assert(count <= NETACCESS_BUFFERS_MAX);
+
+  /* Only continue with valid parameters. */
+  if ( (netAccess != NULL) && (buffers != NULL) && (count > 0) &&
+       (count <= NETACCESS_BUFFERS_MAX) ) /*lint !e774 */
+  {
+    /* Only continue with a valid socket. */
+    if (netAccess->sock >= 0)
+    {
+      /* Set up the I/O vectors. Empty buffers are skipped. */
+      for (idx = 0; idx < count; idx++)
+      {
+        if (buffers[idx].length > 0)
+        {
+          iovecs[iovecCount].iov_base = (void *)buffers[idx].data;
+          iovecs[iovecCount].iov_len = buffers[idx].length;
+          iovecCount++;
+        }
+      }
+      msg.msg_iov = &iovecs[0];
+      msg.msg_iovlen = iovecCount;
+      /* Attempt to send the data. A stream socket can accept less data than requested,
+       * so keep sending the remainder until all data is accepted.
+       */
+      result = true;
+      while ( (result) && (msg.msg_iovlen > 0) )
+      {
+        sendResult = sendmsg(netAccess->sock, &msg, 0);
+        if (sendResult >= 0)
+        {
+          /* Skip the I/O vectors that were sent completely and adjust the one that was
+           * sent partially.
+           */
+          sentLen = (size_t)sendResult;
+          while ( (msg.msg_iovlen > 0) && (sentLen >= msg.msg_iov[0].iov_len) )
+          {
+            sentLen -= msg.msg_iov[0].iov_len;
+            msg.msg_iov++;
+            msg.msg_iovlen--;
+          }
+          if (msg.msg_iovlen > 0)
+          {
+            msg.msg_iov[0].iov_base = (uint8_t *)msg.msg_iov[0].iov_base + sentLen;
+            msg.msg_iov[0].iov_len -= sentLen;
+          }
+        }
+        else if (errno != EINTR)
+        {
+          result = false;
+        }
+      }
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of NetAccessSendVector ***/
+
+
 /************************************************************************************//**
 ** \brief     Receives data from the TCP/IP server in a blocking manner.
+** \param     handle Handle of the network access object.
 ** \param     data Pointer to byte array to store the received data.
 ** \param     length Holds the max number of bytes that can be stored into the byte
 **            array. This function also overwrites this value with the number of bytes
@@ -288,39 +444,85 @@ bool NetAccessSend(uint8_t const * data, uint32_t length)
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-bool NetAccessReceive(uint8_t * data, uint32_t * length, uint32_t timeout)
+bool NetAccessReceive(tNetAccessHandle handle, uint8_t * data, uint32_t * length,
+                      uint32_t timeout)
 {
+  tNetAccessObj * netAccess = (tNetAccessObj *)handle;
   bool result = false;
-  struct timeval tv;
+  bool receptionDone = false;
+  uint64_t deadlineTime;
+  uint64_t remainingTime;
+  struct pollfd pollFd;
+  struct timespec pollTimeout;
+  int pollResult;
   ssize_t receivedLen;
 
   /* Check parameters. */
+  assert(handle != NULL);
   assert(data != NULL);
   assert(length != NULL);
   assert(timeout > 0);
 
   /* Only continue with valid parameters. */
-  if ( (data != NULL) && (length != NULL) && (timeout > 0) ) /*lint !e774 */
+  if ( (netAccess != NULL) && (data != NULL) && (length != NULL) && /*lint !e774 */
+       (timeout > 0) )
   {
     /* Only continue with a valid socket. */
-    if (netAccessSocket >= 0)
+    if (netAccess->sock >= 0)
     {
-      /* Configure the timeout for the receive operation. */
-      tv.tv_sec = (__time_t)(timeout / 1000u);
-      tv.tv_usec = (timeout % 1000u) * 1000u;
-      if (setsockopt(netAccessSocket, SOL_SOCKET, SO_RCVTIMEO, (const char*)&tv, sizeof(struct timeval)) >= 0)
+      /* Determine the time at which the reception times out. Waiting for data is done
+       * with ppoll() for the remaining time. This avoids the need to configure a socket
+       * receive timeout for each reception.
+       */
+      deadlineTime = UtilTimeDeadlineUs((uint64_t)timeout * 1000u);
+      pollFd.fd = netAccess->sock;
+      pollFd.events = POLLIN;
+      while (!receptionDone)
       {
-        /* Attempt to receive data. */
-        receivedLen = recv(netAccessSocket, data, *length, 0);
-        /* Process the result. Everything < 0 indicate that an error occured. A value of
-         * zero is also treated as an error, since data was expected.
+        /* Check if the reception timed out. */
+        remainingTime = UtilTimeDeadlineRemainingUs(deadlineTime);
+        if (remainingTime == 0)
+        {
+          break;
+        }
+        /* Wait for data to arrive. */
+        pollFd.revents = 0;
+        pollTimeout.tv_sec = (time_t)(remainingTime / 1000000u);
+        pollTimeout.tv_nsec = (long)((remainingTime % 1000000u) * 1000u);
+        pollResult = ppoll(&pollFd, 1, &pollTimeout, NULL);
+        if (pollResult <= 0)
+        {
+          /* Stop on a timeout or an error. Only an interrupted wait is retried. */
+          if ( (pollResult == 0) || (errno != EINTR) )
+          {
+            receptionDone = true;
+          }
+          continue;
+        }
+        /* Read the data without blocking. */
+        receivedLen = recv(netAccess->sock, data, *length, MSG_DONTWAIT);
+        /* A value of zero means that the server closed the connection. This is treated
+         * as an error, since data was expected.
          */
-        if (receivedLen > 0)
+        if (receivedLen == 0)
+        {
+          receptionDone = true;
+        }
+        else if (receivedLen < 0)
+        {
+          /* Stop on an error. A spurious wakeup or an interrupted read is retried. */
+          if ( (errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR) )
+          {
+            receptionDone = true;
+          }
+        }
+        else
         {
           /* Store the number of received bytes. */
           *length = (uint32_t)receivedLen;
           /* Successfully received data. */
           result = true;
+          receptionDone = true;
         }
       }
     }
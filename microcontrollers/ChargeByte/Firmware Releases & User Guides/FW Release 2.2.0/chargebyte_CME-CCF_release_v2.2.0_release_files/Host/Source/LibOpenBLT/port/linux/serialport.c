@@ -31,13 +31,18 @@
 /****************************************************************************************
 * Include files
 ****************************************************************************************/
+#define _GNU_SOURCE                         /* for ppoll                               */
 #include <assert.h>                         /* for assertions                          */
 #include <stdint.h>                         /* for standard integer types              */
 #include <stddef.h>                         /* for NULL declaration                    */
 #include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
 #include <unistd.h>                         /* UNIX standard functions                 */
-#include <termios.h>                        /* POSIX terminal control                  */
+#include <poll.h>                           /* for polling file descriptors            */
+#include <time.h>                           /* for time structures                     */
+#include <asm/termbits.h>                   /* kernel terminal control                 */
 #include <fcntl.h>                          /* file control definitions                */
+#include <errno.h>                          /* for error numbers                       */
 #include <sys/ioctl.h>                      /* system I/O control                      */
 #include "serialport.h"                     /* serial port module                      */
 
@@ -50,78 +55,131 @@
 
 
 /****************************************************************************************
-* Local data declarations
+* Type definitions
 ****************************************************************************************/
-/** \brief Serial port handle. */
-static int32_t portHandle;
+/** \brief Serial port object. A serial port handle points to one of these. */
+typedef struct t_serial_port_obj
+{
+  /** \brief Serial port device handle. */
+  int32_t portHandle;
+} tSerialPortObj;
 
 
 /****************************************************************************************
 * Local constant declarations
 ****************************************************************************************/
-/** \brief Lookup table for converting this module's generic baudrate value to a value
- *         supported by the low level interface.
+/** \brief Lookup table for converting a standard baudrate in bits/sec to a value
+ *         supported by the low level interface. Baudrates that are not in this table
+ *         are configured as an arbitrary baudrate with BOTHER.
  */
-static const speed_t baudrateLookup[] =
+static const struct
+{
+  uint32_t baudrate;                        /**< Baudrate in bits/sec.                 */
+  speed_t speed;                            /**< Low level interface value.            */
+} baudrateLookup[] =
 {
-  B9600,                                    /**< Index 0 = SERIALPORT_BR9600           */
-  B19200,                                   /**< Index 1 = SERIALPORT_BR19200          */
-  B38400,                                   /**< Index 2 = SERIALPORT_BR38400          */
-  B57600,                                   /**< Index 3 = SERIALPORT_BR57600          */
-  B115200                                   /**< Index 4 = SERIALPORT_BR115200         */
+  { 9600,    B9600    },
+  { 19200,   B19200   },
+  { 38400,   B38400   },
+  { 57600,   B57600   },
+  { 115200,  B115200  },
+  { 230400,  B230400  },
+  { 460800,  B460800  },
+  { 500000,  B500000  },
+  { 576000,  B576000  },
+  { 921600,  B921600  },
+  { 1000000, B1000000 },
+  { 1152000, B1152000 },
+  { 1500000, B1500000 },
+  { 2000000, B2000000 },
+  { 2500000, B2500000 },
+  { 3000000, B3000000 },
+  { 3500000, B3500000 },
+  { 4000000, B4000000 }
 };
 
 
 /************************************************************************************//**
-** \brief     Initializes the serial port module.
+** \brief     Initializes a serial port object.
+** \return    Handle of the serial port object or NULL in case of an error.
 **
 ****************************************************************************************/
-void SerialPortInit(void)
+tSerialPortHandle SerialPortInit(void)
 {
-  /* Invalidate the port handle. */
-  portHandle = SERIALPORT_INVALID_HANDLE;
+  tSerialPortObj * serialPort;
+
+  /* Allocate memory for the serial port object. */
+  serialPort = malloc(sizeof(tSerialPortObj));
+  assert(serialPort != NULL);
+  /* Only continue if the allocation was successful. */
+  if (serialPort != NULL) /*lint !e774 */
+  {
+    /* Invalidate the port handle. */
+    serialPort->portHandle = SERIALPORT_INVALID_HANDLE;
+  }
+  /* Give the handle back to the caller. */
+  return serialPort;
 } /*** end of SerialPortInit ***/
 
 
 /************************************************************************************//**
-** \brief     Terminates the serial port module.
+** \brief     Terminates a serial port object and releases its memory.
+** \param     handle Handle of the serial port object.
 **
 ****************************************************************************************/
-void SerialPortTerminate(void)
+void SerialPortTerminate(tSerialPortHandle handle)
 {
-  /* Make sure the serial port is closed. */
-  SerialPortClose();
+  tSerialPortObj * serialPort = (tSerialPortObj *)handle;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only continue with valid parameters. */
+  if (serialPort != NULL) /*lint !e774 */
+  {
+    /* Make sure the serial port is closed. */
+    SerialPortClose(handle);
+    /* Release the memory of the object. */
+    free(serialPort);
+  }
 } /*** end of SerialPortTerminate ***/
 
 
 /************************************************************************************//**
 ** \brief     Opens the connection with the serial port configured as 8,N,1 and no flow
 **            control.
+** \param     handle Handle of the serial port object.
 ** \param     portname The name of the serial port to open, i.e. /dev/ttyUSB0.
-** \param     baudrate The desired communication speed.
+** \param     baudrate The desired communication speed in bits/sec. Besides the standard
+**            baudrates, arbitrary baudrates are supported, if the serial port's
+**            driver and hardware support them.
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-bool SerialPortOpen(char const * portname, tSerialPortBaudrate baudrate) 
+bool SerialPortOpen(tSerialPortHandle handle, char const * portname, uint32_t baudrate) 
 {
+  tSerialPortObj * serialPort = (tSerialPortObj *)handle;
   bool result = false;
-  struct termios options = { 0 }; 
+  struct termios2 options = { 0 }; 
   int32_t iFlags;
+  uint32_t idx;
 
   /* Check parameters. */
+  assert(handle != NULL);
   assert(portname != NULL);
+  assert(baudrate > 0);
   
   /* Only continue with valid parameters. */
-  if (portname != NULL) /*lint !e774 */
+  if ( (serialPort != NULL) && (portname != NULL) && (baudrate > 0) ) /*lint !e774 */
   {
     /* Assume the result to be okay from here on and only set it to error when a problem
      * was detected.
      */
     result = true;
     /* Open the port. */
-    portHandle = open(portname, O_RDWR | O_NOCTTY | O_NDELAY);
+    serialPort->portHandle = open(portname, O_RDWR | O_NOCTTY | O_NDELAY);
     /* Check the result */
-    if (portHandle == SERIALPORT_INVALID_HANDLE)
+    if (serialPort->portHandle == SERIALPORT_INVALID_HANDLE)
     {
       result = false;
     }
@@ -129,37 +187,40 @@ bool SerialPortOpen(char const * portname, tSerialPortBaudrate baudrate)
     /* Configure the device to block during read operations. */
     if (result)
     {
-      if (fcntl(portHandle, F_SETFL, 0) == -1)
+      if (fcntl(serialPort->portHandle, F_SETFL, 0) == -1)
       {
-        SerialPortClose();
+        SerialPortClose(handle);
         result = false;
       }
     }
     /* Get the current options for the port. */
     if (result)
     {
-      if (tcgetattr(portHandle, &options) == -1)
+      if (ioctl(serialPort->portHandle, TCGETS2, &options) == -1)
       {
-        SerialPortClose();
-        result = false;
-      }
-    }
-    /* Configure the baudrate. */
-    if (result)
-    {
-      if (cfsetispeed(&options, baudrateLookup[baudrate]) == -1)
-      {
-        SerialPortClose();
+        SerialPortClose(handle);
         result = false;
       }
     }
+    /* Configure the baudrate. Use the low level interface value for a standard
+     * baudrate and BOTHER for an arbitrary one. Note that the input baudrate follows
+     * the output baudrate, because the input baudrate bits are cleared.
+     */
     if (result)
     {
-      if (cfsetospeed(&options, baudrateLookup[baudrate]) == -1)
+      options.c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT));
+      options.c_cflag |= BOTHER;
+      for (idx = 0; idx < (sizeof(baudrateLookup)/sizeof(baudrateLookup[0])); idx++)
       {
-        SerialPortClose();
-        result = false;
+        if (baudrateLookup[idx].baudrate == baudrate)
+        {
+          options.c_cflag &= ~CBAUD;
+          options.c_cflag |= baudrateLookup[idx].speed;
+          break;
+        }
       }
+      options.c_ispeed = baudrate;
+      options.c_ospeed = baudrate;
     }
 
     if (result)
@@ -179,20 +240,23 @@ bool SerialPortOpen(char const * portname, tSerialPortBaudrate baudrate)
       /* Configure timeouts. */
       options.c_cc[VMIN]  = 0;
       options.c_cc[VTIME] = 1; /* in units of 1/10th of a second */
-      /* Set the new options for the port. */
-      if (tcsetattr(portHandle, TCSAFLUSH, &options) == -1)
+      /* Set the new options for the port, after discarding pending data. */
+      if (ioctl(serialPort->portHandle, TCSETSF2, &options) == -1)
       {
-        SerialPortClose();
+        SerialPortClose(handle);
         result = false;
       }
     }
-    /* Turn on DTR. */
+    /* Turn on DTR. Note that pseudo terminals do not have modem control lines and
+     * report ENOTTY, which is not a reason to fail.
+     */
     if (result)
     {
       iFlags = TIOCM_DTR;
-      if (ioctl(portHandle, TIOCMBIS, &iFlags) == -1)
+      if ( (ioctl(serialPort->portHandle, TIOCMBIS, &iFlags) == -1) &&
+           (errno != ENOTTY) )
       {
-        SerialPortClose();
+        SerialPortClose(handle);
         result = false;
       }
     }
@@ -205,40 +269,53 @@ bool SerialPortOpen(char const * portname, tSerialPortBaudrate baudrate)
 
 /************************************************************************************//**
 ** \brief     Closes the connection with the serial port.
+** \param     handle Handle of the serial port object.
 **
 ****************************************************************************************/
-void SerialPortClose(void)
+void SerialPortClose(tSerialPortHandle handle)
 {
-  /* Close the port handle if valid. */
-  if (portHandle != SERIALPORT_INVALID_HANDLE)
+  tSerialPortObj * serialPort = (tSerialPortObj *)handle;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only continue with valid parameters. */
+  if (serialPort != NULL) /*lint !e774 */
   {
-    close(portHandle);
+    /* Close the port handle if valid. */
+    if (serialPort->portHandle != SERIALPORT_INVALID_HANDLE)
+    {
+      close(serialPort->portHandle);
+    }
+    /* Invalidate handle. */
+    serialPort->portHandle = SERIALPORT_INVALID_HANDLE;
   }
-  /* Invalidate handle. */
-  portHandle = SERIALPORT_INVALID_HANDLE;
 } /*** end of SerialPortClose ***/
 
 
 /************************************************************************************//**
 ** \brief     Writes data to the serial port.
+** \param     handle Handle of the serial port object.
 ** \param     data Pointer to byte array with data to write.
 ** \param     length Number of bytes to write.
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-bool SerialPortWrite(uint8_t const * data, uint32_t length)
+bool SerialPortWrite(tSerialPortHandle handle, uint8_t const * data, uint32_t length)
 {
+  tSerialPortObj * serialPort = (tSerialPortObj *)handle;
   bool result = false;
 
   /* Check parameters. */
+  assert(handle != NULL);
   assert(data != NULL);
   assert(length > 0);
 
   /* Only continue with valid parameters. */
-  if ( (data != NULL) && (length > 0) ) /*lint !e774 */
+  if ( (serialPort != NULL) && (data != NULL) && (length > 0) ) /*lint !e774 */
   {
     /* Submit the data for sending. */
-    if ((uint32_t)write(portHandle, data, length) == length)
+    if ((uint32_t)write(serialPort->portHandle, data, length) == length)
     {
       result = true;
     }
@@ -250,24 +327,27 @@ bool SerialPortWrite(uint8_t const * data, uint32_t length)
 
 /************************************************************************************//**
 ** \brief     Reads data from the serial port in a blocking manner.
+** \param     handle Handle of the serial port object.
 ** \param     data Pointer to byte array to store read data.
 ** \param     length Number of bytes to read.
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-bool SerialPortRead(uint8_t * data, uint32_t length)
+bool SerialPortRead(tSerialPortHandle handle, uint8_t * data, uint32_t length)
 {
+  tSerialPortObj * serialPort = (tSerialPortObj *)handle;
   bool result = false;
 
   /* Check parameters. */
+  assert(handle != NULL);
   assert(data != NULL);
   assert(length > 0);
   
   /* Only continue with valid parameters. */
-  if ( (data != NULL) && (length > 0) ) /*lint !e774 */
+  if ( (serialPort != NULL) && (data != NULL) && (length > 0) ) /*lint !e774 */
   {
     /* Attempt to read the requested data. */
-    if ((uint32_t)read(portHandle, data, length) == length)
+    if ((uint32_t)read(serialPort->portHandle, data, length) == length)
     {
       result = true;
     }
@@ -277,5 +357,69 @@ bool SerialPortRead(uint8_t * data, uint32_t length)
 } /*** end of SerialPortRead ***/
 
 
+/************************************************************************************//**
+** \brief     Reads the data that is available on the serial port, without waiting for
+**            a specific number of bytes. If no data is available yet, it waits for data
+**            to arrive, for at most the specified time. All data that is available is
+**            read with a single system call, up to the size of the byte array.
+** \param     handle Handle of the serial port object.
+** \param     data Pointer to byte array to store read data.
+** \param     length Maximum number of bytes to read.
+** \param     timeout Maximum time in microseconds to wait for data to arrive.
+** \return    Number of bytes that were read. Zero if a timeout or error occurred.
+**
+****************************************************************************************/
+uint32_t SerialPortReadAvailable(tSerialPortHandle handle, uint8_t * data,
+                                 uint32_t length, uint32_t timeout)
+{
+  tSerialPortObj * serialPort = (tSerialPortObj *)handle;
+  uint32_t result = 0;
+  struct pollfd pollFd;
+  struct timespec pollTimeout;
+  ssize_t bytesRead;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+  assert(data != NULL);
+  assert(length > 0);
+
+  /* Only continue with valid parameters and an opened port. */
+  if ( (serialPort != NULL) && (data != NULL) && (length > 0) &&
+       (serialPort->portHandle != SERIALPORT_INVALID_HANDLE) ) /*lint !e774 */
+  {
+    /* Wait for data to arrive. Note that ppoll() is used, because its timeout has a
+     * higher resolution than the one of poll().
+     */
+    pollFd.fd = serialPort->portHandle;
+    pollFd.events = POLLIN;
+    pollFd.revents = 0;
+    pollTimeout.tv_sec = (time_t)(timeout / 1000000u);
+    pollTimeout.tv_nsec = (long)((timeout % 1000000u) * 1000u);
+    if (ppoll(&pollFd, 1, &pollTimeout, NULL) > 0)
+    {
+      /* Read all data that is available. */
+      if ((pollFd.revents & POLLIN) != 0)
+      {
+        bytesRead = read(serialPort->portHandle, data, length);
+        if (bytesRead > 0)
+        {
+          result = (uint32_t)bytesRead;
+        }
+      }
+      /* After a hang up, for example of an unplugged USB serial adapter, ppoll() keeps
+       * on returning right away. Wait out the timeout, to not make the caller spin
+       * until its deadline expires.
+       */
+      if ( (result == 0) && ((pollFd.revents & (POLLHUP | POLLERR | POLLNVAL)) != 0) )
+      {
+        (void)nanosleep(&pollTimeout, NULL);
+      }
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of SerialPortReadAvailable ***/
+
+
 /*********************************** end of serialport.c *******************************/
 
@@ -0,0 +1,311 @@
+/************************************************************************************//**
+* \file         port/linux/threadutil.c
+* \brief        Thread and event utility source file.
+* \ingroup      Utility
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+* 
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+* 
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+* 
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include <assert.h>                         /* for assertions                          */
+#include <stdint.h>                         /* for standard integer types              */
+#include <stddef.h>                         /* for NULL declaration                    */
+#include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
+#include <unistd.h>                         /* for read, write and close               */
+#include <errno.h>                          /* for error numbers                       */
+#include <poll.h>                           /* for polling file descriptors            */
+#include <pthread.h>                        /* for posix threads                       */
+#include <sys/eventfd.h>                    /* for event file descriptors              */
+#include "util.h"                           /* Utility module                          */
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Layout of a thread object. */
+typedef struct t_util_thread_obj
+{
+  pthread_t threadId;            /**< Identifier of the posix thread.                  */
+  tUtilThreadFunc func;          /**< Function that runs in the thread.                */
+  void * arg;                    /**< Argument that is passed to the function.         */
+} tUtilThreadObj;
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+static void * UtilThreadEntry(void * param);
+
+
+/************************************************************************************//**
+** \brief     Creates a new thread that runs the specified function.
+** \param     func The function to run in the thread.
+** \param     arg Argument to pass to the function.
+** \return    Handle to the newly created thread object if successful, NULL otherwise.
+**
+****************************************************************************************/
+tUtilThread UtilThreadCreate(tUtilThreadFunc func, void * arg)
+{
+  tUtilThread result = NULL;
+  tUtilThreadObj * threadObj;
+
+  /* Check parameters. */
+  assert(func != NULL);
+
+  /* Only continue with valid parameters. */
+  if (func != NULL) /*lint !e774 */
+  {
+    /* Allocate memory for the thread object. */
+    threadObj = malloc(sizeof(tUtilThreadObj));
+    assert(threadObj != NULL);
+    /* Only continue if the allocation was successful. */
+    if (threadObj != NULL) /*lint !e774 */
+    {
+      threadObj->func = func;
+      threadObj->arg = arg;
+      /* Start the thread and only hand it out if this was successful. */
+      if (pthread_create(&threadObj->threadId, NULL, &UtilThreadEntry,
+                         threadObj) == 0) /*lint !e546 */
+      {
+        result = threadObj;
+      }
+      else
+      {
+        free(threadObj);
+      }
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilThreadCreate ***/
+
+
+/************************************************************************************//**
+** \brief     Waits for a thread, that was previously created with UtilThreadCreate, to
+**            end and releases the thread object afterwards.
+** \param     thread Handle to the thread object.
+**
+****************************************************************************************/
+void UtilThreadJoin(tUtilThread thread)
+{
+  /* Only continue with a valid handle. Note that a NULL handle is allowed, in which
+   * case there is nothing to join.
+   */
+  if (thread != NULL)
+  {
+    (void)pthread_join(((tUtilThreadObj *)thread)->threadId, NULL);
+    free(thread);
+  }
+} /*** end of UtilThreadJoin ***/
+
+
+/************************************************************************************//**
+** \brief     Creates a new event object, which starts out in the reset state. The event
+**            is built on an event file descriptor. This makes it possible for an
+**            application to poll the event together with its own file descriptors.
+** \return    Handle to the newly created event object if successful, NULL otherwise.
+**
+****************************************************************************************/
+tUtilEvent UtilEventCreate(void)
+{
+  tUtilEvent result = NULL;
+  int * eventObj;
+
+  /* Allocate memory for the event object. */
+  eventObj = malloc(sizeof(int));
+  assert(eventObj != NULL);
+  /* Only continue if the allocation was successful. */
+  if (eventObj != NULL) /*lint !e774 */
+  {
+    /* Create the event file descriptor and only hand it out if this was successful. */
+    *eventObj = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (*eventObj >= 0)
+    {
+      result = eventObj;
+    }
+    else
+    {
+      free(eventObj);
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilEventCreate ***/
+
+
+/************************************************************************************//**
+** \brief     Destroys an event object that was previously created with UtilEventCreate.
+**            No thread should be waiting for the event when calling this function.
+** \param     event Handle to the event object.
+**
+****************************************************************************************/
+void UtilEventDestroy(tUtilEvent event)
+{
+  /* Only continue with a valid handle. Note that a NULL handle is allowed, in which
+   * case there is nothing to destroy.
+   */
+  if (event != NULL)
+  {
+    (void)close(*(int *)event);
+    free(event);
+  }
+} /*** end of UtilEventDestroy ***/
+
+
+/************************************************************************************//**
+** \brief     Sets an event object. The event stays set until it is reset.
+** \param     event Handle to the event object.
+**
+****************************************************************************************/
+void UtilEventSet(tUtilEvent event)
+{
+  uint64_t value = 1;
+
+  /* Check parameters. */
+  assert(event != NULL);
+
+  /* Only continue with a valid handle. */
+  if (event != NULL) /*lint !e774 */
+  {
+    /* Adding to the counter makes the file descriptor readable. Note that this can
+     * only fail if the counter is about to overflow, in which case it is already set.
+     */
+    (void)write(*(int *)event, &value, sizeof(value));
+  }
+} /*** end of UtilEventSet ***/
+
+
+/************************************************************************************//**
+** \brief     Resets an event object.
+** \param     event Handle to the event object.
+**
+****************************************************************************************/
+void UtilEventReset(tUtilEvent event)
+{
+  uint64_t value;
+
+  /* Check parameters. */
+  assert(event != NULL);
+
+  /* Only continue with a valid handle. */
+  if (event != NULL) /*lint !e774 */
+  {
+    /* Reading clears the counter. This fails if it was already cleared, which is
+     * fine.
+     */
+    (void)read(*(int *)event, &value, sizeof(value));
+  }
+} /*** end of UtilEventReset ***/
+
+
+/************************************************************************************//**
+** \brief     Waits for an event object to become set. The event is not reset by this
+**            function.
+** \param     event Handle to the event object.
+** \param     timeout Maximum time in milliseconds to wait. UTIL_EVENT_WAIT_INFINITE
+**            waits without a timeout.
+** \return    True if the event is set, false if the timeout expired.
+**
+****************************************************************************************/
+bool UtilEventWait(tUtilEvent event, uint32_t timeout)
+{
+  bool result = false;
+  struct pollfd pollFd;
+  int pollTimeout = -1;
+  int pollResult;
+
+  /* Check parameters. */
+  assert(event != NULL);
+
+  /* Only continue with a valid handle. */
+  if (event != NULL) /*lint !e774 */
+  {
+    /* Convert the timeout. */
+    if (timeout != UTIL_EVENT_WAIT_INFINITE)
+    {
+      pollTimeout = (timeout < (uint32_t)INT32_MAX) ? (int)timeout : INT32_MAX;
+    }
+    pollFd.fd = *(int *)event;
+    pollFd.events = POLLIN;
+    /* Wait for the file descriptor to become readable. Retry when interrupted by a
+     * signal.
+     */
+    do
+    {
+      pollResult = poll(&pollFd, 1, pollTimeout);
+    }
+    while ( (pollResult < 0) && (errno == EINTR) );
+    if (pollResult > 0)
+    {
+      result = true;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilEventWait ***/
+
+
+/************************************************************************************//**
+** \brief     Obtains the operating system handle of an event object. This is a file
+**            descriptor that is readable while the event is set.
+** \param     event Handle to the event object.
+** \return    The file descriptor of the event. -1 if the handle is invalid.
+**
+****************************************************************************************/
+intptr_t UtilEventGetHandle(tUtilEvent event)
+{
+  intptr_t result = -1;
+
+  /* Only continue with a valid handle. */
+  if (event != NULL)
+  {
+    result = *(int *)event;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilEventGetHandle ***/
+
+
+/************************************************************************************//**
+** \brief     Entry point of the threads that are created with UtilThreadCreate. It runs
+**            the thread function.
+** \param     param Pointer to the thread object.
+** \return    Always NULL.
+**
+****************************************************************************************/
+static void * UtilThreadEntry(void * param)
+{
+  tUtilThreadObj * threadObj = (tUtilThreadObj *)param;
+
+  /* Run the thread function. */
+  threadObj->func(threadObj->arg);
+  return NULL;
+} /*** end of UtilThreadEntry ***/
+
+
+/*********************************** end of threadutil.c *******************************/
@@ -35,27 +35,102 @@
 #include <stddef.h>                         /* for NULL declaration                    */
 #include <stdbool.h>                        /* for boolean type                        */
 #include <unistd.h>                         /* UNIX standard functions                 */
-#include <sys/time.h>                       /* time definitions                        */
+#include <errno.h>                          /* for error numbers                       */
+#include <time.h>                           /* for clock functions                     */
 #include "util.h"                           /* Utility module                          */
 
 
 /************************************************************************************//**
-** \brief     Get the system time in milliseconds.
+** \brief     Get the system time in milliseconds. It is based on the monotonic clock, so
+**            it does not jump when the wall-clock time is adjusted. Use it for measuring
+**            time intervals, not for the time of day.
 ** \return    Time in milliseconds.
 **
 ****************************************************************************************/
 uint32_t UtilTimeGetSystemTimeMs(void)
 {
-  uint32_t result = 0;
-  struct timeval tv;
+  return (uint32_t)(UtilTimeGetMonotonicUs() / 1000u);
+} /*** end of UtilTimeGetSystemTimeMs ***/
+
 
-  if (gettimeofday(&tv, NULL) == 0)
+/************************************************************************************//**
+** \brief     Get the system time in microseconds since the epoch. This is the same time
+**            base as the one of the software time stamps that the kernel attaches to
+**            received network packets, so the two can be compared with each other. It
+**            jumps when the wall-clock time is adjusted, so use UtilTimeGetMonotonicUs
+**            for timeouts and for measuring time intervals.
+** \return    Time in microseconds.
+**
+****************************************************************************************/
+uint64_t UtilTimeGetSystemTimeUs(void)
+{
+  uint64_t result = 0;
+  struct timespec ts;
+
+  if (clock_gettime(CLOCK_REALTIME, &ts) == 0)
   {
-    result = (((uint32_t)tv.tv_sec * 1000ul) + ((uint32_t)tv.tv_usec / 1000ul));
+    result = ((uint64_t)ts.tv_sec * 1000000ull) + ((uint64_t)ts.tv_nsec / 1000ull);
   }
   /* Give the result back to the caller. */
   return result;
-} /*** end of UtilTimeGetSystemTimeMs ***/
+} /*** end of UtilTimeGetSystemTimeUs ***/
+
+
+/************************************************************************************//**
+** \brief     Get the time of the monotonic clock in nanoseconds. This clock does not
+**            jump when the wall-clock time is adjusted, for example by NTP. The time at
+**            which it started is unspecified, so it is only useful for measuring time
+**            intervals and for deadlines.
+** \return    Time in nanoseconds.
+**
+****************************************************************************************/
+uint64_t UtilTimeGetMonotonicNs(void)
+{
+  uint64_t result = 0;
+  struct timespec ts;
+
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+  {
+    result = ((uint64_t)ts.tv_sec * 1000000000ull) + (uint64_t)ts.tv_nsec;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilTimeGetMonotonicNs ***/
+
+
+/************************************************************************************//**
+** \brief     Get the time of the monotonic clock in microseconds. See
+**            UtilTimeGetMonotonicNs.
+** \return    Time in microseconds.
+**
+****************************************************************************************/
+uint64_t UtilTimeGetMonotonicUs(void)
+{
+  return UtilTimeGetMonotonicNs() / 1000u;
+} /*** end of UtilTimeGetMonotonicUs ***/
+
+
+/************************************************************************************//**
+** \brief     Sleeps until the monotonic clock reaches the specified time. The
+**            time is slept with an absolute wake-up time, so it does not add up errors
+**            like a relative delay does. Note that the kernel wakes up the thread
+**            somewhat later than requested, typically around 100 microseconds.
+** \param     deadline Monotonic time in microseconds to sleep until. Returns right away
+**            if it already passed.
+**
+****************************************************************************************/
+void UtilTimeSleepUntilUs(uint64_t deadline)
+{
+  struct timespec wakeTime;
+
+  /* Sleep until the deadline. Retry when interrupted by a signal. */
+  wakeTime.tv_sec = (time_t)(deadline / 1000000u);
+  wakeTime.tv_nsec = (long)((deadline % 1000000u) * 1000u);
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeTime, NULL) == EINTR)
+  {
+    ;
+  }
+} /*** end of UtilTimeSleepUntilUs ***/
 
 
 /************************************************************************************//**
@@ -94,7 +94,8 @@ static const tCanInterface ixxatVciInterface =
   IxxatVciDisconnect,
   IxxatVciTransmit,
   IxxatVciIsBusError,
-  IxxatVciRegisterEvents
+  IxxatVciRegisterEvents,
+  NULL
 };
 
 
@@ -781,6 +782,8 @@ static DWORD WINAPI IxxatVciReceptionThread(LPVOID pv)
         {
           rxMsg.data[idx] = sCanMsg.abData[idx];
         }
+        /* Reception time stamps are not supported by this CAN interface. */
+        rxMsg.timestamp = 0;
 
         /* Trigger message reception event(s). */
         pEvents = ixxatVciEventsList;
@@ -117,7 +117,8 @@ static const tCanInterface leafLightInterface =
   LeafLightDisconnect,
   LeafLightTransmit,
   LeafLightIsBusError,
-  LeafLightRegisterEvents
+  LeafLightRegisterEvents,
+  NULL
 };
 
 
@@ -774,6 +775,8 @@ static DWORD WINAPI LeafLightReceptionThread(LPVOID pv)
                   rxMsg.id |= CAN_MSG_EXT_ID_MASK;
                 }
                 rxMsg.dlc = (uint8_t)rxDlc;
+                /* Reception time stamps are not supported by this CAN interface. */
+                rxMsg.timestamp = 0;
 
                 /* Trigger message reception event(s). */
                 pEvents = leafLightEventsList;
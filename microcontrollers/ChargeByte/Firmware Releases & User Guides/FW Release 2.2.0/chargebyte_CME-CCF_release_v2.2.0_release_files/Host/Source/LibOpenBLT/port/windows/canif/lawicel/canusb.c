@@ -94,7 +94,8 @@ static const tCanInterface canUsbInterface =
   CanUsbDisconnect,
   CanUsbTransmit,
   CanUsbIsBusError,
-  CanUsbRegisterEvents
+  CanUsbRegisterEvents,
+  NULL
 };
 
 
@@ -669,6 +670,8 @@ static void __stdcall CanUsbLibReceiveCallback(CANMsg const * pMsg)
       {
         rxMsg.data[idx] = pMsg->data[idx];
       }
+      /* Reception time stamps are not supported by this CAN interface. */
+      rxMsg.timestamp = 0;
       /* Trigger message reception event(s). */
       pEvents = canUsbEventsList;
       for (uint32_t idx = 0; idx < canUsbEventsEntries; idx++)
@@ -108,7 +108,8 @@ static const tCanInterface pCanUsbInterface =
   PCanUsbDisconnect,
   PCanUsbTransmit,
   PCanUsbIsBusError,
-  PCanUsbRegisterEvents
+  PCanUsbRegisterEvents,
+  NULL
 };
 
 /** \brief PCAN-USB channel handle lookup table. The pCanUsbSettings.channel value can
@@ -707,6 +708,8 @@ static DWORD WINAPI PCanUsbReceptionThread(LPVOID pv)
             {
               rxMsg.data[idx] = rxLibMsg.DATA[idx];
             }
+            /* Reception time stamps are not supported by this CAN interface. */
+            rxMsg.timestamp = 0;
 
             /* Trigger message reception event(s). */
             pEvents = pCanUsbEventsList;
@@ -79,7 +79,8 @@ static const tCanInterface pVectorXlInterface =
   VectorXlDisconnect,
   VectorXlTransmit,
   VectorXlIsBusError,
-  VectorXlRegisterEvents
+  VectorXlRegisterEvents,
+  NULL
 };
 
 
@@ -113,6 +114,9 @@ static bool vectorXlChannelActivated;
 /** \brief Boolean flag to detect if a CAN bus error state was detected. ***/
 static bool vectorXlBusErrorDetected;
 
+/** \brief Critical section object that protects the bus error flag. ***/
+static tUtilCriticalSection vectorXlCritSect;
+
 /** \brief Handle for the event to terminate the reception thread. */
 static HANDLE vectorXlTerminateEvent;
 
@@ -158,8 +162,9 @@ static void VectorXlInit(tCanSettings const * settings)
   vectorXlCanEvent = NULL;
   vectorXlRxThreadHandle = NULL;
   
-  /* This module uses critical sections so initialize them. */
-  UtilCriticalSectionInit();
+  /* Create the critical section object for protecting the bus error flag. */
+  vectorXlCritSect = UtilCriticalSectionCreate();
+  assert(vectorXlCritSect != NULL);
 
   /* Reset CAN interface settings. */
   vectorXlSettings.devicename = "";
@@ -238,8 +243,9 @@ static void VectorXlTerminate(void)
     free(vectorXlEventsList);
     vectorXlEventsEntries = 0;
   }
-  /* This module used critical sections so terminate them. */
-  UtilCriticalSectionTerminate();
+  /* Destroy the critical section object. */
+  UtilCriticalSectionDestroy(vectorXlCritSect);
+  vectorXlCritSect = NULL;
 } /*** end of VectorXlTerminate ***/
 
 
@@ -626,7 +632,7 @@ static bool VectorXlIsBusError(void)
   (void)xlCanRequestChipState(vectorXlPortHandle, vectorXLChannelMask);
 
   /* Enter critical section. */
-  UtilCriticalSectionEnter();
+  UtilCriticalSectionLock(vectorXlCritSect);
   
   /* Was a bus error chip state detected by the reception thread? */
   if (vectorXlBusErrorDetected)
@@ -638,7 +644,7 @@ static bool VectorXlIsBusError(void)
   }
   
   /* Exit critical section. */
-  UtilCriticalSectionExit();
+  UtilCriticalSectionUnlock(vectorXlCritSect);
 
   /* Give the result back to the caller. */
   return result;
@@ -809,6 +815,8 @@ static DWORD WINAPI VectorXlReceptionThread(LPVOID pv)
                 {
                   rxMsg.data[byteIdx] = xlEvent.tagData.msg.data[byteIdx];
                 }
+                /* Reception time stamps are not supported by this CAN interface. */
+                rxMsg.timestamp = 0;
                 /* Trigger message reception event(s). */
                 pEvents = vectorXlEventsList;
                 for (uint32_t idx = 0; idx < vectorXlEventsEntries; idx++)
@@ -833,13 +841,13 @@ static DWORD WINAPI VectorXlReceptionThread(LPVOID pv)
                    ((xlEvent.tagData.chipState.busStatus & XL_CHIPSTAT_ERROR_PASSIVE) != 0))
               {
                 /* Enter critical section. */
-                UtilCriticalSectionEnter();
+                UtilCriticalSectionLock(vectorXlCritSect);
                 /* Set bus error flag. Note that this flag is automatically reset by
                  * VectorXlIsBusError.
                  */
                 vectorXlBusErrorDetected = true;
                 /* Exit critical section. */
-                UtilCriticalSectionExit();
+                UtilCriticalSectionUnlock(vectorXlCritSect);
               }
             }
           }  
@@ -33,7 +33,9 @@
 ****************************************************************************************/
 #include <assert.h>                         /* for assertions                          */
 #include <stdint.h>                         /* for standard integer types              */
+#include <stddef.h>                         /* for NULL declaration                    */
 #include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
 #include <windows.h>                        /* for windows library                     */
 #include "util.h"                           /* Utility module                          */
 
@@ -41,88 +43,135 @@
 /****************************************************************************************
 * Local data declarations
 ****************************************************************************************/
-/** \brief Flag to determine if the critical section object was already initialized. */
-static volatile bool criticalSectionInitialized = false;
+/** \brief Initialization state of the process wide critical section: 0 = not yet
+ *         initialized, 1 = initialization in progress, 2 = initialized. A critical
+ *         section object cannot be statically initialized on Windows, so it is
+ *         initialized the first time that it is obtained.
+ */
+static volatile LONG utilCriticalSectionGlobalState = 0;
 
-/** \brief Critical section object. */
-static CRITICAL_SECTION criticalSection;
+/** \brief Process wide critical section object. */
+static CRITICAL_SECTION utilCriticalSectionGlobal;
 
 
 /************************************************************************************//**
-** \brief     Initializes the critical section module. Should be called before the
-**            Enter/Exit functions are used. It is okay to call this initialization
-**            multiple times from different modules.
+** \brief     Creates a new critical section object. Each module that needs to protect
+**            its own shared data should create its own critical section object. This
+**            way unrelated modules never have to wait on each other.
+** \return    Handle to the newly created critical section object if successful, NULL
+**            otherwise.
 **
 ****************************************************************************************/
-void UtilCriticalSectionInit(void)
+tUtilCriticalSection UtilCriticalSectionCreate(void)
 {
-  /* Only initialize if not yet done so previously. */
-  if (!criticalSectionInitialized)
+  tUtilCriticalSection result = NULL;
+  CRITICAL_SECTION * critSectObj;
+
+  /* Allocate memory for the critical section object. */
+  critSectObj = malloc(sizeof(CRITICAL_SECTION));
+  assert(critSectObj != NULL);
+  /* Only continue if the allocation was successful. */
+  if (critSectObj != NULL) /*lint !e774 */
   {
     /* Initialize the critical section object. */
-    InitializeCriticalSection((CRITICAL_SECTION *)&criticalSection);
-    /* Set initialized flag. */
-    criticalSectionInitialized = true;
+    InitializeCriticalSection(critSectObj);
+    result = critSectObj;
   }
-} /*** end of UtilCriticalSectionInit ***/
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilCriticalSectionCreate ***/
 
 
 /************************************************************************************//**
-** \brief     Terminates the critical section module. Should be called once critical
-**            sections are no longer needed. Typically called from another module's
-**            termination function that also initialized it. It is okay to call this 
-**            termination multiple times from different modules.
+** \brief     Destroys a critical section object that was previously created with
+**            UtilCriticalSectionCreate. The critical section should not be locked
+**            when calling this function.
+** \param     critSect Handle to the critical section object.
 **
 ****************************************************************************************/
-void UtilCriticalSectionTerminate(void)
+void UtilCriticalSectionDestroy(tUtilCriticalSection critSect)
 {
-  /* Only terminate if it was initialized. */
-  if (criticalSectionInitialized)
+  /* Only continue with a valid handle. Note that a NULL handle is allowed, in which
+   * case there is nothing to destroy.
+   */
+  if (critSect != NULL)
   {
-    /* Reset the initialized flag. */
-    criticalSectionInitialized = false;
-    /* Delete the critical section object. */
-    DeleteCriticalSection((CRITICAL_SECTION *)&criticalSection);
+    /* Delete the critical section object and release its memory. */
+    DeleteCriticalSection((CRITICAL_SECTION *)critSect);
+    free(critSect);
   }
-} /*** end of UtilCriticalSectionTerminate ***/
+} /*** end of UtilCriticalSectionDestroy ***/
 
 
+/************************************************************************************//**
+** \brief     Obtains the process wide critical section object. Unlike the ones created
+**            with UtilCriticalSectionCreate, it exists from the start and is never
+**            destroyed. It is meant for protecting the initialization and termination
+**            of modules that are shared by multiple users, because these cannot use a
+**            critical section object that they create themselves during their
+**            initialization. It should only be locked for short periods of time.
+** \return    Handle to the process wide critical section object.
+**
+****************************************************************************************/
+tUtilCriticalSection UtilCriticalSectionGetGlobal(void)
+{
+  /* Initialize the critical section object, if this was not yet done. The interlocked
+   * exchange makes sure that only the first caller initializes it. Other callers wait
+   * until this first caller is done.
+   */
+  if (InterlockedCompareExchange(&utilCriticalSectionGlobalState, 1, 0) == 0)
+  {
+    InitializeCriticalSection(&utilCriticalSectionGlobal);
+    (void)InterlockedExchange(&utilCriticalSectionGlobalState, 2);
+  }
+  else
+  {
+    while (InterlockedCompareExchange(&utilCriticalSectionGlobalState, 2, 2) != 2)
+    {
+      Sleep(0);
+    }
+  }
+  /* Give the result back to the caller. */
+  return &utilCriticalSectionGlobal;
+} /*** end of UtilCriticalSectionGetGlobal ***/
+
 
 /************************************************************************************//**
-** \brief     Enters a critical section. The functions UtilCriticalSectionEnter and 
-**            UtilCriticalSectionExit should always be used in a pair.
+** \brief     Locks a critical section object. The functions UtilCriticalSectionLock and
+**            UtilCriticalSectionUnlock should always be used in a pair.
+** \param     critSect Handle to the critical section object.
 **
 ****************************************************************************************/
-void UtilCriticalSectionEnter(void)
+void UtilCriticalSectionLock(tUtilCriticalSection critSect)
 {
-  /* Check initialization. */
-  assert(criticalSectionInitialized);
+  /* Check parameters. */
+  assert(critSect != NULL);
 
-  /* Only continue if actually initialized. */
-  if (criticalSectionInitialized)
+  /* Only continue with a valid handle. */
+  if (critSect != NULL) /*lint !e774 */
   {
-    EnterCriticalSection((CRITICAL_SECTION *)&criticalSection);
+    EnterCriticalSection((CRITICAL_SECTION *)critSect);
   }
-} /*** end of UtilCriticalSectionEnter ***/
+} /*** end of UtilCriticalSectionLock ***/
 
 
 /************************************************************************************//**
-** \brief     Leaves a critical section. The functions UtilCriticalSectionEnter and 
-**            UtilCriticalSectionExit should always be used in a pair.
+** \brief     Unlocks a critical section object. The functions UtilCriticalSectionLock
+**            and UtilCriticalSectionUnlock should always be used in a pair.
+** \param     critSect Handle to the critical section object.
 **
 ****************************************************************************************/
-void UtilCriticalSectionExit(void)
+void UtilCriticalSectionUnlock(tUtilCriticalSection critSect)
 {
-  /* Check initialization. */
-  assert(criticalSectionInitialized);
+  /* Check parameters. */
+  assert(critSect != NULL);
 
-  /* Only continue if actually initialized. */
-  if (criticalSectionInitialized)
+  /* Only continue with a valid handle. */
+  if (critSect != NULL) /*lint !e774 */
   {
-    LeaveCriticalSection((CRITICAL_SECTION *)&criticalSection);
+    LeaveCriticalSection((CRITICAL_SECTION *)critSect);
   }
-} /*** end of UtilCriticalSectionExit ***/
+} /*** end of UtilCriticalSectionUnlock ***/
 
 
 /*********************************** end of critutil.c *********************************/
-
@@ -0,0 +1,224 @@
+/************************************************************************************//**
+* \file         port/windows/fileutil.c
+* \brief        File utility source file.
+* \ingroup      Utility
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+* 
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+* 
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+* 
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include <assert.h>                         /* for assertions                          */
+#include <stdint.h>                         /* for standard integer types              */
+#include <stddef.h>                         /* for NULL declaration                    */
+#include <stdbool.h>                        /* for boolean type                        */
+#include <stdio.h>                          /* Standard I/O functions.                 */
+#include <windows.h>                        /* for windows library                     */
+#include "util.h"                           /* Utility module                          */
+
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Number of 100 nanosecond intervals between the FILETIME epoch (1601) and the
+ *         UNIX epoch (1970).
+ */
+#define UTIL_FILE_EPOCH_OFFSET         (116444736000000000ull)
+
+
+/************************************************************************************//**
+** \brief     Maps the contents of a file into memory for reading. The pages are only
+**            read from the file once they are accessed, so this is faster than reading
+**            the entire file, if it is already in the file cache of the operating
+**            system.
+** \param     filename Name of the file.
+** \param     len Pointer where the number of bytes in the file is written to.
+** \return    Pointer to the contents of the file if successful, NULL otherwise. An
+**            empty file cannot be mapped. Release it with UtilFileUnmap.
+**
+****************************************************************************************/
+uint8_t const * UtilFileMap(char const * filename, uint32_t * len)
+{
+  uint8_t const * result = NULL;
+  HANDLE fileHandle;
+  HANDLE mappingHandle;
+  LARGE_INTEGER fileSize;
+
+  /* Check parameters. */
+  assert(filename != NULL);
+  assert(len != NULL);
+
+  /* Only continue if parameters are valid. */
+  if ( (filename != NULL) && (len != NULL) ) /*lint !e774 */
+  {
+    /* Allow other processes to remove or replace the file while it is mapped. */
+    fileHandle = CreateFileA(filename, GENERIC_READ,
+                             FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                             NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (fileHandle != INVALID_HANDLE_VALUE)
+    {
+      if ( (GetFileSizeEx(fileHandle, &fileSize)) && (fileSize.QuadPart > 0) &&
+           (fileSize.QuadPart <= (LONGLONG)UINT32_MAX) )
+      {
+        mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mappingHandle != NULL)
+        {
+          result = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+          if (result != NULL)
+          {
+            *len = (uint32_t)fileSize.QuadPart;
+          }
+          /* The view stays valid after closing the mapping and the file. */
+          (void)CloseHandle(mappingHandle);
+        }
+      }
+      (void)CloseHandle(fileHandle);
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilFileMap ***/
+
+
+/************************************************************************************//**
+** \brief     Releases the contents of a file that was mapped into memory.
+** \param     data Pointer to the contents of the file, as returned by UtilFileMap.
+** \param     len Number of bytes in the file.
+**
+****************************************************************************************/
+void UtilFileUnmap(uint8_t const * data, uint32_t len)
+{
+  /* Check parameters. */
+  assert(data != NULL);
+
+  (void)len;
+
+  /* Only continue if parameters are valid. */
+  if (data != NULL) /*lint !e774 */
+  {
+    (void)UnmapViewOfFile(data);
+  }
+} /*** end of UtilFileUnmap ***/
+
+
+/************************************************************************************//**
+** \brief     Sets the time of the last modification of a file to the current time.
+** \param     filename Name of the file.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+bool UtilFileTouch(char const * filename)
+{
+  bool result = false;
+  HANDLE fileHandle;
+  FILETIME now;
+
+  /* Check parameters. */
+  assert(filename != NULL);
+
+  /* Only continue if parameters are valid. */
+  if (filename != NULL) /*lint !e774 */
+  {
+    fileHandle = CreateFileA(filename, FILE_WRITE_ATTRIBUTES,
+                             FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                             NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (fileHandle != INVALID_HANDLE_VALUE)
+    {
+      GetSystemTimeAsFileTime(&now);
+      if (SetFileTime(fileHandle, NULL, NULL, &now))
+      {
+        result = true;
+      }
+      (void)CloseHandle(fileHandle);
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilFileTouch ***/
+
+
+/************************************************************************************//**
+** \brief     Calls a function for each regular file in a directory.
+** \param     directory Name of the directory.
+** \param     func Function to call with the name of the file, without the directory,
+**            its size in bytes and the time of its last modification in microseconds
+**            since the epoch.
+** \param     arg Argument to pass on to the function.
+** \return    True if successful, false if the directory could not be opened.
+**
+****************************************************************************************/
+bool UtilFileScanDirectory(char const * directory, tUtilFileScanFunc func, void * arg)
+{
+  bool result = false;
+  char pattern[MAX_PATH];
+  HANDLE findHandle;
+  WIN32_FIND_DATAA findData;
+  uint64_t modified;
+
+  /* Check parameters. */
+  assert(directory != NULL);
+  assert(func != NULL);
+
+  /* Only continue if parameters are valid. */
+  if ( (directory != NULL) && (func != NULL) ) /*lint !e774 */
+  {
+    if (snprintf(pattern, sizeof(pattern), "%s\\*", directory) < (int)sizeof(pattern))
+    {
+      findHandle = FindFirstFileA(pattern, &findData);
+      if (findHandle != INVALID_HANDLE_VALUE)
+      {
+        result = true;
+        do
+        {
+          /* Only report regular files. */
+          if ((findData.dwFileAttributes & (FILE_ATTRIBUTE_DIRECTORY |
+                                            FILE_ATTRIBUTE_REPARSE_POINT)) == 0)
+          {
+            modified = ((uint64_t)findData.ftLastWriteTime.dwHighDateTime << 32) |
+                       findData.ftLastWriteTime.dwLowDateTime;
+            modified = (modified > UTIL_FILE_EPOCH_OFFSET) ?
+                       ((modified - UTIL_FILE_EPOCH_OFFSET) / 10u) : 0u;
+            func(findData.cFileName,
+                 ((uint64_t)findData.nFileSizeHigh << 32) | findData.nFileSizeLow,
+                 modified, arg);
+          }
+        }
+        while (FindNextFileA(findHandle, &findData));
+        (void)FindClose(findHandle);
+      }
+      else if (GetLastError() == ERROR_FILE_NOT_FOUND)
+      {
+        /* The directory exists, but it is empty. */
+        result = true;
+      }
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilFileScanDirectory ***/
+
+
+/*********************************** end of fileutil.c *********************************/
@@ -35,76 +35,103 @@
 #include <stdint.h>                         /* for standard integer types              */
 #include <stddef.h>                         /* for NULL declaration                    */
 #include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
 #include <winsock2.h>                       /* for WinSock2 definitions                */
 #include <ws2tcpip.h>                       /* for WinSock2 TCP/IP protocol extensions */
 #include "netaccess.h"                      /* TCP/IP network access module            */
 
 
 /****************************************************************************************
-* Local data declarations
+* Type definitions
 ****************************************************************************************/
-/** \brief Boolean flag to keep track if the Winsock library is initialized. */
-static bool winsockInitialized;
-
-/** \brief The socket that is used as an endpoint for the TCP/IP network
- * communication.
- */
-static SOCKET netAccessSocket;
+/** \brief Network access object. A network access handle points to one of these. */
+typedef struct t_net_access_obj
+{
+  /** \brief Boolean flag to keep track if the Winsock library is initialized. */
+  bool winsockInitialized;
+  /** \brief The socket that is used as an endpoint for the TCP/IP network
+   *         communication.
+   */
+  SOCKET sock;
+} tNetAccessObj;
 
 
 /************************************************************************************//**
-** \brief     Initializes the network access module.
+** \brief     Initializes a network access object. The Winsock library keeps track of
+**            the number of times it was initialized, so each object initializes it.
+** \return    Handle of the network access object or NULL in case of an error.
 **
 ****************************************************************************************/
-void NetAccessInit(void)
+tNetAccessHandle NetAccessInit(void)
 {
+  tNetAccessObj * netAccess;
   WSADATA wsa;
 
-  /* Invalidate the socket. */
-  netAccessSocket = INVALID_SOCKET;
-  
-  /* Init locals. */
-  winsockInitialized = false;
-  
-  /* Attempt to initialize the Winsock library. */
-  if (WSAStartup(MAKEWORD(2,2),&wsa) == 0)
+  /* Allocate memory for the network access object. */
+  netAccess = malloc(sizeof(tNetAccessObj));
+  assert(netAccess != NULL);
+  /* Only continue if the allocation was successful. */
+  if (netAccess != NULL) /*lint !e774 */
   {
-    /* Update flag. */
-    winsockInitialized = true;
+    /* Invalidate the socket. */
+    netAccess->sock = INVALID_SOCKET;
+    /* Init locals. */
+    netAccess->winsockInitialized = false;
+    /* Attempt to initialize the Winsock library. */
+    if (WSAStartup(MAKEWORD(2,2),&wsa) == 0)
+    {
+      /* Update flag. */
+      netAccess->winsockInitialized = true;
+    }
   }
+  /* Give the handle back to the caller. */
+  return netAccess;
 } /*** end of NetAccessInit ***/
 
 
 /************************************************************************************//**
-** \brief     Terminates the network access module.
+** \brief     Terminates a network access object and releases its memory.
+** \param     handle Handle of the network access object.
 **
 ****************************************************************************************/
-void NetAccessTerminate(void)
+void NetAccessTerminate(tNetAccessHandle handle)
 {
-  /* Make sure to disconnect form the server. */
-  NetAccessDisconnect();
-  
-  /* Cleanup the Winsock library, if it was initialized. */
-  if (winsockInitialized)
+  tNetAccessObj * netAccess = (tNetAccessObj *)handle;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only continue with valid parameters. */
+  if (netAccess != NULL) /*lint !e774 */
   {
-    /* Update flag. */
-    winsockInitialized = false;
-    /* Free Winsock resources. */
-    (void)WSACleanup();
+    /* Make sure to disconnect form the server. */
+    NetAccessDisconnect(handle);
+    /* Cleanup the Winsock library, if it was initialized. */
+    if (netAccess->winsockInitialized)
+    {
+      /* Update flag. */
+      netAccess->winsockInitialized = false;
+      /* Free Winsock resources. */
+      (void)WSACleanup();
+    }
+    /* Release the memory of the object. */
+    free(netAccess);
   }
 } /*** end of NetAccessTerminate ***/
 
 
 /************************************************************************************//**
 ** \brief     Connects to the TCP/IP server at the specified address and the given port.
+** \param     handle Handle of the network access object.
 ** \param     address The address of the server. This can be a hostname (such as
 **            mydomain.com) or an IP address (such as 127.0.0.1).
 ** \param     port The port number on the server to connect to.
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-bool NetAccessConnect(char const * address, uint16_t port)
+bool NetAccessConnect(tNetAccessHandle handle, char const * address, uint16_t port)
 {
+  tNetAccessObj * netAccess = (tNetAccessObj *)handle;
   bool result = false;
   struct addrinfo hints = { 0 };
   struct addrinfo * serverinfo = NULL;
@@ -114,15 +141,16 @@ bool NetAccessConnect(char const * address, uint16_t port)
   bool serverIPv6found = false;
   
   /* Check parameters. */
+  assert(handle != NULL);
   assert(address != NULL);
   assert(port > 0);
 
-  /* Start by invalidating the socket. */
-  netAccessSocket = INVALID_SOCKET;
-
   /* Only continue with valid parameters and an initialized Winsock. */
-  if ( (address != NULL) && (port > 0) && (winsockInitialized) ) /*lint !e774 */
+  if ( (netAccess != NULL) && (address != NULL) && (port > 0) && /*lint !e774 */
+       (netAccess->winsockInitialized) )
   {
+    /* Start by invalidating the socket. */
+    netAccess->sock = INVALID_SOCKET;
     /* Set result to true and only reset it to false upon detection of a problem. */
     result = true;
 
@@ -201,14 +229,16 @@ bool NetAccessConnect(char const * address, uint16_t port)
       /* Create the socket based on the family type. */
       if (serverIPv4found)
       {
-        netAccessSocket = socket(serverIPv4.sin_family, (int)SOCK_STREAM, (int)IPPROTO_TCP);
+        netAccess->sock = socket(serverIPv4.sin_family, (int)SOCK_STREAM,
+                                 (int)IPPROTO_TCP);
       }
       else
       {
-        netAccessSocket = socket(serverIPv6.sin6_family, (int)SOCK_STREAM, (int)IPPROTO_TCP);
+        netAccess->sock = socket(serverIPv6.sin6_family, (int)SOCK_STREAM,
+                                 (int)IPPROTO_TCP);
       }
       /* Check the socket. */
-      if (netAccessSocket == INVALID_SOCKET)
+      if (netAccess->sock == INVALID_SOCKET)
       {
         /* Could not create the socket. */
         result = false;
@@ -228,14 +258,25 @@ bool NetAccessConnect(char const * address, uint16_t port)
         server_address = (struct sockaddr *)&serverIPv6; /*lint !e740 */
       }
       /* Attempt to connect. */
-      if (connect(netAccessSocket, server_address, sizeof(struct sockaddr)) != 0)
+      if (connect(netAccess->sock, server_address, sizeof(struct sockaddr)) != 0)
       {
         /* Could not connect. Close the socket and negate result value. */
-        (void)closesocket(netAccessSocket);
-        netAccessSocket = INVALID_SOCKET;
+        (void)closesocket(netAccess->sock);
+        netAccess->sock = INVALID_SOCKET;
         result = false;
       }
     }
+    /* Disable Nagle's algorithm. XCP is a request/response protocol with small
+     * packets, so a command should go out right away instead of waiting for more data
+     * or for the acknowledgement of the previous segment. Note that this is an
+     * optimization, so failing to configure it is not an error.
+     */
+    if (result)
+    {
+      BOOL noDelay = TRUE;
+      (void)setsockopt(netAccess->sock, IPPROTO_TCP, TCP_NODELAY, (char const *)&noDelay,
+                       sizeof(noDelay));
+    }
   }
   /* Give the result back to the caller. */
   return result;
@@ -244,18 +285,24 @@ bool NetAccessConnect(char const * address, uint16_t port)
 
 /************************************************************************************//**
 ** \brief     Disconnects from the TCP/IP server.
+** \param     handle Handle of the network access object.
 **
 ****************************************************************************************/
-void NetAccessDisconnect(void)
+void NetAccessDisconnect(tNetAccessHandle handle)
 {
-  /* Only perform disconnect with an initialized Winsock. */
-  if (winsockInitialized)
+  tNetAccessObj * netAccess = (tNetAccessObj *)handle;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only perform disconnect with valid parameters and an initialized Winsock. */
+  if ( (netAccess != NULL) && (netAccess->winsockInitialized) ) /*lint !e774 */
   {
     /* Close the socket if it is open. */
-    if (netAccessSocket != INVALID_SOCKET)
+    if (netAccess->sock != INVALID_SOCKET)
     {
-      (void)closesocket(netAccessSocket);
-      netAccessSocket = INVALID_SOCKET;
+      (void)closesocket(netAccess->sock);
+      netAccess->sock = INVALID_SOCKET;
     }
   }
 } /*** end of NetAccessDisconnect ***/
@@ -263,30 +310,47 @@ void NetAccessDisconnect(void)
 
 /************************************************************************************//**
 ** \brief     Sends data to the TCP/IP server.
+** \param     handle Handle of the network access object.
 ** \param     data Pointer to byte array with data to send.
 ** \param     length Number of bytes to send.
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-bool NetAccessSend(uint8_t const * data, uint32_t length)
+bool NetAccessSend(tNetAccessHandle handle, uint8_t const * data, uint32_t length)
 {
+  tNetAccessObj * netAccess = (tNetAccessObj *)handle;
   bool result = false;
+  uint32_t sentLen = 0;
+  int sendResult;
 
   /* Check parameters. */
+  assert(handle != NULL);
   assert(data != NULL);
   assert(length > 0);
 
   /* Only continue with valid parameters and an initialized Winsock. */
-  if ( (data != NULL) && (length > 0) && (winsockInitialized) ) /*lint !e774 */
+  if ( (netAccess != NULL) && (data != NULL) && (length > 0) && /*lint !e774 */
+       (netAccess->winsockInitialized) )
   {
     /* Only continue with a valid socket. */
-    if (netAccessSocket != INVALID_SOCKET)
+    if (netAccess->sock != INVALID_SOCKET)
     {
-      /* Attempt to send the data. */
-      if (send(netAccessSocket, (char const *)data, (int)length, 0) != SOCKET_ERROR)
+      /* Attempt to send the data. A stream socket can accept less data than requested,
+       * so keep sending until all data is accepted.
+       */
+      result = true;
+      while ( (result) && (sentLen < length) )
       {
-        /* Successfully send the data. */
-        result = true;
+        sendResult = send(netAccess->sock, (char const *)&data[sentLen],
+                          (int)(length - sentLen), 0);
+        if (sendResult != SOCKET_ERROR)
+        {
+          sentLen += (uint32_t)sendResult;
+        }
+        else
+        {
+          result = false;
+        }
       }
     }
   }
@@ -295,8 +359,89 @@ bool NetAccessSend(uint8_t const * data, uint32_t length)
 } /*** end of NetAccessSend ***/
 
 
+/************************************************************************************//**
+** \brief     Sends data, that is spread over multiple buffers, to the TCP/IP server. The
+**            buffers are gathered by Winsock, so they do not need to be copied into one
+**            buffer first.
+** \param     handle Handle of the network access object.
+** \param     buffers Pointer to the array with buffers to send.
+** \param     count Number of buffers in the array.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+bool NetAccessSendVector(tNetAccessHandle handle, tNetAccessBuffer const * buffers,
+                         uint32_t count)
+{
+  tNetAccessObj * netAccess = (tNetAccessObj *)handle;
+  bool result = false;
+  WSABUF wsaBuffers[NETACCESS_BUFFERS_MAX];
+  WSABUF * wsaBuffersPtr = &wsaBuffers[0];
+  DWORD wsaBufferCount = 0;
+  DWORD sentLen;
+  uint32_t idx;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+  assert(buffers != NULL);
+  assert(count > 0);
+  assert(count <= NETACCESS_BUFFERS_MAX);
+
+  /* Only continue with valid parameters and an initialized Winsock. */
+  if ( (netAccess != NULL) && (buffers != NULL) && (count > 0) && /*lint !e774 */
+       (count <= NETACCESS_BUFFERS_MAX) && (netAccess->winsockInitialized) )
+  {
+    /* Only continue with a valid socket. */
+    if (netAccess->sock != INVALID_SOCKET)
+    {
+      /* Set up the Winsock buffers. Empty buffers are skipped. */
+      for (idx = 0; idx < count; idx++)
+      {
+        if (buffers[idx].length > 0)
+        {
+          wsaBuffers[wsaBufferCount].buf = (char *)buffers[idx].data;
+          wsaBuffers[wsaBufferCount].len = (ULONG)buffers[idx].length;
+          wsaBufferCount++;
+        }
+      }
+      /* Attempt to send the data. Keep sending the remainder until all data is
+       * accepted.
+       */
+      result = true;
+      while ( (result) && (wsaBufferCount > 0) )
+      {
+        if (WSASend(netAccess->sock, wsaBuffersPtr, wsaBufferCount, &sentLen, 0, NULL,
+                    NULL) == SOCKET_ERROR)
+        {
+          result = false;
+        }
+        else
+        {
+          /* Skip the buffers that were sent completely and adjust the one that was
+           * sent partially.
+           */
+          while ( (wsaBufferCount > 0) && (sentLen >= wsaBuffersPtr->len) )
+          {
+            sentLen -= wsaBuffersPtr->len;
+            wsaBuffersPtr++;
+            wsaBufferCount--;
+          }
+          if (wsaBufferCount > 0)
+          {
+            wsaBuffersPtr->buf += sentLen;
+            wsaBuffersPtr->len -= sentLen;
+          }
+        }
+      }
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of NetAccessSendVector ***/
+
+
 /************************************************************************************//**
 ** \brief     Receives data from the TCP/IP server in a blocking manner.
+** \param     handle Handle of the network access object.
 ** \param     data Pointer to byte array to store the received data.
 ** \param     length Holds the max number of bytes that can be stored into the byte
 **            array. This function also overwrites this value with the number of bytes
@@ -305,32 +450,44 @@ bool NetAccessSend(uint8_t const * data, uint32_t length)
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-bool NetAccessReceive(uint8_t * data, uint32_t * length, uint32_t timeout)
+bool NetAccessReceive(tNetAccessHandle handle, uint8_t * data, uint32_t * length,
+                      uint32_t timeout)
 {
+  tNetAccessObj * netAccess = (tNetAccessObj *)handle;
   bool result = false;
-  int tv;
+  fd_set readSet;
+  struct timeval tv;
+  int selectResult;
   int receivedLen;
 
   /* Check parameters. */
+  assert(handle != NULL);
   assert(data != NULL);
   assert(length != NULL);
   assert(timeout > 0);
 
   /* Only continue with valid parameters and an initialized Winsock. */
-  if ( (data != NULL) && (length != NULL) && (timeout > 0) &&
-       (winsockInitialized) ) /*lint !e774 */
+  if ( (netAccess != NULL) && (data != NULL) && (length != NULL) && /*lint !e774 */
+       (timeout > 0) && (netAccess->winsockInitialized) )
   {
     /* Only continue with a valid socket. */
-    if (netAccessSocket != INVALID_SOCKET)
+    if (netAccess->sock != INVALID_SOCKET)
     {
-      /* Configure the timeout for the receive operation. */
-      tv = (int)timeout;
-      if (setsockopt(netAccessSocket, SOL_SOCKET, SO_RCVTIMEO, (char*)&tv, sizeof(int)) != SOCKET_ERROR)
+      /* Wait for data to arrive with select(). This avoids the need to configure a
+       * socket receive timeout for each reception.
+       */
+      FD_ZERO(&readSet);
+      FD_SET(netAccess->sock, &readSet);
+      tv.tv_sec = (long)(timeout / 1000u);
+      tv.tv_usec = (long)((timeout % 1000u) * 1000u);
+      selectResult = select(0, &readSet, NULL, NULL, &tv);
+      /* Only continue if data is available. */
+      if ( (selectResult != SOCKET_ERROR) && (selectResult > 0) )
       {
         /* Attempt to receive data. */
-        receivedLen = recv(netAccessSocket, (char *)data, (int)*length, 0);
-        /* Process the result. Everything < 0 indicate that an error occured. A value of
-         * zero is also treated as an error, since data was expected.
+        receivedLen = recv(netAccess->sock, (char *)data, (int)*length, 0);
+        /* Process the result. Everything < 0 indicate that an error occured. A value
+         * of zero is also treated as an error, since data was expected.
          */
         if ((receivedLen != SOCKET_ERROR) && (receivedLen > 0))
         {
@@ -35,6 +35,7 @@
 #include <stdint.h>                         /* for standard integer types              */
 #include <stddef.h>                         /* for NULL declaration                    */
 #include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
 #include <windows.h>                        /* for windows library                     */
 #include "serialport.h"                     /* serial port module                      */
 
@@ -47,60 +48,90 @@
 
 
 /****************************************************************************************
-* Local data declarations
+* Type definitions
 ****************************************************************************************/
-/** \brief Serial port handle. */
-static HANDLE hUart;
-
-
-/****************************************************************************************
-* Function prototypes
-****************************************************************************************/
-static uint32_t SerialConvertBaudrate(tSerialPortBaudrate baudrate);
+/** \brief Serial port object. A serial port handle points to one of these. */
+typedef struct t_serial_port_obj
+{
+  /** \brief Serial port handle. */
+  HANDLE hUart;
+  /** \brief Communication timeouts that are configured when opening the serial port. */
+  COMMTIMEOUTS uartTimeouts;
+} tSerialPortObj;
 
 
 /************************************************************************************//**
-** \brief     Initializes the serial port module.
+** \brief     Initializes a serial port object.
+** \return    Handle of the serial port object or NULL in case of an error.
 **
 ****************************************************************************************/
-void SerialPortInit(void)
+tSerialPortHandle SerialPortInit(void)
 {
-  /* Invalidate the port handle. */
-  hUart = INVALID_HANDLE_VALUE;
+  tSerialPortObj * serialPort;
+
+  /* Allocate memory for the serial port object. */
+  serialPort = malloc(sizeof(tSerialPortObj));
+  assert(serialPort != NULL);
+  /* Only continue if the allocation was successful. */
+  if (serialPort != NULL) /*lint !e774 */
+  {
+    /* Invalidate the port handle. */
+    serialPort->hUart = INVALID_HANDLE_VALUE;
+  }
+  /* Give the handle back to the caller. */
+  return serialPort;
 } /*** end of SerialPortInit ***/
 
 
 /************************************************************************************//**
-** \brief     Terminates the serial port module.
+** \brief     Terminates a serial port object and releases its memory.
+** \param     handle Handle of the serial port object.
 **
 ****************************************************************************************/
-void SerialPortTerminate(void)
+void SerialPortTerminate(tSerialPortHandle handle)
 {
-  /* Make sure the serial port is closed. */
-  SerialPortClose();
+  tSerialPortObj * serialPort = (tSerialPortObj *)handle;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only continue with valid parameters. */
+  if (serialPort != NULL) /*lint !e774 */
+  {
+    /* Make sure the serial port is closed. */
+    SerialPortClose(handle);
+    /* Release the memory of the object. */
+    free(serialPort);
+  }
 } /*** end of SerialPortTerminate ***/
 
 
 /************************************************************************************//**
 ** \brief     Opens the connection with the serial port configured as 8,N,1 and no flow
 **            control.
+** \param     handle Handle of the serial port object.
 ** \param     portname The name of the serial port to open, i.e. COM4.
-** \param     baudrate The desired communication speed.
+** \param     baudrate The desired communication speed in bits/sec. Besides the standard
+**            baudrates, arbitrary baudrates are supported, if the serial port's
+**            driver and hardware support them.
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-bool SerialPortOpen(char const * portname, tSerialPortBaudrate baudrate)
+bool SerialPortOpen(tSerialPortHandle handle, char const * portname, uint32_t baudrate)
 {
+  tSerialPortObj * serialPort = (tSerialPortObj *)handle;
   bool result = false;
   COMMTIMEOUTS timeouts = { 0 };
   DCB dcbSerialParams = { 0 };
   char portStr[64] = "\\\\.\\";
 
   /* Check parameters. */
+  assert(handle != NULL);
   assert(portname != NULL);
+  assert(baudrate > 0);
 
   /* Only continue if parameters are valid. */
-  if (portname != NULL)
+  if ( (serialPort != NULL) && (portname != NULL) && (baudrate > 0) )
   {
     /* Assume the result to be okay from here on and only set it to error when a problem
      * was detected.
@@ -110,10 +141,10 @@ bool SerialPortOpen(char const * portname, tSerialPortBaudrate baudrate)
     strcat(portStr, portname);
 
     /* Obtain access to the COM port. */
-    hUart = CreateFile(portStr, GENERIC_READ | GENERIC_WRITE, 0, 0, OPEN_EXISTING,
-      FILE_ATTRIBUTE_NORMAL, 0);
+    serialPort->hUart = CreateFile(portStr, GENERIC_READ | GENERIC_WRITE, 0, 0,
+      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
     /* Validate COM port handle. */
-    if (hUart == INVALID_HANDLE_VALUE)
+    if (serialPort->hUart == INVALID_HANDLE_VALUE)
     {
       result = false;
     }
@@ -122,17 +153,19 @@ bool SerialPortOpen(char const * portname, tSerialPortBaudrate baudrate)
     if (result)
     {
       dcbSerialParams.DCBlength = sizeof(dcbSerialParams);
-      if (!GetCommState(hUart, &dcbSerialParams))
+      if (!GetCommState(serialPort->hUart, &dcbSerialParams))
       {
-        (void)CloseHandle(hUart);
+        (void)CloseHandle(serialPort->hUart);
         result = false;
       }
     }
 
-    /* Configure the baudrate and 8,n,1. */
+    /* Configure the baudrate and 8,n,1. Note that the DCB takes the baudrate in
+     * bits/sec, so standard and arbitrary baudrates are configured in the same way.
+     */
     if (result)
     {
-      dcbSerialParams.BaudRate = SerialConvertBaudrate(baudrate);
+      dcbSerialParams.BaudRate = baudrate;
       dcbSerialParams.ByteSize = 8;
       dcbSerialParams.StopBits = ONESTOPBIT;
       dcbSerialParams.Parity = NOPARITY;
@@ -140,9 +173,9 @@ bool SerialPortOpen(char const * portname, tSerialPortBaudrate baudrate)
       dcbSerialParams.fInX = FALSE;
       dcbSerialParams.fRtsControl = RTS_CONTROL_DISABLE;
       dcbSerialParams.fDtrControl = DTR_CONTROL_ENABLE;
-      if (!SetCommState(hUart, &dcbSerialParams))
+      if (!SetCommState(serialPort->hUart, &dcbSerialParams))
       {
-        (void)CloseHandle(hUart);
+        (void)CloseHandle(serialPort->hUart);
         result =false;
       }
     }
@@ -155,19 +188,21 @@ bool SerialPortOpen(char const * portname, tSerialPortBaudrate baudrate)
       timeouts.ReadTotalTimeoutMultiplier = 100;
       timeouts.WriteTotalTimeoutConstant = 0;
       timeouts.WriteTotalTimeoutMultiplier = 100;
-      if (!SetCommTimeouts(hUart, &timeouts))
+      if (!SetCommTimeouts(serialPort->hUart, &timeouts))
       {
-        (void)CloseHandle(hUart);
+        (void)CloseHandle(serialPort->hUart);
         result = false;
       }
+      /* Store them for restoring them after reading the available data. */
+      serialPort->uartTimeouts = timeouts;
     }
 
     /* Set transmit and receive buffer sizes. */
     if (result)
     {
-      if (!SetupComm(hUart, UART_RX_BUFFER_SIZE, UART_TX_BUFFER_SIZE))
+      if (!SetupComm(serialPort->hUart, UART_RX_BUFFER_SIZE, UART_TX_BUFFER_SIZE))
       {
-        (void)CloseHandle(hUart);
+        (void)CloseHandle(serialPort->hUart);
         result = false;
       }
     }
@@ -175,9 +210,9 @@ bool SerialPortOpen(char const * portname, tSerialPortBaudrate baudrate)
     /* Empty the transmit and receive buffers. */
     if (result)
     {
-      if (!FlushFileBuffers(hUart))
+      if (!FlushFileBuffers(serialPort->hUart))
       {
-        (void)CloseHandle(hUart);
+        (void)CloseHandle(serialPort->hUart);
         result = false;
       }
     }
@@ -189,42 +224,54 @@ bool SerialPortOpen(char const * portname, tSerialPortBaudrate baudrate)
 
 /************************************************************************************//**
 ** \brief     Closes the connection with the serial port.
+** \param     handle Handle of the serial port object.
 **
 ****************************************************************************************/
-void SerialPortClose(void)
+void SerialPortClose(tSerialPortHandle handle)
 {
-  /* Close the COM port handle if valid. */
-  if (hUart != INVALID_HANDLE_VALUE)
+  tSerialPortObj * serialPort = (tSerialPortObj *)handle;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only continue with valid parameters. */
+  if (serialPort != NULL)
   {
-    (void)CloseHandle(hUart);
+    /* Close the COM port handle if valid. */
+    if (serialPort->hUart != INVALID_HANDLE_VALUE)
+    {
+      (void)CloseHandle(serialPort->hUart);
+    }
+    /* Set handles to invalid. */
+    serialPort->hUart = INVALID_HANDLE_VALUE;
   }
-
-  /* Set handles to invalid. */
-  hUart = INVALID_HANDLE_VALUE;
 } /*** end of SerialPortClose ***/
 
 
 /************************************************************************************//**
 ** \brief     Writes data to the serial port.
+** \param     handle Handle of the serial port object.
 ** \param     data Pointer to byte array with data to write.
 ** \param     length Number of bytes to write.
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-bool SerialPortWrite(uint8_t const * data, uint32_t length)
+bool SerialPortWrite(tSerialPortHandle handle, uint8_t const * data, uint32_t length)
 {
+  tSerialPortObj * serialPort = (tSerialPortObj *)handle;
   bool result = false;
   DWORD dwWritten = 0;
 
   /* Check parameters. */
+  assert(handle != NULL);
   assert(data != NULL);
   assert(length > 0);
 
   /* Only continue with valid parameters. */
-  if ( (data != NULL) && (length > 0) )
+  if ( (serialPort != NULL) && (data != NULL) && (length > 0) )
   {
     /* Submit the data for transmission with the serial port. */
-    if (WriteFile(hUart, data, length, &dwWritten, NULL))
+    if (WriteFile(serialPort->hUart, data, length, &dwWritten, NULL))
     {
       /* Double check that all bytes were actually transmitted. */
       if (dwWritten == length)
@@ -240,25 +287,28 @@ bool SerialPortWrite(uint8_t const * data, uint32_t length)
 
 /************************************************************************************//**
 ** \brief     Reads data from the serial port in a blocking manner.
+** \param     handle Handle of the serial port object.
 ** \param     data Pointer to byte array to store read data.
 ** \param     length Number of bytes to read.
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-bool SerialPortRead(uint8_t * data, uint32_t length)
+bool SerialPortRead(tSerialPortHandle handle, uint8_t * data, uint32_t length)
 {
+  tSerialPortObj * serialPort = (tSerialPortObj *)handle;
   bool result = false;
   DWORD dwRead = 0;
 
   /* Check parameters. */
+  assert(handle != NULL);
   assert(data != NULL);
   assert(length > 0);
 
   /* Only continue with valid parameters. */
-  if ( (data != NULL) && (length > 0) )
+  if ( (serialPort != NULL) && (data != NULL) && (length > 0) )
   {
     /* Attempt to read data from the serial port. */
-    if (ReadFile(hUart, data, length, &dwRead, NULL))
+    if (ReadFile(serialPort->hUart, data, length, &dwRead, NULL))
     {
       /* Double check that all bytes were actually read. */
       if (dwRead == length)
@@ -273,39 +323,57 @@ bool SerialPortRead(uint8_t * data, uint32_t length)
 
 
 /************************************************************************************//**
-** \brief     Opens the connection with the serial port configured as 8,N,1 and no flow
-**            control.
-** \param     baudrate The desired communication speed.
-** \return    True if successful, false otherwise.
+** \brief     Reads the data that is available on the serial port, without waiting for
+**            a specific number of bytes. If no data is available yet, it waits for data
+**            to arrive, for at most the specified time. All data that is available is
+**            read with a single system call, up to the size of the byte array.
+** \param     handle Handle of the serial port object.
+** \param     data Pointer to byte array to store read data.
+** \param     length Maximum number of bytes to read.
+** \param     timeout Maximum time in microseconds to wait for data to arrive. Note that
+**            it is rounded up to milliseconds on this platform.
+** \return    Number of bytes that were read. Zero if a timeout or error occurred.
 **
 ****************************************************************************************/
-static uint32_t SerialConvertBaudrate(tSerialPortBaudrate baudrate)
+uint32_t SerialPortReadAvailable(tSerialPortHandle handle, uint8_t * data,
+                                 uint32_t length, uint32_t timeout)
 {
-  uint32_t result;
+  tSerialPortObj * serialPort = (tSerialPortObj *)handle;
+  uint32_t result = 0;
+  COMMTIMEOUTS timeouts;
+  DWORD dwRead = 0;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+  assert(data != NULL);
+  assert(length > 0);
 
-  switch (baudrate)
+  /* Only continue with valid parameters and an opened port. */
+  if ( (serialPort != NULL) && (data != NULL) && (length > 0) &&
+       (serialPort->hUart != INVALID_HANDLE_VALUE) )
   {
-    case SERIALPORT_BR9600:
-      result = CBR_9600;
-      break;
-    case SERIALPORT_BR19200:
-      result = CBR_19200;
-      break;
-    case SERIALPORT_BR38400:
-      result = CBR_38400;
-      break;
-    case SERIALPORT_BR57600:
-      result = CBR_57600;
-      break;
-    case SERIALPORT_BR115200:
-      result = CBR_115200;
-      break;
-    default:
-      result = CBR_9600;
-      break;
+    /* Configure the read timeouts such that ReadFile() returns as soon as at least
+     * one byte is available, or when the timeout expired. A timeout of zero makes it
+     * return immediately with whatever data is available.
+     */
+    timeouts = serialPort->uartTimeouts;
+    timeouts.ReadIntervalTimeout = MAXDWORD;
+    timeouts.ReadTotalTimeoutMultiplier = (timeout > 0) ? MAXDWORD : 0;
+    timeouts.ReadTotalTimeoutConstant = (timeout + 999u) / 1000u;
+    if (SetCommTimeouts(serialPort->hUart, &timeouts))
+    {
+      /* Read all data that is available. */
+      if (ReadFile(serialPort->hUart, data, length, &dwRead, NULL))
+      {
+        result = dwRead;
+      }
+      /* Restore the default timeouts. */
+      (void)SetCommTimeouts(serialPort->hUart, &serialPort->uartTimeouts);
+    }
   }
+  /* Give the result back to the caller. */
   return result;
-} /*** end of SerialConvertBaudrate ***/
+} /*** end of SerialPortReadAvailable ***/
 
 
 /*********************************** end of serialport.c *******************************/
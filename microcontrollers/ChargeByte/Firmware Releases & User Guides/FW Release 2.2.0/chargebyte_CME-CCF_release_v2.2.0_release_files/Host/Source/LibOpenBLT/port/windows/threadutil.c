@@ -0,0 +1,270 @@
+/************************************************************************************//**
+* \file         port/windows/threadutil.c
+* \brief        Thread and event utility source file.
+* \ingroup      Utility
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+* 
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+* 
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+* 
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include <assert.h>                         /* for assertions                          */
+#include <stdint.h>                         /* for standard integer types              */
+#include <stddef.h>                         /* for NULL declaration                    */
+#include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
+#include <windows.h>                        /* for windows library                     */
+#include "util.h"                           /* Utility module                          */
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Layout of a thread object. */
+typedef struct t_util_thread_obj
+{
+  HANDLE threadHandle;           /**< Handle of the windows thread.                    */
+  tUtilThreadFunc func;          /**< Function that runs in the thread.                */
+  void * arg;                    /**< Argument that is passed to the function.         */
+} tUtilThreadObj;
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+static DWORD WINAPI UtilThreadEntry(LPVOID pv);
+
+
+/************************************************************************************//**
+** \brief     Creates a new thread that runs the specified function.
+** \param     func The function to run in the thread.
+** \param     arg Argument to pass to the function.
+** \return    Handle to the newly created thread object if successful, NULL otherwise.
+**
+****************************************************************************************/
+tUtilThread UtilThreadCreate(tUtilThreadFunc func, void * arg)
+{
+  tUtilThread result = NULL;
+  tUtilThreadObj * threadObj;
+
+  /* Check parameters. */
+  assert(func != NULL);
+
+  /* Only continue with valid parameters. */
+  if (func != NULL) /*lint !e774 */
+  {
+    /* Allocate memory for the thread object. */
+    threadObj = malloc(sizeof(tUtilThreadObj));
+    assert(threadObj != NULL);
+    /* Only continue if the allocation was successful. */
+    if (threadObj != NULL) /*lint !e774 */
+    {
+      threadObj->func = func;
+      threadObj->arg = arg;
+      /* Start the thread and only hand it out if this was successful. */
+      threadObj->threadHandle = CreateThread(NULL, 0, UtilThreadEntry, threadObj, 0,
+                                             NULL);
+      if (threadObj->threadHandle != NULL)
+      {
+        result = threadObj;
+      }
+      else
+      {
+        free(threadObj);
+      }
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilThreadCreate ***/
+
+
+/************************************************************************************//**
+** \brief     Waits for a thread, that was previously created with UtilThreadCreate, to
+**            end and releases the thread object afterwards.
+** \param     thread Handle to the thread object.
+**
+****************************************************************************************/
+void UtilThreadJoin(tUtilThread thread)
+{
+  /* Only continue with a valid handle. Note that a NULL handle is allowed, in which
+   * case there is nothing to join.
+   */
+  if (thread != NULL)
+  {
+    (void)WaitForSingleObject(((tUtilThreadObj *)thread)->threadHandle, INFINITE);
+    (void)CloseHandle(((tUtilThreadObj *)thread)->threadHandle);
+    free(thread);
+  }
+} /*** end of UtilThreadJoin ***/
+
+
+/************************************************************************************//**
+** \brief     Creates a new event object, which starts out in the reset state. The event
+**            is built on a manual-reset event. This makes it possible for an
+**            application to wait for the event together with its own handles.
+** \return    Handle to the newly created event object if successful, NULL otherwise.
+**
+****************************************************************************************/
+tUtilEvent UtilEventCreate(void)
+{
+  tUtilEvent result;
+
+  /* Create the manual-reset event. Its handle doubles as the event object handle. */
+  result = CreateEvent(NULL, TRUE, FALSE, NULL);
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilEventCreate ***/
+
+
+/************************************************************************************//**
+** \brief     Destroys an event object that was previously created with UtilEventCreate.
+**            No thread should be waiting for the event when calling this function.
+** \param     event Handle to the event object.
+**
+****************************************************************************************/
+void UtilEventDestroy(tUtilEvent event)
+{
+  /* Only continue with a valid handle. Note that a NULL handle is allowed, in which
+   * case there is nothing to destroy.
+   */
+  if (event != NULL)
+  {
+    (void)CloseHandle((HANDLE)event);
+  }
+} /*** end of UtilEventDestroy ***/
+
+
+/************************************************************************************//**
+** \brief     Sets an event object. The event stays set until it is reset.
+** \param     event Handle to the event object.
+**
+****************************************************************************************/
+void UtilEventSet(tUtilEvent event)
+{
+  /* Check parameters. */
+  assert(event != NULL);
+
+  /* Only continue with a valid handle. */
+  if (event != NULL) /*lint !e774 */
+  {
+    (void)SetEvent((HANDLE)event);
+  }
+} /*** end of UtilEventSet ***/
+
+
+/************************************************************************************//**
+** \brief     Resets an event object.
+** \param     event Handle to the event object.
+**
+****************************************************************************************/
+void UtilEventReset(tUtilEvent event)
+{
+  /* Check parameters. */
+  assert(event != NULL);
+
+  /* Only continue with a valid handle. */
+  if (event != NULL) /*lint !e774 */
+  {
+    (void)ResetEvent((HANDLE)event);
+  }
+} /*** end of UtilEventReset ***/
+
+
+/************************************************************************************//**
+** \brief     Waits for an event object to become set. The event is not reset by this
+**            function.
+** \param     event Handle to the event object.
+** \param     timeout Maximum time in milliseconds to wait. UTIL_EVENT_WAIT_INFINITE
+**            waits without a timeout.
+** \return    True if the event is set, false if the timeout expired.
+**
+****************************************************************************************/
+bool UtilEventWait(tUtilEvent event, uint32_t timeout)
+{
+  bool result = false;
+  DWORD waitTimeout = INFINITE;
+
+  /* Check parameters. */
+  assert(event != NULL);
+
+  /* Only continue with a valid handle. */
+  if (event != NULL) /*lint !e774 */
+  {
+    /* Convert the timeout. Note that INFINITE itself is not a valid timeout value. */
+    if (timeout != UTIL_EVENT_WAIT_INFINITE)
+    {
+      waitTimeout = (timeout < INFINITE) ? timeout : (INFINITE - 1u);
+    }
+    if (WaitForSingleObject((HANDLE)event, waitTimeout) == WAIT_OBJECT_0)
+    {
+      result = true;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilEventWait ***/
+
+
+/************************************************************************************//**
+** \brief     Obtains the operating system handle of an event object. This is the
+**            handle of a manual-reset event, which is signaled while the event is set.
+** \param     event Handle to the event object.
+** \return    The event handle. -1 if the handle is invalid.
+**
+****************************************************************************************/
+intptr_t UtilEventGetHandle(tUtilEvent event)
+{
+  intptr_t result = -1;
+
+  /* Only continue with a valid handle. */
+  if (event != NULL)
+  {
+    result = (intptr_t)event;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilEventGetHandle ***/
+
+
+/************************************************************************************//**
+** \brief     Entry point of the threads that are created with UtilThreadCreate. It runs
+**            the thread function.
+** \param     pv Pointer to the thread object.
+** \return    Always 0.
+**
+****************************************************************************************/
+static DWORD WINAPI UtilThreadEntry(LPVOID pv)
+{
+  tUtilThreadObj * threadObj = (tUtilThreadObj *)pv;
+
+  /* Run the thread function. */
+  threadObj->func(threadObj->arg);
+  return 0;
+} /*** end of UtilThreadEntry ***/
+
+
+/*********************************** end of threadutil.c *******************************/
@@ -38,7 +38,9 @@
 
 
 /************************************************************************************//**
-** \brief     Get the system time in milliseconds.
+** \brief     Get the system time in milliseconds. The tick count does not jump when the
+**            wall-clock time is adjusted, so it can be used for measuring time
+**            intervals.
 ** \return    Time in milliseconds.
 **
 ****************************************************************************************/
@@ -48,6 +50,97 @@ uint32_t UtilTimeGetSystemTimeMs(void)
 } /*** end of UtilTimeGetSystemTimeMs ***/
 
 
+/************************************************************************************//**
+** \brief     Get the system time in microseconds since the epoch. It jumps when the
+**            wall-clock time is adjusted, so use UtilTimeGetMonotonicUs for timeouts and
+**            for measuring time intervals.
+** \return    Time in microseconds.
+**
+****************************************************************************************/
+uint64_t UtilTimeGetSystemTimeUs(void)
+{
+  FILETIME fileTime;
+  ULARGE_INTEGER ticks;
+
+  /* The file time is in 100 nanosecond ticks since January 1, 1601. */
+  GetSystemTimeAsFileTime(&fileTime);
+  ticks.LowPart = fileTime.dwLowDateTime;
+  ticks.HighPart = fileTime.dwHighDateTime;
+  /* Convert it to microseconds since January 1, 1970. */
+  return (ticks.QuadPart / 10u) - 11644473600000000ull;
+} /*** end of UtilTimeGetSystemTimeUs ***/
+
+
+/************************************************************************************//**
+** \brief     Get the time of the monotonic clock in nanoseconds. It is based on the
+**            performance counter, which does not jump when the wall-clock time is
+**            adjusted. The time at which it started is unspecified, so it is only useful
+**            for measuring time intervals and for deadlines.
+** \return    Time in nanoseconds.
+**
+****************************************************************************************/
+uint64_t UtilTimeGetMonotonicNs(void)
+{
+  LARGE_INTEGER counter;
+  LARGE_INTEGER frequency;
+  uint64_t result = 0;
+
+  if ( (QueryPerformanceFrequency(&frequency)) && (QueryPerformanceCounter(&counter)) )
+  {
+    /* Convert the whole seconds and the remainder separately, to prevent an overflow
+     * of the intermediate result.
+     */
+    result = ((uint64_t)counter.QuadPart / (uint64_t)frequency.QuadPart) *
+             1000000000ull;
+    result += (((uint64_t)counter.QuadPart % (uint64_t)frequency.QuadPart) *
+               1000000000ull) / (uint64_t)frequency.QuadPart;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilTimeGetMonotonicNs ***/
+
+
+/************************************************************************************//**
+** \brief     Get the time of the monotonic clock in microseconds. See
+**            UtilTimeGetMonotonicNs.
+** \return    Time in microseconds.
+**
+****************************************************************************************/
+uint64_t UtilTimeGetMonotonicUs(void)
+{
+  return UtilTimeGetMonotonicNs() / 1000u;
+} /*** end of UtilTimeGetMonotonicUs ***/
+
+
+/************************************************************************************//**
+** \brief     Sleeps until the monotonic clock reaches the specified time. The bulk of
+**            the time is slept and the last two milliseconds are spent polling, because
+**            Sleep() is not more accurate than the system timer resolution.
+** \param     deadline Monotonic time in microseconds to sleep until. Returns right away
+**            if it already passed.
+**
+****************************************************************************************/
+void UtilTimeSleepUntilUs(uint64_t deadline)
+{
+  uint64_t now;
+
+  now = UtilTimeGetMonotonicUs();
+  while (now < deadline)
+  {
+    /* Sleep if more than two milliseconds remain, otherwise only yield. */
+    if ((deadline - now) > 2000u)
+    {
+      Sleep((DWORD)(((deadline - now) / 1000u) - 1u));
+    }
+    else
+    {
+      (void)SwitchToThread();
+    }
+    now = UtilTimeGetMonotonicUs();
+  }
+} /*** end of UtilTimeSleepUntilUs ***/
+
+
 /************************************************************************************//**
 ** \brief     Performs a delay of the specified amount of milliseconds.
 ** \param     delay Delay time in milliseconds.
@@ -0,0 +1,468 @@
+/************************************************************************************//**
+* \file         port/windows/udpaccess.c
+* \brief        UDP/IP network access source file.
+* \ingroup      UdpAccess
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+* 
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+* 
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+*
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include <assert.h>                         /* for assertions                          */
+#include <stdint.h>                         /* for standard integer types              */
+#include <stddef.h>                         /* for NULL declaration                    */
+#include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
+#include <string.h>                         /* for string utilities                    */
+#include <winsock2.h>                       /* for WinSock2 definitions                */
+#include <ws2tcpip.h>                       /* for WinSock2 TCP/IP protocol extensions */
+#include "util.h"                           /* Utility module                          */
+#include "udpaccess.h"                      /* UDP/IP network access module            */
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief UDP network access object. A UDP network access handle points to one of
+ *         these.
+ */
+typedef struct t_udp_access_obj
+{
+  /** \brief Boolean flag to keep track if the Winsock library is initialized. */
+  bool winsockInitialized;
+  /** \brief The socket that is used as an endpoint for the UDP/IP network
+   *         communication.
+   */
+  SOCKET sock;
+} tUdpAccessObj;
+
+
+/************************************************************************************//**
+** \brief     Initializes a UDP network access object. The Winsock library keeps track
+**            of the number of times it was initialized, so each object initializes it.
+** \return    Handle of the UDP network access object or NULL in case of an error.
+**
+****************************************************************************************/
+tUdpAccessHandle UdpAccessInit(void)
+{
+  tUdpAccessObj * udpAccess;
+  WSADATA wsa;
+
+  /* Allocate memory for the UDP network access object. */
+  udpAccess = malloc(sizeof(tUdpAccessObj));
+  assert(udpAccess != NULL);
+  /* Only continue if the allocation was successful. */
+  if (udpAccess != NULL) /*lint !e774 */
+  {
+    /* Invalidate the socket. */
+    udpAccess->sock = INVALID_SOCKET;
+    /* Init locals. */
+    udpAccess->winsockInitialized = false;
+    /* Attempt to initialize the Winsock library. */
+    if (WSAStartup(MAKEWORD(2,2),&wsa) == 0)
+    {
+      /* Update flag. */
+      udpAccess->winsockInitialized = true;
+    }
+  }
+  /* Give the handle back to the caller. */
+  return udpAccess;
+} /*** end of UdpAccessInit ***/
+
+
+/************************************************************************************//**
+** \brief     Terminates a UDP network access object and releases its memory.
+** \param     handle Handle of the UDP network access object.
+**
+****************************************************************************************/
+void UdpAccessTerminate(tUdpAccessHandle handle)
+{
+  tUdpAccessObj * udpAccess = (tUdpAccessObj *)handle;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only continue with valid parameters. */
+  if (udpAccess != NULL) /*lint !e774 */
+  {
+    /* Make sure to disconnect form the server. */
+    UdpAccessDisconnect(handle);
+    /* Cleanup the Winsock library, if it was initialized. */
+    if (udpAccess->winsockInitialized)
+    {
+      /* Update flag. */
+      udpAccess->winsockInitialized = false;
+      /* Free Winsock resources. */
+      (void)WSACleanup();
+    }
+    /* Release the memory of the object. */
+    free(udpAccess);
+  }
+} /*** end of UdpAccessTerminate ***/
+
+
+/************************************************************************************//**
+** \brief     Connects to the UDP/IP server at the specified address and the given port.
+**            No data is exchanged for this. The socket is merely bound to the server,
+**            such that datagrams from other sources are filtered out.
+** \param     handle Handle of the UDP network access object.
+** \param     address The address of the server. This can be a hostname (such as
+**            mydomain.com) or an IP address (such as 127.0.0.1).
+** \param     port The port number on the server to connect to.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+bool UdpAccessConnect(tUdpAccessHandle handle, char const * address, uint16_t port)
+{
+  tUdpAccessObj * udpAccess = (tUdpAccessObj *)handle;
+  bool result = false;
+  struct addrinfo hints = { 0 };
+  struct addrinfo * serverinfo = NULL;
+  struct sockaddr_in serverIPv4 = { 0 };
+  struct sockaddr_in6 serverIPv6 = { 0 };
+  bool serverIPv4found = false;
+  bool serverIPv6found = false;
+  
+  /* Check parameters. */
+  assert(handle != NULL);
+  assert(address != NULL);
+  assert(port > 0);
+
+  /* Only continue with valid parameters and an initialized Winsock. */
+  if ( (udpAccess != NULL) && (address != NULL) && (port > 0) && /*lint !e774 */
+       (udpAccess->winsockInitialized) )
+  {
+    /* Start by invalidating the socket. */
+    udpAccess->sock = INVALID_SOCKET;
+    /* Set result to true and only reset it to false upon detection of a problem. */
+    result = true;
+
+    /* Initialize hints structure to aid in hostname resolving. Note that AF_UNSPEC is
+     * used to support both IPv4 and IPv6.
+     */
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = (int)SOCK_DGRAM;
+
+    /* Attempt to resolve the hostname. This converts the hostname to an IP address, if
+     * it wasn't already an IP address.
+     */
+    if (getaddrinfo(address, NULL, &hints, &serverinfo) != 0)
+    {
+      /* Could not resolve the hostname. */
+      result = false;
+    }
+    /* Sanity check on the pointer that should now be initialized and contain data. */
+    else
+    {
+      if (serverinfo == NULL)
+      {
+        result = false;
+      }
+    }
+    /* The serverinfo pointer now points to an array with results of the hostname
+     * resolving. We only need one, so grab the first valid one.
+     */
+    if (result)
+    {
+      /* Point to the first entry. */
+      struct addrinfo * entry = serverinfo;
+      /* Loop over the entries until a valid one was found. */
+      while (entry != NULL)
+      {
+        /* Does this entry contain an IPv4 address? */
+        if (entry->ai_family == AF_INET)
+        {
+          /* Copy this one for later usage. */
+          memcpy (&serverIPv4, entry->ai_addr, sizeof(serverIPv4));
+          serverIPv4.sin_family = AF_INET;
+          serverIPv4.sin_port = htons(port);
+          /* Set flag so we know which socket address variable to use later on. */
+          serverIPv4found = true;
+          /* No need to go over the other entries, since we found a valid one. */
+          break;
+        }
+        /* Does this entry contain an IPv6 address? */
+        if (entry->ai_family == AF_INET6)
+        {
+          /* Copy this one for later usage. */
+          memcpy (&serverIPv6, entry->ai_addr, sizeof(serverIPv6));
+          serverIPv6.sin6_family = AF_INET6;
+          serverIPv6.sin6_port = htons(port);
+          /* Set flag so we know which socket address variable to use later on. */
+          serverIPv6found = true;
+          /* No need to go over the other entries, since we found a valid one. */
+          break;
+        }
+        /* Move on to the next one. */
+        entry = entry->ai_next;
+      }
+    }
+    /* Release the results of the hostname resolving. */
+    if (serverinfo != NULL)
+    {
+      freeaddrinfo(serverinfo);
+    }
+    /* Check that a valid entry was found. */
+    if (result)
+    {
+      if ( (!serverIPv4found) && (!serverIPv6found) )
+      {
+        result = false;
+      }
+    }
+    /* Create the socket. */
+    if (result)
+    {
+      /* Create the socket based on the family type. */
+      if (serverIPv4found)
+      {
+        udpAccess->sock = socket(serverIPv4.sin_family, (int)SOCK_DGRAM,
+                                 (int)IPPROTO_UDP);
+      }
+      else
+      {
+        udpAccess->sock = socket(serverIPv6.sin6_family, (int)SOCK_DGRAM,
+                                 (int)IPPROTO_UDP);
+      }
+      /* Check the socket. */
+      if (udpAccess->sock == INVALID_SOCKET)
+      {
+        /* Could not create the socket. */
+        result = false;
+      }
+    }
+    /* Connect the socket. */
+    if (result)
+    {
+      int connectResult;
+      if (serverIPv4found)
+      {
+        connectResult = connect(udpAccess->sock,
+                                (struct sockaddr *)&serverIPv4, /*lint !e740 */
+                                (int)sizeof(serverIPv4));
+      }
+      else
+      {
+        connectResult = connect(udpAccess->sock,
+                                (struct sockaddr *)&serverIPv6, /*lint !e740 */
+                                (int)sizeof(serverIPv6));
+      }
+      if (connectResult != 0)
+      {
+        /* Could not connect. Close the socket and negate result value. */
+        (void)closesocket(udpAccess->sock);
+        udpAccess->sock = INVALID_SOCKET;
+        result = false;
+      }
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UdpAccessConnect ***/
+
+
+/************************************************************************************//**
+** \brief     Disconnects from the UDP/IP server.
+** \param     handle Handle of the UDP network access object.
+**
+****************************************************************************************/
+void UdpAccessDisconnect(tUdpAccessHandle handle)
+{
+  tUdpAccessObj * udpAccess = (tUdpAccessObj *)handle;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only perform disconnect with valid parameters and an initialized Winsock. */
+  if ( (udpAccess != NULL) && (udpAccess->winsockInitialized) ) /*lint !e774 */
+  {
+    /* Close the socket if it is open. */
+    if (udpAccess->sock != INVALID_SOCKET)
+    {
+      (void)closesocket(udpAccess->sock);
+      udpAccess->sock = INVALID_SOCKET;
+    }
+  }
+} /*** end of UdpAccessDisconnect ***/
+
+
+/************************************************************************************//**
+** \brief     Sends datagrams to the UDP/IP server. Winsock offers no call for sending
+**            multiple datagrams at once, so they are sent one by one. WSASend() gathers
+**            each datagram directly from its buffers.
+** \param     handle Handle of the UDP network access object.
+** \param     datagrams Pointer to the array with datagrams to send.
+** \param     count Number of datagrams in the array.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+bool UdpAccessSend(tUdpAccessHandle handle, tUdpAccessTxDatagram const * datagrams,
+                   uint32_t count)
+{
+  tUdpAccessObj * udpAccess = (tUdpAccessObj *)handle;
+  bool result = false;
+  WSABUF wsaBuffers[UDPACCESS_BUFFERS_MAX];
+  DWORD bytesSent;
+  uint32_t idx;
+  uint32_t bufferIdx;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+  assert(datagrams != NULL);
+  assert(count > 0);
+
+  /* Only continue with valid parameters and an initialized Winsock. */
+  if ( (udpAccess != NULL) && (datagrams != NULL) && (count > 0) && /*lint !e774 */
+       (udpAccess->winsockInitialized) )
+  {
+    /* Only continue with a valid socket. */
+    if (udpAccess->sock != INVALID_SOCKET)
+    {
+      result = true;
+      for (idx = 0; idx < count; idx++)
+      {
+        /* Gather the datagram from its buffers. */
+        assert(datagrams[idx].count <= UDPACCESS_BUFFERS_MAX);
+        for (bufferIdx = 0; bufferIdx < datagrams[idx].count; bufferIdx++)
+        {
+          wsaBuffers[bufferIdx].buf = (char *)datagrams[idx].buffers[bufferIdx].data;
+          wsaBuffers[bufferIdx].len = (ULONG)datagrams[idx].buffers[bufferIdx].length;
+        }
+        if (WSASend(udpAccess->sock, wsaBuffers, (DWORD)datagrams[idx].count,
+                    &bytesSent, 0, NULL, NULL) == SOCKET_ERROR)
+        {
+          result = false;
+          break;
+        }
+      }
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UdpAccessSend ***/
+
+
+/************************************************************************************//**
+** \brief     Receives datagrams from the UDP/IP server. Waits until at least one
+**            datagram is available and then receives all datagrams that are available,
+**            up to the specified number.
+** \param     handle Handle of the UDP network access object.
+** \param     datagrams Pointer to the array with datagrams to store the received data
+**            in. The length of each datagram is overwritten with the number of bytes
+**            that were actually received.
+** \param     count Number of datagrams in the array.
+** \param     timeout Timeout in microseconds for the data reception. A value of 0
+**            only receives the datagrams that are already available.
+** \return    Number of received datagrams. 0 in case of a timeout or an error.
+**
+****************************************************************************************/
+uint32_t UdpAccessReceive(tUdpAccessHandle handle, tUdpAccessDatagram * datagrams,
+                          uint32_t count, uint32_t timeout)
+{
+  tUdpAccessObj * udpAccess = (tUdpAccessObj *)handle;
+  uint32_t result = 0;
+  bool receptionDone = false;
+  uint64_t deadlineTime;
+  uint64_t remainingTime;
+  fd_set readSet;
+  struct timeval tv;
+  int selectResult;
+  int receivedLen;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+  assert(datagrams != NULL);
+  assert(count > 0);
+
+  /* Only continue with valid parameters and an initialized Winsock. */
+  if ( (udpAccess != NULL) && (datagrams != NULL) && (count > 0) && /*lint !e774 */
+       (udpAccess->winsockInitialized) )
+  {
+    /* Only continue with a valid socket. */
+    if (udpAccess->sock != INVALID_SOCKET)
+    {
+      /* Determine the time at which the reception times out. */
+      deadlineTime = UtilTimeDeadlineUs(timeout);
+      while (!receptionDone)
+      {
+        /* Wait for a datagram to arrive. Once the first one is received, only the
+         * datagrams that are already available are received.
+         */
+        remainingTime = UtilTimeDeadlineRemainingUs(deadlineTime);
+        if (result > 0)
+        {
+          remainingTime = 0;
+        }
+        FD_ZERO(&readSet);
+        FD_SET(udpAccess->sock, &readSet);
+        tv.tv_sec = (long)(remainingTime / 1000000u);
+        tv.tv_usec = (long)(remainingTime % 1000000u);
+        selectResult = select(0, &readSet, NULL, NULL, &tv);
+        /* Done if no more datagrams are available. */
+        if ( (selectResult == SOCKET_ERROR) || (selectResult == 0) )
+        {
+          receptionDone = true;
+          continue;
+        }
+        /* Attempt to receive the datagram. */
+        receivedLen = recv(udpAccess->sock, (char *)datagrams[result].data,
+                           (int)datagrams[result].length, 0);
+        if (receivedLen != SOCKET_ERROR)
+        {
+          /* Store the number of received bytes. */
+          datagrams[result].length = (uint32_t)receivedLen;
+          result++;
+          /* Done if the array is full. */
+          if (result >= count)
+          {
+            receptionDone = true;
+          }
+        }
+        /* A datagram that did not fit is truncated. An ICMP port unreachable message
+         * from an earlier datagram is reported as a reset connection. This is not
+         * fatal, because the server might just not be listening yet.
+         */
+        else if (WSAGetLastError() == WSAEMSGSIZE)
+        {
+          result++;
+          if (result >= count)
+          {
+            receptionDone = true;
+          }
+        }
+        else if (WSAGetLastError() != WSAECONNRESET)
+        {
+          receptionDone = true;
+        }
+      }
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UdpAccessReceive ***/
+
+
+/*********************************** end of udpaccess.c ********************************/
@@ -35,6 +35,7 @@
 #include <stdint.h>                         /* for standard integer types              */
 #include <stddef.h>                         /* for NULL declaration                    */
 #include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
 #include <windows.h>                        /* for Windows API                         */
 #include "xcpprotect.h"                     /* XCP protection module                   */
 
@@ -51,20 +52,19 @@ typedef uint32_t (* tXcpProtectLibComputeKey)(uint8_t resource,
 typedef uint32_t (* tXcpProtectLibGetPrivileges)(uint8_t * resourcePtr);
 
 
-/****************************************************************************************
-* Local data declarations
-****************************************************************************************/
-/** \brief Handle to the dynamically loaded seed and key shared library. It can also be
- *         used as a flag to determine if the shared library was specified and success-
- *         fully loaded.
- */
-static HINSTANCE seedNKeyLibraryHandle;
-
-/** \brief Function pointer to the XCP_ComputeKeyFromSeed shared library function. */
-static tXcpProtectLibComputeKey xcpProtectLibComputeKey;
-
-/** \brief Function pointer to the XCP_GetAvailablePrivileges shared library function. */
-static tXcpProtectLibGetPrivileges xcpProtectLibGetPrivileges;
+/** \brief Type for the XCP protection object. */
+typedef struct
+{
+  /** \brief Handle to the dynamically loaded seed and key shared library. It can also
+   *         be used as a flag to determine if the shared library was specified and
+   *         successfully loaded.
+   */
+  HINSTANCE seedNKeyLibraryHandle;
+  /** \brief Function pointer to the XCP_ComputeKeyFromSeed shared library function. */
+  tXcpProtectLibComputeKey xcpProtectLibComputeKey;
+  /** \brief Function pointer to the XCP_GetAvailablePrivileges library function. */
+  tXcpProtectLibGetPrivileges xcpProtectLibGetPrivileges;
+} tXcpProtectObj;
 
 
 /************************************************************************************//**
@@ -73,57 +73,63 @@ static tXcpProtectLibGetPrivileges xcpProtectLibGetPrivileges;
 **            following functions:
 **            - XCP_ComputeKeyFromSeed()
 **            - XCP_GetAvailablePrivileges()
+** \return    Handle of the XCP protection object or NULL if out of memory.
 **
 ****************************************************************************************/
-void XcpProtectInit(char const * seedKeyFile)
+tXcpProtectHandle XcpProtectInit(char const * seedKeyFile)
 {
-  /* Init locals. */
-  seedNKeyLibraryHandle = NULL;
-  /* Reset library function pointers. */
-  xcpProtectLibComputeKey = NULL;
-  xcpProtectLibGetPrivileges = NULL;
+  tXcpProtectObj * xcpProtect;
 
+  /* Create the object. This also resets the library handle and function pointers. */
+  xcpProtect = calloc(1, sizeof(tXcpProtectObj));
   /* Only load the shared library is a valid file was specified. */
-  if (seedKeyFile != NULL)
+  if ( (xcpProtect != NULL) && (seedKeyFile != NULL) )
   {
     /* Attempt to load the shared library. */
-    seedNKeyLibraryHandle = LoadLibrary(seedKeyFile);
+    xcpProtect->seedNKeyLibraryHandle = LoadLibrary(seedKeyFile);
     /* Load the function pointers from the shared library. */
-    if (seedNKeyLibraryHandle != NULL)
+    if (xcpProtect->seedNKeyLibraryHandle != NULL)
     {
-      xcpProtectLibComputeKey = (tXcpProtectLibComputeKey)GetProcAddress(
-                                                        seedNKeyLibraryHandle,
-                                                        "XCP_ComputeKeyFromSeed");
-      xcpProtectLibGetPrivileges = (tXcpProtectLibGetPrivileges)GetProcAddress(
-                                                        seedNKeyLibraryHandle,
-                                                        "XCP_GetAvailablePrivileges");
+      xcpProtect->xcpProtectLibComputeKey =
+        (tXcpProtectLibComputeKey)GetProcAddress(xcpProtect->seedNKeyLibraryHandle,
+                                                 "XCP_ComputeKeyFromSeed");
+      xcpProtect->xcpProtectLibGetPrivileges =
+        (tXcpProtectLibGetPrivileges)GetProcAddress(xcpProtect->seedNKeyLibraryHandle,
+                                                    "XCP_GetAvailablePrivileges");
     }
   }
+  /* Give the object back to the caller. */
+  return xcpProtect;
 } /*** end of XcpProtectInit ***/
 
 
 /************************************************************************************//**
-** \brief     Terminates the XCP protection module.
+** \brief     Terminates the XCP protection module and releases the object.
+** \param     handle Handle of the XCP protection object.
 **
 ****************************************************************************************/
-void XcpProtectTerminate(void)
+void XcpProtectTerminate(tXcpProtectHandle handle)
 {
-  /* Reset library function pointers. */
-  xcpProtectLibComputeKey = NULL;
-  xcpProtectLibGetPrivileges = NULL;
-  /* Only unload the shared library if one was loaded. */
-  if (seedNKeyLibraryHandle != NULL)
+  tXcpProtectObj * xcpProtect = (tXcpProtectObj *)handle;
+
+  /* Only continue with a valid object. */
+  if (xcpProtect != NULL)
   {
-    /* Unload the shared library. */
-    (void)FreeLibrary(seedNKeyLibraryHandle);
-    /* Reset the handle. */
-    seedNKeyLibraryHandle = NULL;
+    /* Only unload the shared library if one was loaded. */
+    if (xcpProtect->seedNKeyLibraryHandle != NULL)
+    {
+      /* Unload the shared library. */
+      (void)FreeLibrary(xcpProtect->seedNKeyLibraryHandle);
+    }
+    /* Release the object. */
+    free(xcpProtect);
   }
 } /*** end of XcpProtectTerminate ***/
 
 
 /************************************************************************************//**
 ** \brief     Computes the key for the requested resource.
+** \param     handle Handle of the XCP protection object.
 ** \param     resource resource for which the unlock key is requested
 ** \param     seedLen  length of the seed
 ** \param     seedPtr  pointer to the seed data
@@ -132,27 +138,30 @@ void XcpProtectTerminate(void)
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-bool XCPProtectComputeKeyFromSeed(uint8_t resource, uint8_t seedLen,
-                                  uint8_t const * seedPtr, uint8_t * keyLenPtr,
-                                  uint8_t * keyPtr)
+bool XCPProtectComputeKeyFromSeed(tXcpProtectHandle handle, uint8_t resource,
+                                  uint8_t seedLen, uint8_t const * seedPtr,
+                                  uint8_t * keyLenPtr, uint8_t * keyPtr)
 {
   bool result = false;
+  tXcpProtectObj * xcpProtect = (tXcpProtectObj *)handle;
 
   /* Check parameters. */
+  assert(xcpProtect != NULL);
   assert(seedLen > 0);
   assert(seedPtr != NULL);
   assert(keyLenPtr != NULL);
   assert(keyPtr != NULL);
 
   /* Only continue if the parameters are valid. */
-  if ( (seedLen > 0) && (seedPtr != NULL) && (keyLenPtr != NULL) &&
-       (keyPtr != NULL) ) /*lint !e774 */
+  if ( (xcpProtect != NULL) && (seedLen > 0) && (seedPtr != NULL) &&
+       (keyLenPtr != NULL) && (keyPtr != NULL) ) /*lint !e774 */
   {
     /* Only continue with a valid function pointer into the shared library. */
-    if (xcpProtectLibComputeKey != NULL)
+    if (xcpProtect->xcpProtectLibComputeKey != NULL)
     {
       /* Call the library function. */
-      if (xcpProtectLibComputeKey(resource, seedLen, seedPtr, keyLenPtr, keyPtr) == 0)
+      if (xcpProtect->xcpProtectLibComputeKey(resource, seedLen, seedPtr, keyLenPtr,
+                                              keyPtr) == 0)
       {
         /* All good so update the result value accordingly. */
         result = true;
@@ -166,26 +175,29 @@ bool XCPProtectComputeKeyFromSeed(uint8_t resource, uint8_t seedLen,
 
 /************************************************************************************//**
 ** \brief     Obtains a bitmask of the resources for which an key algorithm is available.
+** \param     handle Handle of the XCP protection object.
 ** \param     resourcePtr pointer where to store the supported resources for the key
 **                        computation.
 ** \return    XCP_RESULT_OK on success, otherwise XCP_RESULT_ERROR.
 **
 ****************************************************************************************/
-bool XcpProtectGetPrivileges(uint8_t * resourcePtr)
+bool XcpProtectGetPrivileges(tXcpProtectHandle handle, uint8_t * resourcePtr)
 {
   bool result = false;
+  tXcpProtectObj * xcpProtect = (tXcpProtectObj *)handle;
 
   /* Check parameters. */
+  assert(xcpProtect != NULL);
   assert(resourcePtr != NULL);
 
-  /* Only continue if the parameter is valid. */
-  if (resourcePtr != NULL) /*lint !e774 */
+  /* Only continue if the parameters are valid. */
+  if ( (xcpProtect != NULL) && (resourcePtr != NULL) ) /*lint !e774 */
   {
     /* Only continue with a valid function pointer into the shared library. */
-    if (xcpProtectLibGetPrivileges != NULL)
+    if (xcpProtect->xcpProtectLibGetPrivileges != NULL)
     {
       /* Call the library function. */
-      if (xcpProtectLibGetPrivileges(resourcePtr) == 0)
+      if (xcpProtect->xcpProtectLibGetPrivileges(resourcePtr) == 0)
       {
         /* All good so update the result value accordingly. */
         result = true;
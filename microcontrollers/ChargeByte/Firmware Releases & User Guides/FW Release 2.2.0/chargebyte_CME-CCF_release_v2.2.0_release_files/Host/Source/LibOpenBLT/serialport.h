@@ -42,26 +42,23 @@ extern "C" {
 /****************************************************************************************
 * Type definitions
 ****************************************************************************************/
-/** \brief Enumeration of the supported baudrates. */
-typedef enum
-{
-  SERIALPORT_BR9600   = 0,                  /**< 9600 bits/sec                         */
-  SERIALPORT_BR19200  = 1,                  /**< 19200 bits/sec                        */
-  SERIALPORT_BR38400  = 2,                  /**< 38400 bits/sec                        */
-  SERIALPORT_BR57600  = 3,                  /**< 57600 bits/sec                        */
-  SERIALPORT_BR115200 = 4                   /**< 115200 bits/sec                       */
-} tSerialPortBaudrate;
+/** \brief Handle of a serial port object. Each object manages its own serial port, so
+ *         multiple serial ports can be used at the same time.
+ */
+typedef void * tSerialPortHandle;
 
 
 /****************************************************************************************
 * Function prototypes
 ****************************************************************************************/
-void SerialPortInit(void);
-void SerialPortTerminate(void);
-bool SerialPortOpen(char const * portname, tSerialPortBaudrate baudrate);
-void SerialPortClose(void);
-bool SerialPortWrite(uint8_t const * data, uint32_t length);
-bool SerialPortRead(uint8_t * data, uint32_t length);
+tSerialPortHandle SerialPortInit(void);
+void SerialPortTerminate(tSerialPortHandle handle);
+bool SerialPortOpen(tSerialPortHandle handle, char const * portname, uint32_t baudrate);
+void SerialPortClose(tSerialPortHandle handle);
+bool SerialPortWrite(tSerialPortHandle handle, uint8_t const * data, uint32_t length);
+bool SerialPortRead(tSerialPortHandle handle, uint8_t * data, uint32_t length);
+uint32_t SerialPortReadAvailable(tSerialPortHandle handle, uint8_t * data,
+                                 uint32_t length, uint32_t timeout);
 
 #ifdef __cplusplus
 }
@@ -35,70 +35,124 @@
 #include <stdint.h>                         /* for standard integer types              */
 #include <stddef.h>                         /* for NULL declaration                    */
 #include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
 #include "session.h"                        /* Communication session module            */
+#include "util.h"                           /* Utility module                          */
 
 
 /****************************************************************************************
-* Local data declarations
+* Type definitions
 ****************************************************************************************/
-/** \brief Pointer to the communication protocol that is linked. */
-static tSessionProtocol const * protocolPtr;
+/** \brief Type for the communication session object. */
+typedef struct
+{
+  /** \brief Pointer to the communication protocol that is linked. */
+  tSessionProtocol const * protocolPtr;
+  /** \brief Handle of the protocol object. */
+  void * protocolHandle;
+  /** \brief Critical section object that serializes the access to the linked protocol.
+   *         The session can be used from the thread of the application and from the
+   *         thread that executes asynchronous session operations.
+   */
+  tUtilCriticalSection critSect;
+} tSessionObj;
 
 
 /************************************************************************************//**
 ** \brief     Initializes the communication session module for the specified protocol.
 ** \param     protocol The session protocol module to link.
 ** \param     protocolSettings Pointer to structure with protocol specific settings.
+** \return    Handle of the session object if successful, NULL otherwise.
 **
 ****************************************************************************************/
-void SessionInit(tSessionProtocol const * protocol, void const * protocolSettings)
+tSessionHandle SessionInit(tSessionProtocol const * protocol,
+                           void const * protocolSettings)
 {
+  tSessionObj * session = NULL;
+
   /* Check parameters. Note that the protocolSettings parameter is allowed to be NULL,
    * because not every protocol might need additional settings. 
    */
   assert(protocol != NULL);
-  
-  /* Link the protocol module. */
-  protocolPtr = protocol;
-  
-  /* Initialize the protocol and pass on the settings pointer. */
-  if (protocolPtr != NULL)
+
+  /* Only continue with valid parameters. */
+  if (protocol != NULL) /*lint !e774 */
+  {
+    /* Create the session object. */
+    session = calloc(1, sizeof(tSessionObj));
+    assert(session != NULL);
+  }
+  /* Only continue if the session object was created. */
+  if (session != NULL) /*lint !e774 */
   {
-    protocolPtr->Init(protocolSettings);
+    /* Link the protocol module. */
+    session->protocolPtr = protocol;
+    /* Create the critical section object. */
+    session->critSect = UtilCriticalSectionCreate();
+    assert(session->critSect != NULL);
+    /* Initialize the protocol and pass on the settings pointer. */
+    session->protocolHandle = session->protocolPtr->Init(protocolSettings);
+    /* Clean up if the critical section or the protocol object could not be created. */
+    if ( (session->critSect == NULL) || (session->protocolHandle == NULL) )
+    {
+      SessionTerminate(session);
+      session = NULL;
+    }
   }
+  /* Give the result back to the caller. */
+  return session;
 } /*** end of SessionInit ***/
 
 
 /************************************************************************************//**
 ** \brief     Terminates the communication session module.
+** \param     handle Handle of the session object.
 **
 ****************************************************************************************/
-void SessionTerminate(void)
+void SessionTerminate(tSessionHandle handle)
 {
-  /* Terminate the linked protocol. */
-  if (protocolPtr != NULL) 
+  tSessionObj * session = (tSessionObj *)handle;
+
+  /* Only continue with a valid session object. */
+  if (session != NULL)
   {
-    protocolPtr->Terminate();
+    /* Terminate the linked protocol. */
+    if (session->protocolHandle != NULL)
+    {
+      session->protocolPtr->Terminate(session->protocolHandle);
+    }
+    /* Release the critical section object. */
+    if (session->critSect != NULL)
+    {
+      UtilCriticalSectionDestroy(session->critSect);
+    }
+    /* Release the session object. */
+    free(session);
   }
-  /* Unlink the protocol module. */
-  protocolPtr = NULL;
 } /*** end of SessionTerminate ***/
 
 
 /************************************************************************************//**
 ** \brief     Starts the firmware update session. This is where the connection with the
 **            target is made and the bootloader on the target is activated.
+** \param     handle Handle of the session object.
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-bool SessionStart(void)
+bool SessionStart(tSessionHandle handle)
 {
   bool result = false;
-  
+  tSessionObj * session = (tSessionObj *)handle;
+
+  /* Check parameters. */
+  assert(session != NULL);
+
   /* Pass the request on to the linked protocol module. */
-  if (protocolPtr != NULL)
+  if (session != NULL) /*lint !e774 */
   {
-    result = protocolPtr->Start();
+    UtilCriticalSectionLock(session->critSect);
+    result = session->protocolPtr->Start(session->protocolHandle);
+    UtilCriticalSectionUnlock(session->critSect);
   }
   /* Give the result back to the caller. */
   return result;
@@ -109,15 +163,27 @@ bool SessionStart(void)
 ** \brief    Stops the firmware update. This is where the bootloader starts the user
 **           program on the target if a valid one is present. After this the connection
 **           with the target is severed.
+** \param    handle Handle of the session object.
+** \return   True if the firmware update was completed properly, false otherwise.
 **
 ****************************************************************************************/
-void SessionStop(void)
+bool SessionStop(tSessionHandle handle)
 {
+  bool result = false;
+  tSessionObj * session = (tSessionObj *)handle;
+
+  /* Check parameters. */
+  assert(session != NULL);
+
   /* Pass the request on to the linked protocol module. */
-  if (protocolPtr != NULL)
+  if (session != NULL) /*lint !e774 */
   {
-    protocolPtr->Stop();
+    UtilCriticalSectionLock(session->critSect);
+    result = session->protocolPtr->Stop(session->protocolHandle);
+    UtilCriticalSectionUnlock(session->critSect);
   }
+  /* Give the result back to the caller. */
+  return result;
 } /*** end of SessionStop ***/
 
 
@@ -125,23 +191,28 @@ void SessionStop(void)
 ** \brief     Requests the bootloader to erase the specified range of memory on the
 **            target. The bootloader aligns this range to hardware specified erase 
 **            blocks.
+** \param     handle Handle of the session object.
 ** \param     address The starting memory address for the erase operation.
 ** \param     len The total number of bytes to erase from memory.
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-bool SessionClearMemory(uint32_t address, uint32_t len)
+bool SessionClearMemory(tSessionHandle handle, uint32_t address, uint32_t len)
 {
   bool result = false;
+  tSessionObj * session = (tSessionObj *)handle;
   
   /* Check parameters. */
+  assert(session != NULL);
   assert(len > 0);
   
   /* Only continue if the parameters are vald. */
-  if (len > 0)
+  if ( (session != NULL) && (len > 0) ) /*lint !e774 */
   {
     /* Pass the request on to the linked protocol module. */
-    result = protocolPtr->ClearMemory(address, len);
+    UtilCriticalSectionLock(session->critSect);
+    result = session->protocolPtr->ClearMemory(session->protocolHandle, address, len);
+    UtilCriticalSectionUnlock(session->critSect);
   }
   /* Give the result back to the caller. */
   return result;
@@ -152,25 +223,32 @@ bool SessionClearMemory(uint32_t address, uint32_t len)
 ** \brief     Requests the bootloader to program the specified data to memory. In case of
 **            non-volatile memory, the application needs to make sure the memory range
 **            was erased beforehand.
+** \param     handle Handle of the session object.
 ** \param     address The starting memory address for the write operation.
 ** \param     len The number of bytes in the data buffer that should be written.
 ** \param     data Pointer to the byte array with data to write.
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-bool SessionWriteData(uint32_t address, uint32_t len, uint8_t const * data)
+bool SessionWriteData(tSessionHandle handle, uint32_t address, uint32_t len,
+                      uint8_t const * data)
 {
   bool result = false;
+  tSessionObj * session = (tSessionObj *)handle;
 
   /* Check parameters. */
+  assert(session != NULL);
   assert(data != NULL);
   assert(len > 0);
   
   /* Only continue if the parameters are valid. */
-  if ( (data != NULL) && (len > 0) ) /*lint !e774 */
+  if ( (session != NULL) && (data != NULL) && (len > 0) ) /*lint !e774 */
   {
     /* Pass the request on to the linked protocol module. */
-    result = protocolPtr->WriteData(address, len, data);
+    UtilCriticalSectionLock(session->critSect);
+    result = session->protocolPtr->WriteData(session->protocolHandle, address, len,
+                                             data);
+    UtilCriticalSectionUnlock(session->critSect);
   }
   /* Give the result back to the caller. */
   return result;
@@ -180,6 +258,7 @@ bool SessionWriteData(uint32_t address, uint32_t len, uint8_t const * data)
 /************************************************************************************//**
 ** \brief     Request the bootloader to upload the specified range of memory. The data is
 **            stored in the data byte array to which the pointer was specified.
+** \param     handle Handle of the session object.
 ** \param     address The starting memory address for the read operation.
 ** \param     len The number of bytes to upload from the target and store in the data 
 **            buffer.
@@ -187,22 +266,204 @@ bool SessionWriteData(uint32_t address, uint32_t len, uint8_t const * data)
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-bool SessionReadData(uint32_t address, uint32_t len, uint8_t * data)
+bool SessionReadData(tSessionHandle handle, uint32_t address, uint32_t len,
+                     uint8_t * data)
 {
   bool result = false;
+  tSessionObj * session = (tSessionObj *)handle;
 
   /* Check parameters. */
+  assert(session != NULL);
   assert(data != NULL);
   assert(len > 0);
   
   /* Only continue if the parameters are valid. */
-  if ( (data != NULL) && (len > 0) ) /*lint !e774 */
+  if ( (session != NULL) && (data != NULL) && (len > 0) ) /*lint !e774 */
   {
     /* Pass the request on to the linked protocol module. */
-    result = protocolPtr->ReadData(address, len, data);
+    UtilCriticalSectionLock(session->critSect);
+    result = session->protocolPtr->ReadData(session->protocolHandle, address, len,
+                                            data);
+    UtilCriticalSectionUnlock(session->critSect);
   }
   /* Give the result back to the caller. */
   return result;
 } /*** end of SessionReadData ***/
 
+
+/************************************************************************************//**
+** \brief     Obtains the command/response latency statistics of the session.
+** \param     handle Handle of the session object.
+** \param     latency Pointer where the statistics are stored.
+** \return    True if successful, false if not supported by the linked protocol module.
+**
+****************************************************************************************/
+bool SessionGetLatency(tSessionHandle handle, tSessionLatency * latency)
+{
+  bool result = false;
+  tSessionObj * session = (tSessionObj *)handle;
+
+  /* Check parameters. */
+  assert(session != NULL);
+  assert(latency != NULL);
+
+  /* Only continue if the parameters are valid. */
+  if ( (session != NULL) && (latency != NULL) ) /*lint !e774 */
+  {
+    /* Pass the request on to the linked protocol module, if it supports it. */
+    if (session->protocolPtr->GetLatency != NULL)
+    {
+      UtilCriticalSectionLock(session->critSect);
+      session->protocolPtr->GetLatency(session->protocolHandle, latency);
+      UtilCriticalSectionUnlock(session->critSect);
+      result = true;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of SessionGetLatency ***/
+
+
+/************************************************************************************//**
+** \brief     Configures if the transport layer stays connected when the session is
+**            stopped.
+** \param     handle Handle of the session object.
+** \param     keep True to keep the transport layer connected, false otherwise.
+** \return    True if successful, false if not supported by the linked protocol module.
+**
+****************************************************************************************/
+bool SessionKeepTransport(tSessionHandle handle, bool keep)
+{
+  bool result = false;
+  tSessionObj * session = (tSessionObj *)handle;
+
+  /* Check parameters. */
+  assert(session != NULL);
+
+  /* Only continue if the parameters are valid. */
+  if (session != NULL) /*lint !e774 */
+  {
+    /* Pass the request on to the linked protocol module, if it supports it. */
+    if (session->protocolPtr->KeepTransport != NULL)
+    {
+      UtilCriticalSectionLock(session->critSect);
+      session->protocolPtr->KeepTransport(session->protocolHandle, keep);
+      UtilCriticalSectionUnlock(session->critSect);
+      result = true;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of SessionKeepTransport ***/
+
+
+/************************************************************************************//**
+** \brief     Adds a command/response exchange to the latency statistics.
+** \param     latency Pointer to the latency statistics.
+** \param     totalTime The command/response time in microseconds.
+** \param     wireTime The part of it that was spent on the communication medium and in
+**            the target, in microseconds.
+**
+****************************************************************************************/
+void SessionLatencyAdd(tSessionLatency * latency, uint32_t totalTime,
+                       uint32_t wireTime)
+{
+  uint32_t bucket;
+  uint32_t msb;
+
+  /* Check parameters. */
+  assert(latency != NULL);
+
+  /* Only continue if the parameters are valid. */
+  if (latency != NULL) /*lint !e774 */
+  {
+    latency->count++;
+    latency->totalTime += totalTime;
+    latency->wireTime += wireTime;
+    if (totalTime > latency->totalMax)
+    {
+      latency->totalMax = totalTime;
+    }
+    /* Short times have a bucket of their own. */
+    if (totalTime < 16u)
+    {
+      bucket = totalTime;
+    }
+    /* Longer times are located by their most significant bit and the three bits after
+     * it.
+     */
+    else
+    {
+      msb = 4u;
+      while ((totalTime >> (msb + 1u)) != 0u)
+      {
+        msb++;
+      }
+      bucket = 16u + ((msb - 4u) * 8u) + ((totalTime >> (msb - 3u)) & 7u);
+    }
+    latency->histogram[bucket]++;
+  }
+} /*** end of SessionLatencyAdd ***/
+
+
+/************************************************************************************//**
+** \brief     Determines a percentile of the command/response times from the histogram
+**            of the latency statistics. The result is the upper bound of the bucket
+**            that the percentile falls into, but never more than the longest time.
+** \param     latency Pointer to the latency statistics.
+** \param     percentile The percentile to determine, for example 99.
+** \return    Command/response time in microseconds or 0 if there are no statistics.
+**
+****************************************************************************************/
+uint32_t SessionLatencyGetPercentile(tSessionLatency const * latency,
+                                     uint32_t percentile)
+{
+  uint32_t result = 0;
+  uint64_t rank;
+  uint64_t cumulative = 0;
+  uint32_t bucket;
+  uint32_t shift;
+
+  /* Check parameters. */
+  assert(latency != NULL);
+  assert(percentile <= 100u);
+
+  /* Only continue if the parameters are valid and there are statistics. */
+  if ( (latency != NULL) && (percentile <= 100u) && /*lint !e774 */
+       (latency->count > 0) )
+  {
+    /* Determine how many exchanges are at or below the percentile, rounded up. */
+    rank = (((uint64_t)latency->count * percentile) + 99u) / 100u;
+    if (rank == 0)
+    {
+      rank = 1;
+    }
+    /* Find the bucket where the accumulated count reaches it. */
+    for (bucket = 0; bucket < SESSION_LATENCY_BUCKETS; bucket++)
+    {
+      cumulative += latency->histogram[bucket];
+      if (cumulative >= rank)
+      {
+        break;
+      }
+    }
+    /* Convert the bucket to the upper bound of its times. */
+    if (bucket < 16u)
+    {
+      result = bucket;
+    }
+    else if (bucket < SESSION_LATENCY_BUCKETS)
+    {
+      shift = ((bucket - 16u) / 8u) + 1u;
+      result = (((8u + ((bucket - 16u) % 8u) + 1u) << shift) - 1u);
+    }
+    if ( (bucket >= SESSION_LATENCY_BUCKETS) || (result > latency->totalMax) )
+    {
+      result = latency->totalMax;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of SessionLatencyGetPercentile ***/
+
 /*********************************** end of session.c **********************************/
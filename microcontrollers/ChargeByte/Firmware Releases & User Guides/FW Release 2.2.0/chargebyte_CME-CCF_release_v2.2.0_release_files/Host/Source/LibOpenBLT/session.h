@@ -36,7 +36,8 @@
 * The Communication Session module handles the communication with the bootloader during
 * firmware updates on the target system. It contains an interface to link the desired
 * communication protocol that should be used for the communication. For example the XCP
-* protocol.
+* protocol. Each initialization creates a new session object, so that multiple targets
+* can be communicated with at the same time.
 ****************************************************************************************/
 #ifndef SESSION_H
 #define SESSION_H
@@ -45,51 +46,103 @@
 extern "C" {
 #endif
 
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Number of buckets in the histogram of the command/response times. Times up
+ *         to 15 us each have their own bucket. Longer times are split into 8 buckets
+ *         per power of two, which keeps the relative error below 12.5%.
+ */
+#define SESSION_LATENCY_BUCKETS        (240u)
+
+
 /****************************************************************************************
 * Type definitions
 ****************************************************************************************/
-/** \brief Session communication protocol interface. */
+/** \brief Command/response latency statistics of the session. The wire time is the
+ *         part of the command/response time that was spent on the communication medium
+ *         and in the target. The remainder was spent on the host.
+ */
+typedef struct t_session_latency
+{
+  uint32_t count;                /**< Number of measured command/response exchanges.   */
+  uint64_t totalTime;            /**< Accumulated command/response time in us.         */
+  uint64_t wireTime;             /**< Accumulated wire time in us.                     */
+  uint32_t totalMax;             /**< Longest command/response time in us.             */
+  /** \brief Histogram of the command/response times, for determining percentiles. */
+  uint32_t histogram[SESSION_LATENCY_BUCKETS];
+} tSessionLatency;
+
+/** \brief Handle of a communication session object. */
+typedef void * tSessionHandle;
+
+/** \brief Session communication protocol interface. Each initialization creates a new
+ *         protocol object. Its handle is passed as the first parameter to the other
+ *         functions.
+ */
 typedef struct t_session_protocol
 {
-  /** \brief Initializes the protocol module. */
-  void (* Init) (void const * settings);
+  /** \brief Initializes the protocol module. Returns the handle of the protocol object
+   *         or NULL in case of an error.
+   */
+  void * (* Init) (void const * settings);
   /** \brief Terminates the protocol module. */
-  void (* Terminate) (void);
+  void (* Terminate) (void * handle);
   /** \brief Starts the firmware update session. This is where the connection with the
    *         target is made and the bootloader on the target is activated.
    */
-  bool (* Start) (void);
+  bool (* Start) (void * handle);
   /** \brief Stops the firmware update. This is where the bootloader starts the user
    *         program on the target if a valid one is present. After this the connection
-   *         with the target is severed.
+   *         with the target is severed. Returns false if the firmware update could not
+   *         be completed properly.
    */
-  void (* Stop) (void);
+  bool (* Stop) (void * handle);
   /** \brief Requests the bootloader to erase the specified range of memory on the
    *         target. The bootloader aligns this range to hardware specified erase blocks.
    */
-  bool (* ClearMemory) (uint32_t address, uint32_t len);
+  bool (* ClearMemory) (void * handle, uint32_t address, uint32_t len);
   /** \brief Requests the bootloader to program the specified data to memory. In case of
    *         non-volatile memory, the application needs to make sure the memory range
    *         was erased beforehand.
    */
-  bool (* WriteData) (uint32_t address, uint32_t len, uint8_t const * data);  
+  bool (* WriteData) (void * handle, uint32_t address, uint32_t len,
+                      uint8_t const * data);
   /** \brief Request the bootloader to upload the specified range of memory. The data is
    *         stored in the data byte array to which the pointer was specified.
    */
-  bool (* ReadData) (uint32_t address, uint32_t len, uint8_t * data);
+  bool (* ReadData) (void * handle, uint32_t address, uint32_t len, uint8_t * data);
+  /** \brief Obtains the command/response latency statistics of the session. Optional
+   *         and can be NULL.
+   */
+  void (* GetLatency) (void * handle, tSessionLatency * latency);
+  /** \brief Configures if the transport layer stays connected when the session is
+   *         stopped, such that the next session on the same transport layer starts
+   *         without connecting it again. Optional and can be NULL.
+   */
+  void (* KeepTransport) (void * handle, bool keep);
 } tSessionProtocol;
 
 
 /****************************************************************************************
 * Function prototypes
 ****************************************************************************************/
-void SessionInit(tSessionProtocol const * protocol, void const * protocolSettings);
-void SessionTerminate(void);
-bool SessionStart(void);
-void SessionStop(void);
-bool SessionClearMemory(uint32_t address, uint32_t len);
-bool SessionWriteData(uint32_t address, uint32_t len, uint8_t const * data);  
-bool SessionReadData(uint32_t address, uint32_t len, uint8_t * data);
+tSessionHandle SessionInit(tSessionProtocol const * protocol,
+                           void const * protocolSettings);
+void SessionTerminate(tSessionHandle handle);
+bool SessionStart(tSessionHandle handle);
+bool SessionStop(tSessionHandle handle);
+bool SessionClearMemory(tSessionHandle handle, uint32_t address, uint32_t len);
+bool SessionWriteData(tSessionHandle handle, uint32_t address, uint32_t len,
+                      uint8_t const * data);
+bool SessionReadData(tSessionHandle handle, uint32_t address, uint32_t len,
+                     uint8_t * data);
+bool SessionGetLatency(tSessionHandle handle, tSessionLatency * latency);
+bool SessionKeepTransport(tSessionHandle handle, bool keep);
+void SessionLatencyAdd(tSessionLatency * latency, uint32_t totalTime,
+                       uint32_t wireTime);
+uint32_t SessionLatencyGetPercentile(tSessionLatency const * latency,
+                                     uint32_t percentile);
 
 
 #ifdef __cplusplus
@@ -0,0 +1,556 @@
+/************************************************************************************//**
+* \file         sessionasync.c
+* \brief        Asynchronous session operations module source file.
+* \ingroup      SessionAsync
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+* 
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+* 
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+*
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include <assert.h>                         /* for assertions                          */
+#include <stdint.h>                         /* for standard integer types              */
+#include <stddef.h>                         /* for NULL declaration                    */
+#include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
+#include "session.h"                        /* Communication session module            */
+#include "util.h"                           /* Utility module                          */
+#include "sessionasync.h"                   /* Asynchronous session operations module  */
+
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Maximum number of operations that can be pending at the same time. */
+#define SESSION_ASYNC_QUEUE_SIZE       (32u)
+
+/** \brief Number of bytes that a write or read operation processes in one go. Progress
+ *         is reported after each chunk.
+ */
+#define SESSION_ASYNC_CHUNK_SIZE       (8192u)
+
+/* States of an operation in the queue. */
+#define SESSION_ASYNC_STATE_QUEUED     (0u)       /**< Waiting to be executed.         */
+#define SESSION_ASYNC_STATE_RUNNING    (1u)       /**< Being executed.                 */
+#define SESSION_ASYNC_STATE_DONE       (2u)       /**< Completion not yet reported.    */
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Layout of an operation in the queue. */
+typedef struct t_session_async_entry
+{
+  tSessionAsyncOperation operation; /**< The operation itself.                         */
+  uint8_t state;                 /**< State of the operation.                          */
+  bool result;                   /**< Completion result.                               */
+  uint32_t progress;             /**< Number of bytes processed so far.                */
+  uint32_t reported;             /**< Progress that was last reported with an event.   */
+} tSessionAsyncEntry;
+
+/** \brief Type for the asynchronous session operations object. */
+typedef struct
+{
+  /** \brief Handle of the session on which the operations are executed. */
+  tSessionHandle session;
+  /** \brief Queue with the pending operations. It holds the operations that are done,
+   *         but whose completion is not yet reported, followed by the running operation
+   *         and the ones that are still waiting to be executed.
+   */
+  tSessionAsyncEntry queue[SESSION_ASYNC_QUEUE_SIZE];
+  /** \brief Index of the oldest operation in the queue. */
+  uint32_t head;
+  /** \brief Number of operations in the queue. */
+  uint32_t count;
+  /** \brief Number of operations at the start of the queue that are done. */
+  uint32_t doneCount;
+  /** \brief Flag to request the worker thread to stop. */
+  bool cancelRequested;
+  /** \brief Critical section object that protects the data of this object. */
+  tUtilCriticalSection critSect;
+  /** \brief Event that wakes up the worker thread. */
+  tUtilEvent wakeEvent;
+  /** \brief Event that is set when events become pending for the application. It is
+   *         owned by the creator of this object and can be shared by multiple objects.
+   */
+  tUtilEvent notifyEvent;
+  /** \brief The worker thread. It is only started once the first operation is
+   *         submitted.
+   */
+  tUtilThread thread;
+} tSessionAsyncObj;
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+static void SessionAsyncThread(void * arg);
+static void SessionAsyncExecute(tSessionAsyncObj * sessionAsync,
+                                tSessionAsyncEntry * entry);
+static bool SessionAsyncIsCancelled(tSessionAsyncObj * sessionAsync);
+static uint32_t SessionAsyncGetTotal(tSessionAsyncOperation const * operation);
+
+
+/************************************************************************************//**
+** \brief     Initializes the asynchronous session operations module for a session.
+** \param     session Handle of the session on which the operations are executed.
+** \param     notifyEvent Event that is set when events become pending. The caller
+**            retrieves the events after resetting it.
+** \return    Handle of the asynchronous session operations object if successful, NULL
+**            otherwise.
+**
+****************************************************************************************/
+tSessionAsyncHandle SessionAsyncInit(tSessionHandle session, tUtilEvent notifyEvent)
+{
+  tSessionAsyncObj * sessionAsync = NULL;
+
+  /* Check parameters. */
+  assert(session != NULL);
+  assert(notifyEvent != NULL);
+
+  /* Only continue with valid parameters. */
+  if ( (session != NULL) && (notifyEvent != NULL) ) /*lint !e774 */
+  {
+    /* Create the object. This also starts it with an empty queue. */
+    sessionAsync = calloc(1, sizeof(tSessionAsyncObj));
+    assert(sessionAsync != NULL);
+  }
+  /* Only continue if the object was created. */
+  if (sessionAsync != NULL) /*lint !e774 */
+  {
+    sessionAsync->session = session;
+    sessionAsync->notifyEvent = notifyEvent;
+    /* Create the critical section and the event objects. */
+    sessionAsync->critSect = UtilCriticalSectionCreate();
+    assert(sessionAsync->critSect != NULL);
+    sessionAsync->wakeEvent = UtilEventCreate();
+    assert(sessionAsync->wakeEvent != NULL);
+    /* Clean up if one of them could not be created. */
+    if ( (sessionAsync->critSect == NULL) || (sessionAsync->wakeEvent == NULL) )
+    {
+      SessionAsyncTerminate(sessionAsync);
+      sessionAsync = NULL;
+    }
+  }
+  /* Give the result back to the caller. */
+  return sessionAsync;
+} /*** end of SessionAsyncInit ***/
+
+
+/************************************************************************************//**
+** \brief     Terminates the asynchronous session operations module. Operations that are
+**            still pending are dropped without reporting their completion. Call
+**            SessionAsyncCancel first and retrieve the remaining events, if their
+**            completion needs to be reported.
+** \param     handle Handle of the asynchronous session operations object.
+**
+****************************************************************************************/
+void SessionAsyncTerminate(tSessionAsyncHandle handle)
+{
+  tSessionAsyncObj * sessionAsync = (tSessionAsyncObj *)handle;
+
+  /* Only continue with a valid object. */
+  if (sessionAsync != NULL)
+  {
+    /* Make sure the worker thread is stopped. */
+    if ( (sessionAsync->critSect != NULL) && (sessionAsync->wakeEvent != NULL) )
+    {
+      SessionAsyncCancel(sessionAsync);
+    }
+    /* Release the critical section and the event objects. */
+    if (sessionAsync->wakeEvent != NULL)
+    {
+      UtilEventDestroy(sessionAsync->wakeEvent);
+    }
+    if (sessionAsync->critSect != NULL)
+    {
+      UtilCriticalSectionDestroy(sessionAsync->critSect);
+    }
+    /* Release the object, which drops all operations. */
+    free(sessionAsync);
+  }
+} /*** end of SessionAsyncTerminate ***/
+
+
+/************************************************************************************//**
+** \brief     Submits an operation for execution in the background. The operation is
+**            executed after all operations that were submitted before it. Its progress
+**            and completion are reported through events. The data buffer of a write or
+**            read operation must stay valid until its completion is reported.
+** \param     handle Handle of the asynchronous session operations object.
+** \param     operation Pointer to the operation.
+** \return    True if successful, false if the queue is full or the worker thread
+**            could not be started.
+**
+****************************************************************************************/
+bool SessionAsyncSubmit(tSessionAsyncHandle handle,
+                        tSessionAsyncOperation const * operation)
+{
+  bool result = false;
+  tSessionAsyncObj * sessionAsync = (tSessionAsyncObj *)handle;
+  tSessionAsyncEntry * entry;
+
+  /* Check parameters. */
+  assert(sessionAsync != NULL);
+  assert(operation != NULL);
+
+  /* Only continue with valid parameters. */
+  if ( (sessionAsync != NULL) && (operation != NULL) ) /*lint !e774 */
+  {
+    UtilCriticalSectionLock(sessionAsync->critSect);
+    /* Start the worker thread, if not yet done. */
+    if (sessionAsync->thread == NULL)
+    {
+      sessionAsync->cancelRequested = false;
+      sessionAsync->thread = UtilThreadCreate(SessionAsyncThread, sessionAsync);
+    }
+    /* Add the operation to the queue, if there is space. */
+    if ( (sessionAsync->thread != NULL) &&
+         (sessionAsync->count < SESSION_ASYNC_QUEUE_SIZE) )
+    {
+      entry = &sessionAsync->queue[(sessionAsync->head + sessionAsync->count) %
+                                   SESSION_ASYNC_QUEUE_SIZE];
+      entry->operation = *operation;
+      entry->state = SESSION_ASYNC_STATE_QUEUED;
+      entry->result = false;
+      entry->progress = 0;
+      entry->reported = 0;
+      sessionAsync->count++;
+      result = true;
+    }
+    UtilCriticalSectionUnlock(sessionAsync->critSect);
+    /* Wake up the worker thread. */
+    if (result)
+    {
+      UtilEventSet(sessionAsync->wakeEvent);
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of SessionAsyncSubmit ***/
+
+
+/************************************************************************************//**
+** \brief     Cancels all pending operations and stops the worker thread. A running
+**            write or read operation is aborted after its current chunk. The cancelled
+**            operations complete with a negative result. Their completion is reported
+**            through events, just like for any other operation. It is possible to
+**            submit new operations afterwards.
+** \param     handle Handle of the asynchronous session operations object.
+**
+****************************************************************************************/
+void SessionAsyncCancel(tSessionAsyncHandle handle)
+{
+  tSessionAsyncObj * sessionAsync = (tSessionAsyncObj *)handle;
+  uint32_t idx;
+
+  /* Check parameters. */
+  assert(sessionAsync != NULL);
+
+  /* Only continue with valid parameters. */
+  if (sessionAsync != NULL) /*lint !e774 */
+  {
+    /* Stop the worker thread, if it is running. */
+    if (sessionAsync->thread != NULL)
+    {
+      UtilCriticalSectionLock(sessionAsync->critSect);
+      sessionAsync->cancelRequested = true;
+      UtilCriticalSectionUnlock(sessionAsync->critSect);
+      UtilEventSet(sessionAsync->wakeEvent);
+      UtilThreadJoin(sessionAsync->thread);
+      sessionAsync->thread = NULL;
+    }
+    /* Complete the operations that did not get executed. */
+    UtilCriticalSectionLock(sessionAsync->critSect);
+    for (idx = sessionAsync->doneCount; idx < sessionAsync->count; idx++)
+    {
+      sessionAsync->queue[(sessionAsync->head + idx) % SESSION_ASYNC_QUEUE_SIZE].state =
+        SESSION_ASYNC_STATE_DONE;
+    }
+    if (sessionAsync->doneCount < sessionAsync->count)
+    {
+      sessionAsync->doneCount = sessionAsync->count;
+      UtilEventSet(sessionAsync->notifyEvent);
+    }
+    UtilCriticalSectionUnlock(sessionAsync->critSect);
+  }
+} /*** end of SessionAsyncCancel ***/
+
+
+/************************************************************************************//**
+** \brief     Retrieves the next pending event. Completion events are reported in the
+**            order in which the operations were submitted. Progress events are only
+**            reported for the running operation and only the latest progress is
+**            reported, so no events are lost if the application retrieves them less
+**            often than they occur. The notify event is not reset by this function.
+**            Reset it before retrieving the events, so that an event that gets added
+**            in the meantime always sets it again.
+** \param     handle Handle of the asynchronous session operations object.
+** \param     event Pointer where the event is stored.
+** \return    True if an event was retrieved, false if no events are pending.
+**
+****************************************************************************************/
+bool SessionAsyncGetEvent(tSessionAsyncHandle handle, tSessionAsyncEvent * event)
+{
+  bool result = false;
+  tSessionAsyncObj * sessionAsync = (tSessionAsyncObj *)handle;
+  tSessionAsyncEntry * entry;
+
+  /* Check parameters. */
+  assert(sessionAsync != NULL);
+  assert(event != NULL);
+
+  /* Only continue with valid parameters. */
+  if ( (sessionAsync != NULL) && (event != NULL) ) /*lint !e774 */
+  {
+    UtilCriticalSectionLock(sessionAsync->critSect);
+    if (sessionAsync->count > 0)
+    {
+      entry = &sessionAsync->queue[sessionAsync->head];
+      event->context = entry->operation.context;
+      event->operation = entry->operation.type;
+      event->result = entry->result;
+      event->progress = entry->progress;
+      event->total = SessionAsyncGetTotal(&entry->operation);
+      /* Report the completion of the oldest operation, if it is done. */
+      if (entry->state == SESSION_ASYNC_STATE_DONE)
+      {
+        event->type = SESSION_ASYNC_EVENT_COMPLETED;
+        sessionAsync->head = (sessionAsync->head + 1u) % SESSION_ASYNC_QUEUE_SIZE;
+        sessionAsync->count--;
+        sessionAsync->doneCount--;
+        result = true;
+      }
+      /* Otherwise report the progress of the running operation, if it changed. */
+      else if ( (entry->state == SESSION_ASYNC_STATE_RUNNING) &&
+                (entry->progress != entry->reported) )
+      {
+        event->type = SESSION_ASYNC_EVENT_PROGRESS;
+        event->result = true;
+        entry->reported = entry->progress;
+        result = true;
+      }
+    }
+    UtilCriticalSectionUnlock(sessionAsync->critSect);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of SessionAsyncGetEvent ***/
+
+
+/************************************************************************************//**
+** \brief     Obtains the number of pending operations. An operation is pending until
+**            its completion was retrieved as an event.
+** \param     handle Handle of the asynchronous session operations object.
+** \return    Number of pending operations.
+**
+****************************************************************************************/
+uint32_t SessionAsyncGetPendingCount(tSessionAsyncHandle handle)
+{
+  uint32_t result = 0;
+  tSessionAsyncObj * sessionAsync = (tSessionAsyncObj *)handle;
+
+  /* Only continue with a valid object. */
+  if (sessionAsync != NULL)
+  {
+    UtilCriticalSectionLock(sessionAsync->critSect);
+    result = sessionAsync->count;
+    UtilCriticalSectionUnlock(sessionAsync->critSect);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of SessionAsyncGetPendingCount ***/
+
+
+/************************************************************************************//**
+** \brief     Worker thread that executes the queued operations one after the other.
+** \param     arg Thread argument. Pointer to the asynchronous session operations
+**            object.
+**
+****************************************************************************************/
+static void SessionAsyncThread(void * arg)
+{
+  tSessionAsyncObj * sessionAsync = (tSessionAsyncObj *)arg;
+  tSessionAsyncEntry * entry;
+  bool stop = false;
+
+  while (!stop)
+  {
+    /* Reset the wake up event before checking the queue, so a submission that happens
+     * after the check is not missed.
+     */
+    UtilEventReset(sessionAsync->wakeEvent);
+    entry = NULL;
+    UtilCriticalSectionLock(sessionAsync->critSect);
+    if (sessionAsync->cancelRequested)
+    {
+      stop = true;
+    }
+    else if (sessionAsync->doneCount < sessionAsync->count)
+    {
+      /* Take the next operation. */
+      entry = &sessionAsync->queue[(sessionAsync->head + sessionAsync->doneCount) %
+                                   SESSION_ASYNC_QUEUE_SIZE];
+      entry->state = SESSION_ASYNC_STATE_RUNNING;
+    }
+    UtilCriticalSectionUnlock(sessionAsync->critSect);
+    /* Execute the operation or wait for one to be submitted. */
+    if (entry != NULL)
+    {
+      SessionAsyncExecute(sessionAsync, entry);
+    }
+    else if (!stop)
+    {
+      (void)UtilEventWait(sessionAsync->wakeEvent, UTIL_EVENT_WAIT_INFINITE);
+    }
+  }
+} /*** end of SessionAsyncThread ***/
+
+
+/************************************************************************************//**
+** \brief     Executes an operation on the worker thread. Write and read operations are
+**            processed in chunks. The progress is updated after each chunk.
+** \param     sessionAsync Pointer to the asynchronous session operations object.
+** \param     entry Pointer to the operation in the queue.
+**
+****************************************************************************************/
+static void SessionAsyncExecute(tSessionAsyncObj * sessionAsync,
+                                tSessionAsyncEntry * entry)
+{
+  bool result = false;
+  tSessionAsyncOperation const * operation = &entry->operation;
+  uint32_t offset = 0;
+  uint32_t chunkLen;
+
+  switch (operation->type)
+  {
+    case SESSION_ASYNC_OP_START:
+      result = SessionStart(sessionAsync->session);
+      break;
+    case SESSION_ASYNC_OP_STOP:
+      result = SessionStop(sessionAsync->session);
+      break;
+    case SESSION_ASYNC_OP_CLEAR_MEMORY:
+      result = SessionClearMemory(sessionAsync->session, operation->address,
+                                  operation->len);
+      if (result)
+      {
+        offset = operation->len;
+      }
+      break;
+    case SESSION_ASYNC_OP_WRITE_DATA:
+    case SESSION_ASYNC_OP_READ_DATA:
+      result = true;
+      while ( (result) && (offset < operation->len) )
+      {
+        /* Abort the operation if it got cancelled. */
+        if (SessionAsyncIsCancelled(sessionAsync))
+        {
+          result = false;
+          break;
+        }
+        /* Process the next chunk. */
+        chunkLen = operation->len - offset;
+        if (chunkLen > SESSION_ASYNC_CHUNK_SIZE)
+        {
+          chunkLen = SESSION_ASYNC_CHUNK_SIZE;
+        }
+        if (operation->type == SESSION_ASYNC_OP_WRITE_DATA)
+        {
+          result = SessionWriteData(sessionAsync->session, operation->address + offset,
+                                    chunkLen, &operation->writeData[offset]);
+        }
+        else
+        {
+          result = SessionReadData(sessionAsync->session, operation->address + offset,
+                                   chunkLen, &operation->readData[offset]);
+        }
+        /* Update the progress. */
+        if (result)
+        {
+          offset += chunkLen;
+          UtilCriticalSectionLock(sessionAsync->critSect);
+          entry->progress = offset;
+          UtilEventSet(sessionAsync->notifyEvent);
+          UtilCriticalSectionUnlock(sessionAsync->critSect);
+        }
+      }
+      break;
+    default:
+      /* Unsupported operation type. */
+      break;
+  }
+  /* Mark the operation as done. */
+  UtilCriticalSectionLock(sessionAsync->critSect);
+  entry->result = result;
+  entry->progress = offset;
+  entry->state = SESSION_ASYNC_STATE_DONE;
+  sessionAsync->doneCount++;
+  UtilEventSet(sessionAsync->notifyEvent);
+  UtilCriticalSectionUnlock(sessionAsync->critSect);
+} /*** end of SessionAsyncExecute ***/
+
+
+/************************************************************************************//**
+** \brief     Determines if the worker thread was requested to stop.
+** \param     sessionAsync Pointer to the asynchronous session operations object.
+** \return    True if cancelled, false otherwise.
+**
+****************************************************************************************/
+static bool SessionAsyncIsCancelled(tSessionAsyncObj * sessionAsync)
+{
+  bool result;
+
+  UtilCriticalSectionLock(sessionAsync->critSect);
+  result = sessionAsync->cancelRequested;
+  UtilCriticalSectionUnlock(sessionAsync->critSect);
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of SessionAsyncIsCancelled ***/
+
+
+/************************************************************************************//**
+** \brief     Determines the total number of bytes that an operation processes.
+** \param     operation Pointer to the operation.
+** \return    Total number of bytes. 0 for operations without a memory range.
+**
+****************************************************************************************/
+static uint32_t SessionAsyncGetTotal(tSessionAsyncOperation const * operation)
+{
+  uint32_t result = 0;
+
+  if ( (operation->type == SESSION_ASYNC_OP_CLEAR_MEMORY) ||
+       (operation->type == SESSION_ASYNC_OP_WRITE_DATA) ||
+       (operation->type == SESSION_ASYNC_OP_READ_DATA) )
+  {
+    result = operation->len;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of SessionAsyncGetTotal ***/
+
+
+/*********************************** end of sessionasync.c *****************************/
@@ -0,0 +1,118 @@
+/************************************************************************************//**
+* \file         sessionasync.h
+* \brief        Asynchronous session operations module header file.
+* \ingroup      SessionAsync
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+* 
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+* 
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+*
+* \endinternal
+****************************************************************************************/
+/************************************************************************************//**
+* \defgroup   SessionAsync Asynchronous Session Operations Module
+* \brief      Module that executes session operations in the background.
+* \ingroup    Session
+* \details
+* The Asynchronous Session Operations module queues session operations and executes
+* them one after the other on a worker thread. Each object serves one session and has
+* its own worker thread, so the operations of different sessions run concurrently. The
+* application is not blocked while an operation runs. It learns about the progress and
+* the completion of the operations through events, which it retrieves from its own
+* thread. A notify event object signals that events are pending. It is passed in by the
+* creator of the object, so one notify event can serve multiple sessions.
+* Write and read operations are split up into chunks, so their progress can be reported
+* and so that they can be cancelled in between chunks. The session module serializes
+* the access to the protocol, so the synchronous session functions can still be used
+* while operations are pending.
+****************************************************************************************/
+#ifndef SESSIONASYNC_H
+#define SESSIONASYNC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/* Asynchronous session operation types. */
+#define SESSION_ASYNC_OP_START         (0u)       /**< Start the session.              */
+#define SESSION_ASYNC_OP_STOP          (1u)       /**< Stop the session.               */
+#define SESSION_ASYNC_OP_CLEAR_MEMORY  (2u)       /**< Erase memory on the target.     */
+#define SESSION_ASYNC_OP_WRITE_DATA    (3u)       /**< Program data on the target.     */
+#define SESSION_ASYNC_OP_READ_DATA     (4u)       /**< Upload data from the target.    */
+
+/* Asynchronous session event types. */
+#define SESSION_ASYNC_EVENT_PROGRESS   (0u)       /**< Operation made progress.        */
+#define SESSION_ASYNC_EVENT_COMPLETED  (1u)       /**< Operation completed.            */
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Handle of an asynchronous session operations object. */
+typedef void * tSessionAsyncHandle;
+
+/** \brief Layout of an asynchronous session operation. */
+typedef struct t_session_async_operation
+{
+  uint32_t type;                 /**< Operation type (SESSION_ASYNC_OP_xxx).           */
+  uint32_t address;              /**< Memory address for clear, write and read.        */
+  uint32_t len;                  /**< Number of bytes for clear, write and read.       */
+  uint8_t const * writeData;     /**< Data to program. Only used for write.            */
+  uint8_t * readData;            /**< Buffer for the uploaded data. Only used for read.*/
+  void * context;                /**< Context that is handed back with the events.     */
+} tSessionAsyncOperation;
+
+/** \brief Layout of an event of an asynchronous session operation. The progress is
+ *         the number of bytes that were processed so far, out of the total. For start
+ *         and stop operations, both are 0.
+ */
+typedef struct t_session_async_event
+{
+  void * context;                /**< Context of the operation.                        */
+  uint32_t operation;            /**< Operation type (SESSION_ASYNC_OP_xxx).           */
+  uint32_t type;                 /**< Event type (SESSION_ASYNC_EVENT_xxx).            */
+  bool result;                   /**< Completion result. Always true for progress.     */
+  uint32_t progress;             /**< Number of bytes processed so far.                */
+  uint32_t total;                /**< Total number of bytes to process.                */
+} tSessionAsyncEvent;
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+tSessionAsyncHandle SessionAsyncInit(tSessionHandle session, tUtilEvent notifyEvent);
+void SessionAsyncTerminate(tSessionAsyncHandle handle);
+bool SessionAsyncSubmit(tSessionAsyncHandle handle,
+                        tSessionAsyncOperation const * operation);
+void SessionAsyncCancel(tSessionAsyncHandle handle);
+bool SessionAsyncGetEvent(tSessionAsyncHandle handle, tSessionAsyncEvent * event);
+uint32_t SessionAsyncGetPendingCount(tSessionAsyncHandle handle);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SESSIONASYNC_H */
+/********************************* end of sessionasync.h *******************************/
@@ -0,0 +1,107 @@
+/************************************************************************************//**
+* \file         udpaccess.h
+* \brief        UDP/IP network access header file.
+* \ingroup      UdpAccess
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+* 
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+* 
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+*
+* \endinternal
+****************************************************************************************/
+/************************************************************************************//**
+* \defgroup   UdpAccess UDP/IP Network Access
+* \brief      This module implements a generic UDP/IP network access client driver.
+* \ingroup    Session
+* \details
+* The socket is connected to the server, so only datagrams from the server are
+* received. Multiple datagrams can be sent and received with one call, which the port
+* implementation maps onto a single system call where the operating system supports
+* this.
+****************************************************************************************/
+#ifndef UDPACCESS_H
+#define UDPACCESS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Maximum number of buffers that a datagram for sending can consist of. */
+#define UDPACCESS_BUFFERS_MAX          (4u)
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Layout of a datagram for receiving. The length field holds the size of the
+ *         data buffer on entry. A datagram that does not fit is truncated to the size
+ *         of the data buffer.
+ */
+typedef struct t_udp_access_datagram
+{
+  uint8_t * data;                /**< Pointer to the datagram data.                    */
+  uint32_t length;               /**< Number of bytes in the datagram.                 */
+} tUdpAccessDatagram;
+
+/** \brief Layout of a buffer with a part of a datagram for sending. */
+typedef struct t_udp_access_buffer
+{
+  uint8_t const * data;          /**< Pointer to the buffer data.                      */
+  uint32_t length;               /**< Number of bytes in the buffer.                   */
+} tUdpAccessBuffer;
+
+/** \brief Layout of a datagram for sending. The datagram is gathered from the data
+ *         of its buffers, so the parts of the datagram do not need to be copied into
+ *         one buffer first.
+ */
+typedef struct t_udp_access_tx_datagram
+{
+  tUdpAccessBuffer const * buffers; /**< Pointer to the array with buffers.            */
+  uint32_t count;                /**< Number of buffers, up to UDPACCESS_BUFFERS_MAX.  */
+} tUdpAccessTxDatagram;
+
+/** \brief Handle of a UDP network access object. Each object manages its own socket,
+ *         so multiple connections can be used at the same time.
+ */
+typedef void * tUdpAccessHandle;
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+tUdpAccessHandle UdpAccessInit(void);
+void UdpAccessTerminate(tUdpAccessHandle handle);
+bool UdpAccessConnect(tUdpAccessHandle handle, char const * address, uint16_t port);
+void UdpAccessDisconnect(tUdpAccessHandle handle);
+bool UdpAccessSend(tUdpAccessHandle handle, tUdpAccessTxDatagram const * datagrams,
+                   uint32_t count);
+uint32_t UdpAccessReceive(tUdpAccessHandle handle, tUdpAccessDatagram * datagrams,
+                          uint32_t count, uint32_t timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UDPACCESS_H */
+/********************************* end of udpaccess.h **********************************/
@@ -35,9 +35,67 @@
 #include <stdint.h>                         /* for standard integer types              */
 #include <stddef.h>                         /* for NULL declaration                    */
 #include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
 #include <string.h>                         /* for string library                      */
 #include "util.h"                           /* Utility module                          */
 #include "aes256.h"                         /* for AES256 cryptography.                */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>                          /* for CPU feature detection               */
+#include <wmmintrin.h>                      /* for carry-less multiplication           */
+#include <tmmintrin.h>                      /* for byte shuffling                      */
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>                         /* for CPU feature detection and SIMD      */
+#endif
+
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/* The carry-less multiplication checksum kernel is only available on x86 and needs
+ * compiler support for the intrinsics. The functions that use them are compiled for
+ * the required instruction set extensions, so the rest of the library does not need
+ * them. CPUID decides at run-time if they can be used.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+/** \brief Carry-less multiplication checksum kernel is available. */
+#define UTIL_CHECKSUM_CLMUL_ENABLE     (1)
+/** \brief Function attribute for the carry-less multiplication checksum kernel. */
+#define UTIL_CHECKSUM_CLMUL_TARGET     __attribute__((target("pclmul,ssse3,sse2")))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+/** \brief Carry-less multiplication checksum kernel is available. */
+#define UTIL_CHECKSUM_CLMUL_ENABLE     (1)
+/** \brief Function attribute for the carry-less multiplication checksum kernel. */
+#define UTIL_CHECKSUM_CLMUL_TARGET
+#endif
+
+/** \brief Minimum number of bytes for the carry-less multiplication checksum kernel. It
+ *         folds four blocks of 16 bytes in parallel. Shorter data is processed with the
+ *         slicing-by-8 kernel.
+ */
+#define UTIL_CHECKSUM_CLMUL_MIN_LEN    (64u)
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+static uint16_t UtilChecksumCrc16Process(uint16_t crc, uint8_t const * data,
+                                        uint32_t len, uint8_t kernel);
+static uint32_t UtilChecksumCrc32Process(uint32_t crc, uint8_t const * data,
+                                        uint32_t len, uint8_t kernel);
+static uint32_t UtilChecksumCrcShift(uint32_t crc, uint32_t len, uint32_t poly);
+static uint32_t UtilChecksumCrcMultiply(uint32_t a, uint32_t b, uint32_t poly);
+static uint16_t UtilChecksumCrc16Byte(uint16_t crc, uint8_t const * data, uint32_t len);
+static uint32_t UtilChecksumCrc32Byte(uint32_t crc, uint8_t const * data, uint32_t len);
+static uint16_t UtilChecksumCrc16Slice8(uint16_t crc, uint8_t const * data,
+                                        uint32_t len);
+static uint32_t UtilChecksumCrc32Slice8(uint32_t crc, uint8_t const * data,
+                                        uint32_t len);
+#if defined(UTIL_CHECKSUM_CLMUL_ENABLE)
+static bool UtilChecksumClmulDetect(void);
+static uint32_t UtilChecksumClmulFold(uint32_t crc, uint8_t const * data, uint32_t len,
+                                      uint32_t const * constants, uint8_t * folded);
+#endif
+static void UtilChecksumSha256Block(uint32_t * state, uint8_t const * block);
 
 
 /****************************************************************************************
@@ -126,69 +184,1378 @@ static const uint32_t utilChecksumCrc32Table[256] =
   0xBCB4666D, 0xB8757BDA, 0xB5365D03, 0xB1F740B4
 };
 
+/** \brief Additional lookup tables for the slicing-by-8 calculation of a 16-bit CRC
+ *         checksum. Entry [k-1][b] holds the CRC of byte b followed by k zero bytes, so
+ *         eight bytes can be processed with eight independent table lookups. Table 0 is
+ *         utilChecksumCrc16Table.
+ */
+static const uint16_t utilChecksumCrc16SliceTable[7][256] =
+{
+  {
+    0x0000, 0x8603, 0x8C03, 0x0A00, 0x9803, 0x1E00, 0x1400, 0x9203,
+    0xB003, 0x3600, 0x3C00, 0xBA03, 0x2800, 0xAE03, 0xA403, 0x2200,
+    0xE003, 0x6600, 0x6C00, 0xEA03, 0x7800, 0xFE03, 0xF403, 0x7200,
+    0x5000, 0xD603, 0xDC03, 0x5A00, 0xC803, 0x4E00, 0x4400, 0xC203,
+    0x4003, 0xC600, 0xCC00, 0x4A03, 0xD800, 0x5E03, 0x5403, 0xD200,
+    0xF000, 0x7603, 0x7C03, 0xFA00, 0x6803, 0xEE00, 0xE400, 0x6203,
+    0xA000, 0x2603, 0x2C03, 0xAA00, 0x3803, 0xBE00, 0xB400, 0x3203,
+    0x1003, 0x9600, 0x9C00, 0x1A03, 0x8800, 0x0E03, 0x0403, 0x8200,
+    0x8006, 0x0605, 0x0C05, 0x8A06, 0x1805, 0x9E06, 0x9406, 0x1205,
+    0x3005, 0xB606, 0xBC06, 0x3A05, 0xA806, 0x2E05, 0x2405, 0xA206,
+    0x6005, 0xE606, 0xEC06, 0x6A05, 0xF806, 0x7E05, 0x7405, 0xF206,
+    0xD006, 0x5605, 0x5C05, 0xDA06, 0x4805, 0xCE06, 0xC406, 0x4205,
+    0xC005, 0x4606, 0x4C06, 0xCA05, 0x5806, 0xDE05, 0xD405, 0x5206,
+    0x7006, 0xF605, 0xFC05, 0x7A06, 0xE805, 0x6E06, 0x6406, 0xE205,
+    0x2006, 0xA605, 0xAC05, 0x2A06, 0xB805, 0x3E06, 0x3406, 0xB205,
+    0x9005, 0x1606, 0x1C06, 0x9A05, 0x0806, 0x8E05, 0x8405, 0x0206,
+    0x8009, 0x060A, 0x0C0A, 0x8A09, 0x180A, 0x9E09, 0x9409, 0x120A,
+    0x300A, 0xB609, 0xBC09, 0x3A0A, 0xA809, 0x2E0A, 0x240A, 0xA209,
+    0x600A, 0xE609, 0xEC09, 0x6A0A, 0xF809, 0x7E0A, 0x740A, 0xF209,
+    0xD009, 0x560A, 0x5C0A, 0xDA09, 0x480A, 0xCE09, 0xC409, 0x420A,
+    0xC00A, 0x4609, 0x4C09, 0xCA0A, 0x5809, 0xDE0A, 0xD40A, 0x5209,
+    0x7009, 0xF60A, 0xFC0A, 0x7A09, 0xE80A, 0x6E09, 0x6409, 0xE20A,
+    0x2009, 0xA60A, 0xAC0A, 0x2A09, 0xB80A, 0x3E09, 0x3409, 0xB20A,
+    0x900A, 0x1609, 0x1C09, 0x9A0A, 0x0809, 0x8E0A, 0x840A, 0x0209,
+    0x000F, 0x860C, 0x8C0C, 0x0A0F, 0x980C, 0x1E0F, 0x140F, 0x920C,
+    0xB00C, 0x360F, 0x3C0F, 0xBA0C, 0x280F, 0xAE0C, 0xA40C, 0x220F,
+    0xE00C, 0x660F, 0x6C0F, 0xEA0C, 0x780F, 0xFE0C, 0xF40C, 0x720F,
+    0x500F, 0xD60C, 0xDC0C, 0x5A0F, 0xC80C, 0x4E0F, 0x440F, 0xC20C,
+    0x400C, 0xC60F, 0xCC0F, 0x4A0C, 0xD80F, 0x5E0C, 0x540C, 0xD20F,
+    0xF00F, 0x760C, 0x7C0C, 0xFA0F, 0x680C, 0xEE0F, 0xE40F, 0x620C,
+    0xA00F, 0x260C, 0x2C0C, 0xAA0F, 0x380C, 0xBE0F, 0xB40F, 0x320C,
+    0x100C, 0x960F, 0x9C0F, 0x1A0C, 0x880F, 0x0E0C, 0x040C, 0x820F
+  },
+  {
+    0x0000, 0x8017, 0x802B, 0x003C, 0x8053, 0x0044, 0x0078, 0x806F,
+    0x80A3, 0x00B4, 0x0088, 0x809F, 0x00F0, 0x80E7, 0x80DB, 0x00CC,
+    0x8143, 0x0154, 0x0168, 0x817F, 0x0110, 0x8107, 0x813B, 0x012C,
+    0x01E0, 0x81F7, 0x81CB, 0x01DC, 0x81B3, 0x01A4, 0x0198, 0x818F,
+    0x8283, 0x0294, 0x02A8, 0x82BF, 0x02D0, 0x82C7, 0x82FB, 0x02EC,
+    0x0220, 0x8237, 0x820B, 0x021C, 0x8273, 0x0264, 0x0258, 0x824F,
+    0x03C0, 0x83D7, 0x83EB, 0x03FC, 0x8393, 0x0384, 0x03B8, 0x83AF,
+    0x8363, 0x0374, 0x0348, 0x835F, 0x0330, 0x8327, 0x831B, 0x030C,
+    0x8503, 0x0514, 0x0528, 0x853F, 0x0550, 0x8547, 0x857B, 0x056C,
+    0x05A0, 0x85B7, 0x858B, 0x059C, 0x85F3, 0x05E4, 0x05D8, 0x85CF,
+    0x0440, 0x8457, 0x846B, 0x047C, 0x8413, 0x0404, 0x0438, 0x842F,
+    0x84E3, 0x04F4, 0x04C8, 0x84DF, 0x04B0, 0x84A7, 0x849B, 0x048C,
+    0x0780, 0x8797, 0x87AB, 0x07BC, 0x87D3, 0x07C4, 0x07F8, 0x87EF,
+    0x8723, 0x0734, 0x0708, 0x871F, 0x0770, 0x8767, 0x875B, 0x074C,
+    0x86C3, 0x06D4, 0x06E8, 0x86FF, 0x0690, 0x8687, 0x86BB, 0x06AC,
+    0x0660, 0x8677, 0x864B, 0x065C, 0x8633, 0x0624, 0x0618, 0x860F,
+    0x8A03, 0x0A14, 0x0A28, 0x8A3F, 0x0A50, 0x8A47, 0x8A7B, 0x0A6C,
+    0x0AA0, 0x8AB7, 0x8A8B, 0x0A9C, 0x8AF3, 0x0AE4, 0x0AD8, 0x8ACF,
+    0x0B40, 0x8B57, 0x8B6B, 0x0B7C, 0x8B13, 0x0B04, 0x0B38, 0x8B2F,
+    0x8BE3, 0x0BF4, 0x0BC8, 0x8BDF, 0x0BB0, 0x8BA7, 0x8B9B, 0x0B8C,
+    0x0880, 0x8897, 0x88AB, 0x08BC, 0x88D3, 0x08C4, 0x08F8, 0x88EF,
+    0x8823, 0x0834, 0x0808, 0x881F, 0x0870, 0x8867, 0x885B, 0x084C,
+    0x89C3, 0x09D4, 0x09E8, 0x89FF, 0x0990, 0x8987, 0x89BB, 0x09AC,
+    0x0960, 0x8977, 0x894B, 0x095C, 0x8933, 0x0924, 0x0918, 0x890F,
+    0x0F00, 0x8F17, 0x8F2B, 0x0F3C, 0x8F53, 0x0F44, 0x0F78, 0x8F6F,
+    0x8FA3, 0x0FB4, 0x0F88, 0x8F9F, 0x0FF0, 0x8FE7, 0x8FDB, 0x0FCC,
+    0x8E43, 0x0E54, 0x0E68, 0x8E7F, 0x0E10, 0x8E07, 0x8E3B, 0x0E2C,
+    0x0EE0, 0x8EF7, 0x8ECB, 0x0EDC, 0x8EB3, 0x0EA4, 0x0E98, 0x8E8F,
+    0x8D83, 0x0D94, 0x0DA8, 0x8DBF, 0x0DD0, 0x8DC7, 0x8DFB, 0x0DEC,
+    0x0D20, 0x8D37, 0x8D0B, 0x0D1C, 0x8D73, 0x0D64, 0x0D58, 0x8D4F,
+    0x0CC0, 0x8CD7, 0x8CEB, 0x0CFC, 0x8C93, 0x0C84, 0x0CB8, 0x8CAF,
+    0x8C63, 0x0C74, 0x0C48, 0x8C5F, 0x0C30, 0x8C27, 0x8C1B, 0x0C0C
+  },
+  {
+    0x0000, 0x9403, 0xA803, 0x3C00, 0xD003, 0x4400, 0x7800, 0xEC03,
+    0x2003, 0xB400, 0x8800, 0x1C03, 0xF000, 0x6403, 0x5803, 0xCC00,
+    0x4006, 0xD405, 0xE805, 0x7C06, 0x9005, 0x0406, 0x3806, 0xAC05,
+    0x6005, 0xF406, 0xC806, 0x5C05, 0xB006, 0x2405, 0x1805, 0x8C06,
+    0x800C, 0x140F, 0x280F, 0xBC0C, 0x500F, 0xC40C, 0xF80C, 0x6C0F,
+    0xA00F, 0x340C, 0x080C, 0x9C0F, 0x700C, 0xE40F, 0xD80F, 0x4C0C,
+    0xC00A, 0x5409, 0x6809, 0xFC0A, 0x1009, 0x840A, 0xB80A, 0x2C09,
+    0xE009, 0x740A, 0x480A, 0xDC09, 0x300A, 0xA409, 0x9809, 0x0C0A,
+    0x801D, 0x141E, 0x281E, 0xBC1D, 0x501E, 0xC41D, 0xF81D, 0x6C1E,
+    0xA01E, 0x341D, 0x081D, 0x9C1E, 0x701D, 0xE41E, 0xD81E, 0x4C1D,
+    0xC01B, 0x5418, 0x6818, 0xFC1B, 0x1018, 0x841B, 0xB81B, 0x2C18,
+    0xE018, 0x741B, 0x481B, 0xDC18, 0x301B, 0xA418, 0x9818, 0x0C1B,
+    0x0011, 0x9412, 0xA812, 0x3C11, 0xD012, 0x4411, 0x7811, 0xEC12,
+    0x2012, 0xB411, 0x8811, 0x1C12, 0xF011, 0x6412, 0x5812, 0xCC11,
+    0x4017, 0xD414, 0xE814, 0x7C17, 0x9014, 0x0417, 0x3817, 0xAC14,
+    0x6014, 0xF417, 0xC817, 0x5C14, 0xB017, 0x2414, 0x1814, 0x8C17,
+    0x803F, 0x143C, 0x283C, 0xBC3F, 0x503C, 0xC43F, 0xF83F, 0x6C3C,
+    0xA03C, 0x343F, 0x083F, 0x9C3C, 0x703F, 0xE43C, 0xD83C, 0x4C3F,
+    0xC039, 0x543A, 0x683A, 0xFC39, 0x103A, 0x8439, 0xB839, 0x2C3A,
+    0xE03A, 0x7439, 0x4839, 0xDC3A, 0x3039, 0xA43A, 0x983A, 0x0C39,
+    0x0033, 0x9430, 0xA830, 0x3C33, 0xD030, 0x4433, 0x7833, 0xEC30,
+    0x2030, 0xB433, 0x8833, 0x1C30, 0xF033, 0x6430, 0x5830, 0xCC33,
+    0x4035, 0xD436, 0xE836, 0x7C35, 0x9036, 0x0435, 0x3835, 0xAC36,
+    0x6036, 0xF435, 0xC835, 0x5C36, 0xB035, 0x2436, 0x1836, 0x8C35,
+    0x0022, 0x9421, 0xA821, 0x3C22, 0xD021, 0x4422, 0x7822, 0xEC21,
+    0x2021, 0xB422, 0x8822, 0x1C21, 0xF022, 0x6421, 0x5821, 0xCC22,
+    0x4024, 0xD427, 0xE827, 0x7C24, 0x9027, 0x0424, 0x3824, 0xAC27,
+    0x6027, 0xF424, 0xC824, 0x5C27, 0xB024, 0x2427, 0x1827, 0x8C24,
+    0x802E, 0x142D, 0x282D, 0xBC2E, 0x502D, 0xC42E, 0xF82E, 0x6C2D,
+    0xA02D, 0x342E, 0x082E, 0x9C2D, 0x702E, 0xE42D, 0xD82D, 0x4C2E,
+    0xC028, 0x542B, 0x682B, 0xFC28, 0x102B, 0x8428, 0xB828, 0x2C2B,
+    0xE02B, 0x7428, 0x4828, 0xDC2B, 0x3028, 0xA42B, 0x982B, 0x0C28
+  },
+  {
+    0x0000, 0x807B, 0x80F3, 0x0088, 0x81E3, 0x0198, 0x0110, 0x816B,
+    0x83C3, 0x03B8, 0x0330, 0x834B, 0x0220, 0x825B, 0x82D3, 0x02A8,
+    0x8783, 0x07F8, 0x0770, 0x870B, 0x0660, 0x861B, 0x8693, 0x06E8,
+    0x0440, 0x843B, 0x84B3, 0x04C8, 0x85A3, 0x05D8, 0x0550, 0x852B,
+    0x8F03, 0x0F78, 0x0FF0, 0x8F8B, 0x0EE0, 0x8E9B, 0x8E13, 0x0E68,
+    0x0CC0, 0x8CBB, 0x8C33, 0x0C48, 0x8D23, 0x0D58, 0x0DD0, 0x8DAB,
+    0x0880, 0x88FB, 0x8873, 0x0808, 0x8963, 0x0918, 0x0990, 0x89EB,
+    0x8B43, 0x0B38, 0x0BB0, 0x8BCB, 0x0AA0, 0x8ADB, 0x8A53, 0x0A28,
+    0x9E03, 0x1E78, 0x1EF0, 0x9E8B, 0x1FE0, 0x9F9B, 0x9F13, 0x1F68,
+    0x1DC0, 0x9DBB, 0x9D33, 0x1D48, 0x9C23, 0x1C58, 0x1CD0, 0x9CAB,
+    0x1980, 0x99FB, 0x9973, 0x1908, 0x9863, 0x1818, 0x1890, 0x98EB,
+    0x9A43, 0x1A38, 0x1AB0, 0x9ACB, 0x1BA0, 0x9BDB, 0x9B53, 0x1B28,
+    0x1100, 0x917B, 0x91F3, 0x1188, 0x90E3, 0x1098, 0x1010, 0x906B,
+    0x92C3, 0x12B8, 0x1230, 0x924B, 0x1320, 0x935B, 0x93D3, 0x13A8,
+    0x9683, 0x16F8, 0x1670, 0x960B, 0x1760, 0x971B, 0x9793, 0x17E8,
+    0x1540, 0x953B, 0x95B3, 0x15C8, 0x94A3, 0x14D8, 0x1450, 0x942B,
+    0xBC03, 0x3C78, 0x3CF0, 0xBC8B, 0x3DE0, 0xBD9B, 0xBD13, 0x3D68,
+    0x3FC0, 0xBFBB, 0xBF33, 0x3F48, 0xBE23, 0x3E58, 0x3ED0, 0xBEAB,
+    0x3B80, 0xBBFB, 0xBB73, 0x3B08, 0xBA63, 0x3A18, 0x3A90, 0xBAEB,
+    0xB843, 0x3838, 0x38B0, 0xB8CB, 0x39A0, 0xB9DB, 0xB953, 0x3928,
+    0x3300, 0xB37B, 0xB3F3, 0x3388, 0xB2E3, 0x3298, 0x3210, 0xB26B,
+    0xB0C3, 0x30B8, 0x3030, 0xB04B, 0x3120, 0xB15B, 0xB1D3, 0x31A8,
+    0xB483, 0x34F8, 0x3470, 0xB40B, 0x3560, 0xB51B, 0xB593, 0x35E8,
+    0x3740, 0xB73B, 0xB7B3, 0x37C8, 0xB6A3, 0x36D8, 0x3650, 0xB62B,
+    0x2200, 0xA27B, 0xA2F3, 0x2288, 0xA3E3, 0x2398, 0x2310, 0xA36B,
+    0xA1C3, 0x21B8, 0x2130, 0xA14B, 0x2020, 0xA05B, 0xA0D3, 0x20A8,
+    0xA583, 0x25F8, 0x2570, 0xA50B, 0x2460, 0xA41B, 0xA493, 0x24E8,
+    0x2640, 0xA63B, 0xA6B3, 0x26C8, 0xA7A3, 0x27D8, 0x2750, 0xA72B,
+    0xAD03, 0x2D78, 0x2DF0, 0xAD8B, 0x2CE0, 0xAC9B, 0xAC13, 0x2C68,
+    0x2EC0, 0xAEBB, 0xAE33, 0x2E48, 0xAF23, 0x2F58, 0x2FD0, 0xAFAB,
+    0x2A80, 0xAAFB, 0xAA73, 0x2A08, 0xAB63, 0x2B18, 0x2B90, 0xABEB,
+    0xA943, 0x2938, 0x29B0, 0xA9CB, 0x28A0, 0xA8DB, 0xA853, 0x2828
+  },
+  {
+    0x0000, 0xF803, 0x7003, 0x8800, 0xE006, 0x1805, 0x9005, 0x6806,
+    0x4009, 0xB80A, 0x300A, 0xC809, 0xA00F, 0x580C, 0xD00C, 0x280F,
+    0x8012, 0x7811, 0xF011, 0x0812, 0x6014, 0x9817, 0x1017, 0xE814,
+    0xC01B, 0x3818, 0xB018, 0x481B, 0x201D, 0xD81E, 0x501E, 0xA81D,
+    0x8021, 0x7822, 0xF022, 0x0821, 0x6027, 0x9824, 0x1024, 0xE827,
+    0xC028, 0x382B, 0xB02B, 0x4828, 0x202E, 0xD82D, 0x502D, 0xA82E,
+    0x0033, 0xF830, 0x7030, 0x8833, 0xE035, 0x1836, 0x9036, 0x6835,
+    0x403A, 0xB839, 0x3039, 0xC83A, 0xA03C, 0x583F, 0xD03F, 0x283C,
+    0x8047, 0x7844, 0xF044, 0x0847, 0x6041, 0x9842, 0x1042, 0xE841,
+    0xC04E, 0x384D, 0xB04D, 0x484E, 0x2048, 0xD84B, 0x504B, 0xA848,
+    0x0055, 0xF856, 0x7056, 0x8855, 0xE053, 0x1850, 0x9050, 0x6853,
+    0x405C, 0xB85F, 0x305F, 0xC85C, 0xA05A, 0x5859, 0xD059, 0x285A,
+    0x0066, 0xF865, 0x7065, 0x8866, 0xE060, 0x1863, 0x9063, 0x6860,
+    0x406F, 0xB86C, 0x306C, 0xC86F, 0xA069, 0x586A, 0xD06A, 0x2869,
+    0x8074, 0x7877, 0xF077, 0x0874, 0x6072, 0x9871, 0x1071, 0xE872,
+    0xC07D, 0x387E, 0xB07E, 0x487D, 0x207B, 0xD878, 0x5078, 0xA87B,
+    0x808B, 0x7888, 0xF088, 0x088B, 0x608D, 0x988E, 0x108E, 0xE88D,
+    0xC082, 0x3881, 0xB081, 0x4882, 0x2084, 0xD887, 0x5087, 0xA884,
+    0x0099, 0xF89A, 0x709A, 0x8899, 0xE09F, 0x189C, 0x909C, 0x689F,
+    0x4090, 0xB893, 0x3093, 0xC890, 0xA096, 0x5895, 0xD095, 0x2896,
+    0x00AA, 0xF8A9, 0x70A9, 0x88AA, 0xE0AC, 0x18AF, 0x90AF, 0x68AC,
+    0x40A3, 0xB8A0, 0x30A0, 0xC8A3, 0xA0A5, 0x58A6, 0xD0A6, 0x28A5,
+    0x80B8, 0x78BB, 0xF0BB, 0x08B8, 0x60BE, 0x98BD, 0x10BD, 0xE8BE,
+    0xC0B1, 0x38B2, 0xB0B2, 0x48B1, 0x20B7, 0xD8B4, 0x50B4, 0xA8B7,
+    0x00CC, 0xF8CF, 0x70CF, 0x88CC, 0xE0CA, 0x18C9, 0x90C9, 0x68CA,
+    0x40C5, 0xB8C6, 0x30C6, 0xC8C5, 0xA0C3, 0x58C0, 0xD0C0, 0x28C3,
+    0x80DE, 0x78DD, 0xF0DD, 0x08DE, 0x60D8, 0x98DB, 0x10DB, 0xE8D8,
+    0xC0D7, 0x38D4, 0xB0D4, 0x48D7, 0x20D1, 0xD8D2, 0x50D2, 0xA8D1,
+    0x80ED, 0x78EE, 0xF0EE, 0x08ED, 0x60EB, 0x98E8, 0x10E8, 0xE8EB,
+    0xC0E4, 0x38E7, 0xB0E7, 0x48E4, 0x20E2, 0xD8E1, 0x50E1, 0xA8E2,
+    0x00FF, 0xF8FC, 0x70FC, 0x88FF, 0xE0F9, 0x18FA, 0x90FA, 0x68F9,
+    0x40F6, 0xB8F5, 0x30F5, 0xC8F6, 0xA0F0, 0x58F3, 0xD0F3, 0x28F0
+  },
+  {
+    0x0000, 0x8113, 0x8223, 0x0330, 0x8443, 0x0550, 0x0660, 0x8773,
+    0x8883, 0x0990, 0x0AA0, 0x8BB3, 0x0CC0, 0x8DD3, 0x8EE3, 0x0FF0,
+    0x9103, 0x1010, 0x1320, 0x9233, 0x1540, 0x9453, 0x9763, 0x1670,
+    0x1980, 0x9893, 0x9BA3, 0x1AB0, 0x9DC3, 0x1CD0, 0x1FE0, 0x9EF3,
+    0xA203, 0x2310, 0x2020, 0xA133, 0x2640, 0xA753, 0xA463, 0x2570,
+    0x2A80, 0xAB93, 0xA8A3, 0x29B0, 0xAEC3, 0x2FD0, 0x2CE0, 0xADF3,
+    0x3300, 0xB213, 0xB123, 0x3030, 0xB743, 0x3650, 0x3560, 0xB473,
+    0xBB83, 0x3A90, 0x39A0, 0xB8B3, 0x3FC0, 0xBED3, 0xBDE3, 0x3CF0,
+    0xC403, 0x4510, 0x4620, 0xC733, 0x4040, 0xC153, 0xC263, 0x4370,
+    0x4C80, 0xCD93, 0xCEA3, 0x4FB0, 0xC8C3, 0x49D0, 0x4AE0, 0xCBF3,
+    0x5500, 0xD413, 0xD723, 0x5630, 0xD143, 0x5050, 0x5360, 0xD273,
+    0xDD83, 0x5C90, 0x5FA0, 0xDEB3, 0x59C0, 0xD8D3, 0xDBE3, 0x5AF0,
+    0x6600, 0xE713, 0xE423, 0x6530, 0xE243, 0x6350, 0x6060, 0xE173,
+    0xEE83, 0x6F90, 0x6CA0, 0xEDB3, 0x6AC0, 0xEBD3, 0xE8E3, 0x69F0,
+    0xF703, 0x7610, 0x7520, 0xF433, 0x7340, 0xF253, 0xF163, 0x7070,
+    0x7F80, 0xFE93, 0xFDA3, 0x7CB0, 0xFBC3, 0x7AD0, 0x79E0, 0xF8F3,
+    0x0803, 0x8910, 0x8A20, 0x0B33, 0x8C40, 0x0D53, 0x0E63, 0x8F70,
+    0x8080, 0x0193, 0x02A3, 0x83B0, 0x04C3, 0x85D0, 0x86E0, 0x07F3,
+    0x9900, 0x1813, 0x1B23, 0x9A30, 0x1D43, 0x9C50, 0x9F60, 0x1E73,
+    0x1183, 0x9090, 0x93A0, 0x12B3, 0x95C0, 0x14D3, 0x17E3, 0x96F0,
+    0xAA00, 0x2B13, 0x2823, 0xA930, 0x2E43, 0xAF50, 0xAC60, 0x2D73,
+    0x2283, 0xA390, 0xA0A0, 0x21B3, 0xA6C0, 0x27D3, 0x24E3, 0xA5F0,
+    0x3B03, 0xBA10, 0xB920, 0x3833, 0xBF40, 0x3E53, 0x3D63, 0xBC70,
+    0xB380, 0x3293, 0x31A3, 0xB0B0, 0x37C3, 0xB6D0, 0xB5E0, 0x34F3,
+    0xCC00, 0x4D13, 0x4E23, 0xCF30, 0x4843, 0xC950, 0xCA60, 0x4B73,
+    0x4483, 0xC590, 0xC6A0, 0x47B3, 0xC0C0, 0x41D3, 0x42E3, 0xC3F0,
+    0x5D03, 0xDC10, 0xDF20, 0x5E33, 0xD940, 0x5853, 0x5B63, 0xDA70,
+    0xD580, 0x5493, 0x57A3, 0xD6B0, 0x51C3, 0xD0D0, 0xD3E0, 0x52F3,
+    0x6E03, 0xEF10, 0xEC20, 0x6D33, 0xEA40, 0x6B53, 0x6863, 0xE970,
+    0xE680, 0x6793, 0x64A3, 0xE5B0, 0x62C3, 0xE3D0, 0xE0E0, 0x61F3,
+    0xFF00, 0x7E13, 0x7D23, 0xFC30, 0x7B43, 0xFA50, 0xF960, 0x7873,
+    0x7783, 0xF690, 0xF5A0, 0x74B3, 0xF3C0, 0x72D3, 0x71E3, 0xF0F0
+  },
+  {
+    0x0000, 0x1006, 0x200C, 0x300A, 0x4018, 0x501E, 0x6014, 0x7012,
+    0x8030, 0x9036, 0xA03C, 0xB03A, 0xC028, 0xD02E, 0xE024, 0xF022,
+    0x8065, 0x9063, 0xA069, 0xB06F, 0xC07D, 0xD07B, 0xE071, 0xF077,
+    0x0055, 0x1053, 0x2059, 0x305F, 0x404D, 0x504B, 0x6041, 0x7047,
+    0x80CF, 0x90C9, 0xA0C3, 0xB0C5, 0xC0D7, 0xD0D1, 0xE0DB, 0xF0DD,
+    0x00FF, 0x10F9, 0x20F3, 0x30F5, 0x40E7, 0x50E1, 0x60EB, 0x70ED,
+    0x00AA, 0x10AC, 0x20A6, 0x30A0, 0x40B2, 0x50B4, 0x60BE, 0x70B8,
+    0x809A, 0x909C, 0xA096, 0xB090, 0xC082, 0xD084, 0xE08E, 0xF088,
+    0x819B, 0x919D, 0xA197, 0xB191, 0xC183, 0xD185, 0xE18F, 0xF189,
+    0x01AB, 0x11AD, 0x21A7, 0x31A1, 0x41B3, 0x51B5, 0x61BF, 0x71B9,
+    0x01FE, 0x11F8, 0x21F2, 0x31F4, 0x41E6, 0x51E0, 0x61EA, 0x71EC,
+    0x81CE, 0x91C8, 0xA1C2, 0xB1C4, 0xC1D6, 0xD1D0, 0xE1DA, 0xF1DC,
+    0x0154, 0x1152, 0x2158, 0x315E, 0x414C, 0x514A, 0x6140, 0x7146,
+    0x8164, 0x9162, 0xA168, 0xB16E, 0xC17C, 0xD17A, 0xE170, 0xF176,
+    0x8131, 0x9137, 0xA13D, 0xB13B, 0xC129, 0xD12F, 0xE125, 0xF123,
+    0x0101, 0x1107, 0x210D, 0x310B, 0x4119, 0x511F, 0x6115, 0x7113,
+    0x8333, 0x9335, 0xA33F, 0xB339, 0xC32B, 0xD32D, 0xE327, 0xF321,
+    0x0303, 0x1305, 0x230F, 0x3309, 0x431B, 0x531D, 0x6317, 0x7311,
+    0x0356, 0x1350, 0x235A, 0x335C, 0x434E, 0x5348, 0x6342, 0x7344,
+    0x8366, 0x9360, 0xA36A, 0xB36C, 0xC37E, 0xD378, 0xE372, 0xF374,
+    0x03FC, 0x13FA, 0x23F0, 0x33F6, 0x43E4, 0x53E2, 0x63E8, 0x73EE,
+    0x83CC, 0x93CA, 0xA3C0, 0xB3C6, 0xC3D4, 0xD3D2, 0xE3D8, 0xF3DE,
+    0x8399, 0x939F, 0xA395, 0xB393, 0xC381, 0xD387, 0xE38D, 0xF38B,
+    0x03A9, 0x13AF, 0x23A5, 0x33A3, 0x43B1, 0x53B7, 0x63BD, 0x73BB,
+    0x02A8, 0x12AE, 0x22A4, 0x32A2, 0x42B0, 0x52B6, 0x62BC, 0x72BA,
+    0x8298, 0x929E, 0xA294, 0xB292, 0xC280, 0xD286, 0xE28C, 0xF28A,
+    0x82CD, 0x92CB, 0xA2C1, 0xB2C7, 0xC2D5, 0xD2D3, 0xE2D9, 0xF2DF,
+    0x02FD, 0x12FB, 0x22F1, 0x32F7, 0x42E5, 0x52E3, 0x62E9, 0x72EF,
+    0x8267, 0x9261, 0xA26B, 0xB26D, 0xC27F, 0xD279, 0xE273, 0xF275,
+    0x0257, 0x1251, 0x225B, 0x325D, 0x424F, 0x5249, 0x6243, 0x7245,
+    0x0202, 0x1204, 0x220E, 0x3208, 0x421A, 0x521C, 0x6216, 0x7210,
+    0x8232, 0x9234, 0xA23E, 0xB238, 0xC22A, 0xD22C, 0xE226, 0xF220
+  }
+};
+
+/** \brief Additional lookup tables for the slicing-by-8 calculation of a 32-bit CRC
+ *         checksum. Entry [k-1][b] holds the CRC of byte b followed by k zero bytes, so
+ *         eight bytes can be processed with eight independent table lookups. Table 0 is
+ *         utilChecksumCrc32Table.
+ */
+static const uint32_t utilChecksumCrc32SliceTable[7][256] =
+{
+  {
+    0x00000000, 0xD219C1DC, 0xA0F29E0F, 0x72EB5FD3, 0x452421A9, 0x973DE075, 0xE5D6BFA6,
+    0x37CF7E7A, 0x8A484352, 0x5851828E, 0x2ABADD5D, 0xF8A31C81, 0xCF6C62FB, 0x1D75A327,
+    0x6F9EFCF4, 0xBD873D28, 0x10519B13, 0xC2485ACF, 0xB0A3051C, 0x62BAC4C0, 0x5575BABA,
+    0x876C7B66, 0xF58724B5, 0x279EE569, 0x9A19D841, 0x4800199D, 0x3AEB464E, 0xE8F28792,
+    0xDF3DF9E8, 0x0D243834, 0x7FCF67E7, 0xADD6A63B, 0x20A33626, 0xF2BAF7FA, 0x8051A829,
+    0x524869F5, 0x6587178F, 0xB79ED653, 0xC5758980, 0x176C485C, 0xAAEB7574, 0x78F2B4A8,
+    0x0A19EB7B, 0xD8002AA7, 0xEFCF54DD, 0x3DD69501, 0x4F3DCAD2, 0x9D240B0E, 0x30F2AD35,
+    0xE2EB6CE9, 0x9000333A, 0x4219F2E6, 0x75D68C9C, 0xA7CF4D40, 0xD5241293, 0x073DD34F,
+    0xBABAEE67, 0x68A32FBB, 0x1A487068, 0xC851B1B4, 0xFF9ECFCE, 0x2D870E12, 0x5F6C51C1,
+    0x8D75901D, 0x41466C4C, 0x935FAD90, 0xE1B4F243, 0x33AD339F, 0x04624DE5, 0xD67B8C39,
+    0xA490D3EA, 0x76891236, 0xCB0E2F1E, 0x1917EEC2, 0x6BFCB111, 0xB9E570CD, 0x8E2A0EB7,
+    0x5C33CF6B, 0x2ED890B8, 0xFCC15164, 0x5117F75F, 0x830E3683, 0xF1E56950, 0x23FCA88C,
+    0x1433D6F6, 0xC62A172A, 0xB4C148F9, 0x66D88925, 0xDB5FB40D, 0x094675D1, 0x7BAD2A02,
+    0xA9B4EBDE, 0x9E7B95A4, 0x4C625478, 0x3E890BAB, 0xEC90CA77, 0x61E55A6A, 0xB3FC9BB6,
+    0xC117C465, 0x130E05B9, 0x24C17BC3, 0xF6D8BA1F, 0x8433E5CC, 0x562A2410, 0xEBAD1938,
+    0x39B4D8E4, 0x4B5F8737, 0x994646EB, 0xAE893891, 0x7C90F94D, 0x0E7BA69E, 0xDC626742,
+    0x71B4C179, 0xA3AD00A5, 0xD1465F76, 0x035F9EAA, 0x3490E0D0, 0xE689210C, 0x94627EDF,
+    0x467BBF03, 0xFBFC822B, 0x29E543F7, 0x5B0E1C24, 0x8917DDF8, 0xBED8A382, 0x6CC1625E,
+    0x1E2A3D8D, 0xCC33FC51, 0x828CD898, 0x50951944, 0x227E4697, 0xF067874B, 0xC7A8F931,
+    0x15B138ED, 0x675A673E, 0xB543A6E2, 0x08C49BCA, 0xDADD5A16, 0xA83605C5, 0x7A2FC419,
+    0x4DE0BA63, 0x9FF97BBF, 0xED12246C, 0x3F0BE5B0, 0x92DD438B, 0x40C48257, 0x322FDD84,
+    0xE0361C58, 0xD7F96222, 0x05E0A3FE, 0x770BFC2D, 0xA5123DF1, 0x189500D9, 0xCA8CC105,
+    0xB8679ED6, 0x6A7E5F0A, 0x5DB12170, 0x8FA8E0AC, 0xFD43BF7F, 0x2F5A7EA3, 0xA22FEEBE,
+    0x70362F62, 0x02DD70B1, 0xD0C4B16D, 0xE70BCF17, 0x35120ECB, 0x47F95118, 0x95E090C4,
+    0x2867ADEC, 0xFA7E6C30, 0x889533E3, 0x5A8CF23F, 0x6D438C45, 0xBF5A4D99, 0xCDB1124A,
+    0x1FA8D396, 0xB27E75AD, 0x6067B471, 0x128CEBA2, 0xC0952A7E, 0xF75A5404, 0x254395D8,
+    0x57A8CA0B, 0x85B10BD7, 0x383636FF, 0xEA2FF723, 0x98C4A8F0, 0x4ADD692C, 0x7D121756,
+    0xAF0BD68A, 0xDDE08959, 0x0FF94885, 0xC3CAB4D4, 0x11D37508, 0x63382ADB, 0xB121EB07,
+    0x86EE957D, 0x54F754A1, 0x261C0B72, 0xF405CAAE, 0x4982F786, 0x9B9B365A, 0xE9706989,
+    0x3B69A855, 0x0CA6D62F, 0xDEBF17F3, 0xAC544820, 0x7E4D89FC, 0xD39B2FC7, 0x0182EE1B,
+    0x7369B1C8, 0xA1707014, 0x96BF0E6E, 0x44A6CFB2, 0x364D9061, 0xE45451BD, 0x59D36C95,
+    0x8BCAAD49, 0xF921F29A, 0x2B383346, 0x1CF74D3C, 0xCEEE8CE0, 0xBC05D333, 0x6E1C12EF,
+    0xE36982F2, 0x3170432E, 0x439B1CFD, 0x9182DD21, 0xA64DA35B, 0x74546287, 0x06BF3D54,
+    0xD4A6FC88, 0x6921C1A0, 0xBB38007C, 0xC9D35FAF, 0x1BCA9E73, 0x2C05E009, 0xFE1C21D5,
+    0x8CF77E06, 0x5EEEBFDA, 0xF33819E1, 0x2121D83D, 0x53CA87EE, 0x81D34632, 0xB61C3848,
+    0x6405F994, 0x16EEA647, 0xC4F7679B, 0x79705AB3, 0xAB699B6F, 0xD982C4BC, 0x0B9B0560,
+    0x3C547B1A, 0xEE4DBAC6, 0x9CA6E515, 0x4EBF24C9
+  },
+  {
+    0x00000000, 0x01D8AC87, 0x03B1590E, 0x0269F589, 0x0762B21C, 0x06BA1E9B, 0x04D3EB12,
+    0x050B4795, 0x0EC56438, 0x0F1DC8BF, 0x0D743D36, 0x0CAC91B1, 0x09A7D624, 0x087F7AA3,
+    0x0A168F2A, 0x0BCE23AD, 0x1D8AC870, 0x1C5264F7, 0x1E3B917E, 0x1FE33DF9, 0x1AE87A6C,
+    0x1B30D6EB, 0x19592362, 0x18818FE5, 0x134FAC48, 0x129700CF, 0x10FEF546, 0x112659C1,
+    0x142D1E54, 0x15F5B2D3, 0x179C475A, 0x1644EBDD, 0x3B1590E0, 0x3ACD3C67, 0x38A4C9EE,
+    0x397C6569, 0x3C7722FC, 0x3DAF8E7B, 0x3FC67BF2, 0x3E1ED775, 0x35D0F4D8, 0x3408585F,
+    0x3661ADD6, 0x37B90151, 0x32B246C4, 0x336AEA43, 0x31031FCA, 0x30DBB34D, 0x269F5890,
+    0x2747F417, 0x252E019E, 0x24F6AD19, 0x21FDEA8C, 0x2025460B, 0x224CB382, 0x23941F05,
+    0x285A3CA8, 0x2982902F, 0x2BEB65A6, 0x2A33C921, 0x2F388EB4, 0x2EE02233, 0x2C89D7BA,
+    0x2D517B3D, 0x762B21C0, 0x77F38D47, 0x759A78CE, 0x7442D449, 0x714993DC, 0x70913F5B,
+    0x72F8CAD2, 0x73206655, 0x78EE45F8, 0x7936E97F, 0x7B5F1CF6, 0x7A87B071, 0x7F8CF7E4,
+    0x7E545B63, 0x7C3DAEEA, 0x7DE5026D, 0x6BA1E9B0, 0x6A794537, 0x6810B0BE, 0x69C81C39,
+    0x6CC35BAC, 0x6D1BF72B, 0x6F7202A2, 0x6EAAAE25, 0x65648D88, 0x64BC210F, 0x66D5D486,
+    0x670D7801, 0x62063F94, 0x63DE9313, 0x61B7669A, 0x606FCA1D, 0x4D3EB120, 0x4CE61DA7,
+    0x4E8FE82E, 0x4F5744A9, 0x4A5C033C, 0x4B84AFBB, 0x49ED5A32, 0x4835F6B5, 0x43FBD518,
+    0x4223799F, 0x404A8C16, 0x41922091, 0x44996704, 0x4541CB83, 0x47283E0A, 0x46F0928D,
+    0x50B47950, 0x516CD5D7, 0x5305205E, 0x52DD8CD9, 0x57D6CB4C, 0x560E67CB, 0x54679242,
+    0x55BF3EC5, 0x5E711D68, 0x5FA9B1EF, 0x5DC04466, 0x5C18E8E1, 0x5913AF74, 0x58CB03F3,
+    0x5AA2F67A, 0x5B7A5AFD, 0xEC564380, 0xED8EEF07, 0xEFE71A8E, 0xEE3FB609, 0xEB34F19C,
+    0xEAEC5D1B, 0xE885A892, 0xE95D0415, 0xE29327B8, 0xE34B8B3F, 0xE1227EB6, 0xE0FAD231,
+    0xE5F195A4, 0xE4293923, 0xE640CCAA, 0xE798602D, 0xF1DC8BF0, 0xF0042777, 0xF26DD2FE,
+    0xF3B57E79, 0xF6BE39EC, 0xF766956B, 0xF50F60E2, 0xF4D7CC65, 0xFF19EFC8, 0xFEC1434F,
+    0xFCA8B6C6, 0xFD701A41, 0xF87B5DD4, 0xF9A3F153, 0xFBCA04DA, 0xFA12A85D, 0xD743D360,
+    0xD69B7FE7, 0xD4F28A6E, 0xD52A26E9, 0xD021617C, 0xD1F9CDFB, 0xD3903872, 0xD24894F5,
+    0xD986B758, 0xD85E1BDF, 0xDA37EE56, 0xDBEF42D1, 0xDEE40544, 0xDF3CA9C3, 0xDD555C4A,
+    0xDC8DF0CD, 0xCAC91B10, 0xCB11B797, 0xC978421E, 0xC8A0EE99, 0xCDABA90C, 0xCC73058B,
+    0xCE1AF002, 0xCFC25C85, 0xC40C7F28, 0xC5D4D3AF, 0xC7BD2626, 0xC6658AA1, 0xC36ECD34,
+    0xC2B661B3, 0xC0DF943A, 0xC10738BD, 0x9A7D6240, 0x9BA5CEC7, 0x99CC3B4E, 0x981497C9,
+    0x9D1FD05C, 0x9CC77CDB, 0x9EAE8952, 0x9F7625D5, 0x94B80678, 0x9560AAFF, 0x97095F76,
+    0x96D1F3F1, 0x93DAB464, 0x920218E3, 0x906BED6A, 0x91B341ED, 0x87F7AA30, 0x862F06B7,
+    0x8446F33E, 0x859E5FB9, 0x8095182C, 0x814DB4AB, 0x83244122, 0x82FCEDA5, 0x8932CE08,
+    0x88EA628F, 0x8A839706, 0x8B5B3B81, 0x8E507C14, 0x8F88D093, 0x8DE1251A, 0x8C39899D,
+    0xA168F2A0, 0xA0B05E27, 0xA2D9ABAE, 0xA3010729, 0xA60A40BC, 0xA7D2EC3B, 0xA5BB19B2,
+    0xA463B535, 0xAFAD9698, 0xAE753A1F, 0xAC1CCF96, 0xADC46311, 0xA8CF2484, 0xA9178803,
+    0xAB7E7D8A, 0xAAA6D10D, 0xBCE23AD0, 0xBD3A9657, 0xBF5363DE, 0xBE8BCF59, 0xBB8088CC,
+    0xBA58244B, 0xB831D1C2, 0xB9E97D45, 0xB2275EE8, 0xB3FFF26F, 0xB19607E6, 0xB04EAB61,
+    0xB545ECF4, 0xB49D4073, 0xB6F4B5FA, 0xB72C197D
+  },
+  {
+    0x00000000, 0xDC6D9AB7, 0xBC1A28D9, 0x6077B26E, 0x7CF54C05, 0xA098D6B2, 0xC0EF64DC,
+    0x1C82FE6B, 0xF9EA980A, 0x258702BD, 0x45F0B0D3, 0x999D2A64, 0x851FD40F, 0x59724EB8,
+    0x3905FCD6, 0xE5686661, 0xF7142DA3, 0x2B79B714, 0x4B0E057A, 0x97639FCD, 0x8BE161A6,
+    0x578CFB11, 0x37FB497F, 0xEB96D3C8, 0x0EFEB5A9, 0xD2932F1E, 0xB2E49D70, 0x6E8907C7,
+    0x720BF9AC, 0xAE66631B, 0xCE11D175, 0x127C4BC2, 0xEAE946F1, 0x3684DC46, 0x56F36E28,
+    0x8A9EF49F, 0x961C0AF4, 0x4A719043, 0x2A06222D, 0xF66BB89A, 0x1303DEFB, 0xCF6E444C,
+    0xAF19F622, 0x73746C95, 0x6FF692FE, 0xB39B0849, 0xD3ECBA27, 0x0F812090, 0x1DFD6B52,
+    0xC190F1E5, 0xA1E7438B, 0x7D8AD93C, 0x61082757, 0xBD65BDE0, 0xDD120F8E, 0x017F9539,
+    0xE417F358, 0x387A69EF, 0x580DDB81, 0x84604136, 0x98E2BF5D, 0x448F25EA, 0x24F89784,
+    0xF8950D33, 0xD1139055, 0x0D7E0AE2, 0x6D09B88C, 0xB164223B, 0xADE6DC50, 0x718B46E7,
+    0x11FCF489, 0xCD916E3E, 0x28F9085F, 0xF49492E8, 0x94E32086, 0x488EBA31, 0x540C445A,
+    0x8861DEED, 0xE8166C83, 0x347BF634, 0x2607BDF6, 0xFA6A2741, 0x9A1D952F, 0x46700F98,
+    0x5AF2F1F3, 0x869F6B44, 0xE6E8D92A, 0x3A85439D, 0xDFED25FC, 0x0380BF4B, 0x63F70D25,
+    0xBF9A9792, 0xA31869F9, 0x7F75F34E, 0x1F024120, 0xC36FDB97, 0x3BFAD6A4, 0xE7974C13,
+    0x87E0FE7D, 0x5B8D64CA, 0x470F9AA1, 0x9B620016, 0xFB15B278, 0x277828CF, 0xC2104EAE,
+    0x1E7DD419, 0x7E0A6677, 0xA267FCC0, 0xBEE502AB, 0x6288981C, 0x02FF2A72, 0xDE92B0C5,
+    0xCCEEFB07, 0x108361B0, 0x70F4D3DE, 0xAC994969, 0xB01BB702, 0x6C762DB5, 0x0C019FDB,
+    0xD06C056C, 0x3504630D, 0xE969F9BA, 0x891E4BD4, 0x5573D163, 0x49F12F08, 0x959CB5BF,
+    0xF5EB07D1, 0x29869D66, 0xA6E63D1D, 0x7A8BA7AA, 0x1AFC15C4, 0xC6918F73, 0xDA137118,
+    0x067EEBAF, 0x660959C1, 0xBA64C376, 0x5F0CA517, 0x83613FA0, 0xE3168DCE, 0x3F7B1779,
+    0x23F9E912, 0xFF9473A5, 0x9FE3C1CB, 0x438E5B7C, 0x51F210BE, 0x8D9F8A09, 0xEDE83867,
+    0x3185A2D0, 0x2D075CBB, 0xF16AC60C, 0x911D7462, 0x4D70EED5, 0xA81888B4, 0x74751203,
+    0x1402A06D, 0xC86F3ADA, 0xD4EDC4B1, 0x08805E06, 0x68F7EC68, 0xB49A76DF, 0x4C0F7BEC,
+    0x9062E15B, 0xF0155335, 0x2C78C982, 0x30FA37E9, 0xEC97AD5E, 0x8CE01F30, 0x508D8587,
+    0xB5E5E3E6, 0x69887951, 0x09FFCB3F, 0xD5925188, 0xC910AFE3, 0x157D3554, 0x750A873A,
+    0xA9671D8D, 0xBB1B564F, 0x6776CCF8, 0x07017E96, 0xDB6CE421, 0xC7EE1A4A, 0x1B8380FD,
+    0x7BF43293, 0xA799A824, 0x42F1CE45, 0x9E9C54F2, 0xFEEBE69C, 0x22867C2B, 0x3E048240,
+    0xE26918F7, 0x821EAA99, 0x5E73302E, 0x77F5AD48, 0xAB9837FF, 0xCBEF8591, 0x17821F26,
+    0x0B00E14D, 0xD76D7BFA, 0xB71AC994, 0x6B775323, 0x8E1F3542, 0x5272AFF5, 0x32051D9B,
+    0xEE68872C, 0xF2EA7947, 0x2E87E3F0, 0x4EF0519E, 0x929DCB29, 0x80E180EB, 0x5C8C1A5C,
+    0x3CFBA832, 0xE0963285, 0xFC14CCEE, 0x20795659, 0x400EE437, 0x9C637E80, 0x790B18E1,
+    0xA5668256, 0xC5113038, 0x197CAA8F, 0x05FE54E4, 0xD993CE53, 0xB9E47C3D, 0x6589E68A,
+    0x9D1CEBB9, 0x4171710E, 0x2106C360, 0xFD6B59D7, 0xE1E9A7BC, 0x3D843D0B, 0x5DF38F65,
+    0x819E15D2, 0x64F673B3, 0xB89BE904, 0xD8EC5B6A, 0x0481C1DD, 0x18033FB6, 0xC46EA501,
+    0xA419176F, 0x78748DD8, 0x6A08C61A, 0xB6655CAD, 0xD612EEC3, 0x0A7F7474, 0x16FD8A1F,
+    0xCA9010A8, 0xAAE7A2C6, 0x768A3871, 0x93E25E10, 0x4F8FC4A7, 0x2FF876C9, 0xF395EC7E,
+    0xEF171215, 0x337A88A2, 0x530D3ACC, 0x8F60A07B
+  },
+  {
+    0x00000000, 0x490D678D, 0x921ACF1A, 0xDB17A897, 0x20F48383, 0x69F9E40E, 0xB2EE4C99,
+    0xFBE32B14, 0x41E90706, 0x08E4608B, 0xD3F3C81C, 0x9AFEAF91, 0x611D8485, 0x2810E308,
+    0xF3074B9F, 0xBA0A2C12, 0x83D20E0C, 0xCADF6981, 0x11C8C116, 0x58C5A69B, 0xA3268D8F,
+    0xEA2BEA02, 0x313C4295, 0x78312518, 0xC23B090A, 0x8B366E87, 0x5021C610, 0x192CA19D,
+    0xE2CF8A89, 0xABC2ED04, 0x70D54593, 0x39D8221E, 0x036501AF, 0x4A686622, 0x917FCEB5,
+    0xD872A938, 0x2391822C, 0x6A9CE5A1, 0xB18B4D36, 0xF8862ABB, 0x428C06A9, 0x0B816124,
+    0xD096C9B3, 0x999BAE3E, 0x6278852A, 0x2B75E2A7, 0xF0624A30, 0xB96F2DBD, 0x80B70FA3,
+    0xC9BA682E, 0x12ADC0B9, 0x5BA0A734, 0xA0438C20, 0xE94EEBAD, 0x3259433A, 0x7B5424B7,
+    0xC15E08A5, 0x88536F28, 0x5344C7BF, 0x1A49A032, 0xE1AA8B26, 0xA8A7ECAB, 0x73B0443C,
+    0x3ABD23B1, 0x06CA035E, 0x4FC764D3, 0x94D0CC44, 0xDDDDABC9, 0x263E80DD, 0x6F33E750,
+    0xB4244FC7, 0xFD29284A, 0x47230458, 0x0E2E63D5, 0xD539CB42, 0x9C34ACCF, 0x67D787DB,
+    0x2EDAE056, 0xF5CD48C1, 0xBCC02F4C, 0x85180D52, 0xCC156ADF, 0x1702C248, 0x5E0FA5C5,
+    0xA5EC8ED1, 0xECE1E95C, 0x37F641CB, 0x7EFB2646, 0xC4F10A54, 0x8DFC6DD9, 0x56EBC54E,
+    0x1FE6A2C3, 0xE40589D7, 0xAD08EE5A, 0x761F46CD, 0x3F122140, 0x05AF02F1, 0x4CA2657C,
+    0x97B5CDEB, 0xDEB8AA66, 0x255B8172, 0x6C56E6FF, 0xB7414E68, 0xFE4C29E5, 0x444605F7,
+    0x0D4B627A, 0xD65CCAED, 0x9F51AD60, 0x64B28674, 0x2DBFE1F9, 0xF6A8496E, 0xBFA52EE3,
+    0x867D0CFD, 0xCF706B70, 0x1467C3E7, 0x5D6AA46A, 0xA6898F7E, 0xEF84E8F3, 0x34934064,
+    0x7D9E27E9, 0xC7940BFB, 0x8E996C76, 0x558EC4E1, 0x1C83A36C, 0xE7608878, 0xAE6DEFF5,
+    0x757A4762, 0x3C7720EF, 0x0D9406BC, 0x44996131, 0x9F8EC9A6, 0xD683AE2B, 0x2D60853F,
+    0x646DE2B2, 0xBF7A4A25, 0xF6772DA8, 0x4C7D01BA, 0x05706637, 0xDE67CEA0, 0x976AA92D,
+    0x6C898239, 0x2584E5B4, 0xFE934D23, 0xB79E2AAE, 0x8E4608B0, 0xC74B6F3D, 0x1C5CC7AA,
+    0x5551A027, 0xAEB28B33, 0xE7BFECBE, 0x3CA84429, 0x75A523A4, 0xCFAF0FB6, 0x86A2683B,
+    0x5DB5C0AC, 0x14B8A721, 0xEF5B8C35, 0xA656EBB8, 0x7D41432F, 0x344C24A2, 0x0EF10713,
+    0x47FC609E, 0x9CEBC809, 0xD5E6AF84, 0x2E058490, 0x6708E31D, 0xBC1F4B8A, 0xF5122C07,
+    0x4F180015, 0x06156798, 0xDD02CF0F, 0x940FA882, 0x6FEC8396, 0x26E1E41B, 0xFDF64C8C,
+    0xB4FB2B01, 0x8D23091F, 0xC42E6E92, 0x1F39C605, 0x5634A188, 0xADD78A9C, 0xE4DAED11,
+    0x3FCD4586, 0x76C0220B, 0xCCCA0E19, 0x85C76994, 0x5ED0C103, 0x17DDA68E, 0xEC3E8D9A,
+    0xA533EA17, 0x7E244280, 0x3729250D, 0x0B5E05E2, 0x4253626F, 0x9944CAF8, 0xD049AD75,
+    0x2BAA8661, 0x62A7E1EC, 0xB9B0497B, 0xF0BD2EF6, 0x4AB702E4, 0x03BA6569, 0xD8ADCDFE,
+    0x91A0AA73, 0x6A438167, 0x234EE6EA, 0xF8594E7D, 0xB15429F0, 0x888C0BEE, 0xC1816C63,
+    0x1A96C4F4, 0x539BA379, 0xA878886D, 0xE175EFE0, 0x3A624777, 0x736F20FA, 0xC9650CE8,
+    0x80686B65, 0x5B7FC3F2, 0x1272A47F, 0xE9918F6B, 0xA09CE8E6, 0x7B8B4071, 0x328627FC,
+    0x083B044D, 0x413663C0, 0x9A21CB57, 0xD32CACDA, 0x28CF87CE, 0x61C2E043, 0xBAD548D4,
+    0xF3D82F59, 0x49D2034B, 0x00DF64C6, 0xDBC8CC51, 0x92C5ABDC, 0x692680C8, 0x202BE745,
+    0xFB3C4FD2, 0xB231285F, 0x8BE90A41, 0xC2E46DCC, 0x19F3C55B, 0x50FEA2D6, 0xAB1D89C2,
+    0xE210EE4F, 0x390746D8, 0x700A2155, 0xCA000D47, 0x830D6ACA, 0x581AC25D, 0x1117A5D0,
+    0xEAF48EC4, 0xA3F9E949, 0x78EE41DE, 0x31E32653
+  },
+  {
+    0x00000000, 0x1B280D78, 0x36501AF0, 0x2D781788, 0x6CA035E0, 0x77883898, 0x5AF02F10,
+    0x41D82268, 0xD9406BC0, 0xC26866B8, 0xEF107130, 0xF4387C48, 0xB5E05E20, 0xAEC85358,
+    0x83B044D0, 0x989849A8, 0xB641CA37, 0xAD69C74F, 0x8011D0C7, 0x9B39DDBF, 0xDAE1FFD7,
+    0xC1C9F2AF, 0xECB1E527, 0xF799E85F, 0x6F01A1F7, 0x7429AC8F, 0x5951BB07, 0x4279B67F,
+    0x03A19417, 0x1889996F, 0x35F18EE7, 0x2ED9839F, 0x684289D9, 0x736A84A1, 0x5E129329,
+    0x453A9E51, 0x04E2BC39, 0x1FCAB141, 0x32B2A6C9, 0x299AABB1, 0xB102E219, 0xAA2AEF61,
+    0x8752F8E9, 0x9C7AF591, 0xDDA2D7F9, 0xC68ADA81, 0xEBF2CD09, 0xF0DAC071, 0xDE0343EE,
+    0xC52B4E96, 0xE853591E, 0xF37B5466, 0xB2A3760E, 0xA98B7B76, 0x84F36CFE, 0x9FDB6186,
+    0x0743282E, 0x1C6B2556, 0x311332DE, 0x2A3B3FA6, 0x6BE31DCE, 0x70CB10B6, 0x5DB3073E,
+    0x469B0A46, 0xD08513B2, 0xCBAD1ECA, 0xE6D50942, 0xFDFD043A, 0xBC252652, 0xA70D2B2A,
+    0x8A753CA2, 0x915D31DA, 0x09C57872, 0x12ED750A, 0x3F956282, 0x24BD6FFA, 0x65654D92,
+    0x7E4D40EA, 0x53355762, 0x481D5A1A, 0x66C4D985, 0x7DECD4FD, 0x5094C375, 0x4BBCCE0D,
+    0x0A64EC65, 0x114CE11D, 0x3C34F695, 0x271CFBED, 0xBF84B245, 0xA4ACBF3D, 0x89D4A8B5,
+    0x92FCA5CD, 0xD32487A5, 0xC80C8ADD, 0xE5749D55, 0xFE5C902D, 0xB8C79A6B, 0xA3EF9713,
+    0x8E97809B, 0x95BF8DE3, 0xD467AF8B, 0xCF4FA2F3, 0xE237B57B, 0xF91FB803, 0x6187F1AB,
+    0x7AAFFCD3, 0x57D7EB5B, 0x4CFFE623, 0x0D27C44B, 0x160FC933, 0x3B77DEBB, 0x205FD3C3,
+    0x0E86505C, 0x15AE5D24, 0x38D64AAC, 0x23FE47D4, 0x622665BC, 0x790E68C4, 0x54767F4C,
+    0x4F5E7234, 0xD7C63B9C, 0xCCEE36E4, 0xE196216C, 0xFABE2C14, 0xBB660E7C, 0xA04E0304,
+    0x8D36148C, 0x961E19F4, 0xA5CB3AD3, 0xBEE337AB, 0x939B2023, 0x88B32D5B, 0xC96B0F33,
+    0xD243024B, 0xFF3B15C3, 0xE41318BB, 0x7C8B5113, 0x67A35C6B, 0x4ADB4BE3, 0x51F3469B,
+    0x102B64F3, 0x0B03698B, 0x267B7E03, 0x3D53737B, 0x138AF0E4, 0x08A2FD9C, 0x25DAEA14,
+    0x3EF2E76C, 0x7F2AC504, 0x6402C87C, 0x497ADFF4, 0x5252D28C, 0xCACA9B24, 0xD1E2965C,
+    0xFC9A81D4, 0xE7B28CAC, 0xA66AAEC4, 0xBD42A3BC, 0x903AB434, 0x8B12B94C, 0xCD89B30A,
+    0xD6A1BE72, 0xFBD9A9FA, 0xE0F1A482, 0xA12986EA, 0xBA018B92, 0x97799C1A, 0x8C519162,
+    0x14C9D8CA, 0x0FE1D5B2, 0x2299C23A, 0x39B1CF42, 0x7869ED2A, 0x6341E052, 0x4E39F7DA,
+    0x5511FAA2, 0x7BC8793D, 0x60E07445, 0x4D9863CD, 0x56B06EB5, 0x17684CDD, 0x0C4041A5,
+    0x2138562D, 0x3A105B55, 0xA28812FD, 0xB9A01F85, 0x94D8080D, 0x8FF00575, 0xCE28271D,
+    0xD5002A65, 0xF8783DED, 0xE3503095, 0x754E2961, 0x6E662419, 0x431E3391, 0x58363EE9,
+    0x19EE1C81, 0x02C611F9, 0x2FBE0671, 0x34960B09, 0xAC0E42A1, 0xB7264FD9, 0x9A5E5851,
+    0x81765529, 0xC0AE7741, 0xDB867A39, 0xF6FE6DB1, 0xEDD660C9, 0xC30FE356, 0xD827EE2E,
+    0xF55FF9A6, 0xEE77F4DE, 0xAFAFD6B6, 0xB487DBCE, 0x99FFCC46, 0x82D7C13E, 0x1A4F8896,
+    0x016785EE, 0x2C1F9266, 0x37379F1E, 0x76EFBD76, 0x6DC7B00E, 0x40BFA786, 0x5B97AAFE,
+    0x1D0CA0B8, 0x0624ADC0, 0x2B5CBA48, 0x3074B730, 0x71AC9558, 0x6A849820, 0x47FC8FA8,
+    0x5CD482D0, 0xC44CCB78, 0xDF64C600, 0xF21CD188, 0xE934DCF0, 0xA8ECFE98, 0xB3C4F3E0,
+    0x9EBCE468, 0x8594E910, 0xAB4D6A8F, 0xB06567F7, 0x9D1D707F, 0x86357D07, 0xC7ED5F6F,
+    0xDCC55217, 0xF1BD459F, 0xEA9548E7, 0x720D014F, 0x69250C37, 0x445D1BBF, 0x5F7516C7,
+    0x1EAD34AF, 0x058539D7, 0x28FD2E5F, 0x33D52327
+  },
+  {
+    0x00000000, 0x4F576811, 0x9EAED022, 0xD1F9B833, 0x399CBDF3, 0x76CBD5E2, 0xA7326DD1,
+    0xE86505C0, 0x73397BE6, 0x3C6E13F7, 0xED97ABC4, 0xA2C0C3D5, 0x4AA5C615, 0x05F2AE04,
+    0xD40B1637, 0x9B5C7E26, 0xE672F7CC, 0xA9259FDD, 0x78DC27EE, 0x378B4FFF, 0xDFEE4A3F,
+    0x90B9222E, 0x41409A1D, 0x0E17F20C, 0x954B8C2A, 0xDA1CE43B, 0x0BE55C08, 0x44B23419,
+    0xACD731D9, 0xE38059C8, 0x3279E1FB, 0x7D2E89EA, 0xC824F22F, 0x87739A3E, 0x568A220D,
+    0x19DD4A1C, 0xF1B84FDC, 0xBEEF27CD, 0x6F169FFE, 0x2041F7EF, 0xBB1D89C9, 0xF44AE1D8,
+    0x25B359EB, 0x6AE431FA, 0x8281343A, 0xCDD65C2B, 0x1C2FE418, 0x53788C09, 0x2E5605E3,
+    0x61016DF2, 0xB0F8D5C1, 0xFFAFBDD0, 0x17CAB810, 0x589DD001, 0x89646832, 0xC6330023,
+    0x5D6F7E05, 0x12381614, 0xC3C1AE27, 0x8C96C636, 0x64F3C3F6, 0x2BA4ABE7, 0xFA5D13D4,
+    0xB50A7BC5, 0x9488F9E9, 0xDBDF91F8, 0x0A2629CB, 0x457141DA, 0xAD14441A, 0xE2432C0B,
+    0x33BA9438, 0x7CEDFC29, 0xE7B1820F, 0xA8E6EA1E, 0x791F522D, 0x36483A3C, 0xDE2D3FFC,
+    0x917A57ED, 0x4083EFDE, 0x0FD487CF, 0x72FA0E25, 0x3DAD6634, 0xEC54DE07, 0xA303B616,
+    0x4B66B3D6, 0x0431DBC7, 0xD5C863F4, 0x9A9F0BE5, 0x01C375C3, 0x4E941DD2, 0x9F6DA5E1,
+    0xD03ACDF0, 0x385FC830, 0x7708A021, 0xA6F11812, 0xE9A67003, 0x5CAC0BC6, 0x13FB63D7,
+    0xC202DBE4, 0x8D55B3F5, 0x6530B635, 0x2A67DE24, 0xFB9E6617, 0xB4C90E06, 0x2F957020,
+    0x60C21831, 0xB13BA002, 0xFE6CC813, 0x1609CDD3, 0x595EA5C2, 0x88A71DF1, 0xC7F075E0,
+    0xBADEFC0A, 0xF589941B, 0x24702C28, 0x6B274439, 0x834241F9, 0xCC1529E8, 0x1DEC91DB,
+    0x52BBF9CA, 0xC9E787EC, 0x86B0EFFD, 0x574957CE, 0x181E3FDF, 0xF07B3A1F, 0xBF2C520E,
+    0x6ED5EA3D, 0x2182822C, 0x2DD0EE65, 0x62878674, 0xB37E3E47, 0xFC295656, 0x144C5396,
+    0x5B1B3B87, 0x8AE283B4, 0xC5B5EBA5, 0x5EE99583, 0x11BEFD92, 0xC04745A1, 0x8F102DB0,
+    0x67752870, 0x28224061, 0xF9DBF852, 0xB68C9043, 0xCBA219A9, 0x84F571B8, 0x550CC98B,
+    0x1A5BA19A, 0xF23EA45A, 0xBD69CC4B, 0x6C907478, 0x23C71C69, 0xB89B624F, 0xF7CC0A5E,
+    0x2635B26D, 0x6962DA7C, 0x8107DFBC, 0xCE50B7AD, 0x1FA90F9E, 0x50FE678F, 0xE5F41C4A,
+    0xAAA3745B, 0x7B5ACC68, 0x340DA479, 0xDC68A1B9, 0x933FC9A8, 0x42C6719B, 0x0D91198A,
+    0x96CD67AC, 0xD99A0FBD, 0x0863B78E, 0x4734DF9F, 0xAF51DA5F, 0xE006B24E, 0x31FF0A7D,
+    0x7EA8626C, 0x0386EB86, 0x4CD18397, 0x9D283BA4, 0xD27F53B5, 0x3A1A5675, 0x754D3E64,
+    0xA4B48657, 0xEBE3EE46, 0x70BF9060, 0x3FE8F871, 0xEE114042, 0xA1462853, 0x49232D93,
+    0x06744582, 0xD78DFDB1, 0x98DA95A0, 0xB958178C, 0xF60F7F9D, 0x27F6C7AE, 0x68A1AFBF,
+    0x80C4AA7F, 0xCF93C26E, 0x1E6A7A5D, 0x513D124C, 0xCA616C6A, 0x8536047B, 0x54CFBC48,
+    0x1B98D459, 0xF3FDD199, 0xBCAAB988, 0x6D5301BB, 0x220469AA, 0x5F2AE040, 0x107D8851,
+    0xC1843062, 0x8ED35873, 0x66B65DB3, 0x29E135A2, 0xF8188D91, 0xB74FE580, 0x2C139BA6,
+    0x6344F3B7, 0xB2BD4B84, 0xFDEA2395, 0x158F2655, 0x5AD84E44, 0x8B21F677, 0xC4769E66,
+    0x717CE5A3, 0x3E2B8DB2, 0xEFD23581, 0xA0855D90, 0x48E05850, 0x07B73041, 0xD64E8872,
+    0x9919E063, 0x02459E45, 0x4D12F654, 0x9CEB4E67, 0xD3BC2676, 0x3BD923B6, 0x748E4BA7,
+    0xA577F394, 0xEA209B85, 0x970E126F, 0xD8597A7E, 0x09A0C24D, 0x46F7AA5C, 0xAE92AF9C,
+    0xE1C5C78D, 0x303C7FBE, 0x7F6B17AF, 0xE4376989, 0xAB600198, 0x7A99B9AB, 0x35CED1BA,
+    0xDDABD47A, 0x92FCBC6B, 0x43050458, 0x0C526C49
+  },
+  {
+    0x00000000, 0x5BA1DCCA, 0xB743B994, 0xECE2655E, 0x6A466E9F, 0x31E7B255, 0xDD05D70B,
+    0x86A40BC1, 0xD48CDD3E, 0x8F2D01F4, 0x63CF64AA, 0x386EB860, 0xBECAB3A1, 0xE56B6F6B,
+    0x09890A35, 0x5228D6FF, 0xADD8A7CB, 0xF6797B01, 0x1A9B1E5F, 0x413AC295, 0xC79EC954,
+    0x9C3F159E, 0x70DD70C0, 0x2B7CAC0A, 0x79547AF5, 0x22F5A63F, 0xCE17C361, 0x95B61FAB,
+    0x1312146A, 0x48B3C8A0, 0xA451ADFE, 0xFFF07134, 0x5F705221, 0x04D18EEB, 0xE833EBB5,
+    0xB392377F, 0x35363CBE, 0x6E97E074, 0x8275852A, 0xD9D459E0, 0x8BFC8F1F, 0xD05D53D5,
+    0x3CBF368B, 0x671EEA41, 0xE1BAE180, 0xBA1B3D4A, 0x56F95814, 0x0D5884DE, 0xF2A8F5EA,
+    0xA9092920, 0x45EB4C7E, 0x1E4A90B4, 0x98EE9B75, 0xC34F47BF, 0x2FAD22E1, 0x740CFE2B,
+    0x262428D4, 0x7D85F41E, 0x91679140, 0xCAC64D8A, 0x4C62464B, 0x17C39A81, 0xFB21FFDF,
+    0xA0802315, 0xBEE0A442, 0xE5417888, 0x09A31DD6, 0x5202C11C, 0xD4A6CADD, 0x8F071617,
+    0x63E57349, 0x3844AF83, 0x6A6C797C, 0x31CDA5B6, 0xDD2FC0E8, 0x868E1C22, 0x002A17E3,
+    0x5B8BCB29, 0xB769AE77, 0xECC872BD, 0x13380389, 0x4899DF43, 0xA47BBA1D, 0xFFDA66D7,
+    0x797E6D16, 0x22DFB1DC, 0xCE3DD482, 0x959C0848, 0xC7B4DEB7, 0x9C15027D, 0x70F76723,
+    0x2B56BBE9, 0xADF2B028, 0xF6536CE2, 0x1AB109BC, 0x4110D576, 0xE190F663, 0xBA312AA9,
+    0x56D34FF7, 0x0D72933D, 0x8BD698FC, 0xD0774436, 0x3C952168, 0x6734FDA2, 0x351C2B5D,
+    0x6EBDF797, 0x825F92C9, 0xD9FE4E03, 0x5F5A45C2, 0x04FB9908, 0xE819FC56, 0xB3B8209C,
+    0x4C4851A8, 0x17E98D62, 0xFB0BE83C, 0xA0AA34F6, 0x260E3F37, 0x7DAFE3FD, 0x914D86A3,
+    0xCAEC5A69, 0x98C48C96, 0xC365505C, 0x2F873502, 0x7426E9C8, 0xF282E209, 0xA9233EC3,
+    0x45C15B9D, 0x1E608757, 0x79005533, 0x22A189F9, 0xCE43ECA7, 0x95E2306D, 0x13463BAC,
+    0x48E7E766, 0xA4058238, 0xFFA45EF2, 0xAD8C880D, 0xF62D54C7, 0x1ACF3199, 0x416EED53,
+    0xC7CAE692, 0x9C6B3A58, 0x70895F06, 0x2B2883CC, 0xD4D8F2F8, 0x8F792E32, 0x639B4B6C,
+    0x383A97A6, 0xBE9E9C67, 0xE53F40AD, 0x09DD25F3, 0x527CF939, 0x00542FC6, 0x5BF5F30C,
+    0xB7179652, 0xECB64A98, 0x6A124159, 0x31B39D93, 0xDD51F8CD, 0x86F02407, 0x26700712,
+    0x7DD1DBD8, 0x9133BE86, 0xCA92624C, 0x4C36698D, 0x1797B547, 0xFB75D019, 0xA0D40CD3,
+    0xF2FCDA2C, 0xA95D06E6, 0x45BF63B8, 0x1E1EBF72, 0x98BAB4B3, 0xC31B6879, 0x2FF90D27,
+    0x7458D1ED, 0x8BA8A0D9, 0xD0097C13, 0x3CEB194D, 0x674AC587, 0xE1EECE46, 0xBA4F128C,
+    0x56AD77D2, 0x0D0CAB18, 0x5F247DE7, 0x0485A12D, 0xE867C473, 0xB3C618B9, 0x35621378,
+    0x6EC3CFB2, 0x8221AAEC, 0xD9807626, 0xC7E0F171, 0x9C412DBB, 0x70A348E5, 0x2B02942F,
+    0xADA69FEE, 0xF6074324, 0x1AE5267A, 0x4144FAB0, 0x136C2C4F, 0x48CDF085, 0xA42F95DB,
+    0xFF8E4911, 0x792A42D0, 0x228B9E1A, 0xCE69FB44, 0x95C8278E, 0x6A3856BA, 0x31998A70,
+    0xDD7BEF2E, 0x86DA33E4, 0x007E3825, 0x5BDFE4EF, 0xB73D81B1, 0xEC9C5D7B, 0xBEB48B84,
+    0xE515574E, 0x09F73210, 0x5256EEDA, 0xD4F2E51B, 0x8F5339D1, 0x63B15C8F, 0x38108045,
+    0x9890A350, 0xC3317F9A, 0x2FD31AC4, 0x7472C60E, 0xF2D6CDCF, 0xA9771105, 0x4595745B,
+    0x1E34A891, 0x4C1C7E6E, 0x17BDA2A4, 0xFB5FC7FA, 0xA0FE1B30, 0x265A10F1, 0x7DFBCC3B,
+    0x9119A965, 0xCAB875AF, 0x3548049B, 0x6EE9D851, 0x820BBD0F, 0xD9AA61C5, 0x5F0E6A04,
+    0x04AFB6CE, 0xE84DD390, 0xB3EC0F5A, 0xE1C4D9A5, 0xBA65056F, 0x56876031, 0x0D26BCFB,
+    0x8B82B73A, 0xD0236BF0, 0x3CC10EAE, 0x6760D264
+  }
+};
+
+#if defined(UTIL_CHECKSUM_CLMUL_ENABLE)
+/** \brief Folding constants for the 32-bit CRC with polynomial 0x04C11DB7. These are
+ *         x^512, x^576, x^128 and x^192 modulo the polynomial, for folding four blocks
+ *         and one block of 16 bytes at a time.
+ */
+static const uint32_t utilChecksumCrc32ClmulConstants[4] =
+{
+  0xE6228B11, 0x8833794C, 0xE8A45605, 0xC5B9CD4C
+};
+
+/** \brief Folding constants for the 16-bit CRC with polynomial 0x8005. The CRC16 of the
+ *         data equals the upper 16 bits of the 32-bit CRC with the polynomial multiplied
+ *         by x^16, so the same folding works with these constants modulo 0x180050000.
+ */
+static const uint32_t utilChecksumCrc16ClmulConstants[4] =
+{
+  0x807D0000, 0xF9E30000, 0xFF830000, 0xF9130000
+};
+#endif
+
+/** \brief Round constants of SHA-256. */
+static const uint32_t utilChecksumSha256K[64] =
+{
+  0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4,
+  0xAB1C5ED5, 0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE,
+  0x9BDC06A7, 0xC19BF174, 0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F,
+  0x4A7484AA, 0x5CB0A9DC, 0x76F988DA, 0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7,
+  0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967, 0x27B70A85, 0x2E1B2138, 0x4D2C6DFC,
+  0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85, 0xA2BFE8A1, 0xA81A664B,
+  0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070, 0x19A4C116,
+  0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+  0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7,
+  0xC67178F2
+};
+
+
+/****************************************************************************************
+* Local data declarations
+****************************************************************************************/
+#if defined(UTIL_CHECKSUM_CLMUL_ENABLE)
+/** \brief Cached result of the detection of the carry-less multiplication support. Zero
+ *         when not yet detected, 1 when supported and 2 when not supported. Threads that
+ *         detect it at the same time simply store the same value.
+ */
+static volatile uint8_t utilChecksumClmulSupport = 0;
+#endif
+
 
 /************************************************************************************//**
-** \brief     Calculates a 16-bit CRC value over the specified data using byte wise
-**            computation with a table.
+** \brief     Calculates a 16-bit CRC value over the specified data. It uses the fastest
+**            checksum kernel that the CPU supports.
 ** \param     data Array with bytes over which the CRC16 should be calculated.
 ** \param     len Number of bytes in the data array.
 ** \return    The 16-bit CRC value.
 **
 ****************************************************************************************/
 uint16_t UtilChecksumCrc16Calculate(uint8_t const * data, uint32_t len)
+{
+  return UtilChecksumCrc16CalculateKernel(data, len, UTIL_CHECKSUM_KERNEL_AUTO);
+} /*** end of UtilChecksumCrc16Calculate ***/
+
+
+/************************************************************************************//**
+** \brief     Calculates a 32-bit CRC value over the specified data. It uses the fastest
+**            checksum kernel that the CPU supports.
+** \param     data Array with bytes over which the CRC32 should be calculated.
+** \param     len Number of bytes in the data array.
+** \return    The 32-bit CRC value.
+**
+****************************************************************************************/
+uint32_t UtilChecksumCrc32Calculate(uint8_t const * data, uint32_t len)
+{
+  return UtilChecksumCrc32CalculateKernel(data, len, UTIL_CHECKSUM_KERNEL_AUTO);
+} /*** end of UtilChecksumCrc32Calculate ***/
+
+
+/************************************************************************************//**
+** \brief     Determines if the CPU supports the specified checksum kernel.
+** \param     kernel Checksum kernel (UTIL_CHECKSUM_KERNEL_xxx).
+** \return    True if the kernel can be used, false otherwise.
+**
+****************************************************************************************/
+bool UtilChecksumKernelSupported(uint8_t kernel)
+{
+  bool result = false;
+
+  switch (kernel)
+  {
+    case UTIL_CHECKSUM_KERNEL_AUTO:
+    case UTIL_CHECKSUM_KERNEL_BYTE:
+    case UTIL_CHECKSUM_KERNEL_SLICE8:
+      result = true;
+      break;
+#if defined(UTIL_CHECKSUM_CLMUL_ENABLE)
+    case UTIL_CHECKSUM_KERNEL_CLMUL:
+      result = UtilChecksumClmulDetect();
+      break;
+#endif
+    default:
+      break;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilChecksumKernelSupported ***/
+
+
+/************************************************************************************//**
+** \brief     Calculates a 16-bit CRC value over the specified data, with the specified
+**            checksum kernel. All kernels produce the same CRC value.
+** \param     data Array with bytes over which the CRC16 should be calculated.
+** \param     len Number of bytes in the data array.
+** \param     kernel Checksum kernel (UTIL_CHECKSUM_KERNEL_xxx). A kernel that the CPU
+**            does not support is replaced by the fastest one that it does support.
+** \return    The 16-bit CRC value.
+**
+****************************************************************************************/
+uint16_t UtilChecksumCrc16CalculateKernel(uint8_t const * data, uint32_t len,
+                                          uint8_t kernel)
 {
   uint16_t result = 0;
-  uint32_t byteIdx;
-  
+
   /* Verify parameters. */
   assert(data != NULL);
   assert(len > 0);
-  
+
   /* Only continue if parameters are valid. */
   if ( (data != NULL) && (len > 0) ) /*lint !e774 */
   {
-    /* Loop through all bytes. */
-    for (byteIdx = 0; byteIdx < len; byteIdx++)
-    {
-      result = ((uint16_t)(result << 8)) ^ 
-               utilChecksumCrc16Table[(uint8_t)(data[byteIdx] ^ (result >> 8))];
-    }
+    result = UtilChecksumCrc16Process(0, data, len, kernel);
   }
-  
+  /* Give the result back to the caller. */
   return result;
-} /*** end of UtilChecksumCrc16Calculate ***/
+} /*** end of UtilChecksumCrc16CalculateKernel ***/
 
 
 /************************************************************************************//**
-** \brief     Calculates a 32-bit CRC value over the specified data using byte wise
-**            computation with a table.
+** \brief     Continues a 16-bit CRC calculation over the specified data. This makes it
+**            possible to calculate the CRC over data that is not available all at once.
+**            The calculation starts with a CRC value of zero. The CRC value that is
+**            returned after the last part of the data is the CRC value of all data.
+** \param     crc The CRC value of the preceding data, or zero for the first part.
+** \param     data Array with bytes over which the CRC16 should be calculated.
+** \param     len Number of bytes in the data array. Can be zero.
+** \return    The 16-bit CRC value.
+**
+****************************************************************************************/
+uint16_t UtilChecksumCrc16Update(uint16_t crc, uint8_t const * data, uint32_t len)
+{
+  uint16_t result = crc;
+
+  /* Verify parameters. */
+  assert( (data != NULL) || (len == 0) );
+
+  /* Only continue if parameters are valid. */
+  if ( (data != NULL) && (len > 0) ) /*lint !e774 */
+  {
+    result = UtilChecksumCrc16Process(crc, data, len, UTIL_CHECKSUM_KERNEL_AUTO);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilChecksumCrc16Update ***/
+
+
+/************************************************************************************//**
+** \brief     Combines the 16-bit CRC values of two consecutive blocks of data into the
+**            CRC value of both blocks together. This makes it possible to calculate the
+**            CRC values of the blocks independently, for example in parallel.
+**            Because the CRC starts with zero and has no final XOR value, the CRC of A
+**            followed by B is CRC(A) * x^(8*len2) + CRC(B), modulo the polynomial.
+** \param     crc1 CRC value of the first block.
+** \param     crc2 CRC value of the second block.
+** \param     len2 Number of bytes in the second block.
+** \return    The 16-bit CRC value of the first block followed by the second block.
+**
+****************************************************************************************/
+uint16_t UtilChecksumCrc16Combine(uint16_t crc1, uint16_t crc2, uint32_t len2)
+{
+  uint32_t shifted;
+
+  shifted = UtilChecksumCrcShift((uint32_t)crc1 << 16, len2, 0x80050000u);
+  return (uint16_t)((shifted >> 16) ^ crc2);
+} /*** end of UtilChecksumCrc16Combine ***/
+
+
+/************************************************************************************//**
+** \brief     Continues a 16-bit CRC calculation over the specified data, with the
+**            specified checksum kernel.
+** \param     crc The CRC value of the preceding data.
+** \param     data Array with bytes over which the CRC16 should be calculated.
+** \param     len Number of bytes in the data array. Must be larger than zero.
+** \param     kernel Checksum kernel (UTIL_CHECKSUM_KERNEL_xxx). A kernel that the CPU
+**            does not support is replaced by the fastest one that it does support.
+** \return    The 16-bit CRC value.
+**
+****************************************************************************************/
+static uint16_t UtilChecksumCrc16Process(uint16_t crc, uint8_t const * data,
+                                        uint32_t len, uint8_t kernel)
+{
+  uint16_t result;
+#if defined(UTIL_CHECKSUM_CLMUL_ENABLE)
+  uint8_t folded[16];
+  uint32_t foldedLen;
+#endif
+
+  /* Select the fastest kernel if the requested one is not supported. */
+  if ( (kernel == UTIL_CHECKSUM_KERNEL_AUTO) ||
+       (!UtilChecksumKernelSupported(kernel)) )
+  {
+    kernel = UtilChecksumKernelSupported(UTIL_CHECKSUM_KERNEL_CLMUL) ?
+             UTIL_CHECKSUM_KERNEL_CLMUL : UTIL_CHECKSUM_KERNEL_SLICE8;
+  }
+  if (kernel == UTIL_CHECKSUM_KERNEL_BYTE)
+  {
+    result = UtilChecksumCrc16Byte(crc, data, len);
+  }
+#if defined(UTIL_CHECKSUM_CLMUL_ENABLE)
+  else if ( (kernel == UTIL_CHECKSUM_KERNEL_CLMUL) &&
+            (len >= UTIL_CHECKSUM_CLMUL_MIN_LEN) )
+  {
+    /* Fold the data into 16 bytes with the same CRC, then continue with the bytes that
+     * did not fill a complete block.
+     */
+    foldedLen = UtilChecksumClmulFold((uint32_t)crc << 16, data, len,
+                                      utilChecksumCrc16ClmulConstants, folded);
+    result = UtilChecksumCrc16Slice8(0, folded, sizeof(folded));
+    result = UtilChecksumCrc16Slice8(result, &data[foldedLen], len - foldedLen);
+  }
+#endif
+  else
+  {
+    result = UtilChecksumCrc16Slice8(crc, data, len);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilChecksumCrc16Process ***/
+
+
+/************************************************************************************//**
+** \brief     Calculates a 32-bit CRC value over the specified data, with the specified
+**            checksum kernel. All kernels produce the same CRC value.
 ** \param     data Array with bytes over which the CRC32 should be calculated.
 ** \param     len Number of bytes in the data array.
+** \param     kernel Checksum kernel (UTIL_CHECKSUM_KERNEL_xxx). A kernel that the CPU
+**            does not support is replaced by the fastest one that it does support.
 ** \return    The 32-bit CRC value.
 **
 ****************************************************************************************/
-uint32_t UtilChecksumCrc32Calculate(uint8_t const * data, uint32_t len)
+uint32_t UtilChecksumCrc32CalculateKernel(uint8_t const * data, uint32_t len,
+                                          uint8_t kernel)
 {
   uint32_t result = 0;
-  uint32_t byteIdx;
-  
+
   /* Verify parameters. */
   assert(data != NULL);
   assert(len > 0);
-  
+
   /* Only continue if parameters are valid. */
   if ( (data != NULL) && (len > 0) ) /*lint !e774 */
   {
-    /* Loop through all bytes. */
-    for (byteIdx = 0; byteIdx < len; byteIdx++)
+    result = UtilChecksumCrc32Process(0, data, len, kernel);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilChecksumCrc32CalculateKernel ***/
+
+
+/************************************************************************************//**
+** \brief     Continues a 32-bit CRC calculation over the specified data. This makes it
+**            possible to calculate the CRC over data that is not available all at once.
+**            The calculation starts with a CRC value of zero. The CRC value that is
+**            returned after the last part of the data is the CRC value of all data.
+** \param     crc The CRC value of the preceding data, or zero for the first part.
+** \param     data Array with bytes over which the CRC32 should be calculated.
+** \param     len Number of bytes in the data array. Can be zero.
+** \return    The 32-bit CRC value.
+**
+****************************************************************************************/
+uint32_t UtilChecksumCrc32Update(uint32_t crc, uint8_t const * data, uint32_t len)
+{
+  uint32_t result = crc;
+
+  /* Verify parameters. */
+  assert( (data != NULL) || (len == 0) );
+
+  /* Only continue if parameters are valid. */
+  if ( (data != NULL) && (len > 0) ) /*lint !e774 */
+  {
+    result = UtilChecksumCrc32Process(crc, data, len, UTIL_CHECKSUM_KERNEL_AUTO);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilChecksumCrc32Update ***/
+
+
+/************************************************************************************//**
+** \brief     Combines the 32-bit CRC values of two consecutive blocks of data into the
+**            CRC value of both blocks together. This makes it possible to calculate the
+**            CRC values of the blocks independently, for example in parallel.
+**            Because the CRC starts with zero and has no final XOR value, the CRC of A
+**            followed by B is CRC(A) * x^(8*len2) + CRC(B), modulo the polynomial.
+** \param     crc1 CRC value of the first block.
+** \param     crc2 CRC value of the second block.
+** \param     len2 Number of bytes in the second block.
+** \return    The 32-bit CRC value of the first block followed by the second block.
+**
+****************************************************************************************/
+uint32_t UtilChecksumCrc32Combine(uint32_t crc1, uint32_t crc2, uint32_t len2)
+{
+  uint32_t shifted;
+
+  shifted = UtilChecksumCrcShift(crc1, len2, 0x04C11DB7u);
+  return (uint32_t)(shifted ^ crc2);
+} /*** end of UtilChecksumCrc32Combine ***/
+
+
+/************************************************************************************//**
+** \brief     Continues a 32-bit CRC calculation over the specified data, with the
+**            specified checksum kernel.
+** \param     crc The CRC value of the preceding data.
+** \param     data Array with bytes over which the CRC32 should be calculated.
+** \param     len Number of bytes in the data array. Must be larger than zero.
+** \param     kernel Checksum kernel (UTIL_CHECKSUM_KERNEL_xxx). A kernel that the CPU
+**            does not support is replaced by the fastest one that it does support.
+** \return    The 32-bit CRC value.
+**
+****************************************************************************************/
+static uint32_t UtilChecksumCrc32Process(uint32_t crc, uint8_t const * data,
+                                        uint32_t len, uint8_t kernel)
+{
+  uint32_t result;
+#if defined(UTIL_CHECKSUM_CLMUL_ENABLE)
+  uint8_t folded[16];
+  uint32_t foldedLen;
+#endif
+
+  /* Select the fastest kernel if the requested one is not supported. */
+  if ( (kernel == UTIL_CHECKSUM_KERNEL_AUTO) ||
+       (!UtilChecksumKernelSupported(kernel)) )
+  {
+    kernel = UtilChecksumKernelSupported(UTIL_CHECKSUM_KERNEL_CLMUL) ?
+             UTIL_CHECKSUM_KERNEL_CLMUL : UTIL_CHECKSUM_KERNEL_SLICE8;
+  }
+  if (kernel == UTIL_CHECKSUM_KERNEL_BYTE)
+  {
+    result = UtilChecksumCrc32Byte(crc, data, len);
+  }
+#if defined(UTIL_CHECKSUM_CLMUL_ENABLE)
+  else if ( (kernel == UTIL_CHECKSUM_KERNEL_CLMUL) &&
+            (len >= UTIL_CHECKSUM_CLMUL_MIN_LEN) )
+  {
+    /* Fold the data into 16 bytes with the same CRC, then continue with the bytes that
+     * did not fill a complete block.
+     */
+    foldedLen = UtilChecksumClmulFold(crc, data, len,
+                                      utilChecksumCrc32ClmulConstants, folded);
+    result = UtilChecksumCrc32Slice8(0, folded, sizeof(folded));
+    result = UtilChecksumCrc32Slice8(result, &data[foldedLen], len - foldedLen);
+  }
+#endif
+  else
+  {
+    result = UtilChecksumCrc32Slice8(crc, data, len);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilChecksumCrc32Process ***/
+
+
+/************************************************************************************//**
+** \brief     Multiplies a CRC value by x^(8*len) modulo the polynomial, which is the
+**            CRC value after len zero bytes would be appended to its data. The power of
+**            x is built by repeated squaring, so this takes O(log(len)) steps. A 16-bit
+**            CRC is processed in the upper 16 bits, with its polynomial shifted
+**            accordingly, which gives the same result.
+** \param     crc The CRC value, in the upper bits of a 32-bit value.
+** \param     len Number of zero bytes.
+** \param     poly The CRC polynomial, without the x^32 term.
+** \return    The shifted CRC value.
+**
+****************************************************************************************/
+static uint32_t UtilChecksumCrcShift(uint32_t crc, uint32_t len, uint32_t poly)
+{
+  /* Start with x^8, the shift for one byte. */
+  uint32_t square = 0x00000100u;
+
+  while (len > 0)
+  {
+    if ((len & 1u) != 0)
     {
-      result = ((uint32_t)(result << 8)) ^ 
-               utilChecksumCrc32Table[(uint8_t)(data[byteIdx] ^ (result >> 24))];
+      crc = UtilChecksumCrcMultiply(crc, square, poly);
     }
+    square = UtilChecksumCrcMultiply(square, square, poly);
+    len >>= 1;
   }
-  
-  return result;
-} /*** end of UtilChecksumCrc32Calculate ***/
+  return crc;
+} /*** end of UtilChecksumCrcShift ***/
+
+
+/************************************************************************************//**
+** \brief     Multiplies two polynomials over GF(2) modulo the CRC polynomial. The most
+**            significant bit holds the coefficient of x^31.
+** \param     a The first polynomial.
+** \param     b The second polynomial.
+** \param     poly The CRC polynomial, without the x^32 term.
+** \return    The product modulo the CRC polynomial.
+**
+****************************************************************************************/
+static uint32_t UtilChecksumCrcMultiply(uint32_t a, uint32_t b, uint32_t poly)
+{
+  uint32_t product = 0;
+  uint8_t bitIdx;
+
+  /* Process the bits of b from high to low, multiplying by x in between. */
+  for (bitIdx = 32; bitIdx > 0; bitIdx--)
+  {
+    product = ((product & 0x80000000u) != 0) ? ((product << 1) ^ poly) : (product << 1);
+    if ((b & (1ul << (bitIdx - 1u))) != 0)
+    {
+      product ^= a;
+    }
+  }
+  return product;
+} /*** end of UtilChecksumCrcMultiply ***/
+
+
+/************************************************************************************//**
+** \brief     Continues a 16-bit CRC calculation over the specified data using byte wise
+**            computation with a table.
+** \param     crc The CRC value of the preceding data.
+** \param     data Array with bytes over which the CRC16 should be calculated.
+** \param     len Number of bytes in the data array. Can be zero.
+** \return    The 16-bit CRC value.
+**
+****************************************************************************************/
+static uint16_t UtilChecksumCrc16Byte(uint16_t crc, uint8_t const * data, uint32_t len)
+{
+  uint32_t byteIdx;
+
+  /* Loop through all bytes. */
+  for (byteIdx = 0; byteIdx < len; byteIdx++)
+  {
+    crc = ((uint16_t)(crc << 8)) ^
+          utilChecksumCrc16Table[(uint8_t)(data[byteIdx] ^ (crc >> 8))];
+  }
+  return crc;
+} /*** end of UtilChecksumCrc16Byte ***/
+
+
+/************************************************************************************//**
+** \brief     Continues a 32-bit CRC calculation over the specified data using byte wise
+**            computation with a table.
+** \param     crc The CRC value of the preceding data.
+** \param     data Array with bytes over which the CRC32 should be calculated.
+** \param     len Number of bytes in the data array. Can be zero.
+** \return    The 32-bit CRC value.
+**
+****************************************************************************************/
+static uint32_t UtilChecksumCrc32Byte(uint32_t crc, uint8_t const * data, uint32_t len)
+{
+  uint32_t byteIdx;
+
+  /* Loop through all bytes. */
+  for (byteIdx = 0; byteIdx < len; byteIdx++)
+  {
+    crc = ((uint32_t)(crc << 8)) ^
+          utilChecksumCrc32Table[(uint8_t)(data[byteIdx] ^ (crc >> 24))];
+  }
+  return crc;
+} /*** end of UtilChecksumCrc32Byte ***/
+
+
+/************************************************************************************//**
+** \brief     Continues a 16-bit CRC calculation over the specified data, eight bytes at
+**            a time. The CRC is combined with the first two bytes, after which each of
+**            the eight bytes has its own table lookup. These lookups do not depend on
+**            each other, so the CPU performs them in parallel. The remaining bytes are
+**            processed one at a time.
+** \param     crc The CRC value of the preceding data.
+** \param     data Array with bytes over which the CRC16 should be calculated.
+** \param     len Number of bytes in the data array. Can be zero.
+** \return    The 16-bit CRC value.
+**
+****************************************************************************************/
+static uint16_t UtilChecksumCrc16Slice8(uint16_t crc, uint8_t const * data, uint32_t len)
+{
+  for (; len >= 8u; len -= 8u, data += 8u)
+  {
+    crc ^= (uint16_t)(((uint16_t)data[0] << 8) | data[1]);
+    crc = utilChecksumCrc16SliceTable[6][crc >> 8] ^
+          utilChecksumCrc16SliceTable[5][crc & 0xFFu] ^
+          utilChecksumCrc16SliceTable[4][data[2]] ^
+          utilChecksumCrc16SliceTable[3][data[3]] ^
+          utilChecksumCrc16SliceTable[2][data[4]] ^
+          utilChecksumCrc16SliceTable[1][data[5]] ^
+          utilChecksumCrc16SliceTable[0][data[6]] ^
+          utilChecksumCrc16Table[data[7]];
+  }
+  return UtilChecksumCrc16Byte(crc, data, len);
+} /*** end of UtilChecksumCrc16Slice8 ***/
+
+
+/************************************************************************************//**
+** \brief     Continues a 32-bit CRC calculation over the specified data, eight bytes at
+**            a time. The CRC is combined with the first four bytes, after which each of
+**            the eight bytes has its own table lookup. These lookups do not depend on
+**            each other, so the CPU performs them in parallel. The remaining bytes are
+**            processed one at a time.
+** \param     crc The CRC value of the preceding data.
+** \param     data Array with bytes over which the CRC32 should be calculated.
+** \param     len Number of bytes in the data array. Can be zero.
+** \return    The 32-bit CRC value.
+**
+****************************************************************************************/
+static uint32_t UtilChecksumCrc32Slice8(uint32_t crc, uint8_t const * data, uint32_t len)
+{
+  for (; len >= 8u; len -= 8u, data += 8u)
+  {
+    crc ^= ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) |
+           ((uint32_t)data[2] << 8) | (uint32_t)data[3];
+    crc = utilChecksumCrc32SliceTable[6][crc >> 24] ^
+          utilChecksumCrc32SliceTable[5][(crc >> 16) & 0xFFu] ^
+          utilChecksumCrc32SliceTable[4][(crc >> 8) & 0xFFu] ^
+          utilChecksumCrc32SliceTable[3][crc & 0xFFu] ^
+          utilChecksumCrc32SliceTable[2][data[4]] ^
+          utilChecksumCrc32SliceTable[1][data[5]] ^
+          utilChecksumCrc32SliceTable[0][data[6]] ^
+          utilChecksumCrc32Table[data[7]];
+  }
+  return UtilChecksumCrc32Byte(crc, data, len);
+} /*** end of UtilChecksumCrc32Slice8 ***/
+
+
+#if defined(UTIL_CHECKSUM_CLMUL_ENABLE)
+/************************************************************************************//**
+** \brief     Detects if the CPU supports the instructions of the carry-less
+**            multiplication checksum kernel. These are PCLMULQDQ, SSSE3 and SSE2. The
+**            result is cached, because CPUID is slow, especially in a virtual machine.
+** \return    True if supported, false otherwise.
+**
+****************************************************************************************/
+static bool UtilChecksumClmulDetect(void)
+{
+  uint8_t support = utilChecksumClmulSupport;
+
+  /* Detect it the first time. */
+  if (support == 0)
+  {
+    /* CPUID leaf 1: PCLMULQDQ is bit 1 and SSSE3 is bit 9 of ECX, SSE2 is bit 26 of
+     * EDX.
+     */
+#if defined(__GNUC__)
+    unsigned int eax, ebx, ecx, edx;
+
+    support = 2;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) != 0)
+    {
+      if ( ((ecx & (1u << 1)) != 0) && ((ecx & (1u << 9)) != 0) &&
+           ((edx & (1u << 26)) != 0) )
+      {
+        support = 1;
+      }
+    }
+#else
+    int info[4];
+
+    support = 2;
+    __cpuid(info, 1);
+    if ( ((info[2] & (1 << 1)) != 0) && ((info[2] & (1 << 9)) != 0) &&
+         ((info[3] & (1 << 26)) != 0) )
+    {
+      support = 1;
+    }
+#endif
+    utilChecksumClmulSupport = support;
+  }
+  /* Give the result back to the caller. */
+  return (support == 1);
+} /*** end of UtilChecksumClmulDetect ***/
+
+
+/************************************************************************************//**
+** \brief     Folds the data into 16 bytes with the same CRC value, using carry-less
+**            multiplication. The CRC of the data equals the CRC of the 16 bytes, which
+**            the caller calculates with a table kernel. Four blocks of 16 bytes are
+**            folded in parallel. Bit 127 of a block is the most significant bit of its
+**            first byte, which is why the bytes of each block are reversed. A block A
+**            that is followed by the data B, n bits further, is folded by replacing it
+**            with A.hi * (x^(n+64) mod P) + A.lo * (x^n mod P). This has the same CRC.
+** \param     crc The CRC value of the preceding data, in the upper bits of a 32-bit
+**            value. For a CRC16 value, it is shifted left by 16 bits.
+** \param     data Array with bytes over which the CRC should be calculated.
+** \param     len Number of bytes in the data array. Must be at least
+**            UTIL_CHECKSUM_CLMUL_MIN_LEN.
+** \param     constants Array with the folding constants of the CRC polynomial.
+** \param     folded Array of 16 bytes where the folded data is stored.
+** \return    Number of bytes that were folded. This is a multiple of 16. The remaining
+**            bytes must still be processed by the caller.
+**
+****************************************************************************************/
+UTIL_CHECKSUM_CLMUL_TARGET
+static uint32_t UtilChecksumClmulFold(uint32_t crc, uint8_t const * data, uint32_t len,
+                                      uint32_t const * constants, uint8_t * folded)
+{
+  __m128i const swap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                    8, 9, 10, 11, 12, 13, 14, 15);
+  __m128i const fold4 = _mm_set_epi32(0, (int)constants[1], 0, (int)constants[0]);
+  __m128i const fold1 = _mm_set_epi32(0, (int)constants[3], 0, (int)constants[2]);
+  __m128i x0, x1, x2, x3;
+  uint32_t done;
+
+  /* Check parameters. */
+  assert(len >= UTIL_CHECKSUM_CLMUL_MIN_LEN);
+
+  /* Load the first four blocks and add the CRC of the preceding data to the first. */
+  x0 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const *)&data[0]), swap);
+  x1 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const *)&data[16]), swap);
+  x2 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const *)&data[32]), swap);
+  x3 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const *)&data[48]), swap);
+  x0 = _mm_xor_si128(x0, _mm_set_epi32((int)crc, 0, 0, 0));
+  /* Fold four blocks at a time, each into the block 64 bytes further. */
+  for (done = 64u; (len - done) >= 64u; done += 64u)
+  {
+    x0 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x0, fold4, 0x11),
+                                     _mm_clmulepi64_si128(x0, fold4, 0x00)),
+         _mm_shuffle_epi8(_mm_loadu_si128((__m128i const *)&data[done]), swap));
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, fold4, 0x11),
+                                     _mm_clmulepi64_si128(x1, fold4, 0x00)),
+         _mm_shuffle_epi8(_mm_loadu_si128((__m128i const *)&data[done + 16u]), swap));
+    x2 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x2, fold4, 0x11),
+                                     _mm_clmulepi64_si128(x2, fold4, 0x00)),
+         _mm_shuffle_epi8(_mm_loadu_si128((__m128i const *)&data[done + 32u]), swap));
+    x3 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x3, fold4, 0x11),
+                                     _mm_clmulepi64_si128(x3, fold4, 0x00)),
+         _mm_shuffle_epi8(_mm_loadu_si128((__m128i const *)&data[done + 48u]), swap));
+  }
+  /* Fold the four blocks into one. */
+  x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x0, fold1, 0x11),
+                                   _mm_clmulepi64_si128(x0, fold1, 0x00)), x1);
+  x2 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, fold1, 0x11),
+                                   _mm_clmulepi64_si128(x1, fold1, 0x00)), x2);
+  x3 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x2, fold1, 0x11),
+                                   _mm_clmulepi64_si128(x2, fold1, 0x00)), x3);
+  /* Fold the remaining complete blocks one at a time. */
+  for (; (len - done) >= 16u; done += 16u)
+  {
+    x3 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x3, fold1, 0x11),
+                                     _mm_clmulepi64_si128(x3, fold1, 0x00)),
+         _mm_shuffle_epi8(_mm_loadu_si128((__m128i const *)&data[done]), swap));
+  }
+  /* Store the folded block, with its bytes back in data order. */
+  _mm_storeu_si128((__m128i *)folded, _mm_shuffle_epi8(x3, swap));
+  return done;
+} /*** end of UtilChecksumClmulFold ***/
+#endif
+
+
+/************************************************************************************//**
+** \brief     Starts the calculation of a SHA-256 digest.
+** \param     context Pointer to the context of the calculation.
+**
+****************************************************************************************/
+void UtilChecksumSha256Init(tUtilChecksumSha256 * context)
+{
+  /* Check parameters. */
+  assert(context != NULL);
+
+  /* Only continue with valid parameters. */
+  if (context != NULL) /*lint !e774 */
+  {
+    /* Set the initial hash value. */
+    context->state[0] = 0x6A09E667u;
+    context->state[1] = 0xBB67AE85u;
+    context->state[2] = 0x3C6EF372u;
+    context->state[3] = 0xA54FF53Au;
+    context->state[4] = 0x510E527Fu;
+    context->state[5] = 0x9B05688Cu;
+    context->state[6] = 0x1F83D9ABu;
+    context->state[7] = 0x5BE0CD19u;
+    context->length = 0;
+    context->blockLen = 0;
+  }
+} /*** end of UtilChecksumSha256Init ***/
+
+
+/************************************************************************************//**
+** \brief     Continues the calculation of a SHA-256 digest over the specified data.
+**            This makes it possible to calculate the digest of data that is not
+**            available all at once, such as the contents of a large file.
+** \param     context Pointer to the context of the calculation.
+** \param     data Pointer to the data.
+** \param     len Number of bytes in the data.
+**
+****************************************************************************************/
+void UtilChecksumSha256Update(tUtilChecksumSha256 * context, uint8_t const * data,
+                              uint32_t len)
+{
+  uint32_t chunkLen;
+
+  /* Check parameters. */
+  assert(context != NULL);
+  assert((data != NULL) || (len == 0));
+
+  /* Only continue with valid parameters. */
+  if ( (context != NULL) && (data != NULL) ) /*lint !e774 */
+  {
+    context->length += len;
+    while (len > 0)
+    {
+      /* Process complete blocks directly from the data. */
+      if ( (context->blockLen == 0) && (len >= sizeof(context->block)) )
+      {
+        UtilChecksumSha256Block(context->state, data);
+        chunkLen = sizeof(context->block);
+      }
+      /* Otherwise collect the data in the block and process it once full. */
+      else
+      {
+        chunkLen = sizeof(context->block) - context->blockLen;
+        if (chunkLen > len)
+        {
+          chunkLen = len;
+        }
+        memcpy(&context->block[context->blockLen], data, chunkLen);
+        context->blockLen += chunkLen;
+        if (context->blockLen == sizeof(context->block))
+        {
+          UtilChecksumSha256Block(context->state, context->block);
+          context->blockLen = 0;
+        }
+      }
+      data += chunkLen;
+      len -= chunkLen;
+    }
+  }
+} /*** end of UtilChecksumSha256Update ***/
+
+
+/************************************************************************************//**
+** \brief     Finishes the calculation of a SHA-256 digest. The context can no longer be
+**            updated afterwards.
+** \param     context Pointer to the context of the calculation.
+** \param     digest Buffer with UTIL_CHECKSUM_SHA256_LEN bytes where the digest is
+**            written to.
+**
+****************************************************************************************/
+void UtilChecksumSha256Final(tUtilChecksumSha256 * context, uint8_t * digest)
+{
+  uint64_t bitLength;
+  uint8_t idx;
+
+  /* Check parameters. */
+  assert(context != NULL);
+  assert(digest != NULL);
+
+  /* Only continue with valid parameters. */
+  if ( (context != NULL) && (digest != NULL) ) /*lint !e774 */
+  {
+    /* Pad the data with a one bit, zero bits and the length in bits, such that the
+     * last block is full.
+     */
+    bitLength = context->length * 8u;
+    context->block[context->blockLen++] = 0x80u;
+    if (context->blockLen > (sizeof(context->block) - 8u))
+    {
+      memset(&context->block[context->blockLen], 0,
+             sizeof(context->block) - context->blockLen);
+      UtilChecksumSha256Block(context->state, context->block);
+      context->blockLen = 0;
+    }
+    memset(&context->block[context->blockLen], 0,
+           sizeof(context->block) - 8u - context->blockLen);
+    for (idx = 0; idx < 8u; idx++)
+    {
+      context->block[63u - idx] = (uint8_t)(bitLength >> (8u * idx));
+    }
+    UtilChecksumSha256Block(context->state, context->block);
+    /* Store the hash value in big endian byte order. */
+    for (idx = 0; idx < 32u; idx++)
+    {
+      digest[idx] = (uint8_t)(context->state[idx / 4u] >> (24u - (8u * (idx % 4u))));
+    }
+  }
+} /*** end of UtilChecksumSha256Final ***/
+
+
+/************************************************************************************//**
+** \brief     Processes one block of 64 bytes with the SHA-256 compression function.
+** \param     state The hash value, which is updated.
+** \param     block Pointer to the block.
+**
+****************************************************************************************/
+static void UtilChecksumSha256Block(uint32_t * state, uint8_t const * block)
+{
+  uint32_t w[64];
+  uint32_t v[8];
+  uint32_t s0;
+  uint32_t s1;
+  uint32_t t1;
+  uint32_t t2;
+  uint8_t idx;
+
+  /* Prepare the message schedule. */
+  for (idx = 0; idx < 16u; idx++)
+  {
+    w[idx] = ((uint32_t)block[idx * 4u] << 24) |
+             ((uint32_t)block[(idx * 4u) + 1u] << 16) |
+             ((uint32_t)block[(idx * 4u) + 2u] << 8) |
+             (uint32_t)block[(idx * 4u) + 3u];
+  }
+  for (idx = 16; idx < 64u; idx++)
+  {
+    s0 = ((w[idx - 15u] >> 7) | (w[idx - 15u] << 25)) ^
+         ((w[idx - 15u] >> 18) | (w[idx - 15u] << 14)) ^ (w[idx - 15u] >> 3);
+    s1 = ((w[idx - 2u] >> 17) | (w[idx - 2u] << 15)) ^
+         ((w[idx - 2u] >> 19) | (w[idx - 2u] << 13)) ^ (w[idx - 2u] >> 10);
+    w[idx] = w[idx - 16u] + s0 + w[idx - 7u] + s1;
+  }
+  /* Run the 64 rounds. */
+  memcpy(v, state, sizeof(v));
+  for (idx = 0; idx < 64u; idx++)
+  {
+    s1 = ((v[4] >> 6) | (v[4] << 26)) ^ ((v[4] >> 11) | (v[4] << 21)) ^
+         ((v[4] >> 25) | (v[4] << 7));
+    t1 = v[7] + s1 + ((v[4] & v[5]) ^ (~v[4] & v[6])) + utilChecksumSha256K[idx] +
+         w[idx];
+    s0 = ((v[0] >> 2) | (v[0] << 30)) ^ ((v[0] >> 13) | (v[0] << 19)) ^
+         ((v[0] >> 22) | (v[0] << 10));
+    t2 = s0 + ((v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]));
+    v[7] = v[6];
+    v[6] = v[5];
+    v[5] = v[4];
+    v[4] = v[3] + t1;
+    v[3] = v[2];
+    v[2] = v[1];
+    v[1] = v[0];
+    v[0] = t1 + t2;
+  }
+  /* Add the result to the hash value. */
+  for (idx = 0; idx < 8u; idx++)
+  {
+    state[idx] += v[idx];
+  }
+} /*** end of UtilChecksumSha256Block ***/
 
 
 /************************************************************************************//**
@@ -255,6 +1622,71 @@ bool UtilFileExtractFilename(char const * fullFilename, char * filenameBuffer)
 } /*** end of UtilFileExtractFilename ***/
 
 
+/************************************************************************************//**
+** \brief     Determines the deadline that lies the specified time from now, on the
+**            monotonic clock. Deadlines do not move when the wall-clock time is
+**            adjusted, so a timeout never expires early or late because of that.
+** \param     timeout Time from now in microseconds.
+** \return    Monotonic time in microseconds of the deadline.
+**
+****************************************************************************************/
+uint64_t UtilTimeDeadlineUs(uint64_t timeout)
+{
+  return UtilTimeGetMonotonicUs() + timeout;
+} /*** end of UtilTimeDeadlineUs ***/
+
+
+/************************************************************************************//**
+** \brief     Determines the time that remains until the specified deadline.
+** \param     deadline Monotonic time in microseconds of the deadline.
+** \return    Remaining time in microseconds, or zero if the deadline passed.
+**
+****************************************************************************************/
+uint64_t UtilTimeDeadlineRemainingUs(uint64_t deadline)
+{
+  uint64_t result = 0;
+  uint64_t now;
+
+  now = UtilTimeGetMonotonicUs();
+  if (now < deadline)
+  {
+    result = deadline - now;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilTimeDeadlineRemainingUs ***/
+
+
+/************************************************************************************//**
+** \brief     Determines the time that remains until the specified deadline, in
+**            milliseconds, for functions that wait with a millisecond timeout. The time
+**            is rounded up, so that such a wait does not end before the deadline.
+** \param     deadline Monotonic time in microseconds of the deadline.
+** \return    Remaining time in milliseconds, or zero if the deadline passed.
+**
+****************************************************************************************/
+uint32_t UtilTimeDeadlineRemainingMs(uint64_t deadline)
+{
+  uint64_t remaining;
+
+  remaining = (UtilTimeDeadlineRemainingUs(deadline) + 999u) / 1000u;
+  /* Give the result back to the caller, limited to what fits in 32 bits. */
+  return (remaining < 0xFFFFFFFFull) ? (uint32_t)remaining : 0xFFFFFFFEu;
+} /*** end of UtilTimeDeadlineRemainingMs ***/
+
+
+/************************************************************************************//**
+** \brief     Checks if the specified deadline passed.
+** \param     deadline Monotonic time in microseconds of the deadline.
+** \return    True if the deadline passed, false otherwise.
+**
+****************************************************************************************/
+bool UtilTimeDeadlineExpired(uint64_t deadline)
+{
+  return (UtilTimeGetMonotonicUs() >= deadline);
+} /*** end of UtilTimeDeadlineExpired ***/
+
+
 /************************************************************************************//**
 ** \brief     Encrypts the len-bytes in the specified data-array, using the specified
 **            256-bit (32 bytes) key. The results are written back into the same array.
@@ -269,7 +1701,7 @@ bool UtilFileExtractFilename(char const * fullFilename, char * filenameBuffer)
 bool UtilCryptoAes256Encrypt(uint8_t * data, uint32_t len, uint8_t const * key)
 {
   bool result = false;
-  aes256_context ctx;
+  aes256_ks_context ctx;
 
   /* Check parameters */
   assert(data != NULL);
@@ -278,17 +1710,18 @@ bool UtilCryptoAes256Encrypt(uint8_t * data, uint32_t len, uint8_t const * key)
   /* Only continue with valid parameters. Also add a block size check for 'len'. */
   if ( (data != NULL) && (key != NULL) && ((len % 16u) == 0) ) /*lint !e774 */
   {
-    /* Init context */
-    aes256_init(&ctx, key);
-    /* Encrypt in blocks of 16 bytes. */
-    for (uint32_t i = 0; i < (len / 16u); i++)
+    /* Init context. This expands the key once and selects the fastest block cipher
+     * implementation that the CPU supports.
+     */
+    if (aes256_ks_init(&ctx, key, AES256_BACKEND_AUTO) != 0)
     {
-      aes256_encrypt_ecb(&ctx, &data[i * 16u]);
+      /* Encrypt all blocks of 16 bytes at once. */
+      aes256_ks_encrypt_ecb(&ctx, data, len / 16u);
+      /* Cleanup */
+      aes256_ks_done(&ctx);
+      /* Set positive result. */
+      result = true;
     }
-    /* Cleanup */
-    aes256_done(&ctx);
-    /* Set positive result. */
-    result = true;
   }
   /* Give the result back to the caller. */
   return result;
@@ -309,7 +1742,7 @@ bool UtilCryptoAes256Encrypt(uint8_t * data, uint32_t len, uint8_t const * key)
 bool UtilCryptoAes256Decrypt(uint8_t * data, uint32_t len, uint8_t const * key)
 {
   bool result = false;
-  aes256_context ctx;
+  aes256_ks_context ctx;
 
   /* Check parameters */
   assert(data != NULL);
@@ -318,23 +1751,145 @@ bool UtilCryptoAes256Decrypt(uint8_t * data, uint32_t len, uint8_t const * key)
   /* Only continue with valid parameters. Also add a block size check for 'len'. */
   if ( (data != NULL) && (key != NULL) && ((len % 16u) == 0) ) /*lint !e774 */
   {
-    /* Init context */
-    aes256_init(&ctx, key);
-    /* Decrypt in blocks of 16 bytes. */
-    for (uint32_t i = 0; i < (len / 16u); i++)
+    /* Init context. This expands the key once and selects the fastest block cipher
+     * implementation that the CPU supports.
+     */
+    if (aes256_ks_init(&ctx, key, AES256_BACKEND_AUTO) != 0)
     {
-      aes256_decrypt_ecb(&ctx, &data[i * 16u]);
+      /* Decrypt all blocks of 16 bytes at once. */
+      aes256_ks_decrypt_ecb(&ctx, data, len / 16u);
+      /* Cleanup */
+      aes256_ks_done(&ctx);
+      /* Set positive result. */
+      result = true;
     }
-    /* Cleanup */
-    aes256_done(&ctx);
-    /* Set positive result. */
-    result = true;
   }
   /* Give the result back to the caller. */
   return result;
 } /*** end of UtilCryptoAes256Decrypt ***/
 
 
+/************************************************************************************//**
+** \brief     Creates an AES256 cryptography context for the specified 256-bit (32 bytes)
+**            key. The key is expanded once, after which the context en/decrypts any
+**            number of buffers.
+** \param     key The 256-bit cryptography key as a array of 32 bytes.
+** \return    Handle to the context if successful, NULL otherwise.
+**
+****************************************************************************************/
+tUtilCryptoAes256 UtilCryptoAes256Create(uint8_t const * key)
+{
+  tUtilCryptoAes256 result = NULL;
+  aes256_ks_context * ctx;
+
+  /* Check parameters */
+  assert(key != NULL);
+
+  /* Only continue with valid parameters. */
+  if (key != NULL) /*lint !e774 */
+  {
+    /* Allocate the context. */
+    ctx = malloc(sizeof(aes256_ks_context));
+    if (ctx != NULL)
+    {
+      /* Expand the key for the fastest block cipher implementation that the CPU
+       * supports.
+       */
+      if (aes256_ks_init(ctx, key, AES256_BACKEND_AUTO) != 0)
+      {
+        result = ctx;
+      }
+      else
+      {
+        free(ctx);
+      }
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilCryptoAes256Create ***/
+
+
+/************************************************************************************//**
+** \brief     Releases an AES256 cryptography context. The expanded key is wiped before
+**            the memory is freed.
+** \param     crypto Handle to the context.
+**
+****************************************************************************************/
+void UtilCryptoAes256Destroy(tUtilCryptoAes256 crypto)
+{
+  /* Check parameters */
+  assert(crypto != NULL);
+
+  /* Only continue with valid parameters. */
+  if (crypto != NULL) /*lint !e774 */
+  {
+    aes256_ks_done((aes256_ks_context *)crypto);
+    free(crypto);
+  }
+} /*** end of UtilCryptoAes256Destroy ***/
+
+
+/************************************************************************************//**
+** \brief     Encrypts the len-bytes in the specified data-array, using the key of the
+**            cryptography context. The results are written back into the same array.
+** \param     crypto Handle to the context.
+** \param     data Pointer to the byte array with data to encrypt. The encrypted bytes
+**            are stored in the same array.
+** \param     len The number of bytes in the data-array to encrypt. It must be a multiple
+**            of 16, as this is the AES256 minimal block size.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+bool UtilCryptoAes256EncryptData(tUtilCryptoAes256 crypto, uint8_t * data, uint32_t len)
+{
+  bool result = false;
+
+  /* Check parameters */
+  assert(crypto != NULL);
+  assert(data != NULL);
+
+  /* Only continue with valid parameters. Also add a block size check for 'len'. */
+  if ( (crypto != NULL) && (data != NULL) && ((len % 16u) == 0) ) /*lint !e774 */
+  {
+    aes256_ks_encrypt_ecb((aes256_ks_context *)crypto, data, len / 16u);
+    result = true;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilCryptoAes256EncryptData ***/
+
+
+/************************************************************************************//**
+** \brief     Decrypts the len-bytes in the specified data-array, using the key of the
+**            cryptography context. The results are written back into the same array.
+** \param     crypto Handle to the context.
+** \param     data Pointer to the byte array with data to decrypt. The decrypted bytes
+**            are stored in the same array.
+** \param     len The number of bytes in the data-array to decrypt. It must be a multiple
+**            of 16, as this is the AES256 minimal block size.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+bool UtilCryptoAes256DecryptData(tUtilCryptoAes256 crypto, uint8_t * data, uint32_t len)
+{
+  bool result = false;
+
+  /* Check parameters */
+  assert(crypto != NULL);
+  assert(data != NULL);
+
+  /* Only continue with valid parameters. Also add a block size check for 'len'. */
+  if ( (crypto != NULL) && (data != NULL) && ((len % 16u) == 0) ) /*lint !e774 */
+  {
+    aes256_ks_decrypt_ecb((aes256_ks_context *)crypto, data, len / 16u);
+    result = true;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of UtilCryptoAes256DecryptData ***/
+
+
 /*********************************** end of util.c *************************************/
 
  
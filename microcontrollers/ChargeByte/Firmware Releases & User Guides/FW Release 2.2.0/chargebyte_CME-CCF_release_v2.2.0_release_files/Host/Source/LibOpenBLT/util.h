@@ -43,20 +43,130 @@
 extern "C" {
 #endif
 
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Timeout value for UtilEventWait that waits without a timeout. */
+#define UTIL_EVENT_WAIT_INFINITE       (0xFFFFFFFFu)
+
+/** \brief Checksum kernel selection: the fastest kernel that the CPU supports. */
+#define UTIL_CHECKSUM_KERNEL_AUTO      (0u)
+/** \brief Checksum kernel that processes one byte at a time with a lookup table. */
+#define UTIL_CHECKSUM_KERNEL_BYTE      (1u)
+/** \brief Checksum kernel that processes eight bytes at a time with eight lookup
+ *         tables (slicing-by-8).
+ */
+#define UTIL_CHECKSUM_KERNEL_SLICE8    (2u)
+/** \brief Checksum kernel that folds the data with carry-less multiplication (x86
+ *         PCLMULQDQ instruction).
+ */
+#define UTIL_CHECKSUM_KERNEL_CLMUL     (3u)
+
+/** \brief Number of bytes in a SHA-256 digest. */
+#define UTIL_CHECKSUM_SHA256_LEN       (32u)
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Context of a SHA-256 digest calculation. Unlike a CRC value, the digest
+ *         identifies data with certainty for all practical purposes, so it can be used
+ *         to look up data by its contents. The context only exists while the digest is
+ *         calculated, so it is typically a local variable.
+ */
+typedef struct t_util_checksum_sha256
+{
+  uint32_t state[8];                 /**< Hash value of the processed blocks.         */
+  uint64_t length;                   /**< Total number of processed bytes.            */
+  uint8_t block[64];                 /**< Bytes of the block that is not yet full.    */
+  uint32_t blockLen;                 /**< Number of bytes in the block.               */
+} tUtilChecksumSha256;
+
+/** \brief Handle to a critical section object. Each module that shares data between
+ *         threads creates and owns its own critical section object, such that
+ *         unrelated modules do not serialize on the same lock.
+ */
+typedef void * tUtilCriticalSection;
+
+/** \brief Handle to a thread object. */
+typedef void * tUtilThread;
+
+/** \brief Function that runs in a thread. */
+typedef void (* tUtilThreadFunc)(void * arg);
+
+/** \brief Handle to an event object. An event is either set or reset. Besides waiting
+ *         for it with UtilEventWait, its operating system handle can be obtained, such
+ *         that an application can wait for it together with its own handles.
+ */
+typedef void * tUtilEvent;
+
+/** \brief Handle to an AES256 cryptography context. It holds the expanded key, such that
+ *         any number of buffers can be en/decrypted without expanding the key again. The
+ *         context is only read while data is processed, so multiple threads can use the
+ *         same context at the same time.
+ */
+typedef void * tUtilCryptoAes256;
+
+/** \brief Function that UtilFileScanDirectory calls for each file in the directory,
+ *         with the name of the file, its size in bytes and the time of its last
+ *         modification in microseconds since the epoch.
+ */
+typedef void (* tUtilFileScanFunc)(char const * name, uint64_t size, uint64_t modified,
+                                   void * arg);
+
+
 /****************************************************************************************
 * Function prototypes
 ****************************************************************************************/
 uint16_t UtilChecksumCrc16Calculate(uint8_t const * data, uint32_t len);
 uint32_t UtilChecksumCrc32Calculate(uint8_t const * data, uint32_t len);
+bool UtilChecksumKernelSupported(uint8_t kernel);
+uint16_t UtilChecksumCrc16CalculateKernel(uint8_t const * data, uint32_t len,
+                                          uint8_t kernel);
+uint32_t UtilChecksumCrc32CalculateKernel(uint8_t const * data, uint32_t len,
+                                          uint8_t kernel);
+uint16_t UtilChecksumCrc16Update(uint16_t crc, uint8_t const * data, uint32_t len);
+uint32_t UtilChecksumCrc32Update(uint32_t crc, uint8_t const * data, uint32_t len);
+uint16_t UtilChecksumCrc16Combine(uint16_t crc1, uint16_t crc2, uint32_t len2);
+uint32_t UtilChecksumCrc32Combine(uint32_t crc1, uint32_t crc2, uint32_t len2);
+void UtilChecksumSha256Init(tUtilChecksumSha256 * context);
+void UtilChecksumSha256Update(tUtilChecksumSha256 * context, uint8_t const * data,
+                              uint32_t len);
+void UtilChecksumSha256Final(tUtilChecksumSha256 * context, uint8_t * digest);
 bool UtilFileExtractFilename(char const * fullFilename, char * filenameBuffer);
+uint8_t const * UtilFileMap(char const * filename, uint32_t * len);
+void UtilFileUnmap(uint8_t const * data, uint32_t len);
+bool UtilFileTouch(char const * filename);
+bool UtilFileScanDirectory(char const * directory, tUtilFileScanFunc func, void * arg);
 uint32_t UtilTimeGetSystemTimeMs(void);
+uint64_t UtilTimeGetSystemTimeUs(void);
 void UtilTimeDelayMs(uint16_t delay);
-void UtilCriticalSectionInit(void);
-void UtilCriticalSectionTerminate(void);
-void UtilCriticalSectionEnter(void);
-void UtilCriticalSectionExit(void);
+uint64_t UtilTimeGetMonotonicNs(void);
+uint64_t UtilTimeGetMonotonicUs(void);
+void UtilTimeSleepUntilUs(uint64_t deadline);
+uint64_t UtilTimeDeadlineUs(uint64_t timeout);
+uint64_t UtilTimeDeadlineRemainingUs(uint64_t deadline);
+uint32_t UtilTimeDeadlineRemainingMs(uint64_t deadline);
+bool UtilTimeDeadlineExpired(uint64_t deadline);
+tUtilCriticalSection UtilCriticalSectionCreate(void);
+void UtilCriticalSectionDestroy(tUtilCriticalSection critSect);
+tUtilCriticalSection UtilCriticalSectionGetGlobal(void);
+void UtilCriticalSectionLock(tUtilCriticalSection critSect);
+void UtilCriticalSectionUnlock(tUtilCriticalSection critSect);
+tUtilThread UtilThreadCreate(tUtilThreadFunc func, void * arg);
+void UtilThreadJoin(tUtilThread thread);
+tUtilEvent UtilEventCreate(void);
+void UtilEventDestroy(tUtilEvent event);
+void UtilEventSet(tUtilEvent event);
+void UtilEventReset(tUtilEvent event);
+bool UtilEventWait(tUtilEvent event, uint32_t timeout);
+intptr_t UtilEventGetHandle(tUtilEvent event);
 bool UtilCryptoAes256Encrypt(uint8_t * data, uint32_t len, uint8_t const * key);
 bool UtilCryptoAes256Decrypt(uint8_t * data, uint32_t len, uint8_t const * key);
+tUtilCryptoAes256 UtilCryptoAes256Create(uint8_t const * key);
+void UtilCryptoAes256Destroy(tUtilCryptoAes256 crypto);
+bool UtilCryptoAes256EncryptData(tUtilCryptoAes256 crypto, uint8_t * data, uint32_t len);
+bool UtilCryptoAes256DecryptData(tUtilCryptoAes256 crypto, uint8_t * data, uint32_t len);
 
 
 #ifdef __cplusplus
@@ -40,6 +40,7 @@
 #include "session.h"                        /* Communication session module            */
 #include "xcploader.h"                      /* XCP loader module                       */
 #include "xcpprotect.h"                     /* XCP protection module                   */
+#include "util.h"                           /* Utility module                          */
 
 
 /****************************************************************************************
@@ -52,6 +53,7 @@
 #define XCPLOADER_CMD_UNLOCK          (0xF7u)    /**< XCP unlock command code.         */
 #define XCPLOADER_CMD_SET_MTA         (0xF6u)    /**< XCP set mta command code.        */
 #define XCPLOADER_CMD_UPLOAD          (0xF5u)    /**< XCP upload command code.         */
+#define XCPLOADER_CMD_BUILD_CHECKSUM  (0xF3u)    /**< XCP build checksum command code. */
 #define XCPLOADER_CMD_PROGRAM_START   (0xD2u)    /**< XCP program start command code.  */
 #define XCPLOADER_CMD_PROGRAM_CLEAR   (0xD1u)    /**< XCP program clear command code.  */
 #define XCPLOADER_CMD_PROGRAM         (0xD0u)    /**< XCP program command code.        */
@@ -61,45 +63,149 @@
 /* XCP response packet IDs as defined by the protocol. */
 #define XCPLOADER_CMD_PID_RES         (0xFFu)    /**< positive response                */
 
+/* XCP checksum types as defined by the protocol, that the XCP loader supports. They
+ * are sums of all bytes, added into an 8-, 16- or 32-bit value.
+ */
+#define XCPLOADER_CHECKSUM_ADD_11     (0x01u)    /**< sum of bytes into a byte         */
+#define XCPLOADER_CHECKSUM_ADD_12     (0x02u)    /**< sum of bytes into a word         */
+#define XCPLOADER_CHECKSUM_ADD_14     (0x03u)    /**< sum of bytes into a long         */
+
 /** \brief Number of retries to connect to the XCP slave. */
 #define XCPLOADER_CONNECT_RETRIES     (5u)
 
+/** \brief Number of times that program and upload commands are resent, after the
+ *         command or its response got lost on an unreliable transport layer.
+ */
+#define XCPLOADER_TRANSFER_RETRIES    (2u)
+
+/** \brief Number of bytes that are uploaded at once, when verifying the programmed
+ *         data at the end of the programming session on a target that does not support
+ *         the build checksum command.
+ */
+#define XCPLOADER_VERIFY_CHUNK_SIZE   (1024u)
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Range of programmed data, that is verified at the end of the programming
+ *         session.
+ */
+typedef struct
+{
+  uint32_t address;                        /**< Start address of the range.            */
+  uint32_t len;                            /**< Number of bytes in the range.          */
+  uint32_t checksum;                       /**< CRC32 of the programmed data.          */
+  uint32_t sum;                            /**< Byte sum of the programmed data.       */
+} tXcpLoaderRange;
+
+/** \brief Type for the XCP loader object. */
+typedef struct
+{
+  /** \brief The settings that should be used by the XCP loader. */
+  tXcpLoaderSettings settings;
+  /** \brief Flag to keep track of the connection status. */
+  bool connected;
+  /** \brief Flag to keep track of the connection status of the transport layer. */
+  bool transportConnected;
+  /** \brief True if the transport layer should stay connected when stopping. */
+  bool keepTransport;
+  /** \brief Store the byte ordering of the XCP slave. */
+  bool slaveIsIntel;
+  /** \brief True if the transport layer can lose, duplicate or reorder packets. */
+  bool unreliable;
+  /** \brief The max number of bytes in the command transmit object (master->slave). */
+  uint8_t maxCto;
+  /** \brief The max number of bytes in the command transmit object (master->slave)
+   *         during a programming session.
+   */
+  uint8_t maxProgCto;
+  /** \brief The max number of bytes in the data transmit object (slave->master). */
+  uint16_t maxDto;
+  /** \brief Command/response latency statistics of the current session. */
+  tSessionLatency latency;
+  /** \brief Handle of the transport layer object. */
+  void * transport;
+  /** \brief Handle of the XCP protection object. */
+  tXcpProtectHandle protect;
+  /** \brief Ranges of data that were programmed during this session. Only kept track
+   *         of on an unreliable transport layer, for verifying them at the end.
+   */
+  tXcpLoaderRange * ranges;
+  /** \brief Number of ranges in \ref ranges. */
+  uint32_t rangeCount;
+  /** \brief Number of ranges for which memory is allocated in \ref ranges. */
+  uint32_t rangeSize;
+} tXcpLoaderObj;
+
 
 /****************************************************************************************
 * Function prototypes
 ****************************************************************************************/
 /* Protocol functions for linking to the session module. */
-static void XcpLoaderInit(void const * settings);
-static void XcpLoaderTerminate(void);
-static bool XcpLoaderStart(void);
-static void XcpLoaderStop(void);
-static bool XcpLoaderClearMemory(uint32_t address, uint32_t len);
-static bool XcpLoaderWriteData(uint32_t address, uint32_t len, uint8_t const * data);  
-static bool XcpLoaderReadData(uint32_t address, uint32_t len, uint8_t * data);
+static void * XcpLoaderInit(void const * settings);
+static void XcpLoaderTerminate(void * handle);
+static bool XcpLoaderStart(void * handle);
+static bool XcpLoaderStop(void * handle);
+static bool XcpLoaderClearMemory(void * handle, uint32_t address, uint32_t len);
+static bool XcpLoaderWriteData(void * handle, uint32_t address, uint32_t len,
+                               uint8_t const * data);
+static bool XcpLoaderReadData(void * handle, uint32_t address, uint32_t len,
+                              uint8_t * data);
+static void XcpLoaderGetLatency(void * handle, tSessionLatency * latency);
+static void XcpLoaderKeepTransport(void * handle, bool keep);
 /* General module specific utility functions. */
-static void XcpLoaderSetOrderedLong(uint32_t value, uint8_t *data);
-static uint16_t XcpLoaderGetOrderedWord(uint8_t const * data);
+static void XcpLoaderSetOrderedLong(tXcpLoaderObj * loader, uint32_t value,
+                                    uint8_t *data);
+static uint16_t XcpLoaderGetOrderedWord(tXcpLoaderObj * loader, uint8_t const * data);
+static uint32_t XcpLoaderGetOrderedLong(tXcpLoaderObj * loader, uint8_t const * data);
+static bool XcpLoaderSendPacket(tXcpLoaderObj * loader,
+                                tXcpTransportPacket const * txPacket,
+                                tXcpTransportPacket * rxPacket, uint16_t timeout);
+static bool XcpLoaderSendPacketVector(tXcpLoaderObj * loader,
+                                      tXcpTransportTxVector const * txVector,
+                                      tXcpTransportRxVector * rxVector,
+                                      uint16_t timeout);
+static void XcpLoaderUpdateLatency(tXcpLoaderObj * loader, uint32_t totalTime);
+static bool XcpLoaderAddRange(tXcpLoaderObj * loader, uint32_t address, uint32_t len,
+                              uint8_t const * data);
+static bool XcpLoaderVerifyRanges(tXcpLoaderObj * loader);
+static bool XcpLoaderVerifyRangeChecksum(tXcpLoaderObj * loader,
+                                         tXcpLoaderRange const * range,
+                                         bool * supported);
+static bool XcpLoaderVerifyRangeUpload(tXcpLoaderObj * loader,
+                                       tXcpLoaderRange const * range);
 /* XCP command functions. */
-static bool XcpLoaderSendCmdConnect(void);
-static bool XcpLoaderSendCmdGetStatus(uint8_t * session, uint8_t * protectedResources,
+static bool XcpLoaderSendCmdConnect(tXcpLoaderObj * loader);
+static bool XcpLoaderSendCmdGetStatus(tXcpLoaderObj * loader, uint8_t * session,
+                                      uint8_t * protectedResources,
                                       uint16_t * configId);
-static bool XcpLoaderSendCmdGetSeed(uint8_t resource, uint8_t mode, uint8_t * seed, uint8_t * seedLen);
-static bool XcpLoaderSendCmdUnlock(uint8_t const * key, uint8_t keyLen,
-                                   uint8_t * protectedResources);
-static bool XcpLoaderSendCmdSetMta(uint32_t address);
-static bool XcpLoaderSendCmdUpload(uint8_t * data, uint8_t length);
-static bool XcpLoaderSendCmdProgramStart(void);
-static bool XcpLoaderSendCmdProgramReset(void);
-static bool XcpLoaderSendCmdProgram(uint8_t length, uint8_t const * data);
-static bool XcpLoaderSendCmdProgramMax(uint8_t const * data);
-static bool XcpLoaderSendCmdProgramClear(uint32_t length);
+static bool XcpLoaderSendCmdGetSeed(tXcpLoaderObj * loader, uint8_t resource,
+                                    uint8_t mode, uint8_t * seed, uint8_t * seedLen);
+static bool XcpLoaderSendCmdUnlock(tXcpLoaderObj * loader, uint8_t const * key,
+                                   uint8_t keyLen, uint8_t * protectedResources);
+static bool XcpLoaderSendCmdSetMta(tXcpLoaderObj * loader, uint32_t address);
+static bool XcpLoaderSendCmdUpload(tXcpLoaderObj * loader, uint8_t * data,
+                                   uint8_t length);
+static bool XcpLoaderSendCmdBuildChecksum(tXcpLoaderObj * loader, uint32_t blockSize,
+                                          uint8_t * type, uint32_t * checksum);
+static bool XcpLoaderSendCmdProgramStart(tXcpLoaderObj * loader);
+static bool XcpLoaderSendCmdProgramReset(tXcpLoaderObj * loader);
+static bool XcpLoaderSendCmdProgram(tXcpLoaderObj * loader, uint8_t length,
+                                    uint8_t const * data);
+static bool XcpLoaderSendCmdProgramMax(tXcpLoaderObj * loader, uint8_t const * data);
+static bool XcpLoaderSendCmdProgramSegment(tXcpLoaderObj * loader, uint8_t length,
+                                           uint8_t const * data);
+static bool XcpLoaderSendCmdProgramPipelined(tXcpLoaderObj * loader, uint32_t len,
+                                             uint8_t const * data);
+static bool XcpLoaderSendCmdProgramClear(tXcpLoaderObj * loader, uint32_t length);
 
 
 /****************************************************************************************
 * Local constant declarations
 ****************************************************************************************/
 /** \brief Protocol structure filled with XCP loader specifics. */
-static const tSessionProtocol xcpLoader =
+static const tSessionProtocol xcpLoaderProtocol =
 {
   .Init = XcpLoaderInit,
   .Terminate = XcpLoaderTerminate,
@@ -107,34 +213,12 @@ static const tSessionProtocol xcpLoader =
   .Stop = XcpLoaderStop,
   .ClearMemory = XcpLoaderClearMemory,
   .WriteData = XcpLoaderWriteData,
-  .ReadData = XcpLoaderReadData
+  .ReadData = XcpLoaderReadData,
+  .GetLatency = XcpLoaderGetLatency,
+  .KeepTransport = XcpLoaderKeepTransport
 };
 
 
-/****************************************************************************************
-* Local data declarations
-****************************************************************************************/
-/** \brief The settings that should be used by the XCP loader. */
-static tXcpLoaderSettings xcpSettings;
-
-/** \brief Flag to keep track of the connection status. */
-static bool xcpConnected;
-
-/** \brief Store the byte ordering of the XCP slave. */
-static bool xcpSlaveIsIntel;
-
-/** \brief The max number of bytes in the command transmit object (master->slave). */
-static uint8_t xcpMaxCto;
-
-/** \brief The max number of bytes in the command transmit object (master->slave) during
- *         a programming session.
- */
-static uint8_t xcpMaxProgCto;
-
-/** \brief The max number of bytes in the data transmit object (slave->master). */
-static uint16_t xcpMaxDto;
-
-
 /***********************************************************************************//**
 ** \brief     Obtains a pointer to the protocol structure, so that it can be linked to 
 **            the communication session module.
@@ -143,46 +227,38 @@ static uint16_t xcpMaxDto;
 ****************************************************************************************/
 tSessionProtocol const * XcpLoaderGetProtocol(void)
 {
-  return &xcpLoader;
+  return &xcpLoaderProtocol;
 } /*** end of XcpLoaderGetProtocol ***/
 
 
 /************************************************************************************//**
 ** \brief     Initializes the protocol module.
 ** \param     settings Pointer to the structure with protocol settings.
+** \return    Handle of the XCP loader object if successful, NULL otherwise.
 **
 ****************************************************************************************/
-static void XcpLoaderInit(void const * settings)
+static void * XcpLoaderInit(void const * settings)
 {
+  tXcpLoaderObj * loader = NULL;
   char * seedNKeyFileName;
 
-  /* Initialize locals. */
-  xcpConnected = false;
-  xcpSlaveIsIntel = false;
-  xcpMaxCto = 0;
-  xcpMaxProgCto = 0;
-  xcpMaxDto = 0;
-
-  /* Reset the XCP session layer settings. */
-  xcpSettings.timeoutT1 = 1000;
-  xcpSettings.timeoutT3 = 2000;
-  xcpSettings.timeoutT4 = 10000;
-  xcpSettings.timeoutT5 = 1000;
-  xcpSettings.timeoutT6 = 50;
-  xcpSettings.timeoutT7 = 2000;
-  xcpSettings.connectMode = 0;
-  xcpSettings.seedKeyFile = NULL;
-  xcpSettings.transport = NULL;
-  xcpSettings.transportSettings = NULL;
-
   /* Check parameter. */
   assert(settings != NULL);
   /* Only continue with valid parameter. */
   if (settings != NULL) /*lint !e774 */
+  {
+    /* Create the XCP loader object. This also resets the connection state and the
+     * latency statistics.
+     */
+    loader = calloc(1, sizeof(tXcpLoaderObj));
+    assert(loader != NULL);
+  }
+  /* Only continue if the XCP loader object was created. */
+  if (loader != NULL) /*lint !e774 */
   {
     /* shallow copy the XCP settings for later usage */
-    xcpSettings = *(tXcpLoaderSettings *)settings;
-
+    loader->settings = *(tXcpLoaderSettings *)settings;
+    loader->settings.seedKeyFile = NULL;
     /* The seedKeyFile is a pointer and it is not guaranteed that it stays valid so we
      * need to deep copy this one. note the +1 for '\0' in malloc. Note that it is okay
      * for this value to be NULL.
@@ -194,92 +270,126 @@ static void XcpLoaderInit(void const * settings)
       if (seedNKeyFileName != NULL) /*lint !e774 */
       {
         strcpy(seedNKeyFileName, ((tXcpLoaderSettings *)settings)->seedKeyFile);
-        xcpSettings.seedKeyFile = seedNKeyFileName;
+        loader->settings.seedKeyFile = seedNKeyFileName;
       }
     }
     /* Check that a valid transport layer was specified. */
-    assert(xcpSettings.transport != NULL);
+    assert(loader->settings.transport != NULL);
     /* Only access the transport layer if it is valid. */
-    if (xcpSettings.transport != NULL) /*lint !e774 */
+    if (loader->settings.transport != NULL) /*lint !e774 */
     {
       /* Initialize the transport layer. */
-      xcpSettings.transport->Init(xcpSettings.transportSettings);
+      loader->transport =
+        loader->settings.transport->Init(loader->settings.transportSettings);
     }
     /* Invalidate the transportSettings as it is probably no longer valid outside this
      * function scope and should also not be used anymore.
      */
-    xcpSettings.transportSettings = NULL;
+    loader->settings.transportSettings = NULL;
+    /* Initialize the XCP protection module. */
+    loader->protect = XcpProtectInit(loader->settings.seedKeyFile);
+    /* Clean up if the transport layer or the XCP protection could not be created. */
+    if ( (loader->transport == NULL) || (loader->protect == NULL) )
+    {
+      XcpLoaderTerminate(loader);
+      loader = NULL;
+    }
   }
-  /* Initialize the XCP protection module. */
-  XcpProtectInit(xcpSettings.seedKeyFile);
+  /* Give the result back to the caller. */
+  return loader;
 } /*** end of XcpLoaderInit ***/
 
 
 /************************************************************************************//**
 ** \brief     Terminates the protocol module.
+** \param     handle Handle of the XCP loader object.
 **
 ****************************************************************************************/
-static void XcpLoaderTerminate(void)
+static void XcpLoaderTerminate(void * handle)
 {
-  /* Make sure a valid transport layer is linked. */
-  assert(xcpSettings.transport != NULL);
-  
-  /* Terminate the XCP protection module. */
-  XcpProtectTerminate();
-  /* Only continue with a valid transport layer. */
-  if (xcpSettings.transport != NULL) /*lint !e774 */
-  {
-    /* Terminate the transport layer. */
-    xcpSettings.transport->Terminate();
-    /* Unlink the transport layer. */
-    xcpSettings.transport = NULL;
-  }
-  /* Release memory that was allocated for storing the seedKeyFile. */
-  if (xcpSettings.seedKeyFile != NULL)
+  tXcpLoaderObj * loader = (tXcpLoaderObj *)handle;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only continue with valid parameters. */
+  if (loader != NULL) /*lint !e774 */
   {
-    free((char *)xcpSettings.seedKeyFile);
+    /* Terminate the XCP protection module. */
+    if (loader->protect != NULL)
+    {
+      XcpProtectTerminate(loader->protect);
+    }
+    /* Terminate the transport layer. Disconnect it first, if it was kept connected
+     * when the session was stopped.
+     */
+    if ( (loader->settings.transport != NULL) && (loader->transport != NULL) )
+    {
+      if ( (loader->keepTransport) && (loader->transportConnected) )
+      {
+        loader->settings.transport->Disconnect(loader->transport);
+      }
+      loader->settings.transport->Terminate(loader->transport);
+    }
+    /* Release memory that was allocated for storing the seedKeyFile. */
+    if (loader->settings.seedKeyFile != NULL)
+    {
+      free((char *)loader->settings.seedKeyFile);
+    }
+    /* Release memory that was allocated for the programmed ranges. */
+    if (loader->ranges != NULL)
+    {
+      free(loader->ranges);
+    }
+    /* Release the XCP loader object. */
+    free(loader);
   }
-  /* Reset the XCP session layer settings. */
-  xcpSettings.timeoutT1 = 1000;
-  xcpSettings.timeoutT3 = 2000;
-  xcpSettings.timeoutT4 = 10000;
-  xcpSettings.timeoutT5 = 1000;
-  xcpSettings.timeoutT6 = 50;
-  xcpSettings.timeoutT7 = 2000;
-  xcpSettings.connectMode = 0;
-  xcpSettings.seedKeyFile = NULL;
-  xcpSettings.transport = NULL;
-  xcpSettings.transportSettings = NULL;
 } /*** end of XcpLoaderTerminate ***/
 
 
 /************************************************************************************//**
 ** \brief     Starts the firmware update session. This is where the connection with the
 **            target is made and the bootloader on the target is activated.
+** \param     handle Handle of the XCP loader object.
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-static bool XcpLoaderStart(void)
+static bool XcpLoaderStart(void * handle)
 {
+  tXcpLoaderObj * loader = (tXcpLoaderObj *)handle;
   bool result = false;
   uint8_t retryCnt;
   uint8_t protectedResources = 0;
 
   /* Make sure a valid transport layer is linked. */
-  assert(xcpSettings.transport != NULL);
+  assert(loader != NULL);
+  assert(loader->settings.transport != NULL);
   
   /* Only continue with a valid transport layer. */
-  if (xcpSettings.transport != NULL) /*lint !e774 */
+  if (loader->settings.transport != NULL) /*lint !e774 */
   {
     /* Make sure the session is stopped before starting a new one. */
-    XcpLoaderStop();
+    (void)XcpLoaderStop(handle);
+    /* Reset the latency statistics, so that they only cover this session. */
+    memset(&loader->latency, 0, sizeof(loader->latency));
+    /* Find out if lost, duplicated or reordered packets need to be dealt with. */
+    loader->unreliable = (loader->settings.transport->IsUnreliable != NULL) &&
+                         (loader->settings.transport->IsUnreliable(loader->transport));
+    loader->rangeCount = 0;
     /* Init the result value to okay and only set it to error when a problem occurred. */
     result = true;
-    /* Connect the transport layer. */
-    if (!xcpSettings.transport->Connect())
+    /* Connect the transport layer, unless it was kept connected. */
+    if (!loader->transportConnected)
     {
-      /* Could not connect the transport layer. */
-      result = false;
+      if (loader->settings.transport->Connect(loader->transport))
+      {
+        loader->transportConnected = true;
+      }
+      else
+      {
+        /* Could not connect the transport layer. */
+        result = false;
+      }
     }
     /* Connect to the target with a finite amount of retries. */
     if (result)
@@ -287,10 +397,10 @@ static bool XcpLoaderStart(void)
       for (retryCnt=0; retryCnt<XCPLOADER_CONNECT_RETRIES; retryCnt++)
       {
         /* Send the connect command. */
-        if (XcpLoaderSendCmdConnect())
+        if (XcpLoaderSendCmdConnect(loader))
         {
           /* Update connection state. */
-          xcpConnected = true;
+          loader->connected = true;
           /* Connected so no need to retry. */
           break;
         }
@@ -298,10 +408,16 @@ static bool XcpLoaderStart(void)
       /* Check if a connection with the target could be made within the finite amount
        * of retries.
        */
-      if (!xcpConnected)
+      if (!loader->connected)
       {
-        /* Disconnect the transport layer again. */
-        xcpSettings.transport->Disconnect();
+        /* Disconnect the transport layer again, unless it should be kept connected
+         * for the next attempt.
+         */
+        if (!loader->keepTransport)
+        {
+          loader->settings.transport->Disconnect(loader->transport);
+          loader->transportConnected = false;
+        }
         /* Update the result. */
         result = false;
       }
@@ -309,7 +425,7 @@ static bool XcpLoaderStart(void)
     /* Obtain the current resource protection status. */
     if (result)
     {
-      if (!XcpLoaderSendCmdGetStatus(NULL, &protectedResources, NULL))
+      if (!XcpLoaderSendCmdGetStatus(loader, NULL, &protectedResources, NULL))
       {
         result = false;
       }
@@ -333,7 +449,7 @@ static bool XcpLoaderStart(void)
        */
       if (result)
       {
-        if (!XcpProtectGetPrivileges(&availableResources))
+        if (!XcpProtectGetPrivileges(loader->protect, &availableResources))
         {
           /* Could not obtain the supported resource privileges from the XCP protection
            * module.
@@ -351,7 +467,8 @@ static bool XcpLoaderStart(void)
       /* Request (first part of) the seed for unlocking the programming resources. */
       if (result)
       {
-        if (!XcpLoaderSendCmdGetSeed(XCPPROTECT_RESOURCE_PGM, 0, seedPtr, &seedRemainingLen))
+        if (!XcpLoaderSendCmdGetSeed(loader, XCPPROTECT_RESOURCE_PGM, 0, seedPtr,
+                                     &seedRemainingLen))
         {
           result = false;
         }
@@ -364,11 +481,12 @@ static bool XcpLoaderStart(void)
       /* Check if more parts of the seed need to be requested. */
       if (result)
       {
-        while (seedRemainingLen > (xcpMaxDto - 2))
+        while (seedRemainingLen > (loader->maxDto - 2))
         {
           /* update the seed pointer for the next part */
-          seedPtr += (xcpMaxDto - 2);
-          if (!XcpLoaderSendCmdGetSeed(XCPPROTECT_RESOURCE_PGM, 1, seedPtr, &seedRemainingLen))
+          seedPtr += (loader->maxDto - 2);
+          if (!XcpLoaderSendCmdGetSeed(loader, XCPPROTECT_RESOURCE_PGM, 1, seedPtr,
+                                       &seedRemainingLen))
           {
             result = false;
             break;
@@ -381,8 +499,8 @@ static bool XcpLoaderStart(void)
       if ( (result) && (seedTotalLen > 0) )
       {
         /* Compute the key using the XCP protection module. */
-        if (!XCPProtectComputeKeyFromSeed(XCPPROTECT_RESOURCE_PGM, seedTotalLen, seed,
-                                          &keyTotalLen, key))
+        if (!XCPProtectComputeKeyFromSeed(loader->protect, XCPPROTECT_RESOURCE_PGM,
+                                          seedTotalLen, seed, &keyTotalLen, key))
         {
           result = false;
         }
@@ -399,12 +517,13 @@ static bool XcpLoaderStart(void)
           {
             /* Determine how many key bytes are about to be sent. */
             keyCurrentLen = keyRemainingLen;
-            if (keyCurrentLen > (xcpMaxCto - 2))
+            if (keyCurrentLen > (loader->maxCto - 2))
             {
-              keyCurrentLen = (xcpMaxCto - 2);
+              keyCurrentLen = (loader->maxCto - 2);
             }
             /* Send the (possible partial) unlock command. */
-            if (!XcpLoaderSendCmdUnlock(keyPtr, keyRemainingLen, &currentlyProtectedResources))
+            if (!XcpLoaderSendCmdUnlock(loader, keyPtr, keyRemainingLen,
+                                        &currentlyProtectedResources))
             {
               result = false;
               break;
@@ -429,7 +548,7 @@ static bool XcpLoaderStart(void)
     /* Place the target in programming mode if connected. */
     if (result)
     {
-      if (!XcpLoaderSendCmdProgramStart())
+      if (!XcpLoaderSendCmdProgramStart(loader))
       {
         result = false;
       }
@@ -443,30 +562,64 @@ static bool XcpLoaderStart(void)
 /************************************************************************************//**
 ** \brief     Stops the firmware update. This is where the bootloader starts the user
 **            program on the target if a valid one is present. After this the connection
-**            with the target is severed.
+**            with the target is severed. The transport layer is disconnected as well,
+**            unless it should be kept connected. On an unreliable transport layer, the
+**            programmed data is verified first. The bootloader only gets the request to
+**            start the user program, if the data is correct.
+** \param     handle Handle of the XCP loader object.
+** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-static void XcpLoaderStop(void)
+static bool XcpLoaderStop(void * handle)
 {
+  tXcpLoaderObj * loader = (tXcpLoaderObj *)handle;
+  bool result = true;
+  uint8_t retryCnt;
+
   /* Make sure a valid transport layer is linked. */
-  assert(xcpSettings.transport != NULL);
+  assert(loader != NULL);
+  assert(loader->settings.transport != NULL);
   
   /* Only continue with a valid transport layer and if actually connected. */
-  if ( (xcpSettings.transport != NULL) && (xcpConnected) ) /*lint !e774 */
+  if ( (loader->settings.transport != NULL) && (loader->connected) ) /*lint !e774 */
   {
-    /* End the programming session by sending the program command with size 0. */
-    if (XcpLoaderSendCmdProgram(0, NULL))
+    /* End the programming session by sending the program command with size 0. This
+     * makes the bootloader write the data that it still buffers. On an unreliable
+     * transport layer, the command is resent if it or its response got lost.
+     */
+    result = XcpLoaderSendCmdProgram(loader, 0, NULL);
+    for (retryCnt = 0; (!result) && (loader->unreliable) &&
+                       (retryCnt < XCPLOADER_TRANSFER_RETRIES); retryCnt++)
+    {
+      result = XcpLoaderSendCmdProgram(loader, 0, NULL);
+    }
+    /* Read back the programmed data and check that it is correct. Packets that got
+     * duplicated or reordered on their way to the target could have caused the data
+     * to be programmed at the wrong address.
+     */
+    if ( (result) && (loader->rangeCount > 0) )
+    {
+      result = XcpLoaderVerifyRanges(loader);
+    }
+    if (result)
     {
       /* Disconnect the target. Here the reset command is used instead of the disconnect
        * command, because the bootloader should start the user program on the target.
        */
-      (void)XcpLoaderSendCmdProgramReset();
+      (void)XcpLoaderSendCmdProgramReset(loader);
     }
     /* Disconnect the transport layer. */
-    xcpSettings.transport->Disconnect();
+    if (!loader->keepTransport)
+    {
+      loader->settings.transport->Disconnect(loader->transport);
+      loader->transportConnected = false;
+    }
     /* Reset connection status. */
-    xcpConnected = false;
+    loader->connected = false;
+    loader->rangeCount = 0;
   }
+  /* Give the result back to the caller. */
+  return result;
 } /*** end of XcpLoaderStop ***/
 
 
@@ -474,38 +627,42 @@ static void XcpLoaderStop(void)
 ** \brief     Requests the bootloader to erase the specified range of memory on the
 **            target. The bootloader aligns this range to hardware specified erase 
 **            blocks.
+** \param     handle Handle of the XCP loader object.
 ** \param     address The starting memory address for the erase operation.
 ** \param     len The total number of bytes to erase from memory.
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-static bool XcpLoaderClearMemory(uint32_t address, uint32_t len)
+static bool XcpLoaderClearMemory(void * handle, uint32_t address, uint32_t len)
 {
+  tXcpLoaderObj * loader = (tXcpLoaderObj *)handle;
   bool result = false;
+  uint8_t retryCnt = 0;
   
   /* Check parameters. */
   assert(len > 0);
   /* Make sure a valid transport layer is linked. */
-  assert(xcpSettings.transport != NULL);
+  assert(loader != NULL);
+  assert(loader->settings.transport != NULL);
   
   /* Only continue if a transport layer is linked and the parameters are valid. */
-  if ( (len > 0) && (xcpSettings.transport != NULL) && (xcpConnected) )
+  if ( (len > 0) && (loader->settings.transport != NULL) && (loader->connected) )
   {
-    /* Init the result value to okay and only set it to error when a problem occurred. */
-    result = true;
-    /* First set the MTA pointer. */
-    if (!XcpLoaderSendCmdSetMta(address))
-    {
-      result = false;
-    }
-    /* Now perform the erase operation. */
-    if (result)
+    /* Set the MTA pointer and perform the erase operation. On an unreliable transport
+     * layer, both are repeated if a command or its response got lost. Erasing the
+     * same memory twice does no harm.
+     */
+    do
     {
-      if (!XcpLoaderSendCmdProgramClear(len))
+      result = XcpLoaderSendCmdSetMta(loader, address);
+      if (result)
       {
-        result = false;
+        result = XcpLoaderSendCmdProgramClear(loader, len);
       }
+      retryCnt++;
     }
+    while ( (!result) && (loader->unreliable) &&
+            (retryCnt <= XCPLOADER_TRANSFER_RETRIES) );
   }
   /* Give the result back to the caller. */
   return result;
@@ -516,73 +673,106 @@ static bool XcpLoaderClearMemory(uint32_t address, uint32_t len)
 ** \brief     Requests the bootloader to program the specified data to memory. In case of
 **            non-volatile memory, the application needs to make sure the memory range
 **            was erased beforehand.
+** \param     handle Handle of the XCP loader object.
 ** \param     address The starting memory address for the write operation.
 ** \param     len The number of bytes in the data buffer that should be written.
 ** \param     data Pointer to the byte array with data to write.
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-static bool XcpLoaderWriteData(uint32_t address, uint32_t len, uint8_t const * data)
+static bool XcpLoaderWriteData(void * handle, uint32_t address, uint32_t len,
+                               uint8_t const * data)
 {
+  tXcpLoaderObj * loader = (tXcpLoaderObj *)handle;
   bool result = false;
+  bool mtaValid = false;
+  uint8_t retryCnt = 0;
   uint8_t currentWriteCnt;
   uint32_t bufferOffset = 0;
+  uint32_t totalLen = len;
 
   /* Check parameters. */
   assert(data != NULL);
   assert(len > 0);
   /* Make sure a valid transport layer is linked. */
-  assert(xcpSettings.transport != NULL);
+  assert(loader != NULL);
+  assert(loader->settings.transport != NULL);
   
   /* Only continue if the parameters are valid. */
-  if ( (data != NULL) && (len > 0) && (xcpSettings.transport != NULL) && /*lint !e774 */
-       (xcpConnected) ) 
+  if ( (data != NULL) && (len > 0) && /*lint !e774 */
+       (loader->settings.transport != NULL) && (loader->connected) )
   {
     /* Init the result value to okay and only set it to error when a problem occurred. */
     result = true;
-    /* First set the MTA pointer. */
-    if (!XcpLoaderSendCmdSetMta(address))
+    /* Perform segmented programming of the data. Keep multiple program commands in
+     * flight, if the transport layer supports this. If a command or its response got
+     * lost on an unreliable transport layer, it is not known how far the target got.
+     * In this case the MTA pointer is set again and the entire block is resent.
+     */
+    if ( (loader->settings.transport->GetWindow != NULL) &&
+         (loader->settings.transport->GetWindow(loader->transport) > 1) )
     {
-      result = false;
+      do
+      {
+        result = XcpLoaderSendCmdSetMta(loader, address);
+        if (result)
+        {
+          result = XcpLoaderSendCmdProgramPipelined(loader, len, data);
+        }
+        retryCnt++;
+      }
+      while ( (!result) && (loader->unreliable) &&
+              (retryCnt <= XCPLOADER_TRANSFER_RETRIES) );
     }
-
-    /* Perform segmented programming of the data. */
-    if (result)
+    else
     {
-      while (len > 0)
+      while ( (result) && (len > 0) )
       {
         /* Set the current write length to make optimal use of the available packet 
          * data. 
          */
-        currentWriteCnt = len % (xcpMaxProgCto - 1u);
+        currentWriteCnt = len % (loader->maxProgCto - 1u);
         if (currentWriteCnt == 0)
         {
-          currentWriteCnt = (xcpMaxProgCto - 1u);
+          currentWriteCnt = (loader->maxProgCto - 1u);
         }
-        /* Prepare the packed data for the program command. */
-        if (currentWriteCnt < (xcpMaxProgCto - 1u))
+        /* Set the MTA pointer at the start and after a command got lost. */
+        if (!mtaValid)
         {
-          /* Program data. */
-          if (!XcpLoaderSendCmdProgram(currentWriteCnt, &data[bufferOffset]))
-          {
-            result = false;
-            break;
-          }
+          mtaValid = XcpLoaderSendCmdSetMta(loader, address + bufferOffset);
+        }
+        /* Program the data. */
+        if (mtaValid)
+        {
+          mtaValid = XcpLoaderSendCmdProgramSegment(loader, currentWriteCnt,
+                                                    &data[bufferOffset]);
+        }
+        if (mtaValid)
+        {
+          /* Update loop variables. */
+          len -= currentWriteCnt;
+          bufferOffset += currentWriteCnt;
+          retryCnt = 0;
+        }
+        /* On an unreliable transport layer, it is not known if the target processed
+         * the command of which the response got lost. The MTA pointer is set again
+         * before the segment is resent, so that it ends up at the same address.
+         */
+        else if ( (loader->unreliable) && (retryCnt < XCPLOADER_TRANSFER_RETRIES) )
+        {
+          retryCnt++;
         }
         else
         {
-          /* Program max data. */
-          if (!XcpLoaderSendCmdProgramMax(&data[bufferOffset]))
-          {
-            result = false;
-            break;
-          }
+          result = false;
         }
-        /* Update loop variables. */
-        len -= currentWriteCnt;
-        bufferOffset += currentWriteCnt;
       }
     }
+    /* Keep track of the programmed data, such that it can be verified at the end. */
+    if ( (result) && (loader->unreliable) )
+    {
+      result = XcpLoaderAddRange(loader, address, totalLen, data);
+    }
   }
   /* Give the result back to the caller. */
   return result;
@@ -592,6 +782,7 @@ static bool XcpLoaderWriteData(uint32_t address, uint32_t len, uint8_t const * d
 /************************************************************************************//**
 ** \brief     Request the bootloader to upload the specified range of memory. The data is
 **            stored in the data byte array to which the pointer was specified.
+** \param     handle Handle of the XCP loader object.
 ** \param     address The starting memory address for the read operation.
 ** \param     len The number of bytes to upload from the target and store in the data 
 **            buffer.
@@ -599,9 +790,13 @@ static bool XcpLoaderWriteData(uint32_t address, uint32_t len, uint8_t const * d
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-static bool XcpLoaderReadData(uint32_t address, uint32_t len, uint8_t * data)
+static bool XcpLoaderReadData(void * handle, uint32_t address, uint32_t len,
+                              uint8_t * data)
 {
+  tXcpLoaderObj * loader = (tXcpLoaderObj *)handle;
   bool result = false;
+  bool mtaValid = false;
+  uint8_t retryCnt = 0;
   uint8_t currentReadCnt;
   uint32_t bufferOffset = 0;
 
@@ -609,41 +804,53 @@ static bool XcpLoaderReadData(uint32_t address, uint32_t len, uint8_t * data)
   assert(data != NULL);
   assert(len > 0);
   /* Make sure a valid transport layer is linked. */
-  assert(xcpSettings.transport != NULL);
+  assert(loader != NULL);
+  assert(loader->settings.transport != NULL);
   
   /* Only continue if the parameters are valid. */
-  if ( (data != NULL) && (len > 0) && (xcpSettings.transport != NULL) && /*lint !e774 */
-       (xcpConnected) ) 
+  if ( (data != NULL) && (len > 0) && /*lint !e774 */
+       (loader->settings.transport != NULL) && (loader->connected) )
   {
     /* Init the result value to okay and only set it to error when a problem occurred. */
     result = true;
-    /* First set the MTA pointer. */
-    if (!XcpLoaderSendCmdSetMta(address))
-    {
-      result = false;
-    }
     /* Perform segmented upload of the data. */
-    if (result)
+    while ( (result) && (len > 0) )
     {
-      while (len > 0)
+      /* Set the current read length to make optimal use of the available packet 
+       * data. 
+       */
+      currentReadCnt = len % (uint8_t)(loader->maxDto - 1u);
+      if (currentReadCnt == 0)
+      {
+        currentReadCnt = (uint8_t)(loader->maxDto - 1u);
+      }
+      /* Set the MTA pointer at the start and after a command got lost. */
+      if (!mtaValid)
+      {
+        mtaValid = XcpLoaderSendCmdSetMta(loader, address + bufferOffset);
+      }
+      /* Upload some data */
+      if (mtaValid)
+      {
+        mtaValid = XcpLoaderSendCmdUpload(loader, &data[bufferOffset], currentReadCnt);
+      }
+      if (mtaValid)
       {
-        /* Set the current read length to make optimal use of the available packet 
-         * data. 
-         */
-        currentReadCnt = len % (uint8_t)(xcpMaxDto - 1u);
-        if (currentReadCnt == 0)
-        {
-          currentReadCnt = (uint8_t)(xcpMaxDto - 1u);
-        }
-        /* Upload some data */
-        if (!XcpLoaderSendCmdUpload(&data[bufferOffset], currentReadCnt))
-        {
-          result = false;
-          break;
-        }
         /* Update loop variables. */
         len -= currentReadCnt;
         bufferOffset += currentReadCnt;
+        retryCnt = 0;
+      }
+      /* On an unreliable transport layer, the MTA pointer is set again before the
+       * upload is repeated, because the target possibly already advanced it.
+       */
+      else if ( (loader->unreliable) && (retryCnt < XCPLOADER_TRANSFER_RETRIES) )
+      {
+        retryCnt++;
+      }
+      else
+      {
+        result = false;
       }
     }
   }
@@ -652,14 +859,66 @@ static bool XcpLoaderReadData(uint32_t address, uint32_t len, uint8_t * data)
 } /*** end of XcpLoaderReadData ***/
 
 
+/************************************************************************************//**
+** \brief     Obtains the command/response latency statistics of the session.
+** \param     handle Handle of the XCP loader object.
+** \param     latency Pointer where the statistics are stored.
+**
+****************************************************************************************/
+static void XcpLoaderGetLatency(void * handle, tSessionLatency * latency)
+{
+  tXcpLoaderObj * loader = (tXcpLoaderObj *)handle;
+
+  /* Check parameters. */
+  assert(loader != NULL);
+  assert(latency != NULL);
+
+  /* Only continue if the parameters are valid. */
+  if ( (loader != NULL) && (latency != NULL) ) /*lint !e774 */
+  {
+    *latency = loader->latency;
+  }
+} /*** end of XcpLoaderGetLatency ***/
+
+
+/************************************************************************************//**
+** \brief     Configures if the transport layer stays connected when the session is
+**            stopped. A transport layer that is no longer needed is disconnected right
+**            away, if the session is not running.
+** \param     handle Handle of the XCP loader object.
+** \param     keep True to keep the transport layer connected, false otherwise.
+**
+****************************************************************************************/
+static void XcpLoaderKeepTransport(void * handle, bool keep)
+{
+  tXcpLoaderObj * loader = (tXcpLoaderObj *)handle;
+
+  /* Check parameters. */
+  assert(loader != NULL);
+
+  /* Only continue if the parameters are valid. */
+  if (loader != NULL) /*lint !e774 */
+  {
+    loader->keepTransport = keep;
+    if ( (!keep) && (!loader->connected) && (loader->transportConnected) )
+    {
+      loader->settings.transport->Disconnect(loader->transport);
+      loader->transportConnected = false;
+    }
+  }
+} /*** end of XcpLoaderKeepTransport ***/
+
+
 /************************************************************************************//**
 ** \brief     Stores a 32-bit value into a byte buffer taking into account Intel
 **            or Motorola byte ordering.
+** \param     loader Pointer to the XCP loader object.
 ** \param     value The 32-bit value to store in the buffer.
 ** \param     data Array to the buffer for storage.
 **
 ****************************************************************************************/
-static void XcpLoaderSetOrderedLong(uint32_t value, uint8_t *data)
+static void XcpLoaderSetOrderedLong(tXcpLoaderObj * loader, uint32_t value,
+                                    uint8_t *data)
 {
   /* Check parameters. */
   assert(data != NULL);
@@ -667,7 +926,7 @@ static void XcpLoaderSetOrderedLong(uint32_t value, uint8_t *data)
   /* Only continue with valid parameters. */
   if (data != NULL) /*lint !e774 */
   {
-    if (xcpSlaveIsIntel)
+    if (loader->slaveIsIntel)
     {
       data[3] = (uint8_t)(value >> 24);
       data[2] = (uint8_t)(value >> 16);
@@ -688,11 +947,12 @@ static void XcpLoaderSetOrderedLong(uint32_t value, uint8_t *data)
 /************************************************************************************//**
 ** \brief     Obtains a 16-bit value from a byte buffer taking into account Intel
 **            or Motorola byte ordering.
+** \param     loader Pointer to the XCP loader object.
 ** \param     data Array to the buffer with the word value stored as bytes.
 ** \return    The 16-bit value.
 **
 ****************************************************************************************/
-static uint16_t XcpLoaderGetOrderedWord(uint8_t const * data)
+static uint16_t XcpLoaderGetOrderedWord(tXcpLoaderObj * loader, uint8_t const * data)
 {
   uint16_t result = 0;
 
@@ -702,7 +962,7 @@ static uint16_t XcpLoaderGetOrderedWord(uint8_t const * data)
   /* Only continue with valid parameters. */
   if (data != NULL) /*lint !e774 */
   {
-    if (xcpSlaveIsIntel)
+    if (loader->slaveIsIntel)
     {
       result |= (uint16_t)data[0];
       result |= (uint16_t)(data[1] << 8);
@@ -718,32 +978,437 @@ static uint16_t XcpLoaderGetOrderedWord(uint8_t const * data)
 } /*** end of XcpLoaderGetOrderedWord ***/
 
 
+/************************************************************************************//**
+** \brief     Obtains a 32-bit value from a byte buffer taking into account Intel
+**            or Motorola byte ordering.
+** \param     loader Pointer to the XCP loader object.
+** \param     data Array to the buffer with the long value stored as bytes.
+** \return    The 32-bit value.
+**
+****************************************************************************************/
+static uint32_t XcpLoaderGetOrderedLong(tXcpLoaderObj * loader, uint8_t const * data)
+{
+  uint32_t result = 0;
+
+  /* Check parameters. */
+  assert(data != NULL);
+
+  /* Only continue with valid parameters. */
+  if (data != NULL) /*lint !e774 */
+  {
+    if (loader->slaveIsIntel)
+    {
+      result |= (uint32_t)data[0];
+      result |= (uint32_t)data[1] << 8;
+      result |= (uint32_t)data[2] << 16;
+      result |= (uint32_t)data[3] << 24;
+    }
+    else
+    {
+      result |= (uint32_t)data[3];
+      result |= (uint32_t)data[2] << 8;
+      result |= (uint32_t)data[1] << 16;
+      result |= (uint32_t)data[0] << 24;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpLoaderGetOrderedLong ***/
+
+
+/************************************************************************************//**
+** \brief     Sends an XCP packet via the transport layer and waits for the response to
+**            come back. The command/response time is added to the latency statistics.
+** \param     loader Pointer to the XCP loader object.
+** \param     txPacket Pointer to the packet to transmit.
+** \param     rxPacket Pointer where the received packet info is stored.
+** \param     timeout Maximum time in milliseconds to wait for the reception of the
+**            response packet.
+** \return    True is successful and a response packet was received, false otherwise.
+**
+****************************************************************************************/
+static bool XcpLoaderSendPacket(tXcpLoaderObj * loader,
+                                tXcpTransportPacket const * txPacket,
+                                tXcpTransportPacket * rxPacket, uint16_t timeout)
+{
+  bool result = false;
+  uint64_t startTime;
+
+  /* Make sure a valid transport layer is linked. */
+  assert(loader->settings.transport != NULL);
+
+  /* Only continue with a valid transport layer. */
+  if (loader->settings.transport != NULL) /*lint !e774 */
+  {
+    /* Exchange the packets and measure how long it took. */
+    startTime = UtilTimeGetMonotonicUs();
+    result = loader->settings.transport->SendPacket(loader->transport, txPacket,
+                                                    rxPacket, timeout);
+    /* Only successful exchanges are relevant for the latency statistics. */
+    if (result)
+    {
+      XcpLoaderUpdateLatency(loader, (uint32_t)(UtilTimeGetMonotonicUs() - startTime));
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpLoaderSendPacket ***/
+
+
+/************************************************************************************//**
+** \brief     Sends an XCP packet, that is described by a vector, via the transport layer
+**            and waits for the response to come back. The response is stored in the
+**            buffers of the reception vector. If the transport layer supports vectors,
+**            the packets are not copied. Otherwise the packet is assembled and sent with
+**            XcpLoaderSendPacket().
+** \param     loader Pointer to the XCP loader object.
+** \param     txVector Pointer to the vector of the packet to transmit.
+** \param     rxVector Pointer to the vector where the received packet is stored.
+** \param     timeout Maximum time in milliseconds to wait for the reception of the
+**            response packet.
+** \return    True is successful and a response packet was received, false otherwise.
+**
+****************************************************************************************/
+static bool XcpLoaderSendPacketVector(tXcpLoaderObj * loader,
+                                      tXcpTransportTxVector const * txVector,
+                                      tXcpTransportRxVector * rxVector,
+                                      uint16_t timeout)
+{
+  bool result = false;
+  uint64_t startTime;
+  tXcpTransportPacket txPacket;
+  tXcpTransportPacket rxPacket;
+  uint8_t headCnt;
+  uint8_t dataCnt;
+
+  /* Check parameters. */
+  assert(txVector != NULL);
+  assert(rxVector != NULL);
+  assert((txVector->headLen + txVector->dataLen) <= XCPLOADER_PACKET_SIZE_MAX);
+  /* Make sure a valid transport layer is linked. */
+  assert(loader->settings.transport != NULL);
+
+  /* Only continue with a valid transport layer and valid parameters. */
+  if ( (txVector != NULL) && (rxVector != NULL) &&
+       ((txVector->headLen + txVector->dataLen) <= XCPLOADER_PACKET_SIZE_MAX) &&
+       (loader->settings.transport != NULL) ) /*lint !e774 */
+  {
+    /* Exchange the vectors directly, if supported by the transport layer. */
+    if (loader->settings.transport->SendPacketVector != NULL)
+    {
+      startTime = UtilTimeGetMonotonicUs();
+      result = loader->settings.transport->SendPacketVector(loader->transport, txVector,
+                                                            rxVector, timeout);
+      /* Only successful exchanges are relevant for the latency statistics. */
+      if (result)
+      {
+        XcpLoaderUpdateLatency(loader,
+                               (uint32_t)(UtilTimeGetMonotonicUs() - startTime));
+      }
+    }
+    /* Otherwise assemble the packet and exchange it as a regular packet. */
+    else
+    {
+      memcpy(&txPacket.data[0], txVector->head, txVector->headLen);
+      if (txVector->dataLen > 0)
+      {
+        memcpy(&txPacket.data[txVector->headLen], txVector->data, txVector->dataLen);
+      }
+      txPacket.len = txVector->headLen + txVector->dataLen;
+      result = XcpLoaderSendPacket(loader, &txPacket, &rxPacket, timeout);
+      /* Store the response in the buffers of the reception vector. */
+      if (result)
+      {
+        headCnt = (rxPacket.len < rxVector->headSize) ? rxPacket.len : rxVector->headSize;
+        dataCnt = rxPacket.len - headCnt;
+        if (dataCnt > rxVector->dataSize)
+        {
+          dataCnt = rxVector->dataSize;
+        }
+        memcpy(rxVector->head, &rxPacket.data[0], headCnt);
+        if (dataCnt > 0)
+        {
+          memcpy(rxVector->data, &rxPacket.data[headCnt], dataCnt);
+        }
+        rxVector->len = rxPacket.len;
+      }
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpLoaderSendPacketVector ***/
+
+
+/************************************************************************************//**
+** \brief     Adds a successful command/response exchange to the latency statistics. If
+**            the transport layer knows how much of it was spent on the communication
+**            medium and in the target, this wire time is recorded as well. Otherwise
+**            the entire command/response time counts as wire time.
+** \param     loader Pointer to the XCP loader object.
+** \param     totalTime The command/response time in microseconds.
+**
+****************************************************************************************/
+static void XcpLoaderUpdateLatency(tXcpLoaderObj * loader, uint32_t totalTime)
+{
+  uint32_t wireTime;
+
+  /* Obtain the wire time from the transport layer, if supported. */
+  if ( (loader->settings.transport->GetWireTime == NULL) ||
+       (!loader->settings.transport->GetWireTime(loader->transport, &wireTime)) ||
+       (wireTime > totalTime) )
+  {
+    wireTime = totalTime;
+  }
+  /* Update the statistics. */
+  SessionLatencyAdd(&loader->latency, totalTime, wireTime);
+} /*** end of XcpLoaderUpdateLatency ***/
+
+
+/************************************************************************************//**
+** \brief     Keeps track of data that was programmed, by storing its address range and
+**            checksums. Data that directly follows the previously programmed data is
+**            merged into the same range.
+** \param     loader Pointer to the XCP loader object.
+** \param     address The starting memory address of the programmed data.
+** \param     len The number of bytes that were programmed.
+** \param     data Pointer to the byte array with the programmed data.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+static bool XcpLoaderAddRange(tXcpLoaderObj * loader, uint32_t address, uint32_t len,
+                              uint8_t const * data)
+{
+  bool result = false;
+  tXcpLoaderRange * range = NULL;
+  tXcpLoaderRange * newRanges;
+  uint32_t newSize;
+
+  /* Check parameters. */
+  assert(data != NULL);
+  assert(len > 0);
+
+  /* Only continue if the parameters are valid. */
+  if ( (data != NULL) && (len > 0) ) /*lint !e774 */
+  {
+    /* Init the result value to okay and only set it to error when a problem occurred. */
+    result = true;
+    /* Check if the data continues the last range. */
+    if (loader->rangeCount > 0)
+    {
+      range = &loader->ranges[loader->rangeCount - 1u];
+      if ( (range->address + range->len) != address)
+      {
+        range = NULL;
+      }
+    }
+    /* Add a new range, if the data could not be merged. */
+    if (range == NULL)
+    {
+      /* Make room for the new range, if needed. */
+      if (loader->rangeCount == loader->rangeSize)
+      {
+        newSize = (loader->rangeSize == 0) ? 8u : (loader->rangeSize * 2u);
+        newRanges = realloc(loader->ranges, newSize * sizeof(tXcpLoaderRange));
+        if (newRanges == NULL)
+        {
+          result = false;
+        }
+        else
+        {
+          loader->ranges = newRanges;
+          loader->rangeSize = newSize;
+        }
+      }
+      if (result)
+      {
+        range = &loader->ranges[loader->rangeCount];
+        range->address = address;
+        range->len = 0;
+        range->checksum = 0;
+        range->sum = 0;
+        loader->rangeCount++;
+      }
+    }
+    /* Update the range with the programmed data. */
+    if (result)
+    {
+      range->checksum = UtilChecksumCrc32Update(range->checksum, data, len);
+      for (uint32_t idx = 0; idx < len; idx++)
+      {
+        range->sum += data[idx];
+      }
+      range->len += len;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpLoaderAddRange ***/
+
+
+/************************************************************************************//**
+** \brief     Verifies the data that was programmed during this session. The target is
+**            asked to build the checksum of each range, which is a lot faster than
+**            uploading all data. Only if the target does not support this, or reports a
+**            checksum type that the XCP loader does not know, the data is uploaded
+**            instead.
+** \param     loader Pointer to the XCP loader object.
+** \return    True if all programmed data is correct, false otherwise.
+**
+****************************************************************************************/
+static bool XcpLoaderVerifyRanges(tXcpLoaderObj * loader)
+{
+  bool result = true;
+  bool checksumSupported = true;
+  uint32_t rangeIdx;
+
+  /* Verify the ranges one by one. */
+  for (rangeIdx = 0; (result) && (rangeIdx < loader->rangeCount); rangeIdx++)
+  {
+    if (checksumSupported)
+    {
+      result = XcpLoaderVerifyRangeChecksum(loader, &loader->ranges[rangeIdx],
+                                            &checksumSupported);
+    }
+    /* Fall back to uploading the data, if the checksum could not be used. */
+    if (!checksumSupported)
+    {
+      result = XcpLoaderVerifyRangeUpload(loader, &loader->ranges[rangeIdx]);
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpLoaderVerifyRanges ***/
+
+
+/************************************************************************************//**
+** \brief     Verifies a range of programmed data by asking the target to build the
+**            checksum of the range and comparing it with the one of the data that was
+**            sent. Note that the supported checksum types are sums, which detect data
+**            that is missing, duplicated or shifted, but not data that was swapped
+**            within the range.
+** \param     loader Pointer to the XCP loader object.
+** \param     range Pointer to the range.
+** \param     supported Pointer where is stored if the target supports the checksum. If
+**            not, the range still needs to be verified otherwise.
+** \return    True if the range is correct, false otherwise.
+**
+****************************************************************************************/
+static bool XcpLoaderVerifyRangeChecksum(tXcpLoaderObj * loader,
+                                         tXcpLoaderRange const * range,
+                                         bool * supported)
+{
+  bool result = false;
+  bool received = false;
+  uint8_t retryCnt;
+  uint8_t type = 0;
+  uint32_t checksum = 0;
+
+  /* The target advances the MTA pointer, so it is set again before each attempt. On an
+   * unreliable transport layer, the command is resent if it or its response got lost.
+   */
+  for (retryCnt = 0; (!received) && (retryCnt <= XCPLOADER_TRANSFER_RETRIES); retryCnt++)
+  {
+    received = (XcpLoaderSendCmdSetMta(loader, range->address)) &&
+               (XcpLoaderSendCmdBuildChecksum(loader, range->len, &type, &checksum));
+    if ( (!received) && (!loader->unreliable) )
+    {
+      break;
+    }
+  }
+  /* Compare the checksum with the one of the data that was sent. */
+  *supported = true;
+  if (received)
+  {
+    switch (type)
+    {
+      case XCPLOADER_CHECKSUM_ADD_11:
+        result = (checksum == (range->sum & 0xFFu));
+        break;
+      case XCPLOADER_CHECKSUM_ADD_12:
+        result = (checksum == (range->sum & 0xFFFFu));
+        break;
+      case XCPLOADER_CHECKSUM_ADD_14:
+        result = (checksum == range->sum);
+        break;
+      default:
+        /* Negative response or unknown checksum type. */
+        *supported = false;
+        break;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpLoaderVerifyRangeChecksum ***/
+
+
+/************************************************************************************//**
+** \brief     Verifies a range of programmed data by uploading it and comparing its
+**            checksum with the one of the data that was sent.
+** \param     loader Pointer to the XCP loader object.
+** \param     range Pointer to the range.
+** \return    True if the range is correct, false otherwise.
+**
+****************************************************************************************/
+static bool XcpLoaderVerifyRangeUpload(tXcpLoaderObj * loader,
+                                       tXcpLoaderRange const * range)
+{
+  bool result = true;
+  uint8_t buffer[XCPLOADER_VERIFY_CHUNK_SIZE];
+  uint32_t offset = 0;
+  uint32_t chunkLen;
+  uint32_t checksum = 0;
+
+  /* Upload the range in chunks and calculate its checksum. */
+  while ( (result) && (offset < range->len) )
+  {
+    chunkLen = range->len - offset;
+    if (chunkLen > sizeof(buffer))
+    {
+      chunkLen = sizeof(buffer);
+    }
+    result = XcpLoaderReadData(loader, range->address + offset, chunkLen, buffer);
+    if (result)
+    {
+      checksum = UtilChecksumCrc32Update(checksum, buffer, chunkLen);
+      offset += chunkLen;
+    }
+  }
+  /* Compare it with the checksum of the data that was sent. */
+  if ( (result) && (checksum != range->checksum) )
+  {
+    result = false;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpLoaderVerifyRangeUpload ***/
+
+
 /************************************************************************************//**
 ** \brief     Sends the XCP Connect command.
+** \param     loader Pointer to the XCP loader object.
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-static bool XcpLoaderSendCmdConnect(void)
+static bool XcpLoaderSendCmdConnect(tXcpLoaderObj * loader)
 {
   bool result = false;
   tXcpTransportPacket cmdPacket;
   tXcpTransportPacket resPacket;
 
   /* Make sure a valid transport layer is linked. */
-  assert(xcpSettings.transport != NULL);
+  assert(loader->settings.transport != NULL);
   
   /* Only continue with a valid transport layer. */
-  if (xcpSettings.transport != NULL) /*lint !e774 */
+  if (loader->settings.transport != NULL) /*lint !e774 */
   {
     /* Init the result value to okay and only set it to error when a problem occurred. */
     result = true;
     /* Prepare the command packet. */
     cmdPacket.data[0] = XCPLOADER_CMD_CONNECT;
-    cmdPacket.data[1] = xcpSettings.connectMode;
+    cmdPacket.data[1] = loader->settings.connectMode;
     cmdPacket.len = 2;
     /* Send the packet. */
-    if (!xcpSettings.transport->SendPacket(&cmdPacket, &resPacket, 
-                                           xcpSettings.timeoutT6))
+    if (!XcpLoaderSendPacket(loader, &cmdPacket, &resPacket, loader->settings.timeoutT6))
     {
       /* Could not send packet or receive response within the specified timeout. */
       result = false;
@@ -764,34 +1429,32 @@ static bool XcpLoaderSendCmdConnect(void)
       /* Store slave's byte ordering information. */
       if ((resPacket.data[2] & 0x01) == 0)
       {
-        xcpSlaveIsIntel = true;
+        loader->slaveIsIntel = true;
       }
       else
       {
-        xcpSlaveIsIntel = false;
+        loader->slaveIsIntel = false;
       }
       /* Store max number of bytes the slave allows for master->slave packets. */
-      xcpMaxCto = resPacket.data[3];
-      xcpMaxProgCto = xcpMaxCto;
+      loader->maxCto = resPacket.data[3];
+      loader->maxProgCto = loader->maxCto;
       /* Store max number of bytes the slave allows for slave->master packets. */
-      if (xcpSlaveIsIntel)
+      if (loader->slaveIsIntel)
       {
-        xcpMaxDto = resPacket.data[4] + (resPacket.data[5] << 8);
+        loader->maxDto = resPacket.data[4] + (resPacket.data[5] << 8);
       }
       else
       {
-        xcpMaxDto = resPacket.data[5] + (resPacket.data[4] << 8);
+        loader->maxDto = resPacket.data[5] + (resPacket.data[4] << 8);
       }
-      /* Double check size configuration. CTO length can be adjusted. DTO not. */
-      if (xcpMaxCto > XCPLOADER_PACKET_SIZE_MAX) /*lint !e685 */
-      {
-        xcpMaxCto = XCPLOADER_PACKET_SIZE_MAX;
-      }
-      if (xcpMaxDto > XCPLOADER_PACKET_SIZE_MAX)
+      /* Double check size configuration. The CTO length is stored in a byte, so it
+       * always fits. DTO not.
+       */
+      if (loader->maxDto > XCPLOADER_PACKET_SIZE_MAX)
       {
         result = false;
       }
-      if ( (xcpMaxCto == 0) || (xcpMaxDto == 0) )
+      if ( (loader->maxCto == 0) || (loader->maxDto == 0) )
       {
         result = false;
       }
@@ -805,13 +1468,15 @@ static bool XcpLoaderSendCmdConnect(void)
 /************************************************************************************//**
 ** \brief     Sends the XCP Get Status command. Note that it is okay to specify a NULL
 **            value for the parameters if you are not interested in a particular one.
+** \param     loader Pointer to the XCP loader object.
 ** \param     session Current session status.
 ** \param     protectedResources Current resource protection status.
 ** \param     configId Session configuration identifier.
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-static bool XcpLoaderSendCmdGetStatus(uint8_t * session, uint8_t * protectedResources,
+static bool XcpLoaderSendCmdGetStatus(tXcpLoaderObj * loader, uint8_t * session,
+                                      uint8_t * protectedResources,
                                       uint16_t * configId)
 {
   bool result = false;
@@ -819,10 +1484,10 @@ static bool XcpLoaderSendCmdGetStatus(uint8_t * session, uint8_t * protectedReso
   tXcpTransportPacket resPacket;
 
   /* Make sure a valid transport layer is linked. */
-  assert(xcpSettings.transport != NULL);
+  assert(loader->settings.transport != NULL);
 
   /* Only continue with a valid transport layer. */
-  if (xcpSettings.transport != NULL) /*lint !e774 */
+  if (loader->settings.transport != NULL) /*lint !e774 */
   {
     /* Init the result value to okay and only set it to error when a problem occurred. */
     result = true;
@@ -830,8 +1495,7 @@ static bool XcpLoaderSendCmdGetStatus(uint8_t * session, uint8_t * protectedReso
     cmdPacket.data[0] = XCPLOADER_CMD_GET_STATUS;
     cmdPacket.len = 1;
     /* Send the packet. */
-    if (!xcpSettings.transport->SendPacket(&cmdPacket, &resPacket,
-                                           xcpSettings.timeoutT1))
+    if (!XcpLoaderSendPacket(loader, &cmdPacket, &resPacket, loader->settings.timeoutT1))
     {
       /* Could not send packet or receive response within the specified timeout. */
       result = false;
@@ -862,7 +1526,7 @@ static bool XcpLoaderSendCmdGetStatus(uint8_t * session, uint8_t * protectedReso
       /* Store the session configuration id. */
       if (configId != NULL)
       {
-        *configId = XcpLoaderGetOrderedWord(&resPacket.data[4]);
+        *configId = XcpLoaderGetOrderedWord(loader, &resPacket.data[4]);
       }
     }
   }
@@ -873,6 +1537,7 @@ static bool XcpLoaderSendCmdGetStatus(uint8_t * session, uint8_t * protectedReso
 
 /************************************************************************************//**
 ** \brief     Sends the XCP Get Seed command.
+** \param     loader Pointer to the XCP loader object.
 ** \param     resource The resource to unlock (XCPPROTECT_RESOURCE_xxx).
 ** \param     mode 0 for the first part of the seed, 1 for the remaining part.
 ** \param     seed Pointer to byte array where the received seed is stored.
@@ -880,8 +1545,8 @@ static bool XcpLoaderSendCmdGetStatus(uint8_t * session, uint8_t * protectedReso
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-static bool XcpLoaderSendCmdGetSeed(uint8_t resource, uint8_t mode, uint8_t * seed, 
-                                    uint8_t * seedLen)
+static bool XcpLoaderSendCmdGetSeed(tXcpLoaderObj * loader, uint8_t resource,
+                                    uint8_t mode, uint8_t * seed, uint8_t * seedLen)
 {
   bool result = false;
   uint8_t currentSeedLen;
@@ -889,12 +1554,12 @@ static bool XcpLoaderSendCmdGetSeed(uint8_t resource, uint8_t mode, uint8_t * se
   tXcpTransportPacket resPacket;
 
   /* Make sure a valid transport layer is linked and that the parameters are valid. */
-  assert(xcpSettings.transport != NULL);
+  assert(loader->settings.transport != NULL);
   assert(seed != NULL);
   assert(seedLen != NULL);
 
   /* Only continue with a valid transport layer and parameters. */
-  if ( (xcpSettings.transport != NULL) && (seed != NULL) &&
+  if ( (loader->settings.transport != NULL) && (seed != NULL) &&
        (seedLen != NULL) ) /*lint !e774 */
   {
     /* Only continue with a valid resource value. */
@@ -913,8 +1578,8 @@ static bool XcpLoaderSendCmdGetSeed(uint8_t resource, uint8_t mode, uint8_t * se
       cmdPacket.data[2] = resource;
       cmdPacket.len = 3;
       /* Send the packet. */
-      if (!xcpSettings.transport->SendPacket(&cmdPacket, &resPacket,
-                                             xcpSettings.timeoutT1))
+      if (!XcpLoaderSendPacket(loader, &cmdPacket, &resPacket,
+                               loader->settings.timeoutT1))
       {
         /* Could not send packet or receive response within the specified timeout. */
         result = false;
@@ -923,7 +1588,7 @@ static bool XcpLoaderSendCmdGetSeed(uint8_t resource, uint8_t mode, uint8_t * se
       if (result)
       {
         /* Check if the response was valid. */
-        if ( (resPacket.len <= 2) || (resPacket.len > xcpMaxDto) ||
+        if ( (resPacket.len <= 2) || (resPacket.len > loader->maxDto) ||
              (resPacket.data[0] != XCPLOADER_CMD_PID_RES) )
         {
           /* Not a valid or positive response. */
@@ -937,9 +1602,9 @@ static bool XcpLoaderSendCmdGetSeed(uint8_t resource, uint8_t mode, uint8_t * se
         *seedLen = resPacket.data[1];
         /* Determine the number of seed bytes in the current response */
         currentSeedLen = *seedLen;
-        if (currentSeedLen > ((uint8_t)xcpMaxDto - 2))
+        if (currentSeedLen > ((uint8_t)loader->maxDto - 2))
         {
-          currentSeedLen = ((uint8_t)xcpMaxDto - 2);
+          currentSeedLen = ((uint8_t)loader->maxDto - 2);
         }
         /* Store the seed bytes. */
         for (uint8_t idx = 0; idx < currentSeedLen; idx++)
@@ -956,14 +1621,15 @@ static bool XcpLoaderSendCmdGetSeed(uint8_t resource, uint8_t mode, uint8_t * se
 
 /************************************************************************************//**
 ** \brief     Sends the XCP Unlock command.
+** \param     loader Pointer to the XCP loader object.
 ** \param     key Pointer to a byte array containing the key.
 ** \param     keyLen The length of the key in bytes.
 ** \param     protectedResources Current resource protection status.
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-static bool XcpLoaderSendCmdUnlock(uint8_t const * key, uint8_t keyLen,
-                                   uint8_t * protectedResources)
+static bool XcpLoaderSendCmdUnlock(tXcpLoaderObj * loader, uint8_t const * key,
+                                   uint8_t keyLen, uint8_t * protectedResources)
 {
   bool result = false;
   uint8_t keyCurrentLen;
@@ -971,13 +1637,13 @@ static bool XcpLoaderSendCmdUnlock(uint8_t const * key, uint8_t keyLen,
   tXcpTransportPacket resPacket;
 
   /* Make sure a valid transport layer is linked and that the parameters are valid. */
-  assert(xcpSettings.transport != NULL);
+  assert(loader->settings.transport != NULL);
   assert(key != NULL);
   assert(keyLen > 0);
   assert(protectedResources != NULL);
 
   /* Only continue with a valid transport layer and parameters. */
-  if ( (xcpSettings.transport != NULL) && (key != NULL) && (keyLen > 0) &&
+  if ( (loader->settings.transport != NULL) && (key != NULL) && (keyLen > 0) &&
        (protectedResources != NULL) ) /*lint !e774 */
   {
     /* Init the result value to okay and only set it to error when a problem occurred. */
@@ -987,9 +1653,9 @@ static bool XcpLoaderSendCmdUnlock(uint8_t const * key, uint8_t keyLen,
     cmdPacket.data[1] = keyLen;
     /* Determine number of key bytes for the packet. */
     keyCurrentLen = keyLen;
-    if (keyCurrentLen > (xcpMaxCto - 2))
+    if (keyCurrentLen > (loader->maxCto - 2))
     {
-      keyCurrentLen = xcpMaxCto - 2;
+      keyCurrentLen = loader->maxCto - 2;
     }
     /* Copy key bytes. */
     for (uint8_t idx = 0; idx < keyCurrentLen; idx++)
@@ -998,8 +1664,7 @@ static bool XcpLoaderSendCmdUnlock(uint8_t const * key, uint8_t keyLen,
     }
     cmdPacket.len = keyCurrentLen + 2;
     /* Send the packet. */
-    if (!xcpSettings.transport->SendPacket(&cmdPacket, &resPacket,
-                                           xcpSettings.timeoutT1))
+    if (!XcpLoaderSendPacket(loader, &cmdPacket, &resPacket, loader->settings.timeoutT1))
     {
       /* Could not send packet or receive response within the specified timeout. */
       result = false;
@@ -1027,21 +1692,22 @@ static bool XcpLoaderSendCmdUnlock(uint8_t const * key, uint8_t keyLen,
 
 /************************************************************************************//**
 ** \brief     Sends the XCP Set MTA command.
+** \param     loader Pointer to the XCP loader object.
 ** \param     address New MTA address for the slave.
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-static bool XcpLoaderSendCmdSetMta(uint32_t address)
+static bool XcpLoaderSendCmdSetMta(tXcpLoaderObj * loader, uint32_t address)
 {
   bool result = false;
   tXcpTransportPacket cmdPacket;
   tXcpTransportPacket resPacket;
 
   /* Make sure a valid transport layer is linked. */
-  assert(xcpSettings.transport != NULL);
+  assert(loader->settings.transport != NULL);
   
   /* Only continue with a valid transport layer. */
-  if (xcpSettings.transport != NULL) /*lint !e774 */
+  if (loader->settings.transport != NULL) /*lint !e774 */
   {
     /* Init the result value to okay and only set it to error when a problem occurred. */
     result = true;
@@ -1051,11 +1717,10 @@ static bool XcpLoaderSendCmdSetMta(uint32_t address)
     cmdPacket.data[2] = 0; /* Reserved. */
     cmdPacket.data[3] = 0; /* Address extension not supported. */
     /* Set the address taking into account byte ordering. */
-    XcpLoaderSetOrderedLong(address, &cmdPacket.data[4]);
+    XcpLoaderSetOrderedLong(loader, address, &cmdPacket.data[4]);
     cmdPacket.len = 8;
     /* Send the packet. */
-    if (!xcpSettings.transport->SendPacket(&cmdPacket, &resPacket, 
-                                           xcpSettings.timeoutT1))
+    if (!XcpLoaderSendPacket(loader, &cmdPacket, &resPacket, loader->settings.timeoutT1))
     {
       /* Could not send packet or receive response within the specified timeout. */
       result = false;
@@ -1078,37 +1743,50 @@ static bool XcpLoaderSendCmdSetMta(uint32_t address)
 
 /************************************************************************************//**
 ** \brief     Sends the XCP UPLOAD command.
+** \param     loader Pointer to the XCP loader object.
 ** \param     data Destination data buffer.
 ** \param     length Number of bytes to upload.
 ** \return    SB_TRUE is successfull, SB_FALSE otherwise.
 **
 ****************************************************************************************/
-static bool XcpLoaderSendCmdUpload(uint8_t * data, uint8_t length)
+static bool XcpLoaderSendCmdUpload(tXcpLoaderObj * loader, uint8_t * data,
+                                   uint8_t length)
 {
   bool result = false;
-  tXcpTransportPacket cmdPacket;
-  tXcpTransportPacket resPacket;
-  uint8_t dataIdx;
+  uint8_t cmdHead[2];
+  uint8_t resHead;
+  tXcpTransportTxVector cmdVector;
+  tXcpTransportRxVector resVector;
 
   /* Cannot request more data then the max rx data - 1. */
-  assert(length < xcpMaxDto);
+  assert(length < loader->maxDto);
   assert(data != NULL);
   /* Make sure a valid transport layer is linked. */
-  assert(xcpSettings.transport != NULL);
+  assert(loader->settings.transport != NULL);
   
   /* Only continue with a valid transport layer and valid parameters. */
-  if ( (length < xcpMaxDto) && (data != NULL) && 
-       (xcpSettings.transport != NULL) ) /*lint !e774 */
+  if ( (length < loader->maxDto) && (data != NULL) && 
+       (loader->settings.transport != NULL) ) /*lint !e774 */
   {
     /* Init the result value to okay and only set it to error when a problem occurred. */
     result = true;
     /* Prepare the command packet. */
-    cmdPacket.data[0] = XCPLOADER_CMD_UPLOAD;
-    cmdPacket.data[1] = length;
-    cmdPacket.len = 2;
+    cmdHead[0] = XCPLOADER_CMD_UPLOAD;
+    cmdHead[1] = length;
+    cmdVector.head = cmdHead;
+    cmdVector.headLen = 2;
+    cmdVector.data = NULL;
+    cmdVector.dataLen = 0;
+    /* Prepare the response packet. The uploaded data follows the packet identifier
+     * and is stored directly in the destination data buffer.
+     */
+    resVector.head = &resHead;
+    resVector.headSize = 1;
+    resVector.data = data;
+    resVector.dataSize = length;
     /* Send the packet. */
-    if (!xcpSettings.transport->SendPacket(&cmdPacket, &resPacket, 
-                                           xcpSettings.timeoutT1))
+    if (!XcpLoaderSendPacketVector(loader, &cmdVector, &resVector,
+                                   loader->settings.timeoutT1))
     {
       /* Could not send packet or receive response within the specified timeout. */
       result = false;
@@ -1117,43 +1795,89 @@ static bool XcpLoaderSendCmdUpload(uint8_t * data, uint8_t length)
     if (result)
     {
       /* Check if the response was valid. */
-      if ( (resPacket.len == 0) || (resPacket.data[0] != XCPLOADER_CMD_PID_RES) )
+      if ( (resVector.len < (length + 1u)) || (resHead != XCPLOADER_CMD_PID_RES) )
       {
         /* Not a valid or positive response. */
         result = false;
       }
     }
-    
-    /* Now store the uploaded data. */
-    if (result)
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpLoaderSendCmdUpload ***/
+
+
+/************************************************************************************//**
+** \brief     Sends the XCP BUILD CHECKSUM command. The target builds the checksum of the
+**            block that starts at the MTA pointer and advances the MTA pointer.
+** \param     loader Pointer to the XCP loader object.
+** \param     blockSize Number of bytes in the block.
+** \param     type Pointer where the checksum type is stored. It is set to 0, if the
+**            target responded with a negative response.
+** \param     checksum Pointer where the checksum is stored.
+** \return    True if a positive or negative response was received, false otherwise.
+**
+****************************************************************************************/
+static bool XcpLoaderSendCmdBuildChecksum(tXcpLoaderObj * loader, uint32_t blockSize,
+                                          uint8_t * type, uint32_t * checksum)
+{
+  bool result = false;
+  tXcpTransportPacket cmdPacket;
+  tXcpTransportPacket resPacket;
+
+  /* Check parameters. */
+  assert(type != NULL);
+  assert(checksum != NULL);
+  /* Make sure a valid transport layer is linked. */
+  assert(loader->settings.transport != NULL);
+
+  /* Only continue with a valid transport layer and valid parameters. */
+  if ( (type != NULL) && (checksum != NULL) && /*lint !e774 */
+       (loader->settings.transport != NULL) )
+  {
+    /* Prepare the command packet. */
+    cmdPacket.data[0] = XCPLOADER_CMD_BUILD_CHECKSUM;
+    cmdPacket.data[1] = 0; /* Reserved. */
+    cmdPacket.data[2] = 0; /* Reserved. */
+    cmdPacket.data[3] = 0; /* Reserved. */
+    /* Set the block size taking into account byte ordering. */
+    XcpLoaderSetOrderedLong(loader, blockSize, &cmdPacket.data[4]);
+    cmdPacket.len = 8;
+    /* Send the packet. */
+    if (XcpLoaderSendPacket(loader, &cmdPacket, &resPacket, loader->settings.timeoutT1))
     {
-      for (dataIdx = 0; dataIdx < length; dataIdx++)
+      result = true;
+      *type = 0;
+      /* Extract the checksum from a valid positive response. */
+      if ( (resPacket.len >= 8) && (resPacket.data[0] == XCPLOADER_CMD_PID_RES) )
       {
-        data[dataIdx] = resPacket.data[dataIdx + 1];
+        *type = resPacket.data[1];
+        *checksum = XcpLoaderGetOrderedLong(loader, &resPacket.data[4]);
       }
     }
   }
   /* Give the result back to the caller. */
   return result;
-} /*** end of XcpLoaderSendCmdUpload ***/
+} /*** end of XcpLoaderSendCmdBuildChecksum ***/
 
 
 /************************************************************************************//**
 ** \brief     Sends the XCP PROGRAM START command.
+** \param     loader Pointer to the XCP loader object.
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-static bool XcpLoaderSendCmdProgramStart(void)
+static bool XcpLoaderSendCmdProgramStart(tXcpLoaderObj * loader)
 {
   bool result = false;
   tXcpTransportPacket cmdPacket;
   tXcpTransportPacket resPacket;
 
   /* Make sure a valid transport layer is linked. */
-  assert(xcpSettings.transport != NULL);
+  assert(loader->settings.transport != NULL);
   
   /* Only continue with a valid transport layer. */
-  if (xcpSettings.transport != NULL) /*lint !e774 */
+  if (loader->settings.transport != NULL) /*lint !e774 */
   {
     /* Init the result value to okay and only set it to error when a problem occurred. */
     result = true;
@@ -1161,8 +1885,7 @@ static bool XcpLoaderSendCmdProgramStart(void)
     cmdPacket.data[0] = XCPLOADER_CMD_PROGRAM_START;
     cmdPacket.len = 1;
     /* Send the packet. */
-    if (!xcpSettings.transport->SendPacket(&cmdPacket, &resPacket, 
-                                           xcpSettings.timeoutT3))
+    if (!XcpLoaderSendPacket(loader, &cmdPacket, &resPacket, loader->settings.timeoutT3))
     {
       /* Could not send packet or receive response within the specified timeout. */
       result = false;
@@ -1181,11 +1904,7 @@ static bool XcpLoaderSendCmdProgramStart(void)
     /* Store max number of bytes the slave allows for master->slave packets during the
      * programming session.
      */
-    xcpMaxProgCto = resPacket.data[3];
-    if (xcpMaxProgCto > XCPLOADER_PACKET_SIZE_MAX) /*lint !e685 */
-    {
-      xcpMaxProgCto = XCPLOADER_PACKET_SIZE_MAX;
-    }
+    loader->maxProgCto = resPacket.data[3];
   }  
   /* Give the result back to the caller. */
   return result;
@@ -1195,20 +1914,21 @@ static bool XcpLoaderSendCmdProgramStart(void)
 /************************************************************************************//**
 ** \brief     Sends the XCP PROGRAM RESET command. Note that this command is a bit
 **            different as in it does not require a response.
+** \param     loader Pointer to the XCP loader object.
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-static bool XcpLoaderSendCmdProgramReset(void)
+static bool XcpLoaderSendCmdProgramReset(tXcpLoaderObj * loader)
 {
   bool result = false;
   tXcpTransportPacket cmdPacket;
   tXcpTransportPacket resPacket;
 
   /* Make sure a valid transport layer is linked. */
-  assert(xcpSettings.transport != NULL);
+  assert(loader->settings.transport != NULL);
   
   /* Only continue with a valid transport layer. */
-  if (xcpSettings.transport != NULL) /*lint !e774 */
+  if (loader->settings.transport != NULL) /*lint !e774 */
   {
     /* Init the result value to okay and only set it to error when a problem occurred. */
     result = true;
@@ -1219,8 +1939,7 @@ static bool XcpLoaderSendCmdProgramReset(void)
      * allowed for the program reset command. Just make sure to only process the 
      * response if one was actually received.
      */
-    if (xcpSettings.transport->SendPacket(&cmdPacket, &resPacket, 
-                                           xcpSettings.timeoutT5))
+    if (XcpLoaderSendPacket(loader, &cmdPacket, &resPacket, loader->settings.timeoutT5))
     {
       /* Still here so a response was received. check if the reponse was valid. */
       if ( (resPacket.len != 1) || (resPacket.data[0] != XCPLOADER_CMD_PID_RES) )
@@ -1237,50 +1956,53 @@ static bool XcpLoaderSendCmdProgramReset(void)
 
 /************************************************************************************//**
 ** \brief     Sends the XCP PROGRAM command.
+** \param     loader Pointer to the XCP loader object.
 ** \param     length Number of bytes in the data array to program.
 ** \param     data Array with data bytes to program.
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-static bool XcpLoaderSendCmdProgram(uint8_t length, uint8_t const * data)
+static bool XcpLoaderSendCmdProgram(tXcpLoaderObj * loader, uint8_t length,
+                                    uint8_t const * data)
 {
   bool result = false;
-  tXcpTransportPacket cmdPacket;
+  uint8_t cmdHead[2];
+  tXcpTransportTxVector cmdVector;
   tXcpTransportPacket resPacket;
-  uint8_t cnt;
+  tXcpTransportRxVector resVector;
 
   /* Verify that this number of bytes actually fits in this command. */
-  assert((length <= (xcpMaxProgCto-2)) && 
-         (xcpMaxProgCto <= XCPLOADER_PACKET_SIZE_MAX)); /*lint !e685 */
+  assert(length <= (loader->maxProgCto-2));
   if (length > 0)
   {
     assert(data != NULL);
   }
   /* Make sure a valid transport layer is linked. */
-  assert(xcpSettings.transport != NULL);
+  assert(loader->settings.transport != NULL);
   
   /* Only continue with a valid transport layer and valid parameters. */
-  if ( (length <= (xcpMaxProgCto-2)) && 
-       (xcpMaxProgCto <= XCPLOADER_PACKET_SIZE_MAX) && /*lint !e685 */
-       (xcpSettings.transport != NULL) )/*lint !e774 */ 
+  if ( (length <= (loader->maxProgCto-2)) && 
+       (loader->settings.transport != NULL) )/*lint !e774 */ 
   {
     /* Init the result value to okay and only set it to error when a problem occurred. */
     result = true;
-    /* Prepare the command packet */
-    cmdPacket.data[0] = XCPLOADER_CMD_PROGRAM;
-    cmdPacket.data[1] = length;
-    /* Only access data if it is not a NULL pointer. */
-    if (data != NULL)
-    {
-      for (cnt=0; cnt<length; cnt++)
-      {
-        cmdPacket.data[cnt+2] = data[cnt];
-      }
-    }
-    cmdPacket.len = length + 2;
+    /* Prepare the command packet. The data is not copied, but referenced where it is
+     * stored. Only access data if it is not a NULL pointer.
+     */
+    cmdHead[0] = XCPLOADER_CMD_PROGRAM;
+    cmdHead[1] = length;
+    cmdVector.head = cmdHead;
+    cmdVector.headLen = 2;
+    cmdVector.data = data;
+    cmdVector.dataLen = (data != NULL) ? length : 0;
+    /* Prepare the response packet. */
+    resVector.head = resPacket.data;
+    resVector.headSize = sizeof(resPacket.data);
+    resVector.data = NULL;
+    resVector.dataSize = 0;
     /* Send the packet. */
-    if (!xcpSettings.transport->SendPacket(&cmdPacket, &resPacket, 
-                                           xcpSettings.timeoutT5))
+    if (!XcpLoaderSendPacketVector(loader, &cmdVector, &resVector,
+                                   loader->settings.timeoutT5))
     {
       /* Could not send packet or receive response within the specified timeout. */
       result = false;
@@ -1289,7 +2011,7 @@ static bool XcpLoaderSendCmdProgram(uint8_t length, uint8_t const * data)
     if (result)
     {
       /* Check if the response was valid. */
-      if ( (resPacket.len != 1) || (resPacket.data[0] != XCPLOADER_CMD_PID_RES) )
+      if ( (resVector.len != 1) || (resPacket.data[0] != XCPLOADER_CMD_PID_RES) )
       {
         /* Not a valid or positive response. */
         result = false;
@@ -1303,36 +2025,42 @@ static bool XcpLoaderSendCmdProgram(uint8_t length, uint8_t const * data)
 
 /************************************************************************************//**
 ** \brief     Sends the XCP PROGRAM MAX command.
+** \param     loader Pointer to the XCP loader object.
 ** \param     data Array with data bytes to program.
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-static bool XcpLoaderSendCmdProgramMax(uint8_t const * data)
+static bool XcpLoaderSendCmdProgramMax(tXcpLoaderObj * loader, uint8_t const * data)
 {
   bool result = false;
-  tXcpTransportPacket cmdPacket;
+  uint8_t cmdHead;
+  tXcpTransportTxVector cmdVector;
   tXcpTransportPacket resPacket;
-  uint8_t cnt;
+  tXcpTransportRxVector resVector;
 
-  /* verify that this number of bytes actually fits in this command */
-  assert(xcpMaxProgCto <= XCPLOADER_PACKET_SIZE_MAX); /*lint !e685 */
+  /* Check parameters. */
   assert(data != NULL);
   /* Only continue with a valid transport layer and valid parameters. */
-  if ( (xcpMaxProgCto <= XCPLOADER_PACKET_SIZE_MAX) && (data != NULL) && /*lint !e685 */
-       (xcpSettings.transport != NULL) )/*lint !e774 */
+  if ( (data != NULL) && (loader->settings.transport != NULL) )/*lint !e774 */
   {
     /* Init the result value to okay and only set it to error when a problem occurred. */
     result = true;
-    /* Prepare the command packet. */
-    cmdPacket.data[0] = XCPLOADER_CMD_PROGRAM_MAX;
-    for (cnt = 0; cnt < (xcpMaxProgCto-1); cnt++)
-    {
-      cmdPacket.data[cnt+1] = data[cnt];
-    }
-    cmdPacket.len = xcpMaxProgCto;
+    /* Prepare the command packet. The data is not copied, but referenced where it is
+     * stored.
+     */
+    cmdHead = XCPLOADER_CMD_PROGRAM_MAX;
+    cmdVector.head = &cmdHead;
+    cmdVector.headLen = 1;
+    cmdVector.data = data;
+    cmdVector.dataLen = loader->maxProgCto - 1u;
+    /* Prepare the response packet. */
+    resVector.head = resPacket.data;
+    resVector.headSize = sizeof(resPacket.data);
+    resVector.data = NULL;
+    resVector.dataSize = 0;
     /* Send the packet. */
-    if (!xcpSettings.transport->SendPacket(&cmdPacket, &resPacket, 
-                                           xcpSettings.timeoutT5))
+    if (!XcpLoaderSendPacketVector(loader, &cmdVector, &resVector,
+                                   loader->settings.timeoutT5))
     {
       /* Could not send packet or receive response within the specified timeout. */
       result = false;
@@ -1341,7 +2069,7 @@ static bool XcpLoaderSendCmdProgramMax(uint8_t const * data)
     if (result)
     {
       /* Check if the response was valid. */
-      if ( (resPacket.len != 1) || (resPacket.data[0] != XCPLOADER_CMD_PID_RES) )
+      if ( (resVector.len != 1) || (resPacket.data[0] != XCPLOADER_CMD_PID_RES) )
       {
         /* Not a valid or positive response. */
         result = false;
@@ -1353,20 +2081,163 @@ static bool XcpLoaderSendCmdProgramMax(uint8_t const * data)
 } /*** end of XcpLoaderSendCmdProgramMax ***/
 
 
+/************************************************************************************//**
+** \brief     Sends a segment of data to program, using the XCP PROGRAM MAX command if
+**            the segment fills the entire packet, or the XCP PROGRAM command otherwise.
+** \param     loader Pointer to the XCP loader object.
+** \param     length Number of bytes in the data array to program.
+** \param     data Array with data bytes to program.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+static bool XcpLoaderSendCmdProgramSegment(tXcpLoaderObj * loader, uint8_t length,
+                                           uint8_t const * data)
+{
+  bool result;
+
+  if (length < (loader->maxProgCto - 1u))
+  {
+    /* Program data. */
+    result = XcpLoaderSendCmdProgram(loader, length, data);
+  }
+  else
+  {
+    /* Program max data. */
+    result = XcpLoaderSendCmdProgramMax(loader, data);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpLoaderSendCmdProgramSegment ***/
+
+
+/************************************************************************************//**
+** \brief     Sends the XCP PROGRAM and PROGRAM MAX commands for programming the
+**            specified data, with multiple commands in flight. A new command is sent
+**            as long as the transport layer's window is not yet full. Otherwise the
+**            response to the oldest command is collected first. The target processes
+**            the commands in order, so the MTA advances in the same way as with the
+**            regular segmented programming.
+** \param     loader Pointer to the XCP loader object.
+** \param     len The number of bytes in the data buffer that should be written.
+** \param     data Pointer to the byte array with data to write.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+static bool XcpLoaderSendCmdProgramPipelined(tXcpLoaderObj * loader, uint32_t len,
+                                             uint8_t const * data)
+{
+  bool result = false;
+  uint8_t cmdHead[2];
+  tXcpTransportTxVector cmdVector;
+  tXcpTransportPacket resPacket;
+  uint32_t window;
+  uint32_t inFlight = 0;
+  uint32_t bufferOffset = 0;
+  uint8_t currentWriteCnt;
+
+  /* Check parameters. */
+  assert(data != NULL);
+  /* Make sure a valid transport layer is linked that supports pipelining. */
+  assert(loader->settings.transport != NULL);
+  assert(loader->settings.transport->GetWindow != NULL);
+  assert(loader->settings.transport->SubmitPacket != NULL);
+  assert(loader->settings.transport->CollectPacket != NULL);
+
+  /* Only continue with a valid transport layer and valid parameters. */
+  if ( (data != NULL) &&
+       (loader->settings.transport != NULL) && /*lint !e774 */
+       (loader->settings.transport->GetWindow != NULL) &&
+       (loader->settings.transport->SubmitPacket != NULL) &&
+       (loader->settings.transport->CollectPacket != NULL) )
+  {
+    /* Init the result value to okay and only set it to error when a problem occurred. */
+    result = true;
+    window = loader->settings.transport->GetWindow(loader->transport);
+    /* Keep going until all data is sent and all responses are collected. */
+    while ( (result) && ((len > 0) || (inFlight > 0)) )
+    {
+      /* Send the next command, if there is still room in the window. */
+      if ( (len > 0) && (inFlight < window) )
+      {
+        /* Set the current write length to make optimal use of the available packet 
+         * data. 
+         */
+        currentWriteCnt = len % (loader->maxProgCto - 1u);
+        if (currentWriteCnt == 0)
+        {
+          currentWriteCnt = (loader->maxProgCto - 1u);
+        }
+        /* Prepare the command packet. The data is not copied, but referenced where
+         * it is stored. It stays valid until all responses are collected.
+         */
+        if (currentWriteCnt < (loader->maxProgCto - 1u))
+        {
+          cmdHead[0] = XCPLOADER_CMD_PROGRAM;
+          cmdHead[1] = currentWriteCnt;
+          cmdVector.headLen = 2;
+        }
+        else
+        {
+          cmdHead[0] = XCPLOADER_CMD_PROGRAM_MAX;
+          cmdVector.headLen = 1;
+        }
+        cmdVector.head = cmdHead;
+        cmdVector.data = &data[bufferOffset];
+        cmdVector.dataLen = currentWriteCnt;
+        /* Send the packet. */
+        if (!loader->settings.transport->SubmitPacket(loader->transport, &cmdVector))
+        {
+          result = false;
+        }
+        else
+        {
+          /* Update loop variables. */
+          inFlight++;
+          len -= currentWriteCnt;
+          bufferOffset += currentWriteCnt;
+        }
+      }
+      /* Collect the response to the oldest command. */
+      else
+      {
+        if (!loader->settings.transport->CollectPacket(loader->transport, &resPacket, 1,
+                                                       loader->settings.timeoutT5))
+        {
+          /* Could not receive the response within the specified timeout. */
+          result = false;
+        }
+        else if ( (resPacket.len != 1) || (resPacket.data[0] != XCPLOADER_CMD_PID_RES) )
+        {
+          /* Not a valid or positive response. */
+          result = false;
+        }
+        else
+        {
+          inFlight--;
+        }
+      }
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpLoaderSendCmdProgramPipelined ***/
+
+
 /************************************************************************************//**
 ** \brief     Sends the XCP PROGRAM CLEAR command.
+** \param     loader Pointer to the XCP loader object.
 ** \param     length Number of elements to clear starting at the MTA address.
 ** \return    True if successful, false otherwise.
 **
 ****************************************************************************************/
-static bool XcpLoaderSendCmdProgramClear(uint32_t length)
+static bool XcpLoaderSendCmdProgramClear(tXcpLoaderObj * loader, uint32_t length)
 {
   bool result = false;
   tXcpTransportPacket cmdPacket;
   tXcpTransportPacket resPacket;
 
   /* Only continue with a valid transport layer. */
-  if (xcpSettings.transport != NULL) /*lint !e774 */
+  if (loader->settings.transport != NULL) /*lint !e774 */
   {
     /* Init the result value to okay and only set it to error when a problem occurred. */
     result = true;
@@ -1376,11 +2247,10 @@ static bool XcpLoaderSendCmdProgramClear(uint32_t length)
     cmdPacket.data[2] = 0; /* Reserved. */
     cmdPacket.data[3] = 0; /* Reserved. */
     /* Set the erase length taking into account byte ordering. */
-    XcpLoaderSetOrderedLong(length, &cmdPacket.data[4]);
+    XcpLoaderSetOrderedLong(loader, length, &cmdPacket.data[4]);
     cmdPacket.len = 8;
     /* Send the packet. */
-    if (!xcpSettings.transport->SendPacket(&cmdPacket, &resPacket, 
-                                           xcpSettings.timeoutT4))
+    if (!XcpLoaderSendPacket(loader, &cmdPacket, &resPacket, loader->settings.timeoutT4))
     {
       /* Could not send packet or receive response within the specified timeout. */
       result = false;
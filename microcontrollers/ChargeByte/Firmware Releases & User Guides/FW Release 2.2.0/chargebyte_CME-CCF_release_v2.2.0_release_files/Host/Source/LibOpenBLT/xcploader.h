@@ -65,20 +65,88 @@ typedef struct t_xcp_transport_packet
   uint8_t len;                                   /**< Packet length.                   */
 } tXcpTransportPacket;
 
-/** \brief XCP transport layer. */
+/** \brief XCP transport layer packet for transmission, that is made up of two separate
+ *         parts: the head with the command code and its parameters, followed by the
+ *         data. The data is referenced where it is stored, for example in a firmware
+ *         segment, so that it does not need to be copied into a packet first.
+ */
+typedef struct t_xcp_transport_tx_vector
+{
+  uint8_t const * head;                          /**< Packet head.                     */
+  uint8_t const * data;                          /**< Packet data. Can be NULL.        */
+  uint8_t headLen;                               /**< Number of bytes in the head.     */
+  uint8_t dataLen;                               /**< Number of bytes in the data.     */
+} tXcpTransportTxVector;
+
+/** \brief XCP transport layer packet for reception, that is stored in two separate
+ *         buffers provided by the caller. The first bytes of the packet are stored in
+ *         the head buffer and the remaining ones in the data buffer, for example the
+ *         destination of uploaded data. Bytes that do not fit are dropped. The length
+ *         is always set to the full length of the received packet.
+ */
+typedef struct t_xcp_transport_rx_vector
+{
+  uint8_t * head;                                /**< Buffer for the packet head.      */
+  uint8_t * data;                                /**< Buffer for the packet data.      */
+  uint8_t headSize;                              /**< Size of the head buffer.         */
+  uint8_t dataSize;                              /**< Size of the data buffer.         */
+  uint8_t len;                                   /**< Length of the received packet.   */
+} tXcpTransportRxVector;
+
+/** \brief XCP transport layer. Each initialization creates a new transport layer
+ *         object. Its handle is passed as the first parameter to the other functions.
+ */
 typedef struct t_xcp_transport
 {
-  /** \brief Initialization of the XCP transport layer. */
-  void (*Init) (void const * settings);
+  /** \brief Initialization of the XCP transport layer. Returns the handle of the
+   *         transport layer object or NULL in case of an error.
+   */
+  void * (*Init) (void const * settings);
   /** \brief Termination the XCP transport layer. */
-  void (*Terminate) (void);
+  void (*Terminate) (void * handle);
   /** \brief Connects the XCP transport layer. */
-  bool (*Connect) (void);
+  bool (*Connect) (void * handle);
   /** \brief Disconnects the XCP transport layer. */
-  void (*Disconnect) (void);
+  void (*Disconnect) (void * handle);
   /** \brief Sends an XCP packet and waits for the response to come back. */
-  bool (*SendPacket) (tXcpTransportPacket const * txPacket, 
+  bool (*SendPacket) (void * handle, tXcpTransportPacket const * txPacket, 
                       tXcpTransportPacket * rxPacket, uint16_t timeout);
+  /** \brief Obtains the time in microseconds that the last packet exchange spent on
+   *         the communication medium and in the target, so without the processing time
+   *         on the host. Returns false if unknown. Optional and can be NULL.
+   */
+  bool (*GetWireTime) (void * handle, uint32_t * wireTime);
+  /** \brief Obtains the maximum number of packets that can be in flight, as configured
+   *         for the transport layer. A value of 1 means that pipelining is disabled.
+   *         Optional and can be NULL, in which case SubmitPacket and CollectPacket are
+   *         not used.
+   */
+  uint32_t (*GetWindow) (void * handle);
+  /** \brief Sends an XCP packet without waiting for the response to come back. The
+   *         head of the packet can be reused right away, but its data must stay valid
+   *         until the response is collected. Optional and can be NULL.
+   */
+  bool (*SubmitPacket) (void * handle, tXcpTransportTxVector const * txVector);
+  /** \brief Waits for the response to the oldest packet that is still in flight. The
+   *         length of a positive response is specified, because a transport layer
+   *         might need it to locate the response in a stream. Optional and can be NULL.
+   */
+  bool (*CollectPacket) (void * handle, tXcpTransportPacket * rxPacket,
+                         uint8_t resLen, uint16_t timeout);
+  /** \brief Sends an XCP packet and waits for the response to come back, without
+   *         first copying the packets from and to the buffers of the caller. Optional
+   *         and can be NULL, in which case the packets are copied and SendPacket is
+   *         used.
+   */
+  bool (*SendPacketVector) (void * handle, tXcpTransportTxVector const * txVector,
+                            tXcpTransportRxVector * rxVector, uint16_t timeout);
+  /** \brief Determines if packets can get lost, duplicated or reordered on their way
+   *         to or from the target. The XCP loader then resends program and upload
+   *         commands that got lost and verifies the programmed data, before it ends
+   *         the programming session. Optional and can be NULL, in which case each
+   *         packet arrives once and in order, or not at all.
+   */
+  bool (*IsUnreliable) (void * handle);
 } tXcpTransport;
 
 /** \brief XCP protocol specific settings. */
@@ -44,15 +44,24 @@ extern "C" {
 #define XCPPROTECT_RESOURCE_CALPAG     (0x01u)   /**< CALibration and PAGing resource. */
 
 
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Handle of an XCP protection object. Each object loads its own instance of the
+ *         seed and key shared library.
+ */
+typedef void * tXcpProtectHandle;
+
+
 /****************************************************************************************
 * Function prototypes
 ****************************************************************************************/
-void XcpProtectInit(char const * seedKeyFile);
-void XcpProtectTerminate(void);
-bool XCPProtectComputeKeyFromSeed(uint8_t resource, uint8_t seedLen,
-                                  uint8_t const * seedPtr, uint8_t * keyLenPtr,
-                                  uint8_t * keyPtr);
-bool XcpProtectGetPrivileges(uint8_t * resourcePtr);
+tXcpProtectHandle XcpProtectInit(char const * seedKeyFile);
+void XcpProtectTerminate(tXcpProtectHandle handle);
+bool XCPProtectComputeKeyFromSeed(tXcpProtectHandle handle, uint8_t resource,
+                                  uint8_t seedLen, uint8_t const * seedPtr,
+                                  uint8_t * keyLenPtr, uint8_t * keyPtr);
+bool XcpProtectGetPrivileges(tXcpProtectHandle handle, uint8_t * resourcePtr);
 
 
 #ifdef __cplusplus
@@ -44,19 +44,68 @@
 #include "candriver.h"                      /* Generic CAN driver module               */
 
 
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Object of the CAN transport layer. Multiple objects can share the same CAN
+ *         bus, as long as each one uses its own CAN identifiers.
+ */
+typedef struct t_xcp_tp_can_obj
+{
+  /** \brief The settings to use in this transport layer. */
+  tXcpTpCanSettings settings;
+  /** \brief CAN identifier for receiving XCP response packets. */
+  uint32_t rxId;
+  /** \brief Flag to indicate that this object is connected to the CAN driver. */
+  bool connected;
+  /** \brief Flag to indicate that a response packet was received via CAN. Made
+   *         volatile because it is shared with an event callback function that could be
+   *         called from a different thread.
+   */
+  volatile bool responseMessageReceived;
+  /** \brief Event object that is set when a response packet was received. */
+  tUtilEvent responseEvent;
+  /** \brief Buffer for storing the CAN message with response packet data. Made
+   *         volatile because it is shared with an event callback function that could be
+   *         called from a different thread.
+   */
+  volatile tCanMsg responseMessage;
+  /** \brief Critical section object that protects the response packet data shared with
+   *         the CAN event callback function.
+   */
+  tUtilCriticalSection critSect;
+  /** \brief Time in microseconds at which the CAN message with the last packet was
+   *         transmitted. A value of 0 means that it was not yet transmitted. Shared with
+   *         the CAN event callback functions.
+   */
+  volatile uint64_t requestTxTime;
+  /** \brief Time in microseconds at which the CAN message with the last response packet
+   *         was received. Shared with the CAN event callback functions.
+   */
+  volatile uint64_t responseRxTime;
+  /** \brief Time in microseconds that the last packet exchange spent on the CAN bus and
+   *         in the target.
+   */
+  uint32_t wireTime;
+  /** \brief Flag to indicate that \ref wireTime is valid. */
+  bool wireTimeValid;
+} tXcpTpCanObj;
+
+
 /****************************************************************************************
 * Function prototypes
 ****************************************************************************************/
 /* Transport layer module functions. */
-static void XcpTpCanInit(void const * settings);
-static void XcpTpCanTerminate(void);
-static bool XcpTpCanConnect(void);
-static void XcpTpCanDisconnect(void);
-static bool XcpTpCanSendPacket(tXcpTransportPacket const * txPacket, 
+static void * XcpTpCanInit(void const * settings);
+static void XcpTpCanTerminate(void * handle);
+static bool XcpTpCanConnect(void * handle);
+static void XcpTpCanDisconnect(void * handle);
+static bool XcpTpCanSendPacket(void * handle, tXcpTransportPacket const * txPacket, 
                                tXcpTransportPacket * rxPacket, uint16_t timeout);
+static bool XcpTpCanGetWireTime(void * handle, uint32_t * wireTime);
 /* CAN event functions. */
-static void XcpTpCanEventMessageTransmitted(tCanMsg const * msg);
-static void XcpTpCanEventMessageReceived(tCanMsg const * msg);
+static void XcpTpCanEventMessageTransmitted(void * context, tCanMsg const * msg);
+static void XcpTpCanEventMessageReceived(void * context, tCanMsg const * msg);
 
  
 /****************************************************************************************
@@ -69,36 +118,23 @@ static const tXcpTransport canTransport =
   XcpTpCanTerminate,
   XcpTpCanConnect,
   XcpTpCanDisconnect,
-  XcpTpCanSendPacket
+  XcpTpCanSendPacket,
+  XcpTpCanGetWireTime,
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+  NULL
 };
 
 /** \brief CAN driver event functions. */
-static const tCanEvents canEvents =
+static const tCanRxEvents canEvents =
 {
   XcpTpCanEventMessageTransmitted,
   XcpTpCanEventMessageReceived
 };
 
 
-/****************************************************************************************
-* Local data declarations
-****************************************************************************************/
-/** \brief The settings to use in this transport layer. */
-static tXcpTpCanSettings tpCanSettings;
-
-/** \brief Flag to indicate that a response packet was received via CAN. Made volatile
- *         because it is shared with an event callback function that could be called from
- *         a different thread.
- */
-static volatile bool tpCanResponseMessageReceived;
-
-/** \brief Buffer for storing the CAN message with response packet data. Made volatile
- *         because it is shared with an event callback function that could be called from
- *         a different thread.
- */
-static volatile tCanMsg tpCanResponseMessage;
-
-
 /***********************************************************************************//**
 ** \brief     Obtains a pointer to the transport layer structure, so that it can be 
 **            linked to the XCP protocol module.
@@ -112,161 +148,240 @@ tXcpTransport const * XcpTpCanGetTransport(void)
 
 
 /************************************************************************************//**
-** \brief     Initializes the transport layer.
+** \brief     Initializes the transport layer. Multiple transport layer objects can
+**            share the CAN driver, as long as they use the same CAN device, channel and
+**            baudrate.
 ** \param     settings Pointer to settings structure.
-** \return    None.
+** \return    Handle of the transport layer object if successful, NULL otherwise.
 **
 ****************************************************************************************/
-static void XcpTpCanInit(void const * settings)
+static void * XcpTpCanInit(void const * settings)
 {
+  tXcpTpCanObj * tpCan = NULL;
   char * canDeviceName;
   tCanSettings canSettings;
-
-  /* Reset transport layer settings. */
-  tpCanSettings.device = NULL;
-  tpCanSettings.channel = 0;
-  tpCanSettings.baudrate = 500000;
-  tpCanSettings.transmitId = 0x667;
-  tpCanSettings.receiveId = 0x7e1;
-  tpCanSettings.useExtended = false;
-
-  /* This module uses critical sections so initialize them. */
-  UtilCriticalSectionInit();
+  bool initialized = false;
 
   /* Check parameters. */
   assert(settings != NULL);
+  assert(((tXcpTpCanSettings *)settings)->device != NULL);
 
   /* Only continue with valid parameters. */
-  if (settings != NULL) /*lint !e774 */
+  if ( (settings != NULL) &&
+       (((tXcpTpCanSettings *)settings)->device != NULL) ) /*lint !e774 */
+  {
+    /* Create the transport layer object. */
+    tpCan = calloc(1, sizeof(tXcpTpCanObj));
+    assert(tpCan != NULL);
+  }
+  /* Only continue if the transport layer object was created. */
+  if (tpCan != NULL) /*lint !e774 */
   {
     /* Shallow copy the transport layer settings for layer usage. */
-    tpCanSettings = *((tXcpTpCanSettings *)settings);
-    /* The device name is a pointer and it is not gauranteed that it stays valid so we need
-     * to deep copy this one. note the +1 for '\0' in malloc.
+    tpCan->settings = *((tXcpTpCanSettings *)settings);
+    tpCan->settings.device = NULL;
+    /* Create the critical section object for protecting the response packet data and
+     * the event object for signaling its reception.
+     */
+    tpCan->critSect = UtilCriticalSectionCreate();
+    assert(tpCan->critSect != NULL);
+    tpCan->responseEvent = UtilEventCreate();
+    assert(tpCan->responseEvent != NULL);
+    /* The device name is a pointer and it is not gauranteed that it stays valid so we
+     * need to deep copy this one. note the +1 for '\0' in malloc.
      */
-    assert(((tXcpTpCanSettings *)settings)->device != NULL);
-    if (((tXcpTpCanSettings *)settings)->device != NULL) /*lint !e774 */
+    canDeviceName = malloc(strlen(((tXcpTpCanSettings *)settings)->device) + 1);
+    assert(canDeviceName != NULL);
+    if (canDeviceName != NULL) /*lint !e774 */
     {
-      canDeviceName = malloc(strlen(((tXcpTpCanSettings *)settings)->device) + 1);
-      assert(canDeviceName != NULL);
-      if (canDeviceName != NULL) /*lint !e774 */
-      {
-        strcpy(canDeviceName, ((tXcpTpCanSettings *)settings)->device);
-        tpCanSettings.device = canDeviceName;
-      }
+      strcpy(canDeviceName, ((tXcpTpCanSettings *)settings)->device);
+      tpCan->settings.device = canDeviceName;
+    }
+    /* Determine CAN identifier for receiving XCP responses via CAN. */
+    tpCan->rxId = tpCan->settings.receiveId;
+    if (tpCan->settings.useExtended)
+    {
+      tpCan->rxId |= CAN_MSG_EXT_ID_MASK;
     }
   }
-
-  /* Convert the transport layer settings to CAN driver settings. */
-  canSettings.devicename = tpCanSettings.device;
-  canSettings.channel = tpCanSettings.channel;
-  switch (tpCanSettings.baudrate)
+  /* Only continue if all resources were allocated. */
+  if ( (tpCan != NULL) && (tpCan->settings.device != NULL) &&
+       (tpCan->critSect != NULL) && (tpCan->responseEvent != NULL) )
   {
-    case 1000000:
-      canSettings.baudrate = CAN_BR1M;
-      break;
-    case 800000:
-      canSettings.baudrate = CAN_BR800K;
-      break;
-    case 500000:
-      canSettings.baudrate = CAN_BR500K;
-      break;
-    case 250000:
-      canSettings.baudrate = CAN_BR250K;
-      break;
-    case 125000:
-      canSettings.baudrate = CAN_BR125K;
-      break;
-    case 100000:
-      canSettings.baudrate = CAN_BR100K;
-      break;
-    case 50000:
-      canSettings.baudrate = CAN_BR50K;
-      break;
-    case 20000:
-      canSettings.baudrate = CAN_BR20K;
-      break;
-    case 10000:
-      canSettings.baudrate = CAN_BR10K;
-      break;
-    default:
-      /* Default to 500 kbits/sec in case an unsupported baudrate was specified. */
-      canSettings.baudrate = CAN_BR500K;
-      break;
+    /* Convert the transport layer settings to CAN driver settings. */
+    canSettings.devicename = tpCan->settings.device;
+    canSettings.channel = tpCan->settings.channel;
+    switch (tpCan->settings.baudrate)
+    {
+      case 1000000:
+        canSettings.baudrate = CAN_BR1M;
+        break;
+      case 800000:
+        canSettings.baudrate = CAN_BR800K;
+        break;
+      case 500000:
+        canSettings.baudrate = CAN_BR500K;
+        break;
+      case 250000:
+        canSettings.baudrate = CAN_BR250K;
+        break;
+      case 125000:
+        canSettings.baudrate = CAN_BR125K;
+        break;
+      case 100000:
+        canSettings.baudrate = CAN_BR100K;
+        break;
+      case 50000:
+        canSettings.baudrate = CAN_BR50K;
+        break;
+      case 20000:
+        canSettings.baudrate = CAN_BR20K;
+        break;
+      case 10000:
+        canSettings.baudrate = CAN_BR10K;
+        break;
+      default:
+        /* Default to 500 kbits/sec in case an unsupported baudrate was specified. */
+        canSettings.baudrate = CAN_BR500K;
+        break;
+    }
+    /* Configure the reception acceptance filter to receive only one CAN identifier. */
+    canSettings.code = tpCan->rxId;
+    canSettings.mask = 0x9fffffff;
+    /* Configure the transmit pacing. */
+    canSettings.txFrameGap = tpCan->settings.txFrameGap;
+    /* Initialize the CAN driver or share it, if it is already initialized. */
+    initialized = CanInit(&canSettings);
+    if (initialized)
+    {
+      /* Subscribe to the reception of response packets. The CAN driver only dispatches
+       * CAN messages with this identifier to the event functions of this object.
+       */
+      if (!CanRegisterRxId(tpCan->rxId, &canEvents, tpCan))
+      {
+        CanTerminate();
+        initialized = false;
+      }
+    }
   }
-  /* Configure the reception acceptance filter to receive only one CAN identifier. */
-  canSettings.code = tpCanSettings.receiveId;
-  if (tpCanSettings.useExtended)
+  /* Clean up if the transport layer could not be initialized. */
+  if ( (tpCan != NULL) && (!initialized) )
   {
-    canSettings.code |= CAN_MSG_EXT_ID_MASK;
+    if (tpCan->settings.device != NULL)
+    {
+      free((char *)tpCan->settings.device);
+    }
+    if (tpCan->critSect != NULL)
+    {
+      UtilCriticalSectionDestroy(tpCan->critSect);
+    }
+    if (tpCan->responseEvent != NULL)
+    {
+      UtilEventDestroy(tpCan->responseEvent);
+    }
+    free(tpCan);
+    tpCan = NULL;
   }
-  canSettings.mask = 0x9fffffff;
-  /* Initialize the CAN driver. */
-  CanInit(&canSettings);
-  /* Register CAN event functions. */
-  CanRegisterEvents(&canEvents);
+  /* Give the result back to the caller. */
+  return tpCan;
 } /*** end of XcpTpCanInit ***/
 
 
 /************************************************************************************//**
 ** \brief     Terminates the transport layer.
+** \param     handle Handle of the transport layer object.
 **
 ****************************************************************************************/
-static void XcpTpCanTerminate(void)
+static void XcpTpCanTerminate(void * handle)
 {
-  /* Terminate the CAN driver. */
-  CanTerminate();
-  /* Release memory that was allocated for storing the device name. */
-  if (tpCanSettings.device != NULL)
+  tXcpTpCanObj * tpCan = (tXcpTpCanObj *)handle;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only continue with valid parameters. */
+  if (tpCan != NULL) /*lint !e774 */
   {
-    free((char *)tpCanSettings.device);
+    /* Make sure to disconnect first. */
+    XcpTpCanDisconnect(tpCan);
+    /* Unsubscribe from the reception of response packets. */
+    CanUnregisterRxId(tpCan->rxId, &canEvents, tpCan);
+    /* Terminate the CAN driver, if this was its last user. */
+    CanTerminate();
+    /* Release memory that was allocated for storing the device name. */
+    if (tpCan->settings.device != NULL)
+    {
+      free((char *)tpCan->settings.device);
+    }
+    /* Destroy the critical section and event objects. */
+    UtilCriticalSectionDestroy(tpCan->critSect);
+    UtilEventDestroy(tpCan->responseEvent);
+    /* Release the transport layer object. */
+    free(tpCan);
   }
-  /* Reset transport layer settings. */
-  tpCanSettings.device = NULL;
-  tpCanSettings.channel = 0;
-  tpCanSettings.baudrate = 500000;
-  tpCanSettings.transmitId = 0x667;
-  tpCanSettings.receiveId = 0x7e1;
-  tpCanSettings.useExtended = false;
-  /* This module used critical sections so terminate them. */
-  UtilCriticalSectionTerminate();
 } /*** end of XcpTpCanTerminate ***/
 
 
 /************************************************************************************//**
 ** \brief     Connects to the transport layer.
+** \param     handle Handle of the transport layer object.
 ** \return    True is connected, false otherwise.
 **
 ****************************************************************************************/
-static bool XcpTpCanConnect(void)
+static bool XcpTpCanConnect(void * handle)
 {
+  tXcpTpCanObj * tpCan = (tXcpTpCanObj *)handle;
   bool result = false;
 
-  /* Connect to the CAN driver. */
-  if (CanConnect())
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only continue with valid parameters. */
+  if (tpCan != NULL) /*lint !e774 */
   {
-    result = true;
+    /* Make sure that this object is in the disconnected state, such that the CAN
+     * driver keeps track of the correct number of connected users.
+     */
+    XcpTpCanDisconnect(tpCan);
+    /* Connect to the CAN driver. */
+    if (CanConnect())
+    {
+      tpCan->connected = true;
+      result = true;
+    }
   }
-  
   /* Give the result back to the caller. */
   return result;
 } /*** end of XcpTpCanConnect ***/
 
 
 /************************************************************************************//**
-** \brief     Disconnects from the transport layer.
+** \brief     Disconnects from the transport layer. The CAN driver only disconnects from
+**            the CAN bus, once all of its users disconnected.
+** \param     handle Handle of the transport layer object.
 **
 ****************************************************************************************/
-static void XcpTpCanDisconnect(void)
+static void XcpTpCanDisconnect(void * handle)
 {
-  /* Disconnect from the CAN driver. */
-  CanDisconnect();
+  tXcpTpCanObj * tpCan = (tXcpTpCanObj *)handle;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only continue with valid parameters and if connected. */
+  if ( (tpCan != NULL) && (tpCan->connected) ) /*lint !e774 */
+  {
+    /* Disconnect from the CAN driver. */
+    CanDisconnect();
+    tpCan->connected = false;
+  }
 } /*** end of XcpTpCanDisconnect ***/
 
 
 /************************************************************************************//**
 ** \brief     Transmits an XCP packet on the transport layer and attempts to receive the
 **            response packet within the specified timeout.
+** \param     handle Handle of the transport layer object.
 ** \param     txPacket Pointer to the packet to transmit.
 ** \param     rxPacket Pointer where the received packet info is stored.
 ** \param     timeout Maximum time in milliseconds to wait for the reception of the
@@ -274,19 +389,21 @@ static void XcpTpCanDisconnect(void)
 ** \return    True is successful and a response packet was received, false otherwise.
 **
 ****************************************************************************************/
-static bool XcpTpCanSendPacket(tXcpTransportPacket const * txPacket, 
+static bool XcpTpCanSendPacket(void * handle, tXcpTransportPacket const * txPacket, 
                                tXcpTransportPacket * rxPacket, uint16_t timeout)
 {
+  tXcpTpCanObj * tpCan = (tXcpTpCanObj *)handle;
   bool result = false;
   tCanMsg canMsg;
-  uint32_t responseTimeoutTime = 0;
+  uint64_t responseTimeoutTime = 0;
   
   /* Check parameters. */
+  assert(handle != NULL);
   assert(txPacket != NULL);
   assert(rxPacket != NULL);
 
   /* Only continue with valid parameters. */
-  if ( (txPacket != NULL) && (rxPacket != NULL) ) /*lint !e774 */
+  if ( (tpCan != NULL) && (txPacket != NULL) && (rxPacket != NULL) ) /*lint !e774 */
   {
     /* Only continue if data length fits in a CAN message and the CAN bus is not in error
      * state. 
@@ -296,8 +413,8 @@ static bool XcpTpCanSendPacket(tXcpTransportPacket const * txPacket,
       /* Set result value to okay and only change it from now on if an error occurred. */
       result = true;
       /* Store the packet data into a CAN message. */
-      canMsg.id = tpCanSettings.transmitId;
-      if (tpCanSettings.useExtended)
+      canMsg.id = tpCan->settings.transmitId;
+      if (tpCan->settings.useExtended)
       {
         canMsg.id |= CAN_MSG_EXT_ID_MASK;
       }
@@ -306,14 +423,18 @@ static bool XcpTpCanSendPacket(tXcpTransportPacket const * txPacket,
       {
         canMsg.data[idx] = txPacket->data[idx];
       }
+      canMsg.timestamp = 0;
       /* Enter critical section. */
-      UtilCriticalSectionEnter();
+      UtilCriticalSectionLock(tpCan->critSect);
       /* Reset packet received flag before transmitting the packet, to be able to detect
        * its response packet.
        */
-      tpCanResponseMessageReceived = false;
+      tpCan->responseMessageReceived = false;
+      UtilEventReset(tpCan->responseEvent);
+      tpCan->requestTxTime = 0;
+      tpCan->wireTimeValid = false;
       /* Exit critical section. */
-      UtilCriticalSectionExit();
+      UtilCriticalSectionUnlock(tpCan->critSect);
       /* Submit the packet for transmission on the CAN bus. */
       if (!CanTransmit(&canMsg))
       {
@@ -323,40 +444,57 @@ static bool XcpTpCanSendPacket(tXcpTransportPacket const * txPacket,
       if (result)
       {
         /* Determine timeout time for the response packet. */
-        responseTimeoutTime = UtilTimeGetSystemTimeMs() + timeout;
-        /* Poll with timeout detection to receive the response packet as a CAN message
-         * on the CAN bus.
+        responseTimeoutTime = UtilTimeDeadlineUs((uint64_t)timeout * 1000u);
+        /* Wait with timeout detection to receive the response packet as a CAN message
+         * on the CAN bus. The event function signals its reception, so the CPU is not
+         * kept busy while waiting. That matters when multiple transport layer objects
+         * communicate at the same time.
          */
-        while (UtilTimeGetSystemTimeMs() < responseTimeoutTime)
+        for (;;)
         {
+          if (UtilTimeDeadlineExpired(responseTimeoutTime))
+          {
+            break;
+          }
+          (void)UtilEventWait(tpCan->responseEvent,
+                              UtilTimeDeadlineRemainingMs(responseTimeoutTime));
           /* Enter critical section. */
-          UtilCriticalSectionEnter();
+          UtilCriticalSectionLock(tpCan->critSect);
           /* Response received? */
-          if (tpCanResponseMessageReceived)
+          if (tpCan->responseMessageReceived)
           {
             /* Copy the response packet. */
-            rxPacket->len = tpCanResponseMessage.dlc;
+            rxPacket->len = tpCan->responseMessage.dlc;
             for (uint8_t idx = 0; idx < rxPacket->len; idx++)
             {
-              rxPacket->data[idx] = tpCanResponseMessage.data[idx];
+              rxPacket->data[idx] = tpCan->responseMessage.data[idx];
+            }
+            /* Determine the time between the transmission of the packet and the
+             * reception of its response, if the transmission time is known.
+             */
+            if ( (tpCan->requestTxTime != 0) &&
+                 (tpCan->responseRxTime >= tpCan->requestTxTime) )
+            {
+              tpCan->wireTime = (uint32_t)(tpCan->responseRxTime - tpCan->requestTxTime);
+              tpCan->wireTimeValid = true;
             }
             /* Exit critical section. */
-            UtilCriticalSectionExit();
+            UtilCriticalSectionUnlock(tpCan->critSect);
             /* Response packet receive so no need to continue loop. */
             break;
           }
           /* Exit critical section. */
-          UtilCriticalSectionExit();
+          UtilCriticalSectionUnlock(tpCan->critSect);
         }
         /* Enter critical section. */
-        UtilCriticalSectionEnter();
+        UtilCriticalSectionLock(tpCan->critSect);
         /* Check if a timeout occurred and no response was received. */
-        if (!tpCanResponseMessageReceived)
+        if (!tpCan->responseMessageReceived)
         {
           result = false;
         }
         /* Exit critical section. */
-        UtilCriticalSectionExit();
+        UtilCriticalSectionUnlock(tpCan->critSect);
       }
     }
   }
@@ -365,51 +503,120 @@ static bool XcpTpCanSendPacket(tXcpTransportPacket const * txPacket,
 } /*** end of XcpTpCanSendPacket ***/
 
 
+/************************************************************************************//**
+** \brief     Obtains the time that the last packet exchange spent on the CAN bus and in
+**            the target. This is the time between the transmission of the CAN message
+**            with the packet and the reception of the CAN message with its response,
+**            ideally as time stamped by the CAN controller or the kernel.
+** \param     handle Handle of the transport layer object.
+** \param     wireTime Pointer where the time in microseconds is stored.
+** \return    True if successful, false if the time is unknown.
+**
+****************************************************************************************/
+static bool XcpTpCanGetWireTime(void * handle, uint32_t * wireTime)
+{
+  tXcpTpCanObj * tpCan = (tXcpTpCanObj *)handle;
+  bool result = false;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+  assert(wireTime != NULL);
+
+  /* Only continue with valid parameters. */
+  if ( (tpCan != NULL) && (wireTime != NULL) ) /*lint !e774 */
+  {
+    if (tpCan->wireTimeValid)
+    {
+      *wireTime = tpCan->wireTime;
+      result = true;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpCanGetWireTime ***/
+
+
 /************************************************************************************//**
 ** \brief     CAN driver event callback function that gets called each time a CAN
 **            message was transmitted.
+** \param     context Pointer to the transport layer object that subscribed.
 ** \param     msg Pointer to the transmitted CAN message.
 **
 ****************************************************************************************/
-static void XcpTpCanEventMessageTransmitted(tCanMsg const * msg)
+static void XcpTpCanEventMessageTransmitted(void * context, tCanMsg const * msg)
 {
-  (void)msg;
+  tXcpTpCanObj * tpCan = (tXcpTpCanObj *)context;
+  uint32_t tpCanTxId;
+
+  /* Check parameters. */
+  assert(context != NULL);
+  assert(msg != NULL);
 
-  /* Nothing needs to be done here for now. Added for possible future expansions. */
+  /* Only continue with valid parameters. */
+  if ( (tpCan != NULL) && (msg != NULL) ) /*lint !e774 */
+  {
+    /* Determine CAN identifier for transmitting XCP packets via CAN. */
+    tpCanTxId = tpCan->settings.transmitId;
+    if (tpCan->settings.useExtended)
+    {
+      tpCanTxId |= CAN_MSG_EXT_ID_MASK;
+    }
+    /* Only interested in the CAN messages with XCP packets. */
+    if (msg->id == tpCanTxId)
+    {
+      /* Enter critical section. */
+      UtilCriticalSectionLock(tpCan->critSect);
+      /* Store the transmission time. Use the current time in case the CAN interface
+       * does not support time stamps.
+       */
+      tpCan->requestTxTime = (msg->timestamp != 0) ? msg->timestamp :
+                             UtilTimeGetSystemTimeUs();
+      /* Exit critical section. */
+      UtilCriticalSectionUnlock(tpCan->critSect);
+    }
+  }
 } /*** end of XcpTpCanEventMessageTransmitted ***/
 
 
 /************************************************************************************//**
 ** \brief     CAN driver event callback function that gets called each time a CAN
 **            message was received.
+** \param     context Pointer to the transport layer object that subscribed.
 ** \param     msg Pointer to the received CAN message.
 **
 ****************************************************************************************/
-static void XcpTpCanEventMessageReceived(tCanMsg const * msg)
+static void XcpTpCanEventMessageReceived(void * context, tCanMsg const * msg)
 {
-  /* Determine CAN identifier for receiving XCP commands via CAN. */
-  uint32_t tpCanRxId = tpCanSettings.receiveId;
-  if (tpCanSettings.useExtended)
-  {
-    tpCanRxId |= CAN_MSG_EXT_ID_MASK;
-  }
+  tXcpTpCanObj * tpCan = (tXcpTpCanObj *)context;
 
-  /* Check if the identifier matches the one for XCP on CAN. */
-  if (msg->id == tpCanRxId)
+  /* Check parameters. Note that the CAN driver only dispatches CAN messages with the
+   * identifier that was subscribed to, so there is no need to check the identifier.
+   */
+  assert(context != NULL);
+  assert(msg != NULL);
+
+  /* Only continue with valid parameters. */
+  if ( (tpCan != NULL) && (msg != NULL) ) /*lint !e774 */
   {
     /* Enter critical section. */
-    UtilCriticalSectionEnter();
+    UtilCriticalSectionLock(tpCan->critSect);
     /* Copy to the packet response message buffer. */
-    tpCanResponseMessage.id = msg->id;
-    tpCanResponseMessage.dlc = msg->dlc;
+    tpCan->responseMessage.id = msg->id;
+    tpCan->responseMessage.dlc = msg->dlc;
     for (uint8_t idx = 0; idx < msg->dlc; idx++)
     {
-      tpCanResponseMessage.data[idx] = msg->data[idx];
+      tpCan->responseMessage.data[idx] = msg->data[idx];
     }
-    /* Set packet received flag. */
-    tpCanResponseMessageReceived = true;
+    /* Store the reception time. Use the current time in case the CAN interface does not
+     * support time stamps.
+     */
+    tpCan->responseRxTime = (msg->timestamp != 0) ? msg->timestamp :
+                            UtilTimeGetSystemTimeUs();
+    /* Set packet received flag and wake up the thread that waits for it. */
+    tpCan->responseMessageReceived = true;
+    UtilEventSet(tpCan->responseEvent);
     /* Exit critical section. */
-    UtilCriticalSectionExit();
+    UtilCriticalSectionUnlock(tpCan->critSect);
   }
 } /*** end of XcpTpCanEventMessageReceived ***/
 
@@ -0,0 +1,1128 @@
+/************************************************************************************//**
+* \file         xcptpemu.c
+* \brief        XCP network emulation transport layer source file.
+* \ingroup      XcpTpEmu
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+* 
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+* 
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+*
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include <assert.h>                         /* for assertions                          */
+#include <stdint.h>                         /* for standard integer types              */
+#include <stddef.h>                         /* for NULL declaration                    */
+#include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
+#include <string.h>                         /* for string library                      */
+#include "session.h"                        /* Communication session module            */
+#include "xcploader.h"                      /* XCP loader module                       */
+#include "xcptpemu.h"                       /* XCP network emulation transport layer   */
+#include "util.h"                           /* Utility module                          */
+
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Maximum number of commands in flight. A larger window of the wrapped
+ *         transport layer is limited to this value.
+ */
+#define XCP_TP_EMU_WINDOW_MAX          (64u)
+
+/** \brief Maximum number of responses that are still on their way to the host. If more
+ *         responses arrive late, the one that arrives first is dropped.
+ */
+#define XCP_TP_EMU_LATE_MAX            (8u)
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief A submitted command that the network emulation holds on to, until its
+ *         response is collected.
+ */
+typedef struct t_xcp_tp_emu_command
+{
+  /** \brief Copy of the command packet. */
+  tXcpTransportPacket packet;
+  /** \brief Monotonic time in microseconds at which the command is passed on. */
+  uint64_t dueTime;
+  /** \brief True once the command was passed on, or got lost on its way. */
+  bool passed;
+  /** \brief Number of times the command was submitted to the wrapped transport layer.
+   *         0 if it got lost and 2 if it was duplicated.
+   */
+  uint8_t copies;
+  /** \brief True if the response to the command gets lost. */
+  bool responseLost;
+} tXcpTpEmuCommand;
+
+/** \brief A response that was not taken by the receive call that it belongs to, because
+ *         it got duplicated or delayed beyond the timeout. It shows up on a later
+ *         receive call, as it would on a real network.
+ */
+typedef struct t_xcp_tp_emu_response
+{
+  /** \brief Copy of the response packet. */
+  tXcpTransportPacket packet;
+  /** \brief Monotonic time in microseconds at which the response arrives. */
+  uint64_t arrivalTime;
+} tXcpTpEmuResponse;
+
+/** \brief Object of the network emulation transport layer. */
+typedef struct t_xcp_tp_emu_obj
+{
+  /** \brief The settings to use in this transport layer. */
+  tXcpTpEmuSettings settings;
+  /** \brief Handle of the wrapped transport layer object. */
+  void * transport;
+  /** \brief State of the pseudo random generator. */
+  uint32_t randomState;
+  /** \brief Delay in microseconds of the last command that was exchanged. */
+  uint32_t lastDelay;
+  /** \brief Time in microseconds at which the last command is passed on. Later
+   *         commands are not passed on before this time, so they keep their order.
+   */
+  uint64_t lastDueTime;
+  /** \brief Submitted commands, for which the response was not yet collected. */
+  tXcpTpEmuCommand commands[XCP_TP_EMU_WINDOW_MAX];
+  /** \brief Index of the oldest command in \ref commands. */
+  uint32_t commandsFirst;
+  /** \brief Number of commands in \ref commands. */
+  uint32_t commandsCount;
+  /** \brief Number of commands that were submitted to the wrapped transport layer, but
+   *         for which the response was not yet collected.
+   */
+  uint32_t inFlight;
+  /** \brief Number of duplicated commands in \ref inFlight. */
+  uint32_t duplicates;
+  /** \brief Responses that are still on their way to the host, in the order in which
+   *         they were queued.
+   */
+  tXcpTpEmuResponse late[XCP_TP_EMU_LATE_MAX];
+  /** \brief Number of responses in \ref late. */
+  uint32_t lateCount;
+} tXcpTpEmuObj;
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+static void * XcpTpEmuInit(void const * settings);
+static void XcpTpEmuTerminate(void * handle);
+static bool XcpTpEmuConnect(void * handle);
+static void XcpTpEmuDisconnect(void * handle);
+static bool XcpTpEmuSendPacket(void * handle, tXcpTransportPacket const * txPacket,
+                               tXcpTransportPacket * rxPacket, uint16_t timeout);
+static bool XcpTpEmuGetWireTime(void * handle, uint32_t * wireTime);
+static uint32_t XcpTpEmuGetWindow(void * handle);
+static bool XcpTpEmuSubmitPacket(void * handle, tXcpTransportTxVector const * txVector);
+static bool XcpTpEmuCollectPacket(void * handle, tXcpTransportPacket * rxPacket,
+                                  uint8_t resLen, uint16_t timeout);
+static bool XcpTpEmuSendPacketVector(void * handle,
+                                     tXcpTransportTxVector const * txVector,
+                                     tXcpTransportRxVector * rxVector,
+                                     uint16_t timeout);
+static bool XcpTpEmuIsUnreliable(void * handle);
+static bool XcpTpEmuExchange(tXcpTpEmuObj * tpEmu,
+                             tXcpTransportTxVector const * txVector,
+                             tXcpTransportRxVector * rxVector, uint16_t timeout);
+static void XcpTpEmuStoreResponse(tXcpTransportPacket const * packet,
+                                  tXcpTransportRxVector * rxVector);
+static bool XcpTpEmuPass(tXcpTpEmuObj * tpEmu, bool waitOldest);
+static bool XcpTpEmuPassCommand(tXcpTpEmuObj * tpEmu, tXcpTpEmuCommand * command);
+static bool XcpTpEmuDeliver(tXcpTpEmuObj * tpEmu, tXcpTransportPacket * rxPacket,
+                            bool received, uint64_t arrivalTime, uint64_t timeoutTime);
+static void XcpTpEmuQueueResponse(tXcpTpEmuObj * tpEmu,
+                                  tXcpTransportPacket const * packet,
+                                  uint64_t arrivalTime);
+static bool XcpTpEmuTakeResponse(tXcpTpEmuObj * tpEmu, uint64_t deadline,
+                                 tXcpTransportPacket * packet, uint64_t * arrivalTime);
+static void XcpTpEmuDropResponses(tXcpTpEmuObj * tpEmu, uint64_t time);
+static uint32_t XcpTpEmuGetDelay(tXcpTpEmuObj * tpEmu);
+static bool XcpTpEmuChance(tXcpTpEmuObj * tpEmu, uint32_t ppm);
+static uint32_t XcpTpEmuRandom(tXcpTpEmuObj * tpEmu);
+
+
+/****************************************************************************************
+* Local constant declarations
+****************************************************************************************/
+/** \brief XCP transport layer structure filled with network emulation specifics. */
+static const tXcpTransport emuTransport =
+{
+  XcpTpEmuInit,
+  XcpTpEmuTerminate,
+  XcpTpEmuConnect,
+  XcpTpEmuDisconnect,
+  XcpTpEmuSendPacket,
+  XcpTpEmuGetWireTime,
+  XcpTpEmuGetWindow,
+  XcpTpEmuSubmitPacket,
+  XcpTpEmuCollectPacket,
+  XcpTpEmuSendPacketVector,
+  XcpTpEmuIsUnreliable
+};
+
+
+/***********************************************************************************//**
+** \brief     Obtains a pointer to the transport layer structure, so that it can be 
+**            linked to the XCP protocol module.
+** \return    Pointer to transport layer structure.
+**
+****************************************************************************************/
+tXcpTransport const * XcpTpEmuGetTransport(void)
+{
+  return &emuTransport;
+} /*** end of XcpTpEmuGetTransport ***/
+
+
+/************************************************************************************//**
+** \brief     Initializes the transport layer. This also initializes the wrapped
+**            transport layer.
+** \param     settings Pointer to settings structure.
+** \return    Handle of the transport layer object if successful, NULL otherwise.
+**
+****************************************************************************************/
+static void * XcpTpEmuInit(void const * settings)
+{
+  tXcpTpEmuObj * tpEmu = NULL;
+
+  /* Check parameters. */
+  assert(settings != NULL);
+  assert(((tXcpTpEmuSettings *)settings)->transport != NULL);
+
+  /* Only continue with valid parameters. */
+  if ( (settings != NULL) && /*lint !e774 */
+       (((tXcpTpEmuSettings *)settings)->transport != NULL) )
+  {
+    /* Create the transport layer object. */
+    tpEmu = calloc(1, sizeof(tXcpTpEmuObj));
+    assert(tpEmu != NULL);
+  }
+  /* Only continue if the transport layer object was created. */
+  if (tpEmu != NULL) /*lint !e774 */
+  {
+    /* Shallow copy the transport layer settings for layer usage. The wrapped transport
+     * layer copies its own settings upon initialization.
+     */
+    tpEmu->settings = *((tXcpTpEmuSettings *)settings);
+    /* Note that the pseudo random generator cannot have an all zero state. */
+    tpEmu->randomState = (tpEmu->settings.seed != 0) ? tpEmu->settings.seed : 1u;
+    /* Initialize the wrapped transport layer. */
+    tpEmu->transport =
+      tpEmu->settings.transport->Init(tpEmu->settings.transportSettings);
+    /* Clean up if it could not be initialized. */
+    if (tpEmu->transport == NULL)
+    {
+      free(tpEmu);
+      tpEmu = NULL;
+    }
+  }
+  /* Give the result back to the caller. */
+  return tpEmu;
+} /*** end of XcpTpEmuInit ***/
+
+
+/************************************************************************************//**
+** \brief     Terminates the transport layer, including the wrapped transport layer.
+** \param     handle Handle of the transport layer object.
+**
+****************************************************************************************/
+static void XcpTpEmuTerminate(void * handle)
+{
+  tXcpTpEmuObj * tpEmu = (tXcpTpEmuObj *)handle;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only continue with valid parameters. */
+  if (tpEmu != NULL) /*lint !e774 */
+  {
+    /* Terminate the wrapped transport layer. */
+    tpEmu->settings.transport->Terminate(tpEmu->transport);
+    /* Release the transport layer object. */
+    free(tpEmu);
+  }
+} /*** end of XcpTpEmuTerminate ***/
+
+
+/************************************************************************************//**
+** \brief     Connects to the transport layer. The connection itself is made by the
+**            wrapped transport layer, without emulating the network.
+** \param     handle Handle of the transport layer object.
+** \return    True is connected, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpEmuConnect(void * handle)
+{
+  tXcpTpEmuObj * tpEmu = (tXcpTpEmuObj *)handle;
+  bool result = false;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only continue with valid parameters. */
+  if (tpEmu != NULL) /*lint !e774 */
+  {
+    /* Start without commands in flight. */
+    tpEmu->commandsFirst = 0;
+    tpEmu->commandsCount = 0;
+    tpEmu->inFlight = 0;
+    tpEmu->duplicates = 0;
+    tpEmu->lateCount = 0;
+    tpEmu->lastDelay = 0;
+    tpEmu->lastDueTime = 0;
+    /* Connect the wrapped transport layer. */
+    result = tpEmu->settings.transport->Connect(tpEmu->transport);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpEmuConnect ***/
+
+
+/************************************************************************************//**
+** \brief     Disconnects from the transport layer.
+** \param     handle Handle of the transport layer object.
+**
+****************************************************************************************/
+static void XcpTpEmuDisconnect(void * handle)
+{
+  tXcpTpEmuObj * tpEmu = (tXcpTpEmuObj *)handle;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only continue with valid parameters. */
+  if (tpEmu != NULL) /*lint !e774 */
+  {
+    /* Disconnect the wrapped transport layer. */
+    tpEmu->settings.transport->Disconnect(tpEmu->transport);
+  }
+} /*** end of XcpTpEmuDisconnect ***/
+
+
+/************************************************************************************//**
+** \brief     Transmits an XCP packet on the transport layer and attempts to receive the
+**            response packet within the specified timeout.
+** \param     handle Handle of the transport layer object.
+** \param     txPacket Pointer to the packet to transmit.
+** \param     rxPacket Pointer where the received packet info is stored.
+** \param     timeout Maximum time in milliseconds to wait for the reception of the
+**            response packet.
+** \return    True is successful and a response packet was received, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpEmuSendPacket(void * handle, tXcpTransportPacket const * txPacket,
+                               tXcpTransportPacket * rxPacket, uint16_t timeout)
+{
+  tXcpTpEmuObj * tpEmu = (tXcpTpEmuObj *)handle;
+  bool result = false;
+  tXcpTransportTxVector txVector;
+  tXcpTransportRxVector rxVector;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+  assert(txPacket != NULL);
+  assert(rxPacket != NULL);
+
+  /* Only continue with valid parameters. */
+  if ( (tpEmu != NULL) && (txPacket != NULL) && (rxPacket != NULL) ) /*lint !e774 */
+  {
+    /* Describe the packets as vectors, which consist of just the head. */
+    txVector.head = txPacket->data;
+    txVector.headLen = txPacket->len;
+    txVector.data = NULL;
+    txVector.dataLen = 0;
+    rxVector.head = rxPacket->data;
+    rxVector.headSize = sizeof(rxPacket->data);
+    rxVector.data = NULL;
+    rxVector.dataSize = 0;
+    /* Exchange the packets. */
+    result = XcpTpEmuSendPacketVector(handle, &txVector, &rxVector, timeout);
+    if (result)
+    {
+      rxPacket->len = rxVector.len;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpEmuSendPacket ***/
+
+
+/************************************************************************************//**
+** \brief     Obtains the time in microseconds that the last packet exchange spent on
+**            the communication medium and in the target. This is the wire time of the
+**            wrapped transport layer plus the emulated delay.
+** \param     handle Handle of the transport layer object.
+** \param     wireTime Pointer where the wire time is stored.
+** \return    True if successful, false if the wrapped transport layer does not know.
+**
+****************************************************************************************/
+static bool XcpTpEmuGetWireTime(void * handle, uint32_t * wireTime)
+{
+  tXcpTpEmuObj * tpEmu = (tXcpTpEmuObj *)handle;
+  bool result = false;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+  assert(wireTime != NULL);
+
+  /* Only continue with valid parameters and if the wrapped transport layer knows. */
+  if ( (tpEmu != NULL) && (wireTime != NULL) && /*lint !e774 */
+       (tpEmu->settings.transport->GetWireTime != NULL) )
+  {
+    result = tpEmu->settings.transport->GetWireTime(tpEmu->transport, wireTime);
+    if (result)
+    {
+      *wireTime += tpEmu->lastDelay;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpEmuGetWireTime ***/
+
+
+/************************************************************************************//**
+** \brief     Obtains the maximum number of commands that can be in flight. This is the
+**            window of the wrapped transport layer. If commands can get duplicated, one
+**            entry of this window is kept free for a duplicate.
+** \param     handle Handle of the transport layer object.
+** \return    The window size. 1 if pipelining is disabled or not supported.
+**
+****************************************************************************************/
+static uint32_t XcpTpEmuGetWindow(void * handle)
+{
+  tXcpTpEmuObj * tpEmu = (tXcpTpEmuObj *)handle;
+  uint32_t result = 1;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only continue with valid parameters and if the wrapped transport layer supports
+   * pipelining.
+   */
+  if ( (tpEmu != NULL) && /*lint !e774 */
+       (tpEmu->settings.transport->GetWindow != NULL) &&
+       (tpEmu->settings.transport->SubmitPacket != NULL) &&
+       (tpEmu->settings.transport->CollectPacket != NULL) )
+  {
+    result = tpEmu->settings.transport->GetWindow(tpEmu->transport);
+    if ( (tpEmu->settings.duplicatePpm > 0) && (result > 1) )
+    {
+      result--;
+    }
+    if (result > XCP_TP_EMU_WINDOW_MAX)
+    {
+      result = XCP_TP_EMU_WINDOW_MAX;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpEmuGetWindow ***/
+
+
+/************************************************************************************//**
+** \brief     Submits an XCP packet for transmission, without waiting for the response
+**            packet. The command is copied and passed on to the wrapped transport layer
+**            once its delay expired. Its response is obtained later on with
+**            XcpTpEmuCollectPacket().
+** \param     handle Handle of the transport layer object.
+** \param     txVector Pointer to the vector of the packet to transmit.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpEmuSubmitPacket(void * handle, tXcpTransportTxVector const * txVector)
+{
+  tXcpTpEmuObj * tpEmu = (tXcpTpEmuObj *)handle;
+  bool result = false;
+  tXcpTpEmuCommand * command;
+  uint64_t dueTime;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+  assert(txVector != NULL);
+  assert(tpEmu->commandsCount < XcpTpEmuGetWindow(handle));
+
+  /* Only continue with valid parameters and if the window is not yet full. */
+  if ( (tpEmu != NULL) && (txVector != NULL) && /*lint !e774 */
+       (tpEmu->commandsCount < XcpTpEmuGetWindow(handle)) &&
+       ((txVector->headLen + txVector->dataLen) <= XCPLOADER_PACKET_SIZE_MAX) )
+  {
+    /* Copy the command. */
+    command = &tpEmu->commands[(tpEmu->commandsFirst + tpEmu->commandsCount) %
+                               XCP_TP_EMU_WINDOW_MAX];
+    memcpy(&command->packet.data[0], txVector->head, txVector->headLen);
+    if (txVector->dataLen > 0)
+    {
+      memcpy(&command->packet.data[txVector->headLen], txVector->data,
+             txVector->dataLen);
+    }
+    command->packet.len = txVector->headLen + txVector->dataLen;
+    /* Determine when to pass it on, but not before the command submitted before it. */
+    dueTime = UtilTimeDeadlineUs(XcpTpEmuGetDelay(tpEmu));
+    if (dueTime < tpEmu->lastDueTime)
+    {
+      dueTime = tpEmu->lastDueTime;
+    }
+    command->dueTime = dueTime;
+    command->passed = false;
+    command->copies = 0;
+    command->responseLost = false;
+    tpEmu->lastDueTime = dueTime;
+    tpEmu->commandsCount++;
+    /* Pass on the commands whose delay already expired. */
+    result = XcpTpEmuPass(tpEmu, false);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpEmuSubmitPacket ***/
+
+
+/************************************************************************************//**
+** \brief     Attempts to receive the response packet of the oldest submitted command,
+**            within the specified timeout. If the command or its response got lost,
+**            this function waits for the timeout to expire, as it would on a real
+**            network. A late response of an earlier command, that arrives first, is
+**            taken for the response instead. The response to a duplicated command and a
+**            response that is delayed beyond the timeout arrive later on.
+** \param     handle Handle of the transport layer object.
+** \param     rxPacket Pointer where the received packet info is stored.
+** \param     resLen Length of a positive response packet.
+** \param     timeout Maximum time in milliseconds to wait for the reception of the
+**            response packet.
+** \return    True is successful and a response packet was received, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpEmuCollectPacket(void * handle, tXcpTransportPacket * rxPacket,
+                                  uint8_t resLen, uint16_t timeout)
+{
+  tXcpTpEmuObj * tpEmu = (tXcpTpEmuObj *)handle;
+  bool result = false;
+  bool received = false;
+  tXcpTpEmuCommand * command;
+  tXcpTransportPacket duplicatePacket;
+  uint64_t timeoutTime;
+  uint64_t arrivalTime = 0;
+  uint64_t now;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+  assert(rxPacket != NULL);
+  assert(tpEmu->commandsCount > 0);
+
+  /* Only continue with valid parameters and if a command is in flight. */
+  if ( (tpEmu != NULL) && (rxPacket != NULL) && /*lint !e774 */
+       (tpEmu->commandsCount > 0) )
+  {
+    timeoutTime = UtilTimeDeadlineUs((uint64_t)timeout * 1000u);
+    command = &tpEmu->commands[tpEmu->commandsFirst];
+    /* A command that is delayed beyond the timeout is passed on right away, so that
+     * its response can arrive late.
+     */
+    if ( (!command->passed) && (command->dueTime > timeoutTime) )
+    {
+      arrivalTime = command->dueTime;
+      command->dueTime = UtilTimeGetMonotonicUs();
+    }
+    /* Make sure the oldest command was passed on. */
+    result = XcpTpEmuPass(tpEmu, true);
+    /* Collect the response to each copy that the wrapped transport layer got. The
+     * responses are passed on in the order in which they come back, so after a
+     * reordering they belong to a different command.
+     */
+    if ( (result) && (command->copies > 0) )
+    {
+      received = tpEmu->settings.transport->CollectPacket(tpEmu->transport, rxPacket,
+                                                          resLen, timeout);
+      /* The wrapped transport layer only removes a command from its window, once the
+       * response to it was collected.
+       */
+      if (received)
+      {
+        tpEmu->inFlight--;
+      }
+      /* The response to the duplicate arrives after its own delay. */
+      if ( (received) && (command->copies > 1) &&
+           (tpEmu->settings.transport->CollectPacket(tpEmu->transport,
+                                                     &duplicatePacket, resLen,
+                                                     timeout)) )
+      {
+        tpEmu->inFlight--;
+        tpEmu->duplicates--;
+        XcpTpEmuQueueResponse(tpEmu, &duplicatePacket,
+                              UtilTimeGetMonotonicUs() + XcpTpEmuGetDelay(tpEmu));
+      }
+    }
+    /* Remove the command. */
+    tpEmu->commandsFirst = (tpEmu->commandsFirst + 1u) % XCP_TP_EMU_WINDOW_MAX;
+    tpEmu->commandsCount--;
+    /* Hand over the response that arrives first, if any. */
+    if (result)
+    {
+      now = UtilTimeGetMonotonicUs();
+      if (arrivalTime < now)
+      {
+        arrivalTime = now;
+      }
+      result = XcpTpEmuDeliver(tpEmu, rxPacket, (received) && (!command->responseLost),
+                               arrivalTime, timeoutTime);
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpEmuCollectPacket ***/
+
+
+/************************************************************************************//**
+** \brief     Transmits an XCP packet, that is described by a vector, on the transport
+**            layer and attempts to receive the response packet within the specified
+**            timeout. The command is held back for the emulated delay. If the command
+**            or its response got lost, this function waits for the timeout to expire,
+**            as it would on a real network. A duplicated command is exchanged a second
+**            time and its response arrives after its own delay. Late responses that
+**            arrive before the response to this command, are taken for it instead. The
+**            ones that arrived before the command is sent are dropped, just like the
+**            submitted commands for which the response was not yet collected.
+** \param     handle Handle of the transport layer object.
+** \param     txVector Pointer to the vector of the packet to transmit.
+** \param     rxVector Pointer to the vector where the received packet is stored.
+** \param     timeout Maximum time in milliseconds to wait for the reception of the
+**            response packet.
+** \return    True is successful and a response packet was received, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpEmuSendPacketVector(void * handle,
+                                     tXcpTransportTxVector const * txVector,
+                                     tXcpTransportRxVector * rxVector,
+                                     uint16_t timeout)
+{
+  tXcpTpEmuObj * tpEmu = (tXcpTpEmuObj *)handle;
+  bool result = false;
+  bool received = false;
+  uint64_t startTime;
+  uint64_t timeoutTime;
+  uint64_t arrivalTime;
+  uint64_t now;
+  tXcpTransportPacket rxPacket;
+  tXcpTransportPacket duplicatePacket;
+  tXcpTransportRxVector packetVector;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+  assert(txVector != NULL);
+  assert(rxVector != NULL);
+
+  /* Only continue with valid parameters. */
+  if ( (tpEmu != NULL) && (txVector != NULL) && (rxVector != NULL) ) /*lint !e774 */
+  {
+    /* Drop the submitted commands, for example after the collection of a response
+     * failed.
+     */
+    tpEmu->commandsCount = 0;
+    tpEmu->lastDueTime = 0;
+    startTime = UtilTimeGetMonotonicUs();
+    timeoutTime = startTime + ((uint64_t)timeout * 1000u);
+    /* The transport layers discard the responses that are pending, before they send
+     * a command. Only the ones that are still on their way remain.
+     */
+    XcpTpEmuDropResponses(tpEmu, startTime);
+    /* Hold the command back for the emulated delay, but not beyond the timeout. */
+    tpEmu->lastDelay = XcpTpEmuGetDelay(tpEmu);
+    arrivalTime = startTime + tpEmu->lastDelay;
+    UtilTimeSleepUntilUs((arrivalTime < timeoutTime) ? arrivalTime : timeoutTime);
+    /* Exchange the packets, unless the command got lost. The response is received in
+     * a packet first, because it could arrive late.
+     */
+    packetVector.head = rxPacket.data;
+    packetVector.headSize = sizeof(rxPacket.data);
+    packetVector.data = NULL;
+    packetVector.dataSize = 0;
+    if (!XcpTpEmuChance(tpEmu, tpEmu->settings.lossPpm))
+    {
+      received = XcpTpEmuExchange(tpEmu, txVector, &packetVector, timeout);
+      rxPacket.len = packetVector.len;
+      /* Let the target execute a duplicated command once more. */
+      if ( (received) && (XcpTpEmuChance(tpEmu, tpEmu->settings.duplicatePpm)) )
+      {
+        packetVector.head = duplicatePacket.data;
+        packetVector.headSize = sizeof(duplicatePacket.data);
+        if (XcpTpEmuExchange(tpEmu, txVector, &packetVector, timeout))
+        {
+          /* Its response arrives after its own delay. */
+          duplicatePacket.len = packetVector.len;
+          XcpTpEmuQueueResponse(tpEmu, &duplicatePacket,
+                                UtilTimeGetMonotonicUs() + XcpTpEmuGetDelay(tpEmu));
+        }
+      }
+      /* Drop the response, if it got lost. */
+      if ( (received) && (XcpTpEmuChance(tpEmu, tpEmu->settings.lossPpm)) )
+      {
+        received = false;
+      }
+    }
+    /* Hand over the response that arrives first, if any. */
+    now = UtilTimeGetMonotonicUs();
+    if (arrivalTime < now)
+    {
+      arrivalTime = now;
+    }
+    result = XcpTpEmuDeliver(tpEmu, &rxPacket, received, arrivalTime, timeoutTime);
+    /* Store the response in the buffers of the reception vector. */
+    if (result)
+    {
+      XcpTpEmuStoreResponse(&rxPacket, rxVector);
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpEmuSendPacketVector ***/
+
+
+/************************************************************************************//**
+** \brief     Determines if packets can get lost, duplicated or reordered. This is the
+**            case if one of these faults is emulated, or if the wrapped transport layer
+**            is unreliable itself.
+** \param     handle Handle of the transport layer object.
+** \return    True if packets can get lost, duplicated or reordered, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpEmuIsUnreliable(void * handle)
+{
+  tXcpTpEmuObj * tpEmu = (tXcpTpEmuObj *)handle;
+  bool result = false;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only continue with valid parameters. */
+  if (tpEmu != NULL) /*lint !e774 */
+  {
+    result = (tpEmu->settings.lossPpm > 0) || (tpEmu->settings.duplicatePpm > 0) ||
+             (tpEmu->settings.reorderPpm > 0);
+    if ( (!result) && (tpEmu->settings.transport->IsUnreliable != NULL) )
+    {
+      result = tpEmu->settings.transport->IsUnreliable(tpEmu->transport);
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpEmuIsUnreliable ***/
+
+
+/************************************************************************************//**
+** \brief     Exchanges an XCP packet with the wrapped transport layer. The vectors are
+**            passed on directly, if the wrapped transport layer supports it. Otherwise
+**            the packets are assembled. The wrapped transport layer discards the
+**            responses to the commands that are still in flight.
+** \param     tpEmu Pointer to the transport layer object.
+** \param     txVector Pointer to the vector of the packet to transmit.
+** \param     rxVector Pointer to the vector where the received packet is stored.
+** \param     timeout Maximum time in milliseconds to wait for the reception of the
+**            response packet.
+** \return    True is successful and a response packet was received, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpEmuExchange(tXcpTpEmuObj * tpEmu,
+                             tXcpTransportTxVector const * txVector,
+                             tXcpTransportRxVector * rxVector, uint16_t timeout)
+{
+  bool result = false;
+  tXcpTransportPacket txPacket;
+  tXcpTransportPacket rxPacket;
+
+  /* The commands in flight are no longer tracked by the wrapped transport layer. */
+  tpEmu->inFlight = 0;
+  tpEmu->duplicates = 0;
+  /* Exchange the vectors directly, if supported by the wrapped transport layer. */
+  if (tpEmu->settings.transport->SendPacketVector != NULL)
+  {
+    result = tpEmu->settings.transport->SendPacketVector(tpEmu->transport, txVector,
+                                                         rxVector, timeout);
+  }
+  /* Otherwise assemble the packet and exchange it as a regular packet. */
+  else if ((txVector->headLen + txVector->dataLen) <= XCPLOADER_PACKET_SIZE_MAX)
+  {
+    memcpy(&txPacket.data[0], txVector->head, txVector->headLen);
+    if (txVector->dataLen > 0)
+    {
+      memcpy(&txPacket.data[txVector->headLen], txVector->data, txVector->dataLen);
+    }
+    txPacket.len = txVector->headLen + txVector->dataLen;
+    result = tpEmu->settings.transport->SendPacket(tpEmu->transport, &txPacket,
+                                                   &rxPacket, timeout);
+    /* Store the response in the buffers of the reception vector. */
+    if (result)
+    {
+      XcpTpEmuStoreResponse(&rxPacket, rxVector);
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpEmuExchange ***/
+
+
+/************************************************************************************//**
+** \brief     Stores a response packet in the buffers of a reception vector. Bytes that
+**            do not fit are dropped.
+** \param     packet Pointer to the response packet.
+** \param     rxVector Pointer to the vector where the packet is stored.
+**
+****************************************************************************************/
+static void XcpTpEmuStoreResponse(tXcpTransportPacket const * packet,
+                                  tXcpTransportRxVector * rxVector)
+{
+  uint8_t headCnt;
+  uint8_t dataCnt;
+
+  headCnt = (packet->len < rxVector->headSize) ? packet->len : rxVector->headSize;
+  dataCnt = packet->len - headCnt;
+  if (dataCnt > rxVector->dataSize)
+  {
+    dataCnt = rxVector->dataSize;
+  }
+  memcpy(rxVector->head, &packet->data[0], headCnt);
+  if (dataCnt > 0)
+  {
+    memcpy(rxVector->data, &packet->data[headCnt], dataCnt);
+  }
+  rxVector->len = packet->len;
+} /*** end of XcpTpEmuStoreResponse ***/
+
+
+/************************************************************************************//**
+** \brief     Passes the submitted commands on to the wrapped transport layer, in the
+**            order in which they were submitted, for as far as their delay expired.
+**            With the reordering probability, a command is swapped with the next one.
+** \param     tpEmu Pointer to the transport layer object.
+** \param     waitOldest True to wait for the delay of the oldest command to expire, if
+**            it was not yet passed on.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpEmuPass(tXcpTpEmuObj * tpEmu, bool waitOldest)
+{
+  bool result = true;
+  uint32_t idx;
+  tXcpTpEmuCommand * command;
+  tXcpTpEmuCommand * next;
+
+  /* Go through the commands from the oldest to the newest. */
+  for (idx = 0; (result) && (idx < tpEmu->commandsCount); idx++)
+  {
+    command = &tpEmu->commands[(tpEmu->commandsFirst + idx) % XCP_TP_EMU_WINDOW_MAX];
+    /* Skip the commands that were already passed on. */
+    if (command->passed)
+    {
+      continue;
+    }
+    /* Wait for the delay of the oldest command, if requested. Otherwise stop at the
+     * first command whose delay did not yet expire.
+     */
+    if ( (waitOldest) && (idx == 0) )
+    {
+      UtilTimeSleepUntilUs(command->dueTime);
+    }
+    else if (!UtilTimeDeadlineExpired(command->dueTime))
+    {
+      break;
+    }
+    /* Swap it with the next command, if it got reordered. */
+    if ( (idx + 1u) < tpEmu->commandsCount )
+    {
+      next = &tpEmu->commands[(tpEmu->commandsFirst + idx + 1u) % XCP_TP_EMU_WINDOW_MAX];
+      if (XcpTpEmuChance(tpEmu, tpEmu->settings.reorderPpm))
+      {
+        result = XcpTpEmuPassCommand(tpEmu, next);
+        idx++;
+      }
+    }
+    /* Pass the command on. */
+    if (result)
+    {
+      result = XcpTpEmuPassCommand(tpEmu, command);
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpEmuPass ***/
+
+
+/************************************************************************************//**
+** \brief     Passes a submitted command on to the wrapped transport layer, unless it got
+**            lost. A duplicated command is submitted twice, if no other duplicate is in
+**            flight. The window of the wrapped transport layer has room for one.
+** \param     tpEmu Pointer to the transport layer object.
+** \param     command Pointer to the command.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpEmuPassCommand(tXcpTpEmuObj * tpEmu, tXcpTpEmuCommand * command)
+{
+  bool result = true;
+  tXcpTransportTxVector txVector;
+
+  command->passed = true;
+  /* Only submit it if the command did not get lost. */
+  if (!XcpTpEmuChance(tpEmu, tpEmu->settings.lossPpm))
+  {
+    /* The copy of the command stays valid until its response is collected. */
+    txVector.head = command->packet.data;
+    txVector.headLen = command->packet.len;
+    txVector.data = NULL;
+    txVector.dataLen = 0;
+    result = tpEmu->settings.transport->SubmitPacket(tpEmu->transport, &txVector);
+    if (result)
+    {
+      command->copies = 1;
+      tpEmu->inFlight++;
+      /* Submit it once more, if it got duplicated. */
+      if ( (XcpTpEmuChance(tpEmu, tpEmu->settings.duplicatePpm)) &&
+           (tpEmu->duplicates == 0) &&
+           (tpEmu->inFlight <
+            tpEmu->settings.transport->GetWindow(tpEmu->transport)) )
+      {
+        result = tpEmu->settings.transport->SubmitPacket(tpEmu->transport, &txVector);
+        if (result)
+        {
+          command->copies = 2;
+          tpEmu->inFlight++;
+          tpEmu->duplicates++;
+        }
+      }
+      /* Decide if the response gets lost. */
+      command->responseLost = XcpTpEmuChance(tpEmu, tpEmu->settings.lossPpm);
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpEmuPassCommand ***/
+
+
+/************************************************************************************//**
+** \brief     Hands over the response that arrives first, to a receive call. This is a
+**            late response that arrives before the response to the command, or the
+**            response to the command itself. If it is not handed over, the response to
+**            the command is queued, so that it arrives later on. The function waits
+**            until the response arrives or until the timeout expires.
+** \param     tpEmu Pointer to the transport layer object.
+** \param     rxPacket Pointer to the response to the command. The handed over response
+**            is stored here.
+** \param     received True if there is a response to the command, false if the command
+**            or its response got lost.
+** \param     arrivalTime Monotonic time in microseconds at which the response to the
+**            command arrives.
+** \param     timeoutTime Monotonic time in microseconds at which the receive call times
+**            out.
+** \return    True if a response was handed over, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpEmuDeliver(tXcpTpEmuObj * tpEmu, tXcpTransportPacket * rxPacket,
+                            bool received, uint64_t arrivalTime, uint64_t timeoutTime)
+{
+  bool result = false;
+  tXcpTransportPacket latePacket;
+  uint64_t lateArrivalTime;
+  uint64_t deadline;
+
+  /* Determine until when a late response can take the place of this one. */
+  deadline = timeoutTime;
+  if ( (received) && (arrivalTime < deadline) )
+  {
+    deadline = arrivalTime;
+  }
+  if (XcpTpEmuTakeResponse(tpEmu, deadline, &latePacket, &lateArrivalTime))
+  {
+    /* The response to the command is now the one that arrives late. */
+    if (received)
+    {
+      XcpTpEmuQueueResponse(tpEmu, rxPacket, arrivalTime);
+    }
+    *rxPacket = latePacket;
+    UtilTimeSleepUntilUs(lateArrivalTime);
+    result = true;
+  }
+  else if ( (received) && (arrivalTime <= timeoutTime) )
+  {
+    UtilTimeSleepUntilUs(arrivalTime);
+    result = true;
+  }
+  else
+  {
+    /* A response that is delayed beyond the timeout arrives later on. */
+    if (received)
+    {
+      XcpTpEmuQueueResponse(tpEmu, rxPacket, arrivalTime);
+    }
+    UtilTimeSleepUntilUs(timeoutTime);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpEmuDeliver ***/
+
+
+/************************************************************************************//**
+** \brief     Queues a response that arrives late. If the queue is full, the response
+**            that arrives first is dropped to make room.
+** \param     tpEmu Pointer to the transport layer object.
+** \param     packet Pointer to the response packet.
+** \param     arrivalTime Monotonic time in microseconds at which the response arrives.
+**
+****************************************************************************************/
+static void XcpTpEmuQueueResponse(tXcpTpEmuObj * tpEmu,
+                                  tXcpTransportPacket const * packet,
+                                  uint64_t arrivalTime)
+{
+  tXcpTransportPacket droppedPacket;
+  uint64_t droppedArrivalTime;
+
+  if (tpEmu->lateCount >= XCP_TP_EMU_LATE_MAX)
+  {
+    (void)XcpTpEmuTakeResponse(tpEmu, UINT64_MAX, &droppedPacket, &droppedArrivalTime);
+  }
+  tpEmu->late[tpEmu->lateCount].packet = *packet;
+  tpEmu->late[tpEmu->lateCount].arrivalTime = arrivalTime;
+  tpEmu->lateCount++;
+} /*** end of XcpTpEmuQueueResponse ***/
+
+
+/************************************************************************************//**
+** \brief     Takes the queued response that arrives first, if it arrives before the
+**            deadline.
+** \param     tpEmu Pointer to the transport layer object.
+** \param     deadline Monotonic time in microseconds before which the response must
+**            arrive.
+** \param     packet Pointer where the response packet is stored.
+** \param     arrivalTime Pointer where the arrival time of the response is stored.
+** \return    True if a response was taken, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpEmuTakeResponse(tXcpTpEmuObj * tpEmu, uint64_t deadline,
+                                 tXcpTransportPacket * packet, uint64_t * arrivalTime)
+{
+  bool result = false;
+  uint32_t first = 0;
+  uint32_t idx;
+
+  /* Find the response that arrives first. */
+  for (idx = 1; idx < tpEmu->lateCount; idx++)
+  {
+    if (tpEmu->late[idx].arrivalTime < tpEmu->late[first].arrivalTime)
+    {
+      first = idx;
+    }
+  }
+  /* Take it out of the queue, if it arrives in time. */
+  if ( (tpEmu->lateCount > 0) && (tpEmu->late[first].arrivalTime <= deadline) )
+  {
+    *packet = tpEmu->late[first].packet;
+    *arrivalTime = tpEmu->late[first].arrivalTime;
+    tpEmu->lateCount--;
+    memmove(&tpEmu->late[first], &tpEmu->late[first + 1u],
+            (tpEmu->lateCount - first) * sizeof(tpEmu->late[0]));
+    result = true;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpEmuTakeResponse ***/
+
+
+/************************************************************************************//**
+** \brief     Drops the queued responses that arrived at or before the specified time.
+** \param     tpEmu Pointer to the transport layer object.
+** \param     time Monotonic time in microseconds.
+**
+****************************************************************************************/
+static void XcpTpEmuDropResponses(tXcpTpEmuObj * tpEmu, uint64_t time)
+{
+  tXcpTransportPacket droppedPacket;
+  uint64_t droppedArrivalTime;
+
+  while (XcpTpEmuTakeResponse(tpEmu, time, &droppedPacket, &droppedArrivalTime))
+  {
+    /* Nothing else to do. */
+  }
+} /*** end of XcpTpEmuDropResponses ***/
+
+
+/************************************************************************************//**
+** \brief     Determines the delay of a command, which is the configured delay plus a
+**            random part of the jitter.
+** \param     tpEmu Pointer to the transport layer object.
+** \return    Delay in microseconds.
+**
+****************************************************************************************/
+static uint32_t XcpTpEmuGetDelay(tXcpTpEmuObj * tpEmu)
+{
+  uint32_t result;
+
+  result = tpEmu->settings.delay;
+  if (tpEmu->settings.jitter > 0)
+  {
+    result += XcpTpEmuRandom(tpEmu) % (tpEmu->settings.jitter + 1u);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpEmuGetDelay ***/
+
+
+/************************************************************************************//**
+** \brief     Decides if an event with the specified probability happens.
+** \param     tpEmu Pointer to the transport layer object.
+** \param     ppm Probability of the event in parts per million.
+** \return    True if the event happens, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpEmuChance(tXcpTpEmuObj * tpEmu, uint32_t ppm)
+{
+  bool result = false;
+
+  /* Only run the pseudo random generator, if the event can happen. */
+  if (ppm > 0)
+  {
+    result = ((XcpTpEmuRandom(tpEmu) % 1000000u) < ppm);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpEmuChance ***/
+
+
+/************************************************************************************//**
+** \brief     Obtains the next value of the pseudo random generator. It is a 32-bit
+**            xorshift generator, so the same seed always gives the same sequence.
+** \param     tpEmu Pointer to the transport layer object.
+** \return    Pseudo random value.
+**
+****************************************************************************************/
+static uint32_t XcpTpEmuRandom(tXcpTpEmuObj * tpEmu)
+{
+  tpEmu->randomState ^= tpEmu->randomState << 13;
+  tpEmu->randomState ^= tpEmu->randomState >> 17;
+  tpEmu->randomState ^= tpEmu->randomState << 5;
+  /* Give the result back to the caller. */
+  return tpEmu->randomState;
+} /*** end of XcpTpEmuRandom ***/
+
+
+/*********************************** end of xcptpemu.c *********************************/
@@ -0,0 +1,81 @@
+/************************************************************************************//**
+* \file         xcptpemu.h
+* \brief        XCP network emulation transport layer header file.
+* \ingroup      XcpTpEmu
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+* 
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+* 
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+*
+* \endinternal
+****************************************************************************************/
+/************************************************************************************//**
+* \defgroup   XcpTpEmu XCP network emulation transport layer
+* \brief      This module wraps another XCP transport layer and emulates a poor network.
+* \ingroup    XcpLoader
+* \details
+* The network emulation sits between the XCP loader and one of the other transport
+* layers. Each command is held back for a configurable delay and jitter, before it is
+* passed on to the wrapped transport layer. Commands and responses can get lost,
+* commands can be duplicated and commands in flight can be reordered. The response to a
+* duplicated command and a response that is delayed beyond the timeout are not dropped.
+* They arrive later on, where they can be taken for the response to another command, as
+* on a real network. This makes it possible to find out how the XCP loader and the
+* targets cope with noisy CAN buses or wireless TCP/IP links, and how it affects the
+* time of a firmware update, without the need for the actual network.
+****************************************************************************************/
+#ifndef XCPTPEMU_H
+#define XCPTPEMU_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Layout of structure with settings specific to the XCP transport layer module
+ *         for network emulation.
+ */
+typedef struct t_xcp_tp_emu_settings
+{
+  tXcpTransport const * transport; /**< Wrapped transport layer.                       */
+  void const * transportSettings;/**< Settings of the wrapped transport layer.         */
+  uint32_t delay;                /**< Delay of each command in microseconds.           */
+  uint32_t jitter;               /**< Maximum random extra delay in microseconds.      */
+  uint32_t lossPpm;              /**< Packet loss probability in parts per million.    */
+  uint32_t duplicatePpm;         /**< Command duplication probability in ppm.          */
+  uint32_t reorderPpm;           /**< Command reordering probability in ppm.           */
+  uint32_t seed;                 /**< Seed of the pseudo random generator.             */
+} tXcpTpEmuSettings;
+
+
+/***************************************************************************************
+* Function prototypes
+****************************************************************************************/
+tXcpTransport const * XcpTpEmuGetTransport(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XCPTPEMU_H */
+/*********************************** end of xcptpemu.h *********************************/
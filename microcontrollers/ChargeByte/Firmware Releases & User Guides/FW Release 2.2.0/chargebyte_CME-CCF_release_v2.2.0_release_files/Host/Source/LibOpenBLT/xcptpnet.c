@@ -41,17 +41,87 @@
 #include "xcploader.h"                      /* XCP loader module                       */
 #include "xcptpnet.h"                       /* XCP TCP/IP transport layer              */
 #include "netaccess.h"                      /* TCP/IP network access module            */
+#include "util.h"                           /* Utility module                          */
+
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Size of the header that precedes each packet. It holds a 32-bit counter. */
+#define XCP_TP_NET_HEADER_SIZE         (4u)
+
+/** \brief XCP packet identifier of a positive response packet. */
+#define XCP_TP_NET_PID_RES             (0xFFu)
+
+/** \brief XCP packet identifier of an error packet. */
+#define XCP_TP_NET_PID_ERR             (0xFEu)
+
+/** \brief Length of an error packet, as sent by the bootloader. It holds the packet
+ *         identifier and the error code.
+ */
+#define XCP_TP_NET_ERR_LEN             (2u)
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Object of the TCP/IP transport layer. Each one manages its own connection. */
+typedef struct t_xcp_tp_net_obj
+{
+  /** \brief The settings to use in this transport layer. */
+  tXcpTpNetSettings settings;
+  /** \brief Handle of the network access object for the connection. */
+  tNetAccessHandle netAccess;
+  /** \brief Command receive object (CRO) counter. This counter starts at 1 with each new
+   *         connection and is sent with each command packet. The counter gets
+   *         incremented for each command packet, allowing the server to determine the
+   *         correct order for the received commands.
+   */
+  uint32_t croCounter;
+  /** \brief Data transfer object (DTO) counter that is expected in the next response
+   *         packet. The server increments its counter for each response packet. This
+   *         makes it possible to match the responses to the commands in flight.
+   */
+  uint32_t dtoCounter;
+  /** \brief Flag to indicate that the DTO counter of the server is known. It becomes
+   *         known with the first response packet of a connection.
+   */
+  bool dtoCounterValid;
+  /** \brief Number of commands that were submitted, but for which the response was not
+   *         yet collected.
+   */
+  uint32_t inFlight;
+  /** \brief Buffer with the data that was received from the TCP stream, but that is
+   *         not yet processed. It can hold multiple response packets.
+   */
+  uint8_t rxBuffer[2 * (XCPLOADER_PACKET_SIZE_MAX + XCP_TP_NET_HEADER_SIZE)];
+  /** \brief Number of bytes in the reception buffer. */
+  uint32_t rxCount;
+} tXcpTpNetObj;
 
 
 /****************************************************************************************
 * Function prototypes
 ****************************************************************************************/
-static void XcpTpNetInit(void const * settings);
-static void XcpTpNetTerminate(void);
-static bool XcpTpNetConnect(void);
-static void XcpTpNetDisconnect(void);
-static bool XcpTpNetSendPacket(tXcpTransportPacket const * txPacket,
+static void * XcpTpNetInit(void const * settings);
+static void XcpTpNetTerminate(void * handle);
+static bool XcpTpNetConnect(void * handle);
+static void XcpTpNetDisconnect(void * handle);
+static bool XcpTpNetSendPacket(void * handle, tXcpTransportPacket const * txPacket,
                                tXcpTransportPacket * rxPacket, uint16_t timeout);
+static uint32_t XcpTpNetGetWindow(void * handle);
+static bool XcpTpNetSubmitPacket(void * handle, tXcpTransportTxVector const * txVector);
+static bool XcpTpNetCollectPacket(void * handle, tXcpTransportPacket * rxPacket,
+                                  uint8_t resLen, uint16_t timeout);
+static bool XcpTpNetSendPacketVector(void * handle,
+                                     tXcpTransportTxVector const * txVector,
+                                     tXcpTransportRxVector * rxVector,
+                                     uint16_t timeout);
+static bool XcpTpNetTransmit(tXcpTpNetObj * tpNet,
+                             tXcpTransportTxVector const * txVector);
+static bool XcpTpNetReceive(tXcpTpNetObj * tpNet, uint64_t timeoutTime);
+static void XcpTpNetCheckDtoCounter(tXcpTpNetObj * tpNet, uint8_t const * header,
+                                    bool * inSequence);
 
  
 /****************************************************************************************
@@ -64,24 +134,16 @@ static const tXcpTransport netTransport =
   XcpTpNetTerminate,
   XcpTpNetConnect,
   XcpTpNetDisconnect,
-  XcpTpNetSendPacket
+  XcpTpNetSendPacket,
+  NULL,
+  XcpTpNetGetWindow,
+  XcpTpNetSubmitPacket,
+  XcpTpNetCollectPacket,
+  XcpTpNetSendPacketVector,
+  NULL
 };
 
 
-/****************************************************************************************
-* Local data declarations
-****************************************************************************************/
-/** \brief The settings to use in this transport layer. */
-static tXcpTpNetSettings tpNetSettings;
-
-/** \brief Command receive object (CRO) counter. This counter starts at 1 with each new
- *         connection and is sent with each command packet. The counter gets incremented
- *         for each command packet, allowing the server to determine the correct order
- *         for the received commands.
- */
-static uint32_t tpNetCroCounter;
-
-
 /***********************************************************************************//**
 ** \brief     Obtains a pointer to the transport layer structure, so that it can be 
 **            linked to the XCP protocol module.
@@ -97,25 +159,29 @@ tXcpTransport const * XcpTpNetGetTransport(void)
 /************************************************************************************//**
 ** \brief     Initializes the transport layer.
 ** \param     settings Pointer to settings structure.
-** \return    None.
+** \return    Handle of the transport layer object if successful, NULL otherwise.
 **
 ****************************************************************************************/
-static void XcpTpNetInit(void const * settings)
+static void * XcpTpNetInit(void const * settings)
 {
+  tXcpTpNetObj * tpNet = NULL;
   char * netAddress;
 
-  /* Reset transport layer settings. */
-  tpNetSettings.address = NULL;
-  tpNetSettings.port = 0;
-
   /* Check parameters. */
   assert(settings != NULL);
 
   /* Only continue with valid parameters. */
   if (settings != NULL) /*lint !e774 */
+  {
+    /* Create the transport layer object. */
+    tpNet = calloc(1, sizeof(tXcpTpNetObj));
+    assert(tpNet != NULL);
+  }
+  /* Only continue if the transport layer object was created. */
+  if (tpNet != NULL) /*lint !e774 */
   {
     /* Shallow copy the transport layer settings for layer usage. */
-    tpNetSettings = *((tXcpTpNetSettings *)settings);
+    tpNet->settings = *((tXcpTpNetSettings *)settings);
     /* The address is a pointer and it is not guaranteed that it stays valid so we need
      * to deep copy this one. note the +1 for '\0' in malloc.
      */
@@ -127,55 +193,84 @@ static void XcpTpNetInit(void const * settings)
       if (netAddress != NULL) /*lint !e774 */
       {
         strcpy(netAddress, ((tXcpTpNetSettings *)settings)->address);
-        tpNetSettings.address = netAddress;
+        tpNet->settings.address = netAddress;
       }
     }
+    /* Create the network access object. */
+    tpNet->netAccess = NetAccessInit();
+    /* Clean up if one of the allocations failed. */
+    if ( (tpNet->settings.address == NULL) || (tpNet->netAccess == NULL) )
+    {
+      XcpTpNetTerminate(tpNet);
+      tpNet = NULL;
+    }
   }
-  /* Initialize the network access module. */
-  NetAccessInit();
+  /* Give the result back to the caller. */
+  return tpNet;
 } /*** end of XcpTpNetInit ***/
 
 
 /************************************************************************************//**
 ** \brief     Terminates the transport layer.
+** \param     handle Handle of the transport layer object.
 **
 ****************************************************************************************/
-static void XcpTpNetTerminate(void)
+static void XcpTpNetTerminate(void * handle)
 {
-  /* Terminate the network access module. */
-  NetAccessTerminate();
-  /* Release memory that was allocated for storing the network address. */
-  if (tpNetSettings.address != NULL)
+  tXcpTpNetObj * tpNet = (tXcpTpNetObj *)handle;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only continue with valid parameters. */
+  if (tpNet != NULL) /*lint !e774 */
   {
-    free((char *)tpNetSettings.address);
+    /* Terminate the network access object. */
+    if (tpNet->netAccess != NULL)
+    {
+      NetAccessTerminate(tpNet->netAccess);
+    }
+    /* Release memory that was allocated for storing the network address. */
+    if (tpNet->settings.address != NULL)
+    {
+      free((char *)tpNet->settings.address);
+    }
+    /* Release the transport layer object. */
+    free(tpNet);
   }
-  /* Reset transport layer settings. */
-  tpNetSettings.address = NULL;
-  tpNetSettings.port = 0;
 } /*** end of XcpTpNetTerminate ***/
 
 
 /************************************************************************************//**
 ** \brief     Connects to the transport layer.
+** \param     handle Handle of the transport layer object.
 ** \return    True is connected, false otherwise.
 **
 ****************************************************************************************/
-static bool XcpTpNetConnect(void)
+static bool XcpTpNetConnect(void * handle)
 {
+  tXcpTpNetObj * tpNet = (tXcpTpNetObj *)handle;
   bool result = false;
 
-  /* Check transport layer settings. */
-  assert(tpNetSettings.address != NULL);
-  assert(tpNetSettings.port != 0);
-
-  /* Initialize the CRO counter. */
-  tpNetCroCounter = 1;
+  /* Check parameters and transport layer settings. */
+  assert(handle != NULL);
+  assert(tpNet->settings.address != NULL);
+  assert(tpNet->settings.port != 0);
 
   /* Only continue if the transport layer settings are valid. */
-  if ( (tpNetSettings.address != NULL) && (tpNetSettings.port != 0) ) /*lint !e774 */
+  if ( (tpNet != NULL) && (tpNet->settings.address != NULL) &&
+       (tpNet->settings.port != 0) ) /*lint !e774 */
   {
-    /* Connect via the network access module. */
-    result = NetAccessConnect(tpNetSettings.address, tpNetSettings.port);
+    /* Initialize the CRO counter. */
+    tpNet->croCounter = 1;
+    /* The DTO counter becomes known with the first response packet. */
+    tpNet->dtoCounterValid = false;
+    /* Start without commands in flight and without buffered data. */
+    tpNet->inFlight = 0;
+    tpNet->rxCount = 0;
+    /* Connect via the network access object. */
+    result = NetAccessConnect(tpNet->netAccess, tpNet->settings.address,
+                              tpNet->settings.port);
   }
   /* Give the result back to the caller. */
   return result;
@@ -184,18 +279,29 @@ static bool XcpTpNetConnect(void)
 
 /************************************************************************************//**
 ** \brief     Disconnects from the transport layer.
+** \param     handle Handle of the transport layer object.
 **
 ****************************************************************************************/
-static void XcpTpNetDisconnect(void)
+static void XcpTpNetDisconnect(void * handle)
 {
-  /* Disconnect via the network access module. */
-  NetAccessDisconnect();
+  tXcpTpNetObj * tpNet = (tXcpTpNetObj *)handle;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only continue with valid parameters. */
+  if (tpNet != NULL) /*lint !e774 */
+  {
+    /* Disconnect via the network access object. */
+    NetAccessDisconnect(tpNet->netAccess);
+  }
 } /*** end of XcpTpNetDisconnect ***/
 
 
 /************************************************************************************//**
 ** \brief     Transmits an XCP packet on the transport layer and attempts to receive the
 **            response packet within the specified timeout.
+** \param     handle Handle of the transport layer object.
 ** \param     txPacket Pointer to the packet to transmit.
 ** \param     rxPacket Pointer where the received packet info is stored.
 ** \param     timeout Maximum time in milliseconds to wait for the reception of the
@@ -203,69 +309,110 @@ static void XcpTpNetDisconnect(void)
 ** \return    True is successful and a response packet was received, false otherwise.
 **
 ****************************************************************************************/
-static bool XcpTpNetSendPacket(tXcpTransportPacket const * txPacket,
+static bool XcpTpNetSendPacket(void * handle, tXcpTransportPacket const * txPacket,
                                tXcpTransportPacket * rxPacket, uint16_t timeout)
 {
+  tXcpTpNetObj * tpNet = (tXcpTpNetObj *)handle;
   bool result = false;
-  uint16_t byteIdx;
-  /* netBuffer is static to lower the stack load. +4 because the CRO counter value is
-   * added at the start of the packet.
-   */
-  static uint8_t netBuffer[XCPLOADER_PACKET_SIZE_MAX + 4];
+  tXcpTransportTxVector txVector;
+  tXcpTransportRxVector rxVector;
 
   /* Check parameters. */
+  assert(handle != NULL);
   assert(txPacket != NULL);
   assert(rxPacket != NULL);
 
   /* Only continue with valid parameters. */
-  if ( (txPacket != NULL) && (rxPacket != NULL) ) /*lint !e774 */
+  if ( (tpNet != NULL) && (txPacket != NULL) && (rxPacket != NULL) ) /*lint !e774 */
   {
-    /* Set result value to okay and only change it from now on if an error occurred. */
-    result = true;
-    /* Prepare the XCP packet for transmission via TCP/IP. This is basically the same
-     * as the XCP packet data but just the CRO counter of the packet is added to the
-     * first four bytes.
-     */
-    netBuffer[0] = (uint8_t)tpNetCroCounter;
-    netBuffer[1] = (uint8_t)(tpNetCroCounter >> 8);
-    netBuffer[2] = (uint8_t)(tpNetCroCounter >> 16);
-    netBuffer[3] = (uint8_t)(tpNetCroCounter >> 24);
-    /* Increment the CRO counter for the next packet. */
-    tpNetCroCounter++;
-    /* Copy the actual packet data. */
-    for (byteIdx=0; byteIdx<txPacket->len; byteIdx++)
+    /* Describe the packets as vectors, which consist of just the head. */
+    txVector.head = txPacket->data;
+    txVector.headLen = txPacket->len;
+    txVector.data = NULL;
+    txVector.dataLen = 0;
+    rxVector.head = rxPacket->data;
+    rxVector.headSize = sizeof(rxPacket->data);
+    rxVector.data = NULL;
+    rxVector.dataSize = 0;
+    /* Exchange the packets. */
+    result = XcpTpNetSendPacketVector(handle, &txVector, &rxVector, timeout);
+    if (result)
     {
-      netBuffer[byteIdx + 4] = txPacket->data[byteIdx];
+      rxPacket->len = rxVector.len;
     }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpNetSendPacket ***/
+
+
+/************************************************************************************//**
+** \brief     Transmits an XCP packet, that is described by a vector, on the transport
+**            layer and attempts to receive the response packet within the specified
+**            timeout. The packet is sent straight from the buffers of the vector and
+**            the response is stored in the buffers of the reception vector.
+** \param     handle Handle of the transport layer object.
+** \param     txVector Pointer to the vector of the packet to transmit.
+** \param     rxVector Pointer to the vector where the received packet is stored.
+** \param     timeout Maximum time in milliseconds to wait for the reception of the
+**            response packet.
+** \return    True is successful and a response packet was received, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpNetSendPacketVector(void * handle,
+                                     tXcpTransportTxVector const * txVector,
+                                     tXcpTransportRxVector * rxVector,
+                                     uint16_t timeout)
+{
+  tXcpTpNetObj * tpNet = (tXcpTpNetObj *)handle;
+  bool result = false;
+  uint64_t responseTimeoutTime;
+  bool inSequence;
+  uint32_t headCnt;
+  uint32_t dataCnt;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+  assert(txVector != NULL);
+  assert(rxVector != NULL);
+
+  /* Only continue with valid parameters. */
+  if ( (tpNet != NULL) && (txVector != NULL) && (rxVector != NULL) ) /*lint !e774 */
+  {
+    /* Discard data that is still buffered, for example the remainder of a response
+     * that arrived after its timeout. It cannot belong to the upcoming response. The
+     * same applies to the responses of commands that are still in flight.
+     */
+    tpNet->rxCount = 0;
+    tpNet->inFlight = 0;
     /* Send the packet. */
-    if (!NetAccessSend(netBuffer, txPacket->len + 4))
-    {
-      result = false;
-    }
+    result = XcpTpNetTransmit(tpNet, txVector);
 
     /* Only continue if the packet was successfully sent. */
-    uint32_t netRxLength = 0;
     if (result)
     {
       /* Reset the length of the received packet data. */
-      rxPacket->len = 0;
-      /* Set the maximum allowed length of the response packet. */
-      netRxLength = sizeof(netBuffer)/sizeof(netBuffer[0]);
-      /* Attempt to receive the response within the specified timeout. */
-      if (!NetAccessReceive(netBuffer, &netRxLength, timeout))
+      rxVector->len = 0;
+      /* Determine timeout time for the response packet. */
+      responseTimeoutTime = UtilTimeDeadlineUs((uint64_t)timeout * 1000u);
+      /* Attempt to receive the response within the specified timeout. The response
+       * could arrive split over multiple TCP segments. Its header holds no packet
+       * length, so the only thing that can be checked is the minimal length: the DTO
+       * counter and at least one byte of response data. Keep receiving until that
+       * much data arrived.
+       */
+      while ( (result) && (tpNet->rxCount < (XCP_TP_NET_HEADER_SIZE + 1u)) )
       {
-        result = false;
+        result = XcpTpNetReceive(tpNet, responseTimeoutTime);
       }
     }
     /* Only continue if a response packet was received. */
     if (result)
     {
-      /* Validate the response length. It must at least have a DTO counter (32-bits) and
-       * one byte in the response data. It can also not be longer than the maximum
-       * allowed size, based on the size of the buffer.
+      /* Validate the response length. It can not be longer than the maximum allowed
+       * packet size.
        */
-      if ( (netRxLength < 5) ||
-           (netRxLength > (sizeof(netBuffer)/sizeof(netBuffer[0]))) )
+      if (tpNet->rxCount > (XCPLOADER_PACKET_SIZE_MAX + XCP_TP_NET_HEADER_SIZE))
       {
         /* Invalid length. */
         result = false;
@@ -274,20 +421,296 @@ static bool XcpTpNetSendPacket(tXcpTransportPacket const * txPacket,
     /* Only continue if the response packet has a valid length. */
     if (result)
     {
-      /* The first four bytes contain a DTO counter in which we are not really
-       * interested.
+      /* The first four bytes contain the DTO counter. It is only used to match the
+       * responses of pipelined commands, so here it is merely tracked.
+       */
+      XcpTpNetCheckDtoCounter(tpNet, &tpNet->rxBuffer[0], &inSequence);
+      rxVector->len = (uint8_t)(tpNet->rxCount - XCP_TP_NET_HEADER_SIZE);
+      /* Copy the received packet data to the buffers of the reception vector. Bytes
+       * that do not fit are dropped.
+       */
+      headCnt = rxVector->len;
+      if (headCnt > rxVector->headSize)
+      {
+        headCnt = rxVector->headSize;
+      }
+      dataCnt = rxVector->len - headCnt;
+      if (dataCnt > rxVector->dataSize)
+      {
+        dataCnt = rxVector->dataSize;
+      }
+      memcpy(rxVector->head, &tpNet->rxBuffer[XCP_TP_NET_HEADER_SIZE], headCnt);
+      if (dataCnt > 0)
+      {
+        memcpy(rxVector->data, &tpNet->rxBuffer[XCP_TP_NET_HEADER_SIZE + headCnt],
+               dataCnt);
+      }
+    }
+    /* All received data was processed. */
+    tpNet->rxCount = 0;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpNetSendPacketVector ***/
+
+
+/************************************************************************************//**
+** \brief     Obtains the maximum number of commands that can be in flight.
+** \param     handle Handle of the transport layer object.
+** \return    The configured window size. 1 if pipelining is disabled.
+**
+****************************************************************************************/
+static uint32_t XcpTpNetGetWindow(void * handle)
+{
+  tXcpTpNetObj * tpNet = (tXcpTpNetObj *)handle;
+  uint32_t result = 1;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* A window of 0 is treated the same as a window of 1. */
+  if ( (tpNet != NULL) && (tpNet->settings.window > 1) ) /*lint !e774 */
+  {
+    result = tpNet->settings.window;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpNetGetWindow ***/
+
+
+/************************************************************************************//**
+** \brief     Transmits an XCP packet on the transport layer, without waiting for the
+**            response packet. Its response is obtained later on with
+**            XcpTpNetCollectPacket().
+** \param     handle Handle of the transport layer object.
+** \param     txVector Pointer to the vector of the packet to transmit.
+** \return    True is successful, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpNetSubmitPacket(void * handle, tXcpTransportTxVector const * txVector)
+{
+  tXcpTpNetObj * tpNet = (tXcpTpNetObj *)handle;
+  bool result = false;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+  assert(txVector != NULL);
+  assert(tpNet->inFlight < XcpTpNetGetWindow(handle));
+
+  /* Only continue with valid parameters and if the window is not yet full. */
+  if ( (tpNet != NULL) && (txVector != NULL) &&
+       (tpNet->inFlight < XcpTpNetGetWindow(handle)) ) /*lint !e774 */
+  {
+    /* Send the packet. */
+    result = XcpTpNetTransmit(tpNet, txVector);
+    if (result)
+    {
+      tpNet->inFlight++;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpNetSubmitPacket ***/
+
+
+/************************************************************************************//**
+** \brief     Attempts to receive the response packet of the oldest submitted command,
+**            within the specified timeout. The responses of multiple commands can
+**            arrive in one TCP segment. The packet header holds no packet length, so the
+**            response is located based on its packet identifier: a positive response
+**            has the specified length and an error packet is always 2 bytes. The DTO
+**            counter of the response must match the one that is expected for the
+**            command.
+** \param     handle Handle of the transport layer object.
+** \param     rxPacket Pointer where the received packet info is stored.
+** \param     resLen Length of a positive response packet.
+** \param     timeout Maximum time in milliseconds to wait for the reception of the
+**            response packet.
+** \return    True is successful and a response packet was received, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpNetCollectPacket(void * handle, tXcpTransportPacket * rxPacket,
+                                  uint8_t resLen, uint16_t timeout)
+{
+  tXcpTpNetObj * tpNet = (tXcpTpNetObj *)handle;
+  bool result = false;
+  uint64_t responseTimeoutTime;
+  uint32_t frameLen = 0;
+  uint16_t byteIdx;
+  bool inSequence = false;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+  assert(rxPacket != NULL);
+  assert(resLen > 0);
+  assert(tpNet->inFlight > 0);
+
+  /* Only continue with valid parameters and if a command is in flight. */
+  if ( (tpNet != NULL) && (rxPacket != NULL) && (resLen > 0) &&
+       (tpNet->inFlight > 0) ) /*lint !e774 */
+  {
+    /* Set result value to okay and only change it from now on if an error occurred. */
+    result = true;
+    /* Determine timeout time for the response packet. */
+    responseTimeoutTime = UtilTimeDeadlineUs((uint64_t)timeout * 1000u);
+    /* Receive data until the response packet is complete. */
+    while (result)
+    {
+      /* Determine the length of the response packet, once its packet identifier is
+       * available.
        */
-      rxPacket->len = (uint8_t)(netRxLength - 4);
+      if ( (frameLen == 0) && (tpNet->rxCount > XCP_TP_NET_HEADER_SIZE) )
+      {
+        if (tpNet->rxBuffer[XCP_TP_NET_HEADER_SIZE] == XCP_TP_NET_PID_RES)
+        {
+          frameLen = XCP_TP_NET_HEADER_SIZE + resLen;
+        }
+        else if (tpNet->rxBuffer[XCP_TP_NET_HEADER_SIZE] == XCP_TP_NET_PID_ERR)
+        {
+          frameLen = XCP_TP_NET_HEADER_SIZE + XCP_TP_NET_ERR_LEN;
+        }
+        else
+        {
+          /* Not the start of a response packet, so the stream is out of sync. */
+          result = false;
+          break;
+        }
+      }
+      /* Done if the response packet is complete. */
+      if ( (frameLen > 0) && (tpNet->rxCount >= frameLen) )
+      {
+        break;
+      }
+      /* Receive more data. */
+      result = XcpTpNetReceive(tpNet, responseTimeoutTime);
+    }
+    /* Match the response packet to the command, based on the DTO counter. */
+    if (result)
+    {
+      XcpTpNetCheckDtoCounter(tpNet, &tpNet->rxBuffer[0], &inSequence);
+      if (!inSequence)
+      {
+        /* A response packet went missing or is not the one of the oldest command. */
+        result = false;
+      }
+    }
+    /* Only continue if the response packet belongs to the oldest command. */
+    if (result)
+    {
       /* Copy the received packet data. */
+      rxPacket->len = (uint8_t)(frameLen - XCP_TP_NET_HEADER_SIZE);
       for (byteIdx=0; byteIdx<rxPacket->len; byteIdx++)
       {
-        rxPacket->data[byteIdx] = netBuffer[byteIdx + 4];
+        rxPacket->data[byteIdx] = tpNet->rxBuffer[byteIdx + XCP_TP_NET_HEADER_SIZE];
       }
+      /* Remove the response packet from the buffer. */
+      tpNet->rxCount -= frameLen;
+      memmove(&tpNet->rxBuffer[0], &tpNet->rxBuffer[frameLen], tpNet->rxCount);
+      tpNet->inFlight--;
     }
   }
   /* Give the result back to the caller. */
   return result;
-} /*** end of XcpTpNetSendPacket ***/
+} /*** end of XcpTpNetCollectPacket ***/
+
+
+/************************************************************************************//**
+** \brief     Transmits an XCP packet on the transport layer. The CRO counter is added in
+**            front of the packet. The counter, the head and the data of the packet are
+**            handed to the network access module as separate buffers, so the packet
+**            does not need to be copied.
+** \param     tpNet Pointer to the transport layer object.
+** \param     txVector Pointer to the vector of the packet to transmit.
+** \return    True is successful, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpNetTransmit(tXcpTpNetObj * tpNet,
+                             tXcpTransportTxVector const * txVector)
+{
+  bool result;
+  uint8_t croCounter[XCP_TP_NET_HEADER_SIZE];
+  tNetAccessBuffer buffers[3];
+
+  /* Prepare the XCP packet for transmission via TCP/IP. This is basically the same
+   * as the XCP packet data but just the CRO counter of the packet is added to the
+   * first four bytes.
+   */
+  croCounter[0] = (uint8_t)tpNet->croCounter;
+  croCounter[1] = (uint8_t)(tpNet->croCounter >> 8);
+  croCounter[2] = (uint8_t)(tpNet->croCounter >> 16);
+  croCounter[3] = (uint8_t)(tpNet->croCounter >> 24);
+  /* Increment the CRO counter for the next packet. */
+  tpNet->croCounter++;
+  /* Describe the packet with buffers. */
+  buffers[0].data = croCounter;
+  buffers[0].length = XCP_TP_NET_HEADER_SIZE;
+  buffers[1].data = txVector->head;
+  buffers[1].length = txVector->headLen;
+  buffers[2].data = txVector->data;
+  buffers[2].length = txVector->dataLen;
+  /* Send the packet. */
+  result = NetAccessSendVector(tpNet->netAccess, buffers, 3);
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpNetTransmit ***/
+
+
+/************************************************************************************//**
+** \brief     Receives the data that is available on the TCP stream and appends it to
+**            the reception buffer. Waits for data to arrive, if none is available yet.
+** \param     tpNet Pointer to the transport layer object.
+** \param     timeoutTime Monotonic time in microseconds at which reception times out.
+** \return    True if data was received, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpNetReceive(tXcpTpNetObj * tpNet, uint64_t timeoutTime)
+{
+  bool result = false;
+  uint32_t remainingTime;
+  uint32_t rxLength;
+
+  /* Only continue if the reception did not yet time out and if there is free space in
+   * the reception buffer. Note that the remaining time is rounded up to milliseconds.
+   */
+  remainingTime = UtilTimeDeadlineRemainingMs(timeoutTime);
+  rxLength = (sizeof(tpNet->rxBuffer)/sizeof(tpNet->rxBuffer[0])) - tpNet->rxCount;
+  if ( (remainingTime > 0) && (rxLength > 0) )
+  {
+    if (NetAccessReceive(tpNet->netAccess, &tpNet->rxBuffer[tpNet->rxCount],
+                         &rxLength, remainingTime))
+    {
+      tpNet->rxCount += rxLength;
+      result = true;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpNetReceive ***/
+
+
+/************************************************************************************//**
+** \brief     Checks the DTO counter of a response packet against the expected one and
+**            updates the expected one for the next response packet.
+** \param     tpNet Pointer to the transport layer object.
+** \param     header Pointer to the header of the response packet.
+** \param     inSequence Set to true if the DTO counter was as expected, or if it was
+**            not yet known. Set to false otherwise.
+**
+****************************************************************************************/
+static void XcpTpNetCheckDtoCounter(tXcpTpNetObj * tpNet, uint8_t const * header,
+                                    bool * inSequence)
+{
+  uint32_t dtoCounter;
+
+  /* Extract the DTO counter. It is stored in the same byte order as the CRO counter. */
+  dtoCounter = (uint32_t)header[0] | ((uint32_t)header[1] << 8) |
+               ((uint32_t)header[2] << 16) | ((uint32_t)header[3] << 24);
+  /* Compare it with the expected one. */
+  *inSequence = (!tpNet->dtoCounterValid) || (dtoCounter == tpNet->dtoCounter);
+  /* Update the expected one for the next response packet. */
+  tpNet->dtoCounter = dtoCounter + 1u;
+  tpNet->dtoCounterValid = true;
+} /*** end of XcpTpNetCheckDtoCounter ***/
 
 
 /*********************************** end of xcptpnet.c *********************************/
@@ -49,6 +49,7 @@ typedef struct t_xcp_tp_net_settings
 {
   char const * address;          /**< Target IP-address or hostname on the network.    */
   uint16_t port;                 /**< TCP port to use.                                 */
+  uint32_t window;               /**< Maximum number of commands in flight.            */
 } tXcpTpNetSettings;
 
 
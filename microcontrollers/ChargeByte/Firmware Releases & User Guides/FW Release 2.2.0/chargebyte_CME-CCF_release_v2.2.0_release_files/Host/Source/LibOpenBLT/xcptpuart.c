@@ -49,15 +49,51 @@
 ****************************************************************************************/
 #define UART_START_FRAME_LENGTH 13
 
+/** \brief Size of the reception ring buffer. It should be able to hold at least one
+ *         complete packet, including its length byte.
+ */
+#define XCP_TP_UART_RX_BUFFER_SIZE     (1024u)
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Object of the UART transport layer. Each one manages its own serial port. */
+typedef struct t_xcp_tp_uart_obj
+{
+  /** \brief The settings to use in this transport layer. */
+  tXcpTpUartSettings settings;
+  /** \brief Handle of the serial port object. */
+  tSerialPortHandle serialPort;
+  /** \brief Flag to indicate that the start frame was already sent on the port. */
+  bool startMsgSent;
+  /** \brief Buffer for the packet to transmit. +1 because the first byte for an XCP
+   *         packet on the UART transport layer contains the packet length.
+   */
+  uint8_t txBuffer[XCPLOADER_PACKET_SIZE_MAX + 1];
+  /** \brief Ring buffer with the bytes that were read from the serial port, but that
+   *         are not yet processed.
+   */
+  uint8_t rxBuffer[XCP_TP_UART_RX_BUFFER_SIZE];
+  /** \brief Index of the oldest byte in the \ref rxBuffer ring buffer. */
+  uint32_t rxHead;
+  /** \brief Number of bytes in the \ref rxBuffer ring buffer. */
+  uint32_t rxCount;
+} tXcpTpUartObj;
+
+
 /****************************************************************************************
 * Function prototypes
 ****************************************************************************************/
-static void XcpTpUartInit(void const * settings);
-static void XcpTpUartTerminate(void);
-static bool XcpTpUartConnect(void);
-static void XcpTpUartDisconnect(void);
-static bool XcpTpUartSendPacket(tXcpTransportPacket const * txPacket, 
+static void * XcpTpUartInit(void const * settings);
+static void XcpTpUartTerminate(void * handle);
+static bool XcpTpUartConnect(void * handle);
+static void XcpTpUartDisconnect(void * handle);
+static bool XcpTpUartSendPacket(void * handle, tXcpTransportPacket const * txPacket, 
                                 tXcpTransportPacket * rxPacket, uint16_t timeout);
+static void XcpTpUartRxBufferReset(tXcpTpUartObj * tpUart);
+static bool XcpTpUartRxBufferFill(tXcpTpUartObj * tpUart, uint32_t timeout);
+static bool XcpTpUartRxBufferExtract(tXcpTpUartObj * tpUart,
+                                     tXcpTransportPacket * rxPacket);
 
  
 /****************************************************************************************
@@ -70,18 +106,16 @@ static const tXcpTransport uartTransport =
   XcpTpUartTerminate,
   XcpTpUartConnect,
   XcpTpUartDisconnect,
-  XcpTpUartSendPacket
+  XcpTpUartSendPacket,
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+  NULL
 };
 
 
-/****************************************************************************************
-* Local data declarations
-****************************************************************************************/
-/** \brief The settings to use in this transport layer. */
-static tXcpTpUartSettings tpUartSettings;
-static int uart_start_msg_sent = false;
-
-
 /***********************************************************************************//**
 ** \brief     Obtains a pointer to the transport layer structure, so that it can be 
 **            linked to the XCP protocol module.
@@ -97,25 +131,29 @@ tXcpTransport const * XcpTpUartGetTransport(void)
 /************************************************************************************//**
 ** \brief     Initializes the transport layer.
 ** \param     settings Pointer to settings structure.
-** \return    None.
+** \return    Handle of the transport layer object if successful, NULL otherwise.
 **
 ****************************************************************************************/
-static void XcpTpUartInit(void const * settings)
+static void * XcpTpUartInit(void const * settings)
 {
+  tXcpTpUartObj * tpUart = NULL;
   char * uartPortName;
 
-  /* Reset transport layer settings. */
-  tpUartSettings.portname = NULL;
-  tpUartSettings.baudrate = 0;
-  
   /* Check parameters. */
   assert(settings != NULL);
 
   /* Only continue with valid parameters. */
   if (settings != NULL) /*lint !e774 */
+  {
+    /* Create the transport layer object. */
+    tpUart = calloc(1, sizeof(tXcpTpUartObj));
+    assert(tpUart != NULL);
+  }
+  /* Only continue if the transport layer object was created. */
+  if (tpUart != NULL) /*lint !e774 */
   {
     /* Shallow copy the transport layer settings for layer usage. */
-    tpUartSettings = *((tXcpTpUartSettings *)settings);
+    tpUart->settings = *((tXcpTpUartSettings *)settings);
     /* The portname is a pointer and it is not guaranteed that it stays valid so we need
      * to deep copy this one. note the +1 for '\0' in malloc.
      */
@@ -127,88 +165,90 @@ static void XcpTpUartInit(void const * settings)
       if (uartPortName != NULL) /*lint !e774 */
       {
         strcpy(uartPortName, ((tXcpTpUartSettings *)settings)->portname);
-        tpUartSettings.portname = uartPortName;
+        tpUart->settings.portname = uartPortName;
       }
     }
+    /* Initialize the reception ring buffer. */
+    XcpTpUartRxBufferReset(tpUart);
+    /* Create the serial port object. */
+    tpUart->serialPort = SerialPortInit();
+    /* Clean up if one of the allocations failed. */
+    if ( (tpUart->settings.portname == NULL) || (tpUart->serialPort == NULL) )
+    {
+      XcpTpUartTerminate(tpUart);
+      tpUart = NULL;
+    }
   }
-  /* Initialize the serial port. */
-  SerialPortInit();
+  /* Give the result back to the caller. */
+  return tpUart;
 } /*** end of XcpTpUartInit ***/
 
 
 /************************************************************************************//**
 ** \brief     Terminates the transport layer.
+** \param     handle Handle of the transport layer object.
 **
 ****************************************************************************************/
-static void XcpTpUartTerminate(void)
+static void XcpTpUartTerminate(void * handle)
 {
-  /* Terminate the serial port. */
-  SerialPortTerminate();
-  /* Release memory that was allocated for storing the port name. */
-  if (tpUartSettings.portname != NULL)
+  tXcpTpUartObj * tpUart = (tXcpTpUartObj *)handle;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only continue with valid parameters. */
+  if (tpUart != NULL) /*lint !e774 */
   {
-    free((char *)tpUartSettings.portname);
+    /* Terminate the serial port object. */
+    if (tpUart->serialPort != NULL)
+    {
+      SerialPortTerminate(tpUart->serialPort);
+    }
+    /* Release memory that was allocated for storing the port name. */
+    if (tpUart->settings.portname != NULL)
+    {
+      free((char *)tpUart->settings.portname);
+    }
+    /* Release the transport layer object. */
+    free(tpUart);
   }
-  /* Reset transport layer settings. */
-  tpUartSettings.portname = NULL;
-  tpUartSettings.baudrate = 0;
 } /*** end of XcpTpUartTerminate ***/
 
 
 /************************************************************************************//**
 ** \brief     Connects to the transport layer.
+** \param     handle Handle of the transport layer object.
 ** \return    True is connected, false otherwise.
 **
 ****************************************************************************************/
-static bool XcpTpUartConnect(void)
+static bool XcpTpUartConnect(void * handle)
 {
+  tXcpTpUartObj * tpUart = (tXcpTpUartObj *)handle;
   bool result = false;
-  bool baudrateSupported;
-  tSerialPortBaudrate baudrate;
   
-  /* Check if the specified baudrate is supported by the serial port driver. */
-  baudrateSupported = (tpUartSettings.baudrate == 9600) || 
-                      (tpUartSettings.baudrate == 19200) ||
-                      (tpUartSettings.baudrate == 38400) ||
-                      (tpUartSettings.baudrate == 57600) ||
-                      (tpUartSettings.baudrate == 115200);
-                      
-  /* Check transport layer settings. */
-  assert(tpUartSettings.portname != NULL);
-  assert(baudrateSupported);
-                      
-  /* Only continue if the transport layer settings are valid. */
-  if ( (tpUartSettings.portname != NULL) && (baudrateSupported) ) /*lint !e774 */
+  /* Check parameters and transport layer settings. */
+  assert(handle != NULL);
+  assert(tpUart->settings.portname != NULL);
+  assert(tpUart->settings.baudrate > 0);
+
+  /* Only continue if the transport layer settings are valid. Note that the serial port
+   * driver supports arbitrary baudrates, so there is no list of supported ones.
+   */
+  if ( (tpUart != NULL) && (tpUart->settings.portname != NULL) &&
+       (tpUart->settings.baudrate > 0) ) /*lint !e774 */
   {
-    /* Convert the numeric baudrate to the one supported by the serial port driver. */
-    switch (tpUartSettings.baudrate) 
-    {
-      case 115200:
-        baudrate = SERIALPORT_BR115200;
-        break;
-      case 57600:
-        baudrate = SERIALPORT_BR57600;
-        break;
-      case 38400:
-        baudrate = SERIALPORT_BR38400;
-        break;
-      case 19200:
-        baudrate = SERIALPORT_BR19200;
-        break;
-      case 9600:
-      default:
-        baudrate = SERIALPORT_BR9600;
-        break;
-    }
     /* Connect to the serial port. */
-    result = SerialPortOpen(tpUartSettings.portname, baudrate);
+    result = SerialPortOpen(tpUart->serialPort, tpUart->settings.portname,
+                            tpUart->settings.baudrate);
+    /* Start with an empty reception ring buffer. */
+    XcpTpUartRxBufferReset(tpUart);
 	
-	if(result == true && uart_start_msg_sent == false)
+	if(result == true && tpUart->startMsgSent == false)
 	{
-		uart_start_msg_sent = true;
+		tpUart->startMsgSent = true;
 		uint8_t uartstartBuffer[UART_START_FRAME_LENGTH+1] = {0xD, 0xAA,0x55,0x01,0x07,0x67,0x06,0x00,0x00,0x02,0xFF,0x00,0x9B,0x10};
 		/* Transmit the packet. */
-		if (!SerialPortWrite(uartstartBuffer, UART_START_FRAME_LENGTH+1))
+		if (!SerialPortWrite(tpUart->serialPort, uartstartBuffer, UART_START_FRAME_LENGTH+1))
 		{
 			printf("Start frame failed\n");
 			result = false;
@@ -222,18 +262,29 @@ static bool XcpTpUartConnect(void)
 
 /************************************************************************************//**
 ** \brief     Disconnects from the transport layer.
+** \param     handle Handle of the transport layer object.
 **
 ****************************************************************************************/
-static void XcpTpUartDisconnect(void)
+static void XcpTpUartDisconnect(void * handle)
 {
-  /* Disconnect from the serial port. */
-  SerialPortClose();
+  tXcpTpUartObj * tpUart = (tXcpTpUartObj *)handle;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only continue with valid parameters. */
+  if (tpUart != NULL) /*lint !e774 */
+  {
+    /* Disconnect from the serial port. */
+    SerialPortClose(tpUart->serialPort);
+  }
 } /*** end of XcpTpUartDisconnect ***/
 
 
 /************************************************************************************//**
 ** \brief     Transmits an XCP packet on the transport layer and attempts to receive the
 **            response packet within the specified timeout.
+** \param     handle Handle of the transport layer object.
 ** \param     txPacket Pointer to the packet to transmit.
 ** \param     rxPacket Pointer where the received packet info is stored.
 ** \param     timeout Maximum time in milliseconds to wait for the reception of the
@@ -241,24 +292,23 @@ static void XcpTpUartDisconnect(void)
 ** \return    True is successful and a response packet was received, false otherwise.
 **
 ****************************************************************************************/
-static bool XcpTpUartSendPacket(tXcpTransportPacket const * txPacket, 
+static bool XcpTpUartSendPacket(void * handle, tXcpTransportPacket const * txPacket, 
                                 tXcpTransportPacket * rxPacket, uint16_t timeout)
 {
+  tXcpTpUartObj * tpUart = (tXcpTpUartObj *)handle;
   bool result = false;
   uint16_t byteIdx;
-  /* uartBuffer is static to lower the stack load. +1 because the first byte for an XCP 
-   * packet on the UART transport layer contains the packet length.
-   */
-  static uint8_t uartBuffer[XCPLOADER_PACKET_SIZE_MAX + 1]; 
-  uint32_t responseTimeoutTime = 0;
-  bool packetReceptionComplete;
+  uint64_t responseTimeoutTime = 0;
+  uint64_t remainingTime;
+  bool packetReceptionComplete = false;
 
   /* Check parameters. */
+  assert(handle != NULL);
   assert(txPacket != NULL);
   assert(rxPacket != NULL);
 
   /* Only continue with valid parameters. */
-  if ( (txPacket != NULL) && (rxPacket != NULL) ) /*lint !e774 */
+  if ( (tpUart != NULL) && (txPacket != NULL) && (rxPacket != NULL) ) /*lint !e774 */
   {
     /* Set result value to okay and only change it from now on if an error occurred. */
     result = true;
@@ -266,13 +316,17 @@ static bool XcpTpUartSendPacket(tXcpTransportPacket const * txPacket,
      * the XCP packet data but just the length of the packet is added to the first 
      * byte.
      */
-    uartBuffer[0] = txPacket->len;
+    tpUart->txBuffer[0] = txPacket->len;
     for (byteIdx=0; byteIdx<txPacket->len; byteIdx++)
     {
-      uartBuffer[byteIdx + 1] = txPacket->data[byteIdx];
+      tpUart->txBuffer[byteIdx + 1] = txPacket->data[byteIdx];
     }
+    /* Discard bytes that are still buffered, for example the remainder of a response
+     * that arrived after its timeout. These cannot belong to the upcoming response.
+     */
+    XcpTpUartRxBufferReset(tpUart);
     /* Transmit the packet. */
-    if (!SerialPortWrite(uartBuffer, txPacket->len + 1))
+    if (!SerialPortWrite(tpUart->serialPort, tpUart->txBuffer, txPacket->len + 1))
     {
       result = false;
     }
@@ -281,57 +335,22 @@ static bool XcpTpUartSendPacket(tXcpTransportPacket const * txPacket,
     if (result)
     {
       /* Determine timeout time for the response packet. */
-      responseTimeoutTime = UtilTimeGetSystemTimeMs() + timeout;
-      /* Initialize packet reception length. */
-      rxPacket->len = 0;
-      /* Poll with timeout detection to receive the first byte. This one contains the
-       * packet length and cannot be zero.
+      responseTimeoutTime = UtilTimeDeadlineUs((uint64_t)timeout * 1000u);
+      /* Read data from the serial port into the ring buffer, until it holds the
+       * complete response packet. Each read obtains all data that is available at that
+       * point and only waits for the time that remains until the timeout time.
        */
-      while (UtilTimeGetSystemTimeMs() < responseTimeoutTime)
+      packetReceptionComplete = XcpTpUartRxBufferExtract(tpUart, rxPacket);
+      while (!packetReceptionComplete)
       {
-        if (SerialPortRead(&rxPacket->len, 1))
+        remainingTime = UtilTimeDeadlineRemainingUs(responseTimeoutTime);
+        if (remainingTime == 0)
         {
-          /* Length received. Validate it before accepting it */
-          if (rxPacket->len > 0)
-          {
-            /* Start of packet received. Stop this loop to continue with the
-             * reception of the packet.
-             */
-            break;
-          }
+          break;
         }
-      }
-      /* Check if a valid start of packet was received, in which case the first 
-       * byte won't have a zero value.
-       */
-      if (rxPacket->len == 0)
-      {
-        /* No valid start of packet received, so a timeout occurred. */
-        result = false;
-      }
-    }
-      
-    /* Only continue with reception if a valid pacekt lenght was received. */
-    if (result)
-    {
-      /* Continue with reception of the packet. */
-      packetReceptionComplete = false;
-      byteIdx = 0;
-      /* Poll with timeout detection to receive the full packet. */
-      while (UtilTimeGetSystemTimeMs() < responseTimeoutTime)
-      {
-        /* Check if the next byte was received. */
-        if (SerialPortRead(&rxPacket->data[byteIdx], 1))
+        if (XcpTpUartRxBufferFill(tpUart, (uint32_t)remainingTime))
         {
-          /* Check if the packet reception is now complete. */
-          if ((byteIdx + 1) == rxPacket->len)
-          {
-            /* Set flag and stop the loop. */
-            packetReceptionComplete = true;
-            break;
-          }
-          /* Increment indexer to the next byte. */
-          byteIdx++;
+          packetReceptionComplete = XcpTpUartRxBufferExtract(tpUart, rxPacket);
         }
       }
       /* Check if a timeout occurred. */
@@ -346,4 +365,106 @@ static bool XcpTpUartSendPacket(tXcpTransportPacket const * txPacket,
 } /*** end of XcpTpUartSendPacket ***/
 
 
+/************************************************************************************//**
+** \brief     Empties the reception ring buffer.
+** \param     tpUart Pointer to the transport layer object.
+**
+****************************************************************************************/
+static void XcpTpUartRxBufferReset(tXcpTpUartObj * tpUart)
+{
+  tpUart->rxHead = 0;
+  tpUart->rxCount = 0;
+} /*** end of XcpTpUartRxBufferReset ***/
+
+
+/************************************************************************************//**
+** \brief     Reads the data that is available on the serial port into the free space of
+**            the reception ring buffer. Waits for data to arrive, if none is available
+**            yet.
+** \param     tpUart Pointer to the transport layer object.
+** \param     timeout Maximum time in microseconds to wait for data to arrive.
+** \return    True if data was added to the ring buffer, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpUartRxBufferFill(tXcpTpUartObj * tpUart, uint32_t timeout)
+{
+  bool result = false;
+  uint32_t tail;
+  uint32_t space;
+  uint32_t bytesRead;
+
+  /* Determine the free space that directly follows the newest byte. Reading only into
+   * the contiguous part keeps it at one system call. The rest of the free space is
+   * used by the next call.
+   */
+  tail = (tpUart->rxHead + tpUart->rxCount) % XCP_TP_UART_RX_BUFFER_SIZE;
+  space = XCP_TP_UART_RX_BUFFER_SIZE - tpUart->rxCount;
+  if (space > (XCP_TP_UART_RX_BUFFER_SIZE - tail))
+  {
+    space = XCP_TP_UART_RX_BUFFER_SIZE - tail;
+  }
+  /* Only continue if there is free space. */
+  if (space > 0)
+  {
+    bytesRead = SerialPortReadAvailable(tpUart->serialPort, &tpUart->rxBuffer[tail],
+                                        space, timeout);
+    if (bytesRead > 0)
+    {
+      tpUart->rxCount += bytesRead;
+      result = true;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpUartRxBufferFill ***/
+
+
+/************************************************************************************//**
+** \brief     Extracts the next complete packet from the reception ring buffer. The first
+**            byte of a packet contains its length, which cannot be zero. Zero bytes in
+**            front of a packet are therefore skipped.
+** \param     tpUart Pointer to the transport layer object.
+** \param     rxPacket Pointer where the received packet info is stored.
+** \return    True if a complete packet was extracted, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpUartRxBufferExtract(tXcpTpUartObj * tpUart,
+                                     tXcpTransportPacket * rxPacket)
+{
+  bool result = false;
+  uint8_t packetLen;
+  uint32_t byteIdx;
+
+  /* Skip bytes that cannot be the start of a packet. */
+  while ( (tpUart->rxCount > 0) && (tpUart->rxBuffer[tpUart->rxHead] == 0) )
+  {
+    tpUart->rxHead = (tpUart->rxHead + 1) % XCP_TP_UART_RX_BUFFER_SIZE;
+    tpUart->rxCount--;
+  }
+  /* Check if the start of a packet is present. */
+  if (tpUart->rxCount > 0)
+  {
+    packetLen = tpUart->rxBuffer[tpUart->rxHead];
+    /* Check if the packet is complete. */
+    if (tpUart->rxCount >= ((uint32_t)packetLen + 1))
+    {
+      /* Copy the packet. */
+      rxPacket->len = packetLen;
+      for (byteIdx = 0; byteIdx < packetLen; byteIdx++)
+      {
+        rxPacket->data[byteIdx] =
+          tpUart->rxBuffer[(tpUart->rxHead + 1 + byteIdx) %
+                           XCP_TP_UART_RX_BUFFER_SIZE];
+      }
+      /* Remove the packet from the ring buffer. */
+      tpUart->rxHead = (tpUart->rxHead + packetLen + 1) % XCP_TP_UART_RX_BUFFER_SIZE;
+      tpUart->rxCount -= ((uint32_t)packetLen + 1);
+      result = true;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpUartRxBufferExtract ***/
+
+
 /*********************************** end of xcptpuart.c ********************************/
@@ -0,0 +1,842 @@
+/************************************************************************************//**
+* \file         xcptpudp.c
+* \brief        XCP UDP/IP transport layer source file.
+* \ingroup      XcpTpUdp
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+* 
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+* 
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+*
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include <assert.h>                         /* for assertions                          */
+#include <stdint.h>                         /* for standard integer types              */
+#include <stddef.h>                         /* for NULL declaration                    */
+#include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
+#include <string.h>                         /* for string library                      */
+#include "session.h"                        /* Communication session module            */
+#include "xcploader.h"                      /* XCP loader module                       */
+#include "xcptpudp.h"                       /* XCP UDP/IP transport layer              */
+#include "udpaccess.h"                      /* UDP/IP network access module            */
+#include "util.h"                           /* Utility module                          */
+
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Size of the header that precedes each packet. It holds a 32-bit counter. */
+#define XCP_TP_UDP_HEADER_SIZE         (4u)
+
+/** \brief Maximum number of datagrams that are sent or received in one batch. */
+#define XCP_TP_UDP_BATCH_MAX           (16u)
+
+/** \brief Maximum number of times that a command is retransmitted, after the timeout
+ *         of its response expired.
+ */
+#define XCP_TP_UDP_RETRANSMIT_MAX      (2u)
+
+/* XCP command codes of the commands that can safely be retransmitted. */
+#define XCP_TP_UDP_CMD_GET_STATUS      (0xFDu)    /**< XCP get status command code.    */
+#define XCP_TP_UDP_CMD_SET_MTA         (0xF6u)    /**< XCP set mta command code.       */
+#define XCP_TP_UDP_CMD_PROGRAM_START   (0xD2u)    /**< XCP program start command code. */
+#define XCP_TP_UDP_CMD_PROGRAM_CLEAR   (0xD1u)    /**< XCP program clear command code. */
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Object of the UDP/IP transport layer. Each one manages its own socket. */
+typedef struct t_xcp_tp_udp_obj
+{
+  /** \brief The settings to use in this transport layer. */
+  tXcpTpUdpSettings settings;
+  /** \brief Handle of the UDP network access object for the socket. */
+  tUdpAccessHandle udpAccess;
+  /** \brief Command receive object (CRO) counter. The counter value is added to the
+   *         header of each command packet and incremented for each packet. A
+   *         retransmitted datagram keeps its counter value.
+   */
+  uint32_t croCounter;
+  /** \brief Data transfer object (DTO) counter that is expected in the next response
+   *         datagram. The target increments its counter for each response. Datagrams
+   *         with an older counter value are duplicated or stale and get dropped.
+   */
+  uint32_t dtoCounter;
+  /** \brief Flag to indicate that the DTO counter of the target is known. It becomes
+   *         known with the first response datagram of a connection.
+   */
+  bool dtoCounterValid;
+  /** \brief Number of commands that were submitted, but for which the response was not
+   *         yet collected.
+   */
+  uint32_t inFlight;
+  /** \brief Buffers with the start of the datagrams that are prepared for
+   *         transmission. This is the header with the CRO counter, followed by the head
+   *         of the packet.
+   */
+  uint8_t txBuffer[XCP_TP_UDP_BATCH_MAX]
+                  [XCPLOADER_PACKET_SIZE_MAX + XCP_TP_UDP_HEADER_SIZE];
+  /** \brief Lengths of the data in \ref txBuffer. */
+  uint32_t txLength[XCP_TP_UDP_BATCH_MAX];
+  /** \brief Pointers to the remaining data of the datagrams that are prepared for
+   *         transmission. This data is not copied, but sent straight from the buffer
+   *         of the caller.
+   */
+  uint8_t const * txData[XCP_TP_UDP_BATCH_MAX];
+  /** \brief Lengths of the data that \ref txData points to. */
+  uint32_t txDataLength[XCP_TP_UDP_BATCH_MAX];
+  /** \brief Number of datagrams in \ref txBuffer that are not yet sent. */
+  uint32_t txCount;
+  /** \brief Buffers with the received datagrams. Note the extra byte, which makes it
+   *         possible to detect datagrams that are too long, as they get truncated.
+   */
+  uint8_t rxBuffer[XCP_TP_UDP_BATCH_MAX]
+                  [XCPLOADER_PACKET_SIZE_MAX + XCP_TP_UDP_HEADER_SIZE + 1u];
+  /** \brief Lengths of the datagrams in \ref rxBuffer. */
+  uint32_t rxLength[XCP_TP_UDP_BATCH_MAX];
+  /** \brief Index of the next datagram in \ref rxBuffer to process. */
+  uint32_t rxIndex;
+  /** \brief Number of received datagrams in \ref rxBuffer. */
+  uint32_t rxCount;
+} tXcpTpUdpObj;
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+static void * XcpTpUdpInit(void const * settings);
+static void XcpTpUdpTerminate(void * handle);
+static bool XcpTpUdpConnect(void * handle);
+static void XcpTpUdpDisconnect(void * handle);
+static bool XcpTpUdpSendPacket(void * handle, tXcpTransportPacket const * txPacket,
+                               tXcpTransportPacket * rxPacket, uint16_t timeout);
+static uint32_t XcpTpUdpGetWindow(void * handle);
+static bool XcpTpUdpSubmitPacket(void * handle, tXcpTransportTxVector const * txVector);
+static bool XcpTpUdpCollectPacket(void * handle, tXcpTransportPacket * rxPacket,
+                                  uint8_t resLen, uint16_t timeout);
+static bool XcpTpUdpSendPacketVector(void * handle,
+                                     tXcpTransportTxVector const * txVector,
+                                     tXcpTransportRxVector * rxVector,
+                                     uint16_t timeout);
+static bool XcpTpUdpIsUnreliable(void * handle);
+static void XcpTpUdpQueuePacket(tXcpTpUdpObj * tpUdp,
+                                tXcpTransportTxVector const * txVector);
+static bool XcpTpUdpFlush(tXcpTpUdpObj * tpUdp);
+static bool XcpTpUdpReceive(tXcpTpUdpObj * tpUdp, tXcpTransportRxVector * rxVector,
+                            uint64_t timeoutTime);
+static bool XcpTpUdpCheckDtoCounter(tXcpTpUdpObj * tpUdp, uint8_t const * header);
+static void XcpTpUdpDiscard(tXcpTpUdpObj * tpUdp);
+static bool XcpTpUdpIsRetransmittable(tXcpTransportTxVector const * txVector);
+
+ 
+/****************************************************************************************
+* Local constant declarations
+****************************************************************************************/
+/** \brief XCP transport layer structure filled with UDP/IP specifics. */
+static const tXcpTransport udpTransport =
+{
+  XcpTpUdpInit,
+  XcpTpUdpTerminate,
+  XcpTpUdpConnect,
+  XcpTpUdpDisconnect,
+  XcpTpUdpSendPacket,
+  NULL,
+  XcpTpUdpGetWindow,
+  XcpTpUdpSubmitPacket,
+  XcpTpUdpCollectPacket,
+  XcpTpUdpSendPacketVector,
+  XcpTpUdpIsUnreliable
+};
+
+
+/***********************************************************************************//**
+** \brief     Obtains a pointer to the transport layer structure, so that it can be 
+**            linked to the XCP protocol module.
+** \return    Pointer to transport layer structure.
+**
+****************************************************************************************/
+tXcpTransport const * XcpTpUdpGetTransport(void)
+{
+  return &udpTransport;
+} /*** end of XcpTpUdpGetTransport ***/
+
+
+/************************************************************************************//**
+** \brief     Initializes the transport layer.
+** \param     settings Pointer to settings structure.
+** \return    Handle of the transport layer object if successful, NULL otherwise.
+**
+****************************************************************************************/
+static void * XcpTpUdpInit(void const * settings)
+{
+  tXcpTpUdpObj * tpUdp = NULL;
+  char * udpAddress;
+
+  /* Check parameters. */
+  assert(settings != NULL);
+
+  /* Only continue with valid parameters. */
+  if (settings != NULL) /*lint !e774 */
+  {
+    /* Create the transport layer object. */
+    tpUdp = calloc(1, sizeof(tXcpTpUdpObj));
+    assert(tpUdp != NULL);
+  }
+  /* Only continue if the transport layer object was created. */
+  if (tpUdp != NULL) /*lint !e774 */
+  {
+    /* Shallow copy the transport layer settings for layer usage. */
+    tpUdp->settings = *((tXcpTpUdpSettings *)settings);
+    /* The address is a pointer and it is not guaranteed that it stays valid so we need
+     * to deep copy this one. note the +1 for '\0' in malloc.
+     */
+    assert(((tXcpTpUdpSettings *)settings)->address != NULL);
+    if (((tXcpTpUdpSettings *)settings)->address != NULL) /*lint !e774 */
+    {
+      udpAddress = malloc(strlen(((tXcpTpUdpSettings *)settings)->address) + 1);
+      assert(udpAddress != NULL);
+      if (udpAddress != NULL) /*lint !e774 */
+      {
+        strcpy(udpAddress, ((tXcpTpUdpSettings *)settings)->address);
+        tpUdp->settings.address = udpAddress;
+      }
+    }
+    /* Create the UDP network access object. */
+    tpUdp->udpAccess = UdpAccessInit();
+    /* Clean up if one of the allocations failed. */
+    if ( (tpUdp->settings.address == NULL) || (tpUdp->udpAccess == NULL) )
+    {
+      XcpTpUdpTerminate(tpUdp);
+      tpUdp = NULL;
+    }
+  }
+  /* Give the result back to the caller. */
+  return tpUdp;
+} /*** end of XcpTpUdpInit ***/
+
+
+/************************************************************************************//**
+** \brief     Terminates the transport layer.
+** \param     handle Handle of the transport layer object.
+**
+****************************************************************************************/
+static void XcpTpUdpTerminate(void * handle)
+{
+  tXcpTpUdpObj * tpUdp = (tXcpTpUdpObj *)handle;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only continue with valid parameters. */
+  if (tpUdp != NULL) /*lint !e774 */
+  {
+    /* Terminate the UDP network access object. */
+    if (tpUdp->udpAccess != NULL)
+    {
+      UdpAccessTerminate(tpUdp->udpAccess);
+    }
+    /* Release memory that was allocated for storing the network address. */
+    if (tpUdp->settings.address != NULL)
+    {
+      free((char *)tpUdp->settings.address);
+    }
+    /* Release the transport layer object. */
+    free(tpUdp);
+  }
+} /*** end of XcpTpUdpTerminate ***/
+
+
+/************************************************************************************//**
+** \brief     Connects to the transport layer. For UDP/IP, this only prepares the
+**            socket. No data is exchanged with the target.
+** \param     handle Handle of the transport layer object.
+** \return    True is connected, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpUdpConnect(void * handle)
+{
+  tXcpTpUdpObj * tpUdp = (tXcpTpUdpObj *)handle;
+  bool result = false;
+
+  /* Check parameters and transport layer settings. */
+  assert(handle != NULL);
+  assert(tpUdp->settings.address != NULL);
+  assert(tpUdp->settings.port != 0);
+
+  /* Only continue if the transport layer settings are valid. */
+  if ( (tpUdp != NULL) && (tpUdp->settings.address != NULL) &&
+       (tpUdp->settings.port != 0) ) /*lint !e774 */
+  {
+    /* Initialize the CRO counter. */
+    tpUdp->croCounter = 1;
+    /* The DTO counter becomes known with the first response datagram. */
+    tpUdp->dtoCounterValid = false;
+    /* Start without commands in flight and without buffered datagrams. */
+    tpUdp->inFlight = 0;
+    tpUdp->txCount = 0;
+    tpUdp->rxIndex = 0;
+    tpUdp->rxCount = 0;
+    /* Connect via the UDP network access object. */
+    result = UdpAccessConnect(tpUdp->udpAccess, tpUdp->settings.address,
+                              tpUdp->settings.port);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpUdpConnect ***/
+
+
+/************************************************************************************//**
+** \brief     Disconnects from the transport layer.
+** \param     handle Handle of the transport layer object.
+**
+****************************************************************************************/
+static void XcpTpUdpDisconnect(void * handle)
+{
+  tXcpTpUdpObj * tpUdp = (tXcpTpUdpObj *)handle;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only continue with valid parameters. */
+  if (tpUdp != NULL) /*lint !e774 */
+  {
+    /* Disconnect via the UDP network access object. */
+    UdpAccessDisconnect(tpUdp->udpAccess);
+  }
+} /*** end of XcpTpUdpDisconnect ***/
+
+
+/************************************************************************************//**
+** \brief     Transmits an XCP packet on the transport layer and attempts to receive the
+**            response packet within the specified timeout.
+** \param     handle Handle of the transport layer object.
+** \param     txPacket Pointer to the packet to transmit.
+** \param     rxPacket Pointer where the received packet info is stored.
+** \param     timeout Maximum time in milliseconds to wait for the reception of the
+**            response packet.
+** \return    True is successful and a response packet was received, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpUdpSendPacket(void * handle, tXcpTransportPacket const * txPacket,
+                               tXcpTransportPacket * rxPacket, uint16_t timeout)
+{
+  tXcpTpUdpObj * tpUdp = (tXcpTpUdpObj *)handle;
+  bool result = false;
+  tXcpTransportTxVector txVector;
+  tXcpTransportRxVector rxVector;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+  assert(txPacket != NULL);
+  assert(rxPacket != NULL);
+
+  /* Only continue with valid parameters. */
+  if ( (tpUdp != NULL) && (txPacket != NULL) && (rxPacket != NULL) ) /*lint !e774 */
+  {
+    /* Describe the packets as vectors, which consist of just the head. */
+    txVector.head = txPacket->data;
+    txVector.headLen = txPacket->len;
+    txVector.data = NULL;
+    txVector.dataLen = 0;
+    rxVector.head = rxPacket->data;
+    rxVector.headSize = sizeof(rxPacket->data);
+    rxVector.data = NULL;
+    rxVector.dataSize = 0;
+    /* Exchange the packets. */
+    result = XcpTpUdpSendPacketVector(handle, &txVector, &rxVector, timeout);
+    if (result)
+    {
+      rxPacket->len = rxVector.len;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpUdpSendPacket ***/
+
+
+/************************************************************************************//**
+** \brief     Transmits an XCP packet, that is described by a vector, on the transport
+**            layer and attempts to receive the response packet within the specified
+**            timeout. The data of the packet is sent straight from the buffer of the
+**            vector. A datagram can get lost, so the command is retransmitted each time
+**            the timeout expires, if this is safe for the command.
+** \param     handle Handle of the transport layer object.
+** \param     txVector Pointer to the vector of the packet to transmit.
+** \param     rxVector Pointer to the vector where the received packet is stored.
+** \param     timeout Maximum time in milliseconds to wait for the reception of the
+**            response packet.
+** \return    True is successful and a response packet was received, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpUdpSendPacketVector(void * handle,
+                                     tXcpTransportTxVector const * txVector,
+                                     tXcpTransportRxVector * rxVector,
+                                     uint16_t timeout)
+{
+  tXcpTpUdpObj * tpUdp = (tXcpTpUdpObj *)handle;
+  bool result = false;
+  uint8_t retransmitCnt = 0;
+  tUdpAccessBuffer txBuffers[2];
+  tUdpAccessTxDatagram txDatagram;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+  assert(txVector != NULL);
+  assert(rxVector != NULL);
+
+  /* Only continue with valid parameters. */
+  if ( (tpUdp != NULL) && (txVector != NULL) && (rxVector != NULL) ) /*lint !e774 */
+  {
+    /* Discard datagrams that are still pending, for example a response that arrived
+     * after its timeout. They cannot belong to the upcoming response. The same
+     * applies to the responses of commands that are still in flight.
+     */
+    XcpTpUdpDiscard(tpUdp);
+    tpUdp->txCount = 0;
+    tpUdp->inFlight = 0;
+    /* Prepare the datagram. It is sent directly, so remove it from the batch again. */
+    XcpTpUdpQueuePacket(tpUdp, txVector);
+    tpUdp->txCount = 0;
+    txBuffers[0].data = &tpUdp->txBuffer[0][0];
+    txBuffers[0].length = tpUdp->txLength[0];
+    txBuffers[1].data = tpUdp->txData[0];
+    txBuffers[1].length = tpUdp->txDataLength[0];
+    txDatagram.buffers = txBuffers;
+    txDatagram.count = 2;
+    /* Send the datagram and wait for the response. */
+    for (;;)
+    {
+      if (!UdpAccessSend(tpUdp->udpAccess, &txDatagram, 1))
+      {
+        break;
+      }
+      result = XcpTpUdpReceive(tpUdp, rxVector,
+                               UtilTimeDeadlineUs((uint64_t)timeout * 1000u));
+      /* Done if the response was received or if the command should not be
+       * retransmitted.
+       */
+      if ( (result) || (retransmitCnt >= XCP_TP_UDP_RETRANSMIT_MAX) ||
+           (!XcpTpUdpIsRetransmittable(txVector)) )
+      {
+        break;
+      }
+      retransmitCnt++;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpUdpSendPacketVector ***/
+
+
+/************************************************************************************//**
+** \brief     Determines if packets can get lost, duplicated or reordered. This is
+**            always the case for UDP datagrams.
+** \param     handle Handle of the transport layer object.
+** \return    True.
+**
+****************************************************************************************/
+static bool XcpTpUdpIsUnreliable(void * handle)
+{
+  /* Not needed, because it applies to all UDP/IP transport layer objects. */
+  (void)handle;
+
+  return true;
+} /*** end of XcpTpUdpIsUnreliable ***/
+
+
+/************************************************************************************//**
+** \brief     Obtains the maximum number of commands that can be in flight.
+** \param     handle Handle of the transport layer object.
+** \return    The configured window size. 1 if pipelining is disabled.
+**
+****************************************************************************************/
+static uint32_t XcpTpUdpGetWindow(void * handle)
+{
+  tXcpTpUdpObj * tpUdp = (tXcpTpUdpObj *)handle;
+  uint32_t result = 1;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* A window of 0 is treated the same as a window of 1. */
+  if ( (tpUdp != NULL) && (tpUdp->settings.window > 1) ) /*lint !e774 */
+  {
+    result = tpUdp->settings.window;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpUdpGetWindow ***/
+
+
+/************************************************************************************//**
+** \brief     Submits an XCP packet for transmission, without waiting for the response
+**            packet. The datagrams of submitted packets are collected in a batch, which
+**            is sent as soon as it is full or once a response is collected. Its
+**            response is obtained later on with XcpTpUdpCollectPacket().
+** \param     handle Handle of the transport layer object.
+** \param     txVector Pointer to the vector of the packet to transmit.
+** \return    True is successful, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpUdpSubmitPacket(void * handle, tXcpTransportTxVector const * txVector)
+{
+  tXcpTpUdpObj * tpUdp = (tXcpTpUdpObj *)handle;
+  bool result = false;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+  assert(txVector != NULL);
+  assert(tpUdp->inFlight < XcpTpUdpGetWindow(handle));
+
+  /* Only continue with valid parameters and if the window is not yet full. */
+  if ( (tpUdp != NULL) && (txVector != NULL) &&
+       (tpUdp->inFlight < XcpTpUdpGetWindow(handle)) ) /*lint !e774 */
+  {
+    /* Add the packet to the batch. */
+    XcpTpUdpQueuePacket(tpUdp, txVector);
+    tpUdp->inFlight++;
+    result = true;
+    /* Send the batch, once it is full. */
+    if (tpUdp->txCount >= XCP_TP_UDP_BATCH_MAX)
+    {
+      result = XcpTpUdpFlush(tpUdp);
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpUdpSubmitPacket ***/
+
+
+/************************************************************************************//**
+** \brief     Attempts to receive the response packet of the oldest submitted command,
+**            within the specified timeout. Datagrams keep their boundaries, so the
+**            length of the positive response is not needed to locate it. Submitted
+**            commands are not retransmitted, because they advance the target's memory
+**            transfer address. If a datagram got lost, the XCP loader recovers by setting
+**            the memory transfer address again and resending the commands.
+** \param     handle Handle of the transport layer object.
+** \param     rxPacket Pointer where the received packet info is stored.
+** \param     resLen Length of a positive response packet.
+** \param     timeout Maximum time in milliseconds to wait for the reception of the
+**            response packet.
+** \return    True is successful and a response packet was received, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpUdpCollectPacket(void * handle, tXcpTransportPacket * rxPacket,
+                                  uint8_t resLen, uint16_t timeout)
+{
+  tXcpTpUdpObj * tpUdp = (tXcpTpUdpObj *)handle;
+  bool result = false;
+  tXcpTransportRxVector rxVector;
+
+  /* The packet length follows from the datagram length. */
+  (void)resLen;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+  assert(rxPacket != NULL);
+  assert(tpUdp->inFlight > 0);
+
+  /* Only continue with valid parameters and if a command is in flight. */
+  if ( (tpUdp != NULL) && (rxPacket != NULL) && (tpUdp->inFlight > 0) ) /*lint !e774 */
+  {
+    /* Send the datagrams of the commands that were submitted since the last batch. */
+    result = XcpTpUdpFlush(tpUdp);
+    /* Receive the response. */
+    if (result)
+    {
+      rxVector.head = rxPacket->data;
+      rxVector.headSize = sizeof(rxPacket->data);
+      rxVector.data = NULL;
+      rxVector.dataSize = 0;
+      result = XcpTpUdpReceive(tpUdp, &rxVector,
+                               UtilTimeDeadlineUs((uint64_t)timeout * 1000u));
+    }
+    if (result)
+    {
+      rxPacket->len = rxVector.len;
+      tpUdp->inFlight--;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpUdpCollectPacket ***/
+
+
+/************************************************************************************//**
+** \brief     Prepares the datagram for an XCP packet and adds it to the batch of
+**            datagrams to send. The CRO counter is added in front of the head of the
+**            packet. The data of the packet is not copied, so it must stay valid until
+**            the datagram is sent. Note that the caller must make sure that the batch is
+**            not yet full.
+** \param     tpUdp Pointer to the transport layer object.
+** \param     txVector Pointer to the vector of the packet to transmit.
+**
+****************************************************************************************/
+static void XcpTpUdpQueuePacket(tXcpTpUdpObj * tpUdp,
+                                tXcpTransportTxVector const * txVector)
+{
+  uint8_t * datagram;
+
+  /* Check parameters. */
+  assert(tpUdp->txCount < XCP_TP_UDP_BATCH_MAX);
+
+  /* Prepare the XCP packet for transmission via UDP/IP. This is basically the same
+   * as the XCP packet data but just the CRO counter of the packet is added to the
+   * first four bytes.
+   */
+  datagram = &tpUdp->txBuffer[tpUdp->txCount][0];
+  datagram[0] = (uint8_t)tpUdp->croCounter;
+  datagram[1] = (uint8_t)(tpUdp->croCounter >> 8);
+  datagram[2] = (uint8_t)(tpUdp->croCounter >> 16);
+  datagram[3] = (uint8_t)(tpUdp->croCounter >> 24);
+  /* Increment the CRO counter for the next packet. */
+  tpUdp->croCounter++;
+  /* Copy the head of the packet and refer to its data. */
+  memcpy(&datagram[XCP_TP_UDP_HEADER_SIZE], txVector->head, txVector->headLen);
+  tpUdp->txLength[tpUdp->txCount] = txVector->headLen + XCP_TP_UDP_HEADER_SIZE;
+  tpUdp->txData[tpUdp->txCount] = txVector->data;
+  tpUdp->txDataLength[tpUdp->txCount] = txVector->dataLen;
+  tpUdp->txCount++;
+} /*** end of XcpTpUdpQueuePacket ***/
+
+
+/************************************************************************************//**
+** \brief     Sends the datagrams of the batch that are not yet sent.
+** \param     tpUdp Pointer to the transport layer object.
+** \return    True is successful, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpUdpFlush(tXcpTpUdpObj * tpUdp)
+{
+  bool result = true;
+  tUdpAccessBuffer txBuffers[XCP_TP_UDP_BATCH_MAX][2];
+  tUdpAccessTxDatagram txDatagrams[XCP_TP_UDP_BATCH_MAX];
+  uint32_t idx;
+
+  /* Only send if there is something to send. */
+  if (tpUdp->txCount > 0)
+  {
+    for (idx = 0; idx < tpUdp->txCount; idx++)
+    {
+      txBuffers[idx][0].data = &tpUdp->txBuffer[idx][0];
+      txBuffers[idx][0].length = tpUdp->txLength[idx];
+      txBuffers[idx][1].data = tpUdp->txData[idx];
+      txBuffers[idx][1].length = tpUdp->txDataLength[idx];
+      txDatagrams[idx].buffers = &txBuffers[idx][0];
+      txDatagrams[idx].count = 2;
+    }
+    result = UdpAccessSend(tpUdp->udpAccess, txDatagrams, tpUdp->txCount);
+    tpUdp->txCount = 0;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpUdpFlush ***/
+
+
+/************************************************************************************//**
+** \brief     Obtains the next response packet. Datagrams are received in batches, so a
+**            previously received datagram is used first, if available. Datagrams that
+**            are too short or too long to hold a response packet are skipped, just like
+**            duplicated and stale ones, which are detected with the DTO counter.
+** \param     tpUdp Pointer to the transport layer object.
+** \param     rxVector Pointer to the vector where the received packet is stored.
+** \param     timeoutTime Monotonic time in microseconds at which reception times out.
+** \return    True if a response packet was received, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpUdpReceive(tXcpTpUdpObj * tpUdp, tXcpTransportRxVector * rxVector,
+                            uint64_t timeoutTime)
+{
+  bool result = false;
+  tUdpAccessDatagram rxDatagrams[XCP_TP_UDP_BATCH_MAX];
+  uint8_t const * packet;
+  uint64_t remainingTime;
+  uint32_t length;
+  uint32_t headCnt;
+  uint32_t dataCnt;
+  uint32_t idx;
+
+  while (!result)
+  {
+    /* Receive a new batch of datagrams, if all previously received ones were
+     * processed.
+     */
+    if (tpUdp->rxIndex >= tpUdp->rxCount)
+    {
+      tpUdp->rxIndex = 0;
+      tpUdp->rxCount = 0;
+      remainingTime = UtilTimeDeadlineRemainingUs(timeoutTime);
+      if (remainingTime == 0)
+      {
+        break;
+      }
+      for (idx = 0; idx < XCP_TP_UDP_BATCH_MAX; idx++)
+      {
+        rxDatagrams[idx].data = &tpUdp->rxBuffer[idx][0];
+        rxDatagrams[idx].length = sizeof(tpUdp->rxBuffer[0]);
+      }
+      tpUdp->rxCount = UdpAccessReceive(tpUdp->udpAccess, rxDatagrams,
+                                        XCP_TP_UDP_BATCH_MAX,
+                                        (uint32_t)remainingTime);
+      if (tpUdp->rxCount == 0)
+      {
+        break;
+      }
+      for (idx = 0; idx < tpUdp->rxCount; idx++)
+      {
+        tpUdp->rxLength[idx] = rxDatagrams[idx].length;
+      }
+    }
+    /* Process the next datagram. It must at least have a DTO counter (32-bits) and
+     * one byte in the response data.
+     */
+    length = tpUdp->rxLength[tpUdp->rxIndex];
+    if ( (length > XCP_TP_UDP_HEADER_SIZE) &&
+         (length <= (XCPLOADER_PACKET_SIZE_MAX + XCP_TP_UDP_HEADER_SIZE)) &&
+         (XcpTpUdpCheckDtoCounter(tpUdp, &tpUdp->rxBuffer[tpUdp->rxIndex][0])) )
+    {
+      rxVector->len = (uint8_t)(length - XCP_TP_UDP_HEADER_SIZE);
+      packet = &tpUdp->rxBuffer[tpUdp->rxIndex][XCP_TP_UDP_HEADER_SIZE];
+      /* Copy the packet to the buffers of the reception vector. Bytes that do not fit
+       * are dropped.
+       */
+      headCnt = rxVector->len;
+      if (headCnt > rxVector->headSize)
+      {
+        headCnt = rxVector->headSize;
+      }
+      dataCnt = rxVector->len - headCnt;
+      if (dataCnt > rxVector->dataSize)
+      {
+        dataCnt = rxVector->dataSize;
+      }
+      memcpy(rxVector->head, packet, headCnt);
+      if (dataCnt > 0)
+      {
+        memcpy(rxVector->data, &packet[headCnt], dataCnt);
+      }
+      result = true;
+    }
+    tpUdp->rxIndex++;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpUdpReceive ***/
+
+
+/************************************************************************************//**
+** \brief     Checks the DTO counter of a response datagram against the expected one and
+**            updates the expected one for the next response datagram. A counter value
+**            that is newer than expected is accepted, because it just means that
+**            responses got lost.
+** \param     tpUdp Pointer to the transport layer object.
+** \param     header Pointer to the header of the response datagram.
+** \return    True if the datagram should be processed, false if it is a duplicated or
+**            stale one that should be dropped.
+**
+****************************************************************************************/
+static bool XcpTpUdpCheckDtoCounter(tXcpTpUdpObj * tpUdp, uint8_t const * header)
+{
+  bool result = true;
+  uint32_t dtoCounter;
+
+  /* Extract the DTO counter. It is stored in the same byte order as the CRO counter. */
+  dtoCounter = (uint32_t)header[0] | ((uint32_t)header[1] << 8) |
+               ((uint32_t)header[2] << 16) | ((uint32_t)header[3] << 24);
+  /* Compare it with the expected one, taking into account that it can wrap around. */
+  if ( (tpUdp->dtoCounterValid) && ((int32_t)(dtoCounter - tpUdp->dtoCounter) < 0) )
+  {
+    result = false;
+  }
+  /* Update the expected one for the next response datagram. */
+  if (result)
+  {
+    tpUdp->dtoCounter = dtoCounter + 1u;
+    tpUdp->dtoCounterValid = true;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpUdpCheckDtoCounter ***/
+
+
+/************************************************************************************//**
+** \brief     Discards all datagrams that were received, but that are not yet
+**            processed.
+** \param     tpUdp Pointer to the transport layer object.
+**
+****************************************************************************************/
+static void XcpTpUdpDiscard(tXcpTpUdpObj * tpUdp)
+{
+  tUdpAccessDatagram rxDatagrams[XCP_TP_UDP_BATCH_MAX];
+  uint32_t idx;
+
+  /* Drop the datagrams of the last batch. */
+  tpUdp->rxIndex = 0;
+  tpUdp->rxCount = 0;
+  /* Drop the datagrams that are pending at the socket. */
+  do
+  {
+    for (idx = 0; idx < XCP_TP_UDP_BATCH_MAX; idx++)
+    {
+      rxDatagrams[idx].data = &tpUdp->rxBuffer[idx][0];
+      rxDatagrams[idx].length = sizeof(tpUdp->rxBuffer[0]);
+    }
+  }
+  while (UdpAccessReceive(tpUdp->udpAccess, rxDatagrams, XCP_TP_UDP_BATCH_MAX, 0) > 0);
+} /*** end of XcpTpUdpDiscard ***/
+
+
+/************************************************************************************//**
+** \brief     Determines if a command can be retransmitted. This is the case if
+**            executing the command twice has the same effect as executing it once.
+**            That is not the case for commands that advance the memory transfer
+**            address (MTA) and for commands that are followed up by another one with
+**            results that depend on it. CONNECT is already retried by the XCP loader.
+** \param     txVector Pointer to the vector of the command packet.
+** \return    True if the command can be retransmitted, false otherwise.
+**
+****************************************************************************************/
+static bool XcpTpUdpIsRetransmittable(tXcpTransportTxVector const * txVector)
+{
+  bool result = false;
+
+  if (txVector->headLen > 0)
+  {
+    if ( (txVector->head[0] == XCP_TP_UDP_CMD_GET_STATUS) ||
+         (txVector->head[0] == XCP_TP_UDP_CMD_SET_MTA) ||
+         (txVector->head[0] == XCP_TP_UDP_CMD_PROGRAM_START) ||
+         (txVector->head[0] == XCP_TP_UDP_CMD_PROGRAM_CLEAR) )
+    {
+      result = true;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpTpUdpIsRetransmittable ***/
+
+
+/*********************************** end of xcptpudp.c *********************************/
@@ -0,0 +1,71 @@
+/************************************************************************************//**
+* \file         xcptpudp.h
+* \brief        XCP UDP/IP transport layer header file.
+* \ingroup      XcpTpUdp
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+* 
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+* 
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+*
+* \endinternal
+****************************************************************************************/
+/************************************************************************************//**
+* \defgroup   XcpTpUdp XCP UDP/IP transport layer
+* \brief      This module implements the XCP transport layer for UDP/IP.
+* \ingroup    XcpLoader
+* \details
+* Each XCP packet is sent in its own datagram, with the same 32-bit counter header as
+* the TCP/IP transport layer. There is no connection setup, so a session starts with
+* the first command. A command that got no response within the timeout of the XCP
+* loader is retransmitted, but only if executing it twice is harmless.
+****************************************************************************************/
+#ifndef XCPTPUDP_H
+#define XCPTPUDP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Layout of structure with settings specific to the XCP transport layer module
+ *         for UDP/IP.
+ */
+typedef struct t_xcp_tp_udp_settings
+{
+  char const * address;          /**< Target IP-address or hostname on the network.    */
+  uint16_t port;                 /**< UDP port to use.                                 */
+  uint32_t window;               /**< Maximum number of commands in flight.            */
+} tXcpTpUdpSettings;
+
+
+/***************************************************************************************
+* Function prototypes
+****************************************************************************************/
+tXcpTransport const * XcpTpUdpGetTransport(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XCPTPUDP_H */
+/*********************************** end of xcptpudp.h *********************************/
@@ -44,14 +44,27 @@
 #include "usbbulk.h"                        /* USB bulk driver                         */
 
 
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Object of the USB transport layer. */
+typedef struct t_xcp_tp_usb_obj
+{
+  /** \brief Buffer for the packet to transmit. +1 because the first byte for an XCP
+   *         packet on the USB transport layer contains the packet length.
+   */
+  uint8_t txBuffer[XCPLOADER_PACKET_SIZE_MAX + 1];
+} tXcpTpUsbObj;
+
+
 /****************************************************************************************
 * Function prototypes
 ****************************************************************************************/
-static void XcpTpUsbInit(void const * settings);
-static void XcpTpUsbTerminate(void);
-static bool XcpTpUsbConnect(void);
-static void XcpTpUsbDisconnect(void);
-static bool XcpTpUsbSendPacket(tXcpTransportPacket const * txPacket, 
+static void * XcpTpUsbInit(void const * settings);
+static void XcpTpUsbTerminate(void * handle);
+static bool XcpTpUsbConnect(void * handle);
+static void XcpTpUsbDisconnect(void * handle);
+static bool XcpTpUsbSendPacket(void * handle, tXcpTransportPacket const * txPacket, 
                                tXcpTransportPacket * rxPacket, uint16_t timeout);
 
  
@@ -65,10 +78,25 @@ static const tXcpTransport usbTransport =
   XcpTpUsbTerminate,
   XcpTpUsbConnect,
   XcpTpUsbDisconnect,
-  XcpTpUsbSendPacket
+  XcpTpUsbSendPacket,
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+  NULL
 };
 
 
+/****************************************************************************************
+* Local data declarations
+****************************************************************************************/
+/** \brief Flag to indicate that a transport layer object uses the USB bulk driver. The
+ *         driver only supports one device at a time, so there can only be one object.
+ */
+static bool tpUsbInUse = false;
+
+
 /***********************************************************************************//**
 ** \brief     Obtains a pointer to the transport layer structure, so that it can be 
 **            linked to the XCP protocol module.
@@ -84,39 +112,71 @@ tXcpTransport const * XcpTpUsbGetTransport(void)
 /************************************************************************************//**
 ** \brief     Initializes the transport layer.
 ** \param     settings Pointer to settings structure.
-** \return    None.
+** \return    Handle of the transport layer object if successful, NULL otherwise.
 **
 ****************************************************************************************/
-static void XcpTpUsbInit(void const * settings)
+static void * XcpTpUsbInit(void const * settings)
 {
+  tXcpTpUsbObj * tpUsb = NULL;
+
   /* No settings needed for this transport layer. */
   (void)settings;
 
-  /* Initialize the USB bulk driver. */
-  UsbBulkInit();
+  /* Only continue if the USB bulk driver is not yet used by another object. */
+  if (!tpUsbInUse)
+  {
+    /* Create the transport layer object. */
+    tpUsb = malloc(sizeof(tXcpTpUsbObj));
+    assert(tpUsb != NULL);
+    if (tpUsb != NULL) /*lint !e774 */
+    {
+      tpUsbInUse = true;
+      /* Initialize the USB bulk driver. */
+      UsbBulkInit();
+    }
+  }
+  /* Give the result back to the caller. */
+  return tpUsb;
 } /*** end of XcpTpUsbInit ***/
 
 
 /************************************************************************************//**
 ** \brief     Terminates the transport layer.
+** \param     handle Handle of the transport layer object.
 **
 ****************************************************************************************/
-static void XcpTpUsbTerminate(void)
+static void XcpTpUsbTerminate(void * handle)
 {
-  /* Terminate the USB bulk driver. */
-  UsbBulkTerminate();
+  tXcpTpUsbObj * tpUsb = (tXcpTpUsbObj *)handle;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only continue with valid parameters. */
+  if (tpUsb != NULL) /*lint !e774 */
+  {
+    /* Terminate the USB bulk driver. */
+    UsbBulkTerminate();
+    /* Release the transport layer object. */
+    free(tpUsb);
+    tpUsbInUse = false;
+  }
 } /*** end of XcpTpUsbTerminate ***/
 
 
 /************************************************************************************//**
 ** \brief     Connects to the transport layer.
+** \param     handle Handle of the transport layer object.
 ** \return    True is connected, false otherwise.
 **
 ****************************************************************************************/
-static bool XcpTpUsbConnect(void)
+static bool XcpTpUsbConnect(void * handle)
 {
   bool result;
-                      
+
+  /* The USB bulk driver manages the one and only device. */
+  (void)handle;
+
   /* Connect to USB device via USB bulk driver. */
   result = UsbBulkOpen();
   /* Give the result back to the caller. */
@@ -126,10 +186,14 @@ static bool XcpTpUsbConnect(void)
 
 /************************************************************************************//**
 ** \brief     Disconnects from the transport layer.
+** \param     handle Handle of the transport layer object.
 **
 ****************************************************************************************/
-static void XcpTpUsbDisconnect(void)
+static void XcpTpUsbDisconnect(void * handle)
 {
+  /* The USB bulk driver manages the one and only device. */
+  (void)handle;
+
   /* Disconnect from USB device via USB bulk driver. */
   UsbBulkClose();
 } /*** end of XcpTpUsbDisconnect ***/
@@ -138,6 +202,7 @@ static void XcpTpUsbDisconnect(void)
 /************************************************************************************//**
 ** \brief     Transmits an XCP packet on the transport layer and attempts to receive the
 **            response packet within the specified timeout.
+** \param     handle Handle of the transport layer object.
 ** \param     txPacket Pointer to the packet to transmit.
 ** \param     rxPacket Pointer where the received packet info is stored.
 ** \param     timeout Maximum time in milliseconds to wait for the reception of the
@@ -145,23 +210,21 @@ static void XcpTpUsbDisconnect(void)
 ** \return    True is successful and a response packet was received, false otherwise.
 **
 ****************************************************************************************/
-static bool XcpTpUsbSendPacket(tXcpTransportPacket const * txPacket, 
+static bool XcpTpUsbSendPacket(void * handle, tXcpTransportPacket const * txPacket, 
                                tXcpTransportPacket * rxPacket, uint16_t timeout)
 {
+  tXcpTpUsbObj * tpUsb = (tXcpTpUsbObj *)handle;
   bool result = false;
   uint16_t byteIdx;
-  /* usbBuffer is static to lower the stack load. +1 because the first byte for an XCP 
-   * packet on the USB transport layer contains the packet lenght. 
-   */
-  static uint8_t usbBuffer[XCPLOADER_PACKET_SIZE_MAX + 1]; 
-  uint32_t responseTimeoutTime = 0;
+  uint64_t responseTimeoutTime = 0;
 
   /* Check parameters. */
+  assert(handle != NULL);
   assert(txPacket != NULL);
   assert(rxPacket != NULL);
 
   /* Only continue with valid parameters. */
-  if ( (txPacket != NULL) && (rxPacket != NULL) ) /*lint !e774 */
+  if ( (tpUsb != NULL) && (txPacket != NULL) && (rxPacket != NULL) ) /*lint !e774 */
   {
     /* Set result value to okay and only change it from now on if an error occurred. */
     result = true;
@@ -169,13 +232,13 @@ static bool XcpTpUsbSendPacket(tXcpTransportPacket const * txPacket,
      * the XCP packet data but just the length of the packet is added to the first 
      * byte.
      */
-    usbBuffer[0] = txPacket->len;
+    tpUsb->txBuffer[0] = txPacket->len;
     for (byteIdx=0; byteIdx<txPacket->len; byteIdx++)
     {
-      usbBuffer[byteIdx + 1] = txPacket->data[byteIdx];
+      tpUsb->txBuffer[byteIdx + 1] = txPacket->data[byteIdx];
     }
     /*  Transmit the packet via the USB bulk driver. */
-    if (!UsbBulkWrite(usbBuffer, txPacket->len + 1))
+    if (!UsbBulkWrite(tpUsb->txBuffer, txPacket->len + 1))
     {
       result = false;
     }
@@ -184,7 +247,7 @@ static bool XcpTpUsbSendPacket(tXcpTransportPacket const * txPacket,
     if (result)
     {
       /* Determine timeout time for the response packet. */
-      responseTimeoutTime = UtilTimeGetSystemTimeMs() + timeout;
+      responseTimeoutTime = UtilTimeDeadlineUs((uint64_t)timeout * 1000u);
       /* Initialize packet reception length. */
       rxPacket->len = 0;
       /* Receive the first byte. This one contains the packet length and cannot be
@@ -208,15 +271,15 @@ static bool XcpTpUsbSendPacket(tXcpTransportPacket const * txPacket,
     if (result)
     {
       /* Check if there is still time available before the initial timeout. */
-      uint32_t currentTime = UtilTimeGetSystemTimeMs();
-      if (currentTime >= responseTimeoutTime)
+      uint32_t remainingTime = UtilTimeDeadlineRemainingMs(responseTimeoutTime);
+      if (remainingTime == 0)
       {
         result = false;
       }
       else
       {
         /* Receive the actual packet data. */
-        if (!UsbBulkRead(&rxPacket->data[0], rxPacket->len, responseTimeoutTime - currentTime))
+        if (!UsbBulkRead(&rxPacket->data[0], rxPacket->len, remainingTime))
         {
           result = false;
         }
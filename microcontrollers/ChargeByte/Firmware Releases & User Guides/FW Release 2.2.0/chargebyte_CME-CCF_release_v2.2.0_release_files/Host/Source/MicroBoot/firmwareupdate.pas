@@ -714,16 +714,31 @@ begin
       // Update the log.
       FLogString := FInfoString;
       Synchronize(@SynchronizeLogEvent);
-      // Stop the session
-      BltSessionStop();
-      // Update the info.
-      FInfoString := 'Firmware update completed successfully';
-      Synchronize(@SynchronizeInfoEvent);
-      // Update the log.
-      FLogString := FInfoString;
-      Synchronize(@SynchronizeLogEvent);
-      // Trigger the OnDone event
-      Synchronize(@SynchronizeDoneEvent);
+      // Stop the session. This fails if the programming session could not be completed
+      // properly, in which case the bootloader does not start the user program.
+      if BltSessionStop() <> BLT_RESULT_OK then
+      begin
+        // Set error flag.
+        errorDetected := True;
+        // Update the log.
+        FLogString := 'Could not finish the programming session';
+        Synchronize(@SynchronizeLogEvent);
+        // Trigger error.
+        FErrorString := FLogString;
+        Synchronize(@SynchronizeErrorEvent);
+      end;
+      // Report the completion if all is okay.
+      if not errorDetected then
+      begin
+        // Update the info.
+        FInfoString := 'Firmware update completed successfully';
+        Synchronize(@SynchronizeInfoEvent);
+        // Update the log.
+        FLogString := FInfoString;
+        Synchronize(@SynchronizeLogEvent);
+        // Trigger the OnDone event
+        Synchronize(@SynchronizeDoneEvent);
+      end;
       // Transition back to the idle state.
       FState := FUS_IDLE;
     end
@@ -828,6 +843,7 @@ begin
       transportSettingsXcpCan.transmitId := transportXcpCanConfig.TransmitId;
       transportSettingsXcpCan.receiveId := transportXcpCanConfig.ReceiveId;
       transportSettingsXcpCan.useExtended := transportXcpCanConfig.ExtendedId;
+      transportSettingsXcpCan.txFrameGap := 0;
       // Point the transport settings pointer to this one.
       transportSettingsPtr := @transportSettingsXcpCan;
     end
@@ -849,6 +865,7 @@ begin
       // Copy over the settings.
       transportSettingsXcpNet.address := PAnsiChar(AnsiString(transportXcpTcpIpConfig.Address));
       transportSettingsXcpNet.port := transportXcpTcpIpConfig.Port;
+      transportSettingsXcpNet.window := 1;
       // Point the transport settings pointer to this one.
       transportSettingsPtr := @transportSettingsXcpNet;
     end;
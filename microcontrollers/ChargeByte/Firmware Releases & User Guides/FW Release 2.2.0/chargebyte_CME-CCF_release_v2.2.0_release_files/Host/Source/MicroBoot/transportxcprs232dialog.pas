@@ -145,7 +145,7 @@ begin
   else
     CmbDevice.Text := FTransportXcpRs232Config.Device;
   CmbBaudrate.ItemIndex := 0;
-  for baudIdx := 0 to (CmbDevice.Items.Count - 1) do
+  for baudIdx := 0 to (CmbBaudrate.Items.Count - 1) do
   begin
     // Is this combobox entry the currently configured value?
     if StrToInt(CmbBaudrate.Items[baudIdx]) = FTransportXcpRs232Config.Baudrate then
@@ -0,0 +1,86 @@
+#!/bin/sh
+#
+# Shell script to benchmark firmware updates with BootCommander against the XcpSim
+# target simulation. The firmware file is flashed once on each simulated transport
+# layer. Afterwards XcpSim verifies that its flash memory holds the firmware data.
+#
+# Usage: bench.sh [XcpSim] [BootCommander] [firmware file] [XcpSim options]
+#
+# Additional XcpSim options, for example the erase and program times, are passed on to
+# each simulation. The TCP and UDP port can be changed with the XCPSIM_PORT environment
+# variable. Additional BootCommander options, for example the seed/key library that is
+# needed with the XcpSim -lock option, can be set with the BC_OPTS environment variable.
+# XCP on CAN is only benchmarked if the vcan0 network interface exists:
+#   sudo modprobe vcan
+#   sudo ip link add dev vcan0 type vcan
+#   sudo ip link set up vcan0
+#
+
+SIM="$1"
+BC="$2"
+FW="$3"
+shift 3
+PORT="${XCPSIM_PORT:-50000}"
+TMPDIR="${TMPDIR:-/tmp}"
+SIMLOG="$TMPDIR/xcpsim.$$.log"
+BCLOG="$TMPDIR/bootcommander.$$.log"
+PTYLINK="$TMPDIR/xcpsim.$$.tty"
+FAILED=0
+
+# Runs one benchmark. The first parameter is the transport layer name, followed by the
+# XcpSim options for the transport layer. BootCommander options follow after '--'.
+bench() {
+  transport="$1"
+  shift
+  simopts=""
+  while [ "$1" != "--" ]; do
+    simopts="$simopts $1"
+    shift
+  done
+  shift
+
+  echo "--------------------------------------------------------------------------"
+  echo "Benchmark $transport"
+  # Start the simulation and wait until it is ready.
+  "$SIM" -t="$transport" $simopts -exit "$@" "$FW" > "$SIMLOG" 2>&1 &
+  simpid=$!
+  while ! grep -q "Simulating target" "$SIMLOG" 2>/dev/null; do
+    if ! kill -0 "$simpid" 2>/dev/null; then
+      cat "$SIMLOG"
+      FAILED=1
+      return
+    fi
+    sleep 0.1
+  done
+  # Flash the firmware file and time it. Only show its output if it failed.
+  start=$(date +%s%N)
+  "$BC" -t="$transport" $BCOPTS $BC_OPTS -sm "$FW" > "$BCLOG" 2>&1
+  bcresult=$?
+  stop=$(date +%s%N)
+  if [ $bcresult -ne 0 ]; then
+    cat "$BCLOG"
+    kill "$simpid" 2>/dev/null
+    FAILED=1
+  fi
+  wait "$simpid" || FAILED=1
+  cat "$SIMLOG"
+  echo "  -> BootCommander time: $(( (stop - start) / 1000000 )) ms"
+}
+
+BCOPTS="-a=127.0.0.1 -p=$PORT"
+bench xcp_net -p="$PORT" -- "$@"
+bench xcp_udp -p="$PORT" -- "$@"
+BCOPTS="-d=$PTYLINK"
+bench xcp_rs232 -d="$PTYLINK" -- "$@"
+if ip link show vcan0 > /dev/null 2>&1; then
+  BCOPTS="-d=vcan0"
+  bench xcp_can -d=vcan0 -- "$@"
+fi
+
+rm -f "$SIMLOG" "$BCLOG"
+echo "--------------------------------------------------------------------------"
+if [ $FAILED -ne 0 ]; then
+  echo "[ERROR] One or more benchmarks failed."
+  exit 1
+fi
+echo "[OK] All benchmarks passed."
@@ -0,0 +1,140 @@
+#!/bin/sh
+#
+# Shell script to benchmark firmware updates with BootCommander against the XcpSim
+# target simulation, under different network conditions. The network conditions are
+# emulated by the -emu option of BootCommander. The firmware file is flashed once for
+# each combination of transport layer and network profile. Afterwards a table lists the
+# result, the effective throughput and the command/response latency of each run.
+#
+# Usage: benchmatrix.sh [XcpSim] [BootCommander] [firmware file] [XcpSim options]
+#
+# The network profiles are a space separated list of name=options pairs, where the
+# options are those of the BootCommander -emu option. They can be changed with the
+# XCPSIM_PROFILES environment variable. The transport layers to benchmark can be
+# changed with the XCPSIM_TRANSPORTS environment variable. The XCPSIM_PORT and BC_OPTS
+# environment variables work the same as for bench.sh. For example, to compare the
+# pipelined transfer over UDP/IP with different amounts of loss:
+#   XCPSIM_TRANSPORTS="xcp_udp" BC_OPTS="-w=8" \
+#   XCPSIM_PROFILES="clean=delay=0 loss=loss=0.01,seed=1" sh benchmatrix.sh ...
+# The throughput is the number of programmed bytes divided by the total time that
+# BootCommander ran, so it includes connecting, erasing and finishing the session. The
+# latency figures only cover the command/response exchanges that succeeded.
+#
+
+SIM="$1"
+BC="$2"
+FW="$3"
+shift 3
+PORT="${XCPSIM_PORT:-50000}"
+TMPDIR="${TMPDIR:-/tmp}"
+SIMLOG="$TMPDIR/xcpsim.$$.log"
+BCLOG="$TMPDIR/bootcommander.$$.log"
+RESULTS="$TMPDIR/benchmatrix.$$.txt"
+PTYLINK="$TMPDIR/xcpsim.$$.tty"
+PROFILES="${XCPSIM_PROFILES:-clean=delay=0 \
+lan=delay=200,jitter=100 \
+can_noisy=delay=500,jitter=2000,dup=0.005,seed=1 \
+wifi=delay=2000,jitter=8000,seed=2 \
+lossy=delay=500,loss=0.01,seed=3 \
+reorder=delay=200,reorder=0.2,seed=5}"
+TRANSPORTS="${XCPSIM_TRANSPORTS:-xcp_net xcp_udp xcp_rs232}"
+if [ -z "$XCPSIM_TRANSPORTS" ] && ip link show vcan0 > /dev/null 2>&1; then
+  TRANSPORTS="$TRANSPORTS xcp_can"
+fi
+FAILED=0
+
+# Extracts a number from a line of the BootCommander output. The first parameter is the
+# text in front of the number.
+bcvalue() {
+  sed -n "s/.*$1 \([0-9]*\).*/\1/p" "$BCLOG" | tail -n 1
+}
+
+# Runs one benchmark. The first parameter is the transport layer name, the second one
+# the name of the network profile and the third one its options. The XcpSim and
+# BootCommander options of the transport layer follow.
+bench() {
+  transport="$1"
+  profile="$2"
+  emuopts="$3"
+  shift 3
+
+  # Determine the options of the transport layer.
+  case "$transport" in
+    xcp_net|xcp_udp)
+      simopts="-p=$PORT"
+      bcopts="-a=127.0.0.1 -p=$PORT"
+      ;;
+    xcp_rs232)
+      simopts="-d=$PTYLINK"
+      bcopts="-d=$PTYLINK"
+      ;;
+    xcp_can)
+      simopts="-d=vcan0"
+      bcopts="-d=vcan0"
+      ;;
+    *)
+      echo "[ERROR] Unknown transport layer $transport."
+      FAILED=1
+      return
+      ;;
+  esac
+
+  echo "Benchmark $transport with profile $profile ($emuopts)"
+  # Start the simulation and wait until it is ready.
+  "$SIM" -t="$transport" $simopts -exit "$@" "$FW" > "$SIMLOG" 2>&1 &
+  simpid=$!
+  while ! grep -q "Simulating target" "$SIMLOG" 2>/dev/null; do
+    if ! kill -0 "$simpid" 2>/dev/null; then
+      cat "$SIMLOG"
+      FAILED=1
+      return
+    fi
+    sleep 0.1
+  done
+  # Flash the firmware file and time it. The output is needed for the latency figures,
+  # so silent mode cannot be used.
+  start=$(date +%s%N)
+  "$BC" -t="$transport" $bcopts $BC_OPTS -emu="$emuopts" "$FW" > "$BCLOG" 2>&1
+  bcresult=$?
+  stop=$(date +%s%N)
+  ms=$(( (stop - start) / 1000000 ))
+  if [ $bcresult -ne 0 ]; then
+    # A failed update leaves the simulation waiting for the next session.
+    kill "$simpid" 2>/dev/null
+    wait "$simpid" 2>/dev/null
+    printf "%-10s %-10s %-8s %9s %9s %9s %9s %9s\n" "$transport" "$profile" \
+      "FAIL($bcresult)" "$ms" "-" "-" "-" "-" >> "$RESULTS"
+    return
+  fi
+  # BootCommander must detect a corrupted flash memory. If the simulation still finds
+  # a mismatch after a successful update, the host failed to detect it.
+  simresult="OK"
+  wait "$simpid" || simresult="CORRUPT"
+  bytes=$(sed -n 's/.*Programmed bytes: \([0-9]*\).*/\1/p' "$SIMLOG")
+  printf "%-10s %-10s %-8s %9s %9s %9s %9s %9s\n" "$transport" "$profile" \
+    "$simresult" "$ms" "$(( ${bytes:-0} * 1000 / (ms * 1024 + 1) ))" \
+    "$(bcvalue 'Average total:')" "$(bcvalue '99th percentile total:')" \
+    "$(bcvalue 'Maximum total:')" >> "$RESULTS"
+  [ "$simresult" = "OK" ] || FAILED=1
+}
+
+printf "%-10s %-10s %-8s %9s %9s %9s %9s %9s\n" "Transport" "Profile" "Result" \
+  "Time[ms]" "kB/s" "Avg[us]" "P99[us]" "Max[us]" > "$RESULTS"
+for transport in $TRANSPORTS; do
+  for entry in $PROFILES; do
+    bench "$transport" "${entry%%=*}" "${entry#*=}" "$@"
+  done
+done
+
+echo "--------------------------------------------------------------------------"
+cat "$RESULTS"
+rm -f "$SIMLOG" "$BCLOG" "$RESULTS"
+echo "--------------------------------------------------------------------------"
+# Updates that fail under emulated faults are results as well, shown as FAIL with the
+# BootCommander exit code. A simulation that could not start or a corrupted flash memory
+# after a successful update counts as an error.
+if [ $FAILED -ne 0 ]; then
+  echo "[ERROR] One or more benchmarks failed."
+  exit 1
+fi
+echo "[OK] Benchmark matrix completed."
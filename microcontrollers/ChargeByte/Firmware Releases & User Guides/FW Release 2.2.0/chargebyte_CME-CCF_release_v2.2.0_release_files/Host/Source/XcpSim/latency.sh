@@ -0,0 +1,131 @@
+#!/bin/sh
+#
+# Shell script to measure the command/response latency of firmware updates with
+# BootCommander against the XcpSim target simulation. The firmware file is flashed a
+# number of times on each transport layer. Afterwards a table lists the number of
+# command/response exchanges and their average, 99th percentile and maximum time of
+# each run, followed by a summary per transport layer.
+#
+# Usage: latency.sh [XcpSim] [BootCommander] [firmware file] [XcpSim options]
+#
+# XCP on RS232 runs over a pseudo terminal pair, which XcpSim creates. A pseudo terminal
+# does not limit the data rate to the baudrate, so the latency shows the time that the
+# host and the target simulation need to handle a packet, without the time on the
+# line. XCP on TCP/IP runs over the loopback network interface, so the latency shows
+# the time of the TCP stack and of the socket handling on both sides, without the time
+# of a real network. The number of runs per transport layer can be changed with the
+# XCPSIM_RUNS environment variable. The XCPSIM_PORT and BC_OPTS environment variables
+# work the same as for bench.sh. The average host time is the part of the
+# command/response time that was spent in LibOpenBLT itself.
+#
+
+SIM="$1"
+BC="$2"
+FW="$3"
+shift 3
+TMPDIR="${TMPDIR:-/tmp}"
+SIMLOG="$TMPDIR/xcpsim.$$.log"
+BCLOG="$TMPDIR/bootcommander.$$.log"
+RESULTS="$TMPDIR/latency.$$.txt"
+PTYLINK="$TMPDIR/xcpsim.$$.tty"
+PORT="${XCPSIM_PORT:-50000}"
+RUNS="${XCPSIM_RUNS:-5}"
+FAILED=0
+
+# Extracts a number from a line of the BootCommander output. The first parameter is the
+# text in front of the number.
+bcvalue() {
+  sed -n "s/.*$1 \([0-9]*\).*/\1/p" "$BCLOG" | tail -n 1
+}
+
+# Runs one measurement. The first parameter is the transport layer name and the second
+# one the number of the run. The XcpSim options follow, up to '--'. The BootCommander
+# options follow after it.
+measure() {
+  transport="$1"
+  run="$2"
+  shift 2
+  simopts=""
+  while [ "$1" != "--" ]; do
+    simopts="$simopts $1"
+    shift
+  done
+  shift
+
+  echo "Measure $transport run $run"
+  # Start the simulation and wait until it is ready.
+  "$SIM" -t="$transport" $simopts -exit $SIM_OPTS "$FW" > "$SIMLOG" 2>&1 &
+  simpid=$!
+  while ! grep -q "Simulating target" "$SIMLOG" 2>/dev/null; do
+    if ! kill -0 "$simpid" 2>/dev/null; then
+      cat "$SIMLOG"
+      FAILED=1
+      return
+    fi
+    sleep 0.1
+  done
+  # Flash the firmware file. The output is needed for the latency figures, so silent
+  # mode cannot be used.
+  "$BC" -t="$transport" "$@" $BC_OPTS "$FW" > "$BCLOG" 2>&1
+  bcresult=$?
+  if [ $bcresult -ne 0 ]; then
+    cat "$BCLOG"
+    kill "$simpid" 2>/dev/null
+    wait "$simpid" 2>/dev/null
+    FAILED=1
+    return
+  fi
+  wait "$simpid" || FAILED=1
+  printf "%-10s %4s %10s %9s %9s %9s %9s\n" "$transport" "$run" \
+    "$(bcvalue 'Number of exchanges:')" "$(bcvalue 'Average total:')" \
+    "$(bcvalue 'Average host:')" "$(bcvalue '99th percentile total:')" \
+    "$(bcvalue 'Maximum total:')" >> "$RESULTS"
+}
+
+# The XcpSim options apply to each measurement.
+SIM_OPTS="$*"
+printf "%-10s %4s %10s %9s %9s %9s %9s\n" "Transport" "Run" "Exchanges" "Avg[us]" \
+  "Host[us]" "P99[us]" "Max[us]" > "$RESULTS"
+
+# XCP on RS232 over a pseudo terminal pair.
+run=1
+while [ $run -le "$RUNS" ]; do
+  measure xcp_rs232 $run -d="$PTYLINK" -- -d="$PTYLINK"
+  run=$(( run + 1 ))
+done
+
+# XCP on TCP/IP over the loopback network interface.
+run=1
+while [ $run -le "$RUNS" ]; do
+  measure xcp_net $run -p="$PORT" -- -a=127.0.0.1 -p="$PORT"
+  run=$(( run + 1 ))
+done
+
+echo "--------------------------------------------------------------------------"
+cat "$RESULTS"
+echo "--------------------------------------------------------------------------"
+# Summarize each transport layer: the average of the average times, weighted with the
+# number of exchanges, and the worst 99th percentile and maximum time of all runs.
+awk 'NR > 1 {
+       if (!($1 in runs)) { order[++count] = $1 }
+       runs[$1]++; exchanges[$1] += $3; total[$1] += $3 * $4; host[$1] += $3 * $5
+       if ($6 > p99[$1]) { p99[$1] = $6 }
+       if ($7 > max[$1]) { max[$1] = $7 }
+     }
+     END {
+       printf "%-10s %4s %10s %9s %9s %9s %9s\n", "Summary", "Runs", "Exchanges",
+              "Avg[us]", "Host[us]", "P99[us]", "Max[us]"
+       for (i = 1; i <= count; i++) {
+         t = order[i]
+         printf "%-10s %4d %10d %9d %9d %9d %9d\n", t, runs[t], exchanges[t],
+                total[t] / (exchanges[t] + (exchanges[t] == 0)),
+                host[t] / (exchanges[t] + (exchanges[t] == 0)), p99[t], max[t]
+       }
+     }' "$RESULTS"
+rm -f "$SIMLOG" "$BCLOG" "$RESULTS"
+echo "--------------------------------------------------------------------------"
+if [ $FAILED -ne 0 ]; then
+  echo "[ERROR] One or more measurements failed."
+  exit 1
+fi
+echo "[OK] Latency measurements completed."
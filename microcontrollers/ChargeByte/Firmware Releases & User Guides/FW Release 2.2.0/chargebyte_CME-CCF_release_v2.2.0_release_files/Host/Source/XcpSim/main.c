@@ -0,0 +1,1162 @@
+/************************************************************************************//**
+* \file         main.c
+* \brief        XcpSim program source file.
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+*
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+*
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+*
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#define _GNU_SOURCE                         /* for posix_openpt and cfmakeraw          */
+#include <assert.h>                         /* for assertions                          */
+#include <stdint.h>                         /* for standard integer types              */
+#include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
+#include <stdio.h>                          /* Standard I/O functions.                 */
+#include <string.h>                         /* for string library                      */
+#include <signal.h>                         /* for signal handling                     */
+#include <unistd.h>                         /* UNIX standard functions                 */
+#include <fcntl.h>                          /* file control operations                 */
+#include <poll.h>                           /* for polling file descriptors            */
+#include <termios.h>                        /* terminal I/O                            */
+#include <sys/socket.h>                     /* for sockets                             */
+#include <sys/ioctl.h>                      /* I/O control operations                  */
+#include <netinet/in.h>                     /* internet address family                 */
+#include <netinet/tcp.h>                    /* TCP protocol options                    */
+#include <net/if.h>                         /* network interfaces                      */
+#include <linux/can.h>                      /* CAN kernel definitions                  */
+#include <linux/can/raw.h>                  /* CAN raw sockets                         */
+#include "openblt.h"                        /* OpenBLT host library.                   */
+#include "xcpsim.h"                         /* XCP target simulation                   */
+
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Program return code indicating that the program executed successfully. */
+#define RESULT_OK                           (0)
+
+/** \brief Program return code indicating that an error was detected when processing the
+ *         command line parameters.
+ */
+#define RESULT_ERROR_COMMANDLINE            (1)
+
+/** \brief Program return code indicating that the target simulation could not be
+ *         created.
+ */
+#define RESULT_ERROR_SIMULATION_INIT        (2)
+
+/** \brief Program return code indicating that the transport layer could not be set up.
+ */
+#define RESULT_ERROR_TRANSPORT              (3)
+
+/** \brief Program return code indicating that the simulated flash memory does not hold
+ *         the data of the firmware file.
+ */
+#define RESULT_ERROR_FIRMWARE_VERIFY        (4)
+
+/** \brief Maximum number of flash memory regions that can be specified. */
+#define FLASH_REGIONS_MAX                   (16u)
+
+/** \brief Size of the header that precedes each packet on TCP/IP and UDP/IP. It holds
+ *         a 32-bit counter.
+ */
+#define NET_HEADER_SIZE                     (4u)
+
+/** \brief Size of the buffer for receiving the command data stream. */
+#define RX_BUFFER_SIZE                      (4096u)
+
+/** \brief Time in milliseconds to wait for data, before checking again if the program
+ *         should stop.
+ */
+#define POLL_TIMEOUT_MS                     (100)
+
+/** \brief Maximum time in milliseconds to wait for the host to close the pseudo
+ *         terminal, before closing it as well.
+ */
+#define PTY_DRAIN_TIMEOUT_MS                (1000u)
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Supported transport layers. Their names match the ones of BootCommander. */
+typedef enum
+{
+  TRANSPORT_RS232,                          /**< XCP on a pseudo terminal.             */
+  TRANSPORT_CAN,                            /**< XCP on SocketCAN.                     */
+  TRANSPORT_NET,                            /**< XCP on TCP/IP.                        */
+  TRANSPORT_UDP                             /**< XCP on UDP/IP.                        */
+} tTransport;
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+static void DisplayProgramInfo(void);
+static void DisplayProgramUsage(void);
+static void DisplaySimulationStats(void);
+static bool ParseCommandLine(int argc, char const * const argv[]);
+static bool ParseFlashGeometry(char const * geometry);
+static bool RunTransportRs232(void);
+static bool RunTransportCan(void);
+static bool RunTransportNet(void);
+static bool RunTransportUdp(void);
+static bool VerifyFirmwareFile(void);
+static bool KeepRunning(void);
+static void StopSignalHandler(int signum);
+
+
+/****************************************************************************************
+* Local data declarations
+****************************************************************************************/
+/** \brief Handle to the target simulation. */
+static tXcpSimHandle simulation;
+
+/** \brief Settings of the target simulation, as specified on the command line. */
+static tXcpSimSettings simSettings;
+
+/** \brief Flash memory regions, as specified on the command line. */
+static tXcpSimRegion flashRegions[FLASH_REGIONS_MAX];
+
+/** \brief The transport layer to simulate the target on. */
+static tTransport transport;
+
+/** \brief Name of the device. For CAN this is the network interface, for RS232 the
+ *         optional name of a symbolic link to the pseudo terminal.
+ */
+static char const * deviceStr;
+
+/** \brief TCP or UDP port to listen on. */
+static uint16_t netPort;
+
+/** \brief CAN identifier of the command messages from the host. */
+static uint32_t canTransmitId;
+
+/** \brief CAN identifier of the response messages to the host. */
+static uint32_t canReceiveId;
+
+/** \brief Flag to indicate that 29-bit CAN identifiers are used. */
+static bool canExtendedId;
+
+/** \brief Flag to indicate that the program should stop after the first completed
+ *         programming session.
+ */
+static bool exitAfterSession;
+
+/** \brief The filename of the firmware file to verify the flash memory contents with,
+ *         or NULL if not specified.
+ */
+static char const * firmwareFileStr;
+
+/** \brief Flag that is set by the signal handler to request the program to stop. */
+static volatile sig_atomic_t stopRequested;
+
+
+/************************************************************************************//**
+** \brief     This is the program entry point.
+** \param     argc Number of program arguments.
+** \param     argv Array with program arguments.
+** \return    Program return code. 0 for success, error code otherwise.
+**
+****************************************************************************************/
+int main(int argc, char const * const argv[])
+{
+  int result = RESULT_OK;
+  bool transportOk = false;
+
+  /* -------------------- Display info ----------------------------------------------- */
+  /* Check that at least one command line argument was specified. The first one is
+   * always the name of the executable. Without arguments, only the usage is displayed
+   * instead of silently starting a simulation with the default settings.
+   */
+  if (argc < 2)
+  {
+    /* Display program info */
+    DisplayProgramInfo();
+    /* Display program usage. */
+    DisplayProgramUsage();
+    /* Set error code. */
+    result = RESULT_ERROR_COMMANDLINE;
+  }
+  /* Process the command line parameters. */
+  else if (!ParseCommandLine(argc, argv))
+  {
+    /* Display program info */
+    DisplayProgramInfo();
+    /* Display program usage. */
+    DisplayProgramUsage();
+    /* Display error. */
+    printf("[ERROR] Incorrect command line parameters specified.\n");
+    /* Set error code. */
+    result = RESULT_ERROR_COMMANDLINE;
+  }
+  else
+  {
+    /* Display program info. Flush it, because the output is often redirected to a file
+     * or a pipe and the simulation can run for a long time.
+     */
+    DisplayProgramInfo();
+    (void)fflush(stdout);
+  }
+
+  /* -------------------- Initialization --------------------------------------------- */
+  if (result == RESULT_OK)
+  {
+    /* Create the target simulation. */
+    simulation = XcpSimInit(&simSettings);
+    if (simulation == NULL)
+    {
+      /* Display error. */
+      printf("[ERROR] Could not create the target simulation.\n");
+      /* Set error code. */
+      result = RESULT_ERROR_SIMULATION_INIT;
+    }
+  }
+
+  /* -------------------- Simulation ------------------------------------------------- */
+  if (result == RESULT_OK)
+  {
+    /* Stop gracefully when interrupted, such that the statistics are still displayed.
+     * A host that disconnects while a response is sent should not end the program.
+     */
+    (void)signal(SIGINT, StopSignalHandler);
+    (void)signal(SIGTERM, StopSignalHandler);
+    (void)signal(SIGPIPE, SIG_IGN);
+    /* Process commands on the selected transport layer until the program should stop. */
+    switch (transport)
+    {
+      case TRANSPORT_CAN:
+        transportOk = RunTransportCan();
+        break;
+      case TRANSPORT_NET:
+        transportOk = RunTransportNet();
+        break;
+      case TRANSPORT_UDP:
+        transportOk = RunTransportUdp();
+        break;
+      case TRANSPORT_RS232:
+      default:
+        transportOk = RunTransportRs232();
+        break;
+    }
+    if (!transportOk)
+    {
+      /* Display error. */
+      printf("[ERROR] Could not set up the transport layer.\n");
+      /* Set error code. */
+      result = RESULT_ERROR_TRANSPORT;
+    }
+  }
+
+  /* -------------------- Statistics ------------------------------------------------- */
+  if (result == RESULT_OK)
+  {
+    DisplaySimulationStats();
+  }
+
+  /* -------------------- Verification ----------------------------------------------- */
+  if ( (result == RESULT_OK) && (firmwareFileStr != NULL) )
+  {
+    if (!VerifyFirmwareFile())
+    {
+      /* Set error code. */
+      result = RESULT_ERROR_FIRMWARE_VERIFY;
+    }
+  }
+
+  /* -------------------- Cleanup ---------------------------------------------------- */
+  XcpSimTerminate(simulation);
+  /* Give result back. */
+  return result;
+} /*** end of main ***/
+
+
+/************************************************************************************//**
+** \brief     Outputs information to the user about this program.
+**
+****************************************************************************************/
+static void DisplayProgramInfo(void)
+{
+  printf("--------------------------------------------------------------------------\n");
+  printf("XcpSim version 1.00.00. Simulates a microcontroller target that runs the\n");
+  printf("OpenBLT bootloader, for testing firmware updates without hardware.\n\n");
+  printf("Copyright (c) 2017 by Feaser  http://www.feaser.com\n");
+  printf("-------------------------------------------------------------------------\n");
+} /*** end of DisplayProgramInfo ***/
+
+
+/************************************************************************************//**
+** \brief     Outputs information to the user about how to use this program.
+**
+****************************************************************************************/
+static void DisplayProgramUsage(void)
+{
+  printf("Usage:    XcpSim [options] [firmware file]\n");
+  printf("\n");
+  printf("Example:  XcpSim -t=xcp_net -p=1000 -exit firmware.srec\n");
+  printf("\n");
+  printf("The optional firmware file is used to verify the contents of the simulated\n");
+  printf("flash memory, once the program stops.\n");
+  printf("\n");
+  printf("Simulation settings:\n");
+  printf("  -t=[name]        Name of the communication transport layer:\n");
+  printf("                     xcp_rs232 (default) -> XCP on a pseudo terminal.\n");
+  printf("                     xcp_can             -> XCP on SocketCAN.\n");
+  printf("                     xcp_net             -> XCP on TCP/IP.\n");
+  printf("                     xcp_udp             -> XCP on UDP/IP.\n");
+  printf("  -f=[list]        Comma separated list of flash memory regions. Each one\n");
+  printf("                   is specified as address:size:count, with the start\n");
+  printf("                   address and sector size as 32-bit hexadecimal values\n");
+  printf("                   and the number of sectors as a decimal value (Default\n");
+  printf("                   = 10000:1000:240).\n");
+  printf("  -cto=[value]     Maximum length of a command packet, as an 8-bit value\n");
+  printf("                   (Default = 8 for CAN, 255 otherwise).\n");
+  printf("  -dto=[value]     Maximum length of a response packet, as an 8-bit value\n");
+  printf("                   (Default = 8 for CAN, 255 otherwise).\n");
+  printf("  -lock            Protect the programming resource, such that the host\n");
+  printf("                   must unlock it with the seed/key algorithm.\n");
+  printf("  -te=[time]       Time in milliseconds to erase one sector (Default = 0).\n");
+  printf("  -tp=[time]       Time in microseconds to program one byte (Default = 0).\n");
+  printf("  -fl=[value]      Percentage of response packets to drop (Default = 0).\n");
+  printf("  -fe=[value]      Percentage of erase operations that fail (Default = 0).\n");
+  printf("  -fp=[value]      Percentage of program operations that fail (Default =\n");
+  printf("                   0).\n");
+  printf("  -fs=[value]      Seed for the fault injection, as a 32-bit value. The\n");
+  printf("                   same seed results in the same faults (Default = 1).\n");
+  printf("  -exit            Stop after the first completed programming session.\n");
+  printf("\n");
+  printf("XCP on a pseudo terminal settings (xcp_rs232):\n");
+  printf("  -d=[name]        Name of a symbolic link to create for the pseudo\n");
+  printf("                   terminal (Optional). Specify it as the device of the\n");
+  printf("                   host, for example /tmp/ttyXcpSim.\n");
+  printf("\n");
+  printf("XCP on SocketCAN settings (xcp_can):\n");
+  printf("  -d=[name]        Name of the CAN device (Mandatory), for example vcan0.\n");
+  printf("  -tid=[value]     CAN identifier for receiving XCP command messages from\n");
+  printf("                   the host, as a 32-bit hexadecimal value (Default =\n");
+  printf("                   667 hex).\n");
+  printf("  -rid=[value]     CAN identifier for transmitting XCP response messages\n");
+  printf("                   to the host, as a 32-bit hexadecimal value (Default =\n");
+  printf("                   7E1 hex).\n");
+  printf("  -xid=[value]     Configures the 'tid' and 'rid' CAN identifier values\n");
+  printf("                   as 29-bit CAN identifiers, if a 8-bit value > 0 is\n");
+  printf("                   specified (Default = 0).\n");
+  printf("\n");
+  printf("XCP on TCP/IP and UDP/IP settings (xcp_net and xcp_udp):\n");
+  printf("  -p=[value]       The port number to listen on, as a 16-bit value\n");
+  printf("                   (Default = 1000).\n");
+  printf("\n");
+  printf("Note that it is perfectly fine to specify options that are not applicable\n");
+  printf("to the selected transport layer. They are simply ignored.\n");
+  printf("-------------------------------------------------------------------------\n");
+} /*** end of DisplayProgramUsage ***/
+
+
+/************************************************************************************//**
+** \brief     Outputs the statistics that the target simulation collected.
+**
+****************************************************************************************/
+static void DisplaySimulationStats(void)
+{
+  tXcpSimStats stats;
+  uint32_t sessionTimeMs;
+
+  XcpSimGetStats(simulation, &stats);
+  sessionTimeMs = (uint32_t)(stats.sessionTime / 1000u);
+  printf("Simulation statistics:\n");
+  printf("  -> Processed commands: %u\n", stats.commands);
+  printf("  -> Erased sectors: %u\n", stats.sectorsErased);
+  printf("  -> Programmed bytes: %u\n", stats.bytesProgrammed);
+  printf("  -> Uploaded bytes: %u\n", stats.bytesUploaded);
+  printf("  -> Injected faults: %u\n", stats.faultsInjected);
+  printf("  -> Completed sessions: %u\n", stats.sessions);
+  printf("  -> Session time: %u ms\n", sessionTimeMs);
+  /* The throughput only makes sense for sessions that actually completed. */
+  if (stats.sessionTime > 0)
+  {
+    printf("  -> Program throughput: %.1f kB/s\n",
+           ((double)stats.bytesProgrammed * 1000.0) / (double)stats.sessionTime);
+  }
+} /*** end of DisplaySimulationStats ***/
+
+
+/************************************************************************************//**
+** \brief     Parses the command line to validate and extract the command line
+**            parameters.
+** \param     argc Number of program arguments.
+** \param     argv Array with program parameter strings.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+static bool ParseCommandLine(int argc, char const * const argv[])
+{
+  bool result = false;
+  int paramIdx;
+  char const * geometryStr = "10000:1000:240";
+  bool ctoSpecified = false;
+  bool dtoSpecified = false;
+  unsigned int value;
+
+  /* Check parameters. */
+  assert(argv != NULL);
+
+  /* Reset the command line parameter storage variables. */
+  memset(&simSettings, 0, sizeof(simSettings));
+  simSettings.faultSeed = 1;
+  transport = TRANSPORT_RS232;
+  deviceStr = NULL;
+  netPort = 1000;
+  canTransmitId = 0x667;
+  canReceiveId = 0x7E1;
+  canExtendedId = false;
+  exitAfterSession = false;
+  firmwareFileStr = NULL;
+
+  /* Only continue if parameters are valid. */
+  if (argv != NULL) /*lint !e774 */
+  {
+    result = true;
+    /* Loop through the command line parameters. The first one can be skipped as this is
+     * the program name.
+     */
+    for (paramIdx = 1; paramIdx < argc; paramIdx++)
+    {
+      /* Is this the -t=[name] parameter? */
+      if ( (strstr(argv[paramIdx], "-t=") != NULL) &&
+           (strlen(argv[paramIdx]) > 3) )
+      {
+        if (strcmp(&argv[paramIdx][3], "xcp_rs232") == 0)
+        {
+          transport = TRANSPORT_RS232;
+        }
+        else if (strcmp(&argv[paramIdx][3], "xcp_can") == 0)
+        {
+          transport = TRANSPORT_CAN;
+        }
+        else if (strcmp(&argv[paramIdx][3], "xcp_net") == 0)
+        {
+          transport = TRANSPORT_NET;
+        }
+        else if (strcmp(&argv[paramIdx][3], "xcp_udp") == 0)
+        {
+          transport = TRANSPORT_UDP;
+        }
+        else
+        {
+          result = false;
+        }
+        /* Continue with next loop iteration. */
+        continue;
+      }
+      /* Is this the -f=[list] parameter? */
+      if ( (strstr(argv[paramIdx], "-f=") != NULL) &&
+           (strlen(argv[paramIdx]) > 3) )
+      {
+        geometryStr = &argv[paramIdx][3];
+        /* Continue with next loop iteration. */
+        continue;
+      }
+      /* Is this the -cto=[value] parameter? */
+      if ( (strstr(argv[paramIdx], "-cto=") != NULL) &&
+           (strlen(argv[paramIdx]) > 5) )
+      {
+        sscanf(&argv[paramIdx][5], "%u", &value);
+        simSettings.maxCto = (uint8_t)value;
+        ctoSpecified = true;
+        /* Continue with next loop iteration. */
+        continue;
+      }
+      /* Is this the -dto=[value] parameter? */
+      if ( (strstr(argv[paramIdx], "-dto=") != NULL) &&
+           (strlen(argv[paramIdx]) > 5) )
+      {
+        sscanf(&argv[paramIdx][5], "%u", &value);
+        simSettings.maxDto = (uint8_t)value;
+        dtoSpecified = true;
+        /* Continue with next loop iteration. */
+        continue;
+      }
+      /* Is this the -lock parameter? */
+      if (strcmp(argv[paramIdx], "-lock") == 0)
+      {
+        simSettings.pgmProtected = true;
+        /* Continue with next loop iteration. */
+        continue;
+      }
+      /* Is this the -te=[time] parameter? */
+      if ( (strstr(argv[paramIdx], "-te=") != NULL) &&
+           (strlen(argv[paramIdx]) > 4) )
+      {
+        sscanf(&argv[paramIdx][4], "%u", &simSettings.eraseTime);
+        /* Continue with next loop iteration. */
+        continue;
+      }
+      /* Is this the -tp=[time] parameter? */
+      if ( (strstr(argv[paramIdx], "-tp=") != NULL) &&
+           (strlen(argv[paramIdx]) > 4) )
+      {
+        sscanf(&argv[paramIdx][4], "%u", &simSettings.programTime);
+        /* Continue with next loop iteration. */
+        continue;
+      }
+      /* Is this the -fl=[value] parameter? */
+      if ( (strstr(argv[paramIdx], "-fl=") != NULL) &&
+           (strlen(argv[paramIdx]) > 4) )
+      {
+        sscanf(&argv[paramIdx][4], "%u", &value);
+        simSettings.lossRate = (value <= 100u) ? (uint8_t)value : 255u;
+        /* Continue with next loop iteration. */
+        continue;
+      }
+      /* Is this the -fe=[value] parameter? */
+      if ( (strstr(argv[paramIdx], "-fe=") != NULL) &&
+           (strlen(argv[paramIdx]) > 4) )
+      {
+        sscanf(&argv[paramIdx][4], "%u", &value);
+        simSettings.eraseFailRate = (value <= 100u) ? (uint8_t)value : 255u;
+        /* Continue with next loop iteration. */
+        continue;
+      }
+      /* Is this the -fp=[value] parameter? */
+      if ( (strstr(argv[paramIdx], "-fp=") != NULL) &&
+           (strlen(argv[paramIdx]) > 4) )
+      {
+        sscanf(&argv[paramIdx][4], "%u", &value);
+        simSettings.programFailRate = (value <= 100u) ? (uint8_t)value : 255u;
+        /* Continue with next loop iteration. */
+        continue;
+      }
+      /* Is this the -fs=[value] parameter? */
+      if ( (strstr(argv[paramIdx], "-fs=") != NULL) &&
+           (strlen(argv[paramIdx]) > 4) )
+      {
+        sscanf(&argv[paramIdx][4], "%u", &simSettings.faultSeed);
+        /* Continue with next loop iteration. */
+        continue;
+      }
+      /* Is this the -exit parameter? */
+      if (strcmp(argv[paramIdx], "-exit") == 0)
+      {
+        exitAfterSession = true;
+        /* Continue with next loop iteration. */
+        continue;
+      }
+      /* Is this the -d=[name] parameter? */
+      if ( (strstr(argv[paramIdx], "-d=") != NULL) &&
+           (strlen(argv[paramIdx]) > 3) )
+      {
+        deviceStr = &argv[paramIdx][3];
+        /* Continue with next loop iteration. */
+        continue;
+      }
+      /* Is this the -tid=[value] parameter? */
+      if ( (strstr(argv[paramIdx], "-tid=") != NULL) &&
+           (strlen(argv[paramIdx]) > 5) )
+      {
+        sscanf(&argv[paramIdx][5], "%x", &canTransmitId);
+        /* Continue with next loop iteration. */
+        continue;
+      }
+      /* Is this the -rid=[value] parameter? */
+      if ( (strstr(argv[paramIdx], "-rid=") != NULL) &&
+           (strlen(argv[paramIdx]) > 5) )
+      {
+        sscanf(&argv[paramIdx][5], "%x", &canReceiveId);
+        /* Continue with next loop iteration. */
+        continue;
+      }
+      /* Is this the -xid=[value] parameter? */
+      if ( (strstr(argv[paramIdx], "-xid=") != NULL) &&
+           (strlen(argv[paramIdx]) > 5) )
+      {
+        sscanf(&argv[paramIdx][5], "%u", &value);
+        canExtendedId = (value > 0);
+        /* Continue with next loop iteration. */
+        continue;
+      }
+      /* Is this the -p=[value] parameter? */
+      if ( (strstr(argv[paramIdx], "-p=") != NULL) &&
+           (strlen(argv[paramIdx]) > 3) )
+      {
+        sscanf(&argv[paramIdx][3], "%u", &value);
+        netPort = (uint16_t)value;
+        /* Continue with next loop iteration. */
+        continue;
+      }
+      /* The firmware file is the only parameter that is not an option. */
+      if ( (argv[paramIdx][0] != '-') && (firmwareFileStr == NULL) )
+      {
+        firmwareFileStr = argv[paramIdx];
+        /* Continue with next loop iteration. */
+        continue;
+      }
+      /* Unknown parameter. */
+      result = false;
+    }
+    /* Parse the flash memory regions. */
+    if (result)
+    {
+      result = ParseFlashGeometry(geometryStr);
+    }
+    /* Set the default packet sizes. Packets on CAN can be at most 8 bytes long. */
+    if (!ctoSpecified)
+    {
+      simSettings.maxCto = (transport == TRANSPORT_CAN) ? 8u : 255u;
+    }
+    if (!dtoSpecified)
+    {
+      simSettings.maxDto = (transport == TRANSPORT_CAN) ? 8u : 255u;
+    }
+    /* Validate the settings. */
+    if ( (simSettings.maxCto < 8u) || (simSettings.maxDto < 8u) ||
+         (simSettings.lossRate > 100u) || (simSettings.eraseFailRate > 100u) ||
+         (simSettings.programFailRate > 100u) )
+    {
+      result = false;
+    }
+    if (transport == TRANSPORT_CAN)
+    {
+      if ( (deviceStr == NULL) || (simSettings.maxCto > 8u) ||
+           (simSettings.maxDto > 8u) )
+      {
+        result = false;
+      }
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of ParseCommandLine ***/
+
+
+/************************************************************************************//**
+** \brief     Parses the flash memory geometry, as specified on the command line.
+** \param     geometry Comma separated list of flash memory regions. Each one is
+**            specified as address:size:count.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+static bool ParseFlashGeometry(char const * geometry)
+{
+  bool result = true;
+  char const * regionStr = geometry;
+
+  /* Check parameters. */
+  assert(geometry != NULL);
+
+  simSettings.regions = flashRegions;
+  simSettings.regionCount = 0;
+  /* Extract the regions one by one. */
+  while ( (result) && (regionStr != NULL) )
+  {
+    if (simSettings.regionCount >= FLASH_REGIONS_MAX)
+    {
+      result = false;
+    }
+    else if (sscanf(regionStr, "%x:%x:%u",
+                    &flashRegions[simSettings.regionCount].address,
+                    &flashRegions[simSettings.regionCount].sectorSize,
+                    &flashRegions[simSettings.regionCount].sectorCount) != 3)
+    {
+      result = false;
+    }
+    else
+    {
+      simSettings.regionCount++;
+      /* Continue with the next region, if any. */
+      regionStr = strchr(regionStr, ',');
+      if (regionStr != NULL)
+      {
+        regionStr++;
+      }
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of ParseFlashGeometry ***/
+
+
+/************************************************************************************//**
+** \brief     Simulates the target on a pseudo terminal. The host connects to it as if it
+**            were a serial port. Each packet is preceded by its length.
+** \return    True if the transport layer could be set up, false otherwise.
+**
+****************************************************************************************/
+static bool RunTransportRs232(void)
+{
+  bool result = false;
+  int masterFd;
+  int slaveFd = -1;
+  char const * slaveName = NULL;
+  struct termios tioSettings;
+  struct pollfd pollFd;
+  uint8_t rxBuffer[RX_BUFFER_SIZE];
+  uint16_t rxCount = 0;
+  uint8_t txBuffer[XCPSIM_PACKET_SIZE_MAX + 1u];
+  uint8_t resLen;
+  ssize_t bytesRead;
+
+  /* Create the pseudo terminal. */
+  masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+  if (masterFd >= 0)
+  {
+    if ( (grantpt(masterFd) == 0) && (unlockpt(masterFd) == 0) )
+    {
+      slaveName = ptsname(masterFd);
+    }
+  }
+  /* Keep the slave side open, such that the pseudo terminal remains available when the
+   * host closes it. Configure it for raw data, just like the host would.
+   */
+  if (slaveName != NULL)
+  {
+    slaveFd = open(slaveName, O_RDWR | O_NOCTTY);
+    if ( (slaveFd >= 0) && (tcgetattr(slaveFd, &tioSettings) == 0) )
+    {
+      cfmakeraw(&tioSettings);
+      result = (tcsetattr(slaveFd, TCSANOW, &tioSettings) == 0);
+    }
+  }
+  /* Create the symbolic link, if requested. */
+  if ( (result) && (deviceStr != NULL) )
+  {
+    (void)unlink(deviceStr);
+    result = (symlink(slaveName, deviceStr) == 0);
+  }
+  /* Process command packets until the program should stop. */
+  if (result)
+  {
+    printf("Simulating target on pseudo terminal %s\n",
+           (deviceStr != NULL) ? deviceStr : slaveName);
+    (void)fflush(stdout);
+    pollFd.fd = masterFd;
+    pollFd.events = POLLIN;
+    while (KeepRunning())
+    {
+      if (poll(&pollFd, 1, POLL_TIMEOUT_MS) <= 0)
+      {
+        continue;
+      }
+      bytesRead = read(masterFd, &rxBuffer[rxCount], RX_BUFFER_SIZE - rxCount);
+      if (bytesRead <= 0)
+      {
+        continue;
+      }
+      rxCount += (uint16_t)bytesRead;
+      /* Process all complete packets. The first byte holds the packet length. */
+      while ( (rxCount > 0) && (rxCount >= (rxBuffer[0] + 1u)) )
+      {
+        if ( (rxBuffer[0] > 0) &&
+             (XcpSimProcessCommand(simulation, &rxBuffer[1], rxBuffer[0],
+                                   &txBuffer[1], &resLen)) )
+        {
+          txBuffer[0] = resLen;
+          (void)write(masterFd, txBuffer, resLen + 1u);
+        }
+        rxCount -= (uint16_t)(rxBuffer[0] + 1u);
+        memmove(&rxBuffer[0], &rxBuffer[rxBuffer[0] + 1u], rxCount);
+      }
+    }
+    /* Closing the master side hangs up the slave side, which discards the data that
+     * the host did not read yet. Give the host the chance to read the last response,
+     * such as the one to the program reset command, by waiting for it to close the
+     * slave side. The master side reports a hang up once no slave side is open.
+     */
+    (void)close(slaveFd);
+    slaveFd = -1;
+    pollFd.events = 0;
+    (void)poll(&pollFd, 1, PTY_DRAIN_TIMEOUT_MS);
+  }
+  /* Clean up. */
+  if ( (result) && (deviceStr != NULL) )
+  {
+    (void)unlink(deviceStr);
+  }
+  if (slaveFd >= 0)
+  {
+    (void)close(slaveFd);
+  }
+  if (masterFd >= 0)
+  {
+    (void)close(masterFd);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of RunTransportRs232 ***/
+
+
+/************************************************************************************//**
+** \brief     Simulates the target on a SocketCAN network interface, for example a
+**            virtual CAN interface. Each packet is one CAN message.
+** \return    True if the transport layer could be set up, false otherwise.
+**
+****************************************************************************************/
+static bool RunTransportCan(void)
+{
+  bool result = false;
+  int canSocket;
+  struct ifreq ifr;
+  struct sockaddr_can addr;
+  struct can_filter filter;
+  struct can_frame frame;
+  struct pollfd pollFd;
+  uint8_t txBuffer[XCPSIM_PACKET_SIZE_MAX];
+  uint8_t resLen;
+
+  /* Create the socket and bind it to the CAN device. */
+  canSocket = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+  if (canSocket >= 0)
+  {
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, deviceStr, IFNAMSIZ - 1);
+    if (ioctl(canSocket, SIOCGIFINDEX, &ifr) == 0)
+    {
+      memset(&addr, 0, sizeof(addr));
+      addr.can_family = AF_CAN;
+      addr.can_ifindex = ifr.ifr_ifindex;
+      result = (bind(canSocket, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+    }
+  }
+  /* Only receive the command messages from the host. */
+  if (result)
+  {
+    if (canExtendedId)
+    {
+      filter.can_id = (canTransmitId & CAN_EFF_MASK) | CAN_EFF_FLAG;
+      filter.can_mask = CAN_EFF_MASK | CAN_EFF_FLAG | CAN_RTR_FLAG;
+    }
+    else
+    {
+      filter.can_id = canTransmitId & CAN_SFF_MASK;
+      filter.can_mask = CAN_SFF_MASK | CAN_EFF_FLAG | CAN_RTR_FLAG;
+    }
+    result = (setsockopt(canSocket, SOL_CAN_RAW, CAN_RAW_FILTER, &filter,
+                         sizeof(filter)) == 0);
+  }
+  /* Process command packets until the program should stop. */
+  if (result)
+  {
+    printf("Simulating target on CAN device %s\n", deviceStr);
+    (void)fflush(stdout);
+    pollFd.fd = canSocket;
+    pollFd.events = POLLIN;
+    while (KeepRunning())
+    {
+      if (poll(&pollFd, 1, POLL_TIMEOUT_MS) <= 0)
+      {
+        continue;
+      }
+      if (read(canSocket, &frame, sizeof(frame)) != (ssize_t)sizeof(frame))
+      {
+        continue;
+      }
+      if ( (frame.can_dlc > 0) &&
+           (XcpSimProcessCommand(simulation, frame.data, frame.can_dlc, txBuffer,
+                                 &resLen)) )
+      {
+        frame.can_id = canExtendedId ? ((canReceiveId & CAN_EFF_MASK) | CAN_EFF_FLAG) :
+                                       (canReceiveId & CAN_SFF_MASK);
+        frame.can_dlc = resLen;
+        memcpy(frame.data, txBuffer, resLen);
+        (void)write(canSocket, &frame, sizeof(frame));
+      }
+    }
+  }
+  /* Clean up. */
+  if (canSocket >= 0)
+  {
+    (void)close(canSocket);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of RunTransportCan ***/
+
+
+/************************************************************************************//**
+** \brief     Simulates the target on a TCP/IP server socket. One host can be connected
+**            at a time. Each packet is preceded by a 32-bit counter. The command packets
+**            of the host are not delimited, so their lengths are derived from their
+**            contents.
+** \return    True if the transport layer could be set up, false otherwise.
+**
+****************************************************************************************/
+static bool RunTransportNet(void)
+{
+  bool result = false;
+  int listenSocket;
+  int connSocket;
+  int optionValue = 1;
+  struct sockaddr_in addr;
+  struct pollfd pollFd;
+  uint8_t rxBuffer[RX_BUFFER_SIZE];
+  uint16_t rxCount;
+  uint16_t cmdLen;
+  uint8_t txBuffer[XCPSIM_PACKET_SIZE_MAX + NET_HEADER_SIZE];
+  uint8_t resLen;
+  uint32_t dtoCounter = 1;
+  ssize_t bytesRead;
+
+  /* Create the server socket. */
+  listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+  if (listenSocket >= 0)
+  {
+    (void)setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &optionValue,
+                     sizeof(optionValue));
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(netPort);
+    result = ( (bind(listenSocket, (struct sockaddr *)&addr, sizeof(addr)) == 0) &&
+               (listen(listenSocket, 1) == 0) );
+  }
+  /* Accept connections until the program should stop. */
+  if (result)
+  {
+    printf("Simulating target on TCP port %u\n", netPort);
+    (void)fflush(stdout);
+  }
+  while ( (result) && (KeepRunning()) )
+  {
+    pollFd.fd = listenSocket;
+    pollFd.events = POLLIN;
+    if (poll(&pollFd, 1, POLL_TIMEOUT_MS) <= 0)
+    {
+      continue;
+    }
+    connSocket = accept(listenSocket, NULL, NULL);
+    if (connSocket < 0)
+    {
+      continue;
+    }
+    /* Send responses right away. */
+    (void)setsockopt(connSocket, IPPROTO_TCP, TCP_NODELAY, &optionValue,
+                     sizeof(optionValue));
+    /* Process command packets until the host disconnects. */
+    rxCount = 0;
+    pollFd.fd = connSocket;
+    while (KeepRunning())
+    {
+      if (poll(&pollFd, 1, POLL_TIMEOUT_MS) <= 0)
+      {
+        continue;
+      }
+      bytesRead = recv(connSocket, &rxBuffer[rxCount], RX_BUFFER_SIZE - rxCount, 0);
+      if (bytesRead <= 0)
+      {
+        break;
+      }
+      rxCount += (uint16_t)bytesRead;
+      /* Process all complete packets. */
+      while (rxCount > NET_HEADER_SIZE)
+      {
+        cmdLen = XcpSimGetCommandLength(simulation, &rxBuffer[NET_HEADER_SIZE],
+                                        rxCount - NET_HEADER_SIZE);
+        if ( (cmdLen == 0) || (rxCount < (cmdLen + NET_HEADER_SIZE)) )
+        {
+          break;
+        }
+        if (XcpSimProcessCommand(simulation, &rxBuffer[NET_HEADER_SIZE],
+                                 (uint8_t)cmdLen, &txBuffer[NET_HEADER_SIZE],
+                                 &resLen))
+        {
+          txBuffer[0] = (uint8_t)dtoCounter;
+          txBuffer[1] = (uint8_t)(dtoCounter >> 8);
+          txBuffer[2] = (uint8_t)(dtoCounter >> 16);
+          txBuffer[3] = (uint8_t)(dtoCounter >> 24);
+          dtoCounter++;
+          (void)send(connSocket, txBuffer, resLen + NET_HEADER_SIZE, 0);
+        }
+        rxCount -= (uint16_t)(cmdLen + NET_HEADER_SIZE);
+        memmove(&rxBuffer[0], &rxBuffer[cmdLen + NET_HEADER_SIZE], rxCount);
+      }
+    }
+    /* The connection with the host is lost, which resets the target. */
+    (void)close(connSocket);
+    XcpSimReset(simulation);
+  }
+  /* Clean up. */
+  if (listenSocket >= 0)
+  {
+    (void)close(listenSocket);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of RunTransportNet ***/
+
+
+/************************************************************************************//**
+** \brief     Simulates the target on a UDP/IP socket. Each datagram holds one packet,
+**            preceded by a 32-bit counter. Responses are sent to the host that sent the
+**            command.
+** \return    True if the transport layer could be set up, false otherwise.
+**
+****************************************************************************************/
+static bool RunTransportUdp(void)
+{
+  bool result = false;
+  int udpSocket;
+  struct sockaddr_in addr;
+  struct sockaddr_in peerAddr;
+  socklen_t peerAddrLen;
+  struct pollfd pollFd;
+  uint8_t rxBuffer[XCPSIM_PACKET_SIZE_MAX + NET_HEADER_SIZE];
+  uint8_t txBuffer[XCPSIM_PACKET_SIZE_MAX + NET_HEADER_SIZE];
+  uint8_t resLen;
+  uint32_t dtoCounter = 1;
+  ssize_t bytesRead;
+
+  /* Create the socket. */
+  udpSocket = socket(AF_INET, SOCK_DGRAM, 0);
+  if (udpSocket >= 0)
+  {
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(netPort);
+    result = (bind(udpSocket, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+  }
+  /* Process command packets until the program should stop. */
+  if (result)
+  {
+    printf("Simulating target on UDP port %u\n", netPort);
+    (void)fflush(stdout);
+    pollFd.fd = udpSocket;
+    pollFd.events = POLLIN;
+    while (KeepRunning())
+    {
+      if (poll(&pollFd, 1, POLL_TIMEOUT_MS) <= 0)
+      {
+        continue;
+      }
+      peerAddrLen = sizeof(peerAddr);
+      bytesRead = recvfrom(udpSocket, rxBuffer, sizeof(rxBuffer), 0,
+                           (struct sockaddr *)&peerAddr, &peerAddrLen);
+      if (bytesRead <= (ssize_t)NET_HEADER_SIZE)
+      {
+        continue;
+      }
+      if (XcpSimProcessCommand(simulation, &rxBuffer[NET_HEADER_SIZE],
+                               (uint8_t)(bytesRead - NET_HEADER_SIZE),
+                               &txBuffer[NET_HEADER_SIZE], &resLen))
+      {
+        txBuffer[0] = (uint8_t)dtoCounter;
+        txBuffer[1] = (uint8_t)(dtoCounter >> 8);
+        txBuffer[2] = (uint8_t)(dtoCounter >> 16);
+        txBuffer[3] = (uint8_t)(dtoCounter >> 24);
+        dtoCounter++;
+        (void)sendto(udpSocket, txBuffer, resLen + NET_HEADER_SIZE, 0,
+                     (struct sockaddr *)&peerAddr, peerAddrLen);
+      }
+    }
+  }
+  /* Clean up. */
+  if (udpSocket >= 0)
+  {
+    (void)close(udpSocket);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of RunTransportUdp ***/
+
+
+/************************************************************************************//**
+** \brief     Verifies that the simulated flash memory holds all data of the firmware
+**            file.
+** \return    True if the flash memory holds the firmware data, false otherwise.
+**
+****************************************************************************************/
+static bool VerifyFirmwareFile(void)
+{
+  bool result = false;
+  uint32_t segmentIdx;
+  uint32_t segmentCount;
+  uint32_t segmentBase;
+  uint32_t segmentLen;
+  uint8_t const * segmentData;
+  uint8_t * flashData;
+
+  printf("Verifying flash memory with firmware file %s...", firmwareFileStr);
+  /* Load the firmware file. */
+  BltFirmwareInit(BLT_FIRMWARE_PARSER_SRECORD);
+  if (BltFirmwareLoadFromFile(firmwareFileStr, 0) == BLT_RESULT_OK)
+  {
+    result = true;
+    segmentCount = BltFirmwareGetSegmentCount();
+    /* Compare the data of each segment with the contents of the flash memory. */
+    for (segmentIdx = 0; (result) && (segmentIdx < segmentCount); segmentIdx++)
+    {
+      segmentData = BltFirmwareGetSegment(segmentIdx, &segmentBase, &segmentLen);
+      flashData = malloc(segmentLen);
+      result = ( (segmentData != NULL) && (flashData != NULL) &&
+                 (XcpSimReadMemory(simulation, segmentBase, segmentLen, flashData)) &&
+                 (memcmp(segmentData, flashData, segmentLen) == 0) );
+      free(flashData);
+    }
+  }
+  BltFirmwareTerminate();
+  printf(result ? "[OK]\n" : "[ERROR]\n");
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of VerifyFirmwareFile ***/
+
+
+/************************************************************************************//**
+** \brief     Determines if the simulation should keep on running.
+** \return    True to keep on running, false to stop.
+**
+****************************************************************************************/
+static bool KeepRunning(void)
+{
+  bool result = true;
+  tXcpSimStats stats;
+
+  if (stopRequested != 0)
+  {
+    result = false;
+  }
+  else if (exitAfterSession)
+  {
+    XcpSimGetStats(simulation, &stats);
+    result = (stats.sessions == 0);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of KeepRunning ***/
+
+
+/************************************************************************************//**
+** \brief     Signal handler that requests the program to stop.
+** \param     signum The signal number.
+**
+****************************************************************************************/
+static void StopSignalHandler(int signum)
+{
+  (void)signum;
+  stopRequested = 1;
+} /*** end of StopSignalHandler ***/
+
+
+/*********************************** end of main.c *************************************/
@@ -0,0 +1,154 @@
+#!/bin/sh
+#
+# Shell script to measure the throughput of firmware updates with BootCommander against
+# the XcpSim target simulation, while sweeping a setting of the transport layer. The
+# firmware file is flashed once for each value of the setting. Afterwards a table lists
+# the result, the effective throughput and the command/response latency of each run.
+#
+# Usage: throughput.sh [XcpSim] [BootCommander] [firmware file] [XcpSim options]
+#
+# XCP on CAN is measured on the vcan0 network interface for each minimum time between
+# transmitted CAN frames in the XCPSIM_FRAME_GAPS environment variable, a space
+# separated list in microseconds. A gap of 0 lets the transmit queue pass bursts of
+# frames to SocketCAN in batches. The sweep is skipped if vcan0 does not exist:
+#   sudo modprobe vcan
+#   sudo ip link add dev vcan0 type vcan
+#   sudo ip link set up vcan0
+# XCP on RS232 is measured over a pseudo terminal pair for each baudrate in the
+# XCPSIM_BAUDRATES environment variable, a space separated list in bits/sec. Rates that
+# are not a standard one are configured as an arbitrary rate. A pseudo terminal does not
+# limit the data rate to the baudrate, so the line time column estimates the time that
+# the programmed bytes alone need on a real serial line with 10 bits per byte. The time
+# of a real update is at least the longer of the measured time and the line time.
+# XCP on TCP/IP is measured over the loopback network interface for each maximum number
+# of program commands in flight in the XCPSIM_WINDOWS environment variable, a space
+# separated list. The sweep runs once without and once with a network delay, which the
+# network emulation of BootCommander adds to each command. The delay is set in
+# microseconds with the XCPSIM_NET_DELAY environment variable and models the round trip
+# time of a real network. A delay of 0 skips the second sweep. The XCPSIM_PORT and
+# BC_OPTS environment variables work the same as for bench.sh. The throughput is the
+# number of programmed bytes divided by the total time that BootCommander ran, so it
+# includes connecting, erasing and finishing the session.
+#
+
+SIM="$1"
+BC="$2"
+FW="$3"
+shift 3
+TMPDIR="${TMPDIR:-/tmp}"
+SIMLOG="$TMPDIR/xcpsim.$$.log"
+BCLOG="$TMPDIR/bootcommander.$$.log"
+RESULTS="$TMPDIR/throughput.$$.txt"
+PTYLINK="$TMPDIR/xcpsim.$$.tty"
+FRAME_GAPS="${XCPSIM_FRAME_GAPS:-0 50 100 200 500}"
+BAUDRATES="${XCPSIM_BAUDRATES:-57600 115200 230400 460800 921600 1500000 2000000 \
+3000000 4000000}"
+PORT="${XCPSIM_PORT:-50000}"
+WINDOWS="${XCPSIM_WINDOWS:-1 2 4 8 16}"
+NET_DELAY="${XCPSIM_NET_DELAY:-1000}"
+FAILED=0
+
+# Extracts a number from a line of the BootCommander output. The first parameter is the
+# text in front of the number.
+bcvalue() {
+  sed -n "s/.*$1 \([0-9]*\).*/\1/p" "$BCLOG" | tail -n 1
+}
+
+# Runs one measurement. The first parameter is the transport layer name and the second
+# one the name of the setting with its value, as listed in the table. The XcpSim options
+# follow, up to '--'. The BootCommander options follow after it. The line time is only
+# estimated if the LINE_BAUDRATE variable holds the baudrate of a serial line.
+measure() {
+  transport="$1"
+  setting="$2"
+  shift 2
+  simopts=""
+  while [ "$1" != "--" ]; do
+    simopts="$simopts $1"
+    shift
+  done
+  shift
+
+  echo "Measure $transport with $setting"
+  # Start the simulation and wait until it is ready.
+  "$SIM" -t="$transport" $simopts -exit $SIM_OPTS "$FW" > "$SIMLOG" 2>&1 &
+  simpid=$!
+  while ! grep -q "Simulating target" "$SIMLOG" 2>/dev/null; do
+    if ! kill -0 "$simpid" 2>/dev/null; then
+      cat "$SIMLOG"
+      FAILED=1
+      return
+    fi
+    sleep 0.1
+  done
+  # Flash the firmware file and time it. The output is needed for the latency figures,
+  # so silent mode cannot be used.
+  start=$(date +%s%N)
+  "$BC" -t="$transport" "$@" $BC_OPTS "$FW" > "$BCLOG" 2>&1
+  bcresult=$?
+  stop=$(date +%s%N)
+  ms=$(( (stop - start) / 1000000 ))
+  if [ $bcresult -ne 0 ]; then
+    cat "$BCLOG"
+    kill "$simpid" 2>/dev/null
+    wait "$simpid" 2>/dev/null
+    printf "%-10s %-14s %-8s %9s %9s %9s %9s %9s\n" "$transport" "$setting" \
+      "FAIL($bcresult)" "$ms" "-" "-" "-" "-" >> "$RESULTS"
+    FAILED=1
+    return
+  fi
+  simresult="OK"
+  wait "$simpid" || simresult="CORRUPT"
+  bytes=$(sed -n 's/.*Programmed bytes: \([0-9]*\).*/\1/p' "$SIMLOG")
+  linems="-"
+  if [ -n "$LINE_BAUDRATE" ]; then
+    linems=$(( ${bytes:-0} * 10 * 1000 / LINE_BAUDRATE ))
+  fi
+  printf "%-10s %-14s %-8s %9s %9s %9s %9s %9s\n" "$transport" "$setting" \
+    "$simresult" "$ms" "$(( ${bytes:-0} * 1000 / (ms * 1024 + 1) ))" \
+    "$(bcvalue 'Average total:')" "$(bcvalue 'Maximum total:')" "$linems" >> "$RESULTS"
+  [ "$simresult" = "OK" ] || FAILED=1
+}
+
+# The XcpSim options apply to each measurement.
+SIM_OPTS="$*"
+printf "%-10s %-14s %-8s %9s %9s %9s %9s %9s\n" "Transport" "Setting" "Result" \
+  "Time[ms]" "kB/s" "Avg[us]" "Max[us]" "Line[ms]" > "$RESULTS"
+
+# XCP on CAN with different minimum times between transmitted frames.
+if ip link show vcan0 > /dev/null 2>&1; then
+  for gap in $FRAME_GAPS; do
+    measure xcp_can "gap=${gap}us" -d=vcan0 -- -d=vcan0 -fg="$gap"
+  done
+else
+  echo "[SKIP] XCP on CAN, because the vcan0 network interface does not exist."
+fi
+
+# XCP on RS232 over a pseudo terminal pair with different baudrates.
+for baudrate in $BAUDRATES; do
+  LINE_BAUDRATE="$baudrate"
+  measure xcp_rs232 "baud=$baudrate" -d="$PTYLINK" -- -d="$PTYLINK" -b="$baudrate"
+done
+LINE_BAUDRATE=""
+
+# XCP on TCP/IP over the loopback network interface with different window sizes, first
+# without and then with the emulated network delay.
+for window in $WINDOWS; do
+  measure xcp_net "w=$window" -p="$PORT" -- -a=127.0.0.1 -p="$PORT" -w="$window"
+done
+if [ "$NET_DELAY" -ne 0 ]; then
+  for window in $WINDOWS; do
+    measure xcp_net "w=$window,d=${NET_DELAY}us" -p="$PORT" -- -a=127.0.0.1 \
+      -p="$PORT" -w="$window" -emu=delay="$NET_DELAY"
+  done
+fi
+
+echo "--------------------------------------------------------------------------"
+cat "$RESULTS"
+rm -f "$SIMLOG" "$BCLOG" "$RESULTS"
+echo "--------------------------------------------------------------------------"
+if [ $FAILED -ne 0 ]; then
+  echo "[ERROR] One or more measurements failed."
+  exit 1
+fi
+echo "[OK] Throughput measurements completed."
@@ -0,0 +1,1310 @@
+/************************************************************************************//**
+* \file         xcpsim.c
+* \brief        XCP bootloader target simulation source file.
+* \ingroup      XcpSim
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+*
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+*
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+*
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include <assert.h>                         /* for assertions                          */
+#include <stdint.h>                         /* for standard integer types              */
+#include <stdbool.h>                        /* for boolean type                        */
+#include <stdlib.h>                         /* for standard library                    */
+#include <string.h>                         /* for string library                      */
+#include <time.h>                           /* for clock and sleep functions           */
+#include "xcpsim.h"                         /* XCP target simulation                   */
+#include "seednkey.h"                       /* XCP seed and key                        */
+
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/* XCP command codes as defined by the protocol currently supported. */
+#define XCPSIM_CMD_CONNECT            (0xFFu)    /**< XCP connect command code.        */
+#define XCPSIM_CMD_DISCONNECT         (0xFEu)    /**< XCP disconnect command code.     */
+#define XCPSIM_CMD_GET_STATUS         (0xFDu)    /**< XCP get status command code.     */
+#define XCPSIM_CMD_GET_SEED           (0xF8u)    /**< XCP get seed command code.       */
+#define XCPSIM_CMD_UNLOCK             (0xF7u)    /**< XCP unlock command code.         */
+#define XCPSIM_CMD_SET_MTA            (0xF6u)    /**< XCP set mta command code.        */
+#define XCPSIM_CMD_UPLOAD             (0xF5u)    /**< XCP upload command code.         */
+#define XCPSIM_CMD_BUILD_CHECKSUM     (0xF3u)    /**< XCP build checksum command code. */
+#define XCPSIM_CMD_PROGRAM_START      (0xD2u)    /**< XCP program start command code.  */
+#define XCPSIM_CMD_PROGRAM_CLEAR      (0xD1u)    /**< XCP program clear command code.  */
+#define XCPSIM_CMD_PROGRAM            (0xD0u)    /**< XCP program command code.        */
+#define XCPSIM_CMD_PROGRAM_RESET      (0xCFu)    /**< XCP program reset command code.  */
+#define XCPSIM_CMD_PROGRAM_MAX        (0xC9u)    /**< XCP program max command code.    */
+
+/* XCP packet identifiers. */
+#define XCPSIM_PID_RES                (0xFFu)    /**< positive response                */
+#define XCPSIM_PID_ERR                (0xFEu)    /**< error packet                     */
+
+/* XCP error codes. */
+#define XCPSIM_ERR_SEQUENCE           (0x29u)    /**< wrong command sequence           */
+#define XCPSIM_ERR_CMD_UNKNOWN        (0x20u)    /**< unknown or unsupported command   */
+#define XCPSIM_ERR_CMD_SYNTAX         (0x21u)    /**< command syntax invalid           */
+#define XCPSIM_ERR_OUT_OF_RANGE       (0x22u)    /**< parameter out of range           */
+#define XCPSIM_ERR_ACCESS_LOCKED      (0x25u)    /**< access locked, seed/key required */
+#define XCPSIM_ERR_GENERIC            (0x31u)    /**< generic error                    */
+
+/** \brief Checksum type that the build checksum command reports. It is the sum of all
+ *         bytes, added into a 32-bit value.
+ */
+#define XCPSIM_CHECKSUM_TYPE_ADD_14   (0x03u)
+
+/** \brief Length of the seed that the simulation generates for unlocking the
+ *         programming resource.
+ */
+#define XCPSIM_SEED_LEN               (4u)
+
+/** \brief Maximum length of a key. The key is sent in an unlock command, which holds
+ *         its remaining length in a single byte.
+ */
+#define XCPSIM_KEY_LEN_MAX            (255u)
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief A region of the simulated flash memory, together with its contents. */
+typedef struct t_xcp_sim_flash
+{
+  /** \brief Location and sector geometry of the region. */
+  tXcpSimRegion region;
+  /** \brief Contents of the region. */
+  uint8_t * data;
+} tXcpSimFlash;
+
+/** \brief Object of the target simulation. Each one simulates one target. */
+typedef struct t_xcp_sim_obj
+{
+  /** \brief Settings of the simulation. */
+  tXcpSimSettings settings;
+  /** \brief Array with the simulated flash memory regions. */
+  tXcpSimFlash * flash;
+  /** \brief Flag to indicate that the host is connected. */
+  bool connected;
+  /** \brief Currently protected resources. */
+  uint8_t protection;
+  /** \brief Memory transfer address, used by the upload and program commands. */
+  uint32_t mta;
+  /** \brief Seed that was last sent to the host. */
+  uint8_t seed[XCPSIM_SEED_LEN];
+  /** \brief Number of seed bytes that were already sent to the host. */
+  uint8_t seedSent;
+  /** \brief Flag to indicate that a seed was requested and can be unlocked. */
+  bool seedValid;
+  /** \brief Key bytes that were received so far. */
+  uint8_t key[XCPSIM_KEY_LEN_MAX];
+  /** \brief Number of received key bytes. */
+  uint8_t keyCount;
+  /** \brief Time in microseconds at which the host connected. */
+  uint64_t connectTime;
+  /** \brief State of the pseudo random number generator for the fault injection. */
+  uint32_t randState;
+  /** \brief Collected statistics. */
+  tXcpSimStats stats;
+} tXcpSimObj;
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+static void XcpSimCmdConnect(tXcpSimObj * sim, uint8_t const * cmd, uint8_t cmdLen,
+                             uint8_t * res, uint8_t * resLen);
+static void XcpSimCmdGetStatus(tXcpSimObj * sim, uint8_t * res, uint8_t * resLen);
+static void XcpSimCmdGetSeed(tXcpSimObj * sim, uint8_t const * cmd, uint8_t cmdLen,
+                             uint8_t * res, uint8_t * resLen);
+static void XcpSimCmdUnlock(tXcpSimObj * sim, uint8_t const * cmd, uint8_t cmdLen,
+                            uint8_t * res, uint8_t * resLen);
+static void XcpSimCmdSetMta(tXcpSimObj * sim, uint8_t const * cmd, uint8_t cmdLen,
+                            uint8_t * res, uint8_t * resLen);
+static void XcpSimCmdUpload(tXcpSimObj * sim, uint8_t const * cmd, uint8_t cmdLen,
+                            uint8_t * res, uint8_t * resLen);
+static void XcpSimCmdBuildChecksum(tXcpSimObj * sim, uint8_t const * cmd,
+                                   uint8_t cmdLen, uint8_t * res, uint8_t * resLen);
+static void XcpSimCmdProgramStart(tXcpSimObj * sim, uint8_t * res, uint8_t * resLen);
+static void XcpSimCmdProgramClear(tXcpSimObj * sim, uint8_t const * cmd,
+                                  uint8_t cmdLen, uint8_t * res, uint8_t * resLen);
+static void XcpSimCmdProgram(tXcpSimObj * sim, uint8_t const * cmd, uint8_t cmdLen,
+                             uint8_t * res, uint8_t * resLen);
+static void XcpSimCmdProgramReset(tXcpSimObj * sim, uint8_t * res, uint8_t * resLen);
+static void XcpSimSetError(uint8_t errorCode, uint8_t * res, uint8_t * resLen);
+static bool XcpSimFlashErase(tXcpSimObj * sim, uint32_t address, uint32_t len);
+static bool XcpSimFlashWrite(tXcpSimObj * sim, uint32_t address, uint32_t len,
+                             uint8_t const * data);
+static uint8_t * XcpSimFlashLocate(tXcpSimObj * sim, uint32_t address, uint32_t * avail,
+                                   tXcpSimFlash ** flash);
+static bool XcpSimFlashCheckRange(tXcpSimObj * sim, uint32_t address, uint32_t len);
+static bool XcpSimInjectFault(tXcpSimObj * sim, uint8_t rate);
+static uint32_t XcpSimGetLong(uint8_t const * data);
+static void XcpSimSetLong(uint32_t value, uint8_t * data);
+static uint64_t XcpSimGetTimeUs(void);
+static void XcpSimDelayUs(uint64_t delay);
+
+
+/************************************************************************************//**
+** \brief     Creates a new target simulation object. The flash memory of the target is
+**            completely erased.
+** \param     settings Pointer to the simulation settings. The regions array is copied,
+**            so it does not have to remain valid after this function returns.
+** \return    Handle to the simulation object if successful, NULL otherwise.
+**
+****************************************************************************************/
+tXcpSimHandle XcpSimInit(tXcpSimSettings const * settings)
+{
+  tXcpSimObj * sim = NULL;
+  bool initOk = false;
+  uint32_t regionIdx;
+  uint64_t regionSize;
+
+  /* Check parameters. */
+  assert(settings != NULL);
+
+  /* Only continue with valid parameters. */
+  if (settings != NULL) /*lint !e774 */
+  {
+    /* Validate the settings. Packets need to be large enough to hold the longest fixed
+     * length command and response packets.
+     */
+    if ( (settings->regions != NULL) && (settings->regionCount > 0) &&
+         (settings->maxCto >= 8u) && (settings->maxDto >= 8u) &&
+         (settings->lossRate <= 100u) && (settings->eraseFailRate <= 100u) &&
+         (settings->programFailRate <= 100u) )
+    {
+      /* Allocate memory for the object and for the flash regions. */
+      sim = calloc(1, sizeof(tXcpSimObj));
+      if (sim != NULL)
+      {
+        sim->flash = calloc(settings->regionCount, sizeof(tXcpSimFlash));
+        initOk = (sim->flash != NULL);
+      }
+    }
+  }
+  /* Allocate the contents of each region and erase it. */
+  if (initOk)
+  {
+    sim->settings = *settings;
+    sim->settings.regions = NULL;
+    for (regionIdx = 0; regionIdx < settings->regionCount; regionIdx++)
+    {
+      sim->flash[regionIdx].region = settings->regions[regionIdx];
+      regionSize = (uint64_t)settings->regions[regionIdx].sectorSize *
+                   settings->regions[regionIdx].sectorCount;
+      /* The region must not be empty and must fit in the 32-bit address space. */
+      if ( (regionSize == 0) ||
+           ((settings->regions[regionIdx].address + regionSize) > 0x100000000ull) )
+      {
+        initOk = false;
+        break;
+      }
+      sim->flash[regionIdx].data = malloc((size_t)regionSize);
+      if (sim->flash[regionIdx].data == NULL)
+      {
+        initOk = false;
+        break;
+      }
+      memset(sim->flash[regionIdx].data, 0xFF, (size_t)regionSize);
+    }
+  }
+  /* Initialize the remaining object members. */
+  if (initOk)
+  {
+    sim->randState = (settings->faultSeed != 0) ? settings->faultSeed : 1u;
+    XcpSimReset((tXcpSimHandle)sim);
+  }
+  /* Clean up in case of an error. */
+  else if (sim != NULL)
+  {
+    XcpSimTerminate((tXcpSimHandle)sim);
+    sim = NULL;
+  }
+  /* Give the result back to the caller. */
+  return (tXcpSimHandle)sim;
+} /*** end of XcpSimInit ***/
+
+
+/************************************************************************************//**
+** \brief     Releases a target simulation object.
+** \param     handle Handle to the simulation object. Can be NULL.
+**
+****************************************************************************************/
+void XcpSimTerminate(tXcpSimHandle handle)
+{
+  tXcpSimObj * sim = (tXcpSimObj *)handle;
+  uint32_t regionIdx;
+
+  /* Only continue with a valid object. */
+  if (sim != NULL)
+  {
+    /* Release the flash regions. */
+    if (sim->flash != NULL)
+    {
+      for (regionIdx = 0; regionIdx < sim->settings.regionCount; regionIdx++)
+      {
+        free(sim->flash[regionIdx].data);
+      }
+      free(sim->flash);
+    }
+    /* Release the object itself. */
+    free(sim);
+  }
+} /*** end of XcpSimTerminate ***/
+
+
+/************************************************************************************//**
+** \brief     Resets the target, as if it was power cycled. The host is disconnected and
+**            the programming resource is protected again, if configured. The contents
+**            of the flash memory are retained. Should be called when the connection
+**            with the host is lost.
+** \param     handle Handle to the simulation object.
+**
+****************************************************************************************/
+void XcpSimReset(tXcpSimHandle handle)
+{
+  tXcpSimObj * sim = (tXcpSimObj *)handle;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+
+  /* Only continue with valid parameters. */
+  if (sim != NULL) /*lint !e774 */
+  {
+    sim->connected = false;
+    sim->protection = sim->settings.pgmProtected ? XCP_RESOURCE_PGM : 0u;
+    sim->mta = 0;
+    sim->seedSent = 0;
+    sim->seedValid = false;
+    sim->keyCount = 0;
+  }
+} /*** end of XcpSimReset ***/
+
+
+/************************************************************************************//**
+** \brief     Determines the length of the command packet that starts at the specified
+**            data. Needed by stream based transport layers, where the packets are not
+**            delimited.
+** \param     handle Handle to the simulation object.
+** \param     data Pointer to the received command data.
+** \param     len Number of received bytes.
+** \return    Length of the command packet or 0 if more bytes need to be received
+**            before the length can be determined.
+**
+****************************************************************************************/
+uint16_t XcpSimGetCommandLength(tXcpSimHandle handle, uint8_t const * data,
+                                uint16_t len)
+{
+  tXcpSimObj * sim = (tXcpSimObj *)handle;
+  uint16_t result = 0;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+  assert(data != NULL);
+
+  /* Only continue with valid parameters and if at least the command code is known. */
+  if ( (sim != NULL) && (data != NULL) && (len > 0) ) /*lint !e774 */
+  {
+    switch (data[0])
+    {
+      case XCPSIM_CMD_CONNECT:
+      case XCPSIM_CMD_UPLOAD:
+        result = 2u;
+        break;
+      case XCPSIM_CMD_GET_SEED:
+        result = 3u;
+        break;
+      case XCPSIM_CMD_SET_MTA:
+      case XCPSIM_CMD_BUILD_CHECKSUM:
+      case XCPSIM_CMD_PROGRAM_CLEAR:
+        result = 8u;
+        break;
+      case XCPSIM_CMD_PROGRAM_MAX:
+        result = sim->settings.maxCto;
+        break;
+      case XCPSIM_CMD_UNLOCK:
+      case XCPSIM_CMD_PROGRAM:
+        /* The second byte holds the number of data bytes that follow, although an
+         * unlock command never holds more than fits in the packet.
+         */
+        if (len >= 2u)
+        {
+          result = data[1];
+          if (result > (uint16_t)(sim->settings.maxCto - 2u))
+          {
+            result = (data[0] == XCPSIM_CMD_UNLOCK) ?
+                     (uint16_t)(sim->settings.maxCto - 2u) : 0u;
+          }
+          result += 2u;
+        }
+        break;
+      default:
+        /* Disconnect, get status, program start, program reset and unknown commands
+         * consist of just the command code.
+         */
+        result = 1u;
+        break;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpSimGetCommandLength ***/
+
+
+/************************************************************************************//**
+** \brief     Processes a command packet from the host and builds the response packet.
+**            Erase and program commands only return after the configured erase and
+**            program time passed, just like on the real target.
+** \param     handle Handle to the simulation object.
+** \param     cmd Pointer to the command packet.
+** \param     cmdLen Length of the command packet.
+** \param     res Pointer to where the response packet is stored. Must be able to hold
+**            XCPSIM_PACKET_SIZE_MAX bytes.
+** \param     resLen Pointer to where the length of the response packet is stored.
+** \return    True if the response packet should be sent to the host, false otherwise.
+**
+****************************************************************************************/
+bool XcpSimProcessCommand(tXcpSimHandle handle, uint8_t const * cmd, uint8_t cmdLen,
+                          uint8_t * res, uint8_t * resLen)
+{
+  tXcpSimObj * sim = (tXcpSimObj *)handle;
+  bool result = false;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+  assert(cmd != NULL);
+  assert(res != NULL);
+  assert(resLen != NULL);
+
+  /* Only continue with valid parameters. */
+  if ( (sim != NULL) && (cmd != NULL) && (cmdLen > 0) && (res != NULL) &&
+       (resLen != NULL) ) /*lint !e774 */
+  {
+    *resLen = 0;
+    /* The bootloader ignores all commands, except the connect command, as long as the
+     * host is not connected.
+     */
+    if ( (sim->connected) || (cmd[0] == XCPSIM_CMD_CONNECT) )
+    {
+      sim->stats.commands++;
+      result = true;
+      switch (cmd[0])
+      {
+        case XCPSIM_CMD_CONNECT:
+          XcpSimCmdConnect(sim, cmd, cmdLen, res, resLen);
+          break;
+        case XCPSIM_CMD_DISCONNECT:
+          res[0] = XCPSIM_PID_RES;
+          *resLen = 1;
+          XcpSimReset(handle);
+          break;
+        case XCPSIM_CMD_GET_STATUS:
+          XcpSimCmdGetStatus(sim, res, resLen);
+          break;
+        case XCPSIM_CMD_GET_SEED:
+          XcpSimCmdGetSeed(sim, cmd, cmdLen, res, resLen);
+          break;
+        case XCPSIM_CMD_UNLOCK:
+          XcpSimCmdUnlock(sim, cmd, cmdLen, res, resLen);
+          break;
+        case XCPSIM_CMD_SET_MTA:
+          XcpSimCmdSetMta(sim, cmd, cmdLen, res, resLen);
+          break;
+        case XCPSIM_CMD_UPLOAD:
+          XcpSimCmdUpload(sim, cmd, cmdLen, res, resLen);
+          break;
+        case XCPSIM_CMD_BUILD_CHECKSUM:
+          XcpSimCmdBuildChecksum(sim, cmd, cmdLen, res, resLen);
+          break;
+        case XCPSIM_CMD_PROGRAM_START:
+          XcpSimCmdProgramStart(sim, res, resLen);
+          break;
+        case XCPSIM_CMD_PROGRAM_CLEAR:
+          XcpSimCmdProgramClear(sim, cmd, cmdLen, res, resLen);
+          break;
+        case XCPSIM_CMD_PROGRAM:
+        case XCPSIM_CMD_PROGRAM_MAX:
+          XcpSimCmdProgram(sim, cmd, cmdLen, res, resLen);
+          break;
+        case XCPSIM_CMD_PROGRAM_RESET:
+          XcpSimCmdProgramReset(sim, res, resLen);
+          break;
+        default:
+          XcpSimSetError(XCPSIM_ERR_CMD_UNKNOWN, res, resLen);
+          break;
+      }
+      /* Drop the response, if so configured, to simulate a response that got lost on
+       * its way to the host. The command itself was already executed.
+       */
+      if (XcpSimInjectFault(sim, sim->settings.lossRate))
+      {
+        sim->stats.faultsInjected++;
+        result = false;
+      }
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpSimProcessCommand ***/
+
+
+/************************************************************************************//**
+** \brief     Reads data from the simulated flash memory. Can for example be used to
+**            verify the outcome of a firmware update.
+** \param     handle Handle to the simulation object.
+** \param     address Start address of the data to read.
+** \param     len Number of bytes to read.
+** \param     data Pointer to where the read data is stored.
+** \return    True if successful, false if not all data is located in flash memory.
+**
+****************************************************************************************/
+bool XcpSimReadMemory(tXcpSimHandle handle, uint32_t address, uint32_t len,
+                      uint8_t * data)
+{
+  tXcpSimObj * sim = (tXcpSimObj *)handle;
+  bool result = false;
+  uint8_t * flashPtr;
+  uint32_t avail = 0;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+  assert(data != NULL);
+
+  /* Only continue with valid parameters and if all data is located in flash memory. */
+  if ( (sim != NULL) && (data != NULL) ) /*lint !e774 */
+  {
+    result = XcpSimFlashCheckRange(sim, address, len);
+    /* Copy the data, region by region. */
+    while ( (result) && (len > 0) )
+    {
+      flashPtr = XcpSimFlashLocate(sim, address, &avail, NULL);
+      assert(flashPtr != NULL);
+      if (avail > len)
+      {
+        avail = len;
+      }
+      memcpy(data, flashPtr, avail);
+      data += avail;
+      address += avail;
+      len -= avail;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpSimReadMemory ***/
+
+
+/************************************************************************************//**
+** \brief     Obtains the statistics that the simulation collected.
+** \param     handle Handle to the simulation object.
+** \param     stats Pointer to where the statistics are stored.
+**
+****************************************************************************************/
+void XcpSimGetStats(tXcpSimHandle handle, tXcpSimStats * stats)
+{
+  tXcpSimObj * sim = (tXcpSimObj *)handle;
+
+  /* Check parameters. */
+  assert(handle != NULL);
+  assert(stats != NULL);
+
+  /* Only continue with valid parameters. */
+  if ( (sim != NULL) && (stats != NULL) ) /*lint !e774 */
+  {
+    *stats = sim->stats;
+  }
+} /*** end of XcpSimGetStats ***/
+
+
+/************************************************************************************//**
+** \brief     Processes the XCP connect command.
+** \param     sim Pointer to the simulation object.
+** \param     cmd Pointer to the command packet.
+** \param     cmdLen Length of the command packet.
+** \param     res Pointer to where the response packet is stored.
+** \param     resLen Pointer to where the length of the response packet is stored.
+**
+****************************************************************************************/
+static void XcpSimCmdConnect(tXcpSimObj * sim, uint8_t const * cmd, uint8_t cmdLen,
+                             uint8_t * res, uint8_t * resLen)
+{
+  (void)cmd;
+
+  if (cmdLen < 2u)
+  {
+    XcpSimSetError(XCPSIM_ERR_CMD_SYNTAX, res, resLen);
+  }
+  else
+  {
+    /* Start timing the session, unless the host is already connected. */
+    if (!sim->connected)
+    {
+      sim->connectTime = XcpSimGetTimeUs();
+    }
+    sim->connected = true;
+    /* Build the response with the supported resources, the Intel byte ordering and the
+     * maximum packet sizes.
+     */
+    res[0] = XCPSIM_PID_RES;
+    res[1] = XCP_RESOURCE_PGM;
+    res[2] = 0x00;
+    res[3] = sim->settings.maxCto;
+    res[4] = sim->settings.maxDto;
+    res[5] = 0x00;
+    res[6] = 0x01;
+    res[7] = 0x01;
+    *resLen = 8;
+  }
+} /*** end of XcpSimCmdConnect ***/
+
+
+/************************************************************************************//**
+** \brief     Processes the XCP get status command.
+** \param     sim Pointer to the simulation object.
+** \param     res Pointer to where the response packet is stored.
+** \param     resLen Pointer to where the length of the response packet is stored.
+**
+****************************************************************************************/
+static void XcpSimCmdGetStatus(tXcpSimObj * sim, uint8_t * res, uint8_t * resLen)
+{
+  res[0] = XCPSIM_PID_RES;
+  res[1] = 0x00;
+  res[2] = sim->protection;
+  res[3] = 0x00;
+  res[4] = 0x00;
+  res[5] = 0x00;
+  *resLen = 6;
+} /*** end of XcpSimCmdGetStatus ***/
+
+
+/************************************************************************************//**
+** \brief     Processes the XCP get seed command. Mode 0 generates a new seed and sends
+**            its first part. Mode 1 sends the next part of the seed.
+** \param     sim Pointer to the simulation object.
+** \param     cmd Pointer to the command packet.
+** \param     cmdLen Length of the command packet.
+** \param     res Pointer to where the response packet is stored.
+** \param     resLen Pointer to where the length of the response packet is stored.
+**
+****************************************************************************************/
+static void XcpSimCmdGetSeed(tXcpSimObj * sim, uint8_t const * cmd, uint8_t cmdLen,
+                             uint8_t * res, uint8_t * resLen)
+{
+  uint8_t remaining;
+  uint8_t count;
+  uint8_t idx;
+
+  if (cmdLen < 3u)
+  {
+    XcpSimSetError(XCPSIM_ERR_CMD_SYNTAX, res, resLen);
+  }
+  /* Only the programming resource is supported. */
+  else if ( (cmd[2] != XCP_RESOURCE_PGM) || (cmd[1] > 1u) )
+  {
+    XcpSimSetError(XCPSIM_ERR_OUT_OF_RANGE, res, resLen);
+  }
+  /* A seed length of zero tells the host that the resource is not protected. */
+  else if ((sim->protection & XCP_RESOURCE_PGM) == 0)
+  {
+    res[0] = XCPSIM_PID_RES;
+    res[1] = 0;
+    *resLen = 2;
+  }
+  /* The remainder of the seed can only be requested after its first part. */
+  else if ( (cmd[1] == 1u) && (!sim->seedValid) )
+  {
+    XcpSimSetError(XCPSIM_ERR_SEQUENCE, res, resLen);
+  }
+  else
+  {
+    /* Generate a new seed for mode 0. */
+    if (cmd[1] == 0u)
+    {
+      for (idx = 0; idx < XCPSIM_SEED_LEN; idx++)
+      {
+        sim->randState ^= sim->randState << 13;
+        sim->randState ^= sim->randState >> 17;
+        sim->randState ^= sim->randState << 5;
+        sim->seed[idx] = (uint8_t)sim->randState;
+      }
+      sim->seedSent = 0;
+      sim->seedValid = true;
+      sim->keyCount = 0;
+    }
+    /* Send as much of the remaining seed as fits in the response packet. */
+    remaining = XCPSIM_SEED_LEN - sim->seedSent;
+    count = remaining;
+    if (count > (uint8_t)(sim->settings.maxDto - 2u))
+    {
+      count = (uint8_t)(sim->settings.maxDto - 2u);
+    }
+    res[0] = XCPSIM_PID_RES;
+    res[1] = remaining;
+    memcpy(&res[2], &sim->seed[sim->seedSent], count);
+    sim->seedSent += count;
+    *resLen = count + 2u;
+  }
+} /*** end of XcpSimCmdGetSeed ***/
+
+
+/************************************************************************************//**
+** \brief     Processes the XCP unlock command. The key can be spread over multiple
+**            unlock commands. Once it is complete, it is compared with the key that
+**            the seed/key algorithm computes for the seed. On a mismatch the host is
+**            disconnected, just like the bootloader does.
+** \param     sim Pointer to the simulation object.
+** \param     cmd Pointer to the command packet.
+** \param     cmdLen Length of the command packet.
+** \param     res Pointer to where the response packet is stored.
+** \param     resLen Pointer to where the length of the response packet is stored.
+**
+****************************************************************************************/
+static void XcpSimCmdUnlock(tXcpSimObj * sim, uint8_t const * cmd, uint8_t cmdLen,
+                            uint8_t * res, uint8_t * resLen)
+{
+  uint8_t count;
+  uint8_t expectedKey[XCPSIM_KEY_LEN_MAX];
+  uint8_t expectedKeyLen = 0;
+  bool keyOk;
+
+  if (cmdLen < 2u)
+  {
+    XcpSimSetError(XCPSIM_ERR_CMD_SYNTAX, res, resLen);
+  }
+  /* The complete seed must have been sent first. */
+  else if ( (!sim->seedValid) || (sim->seedSent < XCPSIM_SEED_LEN) )
+  {
+    XcpSimSetError(XCPSIM_ERR_SEQUENCE, res, resLen);
+  }
+  else
+  {
+    /* Store the key bytes that are in this packet. The second byte holds the number of
+     * key bytes that remain, including the ones in this packet.
+     */
+    count = cmd[1];
+    if (count > (uint8_t)(cmdLen - 2u))
+    {
+      count = (uint8_t)(cmdLen - 2u);
+    }
+    if (count > (XCPSIM_KEY_LEN_MAX - sim->keyCount))
+    {
+      count = (uint8_t)(XCPSIM_KEY_LEN_MAX - sim->keyCount);
+    }
+    memcpy(&sim->key[sim->keyCount], &cmd[2], count);
+    sim->keyCount += count;
+    /* Verify the key once it is complete. */
+    if (cmd[1] <= count)
+    {
+      keyOk = (XCP_ComputeKeyFromSeed(XCP_RESOURCE_PGM, XCPSIM_SEED_LEN, sim->seed,
+                                      &expectedKeyLen, expectedKey) == XCP_RESULT_OK);
+      if (keyOk)
+      {
+        keyOk = ( (expectedKeyLen == sim->keyCount) &&
+                  (memcmp(expectedKey, sim->key, expectedKeyLen) == 0) );
+      }
+      /* A seed can only be used once. */
+      sim->seedValid = false;
+      sim->keyCount = 0;
+      if (keyOk)
+      {
+        sim->protection &= (uint8_t)~XCP_RESOURCE_PGM;
+      }
+      else
+      {
+        XcpSimSetError(XCPSIM_ERR_ACCESS_LOCKED, res, resLen);
+        XcpSimReset((tXcpSimHandle)sim);
+      }
+    }
+    /* Report the current protection status, unless the key was invalid. */
+    if (*resLen == 0)
+    {
+      res[0] = XCPSIM_PID_RES;
+      res[1] = sim->protection;
+      *resLen = 2;
+    }
+  }
+} /*** end of XcpSimCmdUnlock ***/
+
+
+/************************************************************************************//**
+** \brief     Processes the XCP set MTA command.
+** \param     sim Pointer to the simulation object.
+** \param     cmd Pointer to the command packet.
+** \param     cmdLen Length of the command packet.
+** \param     res Pointer to where the response packet is stored.
+** \param     resLen Pointer to where the length of the response packet is stored.
+**
+****************************************************************************************/
+static void XcpSimCmdSetMta(tXcpSimObj * sim, uint8_t const * cmd, uint8_t cmdLen,
+                            uint8_t * res, uint8_t * resLen)
+{
+  if (cmdLen < 8u)
+  {
+    XcpSimSetError(XCPSIM_ERR_CMD_SYNTAX, res, resLen);
+  }
+  else
+  {
+    sim->mta = XcpSimGetLong(&cmd[4]);
+    res[0] = XCPSIM_PID_RES;
+    *resLen = 1;
+  }
+} /*** end of XcpSimCmdSetMta ***/
+
+
+/************************************************************************************//**
+** \brief     Processes the XCP upload command. Only flash memory can be read.
+** \param     sim Pointer to the simulation object.
+** \param     cmd Pointer to the command packet.
+** \param     cmdLen Length of the command packet.
+** \param     res Pointer to where the response packet is stored.
+** \param     resLen Pointer to where the length of the response packet is stored.
+**
+****************************************************************************************/
+static void XcpSimCmdUpload(tXcpSimObj * sim, uint8_t const * cmd, uint8_t cmdLen,
+                            uint8_t * res, uint8_t * resLen)
+{
+  if (cmdLen < 2u)
+  {
+    XcpSimSetError(XCPSIM_ERR_CMD_SYNTAX, res, resLen);
+  }
+  else if ( (cmd[1] > (uint8_t)(sim->settings.maxDto - 1u)) ||
+            (!XcpSimReadMemory((tXcpSimHandle)sim, sim->mta, cmd[1], &res[1])) )
+  {
+    XcpSimSetError(XCPSIM_ERR_OUT_OF_RANGE, res, resLen);
+  }
+  else
+  {
+    sim->mta += cmd[1];
+    sim->stats.bytesUploaded += cmd[1];
+    res[0] = XCPSIM_PID_RES;
+    *resLen = cmd[1] + 1u;
+  }
+} /*** end of XcpSimCmdUpload ***/
+
+
+/************************************************************************************//**
+** \brief     Processes the XCP build checksum command. The checksum is the sum of all
+**            bytes in the block that starts at the MTA.
+** \param     sim Pointer to the simulation object.
+** \param     cmd Pointer to the command packet.
+** \param     cmdLen Length of the command packet.
+** \param     res Pointer to where the response packet is stored.
+** \param     resLen Pointer to where the length of the response packet is stored.
+**
+****************************************************************************************/
+static void XcpSimCmdBuildChecksum(tXcpSimObj * sim, uint8_t const * cmd,
+                                   uint8_t cmdLen, uint8_t * res, uint8_t * resLen)
+{
+  uint32_t blockSize;
+  uint32_t checksum = 0;
+  uint32_t address;
+  uint32_t remaining;
+  uint32_t avail = 0;
+  uint32_t idx;
+  uint8_t const * flashPtr;
+
+  if (cmdLen < 8u)
+  {
+    XcpSimSetError(XCPSIM_ERR_CMD_SYNTAX, res, resLen);
+  }
+  else
+  {
+    blockSize = XcpSimGetLong(&cmd[4]);
+    if (!XcpSimFlashCheckRange(sim, sim->mta, blockSize))
+    {
+      XcpSimSetError(XCPSIM_ERR_OUT_OF_RANGE, res, resLen);
+    }
+    else
+    {
+      /* Add the bytes, region by region. */
+      address = sim->mta;
+      remaining = blockSize;
+      while (remaining > 0)
+      {
+        flashPtr = XcpSimFlashLocate(sim, address, &avail, NULL);
+        assert(flashPtr != NULL);
+        if (avail > remaining)
+        {
+          avail = remaining;
+        }
+        for (idx = 0; idx < avail; idx++)
+        {
+          checksum += flashPtr[idx];
+        }
+        address += avail;
+        remaining -= avail;
+      }
+      sim->mta += blockSize;
+      res[0] = XCPSIM_PID_RES;
+      res[1] = XCPSIM_CHECKSUM_TYPE_ADD_14;
+      res[2] = 0x00;
+      res[3] = 0x00;
+      XcpSimSetLong(checksum, &res[4]);
+      *resLen = 8;
+    }
+  }
+} /*** end of XcpSimCmdBuildChecksum ***/
+
+
+/************************************************************************************//**
+** \brief     Processes the XCP program start command.
+** \param     sim Pointer to the simulation object.
+** \param     res Pointer to where the response packet is stored.
+** \param     resLen Pointer to where the length of the response packet is stored.
+**
+****************************************************************************************/
+static void XcpSimCmdProgramStart(tXcpSimObj * sim, uint8_t * res, uint8_t * resLen)
+{
+  if ((sim->protection & XCP_RESOURCE_PGM) != 0)
+  {
+    XcpSimSetError(XCPSIM_ERR_ACCESS_LOCKED, res, resLen);
+  }
+  else
+  {
+    /* Programming uses the same packet size and no block transfer mode. */
+    res[0] = XCPSIM_PID_RES;
+    res[1] = 0x00;
+    res[2] = 0x00;
+    res[3] = sim->settings.maxCto;
+    res[4] = 0x00;
+    res[5] = 0x00;
+    res[6] = 0x00;
+    *resLen = 7;
+  }
+} /*** end of XcpSimCmdProgramStart ***/
+
+
+/************************************************************************************//**
+** \brief     Processes the XCP program clear command. All sectors that overlap with the
+**            memory range that starts at the MTA are erased.
+** \param     sim Pointer to the simulation object.
+** \param     cmd Pointer to the command packet.
+** \param     cmdLen Length of the command packet.
+** \param     res Pointer to where the response packet is stored.
+** \param     resLen Pointer to where the length of the response packet is stored.
+**
+****************************************************************************************/
+static void XcpSimCmdProgramClear(tXcpSimObj * sim, uint8_t const * cmd,
+                                  uint8_t cmdLen, uint8_t * res, uint8_t * resLen)
+{
+  if (cmdLen < 8u)
+  {
+    XcpSimSetError(XCPSIM_ERR_CMD_SYNTAX, res, resLen);
+  }
+  else if ((sim->protection & XCP_RESOURCE_PGM) != 0)
+  {
+    XcpSimSetError(XCPSIM_ERR_ACCESS_LOCKED, res, resLen);
+  }
+  /* Only the absolute access mode is supported. */
+  else if (cmd[1] != 0u)
+  {
+    XcpSimSetError(XCPSIM_ERR_OUT_OF_RANGE, res, resLen);
+  }
+  /* Let the erase operation fail, if so configured. */
+  else if (XcpSimInjectFault(sim, sim->settings.eraseFailRate))
+  {
+    sim->stats.faultsInjected++;
+    XcpSimSetError(XCPSIM_ERR_GENERIC, res, resLen);
+  }
+  else if (!XcpSimFlashErase(sim, sim->mta, XcpSimGetLong(&cmd[4])))
+  {
+    XcpSimSetError(XCPSIM_ERR_GENERIC, res, resLen);
+  }
+  else
+  {
+    res[0] = XCPSIM_PID_RES;
+    *resLen = 1;
+  }
+} /*** end of XcpSimCmdProgramClear ***/
+
+
+/************************************************************************************//**
+** \brief     Processes the XCP program and program max commands. The data is programmed
+**            at the MTA. A program command without data marks the end of the
+**            programming sequence.
+** \param     sim Pointer to the simulation object.
+** \param     cmd Pointer to the command packet.
+** \param     cmdLen Length of the command packet.
+** \param     res Pointer to where the response packet is stored.
+** \param     resLen Pointer to where the length of the response packet is stored.
+**
+****************************************************************************************/
+static void XcpSimCmdProgram(tXcpSimObj * sim, uint8_t const * cmd, uint8_t cmdLen,
+                             uint8_t * res, uint8_t * resLen)
+{
+  uint8_t const * data;
+  uint8_t len;
+  bool lenOk;
+
+  /* Determine where the data is and how much of it there is. */
+  if (cmd[0] == XCPSIM_CMD_PROGRAM_MAX)
+  {
+    data = &cmd[1];
+    len = (uint8_t)(sim->settings.maxCto - 1u);
+    lenOk = (cmdLen >= sim->settings.maxCto);
+  }
+  else
+  {
+    data = &cmd[2];
+    len = (cmdLen >= 2u) ? cmd[1] : 0u;
+    lenOk = ( (cmdLen >= 2u) && (cmdLen >= (uint8_t)(len + 2u)) &&
+              (len <= (uint8_t)(sim->settings.maxCto - 2u)) );
+  }
+
+  if (!lenOk)
+  {
+    XcpSimSetError(XCPSIM_ERR_CMD_SYNTAX, res, resLen);
+  }
+  else if ((sim->protection & XCP_RESOURCE_PGM) != 0)
+  {
+    XcpSimSetError(XCPSIM_ERR_ACCESS_LOCKED, res, resLen);
+  }
+  /* A program command without data ends the programming sequence. The simulated flash
+   * memory is written directly, so there is nothing left to do.
+   */
+  else if (len == 0)
+  {
+    res[0] = XCPSIM_PID_RES;
+    *resLen = 1;
+  }
+  /* Let the program operation fail, if so configured. */
+  else if (XcpSimInjectFault(sim, sim->settings.programFailRate))
+  {
+    sim->stats.faultsInjected++;
+    XcpSimSetError(XCPSIM_ERR_GENERIC, res, resLen);
+  }
+  else if (!XcpSimFlashWrite(sim, sim->mta, len, data))
+  {
+    XcpSimSetError(XCPSIM_ERR_GENERIC, res, resLen);
+  }
+  else
+  {
+    sim->mta += len;
+    res[0] = XCPSIM_PID_RES;
+    *resLen = 1;
+  }
+} /*** end of XcpSimCmdProgram ***/
+
+
+/************************************************************************************//**
+** \brief     Processes the XCP program reset command. This completes the programming
+**            session and resets the target.
+** \param     sim Pointer to the simulation object.
+** \param     res Pointer to where the response packet is stored.
+** \param     resLen Pointer to where the length of the response packet is stored.
+**
+****************************************************************************************/
+static void XcpSimCmdProgramReset(tXcpSimObj * sim, uint8_t * res, uint8_t * resLen)
+{
+  sim->stats.sessions++;
+  sim->stats.sessionTime += XcpSimGetTimeUs() - sim->connectTime;
+  res[0] = XCPSIM_PID_RES;
+  *resLen = 1;
+  XcpSimReset((tXcpSimHandle)sim);
+} /*** end of XcpSimCmdProgramReset ***/
+
+
+/************************************************************************************//**
+** \brief     Builds an XCP error packet.
+** \param     errorCode XCP error code.
+** \param     res Pointer to where the response packet is stored.
+** \param     resLen Pointer to where the length of the response packet is stored.
+**
+****************************************************************************************/
+static void XcpSimSetError(uint8_t errorCode, uint8_t * res, uint8_t * resLen)
+{
+  res[0] = XCPSIM_PID_ERR;
+  res[1] = errorCode;
+  *resLen = 2;
+} /*** end of XcpSimSetError ***/
+
+
+/************************************************************************************//**
+** \brief     Erases all flash sectors that overlap with the specified memory range.
+**            Returns after the configured erase time of these sectors passed.
+** \param     sim Pointer to the simulation object.
+** \param     address Start address of the memory range.
+** \param     len Length of the memory range.
+** \return    True if successful, false if the range is not completely located in flash
+**            memory.
+**
+****************************************************************************************/
+static bool XcpSimFlashErase(tXcpSimObj * sim, uint32_t address, uint32_t len)
+{
+  bool result;
+  tXcpSimFlash * flash = NULL;
+  uint32_t avail = 0;
+  uint32_t firstSector;
+  uint32_t lastSector;
+  uint32_t sectorCount = 0;
+
+  result = XcpSimFlashCheckRange(sim, address, len);
+  /* Erase the sectors, region by region. */
+  while ( (result) && (len > 0) )
+  {
+    (void)XcpSimFlashLocate(sim, address, &avail, &flash);
+    assert(flash != NULL);
+    if (avail > len)
+    {
+      avail = len;
+    }
+    firstSector = (address - flash->region.address) / flash->region.sectorSize;
+    lastSector = (address + avail - 1u - flash->region.address) /
+                 flash->region.sectorSize;
+    memset(&flash->data[firstSector * flash->region.sectorSize], 0xFF,
+           (size_t)(lastSector - firstSector + 1u) * flash->region.sectorSize);
+    sectorCount += lastSector - firstSector + 1u;
+    address += avail;
+    len -= avail;
+  }
+  /* Wait for the erase operation to complete. */
+  if (result)
+  {
+    XcpSimDelayUs((uint64_t)sectorCount * sim->settings.eraseTime * 1000u);
+    sim->stats.sectorsErased += sectorCount;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpSimFlashErase ***/
+
+
+/************************************************************************************//**
+** \brief     Programs data in flash memory. Just like with real flash memory, program-
+**            ming can only clear bits. The operation fails if the data cannot be
+**            programmed, because the memory was not erased. Returns after the configured
+**            program time of the data passed.
+** \param     sim Pointer to the simulation object.
+** \param     address Start address of the data.
+** \param     len Number of data bytes.
+** \param     data Pointer to the data bytes.
+** \return    True if successful, false otherwise.
+**
+****************************************************************************************/
+static bool XcpSimFlashWrite(tXcpSimObj * sim, uint32_t address, uint32_t len,
+                             uint8_t const * data)
+{
+  bool result;
+  uint8_t * flashPtr;
+  uint32_t avail = 0;
+  uint32_t idx;
+  uint32_t programTime = len * sim->settings.programTime;
+
+  result = XcpSimFlashCheckRange(sim, address, len);
+  /* Program the data, region by region. */
+  while ( (result) && (len > 0) )
+  {
+    flashPtr = XcpSimFlashLocate(sim, address, &avail, NULL);
+    assert(flashPtr != NULL);
+    if (avail > len)
+    {
+      avail = len;
+    }
+    for (idx = 0; idx < avail; idx++)
+    {
+      flashPtr[idx] &= data[idx];
+      /* Verify the programmed byte. */
+      if (flashPtr[idx] != data[idx])
+      {
+        result = false;
+        break;
+      }
+    }
+    sim->stats.bytesProgrammed += idx;
+    data += avail;
+    address += avail;
+    len -= avail;
+  }
+  /* Wait for the program operation to complete. */
+  XcpSimDelayUs(programTime);
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpSimFlashWrite ***/
+
+
+/************************************************************************************//**
+** \brief     Locates the specified address in the simulated flash memory.
+** \param     sim Pointer to the simulation object.
+** \param     address The address to locate.
+** \param     avail Pointer to where the number of bytes from the address until the end
+**            of its region is stored.
+** \param     flash Pointer to where the pointer to the region is stored. Can be NULL.
+** \return    Pointer to the contents of the simulated flash memory at the address or
+**            NULL if the address is not located in flash memory.
+**
+****************************************************************************************/
+static uint8_t * XcpSimFlashLocate(tXcpSimObj * sim, uint32_t address, uint32_t * avail,
+                                   tXcpSimFlash ** flash)
+{
+  uint8_t * result = NULL;
+  uint32_t regionIdx;
+  uint32_t offset;
+  uint32_t size;
+
+  for (regionIdx = 0; regionIdx < sim->settings.regionCount; regionIdx++)
+  {
+    size = sim->flash[regionIdx].region.sectorSize *
+           sim->flash[regionIdx].region.sectorCount;
+    offset = address - sim->flash[regionIdx].region.address;
+    if ( (address >= sim->flash[regionIdx].region.address) && (offset < size) )
+    {
+      result = &sim->flash[regionIdx].data[offset];
+      *avail = size - offset;
+      if (flash != NULL)
+      {
+        *flash = &sim->flash[regionIdx];
+      }
+      break;
+    }
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpSimFlashLocate ***/
+
+
+/************************************************************************************//**
+** \brief     Checks if the specified memory range is completely located in flash memory.
+**            The range is allowed to span adjacent regions.
+** \param     sim Pointer to the simulation object.
+** \param     address Start address of the memory range.
+** \param     len Length of the memory range.
+** \return    True if the range is located in flash memory, false otherwise.
+**
+****************************************************************************************/
+static bool XcpSimFlashCheckRange(tXcpSimObj * sim, uint32_t address, uint32_t len)
+{
+  bool result = true;
+  uint32_t avail = 0;
+
+  while (len > 0)
+  {
+    if (XcpSimFlashLocate(sim, address, &avail, NULL) == NULL)
+    {
+      result = false;
+      break;
+    }
+    if (avail >= len)
+    {
+      break;
+    }
+    address += avail;
+    len -= avail;
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpSimFlashCheckRange ***/
+
+
+/************************************************************************************//**
+** \brief     Decides whether or not a fault should be injected, based on the configured
+**            rate. A simple xorshift generator makes the faults reproducible for the
+**            same seed.
+** \param     sim Pointer to the simulation object.
+** \param     rate Percentage of the times that a fault should be injected.
+** \return    True if a fault should be injected, false otherwise.
+**
+****************************************************************************************/
+static bool XcpSimInjectFault(tXcpSimObj * sim, uint8_t rate)
+{
+  bool result = false;
+
+  if (rate > 0)
+  {
+    sim->randState ^= sim->randState << 13;
+    sim->randState ^= sim->randState >> 17;
+    sim->randState ^= sim->randState << 5;
+    result = ((sim->randState % 100u) < rate);
+  }
+  /* Give the result back to the caller. */
+  return result;
+} /*** end of XcpSimInjectFault ***/
+
+
+/************************************************************************************//**
+** \brief     Reads a 32-bit value in the Intel byte ordering of the target.
+** \param     data Pointer to the first byte of the value.
+** \return    The value.
+**
+****************************************************************************************/
+static uint32_t XcpSimGetLong(uint8_t const * data)
+{
+  return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) |
+         ((uint32_t)data[3] << 24);
+} /*** end of XcpSimGetLong ***/
+
+
+/************************************************************************************//**
+** \brief     Stores a 32-bit value in the Intel byte ordering of the target.
+** \param     value The value.
+** \param     data Pointer to where the first byte of the value is stored.
+**
+****************************************************************************************/
+static void XcpSimSetLong(uint32_t value, uint8_t * data)
+{
+  data[0] = (uint8_t)value;
+  data[1] = (uint8_t)(value >> 8);
+  data[2] = (uint8_t)(value >> 16);
+  data[3] = (uint8_t)(value >> 24);
+} /*** end of XcpSimSetLong ***/
+
+
+/************************************************************************************//**
+** \brief     Obtains the time of a monotonic clock.
+** \return    The current time in microseconds.
+**
+****************************************************************************************/
+static uint64_t XcpSimGetTimeUs(void)
+{
+  struct timespec now;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &now);
+  return ((uint64_t)now.tv_sec * 1000000u) + ((uint64_t)now.tv_nsec / 1000u);
+} /*** end of XcpSimGetTimeUs ***/
+
+
+/************************************************************************************//**
+** \brief     Waits for the specified time. Used to simulate the duration of erase and
+**            program operations.
+** \param     delay Time to wait in microseconds.
+**
+****************************************************************************************/
+static void XcpSimDelayUs(uint64_t delay)
+{
+  struct timespec remaining;
+
+  if (delay > 0)
+  {
+    remaining.tv_sec = (time_t)(delay / 1000000u);
+    remaining.tv_nsec = (long)((delay % 1000000u) * 1000u);
+    /* Continue waiting when interrupted by a signal. */
+    while (nanosleep(&remaining, &remaining) != 0)
+    {
+      ;
+    }
+  }
+} /*** end of XcpSimDelayUs ***/
+
+
+/*********************************** end of xcpsim.c ***********************************/
@@ -0,0 +1,125 @@
+/************************************************************************************//**
+* \file         xcpsim.h
+* \brief        XCP bootloader target simulation header file.
+* \ingroup      XcpSim
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2017  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. It is released under a commercial license. Refer to
+* the license.pdf file for the exact licensing terms. It should be located in
+* '.\Doc\license.pdf'. Contact Feaser if you did not receive the license.pdf file.
+*
+* In a nutshell, you are allowed to modify and use this software in your closed source
+* proprietary application, provided that the following conditions are met:
+* 1. The software is not released or distributed in source (human-readable) form.
+* 2. These licensing terms and the copyright notice above are not changed.
+*
+* This software has been carefully tested, but is not guaranteed for any particular
+* purpose. Feaser does not offer any warranties and does not guarantee the accuracy,
+* adequacy, or completeness of the software and is not responsible for any errors or
+* omissions or the results obtained from use of the software.
+*
+* \endinternal
+****************************************************************************************/
+/************************************************************************************//**
+* \defgroup   XcpSim XCP bootloader target simulation
+* \brief      This module simulates the XCP command set of the OpenBLT bootloader.
+* \details
+* The simulation processes the XCP command packets that the host sends to the
+* bootloader and builds the response packets, exactly as the bootloader on the micro-
+* controller would. The flash memory of the target is simulated in RAM, with a
+* configurable sector geometry and configurable erase and program times. Faults can be
+* injected to test the error handling of the host. The module does not know anything
+* about the transport layer. It is up to the caller to receive the command packets and
+* to transmit the response packets.
+****************************************************************************************/
+#ifndef XCPSIM_H
+#define XCPSIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include <stdint.h>                         /* for standard integer types              */
+#include <stdbool.h>                        /* for boolean type                        */
+
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Maximum number of bytes in an XCP command or response packet. */
+#define XCPSIM_PACKET_SIZE_MAX         (255u)
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Handle to an XCP target simulation object. */
+typedef void * tXcpSimHandle;
+
+/** \brief Describes a region of flash memory, made up of equally sized sectors. */
+typedef struct t_xcp_sim_region
+{
+  uint32_t address;              /**< Start address of the first sector.               */
+  uint32_t sectorSize;           /**< Size of one sector in bytes.                     */
+  uint32_t sectorCount;          /**< Number of sectors in the region.                 */
+} tXcpSimRegion;
+
+/** \brief Settings of the target simulation. */
+typedef struct t_xcp_sim_settings
+{
+  tXcpSimRegion const * regions; /**< Array with the flash memory regions.             */
+  uint32_t regionCount;          /**< Number of entries in the regions array.          */
+  uint8_t maxCto;                /**< Maximum length of a command packet.              */
+  uint8_t maxDto;                /**< Maximum length of a response packet.             */
+  bool pgmProtected;             /**< Programming needs seed/key unlock when true.     */
+  uint32_t eraseTime;            /**< Time to erase one sector in milliseconds.        */
+  uint32_t programTime;          /**< Time to program one byte in microseconds.        */
+  uint8_t lossRate;              /**< Percentage of response packets to drop.          */
+  uint8_t eraseFailRate;         /**< Percentage of erase operations that fail.        */
+  uint8_t programFailRate;       /**< Percentage of program operations that fail.      */
+  uint32_t faultSeed;            /**< Seed for the pseudo random fault injection.      */
+} tXcpSimSettings;
+
+/** \brief Statistics that the target simulation collects. */
+typedef struct t_xcp_sim_stats
+{
+  uint32_t commands;             /**< Number of processed command packets.             */
+  uint32_t sectorsErased;        /**< Number of erased sectors.                        */
+  uint32_t bytesProgrammed;      /**< Number of programmed bytes.                      */
+  uint32_t bytesUploaded;        /**< Number of bytes read with the upload command.    */
+  uint32_t faultsInjected;       /**< Number of dropped responses and failed actions.  */
+  uint32_t sessions;             /**< Number of completed programming sessions.        */
+  uint64_t sessionTime;          /**< Microseconds between connect and program reset.  */
+} tXcpSimStats;
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+tXcpSimHandle XcpSimInit(tXcpSimSettings const * settings);
+void XcpSimTerminate(tXcpSimHandle handle);
+void XcpSimReset(tXcpSimHandle handle);
+uint16_t XcpSimGetCommandLength(tXcpSimHandle handle, uint8_t const * data,
+                                uint16_t len);
+bool XcpSimProcessCommand(tXcpSimHandle handle, uint8_t const * cmd, uint8_t cmdLen,
+                          uint8_t * res, uint8_t * resLen);
+bool XcpSimReadMemory(tXcpSimHandle handle, uint32_t address, uint32_t len,
+                      uint8_t * data);
+void XcpSimGetStats(tXcpSimHandle handle, tXcpSimStats * stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XCPSIM_H */
+/*********************************** end of xcpsim.h ***********************************/